@@ -103,6 +103,40 @@ using tensorflow::errors::InvalidArgument;
 using tensorflow::gtl::ArraySlice;
 using tensorflow::strings::StrCat;
 
+namespace {
+
+// A GraphDef parsed from a binary buffer. When full protos are available the
+// proto is allocated on an arena: a large GraphDef decomposes into millions of
+// small node and attr messages, and arena allocation both keeps the parse off
+// the global heap and makes destruction near-free. The parsed proto is only
+// read by the import/extend paths (which take it by const reference), so it
+// never needs to be copied off the arena.
+class ArenaParsedGraphDef {
+ public:
+  // Parses the buffer, returning false on malformed input. Must be called
+  // exactly once before def().
+  bool Parse(const void* data, size_t length) {
+#ifdef TENSORFLOW_LITE_PROTOS
+    def_ = &heap_def_;
+#else
+    def_ = tensorflow::protobuf::Arena::CreateMessage<GraphDef>(&arena_);
+#endif
+    return tensorflow::ParseProtoUnlimited(def_, data, length);
+  }
+
+  const GraphDef& def() const { return *def_; }
+
+ private:
+#ifdef TENSORFLOW_LITE_PROTOS
+  GraphDef heap_def_;
+#else
+  tensorflow::protobuf::Arena arena_;
+#endif
+  GraphDef* def_ = nullptr;
+};
+
+}  // namespace
+
 extern "C" {
 
 // --------------------------------------------------------------------------
@@ -444,12 +478,12 @@ void TF_DeleteDeprecatedSession(TF_DeprecatedSession* s, TF_Status* status) {
 
 void TF_ExtendGraph(TF_DeprecatedSession* s, const void* proto,
                     size_t proto_len, TF_Status* status) {
-  GraphDef g;
-  if (!tensorflow::ParseProtoUnlimited(&g, proto, proto_len)) {
+  ArenaParsedGraphDef g;
+  if (!g.Parse(proto, proto_len)) {
     status->status = InvalidArgument("Invalid GraphDef");
     return;
   }
-  status->status = s->session->Extend(g);
+  status->status = s->session->Extend(g.def());
 }
 
 static void DeleteArray(void* data, size_t size, void* arg) {
@@ -2169,15 +2203,14 @@ static void GraphImportGraphDefLocked(TF_Graph* graph, const GraphDef& def,
 TF_ImportGraphDefResults* TF_GraphImportGraphDefWithResults(
     TF_Graph* graph, const TF_Buffer* graph_def,
     const TF_ImportGraphDefOptions* options, TF_Status* status) {
-  GraphDef def;
-  if (!tensorflow::ParseProtoUnlimited(&def, graph_def->data,
-                                       graph_def->length)) {
+  ArenaParsedGraphDef def;
+  if (!def.Parse(graph_def->data, graph_def->length)) {
     status->status = InvalidArgument("Invalid GraphDef");
     return nullptr;
   }
   auto results = new TF_ImportGraphDefResults();
   mutex_lock l(graph->mu);
-  GraphImportGraphDefLocked(graph, def, options, results, status);
+  GraphImportGraphDefLocked(graph, def.def(), options, results, status);
   if (TF_GetCode(status) != TF_OK) {
     delete results;
     return nullptr;
@@ -2200,15 +2233,14 @@ void TF_GraphImportGraphDefWithReturnOutputs(
         "'return_outputs' must be preallocated to length ", num_return_outputs);
     return;
   }
-  GraphDef def;
-  if (!tensorflow::ParseProtoUnlimited(&def, graph_def->data,
-                                       graph_def->length)) {
+  ArenaParsedGraphDef def;
+  if (!def.Parse(graph_def->data, graph_def->length)) {
     status->status = InvalidArgument("Invalid GraphDef");
     return;
   }
   TF_ImportGraphDefResults results;
   mutex_lock l(graph->mu);
-  GraphImportGraphDefLocked(graph, def, options, &results, status);
+  GraphImportGraphDefLocked(graph, def.def(), options, &results, status);
   DCHECK_EQ(results.return_tensors.size(), num_return_outputs);
   memcpy(return_outputs, results.return_tensors.data(),
          num_return_outputs * sizeof(TF_Output));
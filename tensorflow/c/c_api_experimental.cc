@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/c/c_api_experimental.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "absl/strings/substitute.h"
 #include "tensorflow/c/c_api.h"
 #include "tensorflow/c/c_api_internal.h"
@@ -23,7 +26,10 @@ limitations under the License.
 #include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/core/common_runtime/eager/attr_builder.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_server_lib.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/lib/strings/strcat.h"
@@ -897,3 +903,211 @@ TFE_TensorHandle* TFE_ConsumeInputConcreteTensorFromTraceContext(
           << handle->DebugString();
   return ret;
 }
+
+namespace {
+
+// A buffer wrapping caller-owned memory, handed back through the caller's
+// deallocator once the last reference is dropped.  Mirrors TF_ManagedBuffer
+// in c_api.cc, minus the copying fallback: callers of the adoption APIs get
+// either an aliasing tensor or an error.
+class TF_AdoptedBuffer : public tensorflow::TensorBuffer {
+ public:
+  TF_AdoptedBuffer(void* data, size_t len,
+                   void (*deallocator)(void* data, size_t len, void* arg),
+                   void* deallocator_arg)
+      : tensorflow::TensorBuffer(data),
+        len_(len),
+        deallocator_(deallocator),
+        deallocator_arg_(deallocator_arg) {}
+
+  ~TF_AdoptedBuffer() override {
+    (*deallocator_)(data(), len_, deallocator_arg_);
+  }
+
+  size_t size() const override { return len_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(
+      tensorflow::AllocationDescription* proto) const override {
+    tensorflow::int64 rb = size();
+    proto->set_requested_bytes(rb);
+    proto->set_allocator_name(tensorflow::cpu_allocator()->Name());
+  }
+
+  // Prevents input forwarding from mutating this buffer.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const size_t len_;
+  void (*const deallocator_)(void* data, size_t len, void* arg);
+  void* const deallocator_arg_;
+};
+
+// A view of a byte range inside a registered region.  Keeps the region's
+// root buffer alive for the lifetime of the view.
+class TF_RegionViewBuffer : public tensorflow::TensorBuffer {
+ public:
+  TF_RegionViewBuffer(tensorflow::TensorBuffer* root, size_t offset,
+                      size_t len)
+      : tensorflow::TensorBuffer(static_cast<char*>(root->data()) + offset),
+        root_(root),
+        len_(len) {
+    root_->Ref();
+  }
+
+  ~TF_RegionViewBuffer() override { root_->Unref(); }
+
+  size_t size() const override { return len_; }
+  TensorBuffer* root_buffer() override { return root_; }
+  void FillAllocationDescription(
+      tensorflow::AllocationDescription* proto) const override {
+    root_->FillAllocationDescription(proto);
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  tensorflow::TensorBuffer* const root_;
+  const size_t len_;
+};
+
+// Checks the adoption contract: a plain old data dtype whose C and runtime
+// representations match, an aligned data pointer, and enough bytes for the
+// shape.
+Status ValidateAdoptedBuffer(TF_DataType dtype, const void* data, size_t len,
+                             const tensorflow::TensorShape& shape) {
+  if (dtype == TF_STRING || dtype == TF_RESOURCE ||
+      !tensorflow::DataTypeCanUseMemcpy(
+          static_cast<tensorflow::DataType>(dtype))) {
+    return tensorflow::errors::InvalidArgument(
+        "Cannot adopt a buffer holding a tensor of type ",
+        tensorflow::DataTypeString(static_cast<tensorflow::DataType>(dtype)),
+        ": its C API representation differs from the runtime's");
+  }
+  if (reinterpret_cast<intptr_t>(data) % TF_TensorDataAlignment() != 0) {
+    return tensorflow::errors::InvalidArgument(
+        "Buffer to adopt is not aligned to ", TF_TensorDataAlignment(),
+        " bytes");
+  }
+  const size_t elem_size = TF_DataTypeSize(dtype);
+  if (len < elem_size * shape.num_elements()) {
+    return tensorflow::errors::InvalidArgument(
+        "Buffer of ", len, " bytes is too small for a ",
+        shape.num_elements(), "-element tensor of type ",
+        tensorflow::DataTypeString(static_cast<tensorflow::DataType>(dtype)));
+  }
+  return Status::OK();
+}
+
+tensorflow::TensorShape ShapeFromDims(const int64_t* dims, int num_dims) {
+  std::vector<tensorflow::int64> dimvec(num_dims);
+  for (int i = 0; i < num_dims; ++i) {
+    dimvec[i] = static_cast<tensorflow::int64>(dims[i]);
+  }
+  return tensorflow::TensorShape(dimvec);
+}
+
+}  // namespace
+
+struct TF_TensorRegion {
+  tensorflow::TensorBuffer* buffer;  // This handle holds one reference.
+};
+
+size_t TF_TensorDataAlignment() {
+  return std::max<size_t>(1, EIGEN_MAX_ALIGN_BYTES);
+}
+
+TF_Tensor* TF_NewAdoptedTensor(TF_DataType dtype, const int64_t* dims,
+                               int num_dims, void* data, size_t len,
+                               void (*deallocator)(void* data, size_t len,
+                                                   void* arg),
+                               void* deallocator_arg, TF_Status* status) {
+  status->status = Status::OK();
+  const tensorflow::TensorShape shape = ShapeFromDims(dims, num_dims);
+  status->status = ValidateAdoptedBuffer(dtype, data, len, shape);
+  if (!status->status.ok()) return nullptr;
+  return new TF_Tensor{
+      dtype, shape,
+      new TF_AdoptedBuffer(data, len, deallocator, deallocator_arg)};
+}
+
+unsigned char TF_TensorAliasesBuffer(const TF_Tensor* tensor,
+                                     const void* data) {
+  return TF_TensorData(tensor) == data ? 1 : 0;
+}
+
+TF_TensorRegion* TF_NewTensorRegion(void* data, size_t len,
+                                    void (*deallocator)(void* data, size_t len,
+                                                        void* arg),
+                                    void* deallocator_arg) {
+  return new TF_TensorRegion{
+      new TF_AdoptedBuffer(data, len, deallocator, deallocator_arg)};
+}
+
+TF_Tensor* TF_NewTensorFromRegion(TF_TensorRegion* region, TF_DataType dtype,
+                                  const int64_t* dims, int num_dims,
+                                  size_t offset, size_t len,
+                                  TF_Status* status) {
+  status->status = Status::OK();
+  if (offset + len > region->buffer->size()) {
+    status->status = tensorflow::errors::InvalidArgument(
+        "View of ", len, " bytes at offset ", offset,
+        " extends past the end of a region of ", region->buffer->size(),
+        " bytes");
+    return nullptr;
+  }
+  const tensorflow::TensorShape shape = ShapeFromDims(dims, num_dims);
+  const void* data = static_cast<char*>(region->buffer->data()) + offset;
+  status->status = ValidateAdoptedBuffer(dtype, data, len, shape);
+  if (!status->status.ok()) return nullptr;
+  return new TF_Tensor{dtype, shape,
+                       new TF_RegionViewBuffer(region->buffer, offset, len)};
+}
+
+void TF_DeleteTensorRegion(TF_TensorRegion* region) {
+  if (region == nullptr) return;
+  region->buffer->Unref();
+  delete region;
+}
+
+void TF_TensorCopyToBuffer(const TF_Tensor* tensor, void* data, size_t len,
+                           TF_Status* status) {
+  status->status = Status::OK();
+  if (tensor->dtype == TF_STRING || tensor->dtype == TF_RESOURCE) {
+    status->status = tensorflow::errors::InvalidArgument(
+        "Cannot copy a ",
+        tensorflow::DataTypeString(
+            static_cast<tensorflow::DataType>(tensor->dtype)),
+        " tensor into a flat buffer");
+    return;
+  }
+  const size_t size = TF_TensorByteSize(tensor);
+  if (len < size) {
+    status->status = tensorflow::errors::InvalidArgument(
+        "Provided buffer of ", len, " bytes is too small for a tensor of ",
+        size, " bytes");
+    return;
+  }
+  std::memcpy(data, TF_TensorData(tensor), size);
+}
+
+void TF_SessionWarmup(TF_Session* session, const TF_Output* inputs,
+                      TF_Tensor* const* input_values, int ninputs,
+                      const TF_Output* outputs, int noutputs,
+                      const TF_Operation* const* target_opers, int ntargets,
+                      int num_priming_runs, TF_Status* status) {
+  if (num_priming_runs < 1) {
+    status->status = tensorflow::errors::InvalidArgument(
+        "num_priming_runs must be at least 1, got ", num_priming_runs);
+    return;
+  }
+  std::vector<TF_Tensor*> output_values(noutputs, nullptr);
+  for (int i = 0; i < num_priming_runs; ++i) {
+    TF_SessionRun(session, /*run_options=*/nullptr, inputs, input_values,
+                  ninputs, outputs, output_values.data(), noutputs,
+                  target_opers, ntargets, /*run_metadata=*/nullptr, status);
+    for (TF_Tensor* output_value : output_values) {
+      TF_DeleteTensor(output_value);
+    }
+    if (!status->status.ok()) return;
+    std::fill(output_values.begin(), output_values.end(), nullptr);
+  }
+}
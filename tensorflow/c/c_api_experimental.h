@@ -294,6 +294,94 @@ TF_CAPI_EXPORT extern TFE_TensorHandle*
 TFE_ConsumeInputConcreteTensorFromTraceContext(TFE_TraceContext* trace_ctx,
                                                unsigned int idx);
 
+// --------------------------------------------------------------------------
+// Zero-copy tensor creation.
+//
+// TF_NewTensor() silently falls back to copying the caller's buffer when it
+// cannot be used directly, and callers cannot tell which happened.  The APIs
+// below make buffer adoption explicit: creation fails instead of copying,
+// several tensors can share offset views into one registered region, and
+// results can be copied out into caller-provided memory.
+
+// The byte alignment a buffer must satisfy to be adopted by
+// TF_NewAdoptedTensor() or viewed through TF_NewTensorFromRegion().  Buffers
+// returned by TF_AllocateTensor() always satisfy it.
+TF_CAPI_EXPORT extern size_t TF_TensorDataAlignment(void);
+
+// Creates a tensor that reads directly from `data`, never copying.  On
+// success the tensor aliases `data` until deleted, at which point
+// `deallocator` is invoked with `data`, `len` and `deallocator_arg`.  Fails
+// with TF_INVALID_ARGUMENT -- leaving ownership of `data` with the caller,
+// `deallocator` is not invoked -- if:
+//   * `dtype` is TF_STRING or TF_RESOURCE, whose C API representation
+//     differs from the runtime's and therefore always needs conversion, or
+//   * `data` is not aligned to TF_TensorDataAlignment(), or
+//   * `len` is smaller than the tensor's byte size.
+TF_CAPI_EXPORT extern TF_Tensor* TF_NewAdoptedTensor(
+    TF_DataType dtype, const int64_t* dims, int num_dims, void* data,
+    size_t len, void (*deallocator)(void* data, size_t len, void* arg),
+    void* deallocator_arg, TF_Status* status);
+
+// Returns 1 iff `tensor` reads directly from `data`, i.e. the call that
+// created the tensor adopted the buffer (or a view into it) rather than
+// copying out of it.
+TF_CAPI_EXPORT extern unsigned char TF_TensorAliasesBuffer(
+    const TF_Tensor* tensor, const void* data);
+
+typedef struct TF_TensorRegion TF_TensorRegion;
+
+// Registers `len` bytes at `data` (e.g. one arena block holding several
+// tensors) as a region that tensors can alias at offsets through
+// TF_NewTensorFromRegion().  `deallocator` is invoked once the region handle
+// and every tensor viewing the region have been deleted.
+TF_CAPI_EXPORT extern TF_TensorRegion* TF_NewTensorRegion(
+    void* data, size_t len,
+    void (*deallocator)(void* data, size_t len, void* arg),
+    void* deallocator_arg);
+
+// Creates a tensor aliasing `len` bytes at `offset` into `region`, sharing
+// the region's storage without copying.  The tensor's data pointer must be
+// aligned to TF_TensorDataAlignment() and [offset, offset + len) must lie
+// within the region; otherwise fails with TF_INVALID_ARGUMENT.  The dtype
+// restrictions of TF_NewAdoptedTensor() apply.
+TF_CAPI_EXPORT extern TF_Tensor* TF_NewTensorFromRegion(
+    TF_TensorRegion* region, TF_DataType dtype, const int64_t* dims,
+    int num_dims, size_t offset, size_t len, TF_Status* status);
+
+// Releases the caller's handle on `region`.  Tensors already viewing the
+// region remain valid; the underlying buffer is deallocated when the last of
+// them is deleted.
+TF_CAPI_EXPORT extern void TF_DeleteTensorRegion(TF_TensorRegion* region);
+
+// Copies the contents of `tensor` into the caller-provided buffer `data` of
+// size `len`, which must be at least TF_TensorByteSize(tensor) bytes.  Fails
+// with TF_INVALID_ARGUMENT for TF_STRING and TF_RESOURCE tensors, whose
+// contents are not a flat byte array.
+TF_CAPI_EXPORT extern void TF_TensorCopyToBuffer(const TF_Tensor* tensor,
+                                                 void* data, size_t len,
+                                                 TF_Status* status);
+
+// --------------------------------------------------------------------------
+// Session warmup.
+//
+// Runs `num_priming_runs` iterations of the given signature before the
+// session starts serving real traffic.  The first iteration pays for lazy
+// executor creation (graph pruning, placement, partitioning); the remaining
+// iterations grow allocator pools to their steady-state high-water mark and
+// trigger cuDNN/cuBLAS autotuning so later requests hit already-tuned
+// algorithms.  Fetched tensors are discarded.  `num_priming_runs` must be at
+// least 1.  Tuned algorithms can be persisted across process restarts by
+// pointing TF_AUTOTUNE_CACHE_PATH at a cache file written after warmup.
+TF_CAPI_EXPORT extern void TF_SessionWarmup(
+    TF_Session* session,
+    // Input tensors
+    const TF_Output* inputs, TF_Tensor* const* input_values, int ninputs,
+    // Output tensors
+    const TF_Output* outputs, int noutputs,
+    // Target operations
+    const TF_Operation* const* target_opers, int ntargets,
+    int num_priming_runs, TF_Status* status);
+
 #ifdef __cplusplus
 } /* end extern "C" */
 #endif
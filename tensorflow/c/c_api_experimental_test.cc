@@ -14,6 +14,9 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/c/c_api_experimental.h"
+
+#include <cstring>
+
 #include "tensorflow/c/c_api_internal.h"
 #include "tensorflow/c/c_test_util.h"
 #include "tensorflow/c/eager/c_api.h"
@@ -431,5 +434,103 @@ TEST_F(AddEagerOpToGraphTest,
   TFE_DeleteTensorHandle(matrix);
 }
 
+void CountingDeallocator(void* data, size_t len, void* arg) {
+  ++*static_cast<int*>(arg);
+}
+
+TEST(CAPI_EXPERIMENTAL, AdoptedTensor) {
+  alignas(EIGEN_MAX_ALIGN_BYTES) static float values[6] = {0, 1, 2, 3, 4, 5};
+  const int64_t dims[] = {2, 3};
+  int num_deallocations = 0;
+
+  TF_Status* status = TF_NewStatus();
+  TF_Tensor* t =
+      TF_NewAdoptedTensor(TF_FLOAT, dims, 2, values, sizeof(values),
+                          &CountingDeallocator, &num_deallocations, status);
+  ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  ASSERT_NE(t, nullptr);
+  // The tensor aliases the caller's buffer; no copy was made.
+  EXPECT_EQ(values, TF_TensorData(t));
+  EXPECT_EQ(1, TF_TensorAliasesBuffer(t, values));
+  EXPECT_EQ(sizeof(values), TF_TensorByteSize(t));
+
+  // Outputs can be fetched into caller-provided memory.
+  float fetched[6] = {0};
+  TF_TensorCopyToBuffer(t, fetched, sizeof(fetched), status);
+  ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  for (int i = 0; i < 6; ++i) EXPECT_EQ(values[i], fetched[i]);
+  // A too-small destination is rejected.
+  TF_TensorCopyToBuffer(t, fetched, sizeof(fetched) / 2, status);
+  EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(status));
+
+  EXPECT_EQ(0, num_deallocations);
+  TF_DeleteTensor(t);
+  EXPECT_EQ(1, num_deallocations);
+
+  // A too-short buffer fails instead of silently misbehaving, and ownership
+  // stays with the caller.
+  t = TF_NewAdoptedTensor(TF_FLOAT, dims, 2, values, sizeof(values) / 2,
+                          &CountingDeallocator, &num_deallocations, status);
+  EXPECT_EQ(t, nullptr);
+  EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(status));
+  EXPECT_EQ(1, num_deallocations);
+
+  // An unaligned buffer fails instead of being copied.
+  if (TF_TensorDataAlignment() > 1) {
+    char* unaligned = reinterpret_cast<char*>(values) + 1;
+    t = TF_NewAdoptedTensor(TF_FLOAT, dims, 2, unaligned, sizeof(values),
+                            &CountingDeallocator, &num_deallocations, status);
+    EXPECT_EQ(t, nullptr);
+    EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(status));
+    EXPECT_EQ(1, num_deallocations);
+  }
+  TF_DeleteStatus(status);
+}
+
+TEST(CAPI_EXPERIMENTAL, TensorRegionViews) {
+  constexpr size_t kStride =
+      EIGEN_MAX_ALIGN_BYTES > 0 ? EIGEN_MAX_ALIGN_BYTES : sizeof(float);
+  alignas(EIGEN_MAX_ALIGN_BYTES) static char region_bytes[2 * kStride + 24];
+  const int64_t dims[] = {2, 3};
+  int num_deallocations = 0;
+
+  float values[6] = {0, 1, 2, 3, 4, 5};
+  std::memcpy(region_bytes, values, sizeof(values));
+  std::memcpy(region_bytes + kStride, values, sizeof(values));
+
+  TF_TensorRegion* region =
+      TF_NewTensorRegion(region_bytes, sizeof(region_bytes),
+                         &CountingDeallocator, &num_deallocations);
+
+  // Two tensors view disjoint offsets of the same region without copying.
+  TF_Status* status = TF_NewStatus();
+  TF_Tensor* first = TF_NewTensorFromRegion(region, TF_FLOAT, dims, 2,
+                                            /*offset=*/0, 24, status);
+  ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  TF_Tensor* second = TF_NewTensorFromRegion(region, TF_FLOAT, dims, 2,
+                                             /*offset=*/kStride, 24, status);
+  ASSERT_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  EXPECT_EQ(1, TF_TensorAliasesBuffer(first, region_bytes));
+  EXPECT_EQ(1, TF_TensorAliasesBuffer(second, region_bytes + kStride));
+  EXPECT_EQ(values[5], static_cast<float*>(TF_TensorData(second))[5]);
+
+  // Views past the end of the region are rejected.
+  TF_Tensor* bad = TF_NewTensorFromRegion(
+      region, TF_FLOAT, dims, 2, /*offset=*/sizeof(region_bytes), 24, status);
+  EXPECT_EQ(bad, nullptr);
+  EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(status));
+
+  // The views keep the region alive after its handle is released; the
+  // deallocator runs when the last view is deleted.
+  TF_DeleteTensorRegion(region);
+  EXPECT_EQ(0, num_deallocations);
+  EXPECT_EQ(values[4], static_cast<float*>(TF_TensorData(first))[4]);
+  TF_DeleteTensor(first);
+  EXPECT_EQ(0, num_deallocations);
+  TF_DeleteTensor(second);
+  EXPECT_EQ(1, num_deallocations);
+  TF_DeleteStatus(status);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -32,6 +32,10 @@ void TFE_OpConsumeInput(TFE_Op* op, TFE_TensorHandle* h, TF_Status* status) {
   op->operation.ConsumeInput(h->handle);
 }
 
+void TFE_OpClearInputs(TFE_Op* op, TF_Status* status) {
+  op->operation.ClearInputs();
+}
+
 TFE_Profiler* TFE_NewProfiler(TFE_ProfilerContext* ctx) {
   return new TFE_Profiler(ctx);
 }
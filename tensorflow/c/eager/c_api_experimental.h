@@ -25,6 +25,14 @@ extern "C" {
 TF_CAPI_EXPORT extern void TFE_OpConsumeInput(TFE_Op* op, TFE_TensorHandle* h,
                                               TF_Status* status);
 
+// Drops all inputs from `op` so that it can be executed again with fresh
+// inputs. The op name, device and attributes stay frozen, and so does the
+// fingerprint used to look up the cached kernel: re-executing a cleared op
+// skips the per-dispatch attribute hashing that building a new TFE_Op would
+// incur. The number of inputs supplied before each execution must match the
+// first one.
+TF_CAPI_EXPORT extern void TFE_OpClearInputs(TFE_Op* op, TF_Status* status);
+
 typedef struct TFE_ProfilerContext TFE_ProfilerContext;
 
 // A profiler which will start profiling when creating the object and will stop
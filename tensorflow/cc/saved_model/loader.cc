@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "tensorflow/cc/saved_model/loader.h"
 
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include "tensorflow/cc/saved_model/constants.h"
 #include "tensorflow/cc/saved_model/reader.h"
@@ -29,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/saver.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 
 namespace tensorflow {
@@ -64,6 +67,57 @@ uint64 GetLatencyMicroseconds(const uint64 start_microseconds) {
   return end_microseconds - start_microseconds;
 }
 
+// Starts one background thread per variables data shard that reads the shard
+// sequentially into the OS page cache, overlapping variable data I/O with the
+// MetaGraphDef parse and session creation that precede the restore op.  By the
+// time the restore op runs, most of its reads hit warm pages instead of cold
+// storage.  The prefetch is purely advisory: read failures are ignored and the
+// restore op remains the source of truth.  Returns the threads; destroying
+// them joins the prefetch.  Disable by setting TF_SAVED_MODEL_PREFETCH_VARIABLES
+// to false (e.g. for models much larger than memory, where warming the page
+// cache cannot help).
+std::vector<std::unique_ptr<Thread>> PrefetchVariableFiles(
+    const string& export_dir) {
+  std::vector<std::unique_ptr<Thread>> threads;
+  bool prefetch_enabled = true;
+  ReadBoolFromEnvVar("TF_SAVED_MODEL_PREFETCH_VARIABLES", true,
+                     &prefetch_enabled)
+      .IgnoreError();
+  if (!prefetch_enabled) {
+    return threads;
+  }
+  const string variables_path =
+      io::JoinPath(export_dir, kSavedModelVariablesDirectory,
+                   kSavedModelVariablesFilename);
+  std::vector<string> data_files;
+  if (!Env::Default()
+           ->GetMatchingPaths(strings::StrCat(variables_path, ".data-*"),
+                              &data_files)
+           .ok()) {
+    return threads;
+  }
+  for (const string& data_file : data_files) {
+    threads.emplace_back(Env::Default()->StartThread(
+        ThreadOptions(), "saved_model_prefetch", [data_file] {
+          std::unique_ptr<RandomAccessFile> file;
+          if (!Env::Default()->NewRandomAccessFile(data_file, &file).ok()) {
+            return;
+          }
+          constexpr size_t kReadSize = 8 << 20;  // 8MB
+          std::unique_ptr<char[]> scratch(new char[kReadSize]);
+          uint64 offset = 0;
+          StringPiece result;
+          Status s;
+          do {
+            s = file->Read(offset, kReadSize, &result, scratch.get());
+            offset += result.size();
+            // Read() returns OUT_OF_RANGE at end of file.
+          } while (s.ok() && !result.empty());
+        }));
+  }
+  return threads;
+}
+
 Status LoadMetaGraphIntoSession(const MetaGraphDef& meta_graph_def,
                                 const SessionOptions& session_options,
                                 std::unique_ptr<Session>* session) {
@@ -263,6 +317,10 @@ Status LoadSavedModelInternal(const SessionOptions& session_options,
                               const std::unordered_set<string>& tags,
                               SavedModelBundle* const bundle) {
   const uint64 read_start_microseconds = Env::Default()->NowMicros();
+  // Warm the variables data files in the background while the MetaGraphDef is
+  // parsed and the session is created; joined when this function returns.
+  std::vector<std::unique_ptr<Thread>> prefetch_threads =
+      PrefetchVariableFiles(export_dir);
   TF_RETURN_IF_ERROR(ReadMetaGraphDefFromSavedModel(export_dir, tags,
                                                     &bundle->meta_graph_def));
 
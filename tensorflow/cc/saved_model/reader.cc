@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/protobuf/saved_model.pb.h"
 
 namespace tensorflow {
@@ -79,9 +80,23 @@ Status FindMetaGraphDef(const SavedModel& saved_model_proto,
 Status ReadMetaGraphDefFromSavedModel(const string& export_dir,
                                       const std::unordered_set<string>& tags,
                                       MetaGraphDef* const meta_graph_def) {
+#ifdef TENSORFLOW_LITE_PROTOS
   SavedModel saved_model_proto;
   TF_RETURN_IF_ERROR(ReadSavedModel(export_dir, &saved_model_proto));
   TF_RETURN_IF_ERROR(FindMetaGraphDef(saved_model_proto, tags, meta_graph_def));
+#else
+  // Parse the SavedModel on an arena. A large graph decomposes into millions
+  // of small node and attr messages; arena allocation keeps the parse off the
+  // global heap and makes freeing the transient SavedModel (which may hold
+  // several meta graphs besides the one requested) near-free. Only the
+  // matching MetaGraphDef is copied out, since it must outlive the arena.
+  protobuf::Arena arena;
+  SavedModel* saved_model_proto =
+      protobuf::Arena::CreateMessage<SavedModel>(&arena);
+  TF_RETURN_IF_ERROR(ReadSavedModel(export_dir, saved_model_proto));
+  TF_RETURN_IF_ERROR(
+      FindMetaGraphDef(*saved_model_proto, tags, meta_graph_def));
+#endif
   return Status::OK();
 }
 
@@ -0,0 +1,53 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/aot/multi_arch_cpu_function.h"
+
+#include <utility>
+
+namespace tensorflow {
+namespace tfcompile {
+
+int SelectCpuFunctionVariant(
+    const std::vector<CpuFunctionVariant>& variants,
+    const std::function<bool(port::CPUFeature)>& test_feature) {
+  for (int i = 0; i < static_cast<int>(variants.size()); ++i) {
+    const CpuFunctionVariant& variant = variants[i];
+    if (!variant.has_required_feature ||
+        test_feature(variant.required_feature)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+MultiArchCpuFunction::MultiArchCpuFunction(
+    std::vector<CpuFunctionVariant> variants)
+    : variants_(std::move(variants)),
+      selected_variant_(SelectCpuFunctionVariant(
+          variants_, [](port::CPUFeature feature) {
+            return port::TestCPUFeature(feature);
+          })) {}
+
+std::unique_ptr<XlaCompiledCpuFunction> MultiArchCpuFunction::Create(
+    XlaCompiledCpuFunction::AllocMode alloc_mode) const {
+  if (selected_variant_ < 0) {
+    return nullptr;
+  }
+  return variants_[selected_variant_].factory(alloc_mode);
+}
+
+}  // namespace tfcompile
+}  // namespace tensorflow
@@ -0,0 +1,115 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Load-time dispatch between several tfcompile-generated variants of the same
+// computation, each built for a different CPU feature level. This lets a
+// single binary carry e.g. an AVX-512 build and a baseline build of a hot
+// function, and pick the most advanced variant the host CPU can actually run.
+//
+// The tf_library_multiarch macro in tfcompile.bzl generates one class per
+// feature level (suffixed cpp_class) plus a cc_library grouping them; this
+// header provides the runtime selection.
+
+#ifndef TENSORFLOW_COMPILER_AOT_MULTI_ARCH_CPU_FUNCTION_H_
+#define TENSORFLOW_COMPILER_AOT_MULTI_ARCH_CPU_FUNCTION_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/compiler/tf2xla/xla_compiled_cpu_function.h"
+#include "tensorflow/core/platform/cpu_info.h"
+
+namespace tensorflow {
+namespace tfcompile {
+
+// Describes one compiled variant of a computation. Variants built above the
+// deployment baseline record the most advanced CPU feature their code may
+// use, checked with port::TestCPUFeature at selection time; the baseline
+// variant leaves has_required_feature false so it can run on any host.
+struct CpuFunctionVariant {
+  bool has_required_feature = false;
+  port::CPUFeature required_feature = port::MMX;
+
+  // Creates an instance of the generated class for this variant.
+  std::function<std::unique_ptr<XlaCompiledCpuFunction>(
+      XlaCompiledCpuFunction::AllocMode)>
+      factory;
+};
+
+// Builds the baseline variant for tfcompile-generated class Function.
+template <typename Function>
+CpuFunctionVariant MakeCpuFunctionVariant() {
+  CpuFunctionVariant variant;
+  variant.factory = [](XlaCompiledCpuFunction::AllocMode alloc_mode) {
+    return std::unique_ptr<XlaCompiledCpuFunction>(new Function(alloc_mode));
+  };
+  return variant;
+}
+
+// Builds a variant for tfcompile-generated class Function that requires
+// `feature`, e.g. port::AVX512F for a --target_features=+avx512f build.
+template <typename Function>
+CpuFunctionVariant MakeCpuFunctionVariant(port::CPUFeature feature) {
+  CpuFunctionVariant variant = MakeCpuFunctionVariant<Function>();
+  variant.has_required_feature = true;
+  variant.required_feature = feature;
+  return variant;
+}
+
+// Returns the index of the first variant in `variants` whose required
+// feature `test_feature` reports as supported, or -1 if no variant can run.
+// Callers list variants from most to least advanced, baseline last.
+// `test_feature` is injectable for testing; production callers use the
+// MultiArchCpuFunction wrapper below, which passes port::TestCPUFeature.
+int SelectCpuFunctionVariant(
+    const std::vector<CpuFunctionVariant>& variants,
+    const std::function<bool(port::CPUFeature)>& test_feature);
+
+// Groups the variants of one computation and selects among them based on the
+// host CPU. Selection happens once, at construction; Create then instantiates
+// the selected variant. Typical usage, with classes generated by
+// tf_library_multiarch:
+//
+//   MultiArchCpuFunction matmul({
+//       MakeCpuFunctionVariant<MatMulCompAvx512>(port::AVX512F),
+//       MakeCpuFunctionVariant<MatMulCompAvx2>(port::AVX2),
+//       MakeCpuFunctionVariant<MatMulComp>(),
+//   });
+//   std::unique_ptr<XlaCompiledCpuFunction> computation = matmul.Create();
+class MultiArchCpuFunction {
+ public:
+  explicit MultiArchCpuFunction(std::vector<CpuFunctionVariant> variants);
+
+  // Index into the variant list of the variant selected for this host, or -1
+  // if no listed variant can run here.
+  int selected_variant() const { return selected_variant_; }
+
+  // Instantiates the selected variant, or returns nullptr if no variant can
+  // run on this host. Thread-safe; each call creates a fresh instance.
+  std::unique_ptr<XlaCompiledCpuFunction> Create(
+      XlaCompiledCpuFunction::AllocMode alloc_mode =
+          XlaCompiledCpuFunction::AllocMode::ARGS_RESULTS_PROFILES_AND_TEMPS)
+      const;
+
+ private:
+  std::vector<CpuFunctionVariant> variants_;
+  int selected_variant_;
+};
+
+}  // namespace tfcompile
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_COMPILER_AOT_MULTI_ARCH_CPU_FUNCTION_H_
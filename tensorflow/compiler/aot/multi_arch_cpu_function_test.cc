@@ -0,0 +1,96 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/aot/multi_arch_cpu_function.h"
+
+#include <set>
+#include <utility>
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace tfcompile {
+namespace {
+
+// Builds a variant list shaped like a typical multi-arch deployment: an
+// AVX-512 build, an AVX2 build, and a featureless baseline, in preference
+// order. The factories are unused by selection and left empty.
+std::vector<CpuFunctionVariant> ThreeLevelVariants() {
+  std::vector<CpuFunctionVariant> variants(3);
+  variants[0].has_required_feature = true;
+  variants[0].required_feature = port::AVX512F;
+  variants[1].has_required_feature = true;
+  variants[1].required_feature = port::AVX2;
+  return variants;
+}
+
+// Returns a feature test function claiming support for exactly `features`.
+std::function<bool(port::CPUFeature)> SupportsOnly(
+    std::set<port::CPUFeature> features) {
+  return [features](port::CPUFeature feature) {
+    return features.count(feature) > 0;
+  };
+}
+
+TEST(SelectCpuFunctionVariant, PicksMostAdvancedSupported) {
+  std::vector<CpuFunctionVariant> variants = ThreeLevelVariants();
+  EXPECT_EQ(0, SelectCpuFunctionVariant(
+                   variants, SupportsOnly({port::AVX512F, port::AVX2})));
+}
+
+TEST(SelectCpuFunctionVariant, SkipsUnsupportedVariants) {
+  std::vector<CpuFunctionVariant> variants = ThreeLevelVariants();
+  EXPECT_EQ(1, SelectCpuFunctionVariant(variants, SupportsOnly({port::AVX2})));
+}
+
+TEST(SelectCpuFunctionVariant, FallsBackToBaseline) {
+  std::vector<CpuFunctionVariant> variants = ThreeLevelVariants();
+  EXPECT_EQ(2, SelectCpuFunctionVariant(variants, SupportsOnly({})));
+}
+
+TEST(SelectCpuFunctionVariant, ReturnsMinusOneWithoutBaseline) {
+  std::vector<CpuFunctionVariant> variants = ThreeLevelVariants();
+  variants.pop_back();  // Drop the baseline variant.
+  EXPECT_EQ(-1, SelectCpuFunctionVariant(variants, SupportsOnly({})));
+}
+
+TEST(SelectCpuFunctionVariant, RespectsRegistrationOrder) {
+  // If a less advanced variant is listed first, it wins even when the host
+  // supports both; the list order is the preference order.
+  std::vector<CpuFunctionVariant> variants = ThreeLevelVariants();
+  std::swap(variants[0], variants[1]);
+  EXPECT_EQ(0, SelectCpuFunctionVariant(
+                   variants, SupportsOnly({port::AVX512F, port::AVX2})));
+}
+
+TEST(MultiArchCpuFunction, CreateInvokesSelectedFactory) {
+  // A baseline variant has no feature requirement, so selection against the
+  // real host CPU deterministically picks it regardless of the test machine.
+  bool factory_called = false;
+  std::vector<CpuFunctionVariant> variants(1);
+  variants[0].factory =
+      [&factory_called](XlaCompiledCpuFunction::AllocMode alloc_mode) {
+        factory_called = true;
+        return std::unique_ptr<XlaCompiledCpuFunction>();
+      };
+  MultiArchCpuFunction function(std::move(variants));
+  EXPECT_EQ(0, function.selected_variant());
+  function.Create();
+  EXPECT_TRUE(factory_called);
+}
+
+}  // namespace
+}  // namespace tfcompile
+}  // namespace tensorflow
@@ -396,6 +396,98 @@ def tf_library(
             tags = tags,
         )
 
+def tf_library_multiarch(
+        name,
+        graph,
+        config,
+        variants,
+        cpp_class = None,
+        visibility = None,
+        testonly = None,
+        tfcompile_flags = None,
+        tfcompile_tool = "//tensorflow/compiler/aot:tfcompile",
+        include_standard_runtime_deps = True,
+        enable_xla_hlo_profiling = False,
+        deps = None,
+        tags = None):
+    """Compiles a TensorFlow graph once per CPU feature level.
+
+    Generates one tf_library target per variant, with the variant suffix
+    appended to both the target name and the generated C++ class, plus a
+    cc_library grouping all variants together with the runtime dispatch
+    helper.  Pick among the variants at load time with MultiArchCpuFunction
+    from //tensorflow/compiler/aot:multi_arch_cpu_function:
+
+      tf_library_multiarch(
+          name = "matmul",
+          config = "matmul.config.pbtxt",
+          cpp_class = "MatMulComp",
+          graph = "matmul.pb",
+          variants = {
+              "base": [],
+              "avx2": ["--target_features=+avx2,+fma"],
+              "avx512": ["--target_cpu=skylake-avx512"],
+          },
+      )
+
+    generates matmul_base, matmul_avx2 and matmul_avx512 tf_library targets
+    with classes MatMulCompBase, MatMulCompAvx2 and MatMulCompAvx512, and a
+    cc_library named matmul that exports all three.
+
+    Args:
+      name: The name of the grouping cc_library; also the prefix of the
+        per-variant tf_library targets.
+      graph: The TensorFlow GraphDef to compile, as for tf_library.
+      config: File containing tensorflow.tf2xla.Config proto, as for
+        tf_library.
+      variants: Dict mapping a variant suffix to the list of extra tfcompile
+        flags (typically --target_cpu and/or --target_features) selecting its
+        feature level.  An empty list compiles for the default target, which
+        serves as the baseline variant.
+      cpp_class: The name of the generated C++ class, as for tf_library.  Each
+        variant's class is cpp_class with the capitalized variant suffix
+        appended.
+      visibility: Bazel build visibility.
+      testonly: Bazel testonly attribute.
+      tfcompile_flags: List of flags passed to every variant, before the
+        per-variant flags.
+      tfcompile_tool: The tfcompile binary, as for tf_library.
+      include_standard_runtime_deps: As for tf_library.
+      enable_xla_hlo_profiling: As for tf_library.
+      deps: Extra deps for each variant's cc_library.
+      tags: Tags to apply to all generated targets.
+    """
+    variant_libs = []
+    for suffix, variant_flags in variants.items():
+        variant_name = name + "_" + suffix
+        tf_library(
+            name = variant_name,
+            graph = graph,
+            config = config,
+            cpp_class = cpp_class + suffix.capitalize(),
+            gen_test = False,
+            gen_benchmark = False,
+            visibility = visibility,
+            testonly = testonly,
+            tfcompile_flags = (tfcompile_flags or []) + variant_flags,
+            tfcompile_tool = tfcompile_tool,
+            include_standard_runtime_deps = include_standard_runtime_deps,
+            enable_xla_hlo_profiling = enable_xla_hlo_profiling,
+            deps = deps,
+            tags = tags,
+        )
+        variant_libs.append(":" + variant_name)
+
+    native.cc_library(
+        name = name,
+        visibility = visibility,
+        testonly = testonly,
+        deps = variant_libs + [
+            "//tensorflow/compiler/aot:multi_arch_cpu_function",
+        ],
+        tags = tags,
+    )
+
 def target_llvm_triple():
     """Returns the target LLVM triple to be used for compiling the target."""
 
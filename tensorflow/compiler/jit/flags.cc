@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <mutex>  // NOLINT
 
 #include "absl/strings/numbers.h"
@@ -116,6 +117,9 @@ void AllocateAndParseFlags() {
 
   ops_flags = new XlaOpsCommonFlags;
   ops_flags->tf_xla_always_defer_compilation = false;
+  ops_flags->tf_xla_persistent_cache_directory = "";
+  ops_flags->tf_xla_async_compilation = false;
+  ops_flags->tf_xla_alias_resource_updates = false;
 
   jitter_flags = new IntroduceFloatingPointJitterPassFlags;
   jitter_flags->jitter_amount = 1e-5;
@@ -125,6 +129,21 @@ void AllocateAndParseFlags() {
     return true;
   };
 
+  auto setter_for_batch_size_buckets = [](string sequence) {
+    std::vector<int64> buckets;
+    for (absl::string_view bucket_str :
+         absl::StrSplit(sequence, ',', absl::SkipEmpty())) {
+      int64 bucket;
+      if (!absl::SimpleAtoi(bucket_str, &bucket) || bucket <= 0) {
+        return false;
+      }
+      buckets.push_back(bucket);
+    }
+    std::sort(buckets.begin(), buckets.end());
+    ops_flags->tf_xla_batch_size_buckets = std::move(buckets);
+    return true;
+  };
+
   flag_list = new std::vector<Flag>(
       {Flag("tf_xla_enable_lazy_compilation",
             &build_ops_flags->tf_xla_enable_lazy_compilation, ""),
@@ -139,6 +158,25 @@ void AllocateAndParseFlags() {
 
        Flag("tf_xla_always_defer_compilation",
             &ops_flags->tf_xla_always_defer_compilation, ""),
+       Flag("tf_xla_async_compilation", &ops_flags->tf_xla_async_compilation,
+            "If true, compile XLA clusters in a background thread and run "
+            "them through the TF executor until the executable is ready."),
+       Flag("tf_xla_persistent_cache_directory",
+            &ops_flags->tf_xla_persistent_cache_directory,
+            "If non-empty, persist JIT compilation results to this directory "
+            "and reload them across process restarts."),
+       Flag("tf_xla_batch_size_buckets", setter_for_batch_size_buckets, "",
+            "Comma-separated list of batch sizes to compile XLA clusters "
+            "for.  The batch dimension of cluster inputs is padded up to the "
+            "next bucket and outputs are sliced back, so all batch sizes "
+            "within a bucket share one compilation.  Only sound for clusters "
+            "that treat batch rows independently."),
+       Flag("tf_xla_alias_resource_updates",
+            &ops_flags->tf_xla_alias_resource_updates,
+            "If true, alias the input buffers of modified resource variables "
+            "to the corresponding XLA cluster outputs so variables are "
+            "updated in place.  Only safe if nothing reads the variable's old "
+            "value while the cluster executes."),
 
        Flag("tf_introduce_floating_point_jitter_to_tensors",
             setter_for_jitter_tensor_names, "",
@@ -79,6 +79,33 @@ struct XlaOpsCommonFlags {
   // If true, _XlaCompile always refuses to compile the cluster, which means the
   // XLA clusters always run in the TF executor.  Defaults to false.
   bool tf_xla_always_defer_compilation;
+
+  // If true, clusters are compiled in a background thread while execution
+  // proceeds through the TF executor; the compiled executable is picked up
+  // once ready.  Avoids first-request latency spikes at the cost of a few
+  // uncompiled executions.  Defaults to false.
+  bool tf_xla_async_compilation;
+
+  // If non-empty, JIT compilation results are persisted to this directory and
+  // reloaded by later processes, keyed by cluster signature, device and
+  // TensorFlow version.  Defaults to empty (no persistence).
+  string tf_xla_persistent_cache_directory;
+
+  // If non-empty, the batch (leading) dimension of cluster arguments is
+  // rounded up to the next bucket in this sorted list before compilation, and
+  // inputs are padded (outputs sliced) to match at execution time.  This
+  // bounds the number of distinct compilations under dynamic batch sizes.
+  // Only sound for clusters that treat batch rows independently.  Defaults to
+  // empty (no bucketing).
+  std::vector<int64> tf_xla_batch_size_buckets;
+
+  // If true, clusters are compiled with modified resource variables aliased
+  // to their update outputs, so XLA writes the new value into the variable's
+  // existing buffer in place instead of allocating and filling a fresh result
+  // buffer. Avoids doubling the footprint of large variable updates, but is
+  // only safe if nothing reads the variable's old value while the cluster
+  // executes.  Defaults to false.
+  bool tf_xla_alias_resource_updates;
 };
 
 // Flags for the build_xla_ops pass.
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/kernels/xla_ops.h"
 
+#include <algorithm>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
 #include "tensorflow/compiler/jit/defs.h"
@@ -251,10 +253,41 @@ static Status BuildCompilationCache(OpKernelContext* ctx,
   return Status::OK();
 }
 
+// Rounds the batch (leading) dimension of the parameter arguments in `args`
+// up to the next bucket in `buckets` (sorted ascending), so that all batch
+// sizes within a bucket share one compilation.  The launch path pads the
+// inputs and slices the outputs to match.  Leaves `args` untouched when they
+// do not look like a batched computation: every parameter must have rank >= 1
+// and the same leading dimension, which must not exceed the largest bucket.
+// Constant and resource arguments are never modified.
+static void RoundBatchDimensionToBucket(
+    absl::Span<const int64> buckets, std::vector<XlaCompiler::Argument>* args) {
+  int64 batch_size = -1;
+  for (const XlaCompiler::Argument& arg : *args) {
+    if (arg.kind != XlaCompiler::Argument::kParameter) continue;
+    if (arg.shape.dims() == 0) return;
+    if (batch_size == -1) {
+      batch_size = arg.shape.dim_size(0);
+    } else if (arg.shape.dim_size(0) != batch_size) {
+      return;
+    }
+  }
+  if (batch_size <= 0) return;
+  auto it = std::lower_bound(buckets.begin(), buckets.end(), batch_size);
+  if (it == buckets.end() || *it == batch_size) return;
+  VLOG(1) << "Rounding batch size " << batch_size << " up to bucket " << *it;
+  for (XlaCompiler::Argument& arg : *args) {
+    if (arg.kind == XlaCompiler::Argument::kParameter) {
+      arg.shape.set_dim(0, *it);
+    }
+  }
+}
+
 static Status CompileToLocalExecutable(
     OpKernelContext* ctx, const NameAttrList& function,
     const XlaPlatformInfo& platform_info, absl::Span<const int> resources,
-    absl::Span<const int> constants, bool lazy, xla::LocalClient** client,
+    absl::Span<const int> constants,
+    XlaCompilationCache::CompileMode compile_mode, xla::LocalClient** client,
     std::map<int, OptionalTensor>* variables,
     const XlaCompiler::CompilationResult** kernel,
     xla::LocalExecutable** executable) {
@@ -310,13 +343,23 @@ static Status CompileToLocalExecutable(
   // Optimization: where possible, have the computation return a naked array
   // rather than a one-element tuple.
   compile_options.always_return_tuple = false;
+  // Updating variables in place is only implemented for the regular device
+  // launch path; XLA devices hand ownership of output buffers to XlaTensors
+  // and cannot share them with the input.
+  compile_options.alias_resource_update =
+      GetXlaOpsCommonFlags().tf_xla_alias_resource_updates &&
+      platform_info.xla_device_metadata() == nullptr;
 
   std::vector<XlaCompiler::Argument> args;
   TF_RETURN_IF_ERROR(XlaComputationLaunchContext::BuildXlaCompilerArguments(
       constant_args, *variables, ctx, &args));
-  return cache->Compile(options, function, args, compile_options,
-                        lazy ? XlaCompilationCache::CompileMode::kLazy
-                             : XlaCompilationCache::CompileMode::kStrict,
+  const std::vector<int64>& batch_size_buckets =
+      GetXlaOpsCommonFlags().tf_xla_batch_size_buckets;
+  if (!batch_size_buckets.empty() &&
+      platform_info.xla_device_metadata() == nullptr) {
+    RoundBatchDimensionToBucket(batch_size_buckets, &args);
+  }
+  return cache->Compile(options, function, args, compile_options, compile_mode,
                         kernel, executable);
 }
 
@@ -331,8 +374,9 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
 
   {
     Status s = CompileToLocalExecutable(
-        ctx, function_, platform_info_, resources_, constants_, /*lazy=*/false,
-        &client, &variables, &kernel, &executable);
+        ctx, function_, platform_info_, resources_, constants_,
+        XlaCompilationCache::CompileMode::kStrict, &client, &variables, &kernel,
+        &executable);
     if (!s.ok() && (platform_info_.device_type().type_string() == DEVICE_CPU ||
                     platform_info_.device_type().type_string() == DEVICE_GPU)) {
       // Suggest auto jit if the failure was with GPU or CPU.
@@ -352,8 +396,9 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
       client, platform_info_.allocator(),
       /*allocate_xla_tensors=*/platform_info_.is_on_xla_device(),
       platform_info_.UseMultipleStreams());
-  launch_context.PopulateInputs(ctx, kernel, variables,
-                                /*missing_ctx_input_prefix=*/0);
+  OP_REQUIRES_OK(ctx,
+                 launch_context.PopulateInputs(ctx, kernel, variables,
+                                               /*missing_ctx_input_prefix=*/0));
 
   // Execute the computation.
   VLOG(2) << "Executing computation.";
@@ -456,9 +501,17 @@ void XlaCompileOp::Compute(OpKernelContext* ctx) {
       cannot_compile_cluster) {
     executable = nullptr;
   } else {
+    XlaCompilationCache::CompileMode compile_mode = [&] {
+      if (must_compile_) {
+        return XlaCompilationCache::CompileMode::kStrict;
+      }
+      return GetXlaOpsCommonFlags().tf_xla_async_compilation
+                 ? XlaCompilationCache::CompileMode::kAsync
+                 : XlaCompilationCache::CompileMode::kLazy;
+    }();
     Status status = CompileToLocalExecutable(
-        ctx, function_, platform_info_, resources_, constants_,
-        /*lazy=*/!must_compile_, &client, &variables, &kernel, &executable);
+        ctx, function_, platform_info_, resources_, constants_, compile_mode,
+        &client, &variables, &kernel, &executable);
     if (must_compile_ || status.code() != error::UNIMPLEMENTED) {
       OP_REQUIRES_OK(ctx, status);
     }
@@ -525,9 +578,11 @@ void XlaRunOp::Compute(OpKernelContext* ctx) {
   // We're missing the must-be-constant inputs, tell `PopulateInputs`
   // about this.  We don't actually need these inputs because they've
   // already been baked into the compiled kernel.
-  launch_context.PopulateInputs(
-      ctx, closure.compilation_result(), closure.resource_var_snapshots(),
-      /*missing_ctx_input_prefix=*/closure.num_constant_args());
+  OP_REQUIRES_OK(
+      ctx, launch_context.PopulateInputs(
+               ctx, closure.compilation_result(),
+               closure.resource_var_snapshots(),
+               /*missing_ctx_input_prefix=*/closure.num_constant_args()));
 
   se::Stream* stream =
       ctx->op_device_context() ? ctx->op_device_context()->stream() : nullptr;
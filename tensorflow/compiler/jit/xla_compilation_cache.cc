@@ -19,6 +19,8 @@ limitations under the License.
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "tensorflow/compiler/jit/flags.h"
+#include "tensorflow/compiler/jit/xla_compilation_cache.pb.h"
 #include "tensorflow/compiler/tf2xla/shape_util.h"
 #include "tensorflow/compiler/tf2xla/type_util.h"
 #include "tensorflow/compiler/tf2xla/xla_context.h"
@@ -31,6 +33,8 @@ limitations under the License.
 #include "tensorflow/core/graph/graph_constructor.h"
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/public/version.h"
@@ -40,11 +44,30 @@ namespace tensorflow {
 
 constexpr int64 XlaCompilationCache::kDefaultCompilationThreshold;
 
+namespace {
+
+// Number of threads compiling clusters in the background when asynchronous
+// compilation is enabled.
+constexpr int kNumAsyncCompilerThreads = 10;
+
+}  // namespace
+
 XlaCompilationCache::XlaCompilationCache(xla::LocalClient* client,
                                          DeviceType device_type)
-    : client_(client), device_type_(std::move(device_type)) {}
+    : client_(client),
+      device_type_(std::move(device_type)),
+      persistent_cache_directory_(
+          GetXlaOpsCommonFlags().tf_xla_persistent_cache_directory) {
+  if (GetXlaOpsCommonFlags().tf_xla_async_compilation) {
+    async_compiler_threads_.reset(new thread::ThreadPool(
+        Env::Default(), "async_xla_compilation", kNumAsyncCompilerThreads));
+  }
+}
 
 XlaCompilationCache::~XlaCompilationCache() {
+  // Wait for any background compilations to finish; they write into cache
+  // entries owned by this object.
+  async_compiler_threads_.reset();
   // Ensure any use of our programs have completed by waiting for all stream
   // executors to complete.
   for (auto* executor : client_->backend().stream_executors()) {
@@ -164,6 +187,143 @@ Status XlaCompilationCache::BuildExecutable(
   return Status::OK();
 }
 
+string XlaCompilationCache::SerializeSignature(const Signature& signature) {
+  // An exact, deterministic byte encoding of the signature; unlike
+  // HumanString() it never abbreviates constant values, so equality of the
+  // serialized form implies equality of the signatures.
+  string serialized = signature.name;
+  for (const auto& arg : signature.arg_shapes) {
+    absl::StrAppend(&serialized, "|s", static_cast<int>(arg.first));
+    for (int64 dim : arg.second) {
+      absl::StrAppend(&serialized, ",", dim);
+    }
+  }
+  for (const Tensor& arg : signature.arg_values) {
+    absl::StrAppend(&serialized, "|v", static_cast<int>(arg.dtype()), ",",
+                    arg.shape().DebugString(), ",");
+    serialized.append(arg.tensor_data().data(), arg.tensor_data().size());
+  }
+  return serialized;
+}
+
+string XlaCompilationCache::PersistentCacheFileName(
+    const Signature& signature) const {
+  const uint64 fingerprint = Hash64(SerializeSignature(signature));
+  return io::JoinPath(
+      persistent_cache_directory_,
+      absl::StrCat("xla_cache_", device_type_.type_string(), "_",
+                   absl::Hex(fingerprint, absl::kZeroPad16), ".pb"));
+}
+
+Status XlaCompilationCache::LoadPersistentEntry(
+    const Signature& signature, XlaCompiler::CompilationResult* result) {
+  const string file_name = PersistentCacheFileName(signature);
+  XlaSerializedCacheEntry entry;
+  TF_RETURN_IF_ERROR(ReadBinaryProto(Env::Default(), file_name, &entry));
+  if (entry.tf_version() != TF_VERSION_STRING) {
+    return errors::NotFound("Persistent cache entry ", file_name,
+                            " was produced by TensorFlow ", entry.tf_version(),
+                            ", current version is ", TF_VERSION_STRING);
+  }
+  if (entry.device_type() != device_type_.type_string() ||
+      entry.signature() != SerializeSignature(signature)) {
+    return errors::NotFound("Persistent cache entry ", file_name,
+                            " does not match the requested signature");
+  }
+
+  result->input_mapping.assign(entry.input_mapping().begin(),
+                               entry.input_mapping().end());
+  result->xla_input_shapes.clear();
+  for (const xla::ShapeProto& shape : entry.xla_input_shapes()) {
+    result->xla_input_shapes.push_back(xla::Shape(shape));
+  }
+  result->xla_output_shape = xla::Shape(entry.xla_output_shape());
+  result->outputs.clear();
+  for (const XlaSerializedCacheEntry::Output& output_proto : entry.outputs()) {
+    XlaCompiler::OutputDescription output;
+    output.type = output_proto.type();
+    output.shape = TensorShape(output_proto.shape());
+    output.is_constant = output_proto.is_constant();
+    if (output.is_constant &&
+        !output.constant_value.FromProto(output_proto.constant_value())) {
+      return errors::DataLoss("Malformed constant value in persistent cache "
+                              "entry ",
+                              file_name);
+    }
+    output.input_index = output_proto.input_index();
+    output.is_tensor_list = output_proto.is_tensor_list();
+    result->outputs.push_back(std::move(output));
+  }
+  result->host_compute_metadata = entry.host_compute_metadata();
+  result->resource_updates.clear();
+  for (const XlaSerializedCacheEntry::ResourceUpdate& update_proto :
+       entry.resource_updates()) {
+    XlaCompiler::ResourceUpdate update;
+    update.input_index = update_proto.input_index();
+    update.type = update_proto.type();
+    update.shape = TensorShape(update_proto.shape());
+    update.modified = update_proto.modified();
+    for (const string& gradient :
+         update_proto.tensor_array_gradients_accessed()) {
+      update.tensor_array_gradients_accessed.insert(gradient);
+    }
+    result->resource_updates.push_back(std::move(update));
+  }
+  result->computation =
+      std::make_shared<xla::XlaComputation>(entry.hlo_module());
+  return Status::OK();
+}
+
+Status XlaCompilationCache::SavePersistentEntry(
+    const Signature& signature, const XlaCompiler::CompilationResult& result) {
+  XlaSerializedCacheEntry entry;
+  entry.set_signature(SerializeSignature(signature));
+  entry.set_signature_fingerprint(Hash64(entry.signature()));
+  entry.set_device_type(device_type_.type_string());
+  entry.set_tf_version(TF_VERSION_STRING);
+  for (int index : result.input_mapping) {
+    entry.add_input_mapping(index);
+  }
+  for (const xla::Shape& shape : result.xla_input_shapes) {
+    *entry.add_xla_input_shapes() = shape.ToProto();
+  }
+  *entry.mutable_xla_output_shape() = result.xla_output_shape.ToProto();
+  for (const XlaCompiler::OutputDescription& output : result.outputs) {
+    XlaSerializedCacheEntry::Output* output_proto = entry.add_outputs();
+    output_proto->set_type(output.type);
+    output.shape.AsProto(output_proto->mutable_shape());
+    output_proto->set_is_constant(output.is_constant);
+    if (output.is_constant) {
+      output.constant_value.AsProtoTensorContent(
+          output_proto->mutable_constant_value());
+    }
+    output_proto->set_input_index(output.input_index);
+    output_proto->set_is_tensor_list(output.is_tensor_list);
+  }
+  *entry.mutable_host_compute_metadata() = result.host_compute_metadata;
+  for (const XlaCompiler::ResourceUpdate& update : result.resource_updates) {
+    XlaSerializedCacheEntry::ResourceUpdate* update_proto =
+        entry.add_resource_updates();
+    update_proto->set_input_index(update.input_index);
+    update_proto->set_type(update.type);
+    update.shape.AsProto(update_proto->mutable_shape());
+    update_proto->set_modified(update.modified);
+    for (const string& gradient : update.tensor_array_gradients_accessed) {
+      update_proto->add_tensor_array_gradients_accessed(gradient);
+    }
+  }
+  *entry.mutable_hlo_module() = result.computation->proto();
+
+  // Write to a temporary file and rename so concurrent processes never
+  // observe a partially written entry.
+  Env* env = Env::Default();
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(persistent_cache_directory_));
+  const string file_name = PersistentCacheFileName(signature);
+  const string tmp_name = absl::StrCat(file_name, ".tmp.", random::New64());
+  TF_RETURN_IF_ERROR(WriteBinaryProto(env, tmp_name, entry));
+  return env->RenameFile(tmp_name, file_name);
+}
+
 Status XlaCompilationCache::Compile(
     const XlaCompiler::Options& options, const NameAttrList& function,
     absl::Span<const XlaCompiler::Argument> args,
@@ -172,14 +332,29 @@ Status XlaCompilationCache::Compile(
     const XlaCompiler::CompilationResult** out_compilation_result,
     xla::LocalExecutable** out_executable) {
   absl::optional<int64> compile_threshold;
-  if (compile_mode == CompileMode::kLazy) {
+  if (compile_mode == CompileMode::kLazy ||
+      compile_mode == CompileMode::kAsync) {
     compile_threshold = kDefaultCompilationThreshold;
   }
-  auto compile_fn = [&](XlaCompiler* compiler,
-                        XlaCompiler::CompilationResult* result) {
-    return compiler->CompileFunction(compile_options, function, args, result);
-  };
-  return CompileImpl(options, function, args, compile_fn,
+  std::function<Status(XlaCompiler*, XlaCompiler::CompilationResult*)>
+      compile_fn;
+  if (compile_mode == CompileMode::kAsync) {
+    // The compilation may run on a background thread after this call has
+    // returned, so the closure must own copies of everything it uses.
+    std::vector<XlaCompiler::Argument> args_copy(args.begin(), args.end());
+    compile_fn = [compile_options, function,
+                  args_copy](XlaCompiler* compiler,
+                             XlaCompiler::CompilationResult* result) {
+      return compiler->CompileFunction(compile_options, function, args_copy,
+                                       result);
+    };
+  } else {
+    compile_fn = [&](XlaCompiler* compiler,
+                     XlaCompiler::CompilationResult* result) {
+      return compiler->CompileFunction(compile_options, function, args, result);
+    };
+  }
+  return CompileImpl(options, function, args, compile_fn, compile_mode,
                      /*compile_threshold=*/compile_threshold,
                      out_compilation_result, out_executable);
 }
@@ -218,17 +393,85 @@ Status XlaCompilationCache::CompileSingleOp(
     return compiler->CompileSingleOp(compile_options, ctx->op_kernel().def(),
                                      args, result_dtypes, result);
   };
-  return CompileImpl(options, name, args, compile_op,
+  return CompileImpl(options, name, args, compile_op, CompileMode::kStrict,
                      /*compile_threshold=*/absl::nullopt,
                      out_compilation_result, out_executable);
 }
 
+void XlaCompilationCache::CompileEntryLocked(
+    const XlaCompiler::Options& options, const Signature& signature,
+    const string& cluster_name,
+    const std::function<Status(XlaCompiler* compiler,
+                               XlaCompiler::CompilationResult*)>& compile_fn,
+    Entry* entry) {
+  tensorflow::Env* env = tensorflow::Env::Default();
+  const uint64 compile_start_us = env->NowMicros();
+
+  XlaCompiler compiler(options);
+
+  // Try the persistent cache first: a hit skips the TensorFlow-side
+  // lowering of the cluster, and the executable is rebuilt from the stored
+  // HLO module below (the XLA client API offers no way to serialize a
+  // backend executable).
+  bool loaded_from_persistent_cache = false;
+  if (!persistent_cache_directory_.empty()) {
+    Status load_status =
+        LoadPersistentEntry(signature, &entry->compilation_result);
+    if (load_status.ok()) {
+      VLOG(1) << "Loaded persisted compilation for " << cluster_name;
+      loaded_from_persistent_cache = true;
+    } else {
+      VLOG(2) << "No usable persistent cache entry for " << cluster_name << ": "
+              << load_status.ToString();
+    }
+  }
+  if (!loaded_from_persistent_cache) {
+    entry->compilation_status =
+        compile_fn(&compiler, &entry->compilation_result);
+    if (!entry->compilation_status.ok()) {
+      return;
+    }
+  }
+  CHECK_EQ(entry->executable.get(), nullptr);
+  entry->compilation_status =
+      BuildExecutable(options, entry->compilation_result, &entry->executable);
+
+  if (!persistent_cache_directory_.empty() && !loaded_from_persistent_cache &&
+      entry->compilation_status.ok()) {
+    Status save_status =
+        SavePersistentEntry(signature, entry->compilation_result);
+    if (!save_status.ok()) {
+      LOG(WARNING) << "Failed to persist XLA compilation for " << cluster_name
+                   << ": " << save_status.ToString();
+    }
+  }
+
+  const uint64 compile_end_us = env->NowMicros();
+  const uint64 compile_time_us = compile_end_us - compile_start_us;
+  {
+    mutex_lock lock(cluster_compile_stats_mu_);
+    auto it = cluster_compile_stats_.find(cluster_name);
+    it->second.compile_count++;
+    it->second.cumulative_compile_time_us += compile_time_us;
+    VLOG(1) << "compiled " << cluster_name << " " << it->second.compile_count
+            << " times, compile time: " << compile_time_us
+            << " us, cumulative: " << it->second.cumulative_compile_time_us
+            << " us ("
+            << tensorflow::strings::HumanReadableElapsedTime(compile_time_us /
+                                                             1.0e6)
+            << " / "
+            << tensorflow::strings::HumanReadableElapsedTime(
+                   it->second.cumulative_compile_time_us / 1.0e6)
+            << ")";
+  }
+}
+
 Status XlaCompilationCache::CompileImpl(
     const XlaCompiler::Options& options, const NameAttrList& function,
     absl::Span<const XlaCompiler::Argument> args,
     const std::function<Status(XlaCompiler* compiler,
                                XlaCompiler::CompilationResult*)>& compile_fn,
-    absl::optional<int64> compile_threshold,
+    CompileMode compile_mode, absl::optional<int64> compile_threshold,
     const XlaCompiler::CompilationResult** out_compilation_result,
     xla::LocalExecutable** out_executable) {
   DCHECK_NE(out_executable, nullptr);
@@ -328,40 +571,39 @@ Status XlaCompilationCache::CompileImpl(
       return Status::OK();
     }
 
-    tensorflow::Env* env = tensorflow::Env::Default();
-    const uint64 compile_start_us = env->NowMicros();
-    // Do the actual JIT compilation without holding the lock (it can take
-    // a long time.)
+    if (compile_mode == CompileMode::kAsync) {
+      // Compile-behind: schedule the compilation on a background thread and
+      // report the entry as not yet compiled, so the caller keeps executing
+      // the cluster through the TF executor.  Once the background compile
+      // finishes, subsequent lookups return the executable.
+      if (!entry->compilation_scheduled) {
+        entry->compilation_scheduled = true;
+        VLOG(2) << "Scheduling async compilation for signature: "
+                << signature.HumanString();
+        // The task may outlive this call, so it captures everything it uses
+        // by value.  `entry` stays valid because cache entries are never
+        // evicted and the destructor drains the thread pool before
+        // destroying the cache.
+        XlaCompiler::Options options_copy = options;
+        string cluster_name = function.name();
+        async_compiler_threads_->Schedule([this, options_copy, signature,
+                                           cluster_name, compile_fn, entry] {
+          mutex_lock lock(entry->mu);
+          // A kStrict request may have compiled the entry synchronously while
+          // this task was waiting to run.
+          if (entry->compiled) return;
+          entry->compiled = true;
+          CompileEntryLocked(options_copy, signature, cluster_name, compile_fn,
+                             entry);
+        });
+      }
+      *out_compilation_result = nullptr;
+      *out_executable = nullptr;
+      return Status::OK();
+    }
 
-    XlaCompiler compiler(options);
     entry->compiled = true;
-
-    entry->compilation_status =
-        compile_fn(&compiler, &entry->compilation_result);
-    TF_RETURN_IF_ERROR(entry->compilation_status);
-    CHECK_EQ(entry->executable.get(), nullptr);
-    entry->compilation_status =
-        BuildExecutable(options, entry->compilation_result, &entry->executable);
-
-    const uint64 compile_end_us = env->NowMicros();
-    const uint64 compile_time_us = compile_end_us - compile_start_us;
-    {
-      mutex_lock lock(cluster_compile_stats_mu_);
-      auto it = cluster_compile_stats_.find(function.name());
-      it->second.compile_count++;
-      it->second.cumulative_compile_time_us += compile_time_us;
-      VLOG(1) << "compiled " << function.name() << " "
-              << it->second.compile_count
-              << " times, compile time: " << compile_time_us
-              << " us, cumulative: " << it->second.cumulative_compile_time_us
-              << " us ("
-              << tensorflow::strings::HumanReadableElapsedTime(compile_time_us /
-                                                               1.0e6)
-              << " / "
-              << tensorflow::strings::HumanReadableElapsedTime(
-                     it->second.cumulative_compile_time_us / 1.0e6)
-              << ")";
-    }
+    CompileEntryLocked(options, signature, function.name(), compile_fn, entry);
   }
   TF_RETURN_IF_ERROR(entry->compilation_status);
   *out_compilation_result = &entry->compilation_result;
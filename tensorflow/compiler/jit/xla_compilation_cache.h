@@ -49,6 +49,7 @@ class XlaCompilationCache : public ResourceBase {
   enum class CompileMode {
     kLazy,
     kStrict,
+    kAsync,
   };
 
   // Compiles a function into a XlaCompiler::CompilationResult that can be used
@@ -61,7 +62,11 @@ class XlaCompilationCache : public ResourceBase {
   // heuristics, the compilation cache may decide not to compile the cluster at
   // this time.  In this case it returns null into both `out_compilation_result`
   // and `out_executable`.  If `compile_mode` is `kStrict` then the compilation
-  // cache always attempts the compilation on a cache miss.
+  // cache always attempts the compilation on a cache miss.  If `compile_mode`
+  // is `kAsync` then the compilation runs on a background thread and null is
+  // returned into both output pointers until the executable is ready, so the
+  // caller can keep executing the cluster through the TF executor in the
+  // meantime.
   //
   // The result of compilation is written to `*compilation_result`, which must
   // be non-null. If `executable` is non-null, also builds an
@@ -118,6 +123,11 @@ class XlaCompilationCache : public ResourceBase {
       const NameAttrList& function,
       absl::Span<const XlaCompiler::Argument> args);
 
+  // Returns an exact byte serialization of `signature`, suitable for
+  // fingerprinting and for collision checks in the persistent cache:
+  // equality of the serialized forms implies equality of the signatures.
+  static string SerializeSignature(const Signature& signature);
+
  private:
   // Common implementation of Compile and CompileSingleOp.
   Status CompileImpl(
@@ -125,19 +135,53 @@ class XlaCompilationCache : public ResourceBase {
       absl::Span<const XlaCompiler::Argument> args,
       const std::function<Status(XlaCompiler* compiler,
                                  XlaCompiler::CompilationResult*)>& compile_fn,
-      absl::optional<int64> compile_threshold,
+      CompileMode compile_mode, absl::optional<int64> compile_threshold,
       const XlaCompiler::CompilationResult** out_compilation_result,
       xla::LocalExecutable** out_executable);
 
+  struct Entry;
+
+  // Compiles the cluster `cluster_name` into `entry` using `compile_fn`,
+  // consulting and updating the persistent on-disk cache and the cluster
+  // compile statistics. On failure the error is left in
+  // `entry->compilation_status`. Requires that `entry->mu` is held and that
+  // `entry->compiled` has been set to true by the caller.
+  void CompileEntryLocked(
+      const XlaCompiler::Options& options, const Signature& signature,
+      const string& cluster_name,
+      const std::function<Status(XlaCompiler* compiler,
+                                 XlaCompiler::CompilationResult*)>& compile_fn,
+      Entry* entry);
+
   // Takes `result` which has been compiled from a Tensorflow subgraph to a
   // XLA computation already, and generates an XLA LocalExecutable `executable`.
   Status BuildExecutable(const XlaCompiler::Options& options,
                          const XlaCompiler::CompilationResult& result,
                          std::unique_ptr<xla::LocalExecutable>* executable);
 
+  // Returns the file name a persistent cache entry for `signature` is stored
+  // under, derived from the signature fingerprint and the device type.
+  string PersistentCacheFileName(const Signature& signature) const;
+
+  // Attempts to populate `result` from the persistent on-disk cache. Returns
+  // a non-OK status if there is no usable entry (missing, produced by a
+  // different TF version, or a fingerprint collision).
+  Status LoadPersistentEntry(const Signature& signature,
+                             XlaCompiler::CompilationResult* result);
+
+  // Writes `result` to the persistent on-disk cache. Failures are returned to
+  // the caller, which logs and otherwise ignores them.
+  Status SavePersistentEntry(const Signature& signature,
+                             const XlaCompiler::CompilationResult& result);
+
   xla::LocalClient* const client_;
   const DeviceType device_type_;
 
+  // Directory holding persisted compilation results, from the
+  // --tf_xla_persistent_cache_directory flag. Empty if persistence is
+  // disabled.
+  const string persistent_cache_directory_;
+
   // The value associated with a cache entry.
   struct Entry {
     mutex mu;
@@ -145,6 +189,10 @@ class XlaCompilationCache : public ResourceBase {
     // Have we tried compiling this entry?
     bool compiled = false;
 
+    // Has a background compilation been scheduled for this entry?  Only used
+    // with CompileMode::kAsync.
+    bool compilation_scheduled GUARDED_BY(mu) = false;
+
     // The number of times a compilation with this signature has been requested.
     int64 request_count = 0;
 
@@ -185,6 +233,12 @@ class XlaCompilationCache : public ResourceBase {
   absl::flat_hash_map<string, ClusterCompileStats> cluster_compile_stats_
       GUARDED_BY(cluster_compile_stats_mu_);
 
+  // Pool running compilations scheduled with CompileMode::kAsync. Null unless
+  // the --tf_xla_async_compilation flag is set. Declared after the cache map
+  // (and reset first in the destructor) so that in-flight background
+  // compilations drain before the entries they write to are destroyed.
+  std::unique_ptr<thread::ThreadPool> async_compiler_threads_;
+
   // The number of times a lazy compilation must be requested for a specific
   // signature before  we attempt to compile it.
   static constexpr int64 kDefaultCompilationThreshold = 2;
@@ -50,5 +50,39 @@ TEST(XlaCompilationCacheTest, SignatureEquality) {
   }
 }
 
+TEST(XlaCompilationCacheTest, SerializedSignatureUniqueness) {
+  NameAttrList fn;
+  fn.set_name("afunction");
+  std::vector<XlaCompiler::Argument> args(1);
+  args[0].kind = XlaCompiler::Argument::kConstant;
+  args[0].type = DT_INT32;
+  args[0].shape = TensorShape({2});
+  args[0].constant_value = Tensor(DT_INT32, {2});
+  args[0].constant_value.vec<int32>()(0) = 1;
+  args[0].constant_value.vec<int32>()(1) = 2;
+  TF_ASSERT_OK_AND_ASSIGN(XlaCompilationCache::Signature s1,
+                          XlaCompilationCache::BuildSignature(fn, args));
+
+  // Same types and shapes but different constant values must serialize
+  // differently, since the compiled executable bakes the constants in.
+  args[0].constant_value.vec<int32>()(1) = 3;
+  TF_ASSERT_OK_AND_ASSIGN(XlaCompilationCache::Signature s2,
+                          XlaCompilationCache::BuildSignature(fn, args));
+
+  args[0].kind = XlaCompiler::Argument::kParameter;
+  TF_ASSERT_OK_AND_ASSIGN(XlaCompilationCache::Signature s3,
+                          XlaCompilationCache::BuildSignature(fn, args));
+
+  std::vector<XlaCompilationCache::Signature> signatures = {s1, s2, s3};
+  for (int i = 0; i < signatures.size(); ++i) {
+    for (int j = 0; j < signatures.size(); ++j) {
+      EXPECT_EQ(i == j,
+                XlaCompilationCache::SerializeSignature(signatures[i]) ==
+                    XlaCompilationCache::SerializeSignature(signatures[j]))
+          << signatures[i].HumanString() << " " << signatures[j].HumanString();
+    }
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -61,8 +61,8 @@ Status XlaCompileOnDemandOp::Run(OpKernelContext* ctx,
       /*allocate_xla_tensors=*/true,
       /*use_multiple_streams=*/metadata.UseMultipleStreams());
 
-  launch_context.PopulateInputs(ctx, result, variables,
-                                /*missing_ctx_input_prefix=*/0);
+  TF_RETURN_IF_ERROR(launch_context.PopulateInputs(
+      ctx, result, variables, /*missing_ctx_input_prefix=*/0));
 
   se::Stream* stream =
       ctx->op_device_context() ? ctx->op_device_context()->stream() : nullptr;
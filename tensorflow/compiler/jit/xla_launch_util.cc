@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/compiler/tf2xla/xla_compiler.h"
 #include "tensorflow/compiler/xla/client/client_library.h"
 #include "tensorflow/compiler/xla/client/local_client.h"
+#include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/statusor.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/function.h"
@@ -204,7 +205,40 @@ XlaComputationLaunchContext::XlaComputationLaunchContext(
   }
 }
 
-void XlaComputationLaunchContext::PopulateInputs(
+// Copies `t` into a freshly allocated tensor of shape `padded_shape`, which
+// must match `t` in all but the leading dimension.  The rows of `t` occupy a
+// contiguous prefix of the padded buffer; the rest is zeroed so that padded
+// rows cannot introduce NaNs or infinities.
+static Status PadTensorToShape(OpKernelContext* ctx, se::Stream* stream,
+                               const Tensor& t, const TensorShape& padded_shape,
+                               Tensor* padded) {
+  TF_RETURN_IF_ERROR(ctx->allocate_temp(t.dtype(), padded_shape, padded));
+  const size_t valid_bytes = t.TotalBytes();
+  const size_t pad_bytes = padded->TotalBytes() - valid_bytes;
+  if (stream) {
+    se::DeviceMemoryBase src = XlaTensor::DeviceMemoryFromTensor(t);
+    se::DeviceMemoryBase dst = XlaTensor::DeviceMemoryFromTensor(*padded);
+    if (valid_bytes > 0) {
+      stream->ThenMemcpyD2D(&dst, src, valid_bytes);
+    }
+    if (pad_bytes > 0) {
+      se::DeviceMemoryBase tail(
+          static_cast<char*>(dst.opaque()) + valid_bytes, pad_bytes);
+      stream->ThenMemZero(&tail, pad_bytes);
+    }
+  } else {
+    char* dst = static_cast<char*>(DMAHelper::base(padded));
+    if (valid_bytes > 0) {
+      memcpy(dst, DMAHelper::base(&t), valid_bytes);
+    }
+    if (pad_bytes > 0) {
+      memset(dst + valid_bytes, 0, pad_bytes);
+    }
+  }
+  return Status::OK();
+}
+
+Status XlaComputationLaunchContext::PopulateInputs(
     OpKernelContext* ctx, const XlaCompiler::CompilationResult* kernel,
     const std::map<int, OptionalTensor>& variables,
     int missing_ctx_input_prefix) {
@@ -228,6 +262,44 @@ void XlaComputationLaunchContext::PopulateInputs(
       t = &(ctx->input(arg_num - missing_ctx_input_prefix));
     }
 
+    // If the kernel was compiled for a bucketed batch size, the input is
+    // smaller than the compiled-for shape in the leading dimension; copy it
+    // into a zero-padded scratch buffer of the compiled shape.
+    if (!shape.IsTuple() &&
+        xla::ShapeUtil::ByteSizeOf(shape) > t->TotalBytes()) {
+      TensorShape padded_shape;
+      TF_RETURN_IF_ERROR(XLAShapeToTensorShape(shape, &padded_shape));
+      if (padded_shape.dims() != t->dims() || padded_shape.dims() == 0 ||
+          padded_shape.dim_size(0) < t->dim_size(0)) {
+        return errors::Internal(
+            "Compiled shape ", padded_shape.DebugString(),
+            " is not a batch-padded version of input shape ",
+            t->shape().DebugString());
+      }
+      for (int d = 1; d < padded_shape.dims(); ++d) {
+        if (padded_shape.dim_size(d) != t->dim_size(d)) {
+          return errors::Internal(
+              "Compiled shape ", padded_shape.DebugString(),
+              " is not a batch-padded version of input shape ",
+              t->shape().DebugString());
+        }
+      }
+      if (real_batch_size_ != -1 && (real_batch_size_ != t->dim_size(0) ||
+                                     bucketed_batch_size_ !=
+                                         padded_shape.dim_size(0))) {
+        return errors::Internal(
+            "Inconsistent batch padding across cluster inputs");
+      }
+      real_batch_size_ = t->dim_size(0);
+      bucketed_batch_size_ = padded_shape.dim_size(0);
+
+      Tensor padded;
+      TF_RETURN_IF_ERROR(
+          PadTensorToShape(ctx, stream, *t, padded_shape, &padded));
+      padding_tensors_.push_back(padded);
+      t = &padding_tensors_.back();
+    }
+
     if (use_multiple_streams_) {
       CHECK(stream) << "Must have a stream available when using XLA tensors!";
       XlaTensor* xla_tensor = XlaTensor::FromTensor(t);
@@ -255,6 +327,7 @@ void XlaComputationLaunchContext::PopulateInputs(
       arg_ptrs_[i] = arg_buffers_[i].get();
     }
   }
+  return Status::OK();
 }
 
 Status XlaComputationLaunchContext::PopulateOutputs(
@@ -342,8 +415,15 @@ Status XlaComputationLaunchContext::PopulateOutputs(
         xla_tensor->set_host_tensor(const_tensor);
       }
     } else {
-      const TensorShape& shape = kernel->outputs[i].shape;
+      TensorShape shape = kernel->outputs[i].shape;
       const DataType& type = kernel->outputs[i].type;
+      // Outputs batched at a bucketed size are sliced back to the real batch;
+      // since the batch is the leading dimension, the valid rows are a
+      // contiguous prefix of the XLA output buffer.
+      if (bucketed_batch_size_ != -1 && shape.dims() > 0 &&
+          shape.dim_size(0) == bucketed_batch_size_) {
+        shape.set_dim(0, real_batch_size_);
+      }
       VLOG(2) << "Retval " << i << " shape " << shape.DebugString() << " type "
               << DataTypeString(type);
       if (type == DT_RESOURCE) {
@@ -432,6 +512,16 @@ Status XlaComputationLaunchContext::PopulateOutputs(
       *variable_infos[i].var()->tensor() = output_tensor;
     } else {
       se::DeviceMemoryBase buffer = output.buffer({output_num});
+      if (buffer.is_null() && write.shape.num_elements() > 0) {
+        // The computation aliased this update to the variable's input
+        // parameter (see XlaCompiler::CompileOptions::alias_resource_update)
+        // and wrote the new value into the input buffer in place, so the
+        // variable already holds the result.
+        VLOG(2) << "Variable write " << i << " aliased to input "
+                << write.input_index << "; updated in place";
+        ++output_num;
+        continue;
+      }
       output.set_buffer(xla::OwningDeviceMemory(), {output_num});
       Tensor output_tensor = XlaTensorBuffer::MakeTensor(
           write.type, write.shape, buffer, allocator);
@@ -160,10 +160,15 @@ class XlaComputationLaunchContext {
   // missing and adjusts input indices accordingly.  All elements in kernel's
   // input_mapping must be greater than or equal to `missing_ctx_input_prefix`
   // (in other words, no inputs actually required by the kernel can be missing).
-  void PopulateInputs(OpKernelContext* ctx,
-                      const XlaCompiler::CompilationResult* kernel,
-                      const std::map<int, OptionalTensor>& variables,
-                      int missing_ctx_input_prefix);
+  //
+  // If the kernel was compiled with a bucketed batch dimension (see the
+  // --tf_xla_batch_size_buckets flag), inputs whose leading dimension is
+  // smaller than the compiled one are copied into zero-padded scratch buffers
+  // of the compiled shape; PopulateOutputs slices the outputs back.
+  Status PopulateInputs(OpKernelContext* ctx,
+                        const XlaCompiler::CompilationResult* kernel,
+                        const std::map<int, OptionalTensor>& variables,
+                        int missing_ctx_input_prefix);
 
   // Given the XLA output in `output`, populate all outputs of `ctx`.  Also
   // writes out the resource variable updates.
@@ -191,6 +196,15 @@ class XlaComputationLaunchContext {
   bool use_multiple_streams_;
   std::vector<std::unique_ptr<xla::ShapedBuffer>> arg_buffers_;
   std::vector<xla::ShapedBuffer*> arg_ptrs_;
+
+  // Scratch tensors holding inputs that were zero-padded to a bucketed batch
+  // size; they must stay alive until the computation has run.
+  std::vector<Tensor> padding_tensors_;
+
+  // When batch bucketing is in effect, the actual and compiled-for batch
+  // sizes; -1 if no input needed padding.
+  int64 real_batch_size_ = -1;
+  int64 bucketed_batch_size_ = -1;
 };
 
 // A simple TensorBuffer implementation that allows us to create Tensors that
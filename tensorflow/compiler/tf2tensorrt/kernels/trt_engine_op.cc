@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/compiler/tf2tensorrt/convert/utils.h"
 #include "tensorflow/compiler/tf2tensorrt/plugin/trt_plugin_factory.h"
 #include "tensorflow/compiler/tf2tensorrt/utils/trt_allocator.h"
+#include "tensorflow/compiler/tf2tensorrt/utils/trt_engine_instance.pb.h"  // NOLINT
 #include "tensorflow/compiler/tf2tensorrt/utils/trt_logger.h"
 #include "tensorflow/compiler/tf2tensorrt/utils/trt_lru_cache.h"
 #include "tensorflow/compiler/tf2tensorrt/utils/trt_resources.h"
@@ -31,6 +32,11 @@ limitations under the License.
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
@@ -38,6 +44,7 @@ limitations under the License.
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 #if GOOGLE_CUDA
 #if GOOGLE_TENSORRT
@@ -99,6 +106,26 @@ class TRTEngineOp : public AsyncOpKernel {
       const std::vector<TensorShape>& actual_input_shapes,
       std::vector<TensorShape>* engine_input_shapes);
 
+  // Return the file persisted engines for this op's segment are stored under.
+  string EngineStoreFileName() const;
+
+  // Fill `metadata` with the segment fingerprint, TensorRT version and GPU
+  // compute capability of the current process; serialized engines are only
+  // usable when all three match.
+  Status GetEngineBuildEnvironment(OpKernelContext* ctx,
+                                   TRTEngineStoreMetadata* metadata);
+
+  // Load engines persisted by a previous process into `cache_res`. Returns a
+  // non-OK status if there is no store file or it was produced for a
+  // different segment, TensorRT version or GPU.
+  Status LoadPersistedEngines(OpKernelContext* ctx,
+                              TRTEngineCacheResource* cache_res);
+
+  // Persist all successfully built engines in `cache_res` to the store file,
+  // replacing its previous contents.
+  Status SavePersistedEngines(OpKernelContext* ctx,
+                              TRTEngineCacheResource* cache_res);
+
   std::vector<string> input_nodes_;
   std::vector<string> output_nodes_;
 
@@ -139,6 +166,18 @@ class TRTEngineOp : public AsyncOpKernel {
   // If true, create calibration graph for INT8 mode. Otherwise, we are using
   // user-provided quantization ranges.
   bool use_calibration_;
+
+  // Fingerprint of the serialized segment, keying the persistent engine
+  // store.
+  uint64 segment_fingerprint_;
+
+  // Directory holding persisted serialized engines, from the
+  // TF_TRT_ENGINE_CACHE_PATH environment variable. Empty if persistence is
+  // disabled.
+  string engine_store_path_;
+
+  // Whether we have already tried loading persisted engines in this process.
+  bool engine_store_checked_ GUARDED_BY(engine_mutex_) = false;
 };
 
 #define TYPECASE(dt, X, Y)                                    \
@@ -188,6 +227,12 @@ TRTEngineOp::TRTEngineOp(OpKernelConstruction* context)
   // read serialized_engine
   OP_REQUIRES_OK(context,
                  context->GetAttr("serialized_segment", &serialized_segment_));
+  // Fingerprint the segment before its backing string is released below; it
+  // keys the persistent engine store.
+  segment_fingerprint_ = Hash64(serialized_segment_);
+  OP_REQUIRES_OK(context,
+                 ReadStringFromEnvVar("TF_TRT_ENGINE_CACHE_PATH",
+                                      /*default_val=*/"", &engine_store_path_));
   OP_REQUIRES_OK(context,
                  context->GetAttr("workspace_size_bytes", &workspace_size_));
   OP_REQUIRES_OK(context, context->GetAttr("static_engine", &static_engine_));
@@ -518,6 +563,139 @@ bool TRTEngineOp::ExecuteTrtEngine(OpKernelContext* ctx,
   return !kRetry;
 }
 
+string TRTEngineOp::EngineStoreFileName() const {
+  return io::JoinPath(
+      engine_store_path_,
+      StrCat("trt_engines_", absl::Hex(segment_fingerprint_, absl::kZeroPad16),
+             ".records"));
+}
+
+Status TRTEngineOp::GetEngineBuildEnvironment(
+    OpKernelContext* ctx, TRTEngineStoreMetadata* metadata) {
+  metadata->set_segment_fingerprint(segment_fingerprint_);
+  metadata->set_trt_version(getInferLibVersion());
+  int cc_major = 0;
+  int cc_minor = 0;
+  if (!ctx->op_device_context()
+           ->stream()
+           ->parent()
+           ->GetDeviceDescription()
+           .cuda_compute_capability(&cc_major, &cc_minor)) {
+    return errors::Internal("Failed to get CUDA compute capability");
+  }
+  metadata->set_compute_capability_major(cc_major);
+  metadata->set_compute_capability_minor(cc_minor);
+  return Status::OK();
+}
+
+Status TRTEngineOp::LoadPersistedEngines(OpKernelContext* ctx,
+                                         TRTEngineCacheResource* cache_res) {
+  const string file_name = EngineStoreFileName();
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(ctx->env()->NewRandomAccessFile(file_name, &file));
+  auto reader = absl::make_unique<io::RecordReader>(file.get());
+
+  // The first record identifies the environment the engines were built in;
+  // serialized engines are only usable with the exact TensorRT version and
+  // GPU compute capability they were built for.
+  uint64 offset = 0;
+  string record;
+  TF_RETURN_IF_ERROR(reader->ReadRecord(&offset, &record));
+  TRTEngineStoreMetadata metadata;
+  if (!metadata.ParseFromString(record)) {
+    return errors::DataLoss("Malformed engine store metadata in ", file_name);
+  }
+  TRTEngineStoreMetadata current;
+  TF_RETURN_IF_ERROR(GetEngineBuildEnvironment(ctx, &current));
+  if (metadata.segment_fingerprint() != current.segment_fingerprint() ||
+      metadata.trt_version() != current.trt_version() ||
+      metadata.compute_capability_major() !=
+          current.compute_capability_major() ||
+      metadata.compute_capability_minor() !=
+          current.compute_capability_minor()) {
+    return errors::FailedPrecondition(
+        "Persisted engines in ", file_name,
+        " were built for a different segment, TensorRT version or GPU "
+        "compute capability");
+  }
+
+  auto allocator = cache_res->allocator_.get();
+  int num_loaded_engines = 0;
+  do {
+    Status status = reader->ReadRecord(&offset, &record);
+    if (errors::IsOutOfRange(status)) break;
+    TF_RETURN_IF_ERROR(status);
+    TRTEngineInstance engine_instance;
+    if (!engine_instance.ParseFromString(record)) {
+      return errors::DataLoss("Malformed engine record in ", file_name);
+    }
+    std::vector<TensorShape> engine_input_shapes;
+    for (const TensorShapeProto& shape : engine_instance.input_shapes()) {
+      engine_input_shapes.emplace_back(shape);
+    }
+    TrtUniquePtrType<IRuntime> infer(nvinfer1::createInferRuntime(logger));
+    infer->setGpuAllocator(allocator);
+    TrtUniquePtrType<nvinfer1::ICudaEngine> engine(infer->deserializeCudaEngine(
+        engine_instance.serialized_engine().c_str(),
+        engine_instance.serialized_engine().size(),
+        PluginFactoryTensorRT::GetInstance()));
+    if (!engine) {
+      return errors::DataLoss("Failed to deserialize engine from ", file_name);
+    }
+    auto raw_engine = engine.get();
+    cache_res->cache_.emplace(
+        engine_input_shapes,
+        absl::make_unique<EngineContext>(
+            std::move(engine), TrtUniquePtrType<nvinfer1::IExecutionContext>(
+                                   raw_engine->createExecutionContext())));
+    ++num_loaded_engines;
+  } while (1);
+  LOG(INFO) << "Loaded " << num_loaded_engines << " persisted TRT engine(s) "
+            << "for " << name() << " from " << file_name;
+  return Status::OK();
+}
+
+Status TRTEngineOp::SavePersistedEngines(OpKernelContext* ctx,
+                                         TRTEngineCacheResource* cache_res) {
+  Env* env = ctx->env();
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(engine_store_path_));
+  const string file_name = EngineStoreFileName();
+  // Write to a temporary file and rename so concurrent processes never
+  // observe a partially written store.
+  const string tmp_name = StrCat(file_name, ".tmp.", random::New64());
+  int num_engines = 0;
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_RETURN_IF_ERROR(env->NewWritableFile(tmp_name, &file));
+    io::RecordWriter writer(file.get());
+    TRTEngineStoreMetadata metadata;
+    TF_RETURN_IF_ERROR(GetEngineBuildEnvironment(ctx, &metadata));
+    TF_RETURN_IF_ERROR(writer.WriteRecord(metadata.SerializeAsString()));
+    for (const auto& pair : cache_res->cache_) {
+      // Empty contexts mark engines that failed to build; don't persist
+      // those.
+      if (pair.second->cuda_engine == nullptr) continue;
+      TRTEngineInstance engine_instance;
+      for (const TensorShape& shape : pair.first) {
+        shape.AsProto(engine_instance.add_input_shapes());
+      }
+      TrtUniquePtrType<nvinfer1::IHostMemory> engine_data(
+          pair.second->cuda_engine->serialize());
+      engine_instance.set_serialized_engine(engine_data->data(),
+                                            engine_data->size());
+      TF_RETURN_IF_ERROR(
+          writer.WriteRecord(engine_instance.SerializeAsString()));
+      ++num_engines;
+    }
+    TF_RETURN_IF_ERROR(writer.Close());
+    TF_RETURN_IF_ERROR(file->Close());
+  }
+  TF_RETURN_IF_ERROR(env->RenameFile(tmp_name, file_name));
+  VLOG(1) << "Persisted " << num_engines << " TRT engine(s) for " << name()
+          << " to " << file_name;
+  return Status::OK();
+}
+
 EngineContext* TRTEngineOp::GetEngine(
     const std::vector<TensorShape>& input_shapes, OpKernelContext* ctx) {
   static EngineContext empty_context;
@@ -556,6 +734,19 @@ EngineContext* TRTEngineOp::GetEngine(
     return &empty_context;
   }
 
+  // On the first use of the cache in this process, try to reload engines
+  // persisted by a previous one. A store file built for a different segment,
+  // TensorRT version or GPU is ignored; the engines are simply rebuilt.
+  if (!engine_store_path_.empty() && !static_engine_ &&
+      !engine_store_checked_) {
+    engine_store_checked_ = true;
+    Status load_status = LoadPersistedEngines(ctx, cache_res);
+    if (!load_status.ok()) {
+      VLOG(1) << "No usable persisted engines for " << name() << ": "
+              << load_status;
+    }
+  }
+
   // Handle the static engine case. For static engines, the cache will have a
   // single element containing the only engine.
   if (static_engine_) {
@@ -654,6 +845,13 @@ EngineContext* TRTEngineOp::GetEngine(
                                                    std::move(exec_context)));
     VLOG(1) << "Added new engine to cache of " << name()
             << ". Cache size: " << cache.size();
+    if (!engine_store_path_.empty()) {
+      Status save_status = SavePersistedEngines(ctx, cache_res);
+      if (!save_status.ok()) {
+        LOG(WARNING) << "Failed to persist TRT engines for " << name() << ": "
+                     << save_status;
+      }
+    }
   }
   return cache.at(engine_input_shapes).get();
 }
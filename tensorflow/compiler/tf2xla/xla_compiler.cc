@@ -18,6 +18,7 @@ limitations under the License.
 #include <numeric>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/memory/memory.h"
 #include "absl/types/variant.h"
 #include "tensorflow/compiler/tf2xla/graph_compiler.h"
@@ -155,6 +156,11 @@ Status ExecuteGraph(XlaContext* xla_context, std::unique_ptr<Graph> graph,
 //   `resource_updates` is a ResourceUpdate, whose `index` is the index of a
 //   resource variable argument to the computation to be updated, and `type` is
 //   the type of the final output.
+// - If `alias_resource_update` is true, the input parameter of each modified
+//   resource variable is aliased to its update output via the builder, so XLA
+//   may reuse the input buffer for the result. `input_mapping` maps parameter
+//   positions to argument indices and must be the mapping produced by
+//   BuildArguments.
 Status BuildComputation(
     const std::vector<XlaCompiler::Argument>& args,
     const std::vector<XlaExpression>& retvals,
@@ -163,6 +169,7 @@ Status BuildComputation(
     std::unique_ptr<xla::XlaOp> token_output,
     const XlaCompiler::ShapeRepresentationFn& shape_representation_fn,
     bool return_updated_values_for_all_resources, bool always_return_tuple,
+    bool alias_resource_update, absl::Span<const int> input_mapping,
     xla::XlaBuilder* builder, xla::XlaComputation* computation,
     int* num_computation_outputs, int* num_nonconst_outputs,
     std::vector<XlaCompiler::OutputDescription>* outputs,
@@ -260,6 +267,11 @@ Status BuildComputation(
               return a->arg_num() < b->arg_num();
             });
 
+  // Pairs of (output position, parameter number) to alias, collected while
+  // appending resource updates below and applied before the computation is
+  // built, once the final output arity is known.
+  std::vector<std::pair<int64, int64>> aliases;
+
   for (const XlaResource* resource : arg_resources) {
     DCHECK_LT(resource->arg_num(), args.size());
     const XlaCompiler::Argument& arg = args[resource->arg_num()];
@@ -301,6 +313,19 @@ Status BuildComputation(
         retval_index_and_layout.emplace_back(
             elems.size(), resource->representation_shape()->layout());
       }
+
+      // Alias the variable's input parameter to this update output so XLA may
+      // write the new value into the input buffer in place. Restricted to
+      // plain variables: TensorArrays and their gradients pack into tuples
+      // whose shape need not match the input parameter.
+      if (alias_resource_update && modified && arg.initialized &&
+          resource->kind() == XlaResource::kVariable &&
+          resource->tensor_array_gradients().empty()) {
+        auto it = absl::c_find(input_mapping, resource->arg_num());
+        if (it != input_mapping.end()) {
+          aliases.emplace_back(elems.size(), it - input_mapping.begin());
+        }
+      }
       elems.push_back(handle);
     }
   }
@@ -320,6 +345,19 @@ Status BuildComputation(
     xla::GetTupleElement(tuple, 0);
   }
 
+  // Now that the output arity is known, register the resource update aliases
+  // collected above with the builder.
+  const bool returns_tuple = always_return_tuple || elems.size() != 1;
+  for (const auto& alias : aliases) {
+    if (returns_tuple) {
+      builder->SetUpAlias(/*output_index=*/{alias.first},
+                          /*param_number=*/alias.second, /*param_index=*/{});
+    } else {
+      builder->SetUpAlias(/*output_index=*/{}, /*param_number=*/alias.second,
+                          /*param_index=*/{});
+    }
+  }
+
   xla::StatusOr<xla::XlaComputation> computation_status = builder->Build();
   if (!computation_status.ok()) {
     return computation_status.status();
@@ -1206,7 +1244,10 @@ Status XlaCompiler::CompileGraph(
       options.is_entry_computation ? options_.shape_representation_fn
                                    : ShapeRepresentationFn{},
       options.return_updated_values_for_all_resources,
-      options.always_return_tuple, &builder, result->computation.get(),
+      options.always_return_tuple,
+      options.alias_resource_update && options.is_entry_computation &&
+          !options.use_tuple_arg,
+      result->input_mapping, &builder, result->computation.get(),
       &num_computation_outputs, &num_nonconst_outputs, &result->outputs,
       &result->resource_updates, &result->xla_output_shape));
 
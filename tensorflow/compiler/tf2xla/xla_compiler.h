@@ -212,6 +212,15 @@ class XlaCompiler {
 
     // True when we should add XLA input & output to the graph/function.
     bool add_token_input_output = false;
+
+    // If 'alias_resource_update' is true, the input parameters of modified
+    // resource variables are aliased to the corresponding resource update
+    // outputs, allowing XLA to update the variable's buffer in place instead
+    // of allocating (and copying into) a fresh result buffer. The caller must
+    // guarantee that no other reader observes the variable's old value while
+    // the computation runs. Only meaningful for the entry computation with
+    // use_tuple_arg=false.
+    bool alias_resource_update = false;
   };
 
   struct OutputDescription {
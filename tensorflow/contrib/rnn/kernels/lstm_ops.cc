@@ -41,32 +41,19 @@ typedef Eigen::GpuDevice GPUDevice;
 
 namespace functor {
 
+// Elementwise gate math shared by the single-step and the batched
+// multi-timestep forward paths. Expects icfo to already hold the pre-gate
+// activations [x, h_prev] * w + b.
 template <typename T>
-void LSTMBlockCellFpropWithEigen(
-    const LSTMBlockCell& cell, OpKernelContext* ctx, const CPUDevice& d,
-    const float forget_bias, const float cell_clip, bool use_peephole,
-    typename TTypes<T>::ConstMatrix x, typename TTypes<T>::ConstMatrix cs_prev,
-    typename TTypes<T>::ConstMatrix h_prev, typename TTypes<T>::ConstMatrix w,
-    typename TTypes<T>::ConstVec wci, typename TTypes<T>::ConstVec wcf,
-    typename TTypes<T>::ConstVec wco, typename TTypes<T>::ConstVec b,
-    typename TTypes<T>::Matrix xh, typename TTypes<T>::Matrix i,
-    typename TTypes<T>::Matrix cs, typename TTypes<T>::Matrix f,
-    typename TTypes<T>::Matrix o, typename TTypes<T>::Matrix ci,
-    typename TTypes<T>::Matrix co, typename TTypes<T>::Matrix icfo,
-    typename TTypes<T>::Matrix h) {
-  // Concat xh = [x, h].
-  xh.slice(cell.xh_x_offsets(), cell.xh_x_extents()).device(d) = x;
-  xh.slice(cell.xh_h_offsets(), cell.xh_h_extents()).device(d) = h_prev;
-
-  // states1 = xh * w + b
-  typename TTypes<T>::ConstMatrix const_xh(xh.data(), xh.dimensions());
-  TensorBlasGemm<CPUDevice, T, false /* USE_CUBLAS */>::compute(
-      ctx, d, false, false, typename gemm_compute_type<T>::type(1.f), const_xh,
-      w, typename gemm_compute_type<T>::type(0.f), icfo);
-  Eigen::array<Eigen::DenseIndex, 2> b_shape({1, b.dimensions()[0]});
-  Eigen::array<Eigen::DenseIndex, 2> broadcast_shape({cell.batch_size(), 1});
-  icfo.device(d) += b.reshape(b_shape).broadcast(broadcast_shape);
-
+void LSTMBlockCellGatesWithEigen(
+    const LSTMBlockCell& cell, const CPUDevice& d, const float forget_bias,
+    const float cell_clip, bool use_peephole,
+    typename TTypes<T>::ConstMatrix cs_prev, typename TTypes<T>::ConstVec wci,
+    typename TTypes<T>::ConstVec wcf, typename TTypes<T>::ConstVec wco,
+    typename TTypes<T>::Matrix i, typename TTypes<T>::Matrix cs,
+    typename TTypes<T>::Matrix f, typename TTypes<T>::Matrix o,
+    typename TTypes<T>::Matrix ci, typename TTypes<T>::Matrix co,
+    typename TTypes<T>::Matrix icfo, typename TTypes<T>::Matrix h) {
   Eigen::array<Eigen::DenseIndex, 2> p_shape({1, cell.cell_size()});
   Eigen::array<Eigen::DenseIndex, 2> p_broadcast_shape({cell.batch_size(), 1});
 
@@ -122,6 +109,37 @@ void LSTMBlockCellFpropWithEigen(
   h.device(d) = o * co;
 }
 
+template <typename T>
+void LSTMBlockCellFpropWithEigen(
+    const LSTMBlockCell& cell, OpKernelContext* ctx, const CPUDevice& d,
+    const float forget_bias, const float cell_clip, bool use_peephole,
+    typename TTypes<T>::ConstMatrix x, typename TTypes<T>::ConstMatrix cs_prev,
+    typename TTypes<T>::ConstMatrix h_prev, typename TTypes<T>::ConstMatrix w,
+    typename TTypes<T>::ConstVec wci, typename TTypes<T>::ConstVec wcf,
+    typename TTypes<T>::ConstVec wco, typename TTypes<T>::ConstVec b,
+    typename TTypes<T>::Matrix xh, typename TTypes<T>::Matrix i,
+    typename TTypes<T>::Matrix cs, typename TTypes<T>::Matrix f,
+    typename TTypes<T>::Matrix o, typename TTypes<T>::Matrix ci,
+    typename TTypes<T>::Matrix co, typename TTypes<T>::Matrix icfo,
+    typename TTypes<T>::Matrix h) {
+  // Concat xh = [x, h].
+  xh.slice(cell.xh_x_offsets(), cell.xh_x_extents()).device(d) = x;
+  xh.slice(cell.xh_h_offsets(), cell.xh_h_extents()).device(d) = h_prev;
+
+  // states1 = xh * w + b
+  typename TTypes<T>::ConstMatrix const_xh(xh.data(), xh.dimensions());
+  TensorBlasGemm<CPUDevice, T, false /* USE_CUBLAS */>::compute(
+      ctx, d, false, false, typename gemm_compute_type<T>::type(1.f), const_xh,
+      w, typename gemm_compute_type<T>::type(0.f), icfo);
+  Eigen::array<Eigen::DenseIndex, 2> b_shape({1, b.dimensions()[0]});
+  Eigen::array<Eigen::DenseIndex, 2> broadcast_shape({cell.batch_size(), 1});
+  icfo.device(d) += b.reshape(b_shape).broadcast(broadcast_shape);
+
+  LSTMBlockCellGatesWithEigen<T>(cell, d, forget_bias, cell_clip, use_peephole,
+                                 cs_prev, wci, wcf, wco, i, cs, f, o, ci, co,
+                                 icfo, h);
+}
+
 template <typename Device, typename T, bool USE_CUBLAS>
 void LSTMBlockCellBpropWithEigen(
     const LSTMBlockCell& cell, OpKernelContext* ctx, const Device& d,
@@ -815,6 +833,153 @@ class SliceHelper {
   const Device& device_;
 };
 
+// Runs the forward time-step loop of BlockLSTM.
+template <typename Device, typename T, bool USE_CUBLAS>
+struct BlockLSTMFpropLoop {
+  static void Run(OpKernelContext* ctx, const Device& device,
+                  const float forget_bias, const float cell_clip,
+                  const bool use_peephole, const int64 seq_len_max,
+                  const int64 batch_size, const int64 input_size,
+                  const int64 cell_size, const Tensor* x,
+                  const Tensor* cs_prev_tensor, const Tensor* h_prev_tensor,
+                  const Tensor* w_tensor, const Tensor* wci_tensor,
+                  const Tensor* wcf_tensor, const Tensor* wco_tensor,
+                  const Tensor* b_tensor, Tensor* xh_tensor,
+                  Tensor* icfo_tensor, Tensor* i_out, Tensor* cs_out,
+                  Tensor* f_out, Tensor* o_out, Tensor* ci_out, Tensor* co_out,
+                  Tensor* h_out) {
+    SliceHelper<Device, T> slicer(ctx);
+    for (int64 t = 0; t < seq_len_max; ++t) {
+      const Tensor x_tensor = slicer.InputSlice(*x, t, "x");
+      const Tensor& cs_prev_tensor2 =
+          t == 0 ? *cs_prev_tensor
+                 : slicer.OutputSlice(cs_out, t - 1, "cs_prev");
+      const Tensor& h_prev_tensor2 =
+          t == 0 ? *h_prev_tensor : slicer.OutputSlice(h_out, t - 1, "h_prev");
+
+      Tensor i_tensor = slicer.OutputSlice(i_out, t, "i_out");
+      Tensor cs_tensor = slicer.OutputSlice(cs_out, t, "cs_out");
+      Tensor f_tensor = slicer.OutputSlice(f_out, t, "f_out");
+      Tensor o_tensor = slicer.OutputSlice(o_out, t, "o_out");
+      Tensor ci_tensor = slicer.OutputSlice(ci_out, t, "ci_out");
+      Tensor co_tensor = slicer.OutputSlice(co_out, t, "co_out");
+      Tensor h_tensor = slicer.OutputSlice(h_out, t, "h_out");
+
+      functor::LSTMBlockCellFprop<Device, T, USE_CUBLAS>(batch_size, input_size,
+                                                         cell_size)(
+          ctx, device, forget_bias, cell_clip, use_peephole,
+          x_tensor.matrix<T>(), cs_prev_tensor2.matrix<T>(),
+          h_prev_tensor2.matrix<T>(), w_tensor->matrix<T>(),
+          wci_tensor->vec<T>(), wcf_tensor->vec<T>(), wco_tensor->vec<T>(),
+          b_tensor->vec<T>(), xh_tensor->matrix<T>(), i_tensor.matrix<T>(),
+          cs_tensor.matrix<T>(), f_tensor.matrix<T>(), o_tensor.matrix<T>(),
+          ci_tensor.matrix<T>(), co_tensor.matrix<T>(),
+          icfo_tensor->matrix<T>(), h_tensor.matrix<T>());
+      slicer.FinishTimeStep();
+    }
+  }
+};
+
+// CPU specialization: the input contribution x_t * w_x of every valid time
+// step is independent of the recurrence, so it is computed together with the
+// bias in one large GEMM up front. The per-step work is then only the
+// recurrent GEMM h_{t-1} * w_h, accumulated into the precomputed gate
+// activations, plus the elementwise gate math. The recurrent half of the
+// weight matrix is copied once into an aligned scratch tensor instead of
+// being re-sliced out of w every step.
+template <typename T>
+struct BlockLSTMFpropLoop<CPUDevice, T, false /* USE_CUBLAS */> {
+  static void Run(OpKernelContext* ctx, const CPUDevice& device,
+                  const float forget_bias, const float cell_clip,
+                  const bool use_peephole, const int64 seq_len_max,
+                  const int64 batch_size, const int64 input_size,
+                  const int64 cell_size, const Tensor* x,
+                  const Tensor* cs_prev_tensor, const Tensor* h_prev_tensor,
+                  const Tensor* w_tensor, const Tensor* wci_tensor,
+                  const Tensor* wcf_tensor, const Tensor* wco_tensor,
+                  const Tensor* b_tensor, Tensor* xh_tensor,
+                  Tensor* icfo_tensor, Tensor* i_out, Tensor* cs_out,
+                  Tensor* f_out, Tensor* o_out, Tensor* ci_out, Tensor* co_out,
+                  Tensor* h_out) {
+    if (seq_len_max <= 0) return;
+
+    // w splits row-wise into the input weights w_x and the recurrent weights
+    // w_h; w_x is aligned at the start of w, w_h is packed into scratch.
+    typename TTypes<T>::ConstMatrix w(w_tensor->matrix<T>());
+    typename TTypes<T>::ConstMatrix w_x(w.data(), input_size,
+                                        cell_size * 4);
+    Tensor w_h_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(
+                            DataTypeToEnum<T>::v(),
+                            TensorShape({cell_size, cell_size * 4}),
+                            &w_h_tensor));
+    auto w_h = w_h_tensor.matrix<T>();
+    w_h.device(device) =
+        w.slice(Eigen::array<Eigen::DenseIndex, 2>({input_size, 0}),
+                Eigen::array<Eigen::DenseIndex, 2>({cell_size, cell_size * 4}));
+    typename TTypes<T>::ConstMatrix const_w_h(w_h.data(), w_h.dimensions());
+
+    // One GEMM computes x_t * w_x + b for all valid time steps at once.
+    Tensor xw_tensor;
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_temp(
+                 DataTypeToEnum<T>::v(),
+                 TensorShape({seq_len_max * batch_size, cell_size * 4}),
+                 &xw_tensor));
+    auto xw = xw_tensor.matrix<T>();
+    typename TTypes<T>::ConstMatrix x_all(
+        x->flat<T>().data(), seq_len_max * batch_size, input_size);
+    functor::TensorBlasGemm<CPUDevice, T, false /* USE_CUBLAS */>::compute(
+        ctx, device, false, false,
+        typename functor::gemm_compute_type<T>::type(1.f), x_all, w_x,
+        typename functor::gemm_compute_type<T>::type(0.f), xw);
+    typename TTypes<T>::ConstVec b(b_tensor->vec<T>());
+    Eigen::array<Eigen::DenseIndex, 2> b_shape({1, b.dimensions()[0]});
+    Eigen::array<Eigen::DenseIndex, 2> broadcast_shape(
+        {seq_len_max * batch_size, 1});
+    xw.device(device) += b.reshape(b_shape).broadcast(broadcast_shape);
+
+    functor::LSTMBlockCell cell(batch_size, input_size, cell_size);
+    Eigen::array<Eigen::DenseIndex, 2> icfo_extents(
+        {batch_size, cell_size * 4});
+    SliceHelper<CPUDevice, T> slicer(ctx);
+    for (int64 t = 0; t < seq_len_max; ++t) {
+      const Tensor& cs_prev_tensor2 =
+          t == 0 ? *cs_prev_tensor
+                 : slicer.OutputSlice(cs_out, t - 1, "cs_prev");
+      const Tensor& h_prev_tensor2 =
+          t == 0 ? *h_prev_tensor : slicer.OutputSlice(h_out, t - 1, "h_prev");
+
+      Tensor i_tensor = slicer.OutputSlice(i_out, t, "i_out");
+      Tensor cs_tensor = slicer.OutputSlice(cs_out, t, "cs_out");
+      Tensor f_tensor = slicer.OutputSlice(f_out, t, "f_out");
+      Tensor o_tensor = slicer.OutputSlice(o_out, t, "o_out");
+      Tensor ci_tensor = slicer.OutputSlice(ci_out, t, "ci_out");
+      Tensor co_tensor = slicer.OutputSlice(co_out, t, "co_out");
+      Tensor h_tensor = slicer.OutputSlice(h_out, t, "h_out");
+
+      // icfo = xw[t] + h_prev * w_h
+      auto icfo = icfo_tensor->matrix<T>();
+      Eigen::array<Eigen::DenseIndex, 2> icfo_offsets({t * batch_size, 0});
+      icfo.device(device) = xw.slice(icfo_offsets, icfo_extents);
+      functor::TensorBlasGemm<CPUDevice, T, false /* USE_CUBLAS */>::compute(
+          ctx, device, false, false,
+          typename functor::gemm_compute_type<T>::type(1.f),
+          h_prev_tensor2.matrix<T>(), const_w_h,
+          typename functor::gemm_compute_type<T>::type(1.f), icfo);
+
+      functor::LSTMBlockCellGatesWithEigen<T>(
+          cell, device, forget_bias, cell_clip, use_peephole,
+          cs_prev_tensor2.matrix<T>(), wci_tensor->vec<T>(),
+          wcf_tensor->vec<T>(), wco_tensor->vec<T>(), i_tensor.matrix<T>(),
+          cs_tensor.matrix<T>(), f_tensor.matrix<T>(), o_tensor.matrix<T>(),
+          ci_tensor.matrix<T>(), co_tensor.matrix<T>(), icfo,
+          h_tensor.matrix<T>());
+      slicer.FinishTimeStep();
+    }
+  }
+};
+
 }  // namespace
 
 template <typename Device, typename T, bool USE_CUBLAS>
@@ -957,35 +1122,12 @@ class BlockLSTMOp : public OpKernel {
     const Device& device = ctx->eigen_device<Device>();
 
     const int64 seq_len_max = seq_len_max_tensor->scalar<int64>()();
-    SliceHelper<Device, T> slicer(ctx);
-    for (int64 t = 0; t < seq_len_max; ++t) {
-      const Tensor x_tensor = slicer.InputSlice(*x, t, "x");
-      const Tensor& cs_prev_tensor2 =
-          t == 0 ? *cs_prev_tensor
-                 : slicer.OutputSlice(cs_out, t - 1, "cs_prev");
-      const Tensor& h_prev_tensor2 =
-          t == 0 ? *h_prev_tensor : slicer.OutputSlice(h_out, t - 1, "h_prev");
-
-      Tensor i_tensor = slicer.OutputSlice(i_out, t, "i_out");
-      Tensor cs_tensor = slicer.OutputSlice(cs_out, t, "cs_out");
-      Tensor f_tensor = slicer.OutputSlice(f_out, t, "f_out");
-      Tensor o_tensor = slicer.OutputSlice(o_out, t, "o_out");
-      Tensor ci_tensor = slicer.OutputSlice(ci_out, t, "ci_out");
-      Tensor co_tensor = slicer.OutputSlice(co_out, t, "co_out");
-      Tensor h_tensor = slicer.OutputSlice(h_out, t, "h_out");
-
-      functor::LSTMBlockCellFprop<Device, T, USE_CUBLAS>(batch_size, input_size,
-                                                         cell_size)(
-          ctx, device, forget_bias_, cell_clip_, use_peephole_,
-          x_tensor.matrix<T>(), cs_prev_tensor2.matrix<T>(),
-          h_prev_tensor2.matrix<T>(), w_tensor->matrix<T>(),
-          wci_tensor->vec<T>(), wcf_tensor->vec<T>(), wco_tensor->vec<T>(),
-          b_tensor->vec<T>(), xh_tensor.matrix<T>(), i_tensor.matrix<T>(),
-          cs_tensor.matrix<T>(), f_tensor.matrix<T>(), o_tensor.matrix<T>(),
-          ci_tensor.matrix<T>(), co_tensor.matrix<T>(), icfo_tensor.matrix<T>(),
-          h_tensor.matrix<T>());
-      slicer.FinishTimeStep();
-    }
+    BlockLSTMFpropLoop<Device, T, USE_CUBLAS>::Run(
+        ctx, device, forget_bias_, cell_clip_, use_peephole_, seq_len_max,
+        batch_size, input_size, cell_size, x, cs_prev_tensor, h_prev_tensor,
+        w_tensor, wci_tensor, wcf_tensor, wco_tensor, b_tensor, &xh_tensor,
+        &icfo_tensor, i_out, cs_out, f_out, o_out, ci_out, co_out, h_out);
+    if (!ctx->status().ok()) return;
 
     if (seq_len_max < timelen) {
       Tensor cs_tensor = cs_out->Slice(seq_len_max, timelen);
@@ -13,11 +13,13 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <atomic>
 
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
 
 #include "tensorflow/core/common_runtime/allocator_retry.h"
+#include "tensorflow/core/framework/allocator_telemetry.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/lib/core/bits.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
@@ -27,12 +29,31 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+namespace {
+// Returns true iff the per-size-class front cache for small allocations is
+// enabled via TF_BFC_SMALL_ALLOC_CACHE.
+bool SmallAllocCacheEnabled() {
+  static const bool enabled = [] {
+    bool value = false;
+    Status status =
+        ReadBoolFromEnvVar("TF_BFC_SMALL_ALLOC_CACHE", false, &value);
+    if (!status.ok()) {
+      LOG(ERROR) << "SmallAllocCacheEnabled: " << status.error_message();
+    }
+    return value;
+  }();
+  return enabled;
+}
+}  // namespace
+
 BFCAllocator::BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
                            bool allow_growth, const string& name)
-    : sub_allocator_(sub_allocator),
+    : small_alloc_cache_enabled_(SmallAllocCacheEnabled()),
+      sub_allocator_(sub_allocator),
       name_(name),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1) {
@@ -201,6 +222,9 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
   if (r != nullptr) {
     return r;
   } else {
+    // Give back any small allocations parked in the front caches so the
+    // retries below can coalesce and reuse that memory.
+    FlushSmallAllocCaches();
     static const int64 kMaxMillisToWait = 10000;  // 10 seconds
     r = retry_helper_.AllocateRaw(
         [this, &allocation_attr](size_t a, size_t nb, bool v) {
@@ -217,6 +241,24 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
 
 void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
                                 const AllocationAttributes& allocation_attr) {
+  if (SmallCacheApplies(num_bytes, allocation_attr)) {
+    const size_t rounded_bytes = RoundedBytes(num_bytes);
+    void* ptr = TryAllocateFromSmallCache(rounded_bytes);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+    ptr = AllocateRawUncached(unused_alignment, num_bytes, allocation_attr);
+    if (ptr != nullptr) {
+      RecordSmallAllocation(ptr, rounded_bytes);
+    }
+    return ptr;
+  }
+  return AllocateRawUncached(unused_alignment, num_bytes, allocation_attr);
+}
+
+void* BFCAllocator::AllocateRawUncached(
+    size_t unused_alignment, size_t num_bytes,
+    const AllocationAttributes& allocation_attr) {
   VLOG(1) << "AllocateRaw " << Name() << "  " << num_bytes;
   if (allocation_attr.no_retry_on_failure) {
     // Return immediately upon the first failure if this is for allocating an
@@ -226,8 +268,17 @@ void* BFCAllocator::AllocateRaw(size_t unused_alignment, size_t num_bytes,
     if (allocation_attr.freed_by_func != nullptr) {
       freed_by_count = allocation_attr.freed_by_func();
     }
-    void* result = AllocateRawInternal(unused_alignment, num_bytes,
-                                       dump_log_on_failure, freed_by_count);
+    void* result = AllocateRawInternal(
+        unused_alignment, num_bytes,
+        small_alloc_cache_enabled_ ? false : dump_log_on_failure,
+        freed_by_count);
+    if (result == nullptr && small_alloc_cache_enabled_) {
+      // Flush the small-allocation front caches and try once more before
+      // giving up.
+      FlushSmallAllocCaches();
+      result = AllocateRawInternal(unused_alignment, num_bytes,
+                                   dump_log_on_failure, freed_by_count);
+    }
     if (result == nullptr) {
       static std::atomic<int32> log_counter{0};
       int32 counter_value = log_counter.load(std::memory_order_relaxed);
@@ -257,6 +308,30 @@ size_t BFCAllocator::RoundedBytes(size_t bytes) {
   return rounded_bytes;
 }
 
+int64 BFCAllocator::LargestFreeChunkBytes() {
+  for (BinNum b = kNumBins - 1; b >= 0; --b) {
+    const Bin::FreeChunkSet& free_chunks = BinFromIndex(b)->free_chunks;
+    if (!free_chunks.empty()) {
+      // Chunks within a bin are sorted by size.
+      return ChunkFromHandle(*free_chunks.rbegin())->size;
+    }
+  }
+  return 0;
+}
+
+void BFCAllocator::PublishTelemetry() {
+  const int64 bytes_free =
+      static_cast<int64>(total_region_allocated_bytes_) - stats_.bytes_in_use;
+  int64 fragmentation_ppm = 0;
+  if (bytes_free > 0) {
+    fragmentation_ppm =
+        1000000 - LargestFreeChunkBytes() * 1000000 / bytes_free;
+  }
+  allocator_telemetry::UpdateUsage(name_, stats_.bytes_in_use,
+                                   stats_.peak_bytes_in_use,
+                                   fragmentation_ppm);
+}
+
 void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
                                         size_t num_bytes,
                                         bool dump_log_on_failure,
@@ -346,6 +421,13 @@ void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
         stats_.largest_alloc_size =
             std::max<std::size_t>(stats_.largest_alloc_size, chunk->size);
 
+        if (allocator_telemetry::Enabled()) {
+          allocator_telemetry::RecordAllocation(name_, chunk->size);
+          if ((stats_.num_allocs & 255) == 0) {
+            PublishTelemetry();
+          }
+        }
+
         VLOG(4) << "Returning: " << chunk->ptr;
         if (VLOG_IS_ON(4)) {
           LOG(INFO) << "A: " << RenderOccupancy();
@@ -397,12 +479,87 @@ void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
 }
 
 void BFCAllocator::DeallocateRaw(void* ptr) {
+  if (small_alloc_cache_enabled_ && TryReturnToSmallCache(ptr)) {
+    return;
+  }
   VLOG(1) << "DeallocateRaw " << Name() << " "
           << (ptr ? RequestedSize(ptr) : 0);
   DeallocateRawInternal(ptr);
   retry_helper_.NotifyDealloc();
 }
 
+void* BFCAllocator::TryAllocateFromSmallCache(size_t rounded_bytes) {
+  const int size_class = rounded_bytes / kMinAllocationSize - 1;
+  SmallSizeClassCache* cache = &small_caches_[size_class];
+  mutex_lock l(cache->mu);
+  if (cache->free_ptrs.empty()) {
+    return nullptr;
+  }
+  void* ptr = cache->free_ptrs.back();
+  cache->free_ptrs.pop_back();
+  return ptr;
+}
+
+void BFCAllocator::RecordSmallAllocation(const void* ptr,
+                                         size_t rounded_bytes) {
+  const int size_class = rounded_bytes / kMinAllocationSize - 1;
+  PtrClassShard* shard =
+      &ptr_shards_[std::hash<const void*>()(ptr) % kNumPtrShards];
+  mutex_lock l(shard->mu);
+  shard->ptr_class[ptr] = size_class;
+}
+
+bool BFCAllocator::TryReturnToSmallCache(void* ptr) {
+  PtrClassShard* shard =
+      &ptr_shards_[std::hash<const void*>()(ptr) % kNumPtrShards];
+  int size_class = -1;
+  {
+    mutex_lock l(shard->mu);
+    auto it = shard->ptr_class.find(ptr);
+    if (it == shard->ptr_class.end()) {
+      return false;
+    }
+    size_class = it->second;
+  }
+  SmallSizeClassCache* cache = &small_caches_[size_class];
+  {
+    mutex_lock l(cache->mu);
+    if (cache->free_ptrs.size() < kSmallClassCacheCapacity) {
+      cache->free_ptrs.push_back(ptr);
+      return true;
+    }
+  }
+  // The class cache is full: hand the pointer back to the global free
+  // lists and forget about it.
+  {
+    mutex_lock l(shard->mu);
+    shard->ptr_class.erase(ptr);
+  }
+  return false;
+}
+
+void BFCAllocator::FlushSmallAllocCaches() {
+  if (!small_alloc_cache_enabled_) {
+    return;
+  }
+  for (int i = 0; i < kNumSmallSizeClasses; ++i) {
+    std::vector<void*> ptrs;
+    {
+      mutex_lock l(small_caches_[i].mu);
+      ptrs.swap(small_caches_[i].free_ptrs);
+    }
+    for (void* ptr : ptrs) {
+      PtrClassShard* shard =
+          &ptr_shards_[std::hash<const void*>()(ptr) % kNumPtrShards];
+      {
+        mutex_lock l(shard->mu);
+        shard->ptr_class.erase(ptr);
+      }
+      DeallocateRawInternal(ptr);
+    }
+  }
+}
+
 void BFCAllocator::DeallocateRawInternal(void* ptr) {
   if (ptr == nullptr) {
     VLOG(2) << "tried to deallocate nullptr";
@@ -696,6 +853,19 @@ void BFCAllocator::DumpMemoryLog(size_t num_bytes) {
 
 absl::optional<AllocatorStats> BFCAllocator::GetStats() {
   mutex_lock l(lock_);
+  // Report the largest contiguous free chunk so callers can monitor
+  // fragmentation: an OOM with a large free byte total but a small largest
+  // free block means the region is fragmented, not exhausted.
+  int64 largest_free_chunk = 0;
+  for (BinNum bin_num = 0; bin_num < kNumBins; bin_num++) {
+    Bin* b = BinFromIndex(bin_num);
+    for (const ChunkHandle h : b->free_chunks) {
+      const Chunk* c = ChunkFromHandle(h);
+      largest_free_chunk =
+          std::max(largest_free_chunk, static_cast<int64>(c->size));
+    }
+  }
+  stats_.largest_free_block_bytes = largest_free_chunk;
   return stats_;
 }
 
@@ -335,6 +335,13 @@ class BFCAllocator : public Allocator {
   void* FindChunkPtr(BinNum bin_num, size_t rounded_bytes, size_t num_bytes,
                      uint64 freed_before) EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Returns the size of the largest free chunk, used for the fragmentation
+  // telemetry gauge. O(kNumBins).
+  int64 LargestFreeChunkBytes() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Publishes usage and fragmentation gauges via allocator_telemetry.
+  void PublishTelemetry() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Splits the chunk specified by 'h' into two chunks, one at least
   // of size 'num_bytes'.
   void SplitChunk(ChunkHandle h, size_t num_bytes)
@@ -438,6 +445,66 @@ class BFCAllocator : public Allocator {
   // of the available memory.
   bool started_backpedal_ = false;
 
+  // Optional front cache for small allocations, enabled by setting
+  // TF_BFC_SMALL_ALLOC_CACHE=true.  Small requests are segregated into
+  // kMinAllocationSize-granularity size classes, each guarded by its own
+  // mutex, so hot small allocations bypass lock_ and the bin search
+  // entirely.  Cached pointers remain "in use" from the point of view of
+  // the BFC region; they are flushed back whenever a global allocation
+  // fails.  Note that cache hits do not update stats_, and RequestedSize()
+  // for a recycled pointer reports the size of the request that first
+  // allocated it.
+  static const int kNumSmallSizeClasses = 16;
+  static const size_t kSmallSizeClassLimit =
+      kNumSmallSizeClasses * kMinAllocationSize;
+  static const size_t kSmallClassCacheCapacity = 64;
+  static const int kNumPtrShards = 16;
+
+  struct SmallSizeClassCache {
+    mutex mu;
+    std::vector<void*> free_ptrs GUARDED_BY(mu);
+  };
+
+  // Maps pointers eligible for caching to their size class, sharded by
+  // pointer hash so deallocations of distinct pointers rarely contend.
+  struct PtrClassShard {
+    mutex mu;
+    std::unordered_map<const void*, int> ptr_class GUARDED_BY(mu);
+  };
+
+  // True if the small-allocation cache applies to a request of 'num_bytes'
+  // with attributes 'allocation_attr'.
+  bool SmallCacheApplies(size_t num_bytes,
+                         const AllocationAttributes& allocation_attr) const {
+    return small_alloc_cache_enabled_ && num_bytes > 0 &&
+           allocation_attr.freed_by_func == nullptr &&
+           RoundedBytes(num_bytes) <= kSmallSizeClassLimit;
+  }
+
+  // The uncached allocation path (the pre-cache AllocateRaw body).
+  void* AllocateRawUncached(size_t alignment, size_t num_bytes,
+                            const AllocationAttributes& allocation_attr);
+
+  // Pops a cached pointer for the size class of 'rounded_bytes', or returns
+  // nullptr if the class cache is empty.
+  void* TryAllocateFromSmallCache(size_t rounded_bytes);
+
+  // Registers 'ptr' (just allocated via the global path) as eligible for the
+  // size-class cache.
+  void RecordSmallAllocation(const void* ptr, size_t rounded_bytes);
+
+  // Returns true if 'ptr' was a cache-eligible allocation and has been
+  // returned to its size-class cache instead of the global free lists.
+  bool TryReturnToSmallCache(void* ptr);
+
+  // Returns all cached small allocations to the global free lists.  Called
+  // when a global allocation fails so cached memory can be coalesced.
+  void FlushSmallAllocCaches();
+
+  const bool small_alloc_cache_enabled_;
+  SmallSizeClassCache small_caches_[kNumSmallSizeClasses];
+  PtrClassShard ptr_shards_[kNumPtrShards];
+
   std::unique_ptr<SubAllocator> sub_allocator_;
   string name_;
   SharedCounter* timing_counter_ = nullptr;
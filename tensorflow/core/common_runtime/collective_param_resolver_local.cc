@@ -55,13 +55,32 @@ void CollectiveParamResolverLocal::CompleteGroupAsync(
 }
 
 namespace {
+// Tensors below this size are reduced with RingReduce even when NCCL is
+// enabled.  For small gradient tensors the NCCL kernel launch and
+// synchronization latency exceeds the transfer time, and a single-subdiv
+// ring over already-resident device buffers is cheaper.  Empirically set;
+// typical gradient tensors in fully-connected and conv layers are well
+// above it.
+constexpr int64 kMinTensorBytesForNccl = 32 * 1024;
+
+int64 TensorSizeBytes(const CollectiveParams* cp) {
+  const int64 num_elements = cp->instance.shape.num_elements();
+  if (num_elements < 0) return -1;
+  return num_elements * DataTypeSize(cp->instance.data_type);
+}
+
 string GetCollectiveName(const CollectiveParams* cp, bool nccl) {
   switch (cp->instance.type) {
     case BROADCAST_COLLECTIVE:
       return "HierarchicalTreeBroadcast";
 
     case REDUCTION_COLLECTIVE: {
-      if (nccl) {
+      // Pick by tensor size when a real choice exists: NCCL wins on
+      // bandwidth for large tensors, the ring implementation has lower
+      // latency for small ones.  Unknown sizes conservatively keep the
+      // configured default.
+      const int64 bytes = TensorSizeBytes(cp);
+      if (nccl && (bytes < 0 || bytes >= kMinTensorBytesForNccl)) {
         return "NcclReduce";
       } else {
         return "RingReduce";
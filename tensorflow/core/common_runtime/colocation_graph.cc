@@ -494,8 +494,16 @@ Status Member::AssignDevice(const Node& node, bool allow_soft_placement) {
     return Status::OK();
   }
 
+  // The owning graph caches the parsed form of each interned device name;
+  // only fall back to parsing if the assigned name is malformed.
   DeviceNameUtils::ParsedName parsed;
-  DeviceNameUtils::ParseFullName(node.assigned_device_name(), &parsed);
+  const DeviceNameUtils::ParsedName* cached_parsed =
+      node.assigned_device_parsed_name();
+  if (cached_parsed != nullptr) {
+    parsed = *cached_parsed;
+  } else {
+    DeviceNameUtils::ParseFullName(node.assigned_device_name(), &parsed);
+  }
   Status s = DeviceNameUtils::MergeDevNames(&assigned_device_name_, parsed);
   if (!s.ok()) {
     return errors::Internal(
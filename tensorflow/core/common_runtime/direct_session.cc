@@ -87,6 +87,21 @@ Status NewThreadPoolFromThreadPoolOptions(
   if (num_threads == 0) {
     num_threads = NumInterOpThreadsFromSessionOptions(options);
   }
+  // Per-pool wait policy overrides the process-wide spinning flag, so a
+  // latency-critical pool can keep spinning while a throughput pool parks
+  // its idle workers promptly.
+  bool low_latency_hint =
+      !options.config.experimental().disable_thread_spinning();
+  switch (thread_pool_options.wait_policy()) {
+    case ThreadPoolOptionProto::SPIN:
+      low_latency_hint = true;
+      break;
+    case ThreadPoolOptionProto::PARK:
+      low_latency_hint = false;
+      break;
+    default:
+      break;
+  }
   const string& name = thread_pool_options.global_name();
   if (name.empty()) {
     // Session-local threadpool.
@@ -94,7 +109,7 @@ Status NewThreadPoolFromThreadPoolOptions(
             << pool_number << ": " << num_threads;
     *pool = new thread::ThreadPool(
         options.env, ThreadOptions(), strings::StrCat("Compute", pool_number),
-        num_threads, !options.config.experimental().disable_thread_spinning(),
+        num_threads, low_latency_hint,
         /*allocator=*/nullptr);
     *owned = true;
     return Status::OK();
@@ -111,7 +126,7 @@ Status NewThreadPoolFromThreadPoolOptions(
     mvalue->first = thread_pool_options.num_threads();
     mvalue->second = new thread::ThreadPool(
         options.env, ThreadOptions(), strings::StrCat("Compute", pool_number),
-        num_threads, !options.config.experimental().disable_thread_spinning(),
+        num_threads, low_latency_hint,
         /*allocator=*/nullptr);
   } else {
     if (mvalue->first != thread_pool_options.num_threads()) {
@@ -506,7 +521,12 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
   args.session_handle = session_handle_;
   args.tensor_store = &run_state.tensor_store;
   args.step_container = &run_state.step_container;
-  args.sync_on_finish = sync_on_finish_;
+  // A step that opts out of the device sync returns as soon as its fetches
+  // are available, letting the caller overlap the next step's CPU partition
+  // with this step's queued device work.
+  args.sync_on_finish =
+      sync_on_finish_ &&
+      !run_options.experimental().disable_device_sync_on_finish();
 
   const bool do_trace = (run_options.trace_level() > RunOptions::NO_TRACE);
 
@@ -592,8 +612,8 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
       handler_ptr->ScheduleInterOpClosure(std::move(c));
     };
   } else {
-    default_runner = [this, pool](Executor::Args::Closure c) {
-      pool->Schedule(std::move(c));
+    default_runner = [pool](Executor::Args::Closure c) {
+      ScheduleWithThreadBudget(pool, std::move(c));
     };
   }
 
@@ -735,7 +755,46 @@ Status DirectSession::Run(const RunOptions& run_options,
       feed_args[executors_and_keys->input_name_to_index[it.first]] = it.second;
     }
   }
-  const Status s = call_frame.SetArgs(feed_args);
+  // When enabled, repack DMA-copyable feed tensors into cuda-pinned host
+  // memory so that feeds consumed on a GPU travel pinned->device as
+  // asynchronous DMA instead of the driver staging the caller's pageable
+  // buffers. The gpu-compatible allocator degrades to the ordinary CPU
+  // allocator when no GPU is present, making this a no-op there.
+  static const bool pin_feed_tensors = [] {
+    bool b = false;
+    Status status = ReadBoolFromEnvVar("TF_SESSION_PINNED_FEEDS", false, &b);
+    if (!status.ok()) {
+      LOG(ERROR) << "TF_SESSION_PINNED_FEEDS: " << status.error_message();
+    }
+    return b;
+  }();
+  if (pin_feed_tensors) {
+    AllocatorAttributes pinned_attrs;
+    pinned_attrs.set_on_host(true);
+    pinned_attrs.set_gpu_compatible(true);
+    Device* client_device = device_set_.client_device();
+    Allocator* pinned_allocator = client_device->GetAllocator(pinned_attrs);
+    if (pinned_allocator !=
+        client_device->GetAllocator(AllocatorAttributes())) {
+      for (Tensor& t : feed_args) {
+        if (!DataTypeCanUseMemcpy(t.dtype()) || t.NumElements() == 0) {
+          continue;
+        }
+        Tensor pinned(pinned_allocator, t.dtype(), t.shape());
+        if (!pinned.IsInitialized()) {
+          // The pinned pool is exhausted; feed the caller's buffer as-is.
+          continue;
+        }
+        StringPiece from = t.tensor_data();
+        StringPiece to = pinned.tensor_data();
+        memcpy(const_cast<char*>(to.data()), from.data(), from.size());
+        t = std::move(pinned);
+      }
+    }
+  }
+  // Moving the feed tensors into the frame shares the caller's buffers with
+  // the executors without any further per-feed tensor duplication.
+  const Status s = call_frame.ConsumeArgs(std::move(feed_args));
   if (errors::IsInternal(s)) {
     return errors::InvalidArgument(s.error_message());
   } else if (!s.ok()) {
@@ -851,8 +910,8 @@ Status DirectSession::PRunSetup(const std::vector<string>& input_names,
   // because RunOptions is not passed in so we can't know whether
   // their use is intended.
   args.collective_executor = nullptr;
-  args.runner = [this, pool](Executor::Args::Closure c) {
-    pool->Schedule(std::move(c));
+  args.runner = [pool](Executor::Args::Closure c) {
+    ScheduleWithThreadBudget(pool, std::move(c));
   };
   args.session_state = &session_state_;
   args.session_handle = session_handle_;
@@ -1233,6 +1292,17 @@ Status DirectSession::CreateExecutors(
       // is tied to a particular subgraph. Even if the function itself
       // is stateful, the `CallOp` that invokes it is not.
       if (!OpSegment::ShouldOwnKernel(lib, ndef.op())) {
+        if (OpSegment::ShouldShareKernel(lib, ndef.op())) {
+          // Identical stateless nodes (e.g. replicas of the same model
+          // loaded as separately named subgraphs) share one kernel
+          // instance, keyed by the node's structural fingerprint.
+          auto create_fn = [lib, &ndef](OpKernel** kernel) {
+            return lib->CreateKernel(ndef, kernel);
+          };
+          return opseg->FindOrCreateShared(session_handle_,
+                                           OpSegment::KernelFingerprint(ndef),
+                                           kernel, create_fn);
+        }
         return lib->CreateKernel(ndef, kernel);
       }
       auto create_fn = [lib, &ndef](OpKernel** kernel) {
@@ -1245,7 +1315,11 @@ Status DirectSession::CreateExecutors(
                                  create_fn);
     };
     params.delete_kernel = [lib](OpKernel* kernel) {
-      if (kernel && !OpSegment::ShouldOwnKernel(lib, kernel->type_string()))
+      // If the kernel is cached in the OpSegment (per-name for stateful
+      // kernels, structurally for shared stateless kernels), the OpSegment
+      // owns it.
+      if (kernel && !OpSegment::ShouldOwnKernel(lib, kernel->type_string()) &&
+          !OpSegment::ShouldShareKernel(lib, kernel->type_string()))
         delete kernel;
     };
 
@@ -1325,6 +1399,30 @@ Status DirectSession::GetOrCreateExecutors(
         run_state_args->debug_options.debug_tensor_watch_opts());
   }
 
+  // The signature can be remembered for the fastest lookup path below only
+  // if it does not need a per-call handle or debugger state.
+  const bool can_remember_signature = handle_name_counter_value < 0 &&
+                                      !run_state_args->is_partial_run &&
+                                      debug_tensor_watches_summary.empty();
+
+  // Fastest lookup path: repeated calls with an identical signature.
+  // Serving workloads typically reuse a handful of feed/fetch signatures, so
+  // compare against the most recently used one before building string keys.
+  if (can_remember_signature) {
+    mutex_lock l(executor_lock_);
+    if (mru_executors_and_keys_ != nullptr &&
+        inputs.size() == mru_inputs_.size() &&
+        outputs.size() == mru_outputs_.size() &&
+        target_nodes.size() == mru_target_nodes_.size() &&
+        std::equal(inputs.begin(), inputs.end(), mru_inputs_.begin()) &&
+        std::equal(outputs.begin(), outputs.end(), mru_outputs_.begin()) &&
+        std::equal(target_nodes.begin(), target_nodes.end(),
+                   mru_target_nodes_.begin())) {
+      *executors_and_keys = mru_executors_and_keys_.get();
+      return Status::OK();
+    }
+  }
+
   // Fast lookup path, no sorting.
   const string key = strings::StrCat(
       str_util::Join(inputs, ","), "->", str_util::Join(outputs, ","), "/",
@@ -1341,6 +1439,9 @@ Status DirectSession::GetOrCreateExecutors(
     mutex_lock l(executor_lock_);  // could use reader lock
     auto it = executors_.find(key);
     if (it != executors_.end()) {
+      if (can_remember_signature) {
+        RememberMostRecentSignature(inputs, outputs, target_nodes, it->second);
+      }
       *executors_and_keys = it->second.get();
       return Status::OK();
     }
@@ -1374,6 +1475,9 @@ Status DirectSession::GetOrCreateExecutors(
     mutex_lock l(executor_lock_);
     auto it = executors_.find(sorted_key);
     if (it != executors_.end()) {
+      if (can_remember_signature) {
+        RememberMostRecentSignature(inputs, outputs, target_nodes, it->second);
+      }
       *executors_and_keys = it->second.get();
       // Insert this under the original key.
       executors_.emplace(key, it->second);
@@ -1415,11 +1519,25 @@ Status DirectSession::GetOrCreateExecutors(
   // Insert the value under the original key, so the fast path lookup will work
   // if the user uses the same order of inputs, outputs, and targets again.
   executors_.emplace(key, insert_result.first->second);
+  if (can_remember_signature) {
+    RememberMostRecentSignature(inputs, outputs, target_nodes,
+                                insert_result.first->second);
+  }
   *executors_and_keys = insert_result.first->second.get();
 
   return Status::OK();
 }
 
+void DirectSession::RememberMostRecentSignature(
+    gtl::ArraySlice<string> inputs, gtl::ArraySlice<string> outputs,
+    gtl::ArraySlice<string> target_nodes,
+    const std::shared_ptr<ExecutorsAndKeys>& executors_and_keys) {
+  mru_inputs_.assign(inputs.begin(), inputs.end());
+  mru_outputs_.assign(outputs.begin(), outputs.end());
+  mru_target_nodes_.assign(target_nodes.begin(), target_nodes.end());
+  mru_executors_and_keys_ = executors_and_keys;
+}
+
 Status DirectSession::CreateGraphs(
     const BuildGraphOptions& subgraph_options,
     std::unordered_map<string, std::unique_ptr<Graph>>* outputs,
@@ -1702,6 +1820,27 @@ Status DirectSession::MakeCallable(const CallableOptions& callable_options,
   return Status::OK();
 }
 
+Status DirectSession::Warmup(const std::vector<CallableOptions>& signatures) {
+  TF_RETURN_IF_ERROR(CheckNotClosed());
+  TF_RETURN_IF_ERROR(CheckGraphCreated("Warmup()"));
+
+  for (const CallableOptions& callable_options : signatures) {
+    std::vector<string> inputs(callable_options.feed().begin(),
+                               callable_options.feed().end());
+    std::vector<string> outputs(callable_options.fetch().begin(),
+                                callable_options.fetch().end());
+    std::vector<string> target_nodes(callable_options.target().begin(),
+                                     callable_options.target().end());
+    ExecutorsAndKeys* executors_and_keys;
+    RunStateArgs run_state_args(
+        callable_options.run_options().debug_options());
+    TF_RETURN_IF_ERROR(GetOrCreateExecutors(inputs, outputs, target_nodes,
+                                            &executors_and_keys,
+                                            &run_state_args));
+  }
+  return Status::OK();
+}
+
 class DirectSession::RunCallableCallFrame : public CallFrameInterface {
  public:
   RunCallableCallFrame(DirectSession* session,
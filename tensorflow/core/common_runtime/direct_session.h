@@ -116,6 +116,13 @@ class DirectSession : public Session {
                                    RunMetadata* run_metadata) override;
   ::tensorflow::Status ReleaseCallable(CallableHandle handle) override;
 
+  // Builds and caches executors for each of 'signatures' so that the first
+  // Run() call with a matching feed/fetch/target signature does not pay for
+  // graph pruning, placement, partitioning and executor construction. Only
+  // the feed(), fetch(), target() and debug options of each signature are
+  // consulted; the cached executors are shared with subsequent Run() calls.
+  ::tensorflow::Status Warmup(const std::vector<CallableOptions>& signatures);
+
  private:
   // For access to collective_graph_key_.
   friend class DirectSessionCollectiveTest;
@@ -224,6 +231,15 @@ class DirectSession : public Session {
       gtl::ArraySlice<string> target_nodes,
       ExecutorsAndKeys** executors_and_keys, RunStateArgs* run_state_args);
 
+  // Records 'executors_and_keys' as the executors for the most recently
+  // used Run signature, so that a repeated identical call can skip the
+  // executor cache lookup.
+  void RememberMostRecentSignature(
+      gtl::ArraySlice<string> inputs, gtl::ArraySlice<string> outputs,
+      gtl::ArraySlice<string> target_nodes,
+      const std::shared_ptr<ExecutorsAndKeys>& executors_and_keys)
+      EXCLUSIVE_LOCKS_REQUIRED(executor_lock_);
+
   // Creates a set of executors to run the subgraph defined by
   // `callable_options`.
   ::tensorflow::Status CreateExecutors(
@@ -343,6 +359,16 @@ class DirectSession : public Session {
   std::unordered_map<string, std::shared_ptr<ExecutorsAndKeys>> executors_
       GUARDED_BY(executor_lock_);
 
+  // The most recently used Run signature. Serving workloads typically call
+  // Run with a small number of fixed signatures, so GetOrCreateExecutors
+  // compares against this before building any string keys, skipping the key
+  // construction and map lookup on repeated identical calls.
+  std::vector<string> mru_inputs_ GUARDED_BY(executor_lock_);
+  std::vector<string> mru_outputs_ GUARDED_BY(executor_lock_);
+  std::vector<string> mru_target_nodes_ GUARDED_BY(executor_lock_);
+  std::shared_ptr<ExecutorsAndKeys> mru_executors_and_keys_
+      GUARDED_BY(executor_lock_);
+
   class RunCallableCallFrame;
   struct Callable {
     std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
@@ -188,6 +188,36 @@ TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork_Callable) {
   }
 }
 
+TEST_F(DirectSessionMinusAXTest, Warmup) {
+  Initialize({3, 2, -1, 0});
+  auto session = CreateSession();
+  ASSERT_TRUE(session != nullptr);
+  DirectSession* direct_session = static_cast<DirectSession*>(session.get());
+
+  // Warmup requires a graph.
+  Status s = direct_session->Warmup(
+      {MakeCallableOptions({}, {y_ + ":0"}, {y_neg_})});
+  EXPECT_TRUE(errors::IsInvalidArgument(s));
+
+  TF_ASSERT_OK(session->Create(def_));
+  TF_ASSERT_OK(direct_session->Warmup(
+      {MakeCallableOptions({}, {y_ + ":0"}, {y_neg_}),
+       MakeCallableOptions({}, {z_ + ":0"}, {})}));
+
+  // A Run() with one of the warmed-up signatures reuses the cached executors
+  // and produces the expected output.
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run({}, {y_ + ":0"}, {y_neg_}, &outputs));
+  ASSERT_EQ(1, outputs.size());
+  auto mat = outputs[0].matrix<float>();
+  ASSERT_TRUE(outputs[0].IsInitialized());
+  EXPECT_FLOAT_EQ(5.0, mat(0, 0));
+
+  // A warmup signature that names a nonexistent tensor fails.
+  s = direct_session->Warmup({MakeCallableOptions({}, {"unknown:0"}, {})});
+  EXPECT_FALSE(s.ok());
+}
+
 TEST_F(DirectSessionMinusAXTest, TestTensorConnection) {
   Initialize({3, 2, -1, 0});
   auto session = CreateSession();
@@ -31,6 +31,14 @@ class DMAHelper {
   static void UnsafeSetShape(Tensor* t, const TensorShape& s) {
     t->set_shape(s);
   }
+  // Constructs a tensor of the given type and shape that shares `buf`,
+  // acquiring a reference on it. For kernels that emit an alias of an
+  // existing buffer; the caller is responsible for ensuring that `buf`
+  // holds at least shape.num_elements() elements of `type`.
+  static Tensor MakeTensor(DataType type, const TensorShape& shape,
+                           TensorBuffer* buf) {
+    return Tensor(type, shape, buf);
+  }
 };
 
 }  // namespace tensorflow
@@ -158,8 +158,13 @@ DEFINE_GET_ATTR(tensorflow::DataType, type_attrs_);
 #undef DEFINE_GET_ATTR
 
 AttrBuilder& AttrBuilder::NumInputs(int n) {
-  DCHECK(!node_def_finalized_) << "Calling NumInputs after BuildNodeDef.";
-  num_inputs_ = n;
+  // Once the NodeDef has been finalized its (dummy) inputs are fixed; a reused
+  // operation may only be re-populated up to that number of inputs.
+  DCHECK(!node_def_finalized_ || n <= num_inputs_)
+      << "Calling NumInputs after BuildNodeDef.";
+  if (!node_def_finalized_) {
+    num_inputs_ = n;
+  }
   return *this;
 }
 
@@ -53,6 +53,8 @@ class CopyToDeviceNode : public EagerNode {
     return Status::OK();
   }
 
+  string DeviceName() const override { return dstd_->name(); }
+
   TensorHandle* dst() { return dst_; }
 
  private:
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
 
+#include "tensorflow/core/util/env_var.h"
+
 namespace tensorflow {
 
 EagerNode::EagerNode(tensorflow::uint64 id) : id(id) {}
@@ -23,6 +25,8 @@ EagerExecutor::~EagerExecutor() {
   tensorflow::mutex_lock l(node_queue_mutex_);
   thread_done_ = true;
   nodes_pending_.notify_all();
+  // The lane threads are joined when `lanes_` is destroyed, after this
+  // destructor body has released `node_queue_mutex_`.
 }
 
 tensorflow::uint64 EagerExecutor::NextId() {
@@ -32,32 +36,51 @@ tensorflow::uint64 EagerExecutor::NextId() {
 
 void EagerExecutor::EnableAsync() {
   tensorflow::mutex_lock l(node_queue_mutex_);
-  if (thread_ == nullptr) {
-    thread_.reset(tensorflow::Env::Default()->StartThread(
+  if (!async_enabled_) {
+    async_enabled_ = true;
+    bool device_lanes = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_EAGER_ASYNC_DEVICE_LANES", false,
+                                   &device_lanes));
+    use_device_lanes_ = device_lanes;
+    if (!use_device_lanes_) {
+      // All nodes share the default lane, preserving the strict global
+      // ordering of the single threaded executor.
+      GetOrCreateLane("");
+    }
+  }
+}
+
+EagerExecutor::DeviceLane* EagerExecutor::GetOrCreateLane(
+    const string& device) {
+  std::unique_ptr<DeviceLane>& lane = lanes_[device];
+  if (lane == nullptr) {
+    lane.reset(new DeviceLane);
+    lane->thread.reset(tensorflow::Env::Default()->StartThread(
         tensorflow::ThreadOptions(), "eager_async_executor",
-        std::bind(&EagerExecutor::Run, this)));
+        std::bind(&EagerExecutor::Run, this, lane.get())));
   }
+  return lane.get();
 }
 
 void EagerExecutor::Add(EagerNode* node) {
   tensorflow::mutex_lock l(node_queue_mutex_);
-  DCHECK(thread_) << "EnableAsync should have been called before Add";
+  DCHECK(async_enabled_) << "EnableAsync should have been called before Add";
   if (!status_.ok()) {
     delete node;
     return;
   }
-  int64 qlen = node_queue_.size();
-  if (qlen > 0) {
-    if (node_queue_.back()->id >= node->id) {
-      status_ = tensorflow::errors::InvalidArgument(
-          "Inserting EagerNode with non-increasing ids:",
-          node_queue_.back()->id, " vs ", node->id);
-      delete node;
-      return;
-    }
-    node_queue_.push(node);
-  } else {
-    node_queue_.push(node);
+  DeviceLane* lane =
+      GetOrCreateLane(use_device_lanes_ ? node->DeviceName() : "");
+  if (!lane->node_queue.empty() && lane->node_queue.back()->id >= node->id) {
+    status_ = tensorflow::errors::InvalidArgument(
+        "Inserting EagerNode with non-increasing ids:",
+        lane->node_queue.back()->id, " vs ", node->id);
+    delete node;
+    return;
+  }
+  pending_ids_.insert(node->id);
+  lane->node_queue.push(node);
+  if (lane->node_queue.size() == 1) {
     nodes_pending_.notify_all();
   }
 }
@@ -76,12 +99,19 @@ tensorflow::Status EagerExecutor::WaitImpl(bool wait_all,
   tensorflow::mutex_lock l(node_queue_mutex_);
   // Don't wait if an error is already set.
   if (!status_.ok()) return status_;
-  if (node_queue_.empty()) return tensorflow::Status::OK();
+  if (pending_ids_.empty()) return tensorflow::Status::OK();
   if (wait_all) {
-    node_id = node_queue_.back()->id;
-  } else if (node_id < node_queue_.front()->id) {
-    // Note that we are relying on the ops being dispatched sequentially from
-    // the queue.
+    // Lanes complete nodes out of order with respect to each other, so keep
+    // waiting on the largest pending id until nothing is pending.
+    while (!pending_ids_.empty() && status_.ok()) {
+      node_id = *std::max_element(pending_ids_.begin(), pending_ids_.end());
+      node_done_notifications_.insert(std::make_pair(node_id, &cond));
+      cond.wait(l);
+    }
+    return status_;
+  }
+  if (pending_ids_.find(node_id) == pending_ids_.end()) {
+    // The node has already finished running.
     return tensorflow::Status::OK();
   }
   node_done_notifications_.insert(std::make_pair(node_id, &cond));
@@ -94,10 +124,12 @@ tensorflow::Status EagerExecutor::WaitImpl(bool wait_all,
 void EagerExecutor::ClearError() {
   tensorflow::mutex_lock l(node_queue_mutex_);
   if (status_.ok()) return;
-  // If an error was set, node_done_notifications_ and node_queue_ should have
-  // been cleared, and no new entries should have been added since.
+  // If an error was set, node_done_notifications_ and the lane queues should
+  // have been cleared, and no new entries should have been added since.
   DCHECK(node_done_notifications_.empty());
-  DCHECK(node_queue_.empty());
+  for (const auto& entry : lanes_) {
+    DCHECK(entry.second->node_queue.empty());
+  }
   status_ = tensorflow::Status::OK();
   nodes_pending_.notify_all();
 }
@@ -107,30 +139,37 @@ tensorflow::Status EagerExecutor::status() {
   return status_;
 }
 
-void EagerExecutor::Run() {
+void EagerExecutor::Run(DeviceLane* lane) {
   while (true) {
     std::unique_ptr<EagerNode> curr_node;
     {
       tensorflow::mutex_lock l(node_queue_mutex_);
-      while (node_queue_.empty() || !status_.ok()) {
+      while (lane->node_queue.empty() || !status_.ok()) {
         if (thread_done_) return;
         nodes_pending_.wait(l);
       }
-      curr_node.reset(node_queue_.front());
+      // Pop the node before running it so that an error on another lane never
+      // deletes a node this lane is executing.
+      curr_node.reset(lane->node_queue.front());
+      lane->node_queue.pop();
     }
     tensorflow::Status status = curr_node->Run();
     const bool ok = status.ok();
     tensorflow::mutex_lock l(node_queue_mutex_);
-    node_queue_.pop();
+    pending_ids_.erase(curr_node->id);
     if (!ok) {
       status_ = status;
       // TODO(agarwal): mark all affected handles as corrupted before clearing
-      // this queue.
-      // We remove any pending ops so that we don't try to execute them if
-      // ClearError is called.
-      for (int i = 0; i < node_queue_.size(); ++i) {
-        delete node_queue_.front();
-        node_queue_.pop();
+      // the queues.
+      // We remove any pending ops, on all lanes, so that we don't try to
+      // execute them if ClearError is called.
+      for (const auto& entry : lanes_) {
+        std::queue<EagerNode*>* node_queue = &entry.second->node_queue;
+        while (!node_queue->empty()) {
+          pending_ids_.erase(node_queue->front()->id);
+          delete node_queue->front();
+          node_queue->pop();
+        }
       }
     }
     if (!node_done_notifications_.empty()) {
@@ -22,6 +22,7 @@ limitations under the License.
 #include <queue>
 #include <string>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/device_factory.h"
@@ -50,6 +51,12 @@ class EagerNode {
   // execution is done.
   virtual Status Run() = 0;
 
+  // Name of the device this node runs on. When per-device execution lanes are
+  // enabled (see TF_EAGER_ASYNC_DEVICE_LANES), nodes with the same device name
+  // execute in submission order while nodes with different device names may
+  // overlap. An empty name places the node on the default lane.
+  virtual string DeviceName() const { return ""; }
+
   // An id unique to the TFE_Context under which this node is created. Allocated
   // monotonically.
   const uint64 id;
@@ -57,12 +64,17 @@ class EagerNode {
 
 // A class for handling async execution (see TFE_ContextSetAsync).
 // Note that this class is thread-safe.
+//
+// By default all nodes execute in submission order on a single background
+// thread. When TF_EAGER_ASYNC_DEVICE_LANES is set, each device gets its own
+// execution lane (thread + queue): nodes on the same device still run in
+// order, but independent nodes on different devices overlap. Cross-device
+// dependencies are handled by TensorHandle, which blocks consumers of an
+// unready handle until its producing node has run.
 // TODO(agarwal): TFE_OpAddInput may currently block if it tries to access the
 // device of the input handle. Fix that.
 // TODO(agarwal): On error, mark all affected handles as corrupted.
 // TODO(agarwal): Implement support for control dependencies.
-// TODO(agarwal): Support out-of-order execution and dispatching multiple
-// EagerNode in parallel.
 // TODO(agarwal): Implement optimizations over EagerNode traces.
 class EagerExecutor {
  public:
@@ -95,11 +107,23 @@ class EagerExecutor {
   Status status();
 
  private:
-  // Starts execution of pending EagerNodes. This function loops till
-  // thread_done_ is set to true. If any errors are encontered, these are set
-  // inside `status_`. The loop blocks anytime there are no pending nodes, or if
-  // `status_` is not ok.
-  void Run();
+  // An execution lane: a queue of pending EagerNodes drained in order by a
+  // dedicated thread. There is one lane per device when per-device lanes are
+  // enabled, and a single default lane otherwise.
+  struct DeviceLane {
+    std::queue<EagerNode*> node_queue;
+    std::unique_ptr<Thread> thread;
+  };
+
+  // Starts execution of the EagerNodes pending on `lane`. This function loops
+  // till thread_done_ is set to true. If any errors are encountered, these are
+  // set inside `status_`. The loop blocks anytime there are no pending nodes
+  // on the lane, or if `status_` is not ok.
+  void Run(DeviceLane* lane);
+
+  // Returns the lane for `device`, creating it (and its thread) on first use.
+  DeviceLane* GetOrCreateLane(const string& device)
+      EXCLUSIVE_LOCKS_REQUIRED(node_queue_mutex_);
 
   Status WaitImpl(bool wait_all, uint64 node_id);
 
@@ -108,8 +132,13 @@ class EagerExecutor {
   // Used to signal that some EagerNodes are pending execution.
   condition_variable nodes_pending_ GUARDED_BY(node_queue_mutex_);
 
-  // Queue of pending EagerNodes.
-  std::queue<EagerNode*> node_queue_ GUARDED_BY(node_queue_mutex_);
+  // Execution lanes, keyed by device name. The default lane uses the empty
+  // key.
+  std::map<string, std::unique_ptr<DeviceLane>> lanes_
+      GUARDED_BY(node_queue_mutex_);
+
+  // Ids of all EagerNodes that have been added but have not finished running.
+  std::unordered_set<uint64> pending_ids_ GUARDED_BY(node_queue_mutex_);
 
   // `status_` is set based on any errors raised during execution of a
   // EagerNode.  It remains set until ClearError is called.
@@ -121,12 +150,14 @@ class EagerExecutor {
   std::multimap<uint64, condition_variable*> node_done_notifications_
       GUARDED_BY(node_queue_mutex_);
 
-  // Thread object that calls the `Run` method. Currently we use only one thread
-  // for executing the EagerNodes one-by-one.
-  std::unique_ptr<Thread> thread_ GUARDED_BY(node_queue_mutex_);
+  // Set once async mode has been enabled on this executor.
+  bool async_enabled_ GUARDED_BY(node_queue_mutex_) = false;
+
+  // Whether nodes are routed to a lane per device rather than a single queue.
+  bool use_device_lanes_ GUARDED_BY(node_queue_mutex_) = false;
 
-  // Indicates that `thread_` should stop as soon as it is done executing the
-  // current EagerNode.
+  // Indicates that the lane threads should stop as soon as they are done
+  // executing their current EagerNode.
   bool thread_done_ GUARDED_BY(node_queue_mutex_) = false;
 
   mutex next_id_mutex_;
@@ -36,6 +36,13 @@ void EagerOperation::ConsumeInput(tensorflow::TensorHandle* h) {
   attrs_.NumInputs(static_cast<int>(inputs_.size()));
 }
 
+void EagerOperation::ClearInputs() {
+  for (tensorflow::TensorHandle* h : inputs_) {
+    h->Unref();
+  }
+  inputs_.clear();
+}
+
 string EagerOperation::DebugString() const {
   string out;
   VLOG(1) << "EagerOperation::DebugString() over " << this;
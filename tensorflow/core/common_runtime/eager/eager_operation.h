@@ -54,6 +54,10 @@ class EagerOperation {
   }
   void AddInput(tensorflow::TensorHandle* h);
   void ConsumeInput(tensorflow::TensorHandle* h);
+  // Drops all inputs so that the operation can be dispatched again with fresh
+  // ones. The attributes and the memoized kernel cache key stay frozen, so a
+  // repeat dispatch skips the per-attribute fingerprinting entirely.
+  void ClearInputs();
 
   const tensorflow::string& Name() const { return name_; }
   const tensorflow::AttrTypeMap* AttrTypes() const { return attr_types_; }
@@ -76,6 +76,10 @@ class ExecuteNode : public EagerNode {
     }
   }
 
+  string DeviceName() const override {
+    return kernel_->device() == nullptr ? "" : kernel_->device()->name();
+  }
+
  private:
   tensorflow::EagerContext* ctx_;
   tensorflow::gtl::InlinedVector<TensorHandle*, 4> inputs_;
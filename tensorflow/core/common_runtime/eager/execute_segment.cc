@@ -0,0 +1,207 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/eager/execute_segment.h"
+
+#include "tensorflow/core/common_runtime/eager/execute.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+
+EagerExecuteSegment::EagerExecuteSegment(EagerContext* ctx) : ctx_(ctx) {}
+
+EagerExecuteSegment::~EagerExecuteSegment() {
+  for (const auto& entry : value_sources_) {
+    entry.first->Unref();
+  }
+}
+
+EagerExecuteSegment::ValueSource EagerExecuteSegment::ResolveInput(
+    TensorHandle* handle) {
+  auto it = value_sources_.find(handle);
+  if (it != value_sources_.end()) {
+    return it->second;
+  }
+  ValueSource source{-1, num_external_inputs_++};
+  handle->Ref();
+  value_sources_.emplace(handle, source);
+  return source;
+}
+
+Status EagerExecuteSegment::AddOp(
+    EagerOperation* op, gtl::InlinedVector<TensorHandle*, 2>* retvals,
+    int* num_retvals) {
+  if (finalized_) {
+    return errors::FailedPrecondition(
+        "Cannot record ops into a finalized segment");
+  }
+  if (op->EagerContext() != ctx_) {
+    return errors::InvalidArgument(
+        "Op was created in a different EagerContext than this segment");
+  }
+  if (ctx_->Async()) {
+    return errors::Unimplemented(
+        "Segment recording requires synchronous eager execution");
+  }
+  if (ctx_->FindFunctionDef(op->Name()) != nullptr) {
+    return errors::Unimplemented(
+        "Function calls cannot be recorded into a segment: ", op->Name());
+  }
+
+  // The cache key must be computed the same way, and at the same point, as in
+  // EagerLocalExecute: before execution possibly mutates the op's attrs (e.g.
+  // setting the XLA compilation attr).
+  const string unspecified_device_name("<unspecified>");
+  Device* device = op->Device();
+  const string& maybe_unspecified_device_name =
+      device == nullptr ? unspecified_device_name : device->name();
+  Fprint128 cache_key =
+      op->MutableAttrs()->CacheKey(maybe_unspecified_device_name);
+
+  TF_RETURN_IF_ERROR(EagerExecute(op, retvals, num_retvals));
+
+  KernelAndDevice* kernel = ctx_->GetCachedKernel(cache_key);
+  if (kernel == nullptr) {
+    return errors::Internal(
+        "No cached kernel found after executing ", op->Name(),
+        "; only local, non-remote ops can be recorded into a segment");
+  }
+
+  Step step;
+  step.kernel = kernel;
+  // Resolve inputs after execution: EagerExecute may have replaced input
+  // handles to copy them to the kernel's expected device, and the replaced
+  // handles are the ones the kernel actually consumes.
+  for (TensorHandle* input : op->Inputs()) {
+    step.inputs.push_back(ResolveInput(input));
+  }
+  const int step_index = static_cast<int>(steps_.size());
+  for (int i = 0; i < *num_retvals; ++i) {
+    TensorHandle* retval = (*retvals)[i];
+    if (value_sources_.emplace(retval, ValueSource{step_index, i}).second) {
+      retval->Ref();
+    }
+  }
+  steps_.push_back(std::move(step));
+  return Status::OK();
+}
+
+Status EagerExecuteSegment::Finalize(
+    const gtl::InlinedVector<TensorHandle*, 2>& outputs) {
+  if (finalized_) {
+    return errors::FailedPrecondition("Segment is already finalized");
+  }
+  outputs_.reserve(outputs.size());
+  for (TensorHandle* output : outputs) {
+    auto it = value_sources_.find(output);
+    if (it == value_sources_.end() || it->second.step < 0) {
+      return errors::InvalidArgument(
+          "Segment output is not a retval of a recorded step");
+    }
+    outputs_.push_back(it->second);
+  }
+
+  // Decide which inputs must be protected from in-place buffer forwarding
+  // during replay (cf. protected_tensors in EagerKernelExecute): external
+  // inputs always (the caller keeps their handles alive across replays), and
+  // intermediates at every use except the last, unless they are also segment
+  // outputs.
+  std::unordered_map<int64, int> last_use;
+  auto source_key = [](const ValueSource& s) {
+    return (static_cast<int64>(s.step) << 32) | s.index;
+  };
+  for (int i = 0; i < static_cast<int>(steps_.size()); ++i) {
+    for (const ValueSource& source : steps_[i].inputs) {
+      if (source.step >= 0) last_use[source_key(source)] = i;
+    }
+  }
+  std::unordered_map<int64, bool> is_output;
+  for (const ValueSource& source : outputs_) {
+    is_output[source_key(source)] = true;
+  }
+  protect_inputs_.resize(steps_.size());
+  for (int i = 0; i < static_cast<int>(steps_.size()); ++i) {
+    protect_inputs_[i].resize(steps_[i].inputs.size());
+    for (int j = 0; j < static_cast<int>(steps_[i].inputs.size()); ++j) {
+      const ValueSource& source = steps_[i].inputs[j];
+      protect_inputs_[i][j] = source.step < 0 ||
+                              last_use[source_key(source)] != i ||
+                              is_output[source_key(source)];
+    }
+  }
+
+  for (const auto& entry : value_sources_) {
+    entry.first->Unref();
+  }
+  value_sources_.clear();
+  step_outputs_.resize(steps_.size());
+  finalized_ = true;
+  return Status::OK();
+}
+
+Status EagerExecuteSegment::Replay(
+    const gtl::InlinedVector<TensorHandle*, 4>& inputs,
+    gtl::InlinedVector<TensorHandle*, 2>* retvals) {
+  if (!finalized_) {
+    return errors::FailedPrecondition(
+        "Segment must be finalized before it can be replayed");
+  }
+  if (static_cast<int>(inputs.size()) != num_external_inputs_) {
+    return errors::InvalidArgument("Segment expects ", num_external_inputs_,
+                                   " inputs, but ", inputs.size(),
+                                   " were provided");
+  }
+  ScopedStepContainer* container = ctx_->StepContainer();
+  for (int i = 0; i < static_cast<int>(steps_.size()); ++i) {
+    const Step& step = steps_[i];
+    gtl::InlinedVector<TensorValue, 4> input_vector(step.inputs.size());
+    gtl::InlinedVector<Tensor, 4> protected_tensors;
+    for (int j = 0; j < static_cast<int>(step.inputs.size()); ++j) {
+      const ValueSource& source = step.inputs[j];
+      if (source.step < 0) {
+        TF_RETURN_IF_ERROR(
+            inputs[source.index]->TensorValue(&input_vector[j]));
+      } else {
+        input_vector[j] =
+            TensorValue(&step_outputs_[source.step][source.index]);
+      }
+      if (protect_inputs_[i][j]) {
+        protected_tensors.push_back(*input_vector[j].tensor);
+      }
+    }
+    step_outputs_[i].clear();
+    step_outputs_[i].resize(1);
+    if (container == nullptr) {
+      TF_RETURN_IF_ERROR(step.kernel->Run(input_vector, &step_outputs_[i],
+                                          nullptr, nullptr, nullptr));
+    } else {
+      TF_RETURN_IF_ERROR(step.kernel->Run(container, input_vector,
+                                          &step_outputs_[i], nullptr, nullptr,
+                                          nullptr));
+    }
+  }
+  retvals->resize(outputs_.size());
+  for (int i = 0; i < static_cast<int>(outputs_.size()); ++i) {
+    const ValueSource& source = outputs_[i];
+    KernelAndDevice* kernel = steps_[source.step].kernel;
+    (*retvals)[i] = new TensorHandle(
+        step_outputs_[source.step][source.index],
+        /* d= */ kernel->OutputDevice(source.index),
+        /* op_device= */ kernel->device(), ctx_);
+  }
+  return Status::OK();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,119 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EXECUTE_SEGMENT_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EXECUTE_SEGMENT_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/eager/context.h"
+#include "tensorflow/core/common_runtime/eager/eager_operation.h"
+#include "tensorflow/core/common_runtime/eager/kernel_and_device.h"
+#include "tensorflow/core/common_runtime/eager/tensor_handle.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+
+namespace tensorflow {
+
+// Records a straight-line sequence of eager ops into a replayable segment.
+//
+// Hot loops (e.g. a simulation stepping an identical op sequence millions of
+// times) pay per-op dispatch overhead in EagerExecute: attr hashing, kernel
+// cache lookup, placement validation, and a TensorHandle per intermediate.
+// A segment is recorded once by routing ops through AddOp (which also executes
+// them normally, so recording is free of surprises), then Replay runs the
+// captured chain of KernelAndDevice objects directly: intermediate values stay
+// plain Tensors threaded from one kernel to the next and only the segment's
+// final outputs get TensorHandles.
+//
+// Restrictions: recording requires sync execution (no async), ops must be
+// primitive (no function calls), and replay inputs must live on the same
+// devices as their recording-time counterparts. The segment borrows its
+// KernelAndDevice objects from the context's kernel cache, so it must not
+// outlive `ctx`.
+//
+// This class is not thread-safe.
+class EagerExecuteSegment {
+ public:
+  explicit EagerExecuteSegment(EagerContext* ctx);
+  ~EagerExecuteSegment();
+
+  // Executes `op` (exactly as EagerExecute would) and records it as the next
+  // step of the segment. Inputs that were not produced by an earlier recorded
+  // step become external inputs of the segment, in first-use order.
+  Status AddOp(EagerOperation* op,
+               gtl::InlinedVector<TensorHandle*, 2>* retvals, int* num_retvals);
+
+  // Freezes the segment. `outputs` selects which recorded values Replay
+  // returns; each must be a retval of a recorded step. No further AddOp calls
+  // are allowed afterwards.
+  Status Finalize(const gtl::InlinedVector<TensorHandle*, 2>& outputs);
+
+  // Replays the recorded segment. `inputs` must match the recorded external
+  // inputs positionally (see num_external_inputs()) in dtype and device.
+  // On success `retvals` holds one new TensorHandle per output passed to
+  // Finalize; the caller takes ownership.
+  Status Replay(const gtl::InlinedVector<TensorHandle*, 4>& inputs,
+                gtl::InlinedVector<TensorHandle*, 2>* retvals);
+
+  int num_external_inputs() const { return num_external_inputs_; }
+  int num_steps() const { return static_cast<int>(steps_.size()); }
+  bool finalized() const { return finalized_; }
+
+ private:
+  // Identifies where a step input comes from at replay time.
+  struct ValueSource {
+    // If step < 0, the value is inputs[index] passed to Replay. Otherwise it
+    // is output `index` of recorded step `step`.
+    int step;
+    int index;
+  };
+
+  struct Step {
+    KernelAndDevice* kernel;  // borrowed from the context's kernel cache
+    gtl::InlinedVector<ValueSource, 4> inputs;
+  };
+
+  // Maps `handle` to a ValueSource, registering it as a new external input if
+  // it was not produced by a recorded step. Refs handles it keeps in the map
+  // so pooled handle addresses cannot be reused underneath the recording.
+  ValueSource ResolveInput(TensorHandle* handle);
+
+  EagerContext* const ctx_;
+
+  std::vector<Step> steps_;
+
+  // Recording state: recording-time handle -> where its value will come from
+  // at replay time. All keys hold a reference dropped when recording ends.
+  std::unordered_map<TensorHandle*, ValueSource> value_sources_;
+  int num_external_inputs_ = 0;
+
+  // Set by Finalize.
+  std::vector<ValueSource> outputs_;
+  // protect_inputs_[i][j] is true if input j of step i must be protected from
+  // in-place buffer forwarding during replay because its value is still needed
+  // afterwards (cf. protected_tensors in EagerKernelExecute).
+  std::vector<std::vector<bool>> protect_inputs_;
+  bool finalized_ = false;
+
+  // Scratch space reused across replays: outputs of each step.
+  std::vector<std::vector<Tensor>> step_outputs_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(EagerExecuteSegment);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_EXECUTE_SEGMENT_H_
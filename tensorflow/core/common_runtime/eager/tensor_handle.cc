@@ -49,6 +49,20 @@ namespace tensorflow {
 
 namespace {
 
+// Freelist of recycled TensorHandle allocations. Capped so that a burst of
+// live handles does not permanently pin memory.
+constexpr int kHandlePoolMaxSize = 256;
+
+struct HandlePool {
+  mutex mu;
+  std::vector<void*> free_list GUARDED_BY(mu);
+};
+
+HandlePool* GlobalHandlePool() {
+  static HandlePool* pool = new HandlePool;
+  return pool;
+}
+
 // If the tensor is a resource variable, return its data type and shape.
 Status GetResourceVariableDtypeAndShapeInternal(
     const tensorflow::Tensor& tensor, Device* resource_device,
@@ -92,6 +106,36 @@ Status GetResourceVariableDtypeAndShapeInternal(
 
 }  // namespace
 
+void* TensorHandle::operator new(size_t size) {
+  // A (hypothetical) subclass would have a different size; send it straight to
+  // the heap since the freelist only holds sizeof(TensorHandle) blocks.
+  if (size != sizeof(TensorHandle)) {
+    return ::operator new(size);
+  }
+  HandlePool* pool = GlobalHandlePool();
+  {
+    mutex_lock l(pool->mu);
+    if (!pool->free_list.empty()) {
+      void* ptr = pool->free_list.back();
+      pool->free_list.pop_back();
+      return ptr;
+    }
+  }
+  return ::operator new(size);
+}
+
+void TensorHandle::operator delete(void* ptr, size_t size) {
+  if (size == sizeof(TensorHandle)) {
+    HandlePool* pool = GlobalHandlePool();
+    mutex_lock l(pool->mu);
+    if (pool->free_list.size() < kHandlePoolMaxSize) {
+      pool->free_list.push_back(ptr);
+      return;
+    }
+  }
+  ::operator delete(ptr);
+}
+
 TensorHandle::TensorHandle(const class Tensor& t, Device* d, Device* op_device,
                            EagerContext* ctx)
     : dtype(t.dtype()),
@@ -77,6 +77,13 @@ class TensorHandle : public core::RefCounted {
     }
   }
 
+  // TensorHandles are created and destroyed at a very high rate in eager hot
+  // loops (scalar loop counters, learning rates, etc.), so recycled handle
+  // allocations are kept on a small freelist instead of being returned to the
+  // heap allocator on every op.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   Status Tensor(const tensorflow::Tensor** t);
 
   Status TensorValue(tensorflow::TensorValue* t);
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/executor.h"
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <memory>
@@ -24,6 +25,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/common_runtime/kernel_timeline.h"
 #include "tensorflow/core/common_runtime/pending_counts.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocation_description.pb.h"
@@ -64,6 +66,7 @@ limitations under the License.
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
 
 namespace tensorflow {
@@ -163,6 +166,9 @@ struct NodeItem {
   bool is_sink : 1;              // True iff IsSink(node)
   // True iff IsEnter(node) || IsExit(node) || IsNextIteration(node)
   bool is_enter_exit_or_next_iter : 1;
+  // True iff the kernel is synchronous and statically known to be trivially
+  // cheap, so it should always run inline on the dispatching thread.
+  bool always_inline : 1;
 
   // Cached values of node->num_inputs() and node->num_outputs(), to
   // avoid levels of indirection.
@@ -206,6 +212,18 @@ struct NodeItem {
   // 0... for forward from that input.
   const int* forward_from() const { return forward_from_base(); }
 
+  // True iff this node is statically the only consumer of the tensor
+  // arriving at input i, i.e. the producing output slot has no other data
+  // out-edge. Once this node has run, the buffer is dead and could have been
+  // reused for an output.
+  bool input_is_last_use(int i) const {
+    DCHECK_LT(i, num_inputs);
+    return input_last_use_base()[i] != 0;
+  }
+
+  // Return array of per-input last-use markers (see input_is_last_use).
+  const uint8* input_last_use() const { return input_last_use_base(); }
+
  private:
   friend class GraphView;
 
@@ -216,6 +234,7 @@ struct NodeItem {
   //   int                 forward_from[num_outputs];
   //   uint8               input_type[num_inputs];
   //   uint8               output_type[num_outputs];
+  //   uint8               input_last_use[num_inputs];
 
   // Return pointer to variable length section.
   char* var() const {
@@ -245,6 +264,12 @@ struct NodeItem {
         sizeof(AllocatorAttributes) * num_outputs + sizeof(int) * num_outputs +
         sizeof(uint8) * num_inputs);
   }
+  uint8* input_last_use_base() const {
+    return reinterpret_cast<uint8*>(
+        var() + sizeof(EdgeInfo) * num_output_edges +
+        sizeof(AllocatorAttributes) * num_outputs + sizeof(int) * num_outputs +
+        sizeof(uint8) * num_inputs + sizeof(uint8) * num_outputs);
+  }
 
   TF_DISALLOW_COPY_AND_ASSIGN(NodeItem);
 };
@@ -285,6 +310,96 @@ class GraphView {
   TF_DISALLOW_COPY_AND_ASSIGN(GraphView);
 };
 
+// Either a tensor pointer (pass-by-reference) or a tensor (pass-by-value).
+// TODO(yuanbyu): A better way to do "has_value"?
+struct Entry {
+  Entry() {}
+  Entry(const Entry& other)
+      : ref(other.ref),
+        ref_mu(other.ref_mu),
+        has_value(other.has_value),
+        val_field_is_set(other.val_field_is_set),
+        alloc_attr(other.alloc_attr),
+        device_context(other.device_context) {
+    if (val_field_is_set) {
+      val.Init(*other.val);
+    }
+  }
+  Entry(Entry&& other)
+      : ref(other.ref),
+        ref_mu(other.ref_mu),
+        has_value(other.has_value),
+        val_field_is_set(other.val_field_is_set),
+        alloc_attr(other.alloc_attr),
+        device_context(other.device_context) {
+    if (val_field_is_set) {
+      val.Init(std::move(*other.val));
+    }
+  }
+  ~Entry() {
+    if (val_field_is_set) val.Destroy();
+  }
+
+  Entry& operator=(const Entry& other) {
+    if (val_field_is_set) {
+      val.Destroy();
+    }
+    ref = other.ref;
+    ref_mu = other.ref_mu;
+    has_value = other.has_value;
+    val_field_is_set = other.val_field_is_set;
+    alloc_attr = other.alloc_attr;
+    device_context = other.device_context;
+    if (val_field_is_set) {
+      val.Init(*other.val);
+    }
+    return *this;
+  }
+
+  Entry& operator=(Entry&& other) {
+    if (val_field_is_set) {
+      val.Destroy();
+    }
+    ref = other.ref;
+    ref_mu = other.ref_mu;
+    has_value = other.has_value;
+    val_field_is_set = other.val_field_is_set;
+    alloc_attr = other.alloc_attr;
+    device_context = other.device_context;
+    if (val_field_is_set) {
+      val.Init(std::move(*other.val));
+    }
+    return *this;
+  }
+
+  // Clears the <val> field.
+  void ClearVal() {
+    if (val_field_is_set) {
+      val.Destroy();
+      val_field_is_set = false;
+      has_value = false;
+    }
+  }
+
+  // A tensor value, if val_field_is_set.
+  ManualConstructor<Tensor> val;
+
+  Tensor* ref = nullptr;    // A tensor reference.
+  mutex* ref_mu = nullptr;  // mutex for *ref if ref is not nullptr.
+
+  // Whether the value exists, either in <val> or <ref>.
+  bool has_value = false;
+
+  bool val_field_is_set = false;
+
+  // The attributes of the allocator that creates the tensor.
+  AllocatorAttributes alloc_attr;
+
+  // Every entry carries an optional DeviceContext containing
+  // Device-specific information about how the Tensor was produced.
+  DeviceContext* device_context = nullptr;
+};
+
 class ExecutorImpl : public Executor {
  public:
   ExecutorImpl(const LocalExecutorParams& p, std::unique_ptr<const Graph> g)
@@ -303,6 +418,9 @@ class ExecutorImpl : public Executor {
     for (auto fiter : frame_info_) {
       delete fiter.second;
     }
+    for (auto& size_and_array : recycled_input_arrays_) {
+      delete[] size_and_array.second;
+    }
   }
 
   Status Initialize();
@@ -364,6 +482,38 @@ class ExecutorImpl : public Executor {
     return *slot;
   }
 
+  // Returns an Entry array with 'size' elements, preferring an array
+  // recycled from an earlier step of this executor over a fresh allocation.
+  // The returned entries are in the default-constructed state.
+  Entry* GetInputTensorArray(size_t size) const {
+    {
+      mutex_lock l(input_arrays_mu_);
+      for (auto it = recycled_input_arrays_.begin();
+           it != recycled_input_arrays_.end(); ++it) {
+        if (it->first == size) {
+          Entry* array = it->second;
+          recycled_input_arrays_.erase(it);
+          return array;
+        }
+      }
+    }
+    return new Entry[size];
+  }
+
+  // Makes 'array' available for reuse by later steps of this executor, or
+  // deletes it if enough arrays are already cached.
+  // REQUIRES: all 'size' entries are in the default-constructed state.
+  void RecycleInputTensorArray(Entry* array, size_t size) const {
+    {
+      mutex_lock l(input_arrays_mu_);
+      if (recycled_input_arrays_.size() < kMaxRecycledInputArrays) {
+        recycled_input_arrays_.push_back(std::make_pair(size, array));
+        return;
+      }
+    }
+    delete[] array;
+  }
+
   // Owned.
   LocalExecutorParams params_;
   std::unique_ptr<const Graph> graph_;
@@ -380,6 +530,14 @@ class ExecutorImpl : public Executor {
   // the overhead of constructing it for each executor instance.
   gtl::FlatMap<string, FrameInfo*> frame_info_;
 
+  // Freelist of IterationState input_tensors arrays, paired with their
+  // element counts.  Recycling these across steps avoids re-allocating the
+  // per-frame bookkeeping on every Run call of the same graph.
+  static constexpr size_t kMaxRecycledInputArrays = 4;
+  mutable mutex input_arrays_mu_;
+  mutable gtl::InlinedVector<std::pair<size_t, Entry*>, 4>
+      recycled_input_arrays_ GUARDED_BY(input_arrays_mu_);
+
   TF_DISALLOW_COPY_AND_ASSIGN(ExecutorImpl);
 };
 
@@ -422,7 +580,8 @@ size_t GraphView::NodeItemBytes(const Node* n) {
       + num_outputs * sizeof(AllocatorAttributes)  // output_attr[...]
       + num_outputs * sizeof(int)                  // forward_from[num_outputs]
       + num_inputs * sizeof(uint8)                 // input_type[num_inputs]
-      + num_outputs * sizeof(uint8);               // output_type[num_outputs]
+      + num_outputs * sizeof(uint8)                // output_type[num_outputs]
+      + num_inputs * sizeof(uint8);  // input_last_use[num_inputs]
   static constexpr size_t kItemAlignment = sizeof(NodeItem*);
   static_assert(kItemAlignment % alignof(NodeItem) == 0,
                 "NodeItem must be aligned with kItemAlignment");
@@ -506,6 +665,30 @@ char* GraphView::InitializeNode(char* ptr, const Node* n) {
     DCHECK_EQ(item->input_type(i), n->input_type(i));
   }
 
+  // Mark the inputs for which this node is statically the last use of the
+  // incoming tensor: the producing output slot has no other data out-edge.
+  // Inputs fed by constants are excluded, because ConstantOp retains a
+  // reference to its output tensor, so a consumer can never own the buffer
+  // exclusively no matter what the edge structure says.
+  uint8* input_last_use = item->input_last_use_base();
+  for (int i = 0; i < num_inputs; i++) {
+    input_last_use[i] = 0;
+  }
+  for (auto e : n->in_edges()) {
+    if (e->IsControlEdge()) continue;
+    if (e->src()->IsConstant()) continue;
+    int num_consumers = 0;
+    for (auto src_out : e->src()->out_edges()) {
+      if (!src_out->IsControlEdge() &&
+          src_out->src_output() == e->src_output()) {
+        ++num_consumers;
+      }
+    }
+    if (num_consumers == 1) {
+      input_last_use[e->dst_input()] = 1;
+    }
+  }
+
   // Check ScopedAllocatorAttrs and forward_from.  Also assign output_types.
   {
     std::vector<int> forward_input;
@@ -595,6 +778,20 @@ void GetMaxPendingCounts(const Node* n, size_t* max_pending,
   *max_dead_count = num_in_edges;
 }
 
+// Returns true for ops that are statically known to be trivially cheap, so
+// the executor can always run them inline on the dispatching thread rather
+// than paying a threadpool handoff.  The dynamic cost estimate in
+// OpKernel::IsExpensive() starts out "expensive", so without this static
+// classification, chains of such nodes bounce across threads until enough
+// cost samples accumulate.
+static bool IsStaticallyCheapOp(const Node* n) {
+  static const auto* const kCheapOps = new gtl::FlatSet<string>(
+      {"Const", "HostConst", "Identity", "RefIdentity", "IdentityN", "NoOp",
+       "Shape", "ShapeN", "Rank", "Size", "Reshape", "ExpandDims", "Squeeze",
+       "Snapshot", "StopGradient", "PreventGradient"});
+  return kCheapOps->count(n->type_string()) > 0;
+}
+
 Status ExecutorImpl::Initialize() {
   gview_.Initialize(graph_.get());
 
@@ -638,6 +835,7 @@ Status ExecutorImpl::Initialize() {
     }
     CHECK(item->kernel);
     item->kernel_is_async = (item->kernel->AsAsync() != nullptr);
+    item->always_inline = !item->kernel_is_async && IsStaticallyCheapOp(n);
     item->is_merge = IsMerge(n);
     item->is_enter = IsEnter(n);
     if (item->is_enter) {
@@ -856,85 +1054,6 @@ class ExecutorState {
   void RunAsync(Executor::DoneCallback done);
 
  private:
-  // Either a tensor pointer (pass-by-reference) or a tensor (pass-by-value).
-  // TODO(yuanbyu): A better way to do "has_value"?
-  struct Entry {
-    Entry() {}
-    Entry(const Entry& other)
-        : ref(other.ref),
-          ref_mu(other.ref_mu),
-          has_value(other.has_value),
-          val_field_is_set(other.val_field_is_set),
-          alloc_attr(other.alloc_attr),
-          device_context(other.device_context) {
-      if (val_field_is_set) {
-        val.Init(*other.val);
-      }
-    }
-    ~Entry() {
-      if (val_field_is_set) val.Destroy();
-    }
-
-    Entry& operator=(const Entry& other) {
-      if (val_field_is_set) {
-        val.Destroy();
-      }
-      ref = other.ref;
-      ref_mu = other.ref_mu;
-      has_value = other.has_value;
-      val_field_is_set = other.val_field_is_set;
-      alloc_attr = other.alloc_attr;
-      device_context = other.device_context;
-      if (val_field_is_set) {
-        val.Init(*other.val);
-      }
-      return *this;
-    }
-
-    Entry& operator=(Entry&& other) {
-      if (val_field_is_set) {
-        val.Destroy();
-      }
-      ref = other.ref;
-      ref_mu = other.ref_mu;
-      has_value = other.has_value;
-      val_field_is_set = other.val_field_is_set;
-      alloc_attr = other.alloc_attr;
-      device_context = other.device_context;
-      if (val_field_is_set) {
-        val.Init(std::move(*other.val));
-      }
-      return *this;
-    }
-
-    // Clears the <val> field.
-    void ClearVal() {
-      if (val_field_is_set) {
-        val.Destroy();
-        val_field_is_set = false;
-        has_value = false;
-      }
-    }
-
-    // A tensor value, if val_field_is_set.
-    ManualConstructor<Tensor> val;
-
-    Tensor* ref = nullptr;    // A tensor reference.
-    mutex* ref_mu = nullptr;  // mutex for *ref if ref is not nullptr.
-
-    // Whether the value exists, either in <val> or <ref>.
-    bool has_value = false;
-
-    bool val_field_is_set = false;
-
-    // The attributes of the allocator that creates the tensor.
-    AllocatorAttributes alloc_attr;
-
-    // Every entry carries an optional DeviceContext containing
-    // Device-specific information about how the Tensor was produced.
-    DeviceContext* device_context = nullptr;
-  };
-
   // Contains a value for [node->id()] for the device context assigned by the
   // device at the beginning of a step.
   DeviceContextMap device_context_map_;
@@ -944,11 +1063,14 @@ class ExecutorState {
   typedef gtl::InlinedVector<Entry, 4> EntryVector;
 
   struct IterationState {
-    explicit IterationState(const PendingCounts* pending_counts,
-                            int total_input_tensors)
-        : input_tensors(new Entry[total_input_tensors]),
+    IterationState(const ExecutorImpl* impl,
+                   const PendingCounts* pending_counts,
+                   int total_input_tensors)
+        : input_tensors(impl->GetInputTensorArray(total_input_tensors)),
           outstanding_ops(0),
           outstanding_frame_count(0),
+          impl_(impl),
+          total_input_tensors_(total_input_tensors),
           counts_(*pending_counts) {  // Initialize with copy of *pending_counts
     }
 
@@ -994,9 +1116,31 @@ class ExecutorState {
                                     dead_result);
     }
 
-    ~IterationState() { delete[] input_tensors; }
+    // Restores this object to the state a freshly constructed IterationState
+    // would have, so the frame can reuse it for a later iteration instead of
+    // allocating a new one.  "pending_counts" must be the same object the
+    // original construction copied from.
+    void ResetForReuse(const PendingCounts* pending_counts) {
+      for (int i = 0; i < total_input_tensors_; ++i) {
+        input_tensors[i] = Entry();
+      }
+      outstanding_ops = 0;
+      outstanding_frame_count = 0;
+      counts_.ResetFrom(*pending_counts);
+    }
+
+    ~IterationState() {
+      // Reset the entries to the default-constructed state and hand the
+      // array back to the executor so the next step can reuse it.
+      for (int i = 0; i < total_input_tensors_; ++i) {
+        input_tensors[i] = Entry();
+      }
+      impl_->RecycleInputTensorArray(input_tensors, total_input_tensors_);
+    }
 
    private:
+    const ExecutorImpl* impl_;  // Not owned.
+    const int total_input_tensors_;
     PendingCounts counts_;
   };
 
@@ -1069,6 +1213,13 @@ class ExecutorState {
     // The active iteration states of this frame.
     gtl::InlinedVector<IterationState*, 12> iterations;
 
+    // Retired iteration states available for reuse by later iterations of
+    // this frame.  A loop with parallel_iterations=1 cycles through a single
+    // iteration state for its whole lifetime instead of allocating one per
+    // iteration.  Live plus recycled states never exceed
+    // max_parallel_iterations + 1, so this list stays small.
+    gtl::InlinedVector<IterationState*, 2> recycled_iterations GUARDED_BY(mu);
+
     // The NextIteration nodes to enter a new iteration. If the number of
     // outstanding iterations reaches the limit, we will defer the start of
     // the next iteration until the number of outstanding iterations falls
@@ -1118,6 +1269,25 @@ class ExecutorState {
       iterations[index] = state;
     }
 
+    // Returns an IterationState for a new iteration, reusing a recycled one
+    // when available.
+    inline IterationState* MakeIterationState() EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      if (!recycled_iterations.empty()) {
+        IterationState* state = recycled_iterations.back();
+        recycled_iterations.pop_back();
+        state->ResetForReuse(pending_counts);
+        return state;
+      }
+      return new IterationState(executor, pending_counts, total_input_tensors);
+    }
+
+    // Retires a completed iteration state so MakeIterationState can hand it
+    // out again.
+    inline void RecycleIterationState(IterationState* state)
+        EXCLUSIVE_LOCKS_REQUIRED(mu) {
+      recycled_iterations.push_back(state);
+    }
+
     // Decrement the outstanding op count and clean up the iterations in the
     // frame. Return true iff the execution of the frame is done.
     inline bool DecrementOutstandingOps(const GraphView* gview, int64 iter,
@@ -1180,6 +1350,9 @@ class ExecutorState {
         delete iterations[i];
         iterations[i] = nullptr;
       }
+      for (IterationState* state : recycled_iterations) {
+        delete state;
+      }
     }
   };
 
@@ -1264,6 +1437,17 @@ class ExecutorState {
   bool sync_on_finish_;
   const bool trace_using_annotations_;
 
+  // Number of ready nodes packed into each closure handed to runner_ by
+  // ScheduleReady.  See GetDispatchBatchSize().
+  const int64 dispatch_batch_size_;
+
+  // True iff TF_EXECUTOR_FORWARDING_AUDIT is set. When enabled, every
+  // completed kernel is checked for missed buffer-forwarding opportunities
+  // and a per-step summary is logged in Finish().
+  const bool forwarding_audit_;
+  std::atomic<int64> forwarding_audit_forwarded_;
+  std::atomic<int64> forwarding_audit_missed_;
+
   // Owned.
 
   // A flag that is set on error after the frame state has been
@@ -1326,6 +1510,12 @@ class ExecutorState {
   Status ProcessOutputs(const NodeItem& item, OpKernelContext* ctx,
                         EntryVector* outputs, NodeExecStatsInterface* stats);
 
+  // In forwarding-audit mode, checks whether the kernel reused the buffers
+  // of its statically last-use inputs for its outputs, and counts the cases
+  // where it allocated a fresh buffer of matching type and size instead.
+  // Must run before the outputs are released from 'ctx'.
+  void AuditForwarding(const NodeItem& item, OpKernelContext* ctx);
+
   // After processing the outputs, propagates the outputs to their dsts.
   // Contents of *outputs are left in an indeterminate state after
   // returning from this method.
@@ -1343,6 +1533,27 @@ class ExecutorState {
   void ScheduleReady(const TaggedNodeSeq& ready,
                      TaggedNodeReadyQueue* inline_ready);
 
+  // Hands the nodes in 'ready' to runner_ in chunks of up to 'batch_size'
+  // nodes per closure.
+  void DispatchBatched(const TaggedNodeSeq& ready, int64 scheduled_nsec,
+                       int64 batch_size);
+
+  // When a single completion produces at least this many ready nodes (e.g. a
+  // Split feeding hundreds of branches), they are handed to the threadpool
+  // in chunks of kBulkDispatchChunkSize even if no explicit dispatch batch
+  // size is configured, so one completion does not pay one threadpool
+  // enqueue per activated node.
+  static constexpr size_t kBulkDispatchThreshold = 32;
+  static constexpr int64 kBulkDispatchChunkSize = 8;
+
+  // Returns the dispatch batch size to use for a ready list of 'ready_size'
+  // nodes; 1 means unbatched dispatch.
+  int64 EffectiveDispatchBatchSize(size_t ready_size) const {
+    if (dispatch_batch_size_ > 1) return dispatch_batch_size_;
+    if (ready_size >= kBulkDispatchThreshold) return kBulkDispatchChunkSize;
+    return 1;
+  }
+
   // For debugging/logging only.
   inline void MaybeMarkCompleted(FrameState* frame, int64 iter, int64 id);
 
@@ -1373,6 +1584,39 @@ class ExecutorState {
   }
 };
 
+// Returns the number of ready nodes handed to the inter-op threadpool per
+// enqueue in ScheduleReady.  The default of 1 preserves the historical
+// one-closure-per-node behavior.  Setting TF_EXECUTOR_DISPATCH_BATCH_SIZE to
+// a larger value makes ScheduleReady pack up to that many nodes into a single
+// closure, which reduces contention on the threadpool's shared queue for
+// graphs dominated by many small ops.
+static int64 GetDispatchBatchSize() {
+  static const int64 batch_size = []() -> int64 {
+    int64 value;
+    Status status =
+        ReadInt64FromEnvVar("TF_EXECUTOR_DISPATCH_BATCH_SIZE", 1, &value);
+    if (!status.ok() || value < 1) {
+      return 1;
+    }
+    return value;
+  }();
+  return batch_size;
+}
+
+// Returns true if TF_EXECUTOR_FORWARDING_AUDIT is set. In audit mode the
+// executor reports, per step, how many kernels allocated a fresh output
+// buffer even though a statically dead input of matching type and size was
+// available for reuse. See ExecutorState::AuditForwarding.
+static bool ForwardingAuditEnabled() {
+  static const bool enabled = []() -> bool {
+    bool value = false;
+    Status status =
+        ReadBoolFromEnvVar("TF_EXECUTOR_FORWARDING_AUDIT", false, &value);
+    return status.ok() && value;
+  }();
+  return enabled;
+}
+
 ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
@@ -1394,6 +1638,10 @@ ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
       trace_using_annotations_(impl->params_.device->TraceUsingAnnotations()),
+      dispatch_batch_size_(GetDispatchBatchSize()),
+      forwarding_audit_(ForwardingAuditEnabled()),
+      forwarding_audit_forwarded_(0),
+      forwarding_audit_missed_(0),
       num_outstanding_ops_(0) {
   // We start the entire execution in iteration 0 of the root frame
   // so let us create the root frame and the state for iteration 0.
@@ -1405,7 +1653,7 @@ ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
   // Initialize iteration 0.
   root_frame_->iterations.resize(root_frame_->max_parallel_iterations);
   root_frame_->iterations[0] = new IterationState(
-      root_frame_->pending_counts, root_frame_->total_input_tensors);
+      impl_, root_frame_->pending_counts, root_frame_->total_input_tensors);
 
   outstanding_frames_.insert({root_frame_->frame_name, root_frame_});
 }
@@ -1738,6 +1986,7 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
       params.is_input_dead = is_input_dead;
       params.output_attr_array = item.output_attrs();
       params.forward_from_array = item.forward_from();
+      params.input_last_use_array = item.input_last_use();
 
       if (item.kernel_is_async) {
         // Asynchronous computes.
@@ -1747,11 +1996,18 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
         AsyncState* state =
             new AsyncState(params, tagged_node, &item, first_input, stats);
 
-        auto done = [this, state]() {
+        const bool record_timeline = KernelTimeline::Enabled();
+        const int64 timeline_start =
+            record_timeline ? Env::Default()->NowNanos() : 0;
+        auto done = [this, state, record_timeline, timeline_start]() {
           Device* device = impl_->params_.device;
           NodeExecStatsInterface* stats = state->stats;  // Shorthand
           Entry* first_input = state->first_input;       // Shorthand
 
+          if (record_timeline) {
+            KernelTimeline::Record(state->tagged_node.node->id(),
+                                   timeline_start, Env::Default()->NowNanos());
+          }
           nodestats::SetOpEnd(stats);
           EntryVector outputs;
           Status s = ProcessOutputs(*state->item, &state->ctx, &outputs, stats);
@@ -1793,11 +2049,20 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
           if (completed) ScheduleFinish();
         };
         nodestats::SetOpStart(stats);
+        // Tag pool work sharded while launching the kernel with this node so
+        // PoolProfiler can attribute it.
+        thread::ScopedPoolTaskTag pool_tag(id, &node->name());
         device->ComputeAsync(async, &state->ctx, done);
       } else {
         // Synchronous computes.
         OpKernelContext ctx(&params, item.num_outputs);
         nodestats::SetOpStart(stats);
+        // Tag pool work sharded by this kernel with the node executing it so
+        // PoolProfiler can attribute it.
+        thread::ScopedPoolTaskTag pool_tag(id, &node->name());
+        const bool record_timeline = KernelTimeline::Enabled();
+        const int64 timeline_start =
+            record_timeline ? Env::Default()->NowNanos() : 0;
 
         if (TF_PREDICT_FALSE(
                 MightTrace(item, event_collector_, trace_using_annotations_))) {
@@ -1830,6 +2095,10 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
           }
         }
 
+        if (record_timeline) {
+          KernelTimeline::Record(id, timeline_start,
+                                 Env::Default()->NowNanos());
+        }
         nodestats::SetOpEnd(stats);
         s = ProcessOutputs(item, &ctx, &outputs, stats);
         if (s.ok() && impl_->device_record_tensor_accesses_) {
@@ -2003,6 +2272,10 @@ Status ExecutorState::ProcessOutputs(const NodeItem& item, OpKernelContext* ctx,
     return s;
   }
 
+  if (forwarding_audit_) {
+    AuditForwarding(item, ctx);
+  }
+
   // Get the device_context for this node id, if it exists.
   DeviceContext* device_context = nullptr;
   if (node->id() < device_context_map_.size()) {
@@ -2076,12 +2349,50 @@ Status ExecutorState::ProcessOutputs(const NodeItem& item, OpKernelContext* ctx,
     if (!val.is_ref()) {
       // If OpKernelContext returns outputs via pass-by-value, we
       // don't need this trouble.
-      delete val.tensor;
+      OpKernelContext::ReleaseOutputTensor(val.tensor);
     }
   }
   return s;
 }
 
+void ExecutorState::AuditForwarding(const NodeItem& item, OpKernelContext* ctx) {
+  for (int i = 0; i < item.num_inputs; ++i) {
+    if (!item.input_is_last_use(i)) continue;
+    if (IsRefType(item.input_type(i))) continue;
+    if (!ctx->has_input(i)) continue;
+    const Tensor& in = ctx->input(i);
+    if (!in.IsInitialized() || in.NumElements() == 0) continue;
+    const void* in_base = in.tensor_data().data();
+    // The input could have been forwarded to any output of the same type and
+    // size. If one of them shares the input's buffer the kernel forwarded;
+    // if candidates exist but none shares, the kernel allocated a fresh
+    // buffer for a value that could have lived in the dead input's buffer.
+    bool have_candidate = false;
+    bool forwarded = false;
+    for (int j = 0; j < item.num_outputs; ++j) {
+      if (IsRefType(item.output_type(j))) continue;
+      Tensor* out = ctx->mutable_output(j);
+      if (out == nullptr || !out->IsInitialized()) continue;
+      if (out->dtype() != in.dtype()) continue;
+      if (out->NumElements() != in.NumElements()) continue;
+      have_candidate = true;
+      if (out->tensor_data().data() == in_base) {
+        forwarded = true;
+        break;
+      }
+    }
+    if (forwarded) {
+      forwarding_audit_forwarded_.fetch_add(1, std::memory_order_relaxed);
+    } else if (have_candidate) {
+      forwarding_audit_missed_.fetch_add(1, std::memory_order_relaxed);
+      VLOG(1) << "Forwarding audit: " << item.kernel->name() << " ("
+              << item.kernel->type_string() << ") did not reuse last-use input "
+              << i << " of shape " << in.shape().DebugString()
+              << " for a matching output";
+    }
+  }
+}
+
 void ExecutorState::PropagateOutputs(const TaggedNode& tagged_node,
                                      const NodeItem* item, EntryVector* outputs,
                                      TaggedNodeSeq* ready) {
@@ -2168,9 +2479,21 @@ void ExecutorState::PropagateOutputs(const TaggedNode& tagged_node,
       if (input_iter == input_frame->iteration_count &&
           input_frame->num_outstanding_iterations ==
               input_frame->max_parallel_iterations) {
-        // Reached the maximum for parallel iterations.
-        input_frame->next_iter_roots.push_back({node, (*outputs)[0]});
-        output_frame = nullptr;
+        IterationState* iter_state = input_frame->GetIteration(input_iter);
+        if (input_frame->max_parallel_iterations == 1 &&
+            iter_state->outstanding_ops == 1 &&
+            iter_state->outstanding_frame_count == 0) {
+          // Sequential frame (parallel_iterations=1) and this NextIteration
+          // is the last outstanding op of the iteration: the iteration is
+          // about to retire, so advance directly instead of deferring the
+          // value to next_iter_roots and replaying it from CleanupIterations.
+          input_frame->IncrementIteration(&impl_->gview_, ready);
+          output_iter = input_iter + 1;
+        } else {
+          // Reached the maximum for parallel iterations.
+          input_frame->next_iter_roots.push_back({node, (*outputs)[0]});
+          output_frame = nullptr;
+        }
       } else {
         // If this is a new iteration, start it.
         if (input_iter == input_frame->iteration_count) {
@@ -2261,8 +2584,14 @@ void ExecutorState::ScheduleReady(const TaggedNodeSeq& ready,
     scheduled_nsec = nodestats::NowInNsec();
   }
 
+  const int64 dispatch_batch_size = EffectiveDispatchBatchSize(ready.size());
+
   if (inline_ready == nullptr) {
     // Schedule to run all the ready ops in thread pool.
+    if (dispatch_batch_size > 1) {
+      DispatchBatched(ready, scheduled_nsec, dispatch_batch_size);
+      return;
+    }
     for (auto& tagged_node : ready) {
       runner_([=]() { Process(tagged_node, scheduled_nsec); });
     }
@@ -2270,10 +2599,36 @@ void ExecutorState::ScheduleReady(const TaggedNodeSeq& ready,
   }
 
   const GraphView& gview = impl_->gview_;
+  if (dispatch_batch_size > 1) {
+    // Batched dispatch: collect the expensive nodes and hand them to the
+    // threadpool a chunk at a time instead of one enqueue per node.
+    TaggedNodeSeq expensive;
+    for (auto& tagged_node : ready) {
+      const NodeItem& item = *gview.node(tagged_node.node->id());
+      if (tagged_node.is_dead || item.always_inline ||
+          !item.kernel->IsExpensive()) {
+        // Inline this inexpensive node.
+        inline_ready->push_back(tagged_node);
+      } else {
+        expensive.push_back(tagged_node);
+      }
+    }
+    if (!expensive.empty()) {
+      if (inline_ready->empty()) {
+        // Tail recursion optimization
+        inline_ready->push_back(expensive.back());
+        expensive.pop_back();
+      }
+      DispatchBatched(expensive, scheduled_nsec, dispatch_batch_size);
+    }
+    return;
+  }
+
   const TaggedNode* curr_expensive_node = nullptr;
   for (auto& tagged_node : ready) {
     const NodeItem& item = *gview.node(tagged_node.node->id());
-    if (tagged_node.is_dead || !item.kernel->IsExpensive()) {
+    if (tagged_node.is_dead || item.always_inline ||
+        !item.kernel->IsExpensive()) {
       // Inline this inexpensive node.
       inline_ready->push_back(tagged_node);
     } else {
@@ -2299,6 +2654,21 @@ void ExecutorState::ScheduleReady(const TaggedNodeSeq& ready,
   }
 }
 
+void ExecutorState::DispatchBatched(const TaggedNodeSeq& ready,
+                                    int64 scheduled_nsec, int64 batch_size) {
+  for (size_t i = 0; i < ready.size();
+       i += static_cast<size_t>(batch_size)) {
+    const size_t end =
+        std::min(ready.size(), i + static_cast<size_t>(batch_size));
+    TaggedNodeSeq chunk(ready.begin() + i, ready.begin() + end);
+    runner_([this, chunk, scheduled_nsec]() {
+      for (const TaggedNode& tagged_node : chunk) {
+        Process(tagged_node, scheduled_nsec);
+      }
+    });
+  }
+}
+
 inline void ExecutorState::MaybeMarkCompleted(FrameState* frame, int64 iter,
                                               int64 node_id) {
   // TODO(misard) Replace with a finer-grain enabling flag once we
@@ -2450,6 +2820,13 @@ void ExecutorState::ScheduleFinish() {
 }
 
 void ExecutorState::Finish() {
+  if (forwarding_audit_) {
+    LOG(INFO) << "Forwarding audit for step " << step_id_ << ": "
+              << forwarding_audit_missed_.load(std::memory_order_relaxed)
+              << " missed forwarding opportunities, "
+              << forwarding_audit_forwarded_.load(std::memory_order_relaxed)
+              << " outputs forwarded from last-use inputs.";
+  }
   mu_.lock();
   auto status = status_;
   auto done_cb = std::move(done_cb_);
@@ -2550,8 +2927,8 @@ void ExecutorState::FindOrCreateChildFrame(FrameState* frame, int64 iter,
   // 'iterations' is a fixed-length circular buffer.
   temp->iterations.resize(temp->max_parallel_iterations + 1);
   // Initialize iteration 0.
-  temp->iterations[0] =
-      new IterationState(temp->pending_counts, temp->total_input_tensors);
+  temp->iterations[0] = new IterationState(impl_, temp->pending_counts,
+                                           temp->total_input_tensors);
 
   {
     mutex_lock executor_lock(mu_);
@@ -2806,9 +3183,8 @@ void ExecutorState::FrameState::IncrementIteration(const GraphView* gview,
   iteration_count++;
   const int64 next_iter = iteration_count;
 
-  // Initialize the next iteration.
-  IterationState* iter_state =
-      new IterationState(pending_counts, total_input_tensors);
+  // Initialize the next iteration, reusing a recycled state if possible.
+  IterationState* iter_state = MakeIterationState();
   SetIteration(next_iter, iter_state);
   num_outstanding_iterations++;
   dead_exits.clear();
@@ -2825,8 +3201,9 @@ bool ExecutorState::FrameState::CleanupIterations(const GraphView* gview,
                                                   TaggedNodeSeq* ready) {
   int64 curr_iter = iter;
   while (curr_iter <= iteration_count && IsIterationDone(curr_iter)) {
-    // Delete the iteration curr_iter.
-    delete GetIteration(curr_iter);
+    // Retire the iteration curr_iter; its state is reused for a later
+    // iteration of this frame.
+    RecycleIterationState(GetIteration(curr_iter));
     SetIteration(curr_iter, nullptr);
     --num_outstanding_iterations;
     ++curr_iter;
@@ -317,6 +317,48 @@ TEST_F(ExecutorTest, SimpleSwitchDead) {
   EXPECT_TRUE(is_dead);
 }
 
+TEST_F(ExecutorTest, WhileLoopWithSingleParallelIteration) {
+  // Compute: while (v < 20) v += 2; starting from the fed value.  With
+  // parallel_iterations=1 the frame runs its iterations strictly in
+  // sequence, recycling one iteration state for the whole loop and
+  // advancing directly from each NextIteration.
+  std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
+  auto in0 = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  auto enter = test::graph::Enter(g.get(), in0, "loop");
+  enter->AddAttr("parallel_iterations", 1);
+  auto merge = test::graph::Merge(g.get(), enter, {"next"});
+  // The limit and the increment enter the loop as loop invariants.
+  auto limit = test::graph::Enter(
+      g.get(), test::graph::Constant(g.get(), V(20.0)), "loop");
+  limit->AddAttr("is_constant", true);
+  limit->AddAttr("parallel_iterations", 1);
+  auto delta = test::graph::Enter(
+      g.get(), test::graph::Constant(g.get(), V(2.0)), "loop");
+  delta->AddAttr("is_constant", true);
+  delta->AddAttr("parallel_iterations", 1);
+  auto cond = test::graph::LoopCond(
+      g.get(), test::graph::Less(g.get(), merge, limit));
+  auto sw = test::graph::Switch(g.get(), merge, cond);
+  auto exit =
+      test::graph::Exit(g.get(), test::graph::Identity(g.get(), sw, 0));
+  auto body = test::graph::Add(
+      g.get(), test::graph::Identity(g.get(), sw, 1), delta);
+  auto next = test::graph::Next(g.get(), "next", body);
+  g->AddEdge(next, 0, merge, 1);
+  test::graph::Send(g.get(), exit, "b", BOB, 1, ALICE);
+  Create(std::move(g));
+  Rendezvous::Args args;
+  TF_ASSERT_OK(
+      rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0), false));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out, &is_dead));
+  EXPECT_EQ(21.0, V(out));  // 1 + 2 * 10
+  EXPECT_FALSE(is_dead);
+}
+
 TEST_F(ExecutorTest, Abort) {
   // e = a + b + c + d
   std::unique_ptr<Graph> g(new Graph(OpRegistry::Global()));
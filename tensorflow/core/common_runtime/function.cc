@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/function.h"
 
 #include <deque>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 #include "absl/algorithm/container.h"
@@ -32,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/op_def_util.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
@@ -2195,14 +2198,112 @@ std::unique_ptr<FunctionBody> SymbolicGradient(const FunctionBody& f) {
   return SymbolicGradientHelper(f).Compute();
 }
 
+namespace {
+
+// Process-wide memoization of InstantiateFunction() results, keyed by a
+// fingerprint of the FunctionDef plus the canonicalized instantiation attrs.
+// Multi-session servers instantiate byte-identical functions once per session
+// (each session owns its FunctionLibraryDefinition); the template expansion is
+// device- and session-independent, so its result can be shared process-wide.
+//
+// The OpDefs resolved during an expansion may differ between libraries (e.g. a
+// nested function with the same name but a different signature), so each entry
+// records the signatures it resolved and a cached result is only reused after
+// re-resolving them against the caller's library and checking equality.
+class FunctionInstantiationCache {
+ public:
+  static FunctionInstantiationCache* Global() {
+    static FunctionInstantiationCache* cache = new FunctionInstantiationCache;
+    return cache;
+  }
+
+  Status GetOrInstantiate(const FunctionDef& fdef, const AttrSlice& attrs,
+                          const GetFunctionSignature& get_func_sig,
+                          InstantiationResult* result) {
+    const string key = strings::StrCat(
+        FunctionDefHash(fdef), "/",
+        Canonicalize(fdef.signature().name(), attrs));
+    const Entry* entry = nullptr;
+    {
+      mutex_lock l(mu_);
+      auto iter = entries_.find(key);
+      // Entries are immutable and never erased, so the pointer can be used
+      // outside the lock.
+      if (iter != entries_.end()) entry = iter->second.get();
+    }
+    if (entry != nullptr && FunctionDefsEqual(entry->fdef, fdef) &&
+        SignaturesMatch(entry->resolved_sigs, get_func_sig)) {
+      *result = entry->result;
+      return Status::OK();
+    }
+
+    // Record the signatures resolved during expansion for later validation.
+    std::map<string, OpDef> resolved_sigs;
+    auto recording_get_func_sig = [&get_func_sig, &resolved_sigs](
+                                      const string& op, const OpDef** sig) {
+      Status s = get_func_sig(op, sig);
+      if (s.ok() && resolved_sigs.count(op) == 0) {
+        resolved_sigs.emplace(op, **sig);
+      }
+      return s;
+    };
+    result->nodes.clear();
+    result->arg_types.clear();
+    result->ret_types.clear();
+    TF_RETURN_IF_ERROR(
+        InstantiateFunction(fdef, attrs, recording_get_func_sig, result));
+
+    mutex_lock l(mu_);
+    // Bound the cache; a long-running process can see an unbounded stream of
+    // distinct instantiations and correctness does not depend on inserting.
+    if (entries_.size() < kMaxEntries && entries_.count(key) == 0) {
+      auto new_entry = absl::make_unique<Entry>();
+      new_entry->fdef = fdef;
+      new_entry->resolved_sigs = std::move(resolved_sigs);
+      new_entry->result = *result;
+      entries_.emplace(key, std::move(new_entry));
+    }
+    return Status::OK();
+  }
+
+ private:
+  struct Entry {
+    FunctionDef fdef;  // Guards against FunctionDefHash collisions.
+    std::map<string, OpDef> resolved_sigs;
+    InstantiationResult result;
+  };
+
+  static constexpr size_t kMaxEntries = 1000;
+
+  static bool SignaturesMatch(const std::map<string, OpDef>& resolved_sigs,
+                              const GetFunctionSignature& get_func_sig) {
+    for (const auto& name_and_sig : resolved_sigs) {
+      const OpDef* sig = nullptr;
+      if (!get_func_sig(name_and_sig.first, &sig).ok() ||
+          !OpDefEqual(*sig, name_and_sig.second)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  mutex mu_;
+  std::unordered_map<string, std::unique_ptr<Entry>> entries_ GUARDED_BY(mu_);
+};
+
+}  // namespace
+
 Status FunctionDefToBodyHelper(
     const FunctionDef& fdef, const AttrSlice& attrs,
     const FunctionLibraryDefinition* const lib_def,
     const std::function<Status(const string&, const OpDef**)>& get_func_sig,
     std::unique_ptr<FunctionBody>* fbody) {
-  // Instantiates the function template into a graph def.
+  // Instantiates the function template into a graph def, reusing a cached
+  // expansion when an identical function was already instantiated anywhere in
+  // the process.
   InstantiationResult result;
-  TF_RETURN_IF_ERROR(InstantiateFunction(fdef, attrs, get_func_sig, &result));
+  TF_RETURN_IF_ERROR(FunctionInstantiationCache::Global()->GetOrInstantiate(
+      fdef, attrs, get_func_sig, &result));
 
   std::unique_ptr<Graph> graph(new Graph(lib_def));
   GraphConstructorOptions opts;
@@ -143,6 +143,28 @@ TEST_F(FunctionTest, WXPlusB) {
       y, test::AsTensor<float>({5.5, 13.5, 11.5, 27.5}, {2, 2}));
 }
 
+TEST_F(FunctionTest, RepeatedInstantiationAcrossLibraries) {
+  // Instantiating the same function from two independent libraries (as two
+  // sessions would) may share the cached template expansion, but must yield
+  // independent function bodies.
+  const FunctionDef fdef = test::function::XTimesTwo();
+  FunctionDefLibrary proto;
+  *proto.add_function() = fdef;
+  FunctionLibraryDefinition lib1(OpRegistry::Global(), proto);
+  FunctionLibraryDefinition lib2(OpRegistry::Global(), proto);
+
+  std::unique_ptr<FunctionBody> body1;
+  std::unique_ptr<FunctionBody> body2;
+  test::function::Attrs attrs = {{"T", DT_FLOAT}};
+  TF_CHECK_OK(FunctionDefToBodyHelper(fdef, attrs, &lib1, &body1));
+  TF_CHECK_OK(FunctionDefToBodyHelper(fdef, attrs, &lib2, &body2));
+
+  ASSERT_NE(body1->graph, body2->graph);
+  EXPECT_EQ(body1->graph->num_nodes(), body2->graph->num_nodes());
+  EXPECT_EQ(DataTypeVector(body1->arg_types), DataTypeVector(body2->arg_types));
+  EXPECT_EQ(DataTypeVector(body1->ret_types), DataTypeVector(body2->ret_types));
+}
+
 class FunctionLibraryRuntimeTest : public ::testing::Test {
  protected:
   void Init(const std::vector<FunctionDef>& flib) {
@@ -277,6 +277,20 @@ class BaseGPUDevice::StreamGroupFactory {
     return group;
   }
 
+  // Returns the first of `count` consecutive stream group ids that have not
+  // been handed out for {tf_gpu_id} before. Device objects that request
+  // private stream groups reserve their ids here, so that different device
+  // objects backed by the same physical GPU end up with disjoint streams.
+  // This function is thread safe.
+  int ReserveGroupIds(TfGpuId tf_gpu_id, int count) {
+    mutex_lock guard(lock_);
+    int* next_id = &next_private_group_id_[tf_gpu_id.value()];
+    if (*next_id == 0) *next_id = kFirstPrivateGroupId;
+    const int base = *next_id;
+    *next_id += count;
+    return base;
+  }
+
   // Returns a reference to the StreamGroupFactory singleton. Note that this is
   // never destroyed, so the objects it owns are never deleted.
   static StreamGroupFactory& Global() {
@@ -285,9 +299,16 @@ class BaseGPUDevice::StreamGroupFactory {
   }
 
  private:
+  // Group ids below this value are reserved for stream groups shared by all
+  // device objects of a GPU (the pre-existing behavior, where group i holds
+  // the streams for stream_id i).
+  static const int kFirstPrivateGroupId = 1 << 16;
+
   mutex lock_;
   using key_type = std::tuple<int, int>;
   std::map<key_type, StreamGroup> streams_;
+  // Maps a tf_gpu_id to the next unreserved private stream group id.
+  std::map<int, int> next_private_group_id_;
 
   // StreamGroupFactory cannot be created directly; Call
   // StreamGroupFactory::Global() to get the global instance.
@@ -383,10 +404,45 @@ Status BaseGPUDevice::Init(const SessionOptions& options) {
     return errors::InvalidArgument("Invalid value for max_streams.");
   }
 
+  // Whether this device shares its streams with the other device objects that
+  // are backed by the same physical GPU, e.g. the devices created by other
+  // sessions in the same process.
+  // This option is experimental.
+  // Possible values:
+  //   * shared: all device objects of a GPU use the same stream groups, so
+  //          kernels issued by different sessions queue on one compute
+  //          stream. This is currently the default.
+  //   * private: this device object reserves stream groups of its own, so
+  //          models running in different sessions are issued on independent
+  //          compute and copy streams and can overlap on the GPU instead of
+  //          serializing behind each other.
+  string stream_group_mode;
+  TF_RETURN_IF_ERROR(ReadStringFromEnvVar("TF_GPU_STREAM_GROUP_MODE", "shared",
+                                          &stream_group_mode));
+  stream_group_mode = str_util::Lowercase(stream_group_mode);
+  int stream_group_base = 0;
+  if (stream_group_mode == "private") {
+    stream_group_base =
+        StreamGroupFactory::Global().ReserveGroupIds(tf_gpu_id_, max_streams_);
+    if (!timestamped_allocator_) {
+      LOG(WARNING) << "TF_GPU_STREAM_GROUP_MODE=private issues work from "
+                      "different device objects on independent streams while "
+                      "they share one GPU memory allocator. Consider setting "
+                      "GPUOptions::experimental::timestamped_allocator to "
+                      "guard freed memory against reuse across streams.";
+    }
+  } else if (stream_group_mode != "shared") {
+    string error_message =
+        strings::StrCat("Invalid TF_GPU_STREAM_GROUP_MODE: ", stream_group_mode);
+    LOG(WARNING) << error_message;
+    return errors::InvalidArgument(error_message);
+  }
+
   // Create the specified number of GPU streams
   for (int i = 0; i < max_streams_; i++) {
     streams_.push_back(StreamGroupFactory::Global().GetOrCreate(
-        tf_gpu_id_, i, executor_, options.config.gpu_options()));
+        tf_gpu_id_, stream_group_base + i, executor_,
+        options.config.gpu_options()));
     device_contexts_.push_back(new GPUDeviceContext(
         i, streams_.back()->compute, streams_.back()->host_to_device,
         streams_.back()->device_to_host, streams_.back()->device_to_device));
@@ -447,6 +503,36 @@ Status BaseGPUDevice::Init(const SessionOptions& options) {
     }
   }
 
+  // Relative share of the GPU granted to this device when several devices
+  // with private stream groups feed the same physical GPU. StreamExecutor
+  // exposes no stream priorities, so the weight is applied as a cap on the
+  // number of kernels this device may keep pending: a device with twice the
+  // weight can keep twice as many kernels queued, and so receives roughly
+  // twice the share of the hardware scheduler. Only meaningful together with
+  // TF_GPU_STREAM_GROUP_MODE=private, and ignored when
+  // GPUOptions::experimental::pending_cap is set explicitly.
+  int64 stream_group_weight;
+  TF_RETURN_IF_ERROR(ReadInt64FromEnvVar("TF_GPU_STREAM_GROUP_WEIGHT", 0,
+                                         &stream_group_weight));
+  if (stream_group_weight > 0) {
+    // Pending kernel budget granted per unit of weight.
+    static const int64 kPendingKernelsPerWeightUnit = 16;
+    if (stream_group_mode != "private") {
+      LOG(WARNING) << "TF_GPU_STREAM_GROUP_WEIGHT has no effect unless "
+                      "TF_GPU_STREAM_GROUP_MODE=private.";
+    } else if (pending_cap_ > 0) {
+      LOG(WARNING) << "TF_GPU_STREAM_GROUP_WEIGHT ignored because "
+                      "GPUOptions::experimental::pending_cap is set.";
+    } else {
+      pending_cap_ =
+          static_cast<int>(stream_group_weight * kPendingKernelsPerWeightUnit);
+      if (!kernel_tracker_) {
+        kernel_tracker_.reset(
+            new GPUKernelTracker(Env::Default(), /*timing_counter=*/nullptr));
+      }
+    }
+  }
+
   return Status::OK();
 }
 
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "tensorflow/core/platform/stacktrace.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/protobuf/config.pb.h"
@@ -100,6 +103,7 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
       accumulated_stream_(nullptr),
       accumulated_tensors_(new TensorReferenceVector),
       accumulated_tensor_bytes_(0),
+      next_seq_(1),
       threadpool_(Env::Default(), "GPU_Event_Manager", kNumThreads) {
   gpu_event_mgr::InitThreadpoolLabels(&threadpool_);
   StartPollingLoop();
@@ -193,10 +197,21 @@ void EventMgr::FlushAccumulatedTensors() {
 //
 // While one or more events is outstanding, poll for completed events.  When no
 // events are outstanding, we sleep until one is enqueued.
+//
+// Each sweep snapshots the outstanding (event, seq) pairs under mu_, issues
+// the driver-level status queries for the whole batch without the lock, and
+// then retires the completed uses under mu_ again.  Enqueuing threads
+// therefore only contend with the poller for the brief queue manipulation,
+// never for driver calls, and each driver query is amortized over the whole
+// batch of outstanding events rather than being issued per enqueue.
 void EventMgr::PollLoop() {
   ToFreeVector to_free;
+  gtl::InlinedVector<std::pair<se::Event*, uint64>, 4> outstanding;
+  gtl::InlinedVector<uint64, 4> completed_seqs;
   while (true) {
     bool events_still_pending;
+    outstanding.clear();
+    completed_seqs.clear();
     {
       mutex_lock l(mu_);
       if (stop_polling_) {
@@ -205,7 +220,31 @@ void EventMgr::PollLoop() {
       if (used_events_.empty()) {
         events_pending_.wait(l);
       }
-      PollEvents(true, &to_free);
+      for (const InUse& iu : used_events_) {
+        if (iu.event != nullptr) {
+          outstanding.push_back(std::make_pair(iu.event, iu.seq));
+        }
+      }
+    }
+    // Query the snapshot without holding the lock.
+    for (const auto& entry : outstanding) {
+      se::Event::Status s = entry.first->PollForStatus();
+      switch (s) {
+        case se::Event::Status::kUnknown:
+        case se::Event::Status::kError:
+          // We don't expect to see these.  Someday maybe propagate
+          // a Status error, but for now fail hard.
+          LOG(FATAL) << "Unexpected Event status: " << static_cast<int>(s);
+          break;
+        case se::Event::Status::kPending:
+          break;
+        case se::Event::Status::kComplete:
+          completed_seqs.push_back(entry.second);
+      }
+    }
+    {
+      mutex_lock l(mu_);
+      RetireCompletedEvents(completed_seqs, &to_free);
       events_still_pending = !used_events_.empty();
     }
     FreeMemory(to_free);
@@ -231,6 +270,7 @@ void EventMgr::QueueInUse(se::Stream* stream, InUse iu) {
   free_events_.pop_back();
   stream->ThenRecordEvent(e);
   iu.event = e;
+  iu.seq = next_seq_++;
   bool was_empty = used_events_.empty();
   used_events_.push_back(iu);
   // Maybe wake up the polling thread
@@ -295,4 +335,38 @@ void EventMgr::PollEvents(bool is_dedicated_poller,
   }
 }
 
+// Retires the uses named by "completed_seqs".  Matching on the sequence
+// number rather than the event pointer makes this safe against a concurrent
+// retirement (e.g. by PollEvents()) between the poller's snapshot and this
+// call: if a use was already retired its sequence number is simply not
+// found, and a recycled event that has been re-recorded for a later use
+// carries a new sequence number and is left alone.
+void EventMgr::RetireCompletedEvents(
+    const gtl::InlinedVector<uint64, 4>& completed_seqs,
+    ToFreeVector* to_free) {
+  if (completed_seqs.empty()) return;
+  for (auto& iu : used_events_) {
+    if (iu.event == nullptr) continue;
+    if (std::find(completed_seqs.begin(), completed_seqs.end(), iu.seq) ==
+        completed_seqs.end()) {
+      continue;
+    }
+    // Make a copy of the InUse record so we can free it after releasing
+    // the lock
+    to_free->push_back(iu);
+    free_events_.push_back(iu.event);
+    // Mark this InUse record as completed.
+    iu.event = nullptr;
+  }
+  // Then clear any completed InUse records from the front of the queue.
+  while (!used_events_.empty()) {
+    InUse& iu = used_events_.front();
+    if (iu.event == nullptr) {
+      used_events_.pop_front();
+    } else {
+      break;
+    }
+  }
+}
+
 }  // namespace tensorflow
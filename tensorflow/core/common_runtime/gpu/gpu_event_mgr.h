@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_EVENT_MGR_H_
 
 #include <deque>
+#include <memory>
 #include <vector>
 #include "tensorflow/core/framework/log_memory.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -83,27 +84,23 @@ class EventMgr {
 
   // Takes ownership of *bufrec.buf and calls bufrec.alloc->DeallocateRaw()
   // on it as soon as all events currently enqueued on *stream have completed.
+  //
+  // Completed events are retired by the dedicated polling thread, so the
+  // enqueueing thread does no driver-level event queries here.
   inline void ThenDeleteBuffer(se::Stream* stream, BufRec bufrec) {
-    ToFreeVector to_free;
-    {
-      mutex_lock l(mu_);
-      QueueBuffer(stream, bufrec);
-      PollEvents(false, &to_free);
-    }
-    FreeMemory(to_free);
+    mutex_lock l(mu_);
+    QueueBuffer(stream, bufrec);
   }
 
   // Execute func when all pending stream actions have completed.
   // func must be brief and non-blocking since it executes in the one
   // thread used for all such callbacks and also buffer deletions.
+  //
+  // Completed events are retired by the dedicated polling thread, so the
+  // enqueueing thread does no driver-level event queries here.
   inline void ThenExecute(se::Stream* stream, std::function<void()> func) {
-    ToFreeVector to_free;
-    {
-      mutex_lock l(mu_);
-      QueueFunc(stream, std::move(func));
-      PollEvents(false, &to_free);
-    }
-    FreeMemory(to_free);
+    mutex_lock l(mu_);
+    QueueFunc(stream, std::move(func));
   }
 
  private:
@@ -121,11 +118,17 @@ class EventMgr {
     TensorReferenceVector* mem;
     BufRec bufrec;
     std::function<void()> func;
+    // Uniquely identifies this use of the event, so that the polling thread
+    // can poll a snapshot of outstanding events without holding mu_ and
+    // still retire exactly the uses it polled (the event object itself may
+    // have been recycled in the meantime).
+    uint64 seq;
   };
 
   typedef gtl::InlinedVector<InUse, 4> ToFreeVector;
 
   void FreeMemory(const ToFreeVector& to_free) {
+    std::vector<std::function<void()>> funcs_to_run;
     for (const auto& iu : to_free) {
       if (iu.mem != nullptr) {
         for (auto& t : *(iu.mem)) {
@@ -142,7 +145,24 @@ class EventMgr {
         iu.bufrec.alloc->DeallocateRaw(iu.bufrec.buf);
       }
       // The function must be called in another thread.
-      if (iu.func != nullptr) threadpool_.Schedule(iu.func);
+      if (iu.func != nullptr) funcs_to_run.push_back(iu.func);
+    }
+    // The callbacks that completed within this polling sweep are dispatched
+    // to the pool as one batch rather than one Schedule() call each.  All
+    // such callbacks run serially on the single callback thread anyway, so
+    // batching costs no parallelism, and the callback latency added by
+    // coalescing is bounded by one polling quantum
+    // (polling_active_delay_usecs_).
+    if (funcs_to_run.size() == 1) {
+      threadpool_.Schedule(funcs_to_run[0]);
+    } else if (!funcs_to_run.empty()) {
+      auto batch = std::make_shared<std::vector<std::function<void()>>>(
+          std::move(funcs_to_run));
+      threadpool_.Schedule([batch]() {
+        for (const auto& func : *batch) {
+          func();
+        }
+      });
     }
   }
 
@@ -154,17 +174,17 @@ class EventMgr {
 
   void QueueTensors(se::Stream* stream, TensorReferenceVector* tensors)
       EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    QueueInUse(stream, {nullptr, tensors, BufRec(), nullptr});
+    QueueInUse(stream, {nullptr, tensors, BufRec(), nullptr, 0});
   }
 
   void QueueBuffer(se::Stream* stream, BufRec bufrec)
       EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    QueueInUse(stream, {nullptr, nullptr, bufrec, nullptr});
+    QueueInUse(stream, {nullptr, nullptr, bufrec, nullptr, 0});
   }
 
   void QueueFunc(se::Stream* stream, std::function<void()> func)
       EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    QueueInUse(stream, {nullptr, nullptr, BufRec(), std::move(func)});
+    QueueInUse(stream, {nullptr, nullptr, BufRec(), std::move(func), 0});
   }
 
   // This function should be called at roughly the same tempo as
@@ -175,8 +195,18 @@ class EventMgr {
   void PollEvents(bool is_dedicated_poller, ToFreeVector* to_free)
       EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
-  // An internal polling loop that runs at a low frequency to clear
-  // straggler Events.
+  // Retires the InUse records identified by "completed_seqs" (which were
+  // observed complete by an unlocked poll of a snapshot of the queue),
+  // appending records that need cleanup to "*to_free".
+  void RetireCompletedEvents(const gtl::InlinedVector<uint64, 4>& completed_seqs,
+                             ToFreeVector* to_free)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // The internal polling loop that retires completed events. Each sweep
+  // snapshots the outstanding events under mu_, issues the driver-level
+  // status queries for the whole batch without the lock, and then retires
+  // the completed uses, so enqueuing threads are never blocked behind
+  // driver calls.
   void PollLoop();
 
   // Setup/Teardown functions for the polling loop.
@@ -195,6 +225,9 @@ class EventMgr {
   // A FIFO queue of InUse events and associated tensors.
   std::deque<InUse> used_events_ GUARDED_BY(mu_);
 
+  // Sequence number assigned to the next queued InUse record.
+  uint64 next_seq_ GUARDED_BY(mu_);
+
   bool stop_polling_ GUARDED_BY(mu_);
   std::unique_ptr<Notification> polling_stopped_;
 
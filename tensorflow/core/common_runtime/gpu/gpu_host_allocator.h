@@ -17,7 +17,9 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_HOST_ALLOCATOR_H_
 
 #include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/stream_executor.h"
 
 namespace tensorflow {
@@ -46,6 +48,23 @@ class GpuHostAllocator : public SubAllocator {
         return ptr;
       }
       VisitAlloc(ptr, numa_node_, num_bytes);
+      mutex_lock l(mu_);
+      pool_bytes_ += num_bytes;
+      VLOG(1) << "Pinned host memory pool for numa_node " << numa_node_
+              << " grew by " << num_bytes << " bytes to " << pool_bytes_;
+      if (pool_bytes_ > peak_pool_bytes_) {
+        peak_pool_bytes_ = pool_bytes_;
+        // Log the high-water mark at each doubling; the pool is backed by
+        // page-locked memory, so unchecked growth degrades the whole host.
+        if (peak_pool_bytes_ >= next_log_bytes_) {
+          LOG(INFO) << "Pinned host memory pool for numa_node " << numa_node_
+                    << " reached "
+                    << strings::HumanReadableNumBytes(peak_pool_bytes_);
+          while (next_log_bytes_ <= peak_pool_bytes_) {
+            next_log_bytes_ *= 2;
+          }
+        }
+      }
     }
     return ptr;
   }
@@ -54,13 +73,34 @@ class GpuHostAllocator : public SubAllocator {
     if (ptr != nullptr) {
       VisitFree(ptr, numa_node_, num_bytes);
       stream_exec_->HostMemoryDeallocate(ptr);
+      mutex_lock l(mu_);
+      pool_bytes_ -= num_bytes;
+      VLOG(1) << "Pinned host memory pool for numa_node " << numa_node_
+              << " shrank by " << num_bytes << " bytes to " << pool_bytes_;
     }
   }
 
+  // Returns the number of pinned bytes currently held by the pool.
+  int64 pool_bytes() const {
+    mutex_lock l(mu_);
+    return pool_bytes_;
+  }
+
+  // Returns the largest number of pinned bytes the pool has ever held.
+  int64 peak_pool_bytes() const {
+    mutex_lock l(mu_);
+    return peak_pool_bytes_;
+  }
+
  private:
   se::StreamExecutor* stream_exec_;  // not owned, non-null
   const int numa_node_;
 
+  mutable mutex mu_;
+  int64 pool_bytes_ GUARDED_BY(mu_) = 0;
+  int64 peak_pool_bytes_ GUARDED_BY(mu_) = 0;
+  int64 next_log_bytes_ GUARDED_BY(mu_) = 1LL << 20;  // 1MiB
+
   TF_DISALLOW_COPY_AND_ASSIGN(GpuHostAllocator);
 };
 
@@ -19,6 +19,9 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_id.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_id_manager.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_init.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/common_runtime/gpu_device_context.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -36,6 +39,8 @@ limitations under the License.
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/tensor_coding.h"
 #include "tensorflow/core/platform/tracing.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/util.h"
 
 // IMPLEMENTATION NOTE:
@@ -111,6 +116,127 @@ void* GetBase(const Tensor* src) {
 
 void* GetBase(Tensor* dst) { return DMAHelper::base(dst); }
 
+namespace {
+
+// Topology-aware planner for GPU->GPU copies.  Some device pairs have no
+// direct peer access (e.g. GPUs on different PCIe root complexes), and a
+// direct copy between them runs at a fraction of the bandwidth available
+// through an intermediate GPU with fast links to both ends.  The planner
+// builds the peer-access matrix of the process's GPUs once, on first use,
+// and proposes a relay GPU for large copies between non-peer pairs.
+//
+// StreamExecutor's device descriptions in this version do not expose
+// per-link bandwidth, so the planner only distinguishes peer from non-peer
+// pairs: a two-hop path over peer links is assumed to beat a non-peer
+// direct copy, which matches measured NVLink vs cross-socket PCIe rates.
+//
+// Relaying is off by default; enable it by setting TF_GPU_P2P_RELAY_COPY
+// to true.  Copies smaller than TF_GPU_P2P_RELAY_MIN_BYTES (default 1MB)
+// always take the direct path, since the extra hop and the scratch
+// allocation dominate for small transfers.
+class GpuCopyPlanner {
+ public:
+  static GpuCopyPlanner* Global() {
+    static GpuCopyPlanner* instance = new GpuCopyPlanner;
+    return instance;
+  }
+
+  // If a copy of "total_bytes" from "src" to "dst" should be relayed
+  // through an intermediate GPU, returns the relay's executor and sets
+  // "*relay_allocator" to the allocator for its scratch buffer.  Returns
+  // nullptr when the direct path should be used.
+  se::StreamExecutor* PickRelay(se::StreamExecutor* src,
+                                se::StreamExecutor* dst, int64 total_bytes,
+                                Allocator** relay_allocator) {
+    if (!enabled_ || total_bytes < min_bytes_ || src == dst) return nullptr;
+    const int src_i = Index(src);
+    const int dst_i = Index(dst);
+    if (src_i < 0 || dst_i < 0 || peer_[src_i][dst_i]) return nullptr;
+    for (int k = 0; k < static_cast<int>(gpus_.size()); ++k) {
+      if (k == src_i || k == dst_i) continue;
+      if (peer_[src_i][k] && peer_[k][dst_i]) {
+        *relay_allocator = gpus_[k].allocator;
+        return gpus_[k].exec;
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  GpuCopyPlanner() {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GPU_P2P_RELAY_COPY", false, &enabled));
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GPU_P2P_RELAY_MIN_BYTES", 1 << 20,
+                                    &min_bytes_));
+    if (!enabled) return;
+    se::Platform* platform = GPUMachineManager();
+    if (platform == nullptr) return;
+    // Only GPUs the process has created devices for (and that therefore
+    // have a registered TfGpuId and a live allocator) can act as relays.
+    for (int tf_id = 0;; ++tf_id) {
+      PlatformGpuId platform_gpu_id;
+      if (!GpuIdManager::TfToPlatformGpuId(TfGpuId(tf_id), &platform_gpu_id)
+               .ok()) {
+        break;
+      }
+      auto exec_status = platform->ExecutorForDevice(platform_gpu_id.value());
+      if (!exec_status.ok()) continue;
+      Allocator* allocator = GPUProcessState::singleton()->GetGPUAllocator(
+          GPUOptions(), TfGpuId(tf_id), 0);
+      if (allocator == nullptr) continue;
+      GpuEntry entry;
+      entry.exec = exec_status.ValueOrDie();
+      entry.allocator = allocator;
+      gpus_.push_back(entry);
+    }
+    const int n = gpus_.size();
+    peer_.resize(n, std::vector<bool>(n, false));
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+        peer_[i][j] =
+            (i == j) || gpus_[i].exec->CanEnablePeerAccessTo(gpus_[j].exec);
+      }
+    }
+    // A relay requires a third GPU.
+    enabled_ = n > 2;
+  }
+
+  int Index(se::StreamExecutor* exec) const {
+    for (int i = 0; i < static_cast<int>(gpus_.size()); ++i) {
+      if (gpus_[i].exec == exec) return i;
+    }
+    return -1;
+  }
+
+  struct GpuEntry {
+    se::StreamExecutor* exec;
+    Allocator* allocator;
+  };
+
+  bool enabled_ = false;
+  int64 min_bytes_ = 0;
+  std::vector<GpuEntry> gpus_;
+  std::vector<std::vector<bool>> peer_;
+};
+
+}  // namespace
+
+// If "TF_GPU_STAGE_H2D_COPIES" is set to true then host-to-device copies
+// whose source is in pageable memory (e.g. Session::Run feeds, which come
+// from the plain CPU allocator) are first memcpy'd into a cuda-pinned
+// staging buffer so that the subsequent device transfer is truly
+// asynchronous and overlaps with compute, instead of degrading into a
+// driver-staged synchronous copy.
+bool StageH2DCopiesThroughPinnedMemory() {
+  static bool stage_h2d_copies = [] {
+    bool enabled = false;
+    TF_CHECK_OK(
+        ReadBoolFromEnvVar("TF_GPU_STAGE_H2D_COPIES", false, &enabled));
+    return enabled;
+  }();
+  return stage_h2d_copies;
+}
+
 /*static*/
 void GPUUtil::SetProtoFromGPU(const Tensor& tensor, Device* dev,
                               const DeviceContext* device_context,
@@ -210,6 +336,8 @@ void GPUUtil::DeviceToDeviceCopy(
   send_device_to_device_stream->ThenWaitFor(send_stream);
 
   const int64 total_bytes = input->TotalBytes();
+  void* relay_ptr = nullptr;
+  Allocator* relay_allocator = nullptr;
   if (total_bytes > 0) {
     void* src_ptr = GetBase(input);
     DeviceMemoryBase gpu_src_ptr(src_ptr, total_bytes);
@@ -228,17 +356,45 @@ void GPUUtil::DeviceToDeviceCopy(
     // to make sure the memory is free.
     send_device_to_device_stream->ThenWaitFor(recv_stream);
 
-    VLOG(2) << "src_ptr " << src_ptr << " dst_ptr " << dst_ptr;
-    send_device_to_device_stream->ThenMemcpy(&gpu_dst_ptr, gpu_src_ptr,
-                                             total_bytes);
+    // Large copies between GPUs without direct peer access can be relayed
+    // through an intermediate GPU that has peer links to both ends (see
+    // GpuCopyPlanner); both hops then run over peer-enabled links instead
+    // of one slow non-peer copy.  If the relay's allocator is under
+    // pressure, fall back to the direct path rather than retrying.
+    se::StreamExecutor* relay_exec = GpuCopyPlanner::Global()->PickRelay(
+        send_device_to_device_stream->parent(), recv_stream->parent(),
+        total_bytes, &relay_allocator);
+    if (relay_exec != nullptr) {
+      AllocationAttributes no_retry;
+      no_retry.no_retry_on_failure = true;
+      relay_ptr = relay_allocator->AllocateRaw(Allocator::kAllocatorAlignment,
+                                               total_bytes, no_retry);
+    }
+
+    VLOG(2) << "src_ptr " << src_ptr << " dst_ptr " << dst_ptr
+            << " relay_ptr " << relay_ptr;
+    if (relay_ptr != nullptr) {
+      DeviceMemoryBase relay_mem(relay_ptr, total_bytes);
+      send_device_to_device_stream->ThenMemcpy(&relay_mem, gpu_src_ptr,
+                                               total_bytes);
+      send_device_to_device_stream->ThenMemcpy(&gpu_dst_ptr, relay_mem,
+                                               total_bytes);
+    } else {
+      send_device_to_device_stream->ThenMemcpy(&gpu_dst_ptr, gpu_src_ptr,
+                                               total_bytes);
+    }
   }
 
   // Use of input may outlive stack scope, so keep a ref.
   TensorReference input_ref(*input);
   dev_info->event_mgr->ThenExecute(
       send_device_to_device_stream,
-      [done, send_device_to_device_stream, input_ref]() {
+      [done, send_device_to_device_stream, input_ref, relay_allocator,
+       relay_ptr]() {
         input_ref.Unref();
+        if (relay_ptr != nullptr) {
+          relay_allocator->DeallocateRaw(relay_ptr);
+        }
         if (!send_device_to_device_stream->ok()) {
           LOG(FATAL) << "GPU->GPU Memcpy failed";
         }
@@ -322,15 +478,35 @@ void GPUUtil::CopyCPUTensorToGPU(const Tensor* cpu_tensor,
   recv_host_to_device_stream->ThenWaitFor(recv_stream);
 
   const int64 total_bytes = cpu_tensor->TotalBytes();
+  const Tensor* src_tensor = cpu_tensor;
+  Tensor staging_tensor;
   // Note that 0-size tensors have no backing buffer.
   if (total_bytes > 0) {
-    void* src_ptr = GetBase(cpu_tensor);
+    if (StageH2DCopiesThroughPinnedMemory()) {
+      // The gpu host allocator is BFC-backed, so repeated stagings recycle
+      // a pool of pinned slabs that adapts to the feed sizes in use.
+      Allocator* pinned_allocator =
+          GPUProcessState::singleton()->GetGpuHostAllocator(0);
+      staging_tensor =
+          Tensor(pinned_allocator, cpu_tensor->dtype(), cpu_tensor->shape());
+      if (staging_tensor.IsInitialized()) {
+        memcpy(GetBase(&staging_tensor), GetBase(cpu_tensor), total_bytes);
+        src_tensor = &staging_tensor;
+      } else {
+        // The pinned pool is exhausted: fall back to a direct copy from
+        // pageable memory.
+        VLOG(1) << "Failed to allocate " << total_bytes
+                << " bytes of pinned staging memory";
+      }
+    }
+    void* src_ptr = GetBase(src_tensor);
     void* dst_ptr = GetBase(gpu_tensor);
     DeviceMemoryBase gpu_dst_ptr(dst_ptr, total_bytes);
     recv_host_to_device_stream->ThenMemcpy(&gpu_dst_ptr, src_ptr, total_bytes);
   }
-  // Use of cpu_tensor may outlive stack scope, so keep a ref.
-  TensorReference input_ref(*cpu_tensor);
+  // Use of the source tensor may outlive stack scope, so keep a ref.  When
+  // staging, this pins the staging buffer until the transfer completes.
+  TensorReference input_ref(*src_tensor);
   dev_info->event_mgr->ThenExecute(
       recv_host_to_device_stream,
       [recv_host_to_device_stream, done, input_ref]() {
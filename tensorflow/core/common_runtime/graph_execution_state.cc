@@ -193,8 +193,13 @@ Status GraphExecutionState::Extend(
   // 5. Validate that the final graphdef is valid.
   if (gdef.versions().producer() >= 5) {
     // Validate the graph: we assume that merging two valid graphs
-    // should maintain graph validity.
-    TF_RETURN_IF_ERROR(graph::ValidateGraphDef(gdef, *flib_def_));
+    // should maintain graph validity.  The nodes carried over from the old
+    // graph were validated when they were first added, so only the
+    // extension's nodes need to be checked here; this keeps repeated small
+    // extensions of a large graph from re-validating the whole graph.
+    TF_RETURN_IF_ERROR(graph::ValidateGraphDef(gdef, *flib_def_,
+                                               /*start_node_index=*/
+                                               old_node_size));
   }
 
   // 6. Add the extension.
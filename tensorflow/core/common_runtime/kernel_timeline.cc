@@ -0,0 +1,104 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/kernel_timeline.h"
+
+#include <memory>
+
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace {
+
+// Fixed-size ring buffer of events owned by one writer thread. The per-buffer
+// mutex is uncontended except while Drain() is copying events out, so Record()
+// stays cheap on the executor hot path.
+struct ThreadBuffer {
+  mutex mu;
+  KernelTimeline::Event events[KernelTimeline::kEventsPerThread]
+      GUARDED_BY(mu);
+  // Total number of events ever recorded; the oldest buffered event is at
+  // index max(0, next - kEventsPerThread) % kEventsPerThread.
+  int64 next GUARDED_BY(mu) = 0;
+  // Value of `next` at the last drain, so drained events are not re-exported.
+  int64 drained GUARDED_BY(mu) = 0;
+};
+
+// Registry of all thread buffers. Buffers are shared with the registry so
+// events recorded by exited threads can still be drained.
+struct BufferRegistry {
+  mutex mu;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers GUARDED_BY(mu);
+};
+
+BufferRegistry* GlobalRegistry() {
+  static BufferRegistry* registry = new BufferRegistry;
+  return registry;
+}
+
+ThreadBuffer* PerThreadBuffer() {
+  static thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+    auto b = std::make_shared<ThreadBuffer>();
+    BufferRegistry* registry = GlobalRegistry();
+    mutex_lock l(registry->mu);
+    registry->buffers.push_back(b);
+    return b;
+  }();
+  return buffer.get();
+}
+
+}  // namespace
+
+/* static */ bool KernelTimeline::Enabled() {
+  static const bool enabled = []() {
+    bool b = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_KERNEL_TIMELINE", false, &b));
+    return b;
+  }();
+  return enabled;
+}
+
+/* static */ void KernelTimeline::Record(uint64 node_id, int64 start_nanos,
+                                         int64 end_nanos) {
+  ThreadBuffer* buffer = PerThreadBuffer();
+  mutex_lock l(buffer->mu);
+  Event* event = &buffer->events[buffer->next % kEventsPerThread];
+  event->node_id = node_id;
+  event->start_nanos = start_nanos;
+  event->end_nanos = end_nanos;
+  ++buffer->next;
+}
+
+/* static */ void KernelTimeline::Drain(std::vector<Event>* events) {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    BufferRegistry* registry = GlobalRegistry();
+    mutex_lock l(registry->mu);
+    buffers = registry->buffers;
+  }
+  for (const auto& buffer : buffers) {
+    mutex_lock l(buffer->mu);
+    int64 first = buffer->next - kEventsPerThread;
+    if (first < buffer->drained) first = buffer->drained;
+    for (int64 i = first; i < buffer->next; ++i) {
+      events->push_back(buffer->events[i % kEventsPerThread]);
+    }
+    buffer->drained = buffer->next;
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,59 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_KERNEL_TIMELINE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_KERNEL_TIMELINE_H_
+
+#include <vector>
+
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Always-on, low-overhead timeline of per-kernel begin/end events.
+//
+// StepStatsCollector materializes a NodeExecStats protobuf per executed node,
+// which is too expensive to leave enabled in production. When enabled (via the
+// TF_KERNEL_TIMELINE environment variable), the executor instead appends one
+// compact binary event per kernel launch to a fixed-size per-thread ring
+// buffer; old events are overwritten once a buffer fills. Drain() collects and
+// clears the buffered events from all threads, so a background exporter can
+// continuously sample executor hot-path timing.
+class KernelTimeline {
+ public:
+  struct Event {
+    uint64 node_id;
+    int64 start_nanos;
+    int64 end_nanos;
+  };
+
+  // Number of events each thread's ring buffer can hold.
+  static constexpr int kEventsPerThread = 4096;
+
+  // Whether timeline recording is enabled. Cheap enough for the executor hot
+  // path: the TF_KERNEL_TIMELINE environment variable is read once.
+  static bool Enabled();
+
+  // Appends an event to the calling thread's ring buffer, overwriting the
+  // oldest event if the buffer is full. Must only be called when Enabled().
+  static void Record(uint64 node_id, int64 start_nanos, int64 end_nanos);
+
+  // Moves all buffered events, from all threads, into `events` (appended in
+  // no particular order across threads) and clears the buffers.
+  static void Drain(std::vector<Event>* events);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_KERNEL_TIMELINE_H_
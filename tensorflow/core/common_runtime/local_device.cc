@@ -95,7 +95,10 @@ struct LocalDevice::EigenThreadPoolInfo {
       intra_op_parallelism_threads = env_num_threads;
       // If no session setting or environment, compute a reasonable default.
       if (intra_op_parallelism_threads == 0) {
-        intra_op_parallelism_threads = port::NumSchedulableCPUs();
+        // Under the unified thread budget this is the intra-op share of the
+        // process's cores rather than all of them.
+        intra_op_parallelism_threads =
+            IntraOpThreadBudget(port::NumSchedulableCPUs());
         if (numa_node != port::kNUMANoAffinity) {
           // Assume that CPUs are equally distributed over available NUMA nodes.
           // This may not be true, but there isn't currently a better way of
@@ -91,6 +91,14 @@ class PendingCounts {
 
   ~PendingCounts() { delete[] bytes_; }
 
+  // Reset all counts to be the same as "other", which must have been
+  // created with the same layout as this object.  Unlike the copy
+  // constructor, this reuses the existing storage.
+  void ResetFrom(const PendingCounts& other) {
+    DCHECK_EQ(num_bytes_, other.num_bytes_);
+    memcpy(bytes_, other.bytes_, other.num_bytes_);
+  }
+
   void set_initial_count(Handle h, size_t pending_count) {
     if (h.is_large_) {
       LargeCounts* c = Large(h);
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_join.h"
+#include "tensorflow/core/common_runtime/copy_tensor.h"
 #include "tensorflow/core/common_runtime/device_set.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/common_runtime/optimization_registry.h"
@@ -989,6 +990,163 @@ Status ProcessFunctionLibraryRuntime::ReleaseHandle(
   return errors::InvalidArgument("Handle not found: ", handle);
 }
 
+namespace {
+
+// Returns the allocator attributes a function argument or return value of
+// `dtype` lives with (int32s and other host-memory types stay on host).
+AllocatorAttributes FunctionTensorAllocAttrs(DataType dtype) {
+  AllocatorAttributes attrs;
+  if (MTypeFromDType(dtype) == HOST_MEMORY) {
+    attrs.set_on_host(true);
+  }
+  return attrs;
+}
+
+// Copies `in` from `src_device` to `dst_device`, sharing the underlying
+// buffer when both sides are on host memory and otherwise initiating the
+// device copy inline with CopyTensor::ViaDMA. This mirrors what
+// IntraProcessRendezvous does for a same-worker transfer, minus the
+// rendezvous key and table traffic.
+void CopyTensorToDeviceAsync(const Tensor& in, Device* src_device,
+                             DeviceContext* src_device_context,
+                             Device* dst_device,
+                             DeviceContext* dst_device_context,
+                             const AllocatorAttributes& src_alloc_attrs,
+                             Tensor* out, StatusCallback done) {
+  const AllocatorAttributes dst_alloc_attrs =
+      FunctionTensorAllocAttrs(in.dtype());
+  const bool src_host =
+      src_alloc_attrs.on_host() || src_device->parsed_name().type == "CPU";
+  const bool dst_host =
+      dst_alloc_attrs.on_host() || dst_device->parsed_name().type == "CPU";
+  if (src_host && dst_host) {
+    *out = in;
+    done(Status::OK());
+    return;
+  }
+
+  if (!DataTypeCanUseMemcpy(in.dtype()) && in.dtype() != DT_VARIANT) {
+    done(errors::InvalidArgument("Non-DMA-safe ", DataTypeString(in.dtype()),
+                                 " tensor may not be copied from/to a GPU."));
+    return;
+  }
+
+  AllocatorAttributes attr = dst_alloc_attrs;
+  attr.set_gpu_compatible(src_alloc_attrs.gpu_compatible() ||
+                          dst_alloc_attrs.gpu_compatible());
+  Allocator* out_allocator = dst_device->GetAllocator(attr);
+  if (in.dtype() != DT_VARIANT) {
+    // Variants are handled by CopyTensor::ViaDMA.
+    *out = Tensor(out_allocator, in.dtype(), in.shape());
+  }
+  CopyTensor::ViaDMA("function_tensor" /* edge_name */, src_device_context,
+                     dst_device_context, src_device, dst_device,
+                     src_alloc_attrs, dst_alloc_attrs, &in, out,
+                     0 /* dev_to_dev_stream_index */, std::move(done));
+}
+
+}  // namespace
+
+void ProcessFunctionLibraryRuntime::RunOnLocalTarget(
+    const FunctionLibraryRuntime::Options& opts,
+    FunctionLibraryRuntime::Handle handle, const string& source_device,
+    const string& target_device, gtl::ArraySlice<Tensor> args,
+    std::vector<Tensor>* rets, FunctionLibraryRuntime* flr,
+    FunctionLibraryRuntime::DoneCallback done) const {
+  Device* src_dev;
+  Status s = device_mgr_->LookupDevice(source_device, &src_dev);
+  if (!s.ok()) {
+    done(s);
+    return;
+  }
+  Device* dst_dev = flr->device();
+  DeviceContext* src_ctx = nullptr;
+  DeviceContext* dst_ctx = nullptr;
+  s = GetDeviceContext(source_device, &src_ctx);
+  s.Update(GetDeviceContext(target_device, &dst_ctx));
+  if (!s.ok()) {
+    done(s);
+    return;
+  }
+
+  // Take ownership of the argument tensors (cheap buffer references) so they
+  // outlive any asynchronous device copies below.
+  auto owned_args =
+      std::make_shared<std::vector<Tensor>>(args.begin(), args.end());
+  auto copied_args = std::make_shared<std::vector<Tensor>>(args.size());
+  std::vector<AllocatorAttributes> args_alloc_attrs = opts.args_alloc_attrs;
+
+  FunctionLibraryRuntime::Options opts_copy = opts;
+  // The target runs the function locally; arguments arrive through the call
+  // frame rather than through the rendezvous.
+  opts_copy.remote_execution = false;
+
+  // After the arguments have been copied: run the function on the target
+  // device, then copy the returned tensors back to the source device.
+  auto run_and_return = [flr, handle, opts_copy, src_dev, dst_dev, src_ctx,
+                         dst_ctx, owned_args, copied_args, rets,
+                         done](const Status& status) {
+    if (!status.ok()) {
+      done(status);
+      return;
+    }
+    std::vector<Tensor>* target_rets = new std::vector<Tensor>;
+    flr->Run(
+        opts_copy, handle, *copied_args, target_rets,
+        [src_dev, dst_dev, src_ctx, dst_ctx, target_rets, rets,
+         done](const Status& status) {
+          std::shared_ptr<std::vector<Tensor>> owned_rets(target_rets);
+          if (!status.ok()) {
+            done(status);
+            return;
+          }
+          rets->resize(owned_rets->size());
+          if (owned_rets->empty()) {
+            done(Status::OK());
+            return;
+          }
+          auto* refcounted_done = new ReffedStatusCallback(
+              [owned_rets, done](const Status& status) { done(status); });
+          for (size_t i = 0; i < owned_rets->size(); ++i) {
+            refcounted_done->Ref();
+          }
+          for (size_t i = 0; i < owned_rets->size(); ++i) {
+            const Tensor& ret = (*owned_rets)[i];
+            CopyTensorToDeviceAsync(
+                ret, dst_dev, dst_ctx, src_dev, src_ctx,
+                FunctionTensorAllocAttrs(ret.dtype()), &(*rets)[i],
+                [refcounted_done](const Status& status) {
+                  refcounted_done->UpdateStatus(status);
+                  refcounted_done->Unref();
+                });
+          }
+          refcounted_done->Unref();
+        });
+  };
+
+  if (owned_args->empty()) {
+    run_and_return(Status::OK());
+    return;
+  }
+  auto* refcounted_done = new ReffedStatusCallback(std::move(run_and_return));
+  for (size_t i = 0; i < owned_args->size(); ++i) {
+    refcounted_done->Ref();
+  }
+  for (size_t i = 0; i < owned_args->size(); ++i) {
+    const Tensor& arg = (*owned_args)[i];
+    const AllocatorAttributes src_attrs =
+        i < args_alloc_attrs.size() ? args_alloc_attrs[i]
+                                    : FunctionTensorAllocAttrs(arg.dtype());
+    CopyTensorToDeviceAsync(arg, src_dev, src_ctx, dst_dev, dst_ctx, src_attrs,
+                            &(*copied_args)[i],
+                            [refcounted_done](const Status& status) {
+                              refcounted_done->UpdateStatus(status);
+                              refcounted_done->Unref();
+                            });
+  }
+  refcounted_done->Unref();
+}
+
 void ProcessFunctionLibraryRuntime::Run(
     const FunctionLibraryRuntime::Options& opts,
     FunctionLibraryRuntime::Handle handle, gtl::ArraySlice<Tensor> args,
@@ -1028,6 +1186,17 @@ void ProcessFunctionLibraryRuntime::Run(
 
   flr = GetFLR(target_device);
   if (flr != nullptr) {
+    Device* source_dev;
+    if (device_mgr_ != nullptr &&
+        device_mgr_->LookupDevice(opts.source_device, &source_dev).ok()) {
+      // Both the caller's device and the target device live in this process;
+      // pass the arguments and return values directly, with cross-device
+      // copies initiated inline, instead of routing every tensor through a
+      // Send/Recv rendezvous pair.
+      RunOnLocalTarget(opts, handle, opts.source_device, target_device, args,
+                       rets, flr, std::move(done));
+      return;
+    }
     auto rendezvous = opts.rendezvous;
     string source_device = opts.source_device;
     DeviceContext* device_context;
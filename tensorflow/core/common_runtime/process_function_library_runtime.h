@@ -266,6 +266,19 @@ class ProcessFunctionLibraryRuntime {
                       gtl::ArraySlice<Tensor> args, std::vector<Tensor>* rets,
                       FunctionLibraryRuntime::DoneCallback done) const;
 
+  // Runs a function instantiated on `target_device` when both the caller's
+  // source device and the target device are owned by this process. Arguments
+  // and return values are passed directly, with cross-device copies initiated
+  // inline via CopyTensor, instead of routing every tensor through a
+  // Send/Recv rendezvous pair.
+  void RunOnLocalTarget(const FunctionLibraryRuntime::Options& opts,
+                        FunctionLibraryRuntime::Handle handle,
+                        const string& source_device,
+                        const string& target_device,
+                        gtl::ArraySlice<Tensor> args, std::vector<Tensor>* rets,
+                        FunctionLibraryRuntime* flr,
+                        FunctionLibraryRuntime::DoneCallback done) const;
+
   // Data structure holding information for a single instantiated remote
   // (to be executed on `target_device`) function.
   class FunctionData {
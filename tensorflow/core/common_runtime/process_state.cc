@@ -74,9 +74,19 @@ Allocator* ProcessState::GetCPUAllocator(int numa_node) {
     if (!status.ok()) {
       LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
     }
+    // Serving workloads that allocate the same few tensor shapes every step
+    // can opt into the size-rounding PoolAllocator, which turns steady-state
+    // allocations (e.g. fetched outputs) into free-list pops.
+    bool use_pool_allocator = false;
+    status = ReadBoolFromEnvVar("TF_CPU_ALLOCATOR_USE_POOL", false,
+                                &use_pool_allocator);
+    if (!status.ok()) {
+      LOG(ERROR) << "GetCPUAllocator: " << status.error_message();
+    }
     Allocator* allocator = nullptr;
     SubAllocator* sub_allocator =
-        (numa_enabled_ || alloc_visitors_defined || use_bfc_allocator)
+        (numa_enabled_ || alloc_visitors_defined || use_bfc_allocator ||
+         use_pool_allocator)
             ? new BasicCPUAllocator(
                   numa_enabled_ ? numa_node : port::kNUMANoAffinity,
                   cpu_alloc_visitors_, cpu_free_visitors_)
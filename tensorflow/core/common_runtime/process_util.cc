@@ -22,13 +22,20 @@ limitations under the License.
 #endif  // INTEL_MKL
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -66,14 +73,85 @@ int32 DefaultNumInterOpThreads() {
 #endif
 }
 
+// Returns the NUMA node to which the inter-op threadpool's threads should
+// be pinned, or port::kNUMANoAffinity (the default) if unset or invalid.
+// On multi-socket machines, pinning each process's (or each session's)
+// compute pool to one socket via TF_INTER_OP_NUMA_NODE keeps executor work
+// and the tensors it touches on the same NUMA domain.
+int InterOpNumaNodeFromEnvironment() {
+  static const int numa_node = []() -> int {
+    int32 node;
+    const char* val = std::getenv("TF_INTER_OP_NUMA_NODE");
+    if (val == nullptr || !strings::safe_strto32(val, &node)) {
+      return port::kNUMANoAffinity;
+    }
+    if (!port::NUMAEnabled() || node < 0 || node >= port::NUMANumNodes()) {
+      LOG(WARNING) << "TF_INTER_OP_NUMA_NODE=" << val
+                   << " is not a valid NUMA node on this machine; ignoring.";
+      return port::kNUMANoAffinity;
+    }
+    return node;
+  }();
+  return numa_node;
+}
+
+ThreadOptions InterOpThreadOptions() {
+  ThreadOptions thread_opts;
+  thread_opts.numa_node = InterOpNumaNodeFromEnvironment();
+  return thread_opts;
+}
+
+// Process-wide core budget shared by the inter-op and intra-op pools; see
+// the header for the contract.  The run-queue depth is the number of
+// closures handed to ScheduleWithThreadBudget() that have not finished yet.
+class ThreadBudgetManager {
+ public:
+  // Returns the process-wide instance, or nullptr when disabled.
+  static ThreadBudgetManager* Global() {
+    static ThreadBudgetManager* manager = []() -> ThreadBudgetManager* {
+      bool enabled = false;
+      TF_CHECK_OK(ReadBoolFromEnvVar("TF_UNIFIED_THREAD_BUDGET",
+                                     /*default_val=*/false, &enabled));
+      return enabled ? new ThreadBudgetManager(port::MaxParallelism())
+                     : nullptr;
+    }();
+    return manager;
+  }
+
+  explicit ThreadBudgetManager(int budget)
+      : budget_(std::max(2, budget)), in_flight_(0) {}
+
+  // Shares of the budget used to size the pools at creation.  Each side
+  // keeps at least two threads so neither pool can be starved outright.
+  int InterOpShare() const { return std::max(2, budget_ / 2); }
+  int IntraOpShare() const { return std::max(2, budget_ - budget_ / 2); }
+
+  void OpScheduled() { in_flight_.fetch_add(1, std::memory_order_relaxed); }
+  void OpDone() { in_flight_.fetch_sub(1, std::memory_order_relaxed); }
+
+  // Intra-op parallelism available to the op about to run: the whole budget
+  // when it is alone, a 1/run-queue-depth slice when it is not.
+  int IntraOpCap() const {
+    const int depth =
+        std::max(1, in_flight_.load(std::memory_order_relaxed));
+    return std::max(1, budget_ / depth);
+  }
+
+ private:
+  const int budget_;
+  std::atomic<int> in_flight_;
+};
+
 static thread::ThreadPool* InitComputePool(const SessionOptions& options) {
   int32 inter_op_parallelism_threads =
       options.config.inter_op_parallelism_threads();
   if (inter_op_parallelism_threads == 0) {
-    inter_op_parallelism_threads = DefaultNumInterOpThreads();
+    inter_op_parallelism_threads =
+        InterOpThreadBudget(DefaultNumInterOpThreads());
   }
   return new thread::ThreadPool(
-      Env::Default(), ThreadOptions(), "Compute", inter_op_parallelism_threads,
+      Env::Default(), InterOpThreadOptions(), "Compute",
+      inter_op_parallelism_threads,
       !options.config.experimental().disable_thread_spinning(),
       /*allocator=*/nullptr);
 }
@@ -124,14 +202,61 @@ int32 NumInterOpThreadsFromSessionOptions(const SessionOptions& options) {
 
 thread::ThreadPool* NewThreadPoolFromSessionOptions(
     const SessionOptions& options) {
-  const int32 num_threads = NumInterOpThreadsFromSessionOptions(options);
+  int32 num_threads = NumInterOpThreadsFromSessionOptions(options);
+  if (options.config.inter_op_parallelism_threads() <= 0) {
+    // Only defaults are clamped; an explicitly configured size is taken as
+    // the user's deliberate choice.
+    num_threads = InterOpThreadBudget(num_threads);
+  }
   VLOG(1) << "Direct session inter op parallelism threads: " << num_threads;
   return new thread::ThreadPool(
-      options.env, ThreadOptions(), "Compute", num_threads,
+      options.env, InterOpThreadOptions(), "Compute", num_threads,
       !options.config.experimental().disable_thread_spinning(),
       /*allocator=*/nullptr);
 }
 
+bool UnifiedThreadBudgetEnabled() {
+  return ThreadBudgetManager::Global() != nullptr;
+}
+
+int32 InterOpThreadBudget(int32 default_num_threads) {
+  ThreadBudgetManager* budget = ThreadBudgetManager::Global();
+  if (budget == nullptr) {
+    return default_num_threads;
+  }
+  return std::min(default_num_threads,
+                  static_cast<int32>(budget->InterOpShare()));
+}
+
+int32 IntraOpThreadBudget(int32 default_num_threads) {
+  ThreadBudgetManager* budget = ThreadBudgetManager::Global();
+  if (budget == nullptr) {
+    return default_num_threads;
+  }
+  return std::min(default_num_threads,
+                  static_cast<int32>(budget->IntraOpShare()));
+}
+
+void ScheduleWithThreadBudget(thread::ThreadPool* pool,
+                              std::function<void()> closure) {
+  ThreadBudgetManager* budget = ThreadBudgetManager::Global();
+  if (budget == nullptr) {
+    pool->Schedule(std::move(closure));
+    return;
+  }
+  budget->OpScheduled();
+  // The closure is shared rather than moved into the lambda (C++11).
+  auto c = std::make_shared<std::function<void()>>(std::move(closure));
+  pool->Schedule([budget, c]() {
+    // The cap is sampled when the closure starts running, so an op that
+    // waited behind a deep queue sees the depth at execution time, not at
+    // schedule time.
+    ScopedPerThreadMaxParallelism scoped(budget->IntraOpCap());
+    (*c)();
+    budget->OpDone();
+  });
+}
+
 void SchedClosure(std::function<void()> closure) {
   if (!tracing::EventCollector::IsEnabled()) {
     return Env::Default()->SchedClosure(std::move(closure));
@@ -48,6 +48,30 @@ int32 NumInterOpThreadsFromSessionOptions(const SessionOptions& options);
 thread::ThreadPool* NewThreadPoolFromSessionOptions(
     const SessionOptions& options);
 
+// When TF_UNIFIED_THREAD_BUDGET is set, the inter-op and intra-op pools draw
+// their default sizes from one process-wide core budget instead of each
+// claiming every schedulable core, and closures scheduled through
+// ScheduleWithThreadBudget() run with their intra-op parallelism capped by
+// the number of closures currently queued or running, so concurrent ops
+// split the budget instead of oversubscribing it.
+bool UnifiedThreadBudgetEnabled();
+
+// Returns the inter-op (intra-op) pool's share of the process core budget,
+// or `default_num_threads` unchanged when the unified budget is disabled.
+// Only applies to defaults; explicitly configured pool sizes should not be
+// passed through these.
+int32 InterOpThreadBudget(int32 default_num_threads);
+int32 IntraOpThreadBudget(int32 default_num_threads);
+
+// Schedules "closure" on "pool".  Under the unified thread budget the
+// closure runs with a per-thread max parallelism derived from the current
+// run-queue depth: a lone op may shard across the whole budget, while ops
+// queued behind many others are narrowed so their cores go to running more
+// ops concurrently.  Equivalent to pool->Schedule(closure) when the budget
+// is disabled.
+void ScheduleWithThreadBudget(thread::ThreadPool* pool,
+                              std::function<void()> closure);
+
 // Schedule "closure" in the default thread queue.
 void SchedClosure(std::function<void()> closure);
 
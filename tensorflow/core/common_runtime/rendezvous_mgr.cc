@@ -100,6 +100,11 @@ void IntraProcessRendezvous::SameWorkerRecvDone(
   AllocatorAttributes attr = recv_args.alloc_attrs;
   attr.set_gpu_compatible(send_args.alloc_attrs.gpu_compatible() ||
                           recv_args.alloc_attrs.gpu_compatible());
+  if (attr.numa_node < 0) {
+    // Place the copy local to the consuming device's NUMA node so the
+    // downstream ops don't read across the interconnect.
+    attr.numa_node = dst_device->attributes().locality().numa_node();
+  }
   Allocator* out_allocator = dst_device->GetAllocator(attr);
   if (in.dtype() != DT_VARIANT) {
     // Variants are handled by CopyTensor::ViaDMA.
@@ -128,6 +133,19 @@ void IntraProcessRendezvous::RecvAsync(const ParsedKey& parsed,
                          const Rendezvous::Args& send_args,
                          const Rendezvous::Args& recv_args, const Tensor& in,
                          bool is_dead) {
+            // When both sides live on host memory the recv aliases the sent
+            // buffer, so hand "in" to the consumer directly instead of going
+            // through the heap-allocated intermediate that the DMA path
+            // below needs.
+            const bool src_host = (send_args.alloc_attrs.on_host() ||
+                                   parsed.src.type == "CPU");
+            const bool dst_host = (recv_args.alloc_attrs.on_host() ||
+                                   parsed.dst.type == "CPU");
+            if (status.ok() && in.IsInitialized() && src_host && dst_host) {
+              done(Status::OK(), send_args, recv_args, in, is_dead);
+              return;
+            }
+
             // If "in" is an uninitialized tensor, do copy-construction to
             // preserve the uninitialized state, along with data type and shape
             // info, which is useful for debugger purposes.
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 
 #include "tensorflow/core/common_runtime/local_device.h"
+#include "tensorflow/core/common_runtime/process_state.h"
 #include "tensorflow/core/common_runtime/scoped_allocator.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -27,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/types.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/session_options.h"
@@ -75,6 +77,14 @@ ThreadPoolDevice::ThreadPoolDevice(const SessionOptions& options,
 ThreadPoolDevice::~ThreadPoolDevice() {}
 
 Allocator* ThreadPoolDevice::GetAllocator(AllocatorAttributes attr) {
+  if (attr.numa_node != port::kNUMANoAffinity &&
+      attr.numa_node < port::NUMANumNodes()) {
+    // An explicit NUMA placement request, e.g. for a tensor that will be
+    // consumed by an op on another socket's device.  allocator_ already
+    // belongs to this device's own node, so only a differing request
+    // needs the per-node lookup.
+    return ProcessState::singleton()->GetCPUAllocator(attr.numa_node);
+  }
   return allocator_;
 }
 
@@ -43,6 +43,9 @@ limitations under the License.
 #include "tensorflow/core/graph/graph_partition.h"
 #include "tensorflow/core/graph/validate.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
@@ -241,6 +244,17 @@ Status GraphMgr::InitItem(const string& session, const GraphDef& gdef,
       // is tied to a particular subgraph. Even if the function itself
       // is stateful, the `CallOp` that invokes it is not.
       if (!OpSegment::ShouldOwnKernel(lib, ndef.op())) {
+        if (OpSegment::ShouldShareKernel(lib, ndef.op())) {
+          // Identical stateless nodes (e.g. replicas of the same model
+          // registered as separately named subgraphs) share one kernel
+          // instance, keyed by the node's structural fingerprint.
+          auto create_fn = [lib, &ndef](OpKernel** kernel) {
+            return lib->CreateKernel(ndef, kernel);
+          };
+          return opseg->FindOrCreateShared(session,
+                                           OpSegment::KernelFingerprint(ndef),
+                                           kernel, create_fn);
+        }
         return lib->CreateKernel(ndef, kernel);
       }
       auto create_fn = [lib, &ndef](OpKernel** kernel) {
@@ -252,7 +266,11 @@ Status GraphMgr::InitItem(const string& session, const GraphDef& gdef,
       return opseg->FindOrCreate(session, ndef.name(), kernel, create_fn);
     };
     params.delete_kernel = [lib](OpKernel* kernel) {
-      if (kernel && !OpSegment::ShouldOwnKernel(lib, kernel->type_string())) {
+      // If the kernel is cached in the OpSegment (per-name for stateful
+      // kernels, structurally for shared stateless kernels), the OpSegment
+      // owns it.
+      if (kernel && !OpSegment::ShouldOwnKernel(lib, kernel->type_string()) &&
+          !OpSegment::ShouldShareKernel(lib, kernel->type_string())) {
         delete kernel;
       }
     };
@@ -280,12 +298,50 @@ Status GraphMgr::InitItem(const string& session, const GraphDef& gdef,
   return Status::OK();
 }
 
+namespace {
+// Fingerprints everything that determines the outcome of a Register() call
+// for a given session, so that registering an identical graph again can be
+// answered from the table.
+uint64 RegistrationFingerprint(const string& session, const GraphDef& gdef,
+                               const GraphOptions& graph_options,
+                               const DebugOptions& debug_options,
+                               int64 collective_graph_key) {
+  uint64 fingerprint = DeterministicProtoHash64(gdef);
+  fingerprint = Hash64Combine(fingerprint, Hash64(session));
+  fingerprint =
+      Hash64Combine(fingerprint, DeterministicProtoHash64(graph_options));
+  fingerprint =
+      Hash64Combine(fingerprint, DeterministicProtoHash64(debug_options));
+  fingerprint =
+      Hash64Combine(fingerprint, static_cast<uint64>(collective_graph_key));
+  return fingerprint;
+}
+}  // namespace
+
 Status GraphMgr::Register(const string& session, const GraphDef& gdef,
                           const GraphOptions& graph_options,
                           const DebugOptions& debug_options,
                           int64 collective_graph_key,
                           DistributedFunctionLibraryRuntime* cluster_flr,
                           string* handle) {
+  // Re-registering an identical graph (e.g. when the master rebuilds its
+  // state after a preemption elsewhere in the cluster) reuses the existing
+  // item instead of re-partitioning the graph and rebuilding its executors;
+  // only the fingerprint of the request is computed.
+  const uint64 fingerprint = RegistrationFingerprint(
+      session, gdef, graph_options, debug_options, collective_graph_key);
+  {
+    mutex_lock l(mu_);
+    auto iter = fingerprint_to_handle_.find(fingerprint);
+    if (iter != fingerprint_to_handle_.end()) {
+      *handle = iter->second;
+      Item* item = gtl::FindWithDefault(table_, *handle, nullptr);
+      CHECK(item != nullptr);
+      ++item->registration_count;
+      return Status::OK();
+    }
+  }
+
   Item* item = new Item;
   Status s = InitItem(session, gdef, graph_options, debug_options,
                       collective_graph_key, cluster_flr, item);
@@ -300,6 +356,11 @@ Status GraphMgr::Register(const string& session, const GraphDef& gdef,
     *handle = strings::Printf("%016llx", ++next_id_);
     item->handle = *handle;
     CHECK(table_.insert({*handle, item}).second);
+    if (fingerprint_to_handle_.insert({fingerprint, *handle}).second) {
+      item->fingerprint = fingerprint;
+    }
+    // Otherwise a concurrent Register() of the same graph won the race; both
+    // items are kept and this one is simply not reachable by fingerprint.
   }
   return Status::OK();
 }
@@ -315,6 +376,13 @@ Status GraphMgr::Deregister(const string& handle) {
                              ". Possibly, this worker just restarted.");
     }
     item = iter->second;
+    if (--item->registration_count > 0) {
+      // Another registration still refers to this item.
+      return Status::OK();
+    }
+    if (item->fingerprint != 0) {
+      fingerprint_to_handle_.erase(item->fingerprint);
+    }
     table_.erase(iter);
   }
   item->Unref();
@@ -330,6 +398,7 @@ Status GraphMgr::DeregisterAll() {
       items.push_back(entry.second);
     }
     table_.clear();
+    fingerprint_to_handle_.clear();
   }
   for (auto item : items) {
     item->Unref();
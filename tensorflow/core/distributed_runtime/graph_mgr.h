@@ -141,6 +141,16 @@ class GraphMgr {
     GraphMgr* graph_mgr;
 
     int64 collective_graph_key;
+
+    // Fingerprint of the registration request, used to answer Register()
+    // calls for an identical graph from the table.  Zero if this item is not
+    // reachable by fingerprint.  Guarded by GraphMgr::mu_.
+    uint64 fingerprint = 0;
+
+    // Number of Register() calls that returned this item's handle.  The
+    // item is removed from the table when the last one is deregistered.
+    // Guarded by GraphMgr::mu_.
+    int64 registration_count = 1;
   };
 
   const WorkerEnv* worker_env_;  // Not owned.
@@ -162,6 +172,10 @@ class GraphMgr {
   // mechanism to gc these graphs.
   std::unordered_map<string, Item*> table_;
 
+  // Maps the fingerprint of a registration request to the handle of the item
+  // serving it, so re-registration of an identical graph is deduplicated.
+  std::unordered_map<uint64, string> fingerprint_to_handle_ GUARDED_BY(mu_);
+
   void StartParallelExecutors(const string& handle, int64 step_id, Item* item,
                               Rendezvous* rendezvous,
                               CollectiveExecutor::Handle* ce_handle,
@@ -44,6 +44,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
@@ -222,6 +223,16 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
                       const RunState* run_state,
                       GraphExecutionState* execution_state);
 
+  // Memoization for CheckFetches().  The signature identifies the
+  // (still-unfed feeds, feeds, fetches) combination of one partial-run step;
+  // streaming clients repeat the same per-chunk combination for every
+  // stream, so steady-state chunks can replace the full-graph traversal
+  // (which runs under the session lock) with a hash lookup.
+  static uint64 FetchCheckSignature(const RunStepRequestWrapper& req,
+                                    const RunState* run_state);
+  bool IsValidatedFetchCheck(uint64 signature);
+  void RecordValidatedFetchCheck(uint64 signature);
+
  private:
   const string session_handle_;
   const BuildGraphOptions bg_opts_;
@@ -282,6 +293,12 @@ class MasterSession::ReffedClientGraph : public core::RefCounted {
   // init_result_ remembers the initialization error if any.
   Status init_result_ GUARDED_BY(mu_);
 
+  // Signatures of (unfed feeds, feeds, fetches) combinations that have
+  // passed CheckFetches().  See FetchCheckSignature().
+  mutex fetch_check_mu_;
+  std::unordered_set<uint64> validated_fetch_checks_
+      GUARDED_BY(fetch_check_mu_);
+
   std::unique_ptr<StatsPublisherInterface> stats_publisher_;
 
   string DetailText(const NodeDetails& details, const NodeExecStats& stats) {
@@ -1035,6 +1052,43 @@ Status MasterSession::ReffedClientGraph::CheckFetches(
   return Status::OK();
 }
 
+/* static */
+uint64 MasterSession::ReffedClientGraph::FetchCheckSignature(
+    const RunStepRequestWrapper& req, const RunState* run_state) {
+  // Names are combined by addition so that the signature is independent of
+  // iteration and request order.
+  uint64 unfed = 0;
+  for (const auto& input : run_state->pending_inputs) {
+    if (input.second) continue;
+    unfed += Hash64(input.first);
+  }
+  uint64 feeds = 0;
+  for (size_t i = 0; i < req.num_feeds(); ++i) {
+    feeds += Hash64(req.feed_name(i));
+  }
+  uint64 fetches = 0;
+  for (size_t i = 0; i < req.num_fetches(); ++i) {
+    fetches += Hash64(req.fetch_name(i));
+  }
+  return Hash64Combine(unfed, Hash64Combine(feeds, fetches));
+}
+
+bool MasterSession::ReffedClientGraph::IsValidatedFetchCheck(uint64 signature) {
+  mutex_lock l(fetch_check_mu_);
+  return validated_fetch_checks_.count(signature) > 0;
+}
+
+void MasterSession::ReffedClientGraph::RecordValidatedFetchCheck(
+    uint64 signature) {
+  mutex_lock l(fetch_check_mu_);
+  // Each distinct per-chunk feed/fetch combination contributes one entry;
+  // the bound only guards against pathological clients.
+  if (validated_fetch_checks_.size() >= 10000) {
+    validated_fetch_checks_.clear();
+  }
+  validated_fetch_checks_.insert(signature);
+}
+
 // Asynchronously deregisters subgraphs on the workers, without waiting for the
 // result.
 void MasterSession::ReffedClientGraph::DeregisterPartitions() {
@@ -1543,7 +1597,7 @@ Status MasterSession::PartialRunSetup(const PartialRunSetupRequest* req,
       new RunState(inputs, outputs, rcg,
                    NewStepId(BuildGraphOptions::kNoCollectiveGraphKey), count);
   {
-    mutex_lock l(mu_);
+    mutex_lock l(partial_runs_mu_);
     partial_runs_.emplace(
         std::make_pair(handle, std::unique_ptr<RunState>(run_state)));
   }
@@ -1634,7 +1688,7 @@ Status MasterSession::DoPartialRun(CallOptions* opts,
   const string& prun_handle = req.partial_run_handle();
   RunState* run_state = nullptr;
   {
-    mutex_lock l(mu_);
+    mutex_lock l(partial_runs_mu_);
     auto it = partial_runs_.find(prun_handle);
     if (it == partial_runs_.end()) {
       return errors::InvalidArgument(
@@ -1711,10 +1765,18 @@ Status MasterSession::DoPartialRun(CallOptions* opts,
   }
 
   // Ensure that the requested fetches can be computed from the provided feeds.
-  {
-    mutex_lock l(mu_);
-    TF_RETURN_IF_ERROR(
-        run_state->rcg->CheckFetches(req, run_state, execution_state_.get()));
+  // Steps that repeat an already-validated feed/fetch combination (the
+  // steady state when streaming chunks through the same graph) skip the
+  // graph traversal, and the session lock, entirely.
+  const uint64 fetch_check_signature =
+      ReffedClientGraph::FetchCheckSignature(req, run_state);
+  if (!run_state->rcg->IsValidatedFetchCheck(fetch_check_signature)) {
+    {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(
+          run_state->rcg->CheckFetches(req, run_state, execution_state_.get()));
+    }
+    run_state->rcg->RecordValidatedFetchCheck(fetch_check_signature);
   }
 
   // Determine if this partial run satisfies all the pending inputs and outputs.
@@ -1751,7 +1813,7 @@ Status MasterSession::DoPartialRun(CallOptions* opts,
           MarkRunCompletion();
           Unref();
         });
-    mutex_lock l(mu_);
+    mutex_lock l(partial_runs_mu_);
     partial_runs_.erase(prun_handle);
   }
   return s;
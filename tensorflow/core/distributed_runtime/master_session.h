@@ -191,8 +191,12 @@ class MasterSession : public core::RefCounted {
 
     ~RunState();
   };
+  // Guards partial_runs_ separately from mu_ so that concurrent partial-run
+  // steps (e.g. many streams feeding chunks through a stateful graph) do not
+  // contend with graph-building state.
+  mutex partial_runs_mu_;
   std::unordered_map<string, std::unique_ptr<RunState>> partial_runs_
-      GUARDED_BY(mu_);
+      GUARDED_BY(partial_runs_mu_);
 
   // Active RunStep calls.
   condition_variable num_running_is_zero_;
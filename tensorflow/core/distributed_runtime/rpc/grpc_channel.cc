@@ -15,9 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_channel.h"
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "grpcpp/create_channel.h"
 
@@ -27,12 +30,14 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/host_info.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -54,8 +59,44 @@ Status ValidateHostPortPair(const string& host_port) {
   return Status::OK();
 }
 
+// Returns true if `host` names this machine.
+bool IsLocalHost(const string& host) {
+  return host.empty() || host == "localhost" || host == "127.0.0.1" ||
+         host == "::1" || host == port::Hostname();
+}
+
 }  // namespace
 
+const string& GrpcUnixSocketDir() {
+  static const string* dir = [] {
+    string d;
+    Status s = ReadStringFromEnvVar("TF_GRPC_UNIX_SOCKET_DIR", "", &d);
+    if (!s.ok()) {
+      LOG(WARNING) << "Invalid TF_GRPC_UNIX_SOCKET_DIR: " << s;
+      d.clear();
+    }
+    return new string(d);
+  }();
+  return *dir;
+}
+
+string GrpcUnixSocketPath(int port) {
+  return strings::StrCat(GrpcUnixSocketDir(), "/tf_grpc_worker_", port,
+                         ".sock");
+}
+
+string MaybeUnixSocketTarget(const string& host_port) {
+  if (GrpcUnixSocketDir().empty()) return "";
+  const auto colon_index = host_port.find_last_of(':');
+  uint32 port;
+  if (colon_index == string::npos ||
+      !strings::safe_strtou32(host_port.substr(colon_index + 1), &port)) {
+    return "";
+  }
+  if (!IsLocalHost(host_port.substr(0, colon_index))) return "";
+  return strings::StrCat("unix://", GrpcUnixSocketPath(port));
+}
+
 ::grpc::ChannelArguments GetChannelArguments(const RPCOptions* rpc_options) {
   // TODO(mrry): Implement secure channels.
   ::grpc::ChannelArguments args;
@@ -93,8 +134,23 @@ Status NewHostPortGrpcChannel(const string& target,
   TF_RETURN_IF_ERROR(ValidateHostPortPair(target));
 
   ::grpc::ChannelArguments args = GetChannelArguments(rpc_options);
-  *channel_pointer = ::grpc::CreateCustomChannel(
-      "dns:///" + target, ::grpc::InsecureChannelCredentials(), args);
+  // Tag each channel with a unique id.  Channels whose arguments compare
+  // equal share subchannels (and hence the underlying TCP connection), which
+  // would collapse the several channels a cache may keep per target back
+  // onto one connection.
+  static std::atomic<int> channel_id_counter(0);
+  args.SetInt("tensorflow.channel_id", ++channel_id_counter);
+  // A co-located worker is dialed over its Unix-domain socket when enabled,
+  // bypassing the TCP loopback stack.
+  const string unix_socket_target = MaybeUnixSocketTarget(target);
+  if (!unix_socket_target.empty()) {
+    VLOG(1) << "Dialing " << target << " via " << unix_socket_target;
+    *channel_pointer = ::grpc::CreateCustomChannel(
+        unix_socket_target, ::grpc::InsecureChannelCredentials(), args);
+  } else {
+    *channel_pointer = ::grpc::CreateCustomChannel(
+        "dns:///" + target, ::grpc::InsecureChannelCredentials(), args);
+  }
   return Status::OK();
 }
 
@@ -137,47 +193,73 @@ Status GrpcChannelSpec::AddHostPortsJob(
 namespace {
 
 // GrpcChannelCache that caches results to FindWorkerChannel() calls.
+//
+// The cache keeps num_channels_per_target channels per target and hands them
+// out round-robin, so concurrent RPCs to the same target can ride separate
+// HTTP/2 connections.
 class CachingGrpcChannelCache : public GrpcChannelCache {
  public:
-  CachingGrpcChannelCache() {}
+  explicit CachingGrpcChannelCache(int num_channels_per_target)
+      : num_channels_per_target_(std::max(1, num_channels_per_target)) {}
 
   ~CachingGrpcChannelCache() override {}
 
   SharedGrpcChannelPtr FindWorkerChannel(const string& target) override {
-    SharedGrpcChannelPtr ch = nullptr;
     {
       mutex_lock l(mu_);  // could use reader lock
-      ch = gtl::FindPtrOrNull(channels_, target);
-      if (ch) {
-        return ch;
+      ChannelState* state = gtl::FindOrNull(channels_, target);
+      if (state != nullptr) {
+        return NextChannel(state);
       }
     }
-    ch = FindChannelOnce(target);
-    if (ch) {
-      mutex_lock l(mu_);
-      channels_.insert({target, ch});
+    ChannelState new_state;
+    for (int i = 0; i < num_channels_per_target_; ++i) {
+      SharedGrpcChannelPtr ch = FindChannelOnce(target);
+      if (!ch) {
+        return nullptr;
+      }
+      new_state.channels.push_back(std::move(ch));
     }
-    return ch;
+    mutex_lock l(mu_);
+    ChannelState* state = &channels_.insert({target, new_state}).first->second;
+    return NextChannel(state);
   }
 
  protected:
-  // Find the ClientChannel for "target".  Only called when no channel was
-  // found in the channels_ cache for "target".  A non nullptr result will be
-  // cached in channels_.
+  // Find the ClientChannel for "target".  Called num_channels_per_target
+  // times when no channels were found in the channels_ cache for "target",
+  // and expected to return a distinct channel on each call.  Non nullptr
+  // results will be cached in channels_.
   virtual SharedGrpcChannelPtr FindChannelOnce(const string& target) = 0;
 
  private:
+  // Channels for one target, handed out round-robin.
+  struct ChannelState {
+    std::vector<SharedGrpcChannelPtr> channels;
+    int next = 0;
+  };
+
+  SharedGrpcChannelPtr NextChannel(ChannelState* state)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    SharedGrpcChannelPtr ch = state->channels[state->next];
+    state->next = (state->next + 1) % state->channels.size();
+    return ch;
+  }
+
+  const int num_channels_per_target_;
+
   // TODO(zhifengc): Eviction when the map becomes too big.
   mutex mu_;
-  std::unordered_map<string, SharedGrpcChannelPtr> channels_ GUARDED_BY(mu_);
+  std::unordered_map<string, ChannelState> channels_ GUARDED_BY(mu_);
 };
 
 // A ChannelCache that is the union of multiple ChannelCaches.
 // Takes ownership of the caches passed to the constructor.
 class MultiGrpcChannelCache : public CachingGrpcChannelCache {
  public:
-  explicit MultiGrpcChannelCache(const std::vector<GrpcChannelCache*>& caches)
-      : CachingGrpcChannelCache(), caches_(caches) {}
+  MultiGrpcChannelCache(const std::vector<GrpcChannelCache*>& caches,
+                        int num_channels_per_target)
+      : CachingGrpcChannelCache(num_channels_per_target), caches_(caches) {}
 
   ~MultiGrpcChannelCache() override {
     for (GrpcChannelCache* cache : caches_) {
@@ -243,8 +325,10 @@ class SparseGrpcChannelCache : public CachingGrpcChannelCache {
  public:
   SparseGrpcChannelCache(const string& job_id,
                          const std::map<int, string>& host_ports,
-                         ChannelCreationFunction channel_func)
-      : job_id_(job_id),
+                         ChannelCreationFunction channel_func,
+                         int num_channels_per_target)
+      : CachingGrpcChannelCache(num_channels_per_target),
+        job_id_(job_id),
         host_ports_(host_ports),
         channel_func_(std::move(channel_func)) {
     LOG(INFO) << "Initialize GrpcChannelCache for job " << ToString();
@@ -319,7 +403,8 @@ class SparseGrpcChannelCache : public CachingGrpcChannelCache {
 }  // namespace
 
 GrpcChannelCache* NewGrpcChannelCache(const GrpcChannelSpec& spec,
-                                      ChannelCreationFunction channel_func) {
+                                      ChannelCreationFunction channel_func,
+                                      int num_channels_per_target) {
   const int num_jobs = spec.host_ports_jobs().size();
   if (!num_jobs) {
     LOG(ERROR) << "Empty channel spec.";
@@ -328,10 +413,12 @@ GrpcChannelCache* NewGrpcChannelCache(const GrpcChannelSpec& spec,
   std::vector<GrpcChannelCache*> caches;
   caches.reserve(num_jobs);
   for (auto& job : spec.host_ports_jobs()) {
-    caches.push_back(
-        new SparseGrpcChannelCache(job.job_id, job.host_ports, channel_func));
+    caches.push_back(new SparseGrpcChannelCache(
+        job.job_id, job.host_ports, channel_func, num_channels_per_target));
   }
-  return caches.size() == 1 ? caches[0] : new MultiGrpcChannelCache(caches);
+  return caches.size() == 1
+             ? caches[0]
+             : new MultiGrpcChannelCache(caches, num_channels_per_target);
 }
 
 }  // end namespace tensorflow
@@ -82,11 +82,32 @@ class GrpcChannelCache {
 
 typedef std::function<SharedGrpcChannelPtr(string)> ChannelCreationFunction;
 
+// Creates a channel cache for the given cluster spec.  When
+// num_channels_per_target > 1, the cache maintains that many channels (each
+// backed by its own HTTP/2 connection) per target and hands them out
+// round-robin, so concurrent RPCs to one target are not serialized behind a
+// single TCP connection.
 GrpcChannelCache* NewGrpcChannelCache(const GrpcChannelSpec& channel_spec,
-                                      ChannelCreationFunction channel_func);
+                                      ChannelCreationFunction channel_func,
+                                      int num_channels_per_target = 1);
 
 // Below here are internal-only functions.
 
+// Support for same-host worker communication over Unix-domain sockets,
+// enabled by setting TF_GRPC_UNIX_SOCKET_DIR to an absolute directory
+// writable by all co-located workers.  Returns the empty string when
+// disabled.
+const string& GrpcUnixSocketDir();
+
+// The socket path a worker serving on `port` listens on when Unix-domain
+// sockets are enabled.
+string GrpcUnixSocketPath(int port);
+
+// If Unix-domain sockets are enabled and `host_port` refers to a port on
+// this host, returns the "unix://" channel target for it; otherwise returns
+// the empty string.
+string MaybeUnixSocketTarget(const string& host_port);
+
 ::grpc::ChannelArguments GetChannelArguments(const RPCOptions* rpc_options);
 
 ChannelCreationFunction ConvertToChannelCreationFunction(
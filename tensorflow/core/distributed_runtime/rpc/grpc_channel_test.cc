@@ -118,6 +118,31 @@ TEST(GrpcChannelTest, HostPorts) {
   }
 }
 
+TEST(GrpcChannelTest, MultipleChannelsPerTarget) {
+  GrpcChannelSpec spec;
+  TF_EXPECT_OK(spec.AddHostPortsJob("mnist", {"a:1", "b:2"}));
+  ChannelCreationFunction channel_func =
+      ConvertToChannelCreationFunction(NewHostPortGrpcChannel);
+  std::unique_ptr<GrpcChannelCache> cc(
+      NewGrpcChannelCache(spec, channel_func, /*num_channels_per_target=*/2));
+
+  // Successive lookups for one target alternate between its two channels.
+  auto a_1 = cc->FindWorkerChannel("/job:mnist/replica:0/task:0");
+  auto a_2 = cc->FindWorkerChannel("/job:mnist/replica:0/task:0");
+  auto a_3 = cc->FindWorkerChannel("/job:mnist/replica:0/task:0");
+  auto a_4 = cc->FindWorkerChannel("/job:mnist/replica:0/task:0");
+  EXPECT_NE(a_1.get(), a_2.get());
+  EXPECT_EQ(a_1.get(), a_3.get());
+  EXPECT_EQ(a_2.get(), a_4.get());
+
+  // Channels are never shared across targets.
+  auto b_1 = cc->FindWorkerChannel("/job:mnist/replica:0/task:1");
+  auto b_2 = cc->FindWorkerChannel("/job:mnist/replica:0/task:1");
+  EXPECT_NE(b_1.get(), b_2.get());
+  EXPECT_NE(a_1.get(), b_1.get());
+  EXPECT_NE(a_2.get(), b_2.get());
+}
+
 TEST(GrpcChannelTest, SparseHostPorts) {
   GrpcChannelSpec spec;
   TF_EXPECT_OK(
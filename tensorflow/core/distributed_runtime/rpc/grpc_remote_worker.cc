@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_remote_worker.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "grpcpp/generic/generic_stub.h"
@@ -36,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/protobuf/transport_options.pb.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -46,7 +48,8 @@ class GrpcRemoteWorker : public WorkerInterface {
   explicit GrpcRemoteWorker(SharedGrpcChannelPtr channel,
                             ::grpc::CompletionQueue* completion_queue,
                             thread::ThreadPool* callback_threadpool,
-                            WorkerCacheLogger* logger)
+                            WorkerCacheLogger* logger,
+                            GrpcMarkRecvFinishedBatcher* ack_batcher)
       : channel_(std::move(channel)),
         stub_(channel_),
         cq_(completion_queue),
@@ -67,7 +70,8 @@ class GrpcRemoteWorker : public WorkerInterface {
         instancesource_(Method(GrpcWorkerMethod::kCompleteInstance)),
         getstepsequence_(Method(GrpcWorkerMethod::kGetStepSequence)),
         markrecvfinished_(Method(GrpcWorkerMethod::kMarkRecvFinished)),
-        logger_(logger) {}
+        logger_(logger),
+        ack_batcher_(ack_batcher) {}
 
   ~GrpcRemoteWorker() override {}
 
@@ -284,6 +288,13 @@ class GrpcRemoteWorker : public WorkerInterface {
   }
 
   void IssueMarkRecvFinishedRequest(int64 request_id) {
+    if (ack_batcher_ != nullptr) {
+      // The batcher outlives this worker object, so acks survive the
+      // worker's release and coalesce across recvs from the same target.
+      ack_batcher_->EnqueueAck(channel_, cq_, callback_threadpool_,
+                               request_id);
+      return;
+    }
     VLOG(2) << "Send MarkRecvFinishedRequest for request " << request_id;
     MarkRecvFinishedRequest request;
     request.set_request_id(request_id);
@@ -321,15 +332,75 @@ class GrpcRemoteWorker : public WorkerInterface {
   // Support for logging.
   WorkerCacheLogger* logger_;
 
+  // Shared ack coalescing for MarkRecvFinished, owned by the worker cache.
+  // May be nullptr, in which case acks are sent one RPC each.
+  GrpcMarkRecvFinishedBatcher* ack_batcher_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(GrpcRemoteWorker);
 };
 
+GrpcMarkRecvFinishedBatcher::GrpcMarkRecvFinishedBatcher()
+    : method_(GrpcWorkerMethodName(GrpcWorkerMethod::kMarkRecvFinished)),
+      max_batch_size_([] {
+        int64 max_batch = 64;
+        Status s = ReadInt64FromEnvVar("TF_GRPC_RECV_ACK_MAX_BATCH", 64,
+                                       &max_batch);
+        if (!s.ok()) {
+          LOG(WARNING) << "Invalid TF_GRPC_RECV_ACK_MAX_BATCH: " << s;
+        }
+        return std::max(int64{1}, max_batch);
+      }()) {}
+
+void GrpcMarkRecvFinishedBatcher::EnqueueAck(
+    SharedGrpcChannelPtr channel, ::grpc::CompletionQueue* completion_queue,
+    thread::ThreadPool* callback_threadpool, int64 request_id) {
+  mutex_lock l(mu_);
+  std::unique_ptr<TargetState>& state = targets_[channel.get()];
+  if (state == nullptr) {
+    state.reset(new TargetState(std::move(channel), completion_queue,
+                                callback_threadpool));
+  }
+  state->pending.push_back(request_id);
+  if (!state->in_flight) {
+    Flush(state.get());
+  }
+}
+
+void GrpcMarkRecvFinishedBatcher::Flush(TargetState* state) {
+  MarkRecvFinishedRequest request;
+  const size_t num_acks =
+      std::min(state->pending.size(), static_cast<size_t>(max_batch_size_));
+  // Also set the singular field so that an older worker acks at least one
+  // request.
+  request.set_request_id(state->pending.front());
+  for (size_t i = 0; i < num_acks; ++i) {
+    request.add_request_ids(state->pending[i]);
+  }
+  state->pending.erase(state->pending.begin(), state->pending.begin() + num_acks);
+  state->in_flight = true;
+  VLOG(1) << "Send MarkRecvFinishedRequest with " << num_acks << " acks";
+
+  MarkRecvFinishedResponse* response = new MarkRecvFinishedResponse();
+  auto done = [this, state, response](Status status) {
+    delete response;
+    mutex_lock l(mu_);
+    state->in_flight = false;
+    if (!state->pending.empty()) {
+      Flush(state);
+    }
+  };
+  new RPCState<protobuf::Message>(&state->stub, state->cq, method_, request,
+                                  response, std::move(done), nullptr,
+                                  state->threadpool, kMaxWorkerRpcRetries);
+}
+
 WorkerInterface* NewGrpcRemoteWorker(SharedGrpcChannelPtr channel,
                                      ::grpc::CompletionQueue* completion_queue,
                                      thread::ThreadPool* callback_threadpool,
-                                     WorkerCacheLogger* logger) {
+                                     WorkerCacheLogger* logger,
+                                     GrpcMarkRecvFinishedBatcher* ack_batcher) {
   return new GrpcRemoteWorker(std::move(channel), completion_queue,
-                              callback_threadpool, logger);
+                              callback_threadpool, logger, ack_batcher);
 }
 
 }  // namespace tensorflow
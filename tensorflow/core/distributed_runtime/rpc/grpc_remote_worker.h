@@ -17,19 +17,70 @@ limitations under the License.
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_REMOTE_WORKER_H_
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "grpcpp/completion_queue.h"
+#include "grpcpp/generic/generic_stub.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/mutex.h"
 
 namespace tensorflow {
 class WorkerCacheLogger;
 class WorkerInterface;
 
+// Coalesces MarkRecvFinished acks destined to the same remote worker into
+// batched RPCs, so a step that receives dozens of cached tensors from one
+// worker does not pay full gRPC overhead per ack.  One instance is shared by
+// all GrpcRemoteWorker objects of a worker cache and must outlive the
+// completion queue threads that drive its callbacks.
+class GrpcMarkRecvFinishedBatcher {
+ public:
+  GrpcMarkRecvFinishedBatcher();
+
+  // Queues an ack of `request_id` for the worker served by `channel`.  The
+  // first ack to an idle target is sent immediately; acks arriving while an
+  // ack RPC to that target is in flight ride along in the next one, so the
+  // effective batching window adapts to the RPC round-trip time.
+  void EnqueueAck(SharedGrpcChannelPtr channel,
+                  ::grpc::CompletionQueue* completion_queue,
+                  thread::ThreadPool* callback_threadpool, int64 request_id);
+
+ private:
+  struct TargetState {
+    TargetState(SharedGrpcChannelPtr channel,
+                ::grpc::CompletionQueue* completion_queue,
+                thread::ThreadPool* callback_threadpool)
+        : stub(std::move(channel)),
+          cq(completion_queue),
+          threadpool(callback_threadpool) {}
+
+    ::grpc::GenericStub stub;
+    ::grpc::CompletionQueue* cq;
+    thread::ThreadPool* threadpool;
+    std::vector<int64> pending;
+    bool in_flight = false;
+  };
+
+  // Sends up to max_batch_size_ pending acks for the target in one RPC.
+  void Flush(TargetState* state) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const ::grpc::string method_;
+  // Upper bound on acks per RPC; tunable via TF_GRPC_RECV_ACK_MAX_BATCH.
+  const int64 max_batch_size_;
+
+  mutex mu_;
+  // Keyed by channel so that each remote target coalesces independently.
+  std::unordered_map<::grpc::Channel*, std::unique_ptr<TargetState>> targets_
+      GUARDED_BY(mu_);
+};
+
 WorkerInterface* NewGrpcRemoteWorker(SharedGrpcChannelPtr channel,
                                      ::grpc::CompletionQueue* completion_queue,
                                      thread::ThreadPool* callback_threadpool,
-                                     WorkerCacheLogger* logger);
+                                     WorkerCacheLogger* logger,
+                                     GrpcMarkRecvFinishedBatcher* ack_batcher);
 
 }  // namespace tensorflow
 
@@ -15,10 +15,18 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_response_cache.h"
 #include "absl/types/optional.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
 #include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 
+namespace {
+// Tensors below this size are not worth deduplicating: encoding them is
+// cheaper than the map insertion, and they are copied into the response
+// proto rather than shared by reference anyway.
+constexpr int64 kMinBytesForEncodeDedup = 1024;
+}  // namespace
+
 bool GrpcResponseCache::QueueRequest(int64 request_id, int64 step_id,
                                      const FinishResponseCB& cb) {
   VLOG(1) << "GrpcResponseCache Lookup " << request_id;
@@ -110,6 +118,49 @@ void GrpcResponseCache::CleanEntriesForStep(int64 step_id) {
       ++it;
     }
   }
+  for (auto it = encoded_tensors_.begin(), last = encoded_tensors_.end();
+       it != last;) {
+    if (it->second.step_id == step_id) {
+      it = encoded_tensors_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void GrpcResponseCache::EncodeTensorWithDedup(int64 step_id,
+                                              const Tensor& tensor,
+                                              bool is_dead, bool require_ack,
+                                              ::grpc::ByteBuffer* response) {
+  if (is_dead || tensor.TotalBytes() < kMinBytesForEncodeDedup) {
+    grpc::EncodeTensorToByteBuffer(is_dead, tensor, require_ack, response);
+    return;
+  }
+  const StepTensorKey key{step_id, tensor.tensor_data().data()};
+  {
+    mutex_lock m(mu_);
+    auto it = encoded_tensors_.find(key);
+    if (it != encoded_tensors_.end()) {
+      // Copying a ByteBuffer shares the already-serialized slices.
+      *response = it->second.buffer;
+      return;
+    }
+  }
+  // Encode outside the critical section; concurrent requests for the same
+  // buffer may race here and encode twice, which is correct, and only the
+  // first insertion is kept.
+  ::grpc::ByteBuffer buffer;
+  grpc::EncodeTensorToByteBuffer(is_dead, tensor, require_ack, &buffer);
+  {
+    mutex_lock m(mu_);
+    EncodedTensorEntry& entry = encoded_tensors_[key];
+    if (entry.step_id == -1) {
+      entry.step_id = step_id;
+      entry.tensor = tensor;
+      entry.buffer = buffer;
+    }
+  }
+  *response = buffer;
 }
 
 }  // namespace tensorflow
@@ -19,10 +19,12 @@ limitations under the License.
 #include <unordered_map>
 #include <vector>
 
+#include "grpcpp/impl/codegen/byte_buffer.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/lib/hash/hash.h"
 
 // gRPC response caching.  Most WorkerService methods cannot be retried directly
 // as they will fail or deadlock.  To enable retrying, we can instead cache
@@ -63,6 +65,17 @@ class GrpcResponseCache {
   // Erase cache entries with the given step_id
   void CleanEntriesForStep(int64 step_id);
 
+  // Encode `tensor` as a RecvTensorResponse into `response`, serializing any
+  // given tensor buffer at most once per step.  When many RecvTensor requests
+  // read the same tensor in one step (e.g. a variable broadcast to every
+  // worker), the rendezvous hands each request a Tensor sharing one
+  // underlying buffer; subsequent requests are answered with a ByteBuffer
+  // copy, which shares the already-serialized slices instead of re-encoding.
+  // Entries hold a reference on the tensor so the buffer address cannot be
+  // reused while cached, and are dropped by CleanEntriesForStep.
+  void EncodeTensorWithDedup(int64 step_id, const Tensor& tensor, bool is_dead,
+                             bool require_ack, ::grpc::ByteBuffer* response);
+
  private:
   struct ResponseCacheEntry {
     enum class State {
@@ -83,10 +96,39 @@ class GrpcResponseCache {
     std::vector<FinishResponseCB> callbacks;
   };
 
+  // Identifies a tensor buffer within a step.  The buffer address alone is
+  // not sufficient: persistent buffers (variables) keep their address across
+  // steps while their contents change.
+  struct StepTensorKey {
+    int64 step_id;
+    const void* data;
+
+    bool operator==(const StepTensorKey& other) const {
+      return step_id == other.step_id && data == other.data;
+    }
+  };
+
+  struct StepTensorKeyHash {
+    size_t operator()(const StepTensorKey& key) const {
+      return Hash64Combine(key.step_id,
+                           reinterpret_cast<uint64>(key.data));
+    }
+  };
+
+  struct EncodedTensorEntry {
+    int64 step_id = -1;
+    // Holds a reference on the underlying buffer so its address stays valid
+    // (and unique) for the lifetime of the cache entry.
+    Tensor tensor;
+    ::grpc::ByteBuffer buffer;
+  };
+
   mutex mu_;
   // response_cache_ is expected to be small, as entries are cleared immediately
   // on ack from the receiver.
   gtl::FlatMap<int64, ResponseCacheEntry> response_cache_ GUARDED_BY(mu_);
+  gtl::FlatMap<StepTensorKey, EncodedTensorEntry, StepTensorKeyHash>
+      encoded_tensors_ GUARDED_BY(mu_);
 };
 
 }  // namespace tensorflow
@@ -193,6 +193,15 @@ Status GrpcServer::Init(const GrpcServerOptions& opts) {
   ::grpc::ServerBuilder builder;
   builder.AddListeningPort(strings::StrCat("0.0.0.0:", requested_port),
                            GetServerCredentials(server_def_), &bound_port_);
+  // When Unix-domain sockets are enabled, also serve on one so co-located
+  // workers can skip the TCP loopback stack; see MaybeUnixSocketTarget() for
+  // the client side.  Skipped for a wildcard port, whose number is unknown
+  // until after the server starts.
+  if (!GrpcUnixSocketDir().empty() && requested_port != 0) {
+    builder.AddListeningPort(
+        strings::StrCat("unix://", GrpcUnixSocketPath(requested_port)),
+        GetServerCredentials(server_def_));
+  }
   builder.SetMaxMessageSize(std::numeric_limits<int32>::max());
 
   builder.SetOption(
@@ -322,8 +331,11 @@ Status GrpcServer::WorkerCacheFactory(const WorkerCacheFactoryOptions& options,
   GrpcChannelSpec channel_spec;
   TF_RETURN_IF_ERROR(ParseChannelSpec(options, &channel_spec));
 
-  channel_cache_.reset(
-      NewGrpcChannelCache(channel_spec, GetChannelCreationFunction()));
+  channel_cache_.reset(NewGrpcChannelCache(
+      channel_spec, GetChannelCreationFunction(),
+      server_def_.default_session_config()
+          .rpc_options()
+          .num_channels_per_target()));
 
   string name_prefix = strings::StrCat("/job:", *options.job_name, "/replica:0",
                                        "/task:", options.task_index);
@@ -22,6 +22,7 @@ limitations under the License.
 #include "grpcpp/impl/codegen/proto_utils.h"
 #include "grpcpp/support/byte_buffer.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -53,7 +54,22 @@ class GrpcByteSource : public TensorResponse::Source {
     return stream_;
   }
 
+  core::RefCounted* PinContents() override {
+    return new PinnedByteBuffer(*buffer_);
+  }
+
  private:
+  // Holds slice references on the response data so a tensor aliasing the
+  // receive buffer can outlive the RPC that produced it.
+  class PinnedByteBuffer : public core::RefCounted {
+   public:
+    explicit PinnedByteBuffer(const ::grpc::ByteBuffer& buffer)
+        : buffer_(buffer) {}
+
+   private:
+    ::grpc::ByteBuffer buffer_;
+  };
+
   void DeleteStream() {
     if (stream_) {
       stream_->~Reader();
@@ -77,7 +77,7 @@ class GrpcWorkerCache : public WorkerCachePartial {
       if (!channel) return nullptr;
       return NewGrpcRemoteWorker(
           channel, threads_[AssignWorkerToThread(target)].completion_queue(),
-          callback_threadpool_.get(), &logger_);
+          callback_threadpool_.get(), &logger_, &ack_batcher_);
     }
   }
 
@@ -146,6 +146,10 @@ class GrpcWorkerCache : public WorkerCachePartial {
   WorkerInterface* const local_worker_;  // Not owned.
   std::shared_ptr<GrpcChannelCache> channel_cache_;
   WorkerCacheLogger logger_;
+  // Shared by all workers created by this cache; coalesces MarkRecvFinished
+  // acks per target.  Outlives the workers and, because the destructor
+  // drains threads_ first, all in-flight callbacks.
+  GrpcMarkRecvFinishedBatcher ack_batcher_;
   std::vector<GrpcWorkerCacheThread> threads_;
 
   std::unique_ptr<thread::ThreadPool> callback_threadpool_;
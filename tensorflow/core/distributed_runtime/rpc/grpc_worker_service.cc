@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <deque>
 #include <memory>
+#include <queue>
 #include <unordered_map>
 #include <vector>
 
@@ -224,8 +225,16 @@ class GrpcWorkerServiceThread {
 
   void MarkRecvFinishedHandler(
       WorkerCall<MarkRecvFinishedRequest, MarkRecvFinishedResponse>* call) {
-    VLOG(1) << "Clean cache entry for request " << call->request.request_id();
-    worker_->RemoveCacheEntryForId(call->request.request_id());
+    if (call->request.request_ids_size() > 0) {
+      VLOG(1) << "Clean cache entries for " << call->request.request_ids_size()
+              << " batched requests";
+      for (int64 request_id : call->request.request_ids()) {
+        worker_->RemoveCacheEntryForId(request_id);
+      }
+    } else {
+      VLOG(1) << "Clean cache entry for request " << call->request.request_id();
+      worker_->RemoveCacheEntryForId(call->request.request_id());
+    }
     call->SendResponse(::grpc::Status::OK);
     ENQUEUE_REQUEST(MarkRecvFinished, false);
   }
@@ -257,24 +266,44 @@ class GrpcWorkerServiceThread {
 
   void RecvTensorHandlerRaw(
       WorkerCall<RecvTensorRequest, ::grpc::ByteBuffer>* call) {
-    Schedule([this, call]() {
-      CallOptions* call_opts = new CallOptions;
-      call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
-
-      worker_->GrpcRecvTensorAsync(
-          call_opts, &call->request, &call->response,
-          [call, call_opts](const Status& s) {
-            call->ClearCancelCallback();
-            delete call_opts;
-            if (!s.ok()) {
-              VLOG(1) << "Bad response from RecvTensor:" << s;
-            }
-            call->SendResponse(ToGrpcStatus(s));
-          });
-    });
+    // RecvTensor requests are not dispatched in arrival order: each arrival
+    // is queued by request priority and one drain task is scheduled, so when
+    // the compute pool is backlogged the pending request with the highest
+    // priority (client issue order) is serviced first.
+    {
+      mutex_lock l(pending_recvs_mu_);
+      pending_recvs_.push(
+          PendingRecvTensorCall{call->request.priority(), next_recv_arrival_++,
+                                call});
+    }
+    Schedule([this]() { DispatchRecvTensor(); });
     EnqueueRecvTensorRequestRaw();
   }
 
+  void DispatchRecvTensor() {
+    WorkerCall<RecvTensorRequest, ::grpc::ByteBuffer>* call;
+    {
+      mutex_lock l(pending_recvs_mu_);
+      // There is exactly one dispatch task scheduled per queued call, so the
+      // queue is never empty here.
+      call = pending_recvs_.top().call;
+      pending_recvs_.pop();
+    }
+    CallOptions* call_opts = new CallOptions;
+    call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+
+    worker_->GrpcRecvTensorAsync(
+        call_opts, &call->request, &call->response,
+        [call, call_opts](const Status& s) {
+          call->ClearCancelCallback();
+          delete call_opts;
+          if (!s.ok()) {
+            VLOG(1) << "Bad response from RecvTensor:" << s;
+          }
+          call->SendResponse(ToGrpcStatus(s));
+        });
+  }
+
   void RecvBufHandler(WorkerCall<RecvBufRequest, RecvBufResponse>* call) {
     Schedule([this, call]() {
       CallOptions* call_opts = new CallOptions;
@@ -344,6 +373,20 @@ class GrpcWorkerServiceThread {
     }
   }
 
+  // A RecvTensor call waiting for a dispatch task.  Ordered by request
+  // priority, then by arrival for equal priorities (std::priority_queue pops
+  // the largest element, so earlier arrivals compare greater).
+  struct PendingRecvTensorCall {
+    int32 priority;
+    uint64 arrival;
+    WorkerCall<RecvTensorRequest, ::grpc::ByteBuffer>* call;
+
+    bool operator<(const PendingRecvTensorCall& other) const {
+      if (priority != other.priority) return priority < other.priority;
+      return arrival > other.arrival;
+    }
+  };
+
   GrpcWorker* const worker_ = nullptr;  // Not owned.
   std::unique_ptr<::grpc::ServerCompletionQueue> cq_;
   std::unique_ptr<Thread> thread_;
@@ -351,6 +394,11 @@ class GrpcWorkerServiceThread {
   GrpcResponseCache* cache_;
   grpc::WorkerService::AsyncService* const worker_service_;
 
+  mutex pending_recvs_mu_;
+  std::priority_queue<PendingRecvTensorCall> pending_recvs_
+      GUARDED_BY(pending_recvs_mu_);
+  uint64 next_recv_arrival_ GUARDED_BY(pending_recvs_mu_) = 0;
+
   mutex shutdown_mu_;
   bool is_shutdown_ GUARDED_BY(shutdown_mu_);
   TF_DISALLOW_COPY_AND_ASSIGN(GrpcWorkerServiceThread);
@@ -427,6 +475,32 @@ void GrpcWorker::EnableResponseCache() {
   response_cache_ = absl::make_unique<GrpcResponseCache>();
 }
 
+namespace {
+// Bound on the number of distinct rendezvous keys remembered by
+// ParseRecvTensorKey.  A typical graph has far fewer recv keys than this; the
+// cap only guards against unbounded growth if a worker serves many sessions.
+const size_t kMaxParsedKeyCacheSize = 10000;
+}  // namespace
+
+Status GrpcWorker::ParseRecvTensorKey(const string& key,
+                                      Rendezvous::ParsedKey* parsed) {
+  {
+    mutex_lock l(parsed_key_mu_);
+    auto it = parsed_key_cache_.find(key);
+    if (it != parsed_key_cache_.end()) {
+      *parsed = it->second;
+      return Status::OK();
+    }
+  }
+  TF_RETURN_IF_ERROR(Rendezvous::ParseKey(key, parsed));
+  mutex_lock l(parsed_key_mu_);
+  if (parsed_key_cache_.size() >= kMaxParsedKeyCacheSize) {
+    parsed_key_cache_.clear();
+  }
+  parsed_key_cache_.emplace(key, *parsed);
+  return Status::OK();
+}
+
 // GrpcRecvTensorAsync: unlike the other Worker methods, which use protocol
 // buffers for a response object, to avoid extra protocol buffer serialization
 // overhead we generate our response directly into a ::grpc::ByteBuffer object
@@ -439,11 +513,19 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
 
   bool cache_enabled = (response_cache_ != nullptr && request_id != 0);
 
-  auto do_response = [response, done, cache_enabled](const Tensor& tensor,
-                                                     bool is_dead,
-                                                     const Status& status) {
+  auto do_response = [this, response, done, cache_enabled, step_id](
+                         const Tensor& tensor, bool is_dead,
+                         const Status& status) {
     if (status.ok()) {
-      grpc::EncodeTensorToByteBuffer(is_dead, tensor, cache_enabled, response);
+      if (cache_enabled) {
+        // Deduplicates serialization when many requests in this step read
+        // the same tensor, e.g. a parameter broadcast to every worker.
+        response_cache_->EncodeTensorWithDedup(step_id, tensor, is_dead,
+                                               cache_enabled, response);
+      } else {
+        grpc::EncodeTensorToByteBuffer(is_dead, tensor, cache_enabled,
+                                       response);
+      }
     }
     done(status);
   };
@@ -482,7 +564,7 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
   const string& key = request->rendezvous_key();
   TRACEPRINTF("RecvTensor: %lld %s", step_id, key.c_str());
   Rendezvous::ParsedKey parsed;
-  s = Rendezvous::ParseKey(key, &parsed);
+  s = ParseRecvTensorKey(key, &parsed);
   Device* src_dev = nullptr;
   if (s.ok()) {
     s = PrepareRecvTensor(parsed, &src_dev);
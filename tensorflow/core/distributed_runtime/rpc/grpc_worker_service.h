@@ -22,6 +22,8 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/rpc/grpc_response_cache.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service_impl.h"
 #include "tensorflow/core/distributed_runtime/worker.h"
+#include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
 namespace grpc {
@@ -63,8 +65,18 @@ class GrpcWorker : public Worker {
   void RemoveCacheEntryForId(int64 request_id);
 
  private:
+  // Parses a rendezvous key, consulting a cache of previously parsed keys.
+  // Rendezvous keys repeat verbatim on every training step, and parsing one
+  // (two device name parses plus a hex incarnation decode) is measurable on
+  // the RecvTensor hot path.
+  Status ParseRecvTensorKey(const string& key, Rendezvous::ParsedKey* parsed);
+
   std::unique_ptr<GrpcResponseCache> response_cache_;
   const int32 recv_buf_max_chunk_;
+
+  mutex parsed_key_mu_;
+  std::unordered_map<string, Rendezvous::ParsedKey> parsed_key_cache_
+      GUARDED_BY(parsed_key_mu_);
 };
 
 std::unique_ptr<GrpcWorker> NewGrpcWorker(WorkerEnv* worker_env,
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <atomic>
 #include <unordered_set>
 
 #include "tensorflow/core/common_runtime/device.h"
@@ -50,6 +51,12 @@ class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  private:
   ~RpcRemoteRendezvous() override {}
 
+  // Counts remote receives issued by this step, in order.  Used to derive
+  // the RecvTensorRequest priority: the executor issues Recv ops roughly in
+  // the order their consumers run, so earlier-issued receives are tagged
+  // with higher priority.
+  std::atomic<int32> next_recv_sequence_{0};
+
   TF_DISALLOW_COPY_AND_ASSIGN(RpcRemoteRendezvous);
 };
 
@@ -60,7 +67,8 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
 
   void Init(WorkerInterface* wi, int64 step_id, StringPiece key,
             AllocatorAttributes alloc_attrs, Device* dst_device,
-            const Rendezvous::Args& recv_args, Rendezvous::DoneCallback done) {
+            const Rendezvous::Args& recv_args, int32 priority,
+            Rendezvous::DoneCallback done) {
     wi_ = wi;
     alloc_attrs_ = alloc_attrs;
     dst_device_ = dst_device;
@@ -69,6 +77,7 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     req_.set_step_id(step_id);
     req_.set_rendezvous_key(key.data(), key.size());
     req_.set_request_id(GetUniqueRequestId());
+    req_.set_priority(priority);
   }
 
   void Reset() {
@@ -250,8 +259,11 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
     return;
   }
 
+  // Earlier-issued receives get higher priority, so the remote worker
+  // services the transfers whose consumers run first.
+  const int32 priority = kint32max - next_recv_sequence_.fetch_add(1);
   call->Init(rwi, step_id_, parsed.FullKey(), recv_args.alloc_attrs, dst_device,
-             recv_args, std::move(done));
+             recv_args, priority, std::move(done));
 
   // Record "call" in active_ so that it can be aborted cleanly.
   RegisterCall(call);
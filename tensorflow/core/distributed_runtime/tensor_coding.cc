@@ -18,6 +18,8 @@ limitations under the License.
 #include "google/protobuf/any.pb.h"
 
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 
@@ -142,10 +144,61 @@ bool ReadNestedMessage(protobuf::io::CodedInputStream* input,
   return input->DecrementRecursionDepthAndPopLimit(p.first);
 }
 
+// Tensor backing store that aliases received RPC data in place, holding a
+// reference on the transport's buffer so the tensor can outlive the
+// response it was parsed from.
+class AliasedResponseBuffer : public TensorBuffer {
+ public:
+  AliasedResponseBuffer(void* data, size_t len, core::RefCounted* owner)
+      : TensorBuffer(data), len_(len), owner_(owner) {}
+  ~AliasedResponseBuffer() override { owner_->Unref(); }
+
+  size_t size() const override { return len_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(len_);
+    proto->set_allocated_bytes(len_);
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const size_t len_;
+  core::RefCounted* const owner_;
+};
+
 }  // namespace
 
+bool TensorResponse::TryAliasTensorContent(
+    Source* source, protobuf::io::CodedInputStream* input,
+    const TensorProto& tensor_meta, int num_bytes) {
+  TensorShape shape(tensor_meta.tensor_shape());
+  if (static_cast<int64>(num_bytes) !=
+      shape.num_elements() * DataTypeSize(tensor_meta.dtype())) {
+    return false;
+  }
+  if (num_bytes == 0) return false;
+  // The whole content must be contiguous in the stream's current buffer.
+  const void* data;
+  int size;
+  if (!input->GetDirectBufferPointer(&data, &size) || size < num_bytes) {
+    return false;
+  }
+  // Tensors are handed to Eigen kernels that expect allocator alignment.
+  if (reinterpret_cast<uintptr_t>(data) % Allocator::kAllocatorAlignment != 0) {
+    return false;
+  }
+  core::RefCounted* owner = source->PinContents();
+  if (owner == nullptr) return false;
+  TensorBuffer* buf = new AliasedResponseBuffer(
+      const_cast<void*>(data), static_cast<size_t>(num_bytes), owner);
+  tensor_ = DMAHelper::MakeTensor(tensor_meta.dtype(), shape, buf);
+  buf->Unref();
+  return input->Skip(num_bytes);
+}
+
 bool TensorResponse::ParseTensorSubmessage(
-    protobuf::io::CodedInputStream* input, TensorProto* tensor_meta) {
+    Source* source, protobuf::io::CodedInputStream* input,
+    TensorProto* tensor_meta) {
   bool seen_tensor_content = false;
   while (true) {
     auto p = input->ReadTagWithCutoff(127);
@@ -195,13 +248,16 @@ bool TensorResponse::ParseTensorSubmessage(
         int num_bytes;
         if (!ReadVarintSizeAsInt(input, &num_bytes)) return false;
         seen_tensor_content = true;
+        // Land the tensor bytes with no copy when the transport can pin a
+        // suitably aligned contiguous buffer; otherwise fall back to
+        // copying into freshly allocated storage.
+        if (TryAliasTensorContent(source, input, *tensor_meta, num_bytes)) {
+          break;
+        }
         TensorShape shape(tensor_meta->tensor_shape());
         Tensor t(allocator_, tensor_meta->dtype(), shape);
         StringPiece buf = t.tensor_data();
         if (static_cast<size_t>(num_bytes) != buf.size()) return false;
-        // TODO(jeff,sanjay): Figure out a way to avoid this copy if
-        // the underlying ZeroCopyInputStream data is properly aligned
-        // and compatible with what allocator_ wants.
         if (!input->ReadRaw(const_cast<char*>(buf.data()), num_bytes))
           return false;
         tensor_ = std::move(t);
@@ -235,7 +291,7 @@ bool TensorResponse::ParseFast(Source* source) {
         std::pair<protobuf::io::CodedInputStream::Limit, int> p =
             input.IncrementRecursionDepthAndPushLimit(length);
         if (p.second < 0 ||
-            !ParseTensorSubmessage(&input, meta_.mutable_tensor())) {
+            !ParseTensorSubmessage(source, &input, meta_.mutable_tensor())) {
           return false;
         }
         if (!input.DecrementRecursionDepthAndPopLimit(p.first)) {
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/types.h"
@@ -64,6 +65,14 @@ class TensorResponse {
     // Ownership of the returned stream is retained by the Source and
     // should not be deleted by the caller.
     virtual ::tensorflow::protobuf::io::ZeroCopyInputStream* contents() = 0;
+
+    // If the memory yielded by contents() remains valid and unchanged for
+    // as long as a reference is held on the returned object, returns a new
+    // reference pinning that memory; the caller takes ownership of the
+    // reference.  Returns nullptr (the default) if the data is only valid
+    // for the duration of the ParseFrom() call, in which case ParseFrom
+    // must copy the tensor contents out of it.
+    virtual core::RefCounted* PinContents() { return nullptr; }
   };
 
   // Parse the RecvTensorResponse encoded in the data yielded by
@@ -92,8 +101,12 @@ class TensorResponse {
   DeviceBase* device() const { return device_; }
 
  private:
-  bool ParseTensorSubmessage(protobuf::io::CodedInputStream* input,
+  bool ParseTensorSubmessage(Source* source,
+                             protobuf::io::CodedInputStream* input,
                              TensorProto* tensor_meta);
+  bool TryAliasTensorContent(Source* source,
+                             protobuf::io::CodedInputStream* input,
+                             const TensorProto& tensor_meta, int num_bytes);
   bool ParseFast(Source* source);
   bool ParseSlow(Source* source);
 
@@ -19,9 +19,11 @@ limitations under the License.
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mem.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
@@ -156,6 +158,73 @@ TEST_F(TensorResponseTest, Simple) {
 
 TEST_F(TensorResponseTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+// A Source over caller-owned memory that supports pinning, so ParseFrom may
+// alias tensor contents in place instead of copying them.
+class PinnedArraySource : public TensorResponse::Source {
+ public:
+  PinnedArraySource(const char* data, size_t size)
+      : data_(data), size_(size) {}
+
+  protobuf::io::ZeroCopyInputStream* contents() override {
+    stream_.reset(new protobuf::io::ArrayInputStream(data_, size_));
+    return stream_.get();
+  }
+
+  core::RefCounted* PinContents() override {
+    ++num_pins_;
+    return new core::RefCounted;
+  }
+
+  int num_pins() const { return num_pins_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+  int num_pins_ = 0;
+  std::unique_ptr<protobuf::io::ArrayInputStream> stream_;
+};
+
+TEST_F(TensorResponseTest, AliasesPinnedSourceMemory) {
+  // Build an encoded response whose tensor content is easy to locate.
+  std::vector<int8> v(256);
+  for (int i = 0; i < 256; i++) v[i] = i % 10;
+  Tensor src(DT_INT8, TensorShape({1, 256}));
+  test::FillValues<int8>(&src, v);
+
+  RecvTensorResponse proto;
+  proto.set_send_start_micros(123456);
+  src.AsProtoTensorContent(proto.mutable_tensor());
+  string encoded;
+  proto.AppendToString(&encoded);
+
+  // Place the encoded bytes so that the tensor content lands on an
+  // allocator-aligned address, the precondition for the zero-copy path.
+  const size_t content_offset = encoded.find(
+      string(src.tensor_data().data(), src.tensor_data().size()));
+  ASSERT_NE(content_offset, string::npos);
+  const size_t kAlign = Allocator::kAllocatorAlignment;
+  char* storage = static_cast<char*>(
+      port::AlignedMalloc(encoded.size() + kAlign, kAlign));
+  const size_t shift = (kAlign - content_offset % kAlign) % kAlign;
+  memcpy(storage + shift, encoded.data(), encoded.size());
+
+  PinnedArraySource source(storage + shift, encoded.size());
+  TensorResponse response;
+  DummyDevice cpu_device(Env::Default());
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  TF_EXPECT_OK(response.ParseFrom(&source));
+
+  const Tensor& result = response.tensor();
+  EXPECT_EQ(result.dtype(), DT_INT8);
+  EXPECT_EQ(result.DebugString(), src.DebugString());
+  // The parsed tensor must alias the source buffer, not a copy of it.
+  EXPECT_EQ(result.tensor_data().data(), storage + shift + content_offset);
+  EXPECT_EQ(source.num_pins(), 1);
+
+  response.Clear();  // Release the alias before freeing the buffer.
+  port::AlignedFree(storage);
+}
+
 string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
@@ -15,7 +15,13 @@ limitations under the License.
 
 #include "tensorflow/core/framework/allocator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
 #include "tensorflow/core/framework/allocator_registry.h"
+#include "tensorflow/core/framework/allocator_telemetry.h"
 #include "tensorflow/core/framework/log_memory.h"
 #include "tensorflow/core/framework/tracking_allocator.h"
 #include "tensorflow/core/framework/variant.h"
@@ -28,13 +34,15 @@ namespace tensorflow {
 
 string AllocatorStats::DebugString() const {
   return strings::Printf(
-      "Limit:        %20lld\n"
-      "InUse:        %20lld\n"
-      "MaxInUse:     %20lld\n"
-      "NumAllocs:    %20lld\n"
-      "MaxAllocSize: %20lld\n",
+      "Limit:            %20lld\n"
+      "InUse:            %20lld\n"
+      "MaxInUse:         %20lld\n"
+      "NumAllocs:        %20lld\n"
+      "MaxAllocSize:     %20lld\n"
+      "LargestFreeBlock: %20lld\n",
       this->bytes_limit ? *this->bytes_limit : 0, this->bytes_in_use,
-      this->peak_bytes_in_use, this->num_allocs, this->largest_alloc_size);
+      this->peak_bytes_in_use, this->num_allocs, this->largest_alloc_size,
+      this->largest_free_block_bytes ? *this->largest_free_block_bytes : 0);
 }
 
 constexpr size_t Allocator::kAllocatorAlignment;
@@ -59,6 +67,58 @@ void Allocator::RunVariantDtor(Variant* p, size_t n) {
 
 // If true, cpu allocator collects more stats.
 static bool cpu_allocator_collect_stats = false;
+
+// If true (set via TF_CPU_ALLOCATOR_THREAD_CACHE before the first CPU
+// allocation), the CPU allocator keeps a per-thread magazine of recently
+// freed small blocks so hot small-tensor allocation and deallocation avoid
+// malloc entirely.  Every block then carries a small header recording its
+// size class, which is how DeallocateRaw routes a pointer back to the right
+// magazine without a size lookup.
+static bool CPUAllocatorThreadCacheEnabled() {
+  static const bool enabled = [] {
+    const char* val = std::getenv("TF_CPU_ALLOCATOR_THREAD_CACHE");
+    return val != nullptr && (val[0] == '1' || val[0] == 't' || val[0] == 'T');
+  }();
+  return enabled;
+}
+
+namespace {
+
+// Size classes cover blocks up to 4KB in 64-byte steps, which is where the
+// bulk of TensorFlow's small scalar/shape tensor buffers fall.
+constexpr size_t kThreadCacheGranularity = 64;
+constexpr int kThreadCacheNumClasses = 64;
+constexpr size_t kThreadCacheMaxBlockBytes =
+    kThreadCacheGranularity * kThreadCacheNumClasses;
+constexpr size_t kThreadCacheClassCapacity = 16;
+// Tag stored just below the user pointer: 0 for uncacheable blocks,
+// otherwise (size class + 1).
+constexpr size_t kThreadCacheUncachedTag = 0;
+
+struct CPUThreadCache {
+  // User pointers, grouped by size class.
+  std::vector<void*> blocks[kThreadCacheNumClasses];
+
+  static void* BasePtr(void* user_ptr) {
+    const size_t pad = reinterpret_cast<size_t*>(user_ptr)[-2];
+    return static_cast<char*>(user_ptr) - pad;
+  }
+
+  ~CPUThreadCache() {
+    for (auto& size_class : blocks) {
+      for (void* user_ptr : size_class) {
+        port::AlignedFree(BasePtr(user_ptr));
+      }
+    }
+  }
+};
+
+CPUThreadCache* GetCPUThreadCache() {
+  static thread_local CPUThreadCache cache;
+  return &cache;
+}
+
+}  // namespace
 // If true, cpu allocator collects full stats.
 static bool cpu_allocator_collect_full_stats = false;
 
@@ -97,7 +157,8 @@ bool CPUAllocatorFullStatsEnabled() { return cpu_allocator_collect_full_stats; }
 string AllocatorAttributes::DebugString() const {
   return strings::StrCat("AllocatorAttributes(on_host=", on_host(),
                          " nic_compatible=", nic_compatible(),
-                         " gpu_compatible=", gpu_compatible(), ")");
+                         " gpu_compatible=", gpu_compatible(),
+                         " numa_node=", numa_node, ")");
 }
 
 namespace {
@@ -124,9 +185,19 @@ class CPUAllocator : public Allocator {
                    << "% of system memory.";
     }
 
-    void* p = port::AlignedMalloc(num_bytes, alignment);
+    void* p;
+    if (CPUAllocatorThreadCacheEnabled()) {
+      p = AllocateWithThreadCache(alignment, num_bytes);
+    } else {
+      p = port::AlignedMalloc(num_bytes, alignment);
+    }
+    if (allocator_telemetry::Enabled()) {
+      static const string& cpu_allocator_name = *new string("cpu");
+      allocator_telemetry::RecordAllocation(cpu_allocator_name, num_bytes);
+    }
     if (cpu_allocator_collect_stats) {
-      const std::size_t alloc_size = port::MallocExtension_GetAllocatedSize(p);
+      const std::size_t alloc_size = port::MallocExtension_GetAllocatedSize(
+          CPUAllocatorThreadCacheEnabled() ? CPUThreadCache::BasePtr(p) : p);
       mutex_lock l(mu_);
       ++stats_.num_allocs;
       stats_.bytes_in_use += alloc_size;
@@ -135,6 +206,14 @@ class CPUAllocator : public Allocator {
       stats_.largest_alloc_size =
           std::max<int64>(stats_.largest_alloc_size, alloc_size);
 
+      if (allocator_telemetry::Enabled() && (stats_.num_allocs & 255) == 0) {
+        static const string& cpu_allocator_name = *new string("cpu");
+        // Malloc-backed, so fragmentation is not meaningful here.
+        allocator_telemetry::UpdateUsage(cpu_allocator_name,
+                                         stats_.bytes_in_use,
+                                         stats_.peak_bytes_in_use, 0);
+      }
+
       if (stats_.bytes_in_use > TotalAllocationWarningBytes() &&
           total_allocation_warning_count_ < kMaxTotalAllocationWarnings) {
         ++total_allocation_warning_count_;
@@ -148,15 +227,28 @@ class CPUAllocator : public Allocator {
 
   void DeallocateRaw(void* ptr) override {
     if (cpu_allocator_collect_stats) {
-      const std::size_t alloc_size =
-          port::MallocExtension_GetAllocatedSize(ptr);
+      const std::size_t alloc_size = port::MallocExtension_GetAllocatedSize(
+          CPUAllocatorThreadCacheEnabled() && ptr != nullptr
+              ? CPUThreadCache::BasePtr(ptr)
+              : ptr);
       mutex_lock l(mu_);
       stats_.bytes_in_use -= alloc_size;
     }
-    port::AlignedFree(ptr);
+    if (CPUAllocatorThreadCacheEnabled()) {
+      DeallocateWithThreadCache(ptr);
+    } else {
+      port::AlignedFree(ptr);
+    }
   }
 
   absl::optional<AllocatorStats> GetStats() override {
+    if (CPUAllocatorThreadCacheEnabled()) {
+      const int64 hits = thread_cache_hits_.load(std::memory_order_relaxed);
+      const int64 misses =
+          thread_cache_misses_.load(std::memory_order_relaxed);
+      VLOG(1) << "CPUAllocator thread cache: " << hits << " hits, " << misses
+              << " misses";
+    }
     mutex_lock l(mu_);
     return stats_;
   }
@@ -169,16 +261,70 @@ class CPUAllocator : public Allocator {
   }
 
   size_t AllocatedSizeSlow(const void* ptr) const override {
+    if (CPUAllocatorThreadCacheEnabled() && ptr != nullptr) {
+      return port::MallocExtension_GetAllocatedSize(
+          CPUThreadCache::BasePtr(const_cast<void*>(ptr)));
+    }
     return port::MallocExtension_GetAllocatedSize(ptr);
   }
 
  private:
+  // Allocates a block with a header recording how to free it.  The header
+  // occupies 'pad' bytes below the returned pointer: word -1 holds the size
+  // class tag and word -2 the pad (distance back to the malloc'd base).
+  void* AllocateWithThreadCache(size_t alignment, size_t num_bytes) {
+    const size_t pad =
+        std::max(alignment, size_t{Allocator::kAllocatorAlignment});
+    size_t tag = kThreadCacheUncachedTag;
+    if (pad == Allocator::kAllocatorAlignment &&
+        num_bytes <= kThreadCacheMaxBlockBytes) {
+      const size_t block_bytes =
+          std::max(kThreadCacheGranularity,
+                   (num_bytes + kThreadCacheGranularity - 1) /
+                       kThreadCacheGranularity * kThreadCacheGranularity);
+      const int size_class = block_bytes / kThreadCacheGranularity - 1;
+      CPUThreadCache* cache = GetCPUThreadCache();
+      if (!cache->blocks[size_class].empty()) {
+        void* user_ptr = cache->blocks[size_class].back();
+        cache->blocks[size_class].pop_back();
+        thread_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+        return user_ptr;
+      }
+      thread_cache_misses_.fetch_add(1, std::memory_order_relaxed);
+      tag = size_class + 1;
+      num_bytes = block_bytes;
+    }
+    void* base = port::AlignedMalloc(num_bytes + pad, pad);
+    if (base == nullptr) return nullptr;
+    void* user_ptr = static_cast<char*>(base) + pad;
+    reinterpret_cast<size_t*>(user_ptr)[-1] = tag;
+    reinterpret_cast<size_t*>(user_ptr)[-2] = pad;
+    return user_ptr;
+  }
+
+  void DeallocateWithThreadCache(void* ptr) {
+    if (ptr == nullptr) return;
+    const size_t tag = reinterpret_cast<size_t*>(ptr)[-1];
+    if (tag != kThreadCacheUncachedTag) {
+      const int size_class = tag - 1;
+      CPUThreadCache* cache = GetCPUThreadCache();
+      if (cache->blocks[size_class].size() < kThreadCacheClassCapacity) {
+        cache->blocks[size_class].push_back(ptr);
+        return;
+      }
+    }
+    port::AlignedFree(CPUThreadCache::BasePtr(ptr));
+  }
+
   mutex mu_;
   AllocatorStats stats_ GUARDED_BY(mu_);
 
   // Use <atomic> for single allocations to avoid mutex contention when
   // statistics are disabled.
   std::atomic<int> single_allocation_warning_count_;
+  // Thread-cache hit counters, maintained only when the cache is enabled.
+  std::atomic<int64> thread_cache_hits_{0};
+  std::atomic<int64> thread_cache_misses_{0};
   int total_allocation_warning_count_ GUARDED_BY(mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(CPUAllocator);
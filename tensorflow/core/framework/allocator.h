@@ -67,6 +67,13 @@ struct AllocatorStats {
   // is known.
   absl::optional<int64> bytes_limit;
 
+  // The size of the largest contiguous free block, if the allocator tracks
+  // its free space (e.g. BFCAllocator).  Together with the free byte total
+  // (bytes_limit - bytes_in_use) this exposes how fragmented the region is:
+  // an allocation larger than this value will fail even if enough bytes are
+  // free in aggregate.
+  absl::optional<int64> largest_free_block_bytes;
+
   AllocatorStats()
       : num_allocs(0),
         bytes_in_use(0),
@@ -370,6 +377,9 @@ struct AllocatorAttributes {
     scope_id = (scope_id > 0 && other.scope_id == 0)
                    ? scope_id
                    : ((scope_id == 0) ? other.scope_id : 0);
+    if (numa_node < 0) {
+      numa_node = other.numa_node;
+    }
   }
   // Returns true if the fields set in *this is a subset of or equal to
   // those set in other.
@@ -385,6 +395,11 @@ struct AllocatorAttributes {
   // EXPERIMENTAL: If this is greater than zero, then allocation is delegated to
   // a named special-purpose allocator on the same device.
   int32 scope_id = 0;
+  // If >= 0, the preferred NUMA node for the allocation.  This is a
+  // soft preference honored by devices that keep per-node allocators
+  // (currently the CPU device); other devices ignore it.  The default
+  // value matches port::kNUMANoAffinity, i.e. no preference.
+  int32 numa_node = -1;
 
   // Returns a human readable representation of this.
   string DebugString() const;
@@ -0,0 +1,79 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/allocator_telemetry.h"
+
+#include <cstdlib>
+
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/monitoring/gauge.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
+
+namespace tensorflow {
+namespace allocator_telemetry {
+namespace {
+
+auto* allocation_size_bytes = monitoring::Sampler<1>::New(
+    {"/tensorflow/core/allocator/allocation_size_bytes",
+     "Sampled allocation sizes in bytes (1 in 64 allocations per thread).",
+     "allocator"},
+    // Power of 2 starting at 64 bytes with bucket count 26 (2GB).
+    {monitoring::Buckets::Exponential(64, 2, 26)});
+
+auto* allocations = monitoring::Counter<1>::New(
+    "/tensorflow/core/allocator/allocations",
+    "Estimated number of allocations, maintained in sampled batches.",
+    "allocator");
+
+auto* bytes_in_use = monitoring::Gauge<int64, 1>::New(
+    "/tensorflow/core/allocator/bytes_in_use",
+    "Number of bytes currently in use.", "allocator");
+
+auto* peak_bytes_in_use = monitoring::Gauge<int64, 1>::New(
+    "/tensorflow/core/allocator/peak_bytes_in_use",
+    "Peak number of bytes in use.", "allocator");
+
+auto* fragmentation_ppm = monitoring::Gauge<int64, 1>::New(
+    "/tensorflow/core/allocator/fragmentation_ppm",
+    "Parts-per-million of free memory not in the largest free block.",
+    "allocator");
+
+}  // namespace
+
+bool Enabled() {
+  static const bool enabled = []() {
+    const char* env = std::getenv("TF_ALLOCATOR_TELEMETRY");
+    return env != nullptr && env[0] != '\0' && env[0] != '0';
+  }();
+  return enabled;
+}
+
+void RecordAllocation(const string& allocator_name, int64 num_bytes) {
+  static thread_local int32 sample_countdown = 0;
+  if (--sample_countdown > 0) return;
+  sample_countdown = kSampleEvery;
+  allocations->GetCell(allocator_name)->IncrementBy(kSampleEvery);
+  allocation_size_bytes->GetCell(allocator_name)->Add(num_bytes);
+}
+
+void UpdateUsage(const string& allocator_name, int64 in_use, int64 peak,
+                 int64 frag_ppm) {
+  bytes_in_use->GetCell(allocator_name)->Set(in_use);
+  peak_bytes_in_use->GetCell(allocator_name)->Set(peak);
+  fragmentation_ppm->GetCell(allocator_name)->Set(frag_ppm);
+}
+
+}  // namespace allocator_telemetry
+}  // namespace tensorflow
@@ -0,0 +1,52 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_FRAMEWORK_ALLOCATOR_TELEMETRY_H_
+#define TENSORFLOW_CORE_FRAMEWORK_ALLOCATOR_TELEMETRY_H_
+
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace allocator_telemetry {
+
+// Continuous allocator telemetry published through the monitoring library
+// (and hence exported via CollectionRegistry/CollectedMetrics), so memory
+// regressions can be diagnosed in production without a debugger. Enabled with
+// the TF_ALLOCATOR_TELEMETRY environment variable; callers are expected to
+// check Enabled() before calling the record functions.
+bool Enabled();
+
+// Number of allocations between histogram samples on each thread. Sampling
+// keeps the per-allocation cost to a thread-local decrement in the common
+// case; the allocation counter is incremented in batches of the same size so
+// rates stay accurate.
+constexpr int kSampleEvery = 64;
+
+// Records an allocation of `num_bytes` from the allocator named
+// `allocator_name`. Only every kSampleEvery-th call per thread (across all
+// allocators) feeds the size histogram.
+void RecordAllocation(const string& allocator_name, int64 num_bytes);
+
+// Publishes point-in-time usage gauges for `allocator_name`. Callers should
+// invoke this periodically (e.g. every few hundred allocations), not on every
+// allocation. `fragmentation_ppm` is parts-per-million of free memory not in
+// the largest free block; pass 0 for allocators where this is meaningless.
+void UpdateUsage(const string& allocator_name, int64 bytes_in_use,
+                 int64 peak_bytes_in_use, int64 fragmentation_ppm);
+
+}  // namespace allocator_telemetry
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_ALLOCATOR_TELEMETRY_H_
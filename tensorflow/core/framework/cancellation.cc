@@ -15,12 +15,15 @@ limitations under the License.
 
 #include "tensorflow/core/framework/cancellation.h"
 
+#include <vector>
+
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/logging.h"
 
 namespace tensorflow {
 
 const CancellationToken CancellationManager::kInvalidToken = -1;
+constexpr int CancellationManager::kNumShards;
 
 CancellationManager::CancellationManager()
     : is_cancelling_(false),
@@ -29,85 +32,111 @@ CancellationManager::CancellationManager()
 
 void CancellationManager::Reset() {
   mutex_lock l(mu_);
-  is_cancelling_ = false;
+  is_cancelling_.store(false);
   is_cancelled_.store(false);
 }
 
 void CancellationManager::StartCancel() {
-  gtl::FlatMap<CancellationToken, CancelCallback> callbacks_to_run;
   {
     mutex_lock l(mu_);
-    if (is_cancelled_.load(std::memory_order_relaxed) || is_cancelling_) {
+    if (is_cancelled_.load(std::memory_order_relaxed) ||
+        is_cancelling_.load(std::memory_order_relaxed)) {
       return;
     }
-    is_cancelling_ = true;
-    std::swap(callbacks_, callbacks_to_run);
+    // Publish is_cancelling_ before draining any shard. A concurrent
+    // registration in a shard we have not drained yet either observes the
+    // flag under its shard lock, or completes its insert first and is swept
+    // by the drain below.
+    is_cancelling_.store(true, std::memory_order_release);
+  }
+  std::vector<CancelCallback> callbacks_to_run;
+  for (CallbackShard& shard : shards_) {
+    mutex_lock l(shard.mu);
+    for (auto& key_and_value : shard.callbacks) {
+      callbacks_to_run.push_back(std::move(key_and_value.second));
+    }
+    shard.callbacks.clear();
   }
-  // We call these callbacks without holding mu_, so that concurrent
+  // We call these callbacks without holding any locks, so that concurrent
   // calls to DeregisterCallback, which can happen asynchronously, do
   // not block. The callbacks remain valid because any concurrent call
   // to DeregisterCallback will block until the
   // cancelled_notification_ is notified.
-  for (auto key_and_value : callbacks_to_run) {
-    key_and_value.second();
+  for (CancelCallback& callback : callbacks_to_run) {
+    callback();
   }
   {
     mutex_lock l(mu_);
-    is_cancelling_ = false;
+    // Set is_cancelled_ before clearing is_cancelling_ so that a lock-free
+    // reader that observes is_cancelling_ == false afterwards also observes
+    // is_cancelled_ == true.
     is_cancelled_.store(true, std::memory_order_release);
+    is_cancelling_.store(false, std::memory_order_release);
   }
   cancelled_notification_.Notify();
 }
 
 CancellationToken CancellationManager::get_cancellation_token() {
-  mutex_lock l(mu_);
-  return next_cancellation_token_++;
+  return next_cancellation_token_.fetch_add(1, std::memory_order_relaxed);
 }
 
 bool CancellationManager::RegisterCallback(CancellationToken token,
                                            CancelCallback callback) {
-  mutex_lock l(mu_);
-  CHECK_LT(token, next_cancellation_token_) << "Invalid cancellation token";
-  bool should_register = !is_cancelled_ && !is_cancelling_;
+  CHECK_LT(token, next_cancellation_token_.load(std::memory_order_relaxed))
+      << "Invalid cancellation token";
+  CallbackShard* shard = GetShard(token);
+  mutex_lock l(shard->mu);
+  bool should_register = !is_cancelling_.load(std::memory_order_acquire) &&
+                         !is_cancelled_.load(std::memory_order_acquire);
   if (should_register) {
-    std::swap(callbacks_[token], callback);
+    std::swap(shard->callbacks[token], callback);
   }
   return should_register;
 }
 
 bool CancellationManager::DeregisterCallback(CancellationToken token) {
-  mu_.lock();
-  if (is_cancelled_) {
-    mu_.unlock();
-    return false;
-  } else if (is_cancelling_) {
-    mu_.unlock();
+  CallbackShard* shard = GetShard(token);
+  shard->mu.lock();
+  // Read is_cancelling_ before is_cancelled_ (the reverse of the order in
+  // which StartCancel() sets them): if both read false while the shard lock
+  // is held, StartCancel() cannot have drained this shard yet, so erasing the
+  // callback here guarantees it will not be invoked.
+  const bool cancelling = is_cancelling_.load(std::memory_order_acquire);
+  const bool cancelled = is_cancelled_.load(std::memory_order_acquire);
+  if (!cancelling && !cancelled) {
+    shard->callbacks.erase(token);
+    shard->mu.unlock();
+    return true;
+  }
+  shard->mu.unlock();
+  if (!cancelled) {
     // Wait for all of the cancellation callbacks to be called. This
     // wait ensures that the caller of DeregisterCallback does not
     // return immediately and free objects that may be used in the
     // execution of any currently pending callbacks in StartCancel.
     cancelled_notification_.WaitForNotification();
-    return false;
-  } else {
-    callbacks_.erase(token);
-    mu_.unlock();
-    return true;
   }
+  return false;
 }
 
 bool CancellationManager::TryDeregisterCallback(CancellationToken token) {
-  mutex_lock lock(mu_);
-  if (is_cancelled_ || is_cancelling_) {
+  CallbackShard* shard = GetShard(token);
+  mutex_lock lock(shard->mu);
+  if (is_cancelling_.load(std::memory_order_acquire) ||
+      is_cancelled_.load(std::memory_order_acquire)) {
     return false;
   } else {
-    callbacks_.erase(token);
+    shard->callbacks.erase(token);
     return true;
   }
 }
 
 CancellationManager::~CancellationManager() {
-  if (!callbacks_.empty()) {
-    StartCancel();
+  for (CallbackShard& shard : shards_) {
+    if (!shard.callbacks.empty()) {
+      StartCancel();
+      break;
+    }
   }
 }
 
@@ -135,13 +135,33 @@ class CancellationManager {
   bool TryDeregisterCallback(CancellationToken token);
 
  private:
-  bool is_cancelling_;
+  // The callback table is sharded so that concurrent registrations and
+  // deregistrations (one per async op in a step) do not serialize on a single
+  // lock. StartCancel() publishes is_cancelling_ before draining any shard;
+  // registration and deregistration re-check the cancellation flags under the
+  // owning shard's lock, so a callback is either swept by the drain or its
+  // owner observes that cancellation has started.
+  struct CallbackShard {
+    mutex mu;
+    gtl::FlatMap<CancellationToken, CancelCallback> callbacks GUARDED_BY(mu);
+  };
+
+  static constexpr int kNumShards = 16;
+
+  CallbackShard* GetShard(CancellationToken token) {
+    // Tokens are assigned sequentially, so modulo spreads them evenly.
+    return &shards_[token % kNumShards];
+  }
+
+  std::atomic_bool is_cancelling_;
   std::atomic_bool is_cancelled_;
 
+  // Serializes the state transitions in StartCancel() and Reset(). Callback
+  // registration and deregistration only take the owning shard's lock.
   mutex mu_;
   Notification cancelled_notification_;
-  CancellationToken next_cancellation_token_ GUARDED_BY(mu_);
-  gtl::FlatMap<CancellationToken, CancelCallback> callbacks_ GUARDED_BY(mu_);
+  std::atomic<CancellationToken> next_cancellation_token_;
+  CallbackShard shards_[kNumShards];
 };
 
 }  // namespace tensorflow
@@ -95,6 +95,29 @@ TEST(Cancellation, CancelMultiple) {
   delete manager;
 }
 
+TEST(Cancellation, CancelAcrossShards) {
+  // Registers more callbacks than the manager has internal shards, so
+  // StartCancel must collect from every shard.
+  const int kNumCallbacks = 100;
+  CancellationManager* manager = new CancellationManager();
+  int num_called = 0;
+  std::vector<CancellationToken> tokens;
+  for (int i = 0; i < kNumCallbacks; ++i) {
+    auto token = manager->get_cancellation_token();
+    EXPECT_TRUE(
+        manager->RegisterCallback(token, [&num_called]() { ++num_called; }));
+    tokens.push_back(token);
+  }
+  // Deregistered callbacks must not run, whichever shard they live in.
+  const int kNumDeregistered = 10;
+  for (int i = 0; i < kNumDeregistered; ++i) {
+    EXPECT_TRUE(manager->DeregisterCallback(tokens[i]));
+  }
+  manager->StartCancel();
+  EXPECT_EQ(kNumCallbacks - kNumDeregistered, num_called);
+  delete manager;
+}
+
 TEST(Cancellation, IsCancelled) {
   CancellationManager* cm = new CancellationManager();
   thread::ThreadPool w(Env::Default(), "test", 4);
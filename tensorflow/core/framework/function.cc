@@ -973,6 +973,24 @@ Status FunctionCallFrame::SetArgs(gtl::ArraySlice<Tensor> args) {
   return Status::OK();
 }
 
+Status FunctionCallFrame::ConsumeArgs(gtl::InlinedVector<Tensor, 4>&& args) {
+  // Input type checks.
+  if (args.size() != arg_types_.size()) {
+    return errors::InvalidArgument("Expects ", arg_types_.size(),
+                                   " arguments, but ", args.size(),
+                                   " is provided");
+  }
+  for (size_t i = 0; i < args.size(); ++i) {
+    if (arg_types_[i] != args[i].dtype()) {
+      return errors::InvalidArgument(
+          "Expects arg[", i, "] to be ", DataTypeString(arg_types_[i]), " but ",
+          DataTypeString(args[i].dtype()), " is provided");
+    }
+  }
+  args_ = std::move(args);
+  return Status::OK();
+}
+
 Status FunctionCallFrame::GetRetvals(std::vector<Tensor>* rets) const {
   rets->clear();
   rets->reserve(rets_.size());
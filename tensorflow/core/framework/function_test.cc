@@ -951,6 +951,23 @@ TEST(FunctionCallFrame, Float_Float_Float) {
   test::ExpectTensorEqual<float>(rets[0], v);
 }
 
+TEST(FunctionCallFrame, ConsumeArgs) {
+  FunctionCallFrame frame({DT_FLOAT, DT_FLOAT}, {});
+  auto a = test::AsTensor<float>({100});
+  auto b = test::AsTensor<float>({200});
+  auto c = test::AsTensor<int64>({300});
+  HasError(frame.ConsumeArgs({a}), "Invalid argument: Expects 2 arguments");
+  HasError(frame.ConsumeArgs({a, c}),
+           "Invalid argument: Expects arg[1] to be float");
+  TF_EXPECT_OK(frame.ConsumeArgs({a, b}));
+
+  Tensor v;
+  TF_EXPECT_OK(frame.GetArg(0, &v));
+  test::ExpectTensorEqual<float>(a, v);
+  TF_EXPECT_OK(frame.GetArg(1, &v));
+  test::ExpectTensorEqual<float>(b, v);
+}
+
 TEST(Canonicalize, Basic) {
   EXPECT_EQ(Canonicalize("MatMul", Attrs({{"T", DT_FLOAT},
                                           {"transpose_a", false},
@@ -47,12 +47,41 @@ limitations under the License.
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/platform_strings.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
 
 namespace {
 
+bool PoolOutputTensorObjects() {
+  static bool pool_output_tensor_objects = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_POOL_OUTPUT_TENSOR_OBJECTS", false,
+                                   &enabled));
+    return enabled;
+  }();
+  return pool_output_tensor_objects;
+}
+
+// A per-thread freelist of Tensor objects recycled between kernel output
+// production and executor output consumption.  The pooled objects hold no
+// buffer references; only the Tensor metadata allocation is saved.
+struct OutputTensorPool {
+  static constexpr size_t kMaxPooledTensors = 32;
+  std::vector<Tensor*> tensors;
+  ~OutputTensorPool() {
+    for (Tensor* t : tensors) {
+      delete t;
+    }
+  }
+};
+
+OutputTensorPool* GetOutputTensorPool() {
+  static thread_local OutputTensorPool pool;
+  return &pool;
+}
+
 Status MatchSignatureHelper(const DataTypeSlice expected_inputs,
                             const DataTypeSlice expected_outputs,
                             const DataTypeSlice inputs,
@@ -297,10 +326,37 @@ OpKernelContext::OpKernelContext(Params* params, int num_outputs)
   }
 }
 
+Tensor* OpKernelContext::AcquireOutputTensor() {
+  if (PoolOutputTensorObjects()) {
+    OutputTensorPool* pool = GetOutputTensorPool();
+    if (!pool->tensors.empty()) {
+      Tensor* t = pool->tensors.back();
+      pool->tensors.pop_back();
+      return t;
+    }
+  }
+  return new Tensor;
+}
+
+void OpKernelContext::ReleaseOutputTensor(Tensor* tensor) {
+  if (tensor == nullptr) return;
+  if (PoolOutputTensorObjects()) {
+    OutputTensorPool* pool = GetOutputTensorPool();
+    if (pool->tensors.size() < OutputTensorPool::kMaxPooledTensors) {
+      // Drop the buffer reference now so no tensor memory is held
+      // captive by the pool.
+      *tensor = Tensor();
+      pool->tensors.push_back(tensor);
+      return;
+    }
+  }
+  delete tensor;
+}
+
 OpKernelContext::~OpKernelContext() {
   for (TensorValue& value : outputs_) {
     if (!value.is_ref()) {
-      delete value.tensor;
+      ReleaseOutputTensor(value.tensor);
     }
   }
   if (params_->record_tensor_accesses) referenced_tensors_.Destroy();
@@ -729,11 +785,13 @@ Status OpKernelContext::allocate_output(int index, const TensorShape& shape,
   const DataType type = params_->op_kernel->output_type(index);
   DCHECK(!IsRefType(type));
   DCHECK(mutable_output(index) == nullptr);
-  auto output_tensor = MakeUnique<Tensor>();
-  Status s = allocate_tensor(type, shape, output_tensor.get(), attr);
+  Tensor* output_tensor = AcquireOutputTensor();
+  Status s = allocate_tensor(type, shape, output_tensor, attr);
   if (s.ok()) {
-    outputs_[index] = TensorValue(output_tensor.release());
+    outputs_[index] = TensorValue(output_tensor);
     *output = outputs_[index].tensor;
+  } else {
+    ReleaseOutputTensor(output_tensor);
   }
   return s;
 }
@@ -812,18 +870,20 @@ void OpKernelContext::set_output(int index, const Tensor& tensor) {
             << " params_->forward_from_array[index] "
             << params_->forward_from_array[index] << " alloc_attr.scope_id "
             << allocator_attributes.scope_id;
-    auto new_tensor = MakeUnique<Tensor>();
-    Status s = allocate_tensor(type, tensor.shape(), new_tensor.get(),
+    Tensor* new_tensor = AcquireOutputTensor();
+    Status s = allocate_tensor(type, tensor.shape(), new_tensor,
                                allocator_attributes);
     TF_DCHECK_OK(s);
-    device()->CopyTensorInSameDevice(&tensor, new_tensor.get(),
-                                     op_device_context(), [](const Status&) {});
-    outputs_[index] = TensorValue(new_tensor.release());
+    device()->CopyTensorInSameDevice(&tensor, new_tensor, op_device_context(),
+                                     [](const Status&) {});
+    outputs_[index] = TensorValue(new_tensor);
   } else {
     // Input can be forwarded to output; incref on `tensor` and set output at
     // `index` to this tensor.
     record_tensor_reference(tensor);
-    outputs_[index] = TensorValue(new Tensor(tensor));
+    Tensor* output_tensor = AcquireOutputTensor();
+    *output_tensor = tensor;
+    outputs_[index] = TensorValue(output_tensor);
     if (track_allocations() && tensor.TotalBytes() > 0) {
       mutex_lock l(stats_mu_);
       if (!temp_tensor_buffer_and_size_) {
@@ -1078,6 +1138,7 @@ static KernelRegistry* GlobalKernelRegistryTyped() {
 #ifdef AUTOLOAD_DYNAMIC_KERNELS
   LoadDynamicKernels();
 #endif  // AUTOLOAD_DYNAMIC_KERNELS
+  ResolveDeferredKernelRegistrations();
   return reinterpret_cast<KernelRegistry*>(GlobalKernelRegistry());
 }
 
@@ -1089,9 +1150,12 @@ static string Key(StringPiece op_type, const DeviceType& device_type,
 
 namespace kernel_factory {
 
-void OpKernelRegistrar::InitInternal(const KernelDef* kernel_def,
-                                     StringPiece kernel_class_name,
-                                     std::unique_ptr<OpKernelFactory> factory) {
+namespace {
+
+// Inserts the given registration into the registry, consuming kernel_def.
+void InsertKernelRegistration(const KernelDef* kernel_def,
+                              StringPiece kernel_class_name,
+                              std::unique_ptr<OpKernelFactory> factory) {
   // See comments in register_kernel::Name in header for info on _no_register.
   if (kernel_def->op() != "_no_register") {
     const string key =
@@ -1100,11 +1164,12 @@ void OpKernelRegistrar::InitInternal(const KernelDef* kernel_def,
 
     // To avoid calling LoadDynamicKernels DO NOT CALL GlobalKernelRegistryTyped
     // here.
-    // InitInternal gets called by static initializers, so it ends up executing
-    // before main. This causes LoadKernelLibraries function to get called
-    // before some file libraries can initialize, which in turn crashes the
-    // program flakily. Until we get rid of static initializers in kernel
-    // registration mechanism, we have this workaround here.
+    // InsertKernelRegistration can get called by static initializers, so it
+    // can end up executing before main. This causes LoadKernelLibraries
+    // function to get called before some file libraries can initialize, which
+    // in turn crashes the program flakily. Until we get rid of static
+    // initializers in kernel registration mechanism, we have this workaround
+    // here.
     reinterpret_cast<KernelRegistry*>(GlobalKernelRegistry())
         ->emplace(key, KernelRegistration(*kernel_def, kernel_class_name,
                                           std::move(factory)));
@@ -1112,6 +1177,42 @@ void OpKernelRegistrar::InitInternal(const KernelDef* kernel_def,
   delete kernel_def;
 }
 
+// A kernel registration recorded by a static initializer but not yet
+// materialized into the registry. Recording one of these is cheap (no
+// KernelDef is built, no registry insertion happens), which keeps the
+// per-kernel static initializer cost off the process startup path.
+struct DeferredRegistration {
+  const KernelDef* (*lazy_kernel_def)();
+  StringPiece kernel_class_name;
+  std::unique_ptr<OpKernelFactory> factory;
+};
+
+mutex* GetDeferredRegistrationMu() {
+  static mutex* mu = new mutex;
+  return mu;
+}
+
+std::vector<DeferredRegistration>* GetDeferredRegistrations() {
+  static auto* deferred = new std::vector<DeferredRegistration>;
+  return deferred;
+}
+
+}  // namespace
+
+void OpKernelRegistrar::InitInternal(const KernelDef* kernel_def,
+                                     StringPiece kernel_class_name,
+                                     std::unique_ptr<OpKernelFactory> factory) {
+  InsertKernelRegistration(kernel_def, kernel_class_name, std::move(factory));
+}
+
+void OpKernelRegistrar::DeferInternal(const KernelDef* (*lazy_kernel_def)(),
+                                      StringPiece kernel_class_name,
+                                      std::unique_ptr<OpKernelFactory> factory) {
+  mutex_lock l(*GetDeferredRegistrationMu());
+  GetDeferredRegistrations()->push_back(
+      {lazy_kernel_def, kernel_class_name, std::move(factory)});
+}
+
 OpKernel* OpKernelRegistrar::PtrOpKernelFactory::Create(
     OpKernelConstruction* context) {
   return (*create_func_)(context);
@@ -1119,6 +1220,28 @@ OpKernel* OpKernelRegistrar::PtrOpKernelFactory::Create(
 
 }  // namespace kernel_factory
 
+void ResolveDeferredKernelRegistrations() {
+  // The registry insertions happen under the same lock that guards the
+  // deferred list, so a racing lookup blocks here until resolution is
+  // complete rather than observing a partially filled registry. Once the
+  // list has been drained this reduces to an uncontended lock round trip.
+  // Registrations recorded after the first resolution (e.g. from a
+  // dynamically loaded kernel library) are materialized by the next registry
+  // access, under the same rules as dynamic kernel loading today.
+  mutex_lock l(*kernel_factory::GetDeferredRegistrationMu());
+  std::vector<kernel_factory::DeferredRegistration>* deferred =
+      kernel_factory::GetDeferredRegistrations();
+  for (kernel_factory::DeferredRegistration& registration : *deferred) {
+    const KernelDef* kernel_def = registration.lazy_kernel_def();
+    if (kernel_def != nullptr) {
+      kernel_factory::InsertKernelRegistration(
+          kernel_def, registration.kernel_class_name,
+          std::move(registration.factory));
+    }
+  }
+  deferred->clear();
+}
+
 namespace {
 
 static const StringPiece kKernelAttr("_kernel");
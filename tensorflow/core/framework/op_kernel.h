@@ -696,6 +696,12 @@ class OpKernelContext {
     // Values in [0,...) represent reservations for the indexed output.
     const int* forward_from_array = nullptr;
 
+    // For each input: non-zero iff this kernel is statically the last
+    // consumer of that input tensor, so its buffer is dead after the kernel
+    // runs and is the best candidate for forwarding to an output. May be
+    // nullptr if the executor does not compute this information.
+    const uint8* input_last_use_array = nullptr;
+
     // For tracking actively running deferred ops.
     std::function<void()> inc_num_deferred_ops_function = []() {};
     std::function<void()> dec_num_deferred_ops_function = []() {};
@@ -870,9 +876,21 @@ class OpKernelContext {
       const TensorShape& output_shape, MemoryType output_memory_type,
       const AllocatorAttributes& output_attr) TF_MUST_USE_RESULT;
 
+  // Returns true iff the executor determined from the static graph that this
+  // kernel is the last consumer of the tensor at input_index, i.e. no other
+  // node reads the value, so the input buffer is dead once this kernel has
+  // run. Forwarding such an input to an output is the most profitable reuse;
+  // forward_input_or_allocate_output tries these inputs first. Returns false
+  // when the executor did not provide the information.
+  bool input_is_last_use(int input_index) const {
+    return params_->input_last_use_array != nullptr &&
+           params_->input_last_use_array[input_index] != 0;
+  }
+
   // Tries to forward one of the inputs given in input_indices to
-  // output[output_index]. If none of the given inputs can be forwarded, calls
-  // allocate_output() to allocate a new output buffer.
+  // output[output_index], preferring inputs whose last use is this kernel
+  // (see input_is_last_use). If none of the given inputs can be forwarded,
+  // calls allocate_output() to allocate a new output buffer.
   Status forward_input_or_allocate_output(
       gtl::ArraySlice<int> candidate_input_indices, int output_index,
       const TensorShape& output_shape, Tensor** output) TF_MUST_USE_RESULT;
@@ -1200,6 +1218,17 @@ class OpKernelContext {
   void set_output_ref(int index, mutex* mu, Tensor* tensor_for_ref);
   TensorValue release_output(int index);
 
+  // Obtains a default-constructed Tensor object for use as a kernel
+  // output, and returns one once the executor has consumed its contents.
+  // If "TF_POOL_OUTPUT_TENSOR_OBJECTS" is set to true these recycle the
+  // objects through a small thread-local freelist, eliminating the
+  // per-output heap allocation of Tensor metadata in steady state;
+  // otherwise they degenerate to new/delete.  A Tensor passed to
+  // ReleaseOutputTensor must be heap-allocated and unaliased, and the
+  // caller must not touch it afterwards.
+  static Tensor* AcquireOutputTensor();
+  static void ReleaseOutputTensor(Tensor* tensor);
+
   bool track_allocations() const { return params_->track_allocations; }
 
   // Records temp memory allocation. Tensor object is recorded to identify the
@@ -1396,18 +1425,19 @@ class Name : public KernelDefBuilder {
 #define REGISTER_KERNEL_BUILDER_UNIQ_HELPER(ctr, kernel_builder, ...) \
   REGISTER_KERNEL_BUILDER_UNIQ(ctr, kernel_builder, __VA_ARGS__)
 
-#define REGISTER_KERNEL_BUILDER_UNIQ(ctr, kernel_builder, ...)        \
-  constexpr bool should_register_##ctr##__flag =                      \
-      SHOULD_REGISTER_OP_KERNEL(#__VA_ARGS__);                        \
-  static ::tensorflow::kernel_factory::OpKernelRegistrar              \
-      registrar__body__##ctr##__object(                               \
-          should_register_##ctr##__flag                               \
-              ? ::tensorflow::register_kernel::kernel_builder.Build() \
-              : nullptr,                                              \
-          #__VA_ARGS__,                                               \
-          [](::tensorflow::OpKernelConstruction* context)             \
-              -> ::tensorflow::OpKernel* {                            \
-            return new __VA_ARGS__(context);                          \
+#define REGISTER_KERNEL_BUILDER_UNIQ(ctr, kernel_builder, ...)            \
+  constexpr bool should_register_##ctr##__flag =                          \
+      SHOULD_REGISTER_OP_KERNEL(#__VA_ARGS__);                            \
+  static ::tensorflow::kernel_factory::OpKernelRegistrar                  \
+      registrar__body__##ctr##__object(                                   \
+          should_register_##ctr##__flag,                                  \
+          []() -> const ::tensorflow::KernelDef* {                        \
+            return ::tensorflow::register_kernel::kernel_builder.Build(); \
+          },                                                              \
+          #__VA_ARGS__,                                                   \
+          [](::tensorflow::OpKernelConstruction* context)                 \
+              -> ::tensorflow::OpKernel* {                                \
+            return new __VA_ARGS__(context);                              \
           });
 
 // The `REGISTER_SYSTEM_KERNEL_BUILDER()` macro acts as
@@ -1420,14 +1450,18 @@ class Name : public KernelDefBuilder {
 #define REGISTER_SYSTEM_KERNEL_BUILDER_UNIQ_HELPER(ctr, kernel_builder, ...) \
   REGISTER_SYSTEM_KERNEL_BUILDER_UNIQ(ctr, kernel_builder, __VA_ARGS__)
 
-#define REGISTER_SYSTEM_KERNEL_BUILDER_UNIQ(ctr, kernel_builder, ...)    \
-  static ::tensorflow::kernel_factory::OpKernelRegistrar                 \
-      registrar__body__##ctr##__object(                                  \
-          ::tensorflow::register_kernel::system::kernel_builder.Build(), \
-          #__VA_ARGS__,                                                  \
-          [](::tensorflow::OpKernelConstruction* context)                \
-              -> ::tensorflow::OpKernel* {                               \
-            return new __VA_ARGS__(context);                             \
+#define REGISTER_SYSTEM_KERNEL_BUILDER_UNIQ(ctr, kernel_builder, ...) \
+  static ::tensorflow::kernel_factory::OpKernelRegistrar              \
+      registrar__body__##ctr##__object(                               \
+          /*should_register=*/true,                                   \
+          []() -> const ::tensorflow::KernelDef* {                    \
+            return ::tensorflow::register_kernel::system::            \
+                kernel_builder.Build();                               \
+          },                                                          \
+          #__VA_ARGS__,                                               \
+          [](::tensorflow::OpKernelConstruction* context)             \
+              -> ::tensorflow::OpKernel* {                            \
+            return new __VA_ARGS__(context);                          \
           });
 
 // Checks whether a given kernel is registered on device_type.
@@ -1453,6 +1487,14 @@ KernelList GetFilteredRegisteredKernels(
 // Gets a list of all registered kernels for a given op
 KernelList GetRegisteredKernelsForOp(StringPiece op_name);
 
+// Resolves any kernel registrations that were recorded by
+// REGISTER_KERNEL_BUILDER but have not yet been materialized into the kernel
+// registry. Registrations are recorded as cheap deferred descriptors at
+// static initialization time and resolved lazily on the first registry
+// lookup; servers that would rather pay the one-time resolution cost during
+// initialization than on the first request can call this eagerly.
+void ResolveDeferredKernelRegistrations();
+
 namespace kernel_factory {
 
 // OpKernelFactory is responsible for creating OpKernels when TensorFlow needs
@@ -1490,6 +1532,22 @@ class OpKernelRegistrar {
     }
   }
 
+  // Records a deferred registration: `lazy_kernel_def` is invoked at most
+  // once, when the kernel registry is first consulted (or when
+  // ResolveDeferredKernelRegistrations() is called). Recording only appends
+  // a few words to a list, which keeps KernelDef construction and registry
+  // insertion for every linked-in kernel off the process startup path.
+  OpKernelRegistrar(bool should_register, const KernelDef* (*lazy_kernel_def)(),
+                    StringPiece kernel_class_name,
+                    OpKernel* (*create_fn)(OpKernelConstruction*)) {
+    // Perform the check in the header to allow compile-time optimization
+    // to a no-op, allowing the linker to remove the kernel symbols.
+    if (should_register) {
+      DeferInternal(lazy_kernel_def, kernel_class_name,
+                    absl::make_unique<PtrOpKernelFactory>(create_fn));
+    }
+  }
+
  private:
   struct PtrOpKernelFactory : public OpKernelFactory {
     explicit PtrOpKernelFactory(OpKernel* (*create_func)(OpKernelConstruction*))
@@ -1502,6 +1560,10 @@ class OpKernelRegistrar {
 
   void InitInternal(const KernelDef* kernel_def, StringPiece kernel_class_name,
                     std::unique_ptr<OpKernelFactory> factory);
+
+  void DeferInternal(const KernelDef* (*lazy_kernel_def)(),
+                     StringPiece kernel_class_name,
+                     std::unique_ptr<OpKernelFactory> factory);
 };
 
 }  // namespace kernel_factory
@@ -1603,10 +1665,18 @@ inline TensorValue OpKernelContext::release_output(int index) {
 inline Status OpKernelContext::forward_input_or_allocate_output(
     gtl::ArraySlice<int> candidate_input_indices, int output_index,
     const TensorShape& output_shape, Tensor** output) {
-  for (int input_index : candidate_input_indices) {
-    if (forward_input_to_output_with_shape(input_index, output_index,
-                                           output_shape, output)) {
-      return Status::OK();
+  // Try the candidates whose last use is this kernel first: their buffers
+  // are dead after this kernel runs, so reusing one of them releases the
+  // most memory. When the executor provides no last-use information the
+  // first pass matches nothing and candidates are tried in the given order.
+  for (int round = 0; round < 2; ++round) {
+    const bool want_last_use = (round == 0);
+    for (int input_index : candidate_input_indices) {
+      if (input_is_last_use(input_index) != want_last_use) continue;
+      if (forward_input_to_output_with_shape(input_index, output_index,
+                                             output_shape, output)) {
+        return Status::OK();
+      }
     }
   }
   return allocate_output(output_index, output_shape, output);
@@ -1035,5 +1035,15 @@ TEST(RegisteredKernels, GetRegisteredKernelsForOp) {
   EXPECT_EQ(kernel_list.kernel(0).device_type(), "CPU");
 }
 
+// Eagerly resolving deferred registrations must be idempotent and must not
+// duplicate kernels that were already resolved by an earlier lookup.
+TEST(RegisteredKernels, ResolveDeferredKernelRegistrationsIsIdempotent) {
+  ResolveDeferredKernelRegistrations();
+  ResolveDeferredKernelRegistrations();
+  auto kernel_list = GetRegisteredKernelsForOp("Test1");
+  ASSERT_EQ(kernel_list.kernel_size(), 1);
+  EXPECT_EQ(kernel_list.kernel(0).device_type(), "CPU");
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -15,18 +15,23 @@ limitations under the License.
 
 #include "tensorflow/core/framework/op_segment.h"
 
+#include "tensorflow/core/framework/attr_value_util.h"
 #include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 OpSegment::Item::~Item() {
   for (auto kv : name_kernel) delete kv.second;
+  for (auto kv : shared_kernel) delete kv.second;
 }
 
 OpSegment::OpSegment() {}
@@ -71,6 +76,55 @@ Status OpSegment::FindOrCreate(const string& session_handle,
   return Status::OK();
 }
 
+Status OpSegment::FindOrCreateShared(const string& session_handle,
+                                     uint64 fingerprint, OpKernel** kernel,
+                                     CreateKernelFn create_fn) {
+  {
+    mutex_lock l(mu_);
+    auto item = gtl::FindPtrOrNull(sessions_, session_handle);
+    if (item == nullptr) {
+      return errors::NotFound("Session ", session_handle, " is not found.");
+    }
+    *kernel = gtl::FindPtrOrNull(item->shared_kernel, fingerprint);
+    if (*kernel != nullptr) {
+      return Status::OK();
+    }
+  }
+  Status s = create_fn(kernel);
+  if (!s.ok()) {
+    LOG(ERROR) << "Create kernel failed: " << s;
+    return s;
+  }
+  {
+    mutex_lock l(mu_);
+    auto item = gtl::FindPtrOrNull(sessions_, session_handle);
+    if (item == nullptr) {
+      return errors::NotFound("Session ", session_handle, " is not found.");
+    }
+    OpKernel** p_kernel = &(item->shared_kernel[fingerprint]);
+    if (*p_kernel == nullptr) {
+      *p_kernel = *kernel;  // Inserts 'kernel' in the map.
+    } else {
+      delete *kernel;
+      *kernel = *p_kernel;
+    }
+  }
+  return Status::OK();
+}
+
+uint64 OpSegment::KernelFingerprint(const NodeDef& ndef) {
+  uint64 h = Hash64(ndef.op());
+  h = Hash64Combine(h, Hash64(ndef.device()));
+  // NodeDef attrs are an unordered map; combine the per-attr hashes with an
+  // order-independent operation so that iteration order does not matter.
+  uint64 attrs_hash = 0;
+  for (const auto& attr : ndef.attr()) {
+    attrs_hash +=
+        Hash64Combine(Hash64(attr.first), AttrValueHash(attr.second));
+  }
+  return Hash64Combine(h, attrs_hash);
+}
+
 void OpSegment::AddHold(const string& session_handle) {
   mutex_lock l(mu_);
   Item** item = &sessions_[session_handle];
@@ -108,4 +162,20 @@ bool OpSegment::ShouldOwnKernel(FunctionLibraryRuntime* lib,
          node_op != "PartitionedCall" && node_op != "StatefulPartitionedCall";
 }
 
+bool OpSegment::ShouldShareKernel(FunctionLibraryRuntime* lib,
+                                  const string& node_op) {
+  static const bool share_enabled = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_OP_SEGMENT_SHARE_STATELESS_KERNELS",
+                                   false, &enabled));
+    return enabled;
+  }();
+  // Stateful kernels keep per-node state, and function kernels (CallOp and
+  // the PartitionedCall ops) hold a handle tied to a particular subgraph
+  // instantiation; neither may be shared structurally.
+  return share_enabled && !lib->IsStateful(node_op) &&
+         lib->GetFunctionLibraryDefinition()->Find(node_op) == nullptr &&
+         node_op != "PartitionedCall" && node_op != "StatefulPartitionedCall";
+}
+
 }  // end namespace tensorflow
@@ -60,16 +60,40 @@ class OpSegment {
   Status FindOrCreate(const string& session_handle, const string& node_name,
                       OpKernel** kernel, CreateKernelFn create_fn);
 
+  // Variant of FindOrCreate() that shares one kernel instance among all
+  // nodes in "session_handle" with the same structural "fingerprint"
+  // (see KernelFingerprint), regardless of node name. Callers must only
+  // use this for kernels that pass ShouldShareKernel(); the first node to
+  // be instantiated provides the NodeDef (including the node name reported
+  // in error messages) for the shared kernel.
+  Status FindOrCreateShared(const string& session_handle, uint64 fingerprint,
+                            OpKernel** kernel, CreateKernelFn create_fn);
+
+  // Fingerprint of the kernel-relevant fields of "ndef": op, device and
+  // attrs. Two nodes with the same fingerprint instantiate identical
+  // kernels.
+  static uint64 KernelFingerprint(const NodeDef& ndef);
+
   // Returns true if OpSegment should own the kernel.
   static bool ShouldOwnKernel(FunctionLibraryRuntime* lib,
                               const string& node_op);
 
+  // Returns true if identical nodes running "node_op" should share one
+  // kernel instance via FindOrCreateShared(). Only stateless, non-function
+  // kernels qualify, and sharing must be enabled by setting the environment
+  // variable TF_OP_SEGMENT_SHARE_STATELESS_KERNELS to true.
+  static bool ShouldShareKernel(FunctionLibraryRuntime* lib,
+                                const string& node_op);
+
  private:
   // op name -> OpKernel
   typedef std::unordered_map<string, OpKernel*> KernelMap;
+  // kernel fingerprint -> OpKernel
+  typedef std::unordered_map<uint64, OpKernel*> SharedKernelMap;
   struct Item {
     int num_holds = 1;      // Num of holds put on the session.
     KernelMap name_kernel;  // op name -> kernel.
+    SharedKernelMap shared_kernel;  // kernel fingerprint -> kernel.
     ~Item();
   };
 
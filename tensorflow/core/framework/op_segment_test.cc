@@ -130,6 +130,45 @@ TEST_F(OpSegmentTest, CreateFailure) {
   opseg.RemoveHold("A");
 }
 
+TEST_F(OpSegmentTest, StructuralSharing) {
+  OpSegment opseg;
+  OpKernel* op;
+  OpKernel* other_op;
+
+  // All the float Mul nodes differ only in name, so they share a
+  // fingerprint; the int32 nodes hash differently.
+  const uint64 f_fp = OpSegment::KernelFingerprint(float_nodedefs_[0]);
+  for (int i = 1; i < 10; ++i) {
+    EXPECT_EQ(f_fp, OpSegment::KernelFingerprint(float_nodedefs_[i]));
+    EXPECT_NE(f_fp, OpSegment::KernelFingerprint(int32_nodedefs_[i]));
+  }
+
+  opseg.AddHold("A");
+  auto* ndef = &float_nodedefs_[0];
+  TF_EXPECT_OK(opseg.FindOrCreateShared(
+      "A", OpSegment::KernelFingerprint(*ndef), &op, GetFn(ndef)));
+  ValidateOpAndTypes(op, *ndef, DT_FLOAT);
+
+  // A differently named but structurally identical node reuses the same
+  // kernel instance without invoking the create function.
+  auto reterr = [](OpKernel** kernel) {
+    return errors::Internal("Should not be called");
+  };
+  TF_EXPECT_OK(opseg.FindOrCreateShared(
+      "A", OpSegment::KernelFingerprint(float_nodedefs_[1]), &other_op,
+      reterr));
+  EXPECT_EQ(op, other_op);
+
+  // A node with a different fingerprint gets its own kernel.
+  ndef = &int32_nodedefs_[0];
+  TF_EXPECT_OK(opseg.FindOrCreateShared(
+      "A", OpSegment::KernelFingerprint(*ndef), &other_op, GetFn(ndef)));
+  EXPECT_NE(op, other_op);
+  ValidateOpAndTypes(other_op, *ndef, DT_INT32);
+
+  opseg.RemoveHold("A");
+}
+
 TEST_F(OpSegmentTest, AddRemoveHolds) {
   OpSegment opseg;
   OpKernel* op;
@@ -168,7 +168,7 @@ class LocalRendezvousImpl : public Rendezvous {
       // There is no waiter for this message. Append the message
       // into the queue. The waiter will pick it up when arrives.
       // Only send-related fields need to be filled.
-      Item* item = new Item;
+      Item* item = AcquireItem();
       item->value = val;
       item->is_dead = is_dead;
       item->send_args = send_args;
@@ -189,7 +189,7 @@ class LocalRendezvousImpl : public Rendezvous {
     // lock.
     DCHECK(!item->IsSendValue());
     item->waiter(Status::OK(), send_args, item->recv_args, val, is_dead);
-    delete item;
+    ReleaseItem(item);
     return Status::OK();
   }
 
@@ -211,7 +211,7 @@ class LocalRendezvousImpl : public Rendezvous {
     if (queue->empty() || !queue->front()->IsSendValue()) {
       // There is no message to pick up.
       // Only recv-related fields need to be filled.
-      Item* item = new Item;
+      Item* item = AcquireItem();
       item->waiter = std::move(done);
       item->recv_args = recv_args;
       if (item->recv_args.device_context) {
@@ -232,7 +232,7 @@ class LocalRendezvousImpl : public Rendezvous {
     // of the table lock.
     DCHECK(item->IsSendValue());
     done(Status::OK(), item->send_args, recv_args, item->value, item->is_dead);
-    delete item;
+    ReleaseItem(item);
   }
 
   void StartAbort(const Status& status) override {
@@ -274,8 +274,50 @@ class LocalRendezvousImpl : public Rendezvous {
 
     // Returns true iff this item represents a value being sent.
     bool IsSendValue() const { return this->waiter == nullptr; }
+
+    // Releases held references and restores the default-constructed state
+    // so the item can be recycled by AcquireItem().
+    void Reset() {
+      if (send_args.device_context) {
+        send_args.device_context->Unref();
+      }
+      if (recv_args.device_context) {
+        recv_args.device_context->Unref();
+      }
+      send_args = Args();
+      recv_args = Args();
+      waiter = nullptr;
+      value = Tensor();
+      is_dead = false;
+    }
   };
 
+  // Steady-state Send/Recv traffic creates and destroys one Item per
+  // message.  Recycle them through a small free list so the common case
+  // does not hit the heap.
+  static const size_t kMaxFreeItems = 64;
+
+  Item* AcquireItem() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (free_items_.empty()) return new Item;
+    Item* item = free_items_.back();
+    free_items_.pop_back();
+    return item;
+  }
+
+  void ReleaseItem(Item* item) {
+    // Reset outside the lock: it may drop the last reference to a large
+    // tensor buffer.
+    item->Reset();
+    {
+      mutex_lock l(mu_);
+      if (free_items_.size() < kMaxFreeItems) {
+        free_items_.push_back(item);
+        return;
+      }
+    }
+    delete item;
+  }
+
   // We key the hash table by KeyHash of the Rendezvous::CreateKey string
   static uint64 KeyHash(const StringPiece& k) {
     return Hash64(k.data(), k.size());
@@ -294,11 +336,15 @@ class LocalRendezvousImpl : public Rendezvous {
   mutex mu_;
   Table table_ GUARDED_BY(mu_);
   Status status_ GUARDED_BY(mu_);
+  std::vector<Item*> free_items_ GUARDED_BY(mu_);
 
   ~LocalRendezvousImpl() override {
     if (!table_.empty()) {
       StartAbort(errors::Cancelled("LocalRendezvousImpl deleted"));
     }
+    for (Item* item : free_items_) {
+      delete item;
+    }
   }
 
   TF_DISALLOW_COPY_AND_ASSIGN(LocalRendezvousImpl);
@@ -78,8 +78,11 @@ Status ValidateDevice(OpKernelContext* ctx, const ResourceHandle& p) {
 
 }  // end namespace internal
 
+constexpr int ResourceMgr::kNumShards;
+
 Status ResourceMgr::InsertDebugTypeName(uint64 hash_code,
                                         const string& type_name) {
+  mutex_lock l(debug_mu_);
   auto iter = debug_type_names_.emplace(hash_code, type_name);
   if (iter.first->second != type_name) {
     return errors::AlreadyExists("Duplicate hash code found for type ",
@@ -89,6 +92,7 @@ Status ResourceMgr::InsertDebugTypeName(uint64 hash_code,
 }
 
 const char* ResourceMgr::DebugTypeName(uint64 hash_code) const {
+  mutex_lock l(debug_mu_);
   auto type_name_iter = debug_type_names_.find(hash_code);
   if (type_name_iter == debug_type_names_.end()) {
     return "<unknown>";
@@ -105,54 +109,55 @@ ResourceMgr::ResourceMgr(const string& default_container)
 ResourceMgr::~ResourceMgr() { Clear(); }
 
 void ResourceMgr::Clear() {
-  mutex_lock l(mu_);
-  for (const auto& p : containers_) {
-    for (const auto& q : *p.second) {
-      q.second->Unref();
+  for (ResourceShard& shard : shards_) {
+    mutex_lock l(shard.mu);
+    for (const auto& p : shard.containers) {
+      for (const auto& q : *p.second) {
+        q.second->Unref();
+      }
+      delete p.second;
     }
-    delete p.second;
+    shard.containers.clear();
+  }
+  {
+    mutex_lock l(containers_mu_);
+    container_counts_.clear();
   }
-  containers_.clear();
+  generation_.fetch_add(1, std::memory_order_release);
 }
 
 string ResourceMgr::DebugString() const {
-  mutex_lock l(mu_);
-  struct Line {
-    const string* container;
-    const string type;
-    const string* resource;
-    const string detail;
-  };
-  std::vector<Line> lines;
-  for (const auto& p : containers_) {
-    const string& container = p.first;
-    for (const auto& q : *p.second) {
-      const Key& key = q.first;
-      const char* type = DebugTypeName(key.first);
-      const string& resource = key.second;
-      Line l{&container, port::Demangle(type), &resource,
-             q.second->DebugString()};
-      lines.push_back(l);
-    }
-  }
   std::vector<string> text;
-  text.reserve(lines.size());
-  for (const Line& line : lines) {
-    text.push_back(strings::Printf(
-        "%-20s | %-40s | %-40s | %-s", line.container->c_str(),
-        line.type.c_str(), line.resource->c_str(), line.detail.c_str()));
+  for (const ResourceShard& shard : shards_) {
+    mutex_lock l(shard.mu);
+    for (const auto& p : shard.containers) {
+      const string& container = p.first;
+      for (const auto& q : *p.second) {
+        const Key& key = q.first;
+        const string type = port::Demangle(DebugTypeName(key.first));
+        const string& resource = key.second;
+        text.push_back(strings::Printf(
+            "%-20s | %-40s | %-40s | %-s", container.c_str(), type.c_str(),
+            resource.c_str(), q.second->DebugString().c_str()));
+      }
+    }
   }
   std::sort(text.begin(), text.end());
   return str_util::Join(text, "\n");
 }
 
-Status ResourceMgr::DoCreate(const string& container, TypeIndex type,
-                             const string& name, ResourceBase* resource) {
-  Container** b = &containers_[container];
+Status ResourceMgr::DoCreate(ResourceShard* shard, const string& container,
+                             TypeIndex type, const string& name,
+                             ResourceBase* resource) {
+  Container** b = &shard->containers[container];
   if (*b == nullptr) {
     *b = new Container;
   }
   if ((*b)->insert({{type.hash_code(), name}, resource}).second) {
+    {
+      mutex_lock l(containers_mu_);
+      ++container_counts_[container];
+    }
     TF_RETURN_IF_ERROR(InsertDebugTypeName(type.hash_code(), type.name()));
     return Status::OK();
   }
@@ -161,17 +166,21 @@ Status ResourceMgr::DoCreate(const string& container, TypeIndex type,
                                type.name());
 }
 
-Status ResourceMgr::DoLookup(const string& container, TypeIndex type,
+Status ResourceMgr::DoLookup(const ResourceShard& shard,
+                             const string& container, TypeIndex type,
                              const string& name,
                              ResourceBase** resource) const {
-  const Container* b = gtl::FindPtrOrNull(containers_, container);
-  if (b == nullptr) {
-    return errors::NotFound("Container ", container,
-                            " does not exist. (Could not find resource: ",
-                            container, "/", name, ")");
-  }
-  auto r = gtl::FindPtrOrNull(*b, {type.hash_code(), name});
+  const Container* b = gtl::FindPtrOrNull(shard.containers, container);
+  auto r = (b == nullptr) ? nullptr
+                          : gtl::FindPtrOrNull(*b, {type.hash_code(), name});
   if (r == nullptr) {
+    // The container may exist in other shards even if this shard has no
+    // table for it.
+    if (b == nullptr && !ContainerExists(container)) {
+      return errors::NotFound("Container ", container,
+                              " does not exist. (Could not find resource: ",
+                              container, "/", name, ")");
+    }
     return errors::NotFound("Resource ", container, "/", name, "/", type.name(),
                             " does not exist.");
   }
@@ -183,11 +192,16 @@ Status ResourceMgr::DoLookup(const string& container, TypeIndex type,
 Status ResourceMgr::DoDelete(const string& container, uint64 type_hash_code,
                              const string& resource_name,
                              const string& type_name) {
+  ResourceShard* shard = GetShard(container, type_hash_code, resource_name);
   ResourceBase* base = nullptr;
   {
-    mutex_lock l(mu_);
-    Container* b = gtl::FindPtrOrNull(containers_, container);
+    mutex_lock l(shard->mu);
+    Container* b = gtl::FindPtrOrNull(shard->containers, container);
     if (b == nullptr) {
+      if (ContainerExists(container)) {
+        return errors::NotFound("Resource ", container, "/", resource_name,
+                                "/", type_name, " does not exist.");
+      }
       return errors::NotFound("Container ", container, " does not exist.");
     }
     auto iter = b->find({type_hash_code, resource_name});
@@ -198,6 +212,14 @@ Status ResourceMgr::DoDelete(const string& container, uint64 type_hash_code,
     base = iter->second;
     b->erase(iter);
   }
+  {
+    mutex_lock l(containers_mu_);
+    auto iter = container_counts_.find(container);
+    if (iter != container_counts_.end() && --iter->second <= 0) {
+      container_counts_.erase(iter);
+    }
+  }
+  generation_.fetch_add(1, std::memory_order_release);
   CHECK(base != nullptr);
   base->Unref();
   return Status::OK();
@@ -214,29 +236,42 @@ Status ResourceMgr::Delete(const ResourceHandle& handle) {
 }
 
 Status ResourceMgr::Cleanup(const string& container) {
-  {
-    tf_shared_lock l(mu_);
-    if (!gtl::FindOrNull(containers_, container)) {
-      // Nothing to cleanup.
-      return Status::OK();
+  // A container's resources are spread across all shards; drop the
+  // container's table from each of them.
+  bool found = false;
+  for (ResourceShard& shard : shards_) {
+    Container* b = nullptr;
+    {
+      tf_shared_lock l(shard.mu);
+      if (!gtl::FindOrNull(shard.containers, container)) {
+        // Nothing to cleanup in this shard.
+        continue;
+      }
     }
-  }
-  Container* b = nullptr;
-  {
-    mutex_lock l(mu_);
-    auto iter = containers_.find(container);
-    if (iter == containers_.end()) {
-      // Nothing to cleanup, it's OK (concurrent cleanup).
-      return Status::OK();
+    {
+      mutex_lock l(shard.mu);
+      auto iter = shard.containers.find(container);
+      if (iter == shard.containers.end()) {
+        // Nothing to cleanup, it's OK (concurrent cleanup).
+        continue;
+      }
+      b = iter->second;
+      shard.containers.erase(iter);
     }
-    b = iter->second;
-    containers_.erase(iter);
+    CHECK(b != nullptr);
+    for (const auto& p : *b) {
+      p.second->Unref();
+    }
+    delete b;
+    found = true;
   }
-  CHECK(b != nullptr);
-  for (const auto& p : *b) {
-    p.second->Unref();
+  if (found) {
+    {
+      mutex_lock l(containers_mu_);
+      container_counts_.erase(container);
+    }
+    generation_.fetch_add(1, std::memory_order_release);
   }
-  delete b;
   return Status::OK();
 }
 
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <typeindex>
@@ -136,8 +137,8 @@ class ResourceMgr {
   Status Lookup(const string& container, const string& name,
                 T** resource) const TF_MUST_USE_RESULT;
 
-  // Similar to Lookup, but looks up multiple resources at once, with only a
-  // single lock acquisition.  If containers_and_names[i] is uninitialized
+  // Similar to Lookup, but looks up multiple resources at once, locking each
+  // resource's shard in turn.  If containers_and_names[i] is uninitialized
   // then this function does not modify resources[i].
   template <typename T, bool use_dynamic_cast = false>
   Status LookupMany(absl::Span<std::pair<const string*, const string*> const>
@@ -178,6 +179,13 @@ class ResourceMgr {
   // Returns a text description for all resources.
   string DebugString() const;
 
+  // Returns a counter that is incremented whenever a resource is removed
+  // from *this.  ResourceHandleCache compares it against the value observed
+  // when a pointer was cached to decide whether the cache is still valid.
+  int64 generation() const {
+    return generation_.load(std::memory_order_acquire);
+  }
+
  private:
   typedef std::pair<uint64, string> Key;
   struct KeyHash {
@@ -192,22 +200,56 @@ class ResourceMgr {
   };
   typedef std::unordered_map<Key, ResourceBase*, KeyHash, KeyEqual> Container;
 
+  // The resource tables are sharded by the hash of the resource key so that
+  // concurrent accesses to different resources rarely contend on a lock.
+  // Each shard maps container names to the subset of that container's
+  // resources whose keys hash to the shard.
+  struct ResourceShard {
+    mutable mutex mu;
+    std::unordered_map<string, Container*> containers GUARDED_BY(mu);
+  };
+  static constexpr int kNumShards = 16;
+
   const string default_container_;
-  mutable mutex mu_;
-  std::unordered_map<string, Container*> containers_ GUARDED_BY(mu_);
+  mutable ResourceShard shards_[kNumShards];
+
+  // Incremented whenever a resource is removed from any container.
+  std::atomic<int64> generation_{0};
+
+  // Names of the containers that currently hold at least one resource,
+  // with the number of resources in each.  Kept so error messages can
+  // distinguish a missing container from a missing resource without
+  // visiting every shard.  Lock ordering: any shard mu < containers_mu_.
+  mutable mutex containers_mu_;
+  std::unordered_map<string, int64> container_counts_ GUARDED_BY(containers_mu_);
+
+  // Returns true iff some shard holds a resource in "container".
+  bool ContainerExists(const string& container) const {
+    mutex_lock l(containers_mu_);
+    return container_counts_.find(container) != container_counts_.end();
+  }
+
+  // Returns the shard holding the resource key (container, type, name).
+  ResourceShard* GetShard(const string& container, uint64 type_hash_code,
+                          const string& name) const {
+    uint64 h = Hash64(name.data(), name.size(), type_hash_code);
+    h = Hash64(container.data(), container.size(), h);
+    return &shards_[h % kNumShards];
+  }
 
   template <typename T, bool use_dynamic_cast = false>
-  Status LookupInternal(const string& container, const string& name,
-                        T** resource) const
-      SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+  Status LookupInternal(const ResourceShard& shard, const string& container,
+                        const string& name, T** resource) const
+      SHARED_LOCKS_REQUIRED(shard.mu) TF_MUST_USE_RESULT;
 
-  Status DoCreate(const string& container, TypeIndex type, const string& name,
-                  ResourceBase* resource)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+  Status DoCreate(ResourceShard* shard, const string& container,
+                  TypeIndex type, const string& name, ResourceBase* resource)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->mu) TF_MUST_USE_RESULT;
 
-  Status DoLookup(const string& container, TypeIndex type, const string& name,
+  Status DoLookup(const ResourceShard& shard, const string& container,
+                  TypeIndex type, const string& name,
                   ResourceBase** resource) const
-      SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+      SHARED_LOCKS_REQUIRED(shard.mu) TF_MUST_USE_RESULT;
 
   Status DoDelete(const string& container, uint64 type_hash_code,
                   const string& resource_name,
@@ -216,17 +258,17 @@ class ResourceMgr {
                   const string& resource_name) TF_MUST_USE_RESULT;
 
   // Inserts the type name for 'hash_code' into the hash_code to type name map.
-  Status InsertDebugTypeName(uint64 hash_code, const string& type_name)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+  Status InsertDebugTypeName(uint64 hash_code,
+                             const string& type_name) TF_MUST_USE_RESULT;
 
   // Returns the type name for the 'hash_code'.
   // Returns "<unknown>" if a resource with such a type was never inserted into
   // the container.
-  const char* DebugTypeName(uint64 hash_code) const
-      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  const char* DebugTypeName(uint64 hash_code) const;
 
   // Map from type hash_code to type name.
-  std::unordered_map<uint64, string> debug_type_names_ GUARDED_BY(mu_);
+  mutable mutex debug_mu_;
+  std::unordered_map<uint64, string> debug_type_names_ GUARDED_BY(debug_mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(ResourceMgr);
 };
@@ -296,6 +338,61 @@ Status DeleteResource(OpKernelContext* ctx, const ResourceHandle& p);
 // resource is not present in the container.
 Status DeleteResource(OpKernelContext* ctx, const ResourceHandle& p);
 
+// Caches the result of a successful LookupResource call so that a kernel
+// which dereferences the same handle on every execution (e.g. a variable
+// read issued once per step) can skip the resource manager's tables on
+// repeat lookups.  The cache holds one ref on the cached resource and
+// checks ResourceMgr::generation() on every hit, so it never serves a
+// pointer after the resource (or its container) has been deleted.
+// Thread-safe; intended to be a member of the kernel.
+template <typename T>
+class ResourceHandleCache {
+ public:
+  ResourceHandleCache() {}
+
+  ~ResourceHandleCache() {
+    if (resource_ != nullptr) resource_->Unref();
+  }
+
+  // Same contract as LookupResource: if the lookup succeeds, the caller
+  // takes the ownership of one ref on "*value".
+  Status Lookup(OpKernelContext* ctx, const ResourceHandle& p, T** value) {
+    const ResourceMgr* mgr = ctx->resource_manager();
+    // The generation is captured before consulting the tables so that any
+    // deletion racing with this lookup invalidates what we cache below.
+    const int64 generation = mgr->generation();
+    {
+      tf_shared_lock l(mu_);
+      if (resource_ != nullptr && mgr_ == mgr && generation_ == generation &&
+          p.hash_code() == handle_.hash_code() && p.name() == handle_.name() &&
+          p.container() == handle_.container() &&
+          p.device() == handle_.device()) {
+        resource_->Ref();
+        *value = resource_;
+        return Status::OK();
+      }
+    }
+    TF_RETURN_IF_ERROR(LookupResource(ctx, p, value));
+    mutex_lock l(mu_);
+    if (resource_ != nullptr) resource_->Unref();
+    (*value)->Ref();
+    resource_ = *value;
+    handle_ = p;
+    mgr_ = mgr;
+    generation_ = generation;
+    return Status::OK();
+  }
+
+ private:
+  mutex mu_;
+  const ResourceMgr* mgr_ GUARDED_BY(mu_) = nullptr;
+  int64 generation_ GUARDED_BY(mu_) = -1;
+  ResourceHandle handle_ GUARDED_BY(mu_);
+  T* resource_ GUARDED_BY(mu_) = nullptr;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ResourceHandleCache);
+};
+
 // Policy helper to decide which container/shared_name to use for a
 // stateful kernel that accesses shared resource.
 class ContainerInfo {
@@ -433,16 +530,20 @@ Status ResourceMgr::Create(const string& container, const string& name,
                            T* resource) {
   CheckDeriveFromResourceBase<T>();
   CHECK(resource != nullptr);
-  mutex_lock l(mu_);
-  return DoCreate(container, MakeTypeIndex<T>(), name, resource);
+  const TypeIndex type = MakeTypeIndex<T>();
+  ResourceShard* shard = GetShard(container, type.hash_code(), name);
+  mutex_lock l(shard->mu);
+  return DoCreate(shard, container, type, name, resource);
 }
 
 template <typename T, bool use_dynamic_cast>
 Status ResourceMgr::Lookup(const string& container, const string& name,
                            T** resource) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
-  return LookupInternal<T, use_dynamic_cast>(container, name, resource);
+  const ResourceShard& shard =
+      *GetShard(container, MakeTypeIndex<T>().hash_code(), name);
+  tf_shared_lock l(shard.mu);
+  return LookupInternal<T, use_dynamic_cast>(shard, container, name, resource);
 }
 
 template <typename T, bool use_dynamic_cast>
@@ -451,13 +552,16 @@ Status ResourceMgr::LookupMany(
         containers_and_names,
     std::vector<std::unique_ptr<T, core::RefCountDeleter>>* resources) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
+  const uint64 type_hash_code = MakeTypeIndex<T>().hash_code();
   resources->resize(containers_and_names.size());
   for (size_t i = 0; i < containers_and_names.size(); ++i) {
     T* resource;
-    Status s = LookupInternal<T, use_dynamic_cast>(
-        *containers_and_names[i].first, *containers_and_names[i].second,
-        &resource);
+    const string& container = *containers_and_names[i].first;
+    const string& name = *containers_and_names[i].second;
+    const ResourceShard& shard = *GetShard(container, type_hash_code, name);
+    tf_shared_lock l(shard.mu);
+    Status s =
+        LookupInternal<T, use_dynamic_cast>(shard, container, name, &resource);
     if (s.ok()) {
       (*resources)[i].reset(resource);
     }
@@ -477,10 +581,11 @@ struct TypeCastFunctor<T, true> {
 };
 
 template <typename T, bool use_dynamic_cast>
-Status ResourceMgr::LookupInternal(const string& container, const string& name,
+Status ResourceMgr::LookupInternal(const ResourceShard& shard,
+                                   const string& container, const string& name,
                                    T** resource) const {
   ResourceBase* found = nullptr;
-  Status s = DoLookup(container, MakeTypeIndex<T>(), name, &found);
+  Status s = DoLookup(shard, container, MakeTypeIndex<T>(), name, &found);
   if (s.ok()) {
     // It's safe to down cast 'found' to T* since
     // typeid(T).hash_code() is part of the map key.
@@ -494,18 +599,20 @@ Status ResourceMgr::LookupOrCreate(const string& container, const string& name,
                                    T** resource,
                                    std::function<Status(T**)> creator) {
   CheckDeriveFromResourceBase<T>();
+  const TypeIndex type = MakeTypeIndex<T>();
+  ResourceShard* shard = GetShard(container, type.hash_code(), name);
   *resource = nullptr;
   Status s;
   {
-    tf_shared_lock l(mu_);
-    s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
+    tf_shared_lock l(shard->mu);
+    s = LookupInternal<T, use_dynamic_cast>(*shard, container, name, resource);
     if (s.ok()) return s;
   }
-  mutex_lock l(mu_);
-  s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
+  mutex_lock l(shard->mu);
+  s = LookupInternal<T, use_dynamic_cast>(*shard, container, name, resource);
   if (s.ok()) return s;
   TF_RETURN_IF_ERROR(creator(resource));
-  s = DoCreate(container, MakeTypeIndex<T>(), name, *resource);
+  s = DoCreate(shard, container, type, name, *resource);
   if (!s.ok()) {
     return errors::Internal("LookupOrCreate failed unexpectedly");
   }
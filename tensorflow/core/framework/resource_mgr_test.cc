@@ -125,6 +125,34 @@ TEST(ResourceMgrTest, Basic) {
   TF_CHECK_OK(rm.Cleanup("bar"));
 }
 
+TEST(ResourceMgrTest, GenerationCountsRemovalsOnly) {
+  ResourceMgr rm;
+  const int64 gen0 = rm.generation();
+
+  // Creating resources never invalidates a previously cached pointer, so
+  // the generation must not move.
+  TF_CHECK_OK(rm.Create("foo", "bar", new Resource("cat")));
+  TF_CHECK_OK(rm.Create("foo", "baz", new Resource("dog")));
+  EXPECT_EQ(gen0, rm.generation());
+
+  // Every form of removal must advance it.
+  TF_CHECK_OK(rm.Delete<Resource>("foo", "bar"));
+  const int64 gen1 = rm.generation();
+  EXPECT_LT(gen0, gen1);
+
+  TF_CHECK_OK(rm.Cleanup("foo"));
+  const int64 gen2 = rm.generation();
+  EXPECT_LT(gen1, gen2);
+
+  // Cleaning up a container that does not exist removes nothing.
+  TF_CHECK_OK(rm.Cleanup("foo"));
+  EXPECT_EQ(gen2, rm.generation());
+
+  TF_CHECK_OK(rm.Create("foo", "bar", new Resource("kitty")));
+  rm.Clear();
+  EXPECT_LT(gen2, rm.generation());
+}
+
 TEST(ResourceMgrTest, CreateOrLookup) {
   ResourceMgr rm;
   EXPECT_EQ("R/cat", LookupOrCreate<Resource>(&rm, "foo", "bar", "cat"));
@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RESOURCE_VAR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RESOURCE_VAR_H_
 
+#include <atomic>
+#include <memory>
+
 #include "tensorflow/core/framework/resource_mgr.h"
 
 namespace tensorflow {
@@ -51,6 +54,17 @@ namespace tensorflow {
 // shared mutex prevents them from overlapping with dense writes, which is
 // necessary as dense writes can change the shape the of the tensor.
 //
+// A copy-on-write variable can additionally be frozen (via FreezeVariableOp).
+// Freezing publishes an immutable snapshot of the variable's tensor; as long
+// as the snapshot is live, dense reads alias it without touching the
+// variable's mutex, making a read of a frozen variable as cheap as a constant
+// access. The snapshot itself aliases the variable's buffer, so the first
+// write after a freeze observes a reference count bigger than one and falls
+// back to the usual copy-on-write path; every writer drops the snapshot
+// (under the exclusive lock it already holds) before mutating the variable.
+// Variables in copy-on-read mode cannot be frozen, since no tensor is allowed
+// to alias their buffer.
+//
 // Transitioning a variable from copy-on-read mode to copy-on-write mode is
 // currently not supported. To upgrade a variable from copy-on-write to
 // copy-on-read use `EnsureSparseVariableAccess()`, and then grab the variable's
@@ -67,6 +81,45 @@ class Var : public ResourceBase {
   mutex* mu() { return &mu_; }
   Tensor* tensor() { return &tensor_; }
 
+  // Publishes an immutable snapshot of the variable's current value, enabling
+  // the lock-free read path. Fails if the variable is uninitialized or in
+  // copy-on-read mode.
+  // REQUIRES: mu() held exclusively.
+  Status Freeze() {
+    if (!is_initialized) {
+      return errors::FailedPrecondition(
+          "Cannot freeze uninitialized variable.");
+    }
+    if (copy_on_read_mode.load()) {
+      return errors::FailedPrecondition(
+          "Cannot freeze a variable in copy-on-read mode; no tensor may "
+          "alias its buffer.");
+    }
+    std::atomic_store_explicit(
+        &snapshot_, std::shared_ptr<const Tensor>(new Tensor(tensor_)),
+        std::memory_order_release);
+    return Status::OK();
+  }
+
+  // Drops the frozen snapshot, if any. Readers that already obtained the
+  // snapshot keep a reference to the old buffer, so the next write copies the
+  // variable instead of mutating it in place (ordinary copy-on-write).
+  // REQUIRES: mu() held exclusively.
+  void Unfreeze() {
+    if (std::atomic_load_explicit(&snapshot_, std::memory_order_relaxed) !=
+        nullptr) {
+      std::atomic_store_explicit(&snapshot_, std::shared_ptr<const Tensor>(),
+                                 std::memory_order_release);
+    }
+  }
+
+  // Returns the frozen snapshot, or nullptr if the variable is not frozen.
+  // Called without holding mu(); the returned tensor is immutable and is kept
+  // alive by the returned pointer.
+  std::shared_ptr<const Tensor> SnapshotIfFrozen() const {
+    return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+  }
+
   string DebugString() const override {
     return strings::StrCat(DataTypeString(tensor_.dtype()), "/",
                            tensor_.shape().DebugString());
@@ -90,6 +143,10 @@ class Var : public ResourceBase {
  private:
   mutex mu_;
   Tensor tensor_;
+  // The frozen snapshot, accessed with the std::atomic_* shared_ptr
+  // overloads: readers load it without holding mu_, writers publish or clear
+  // it while holding mu_ exclusively.
+  std::shared_ptr<const Tensor> snapshot_;
 
   ~Var() override {}
   TF_DISALLOW_COPY_AND_ASSIGN(Var);
@@ -355,6 +355,8 @@ Graph::Graph(const OpRegistryInterface* ops)
 
   // Initialize the name interning table for assigned_device_name.
   device_names_.push_back("");
+  parsed_device_names_.emplace_back();
+  parsed_device_name_is_valid_.push_back(true);
   DCHECK_EQ(0, InternDeviceName(""));
 
   // Source and sink have no endpoints, just control edges.
@@ -422,6 +424,14 @@ Node* Graph::AddNode(const NodeDef& node_def, Status* status) {
   return node;
 }
 
+Node* Graph::AddNode(const NodeDef& node_def, const OpDef* op_def,
+                     const DataTypeVector& inputs,
+                     const DataTypeVector& outputs) {
+  return AllocateNode(
+      std::make_shared<NodeProperties>(op_def, node_def, inputs, outputs),
+      nullptr);
+}
+
 Node* Graph::CopyNode(const Node* node) {
   DCHECK(!node->IsSource());
   DCHECK(!node->IsSink());
@@ -793,6 +803,14 @@ int Graph::InternDeviceName(const string& device_name) {
   const int index = device_names_map_.size();
   index_cell = index;
   device_names_.push_back(device_name);
+
+  // Cache the parsed form alongside the interned name so consumers of
+  // get_parsed_device_name() never re-parse it.
+  DeviceNameUtils::ParsedName parsed;
+  const bool valid = DeviceNameUtils::ParseFullName(device_name, &parsed);
+  if (!valid) parsed.Clear();
+  parsed_device_names_.push_back(parsed);
+  parsed_device_name_is_valid_.push_back(valid);
   return index;
 }
 
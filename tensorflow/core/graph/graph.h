@@ -51,6 +51,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/device_name_utils.h"
 
 namespace tensorflow {
 
@@ -113,6 +114,12 @@ class Node {
   // TODO(josh11b): Move assigned_device_name outside of Node into a
   // NodeId->DeviceName map.
   const string& assigned_device_name() const;
+  // Returns the cached parsed form of assigned_device_name(), or nullptr if
+  // the assigned device name is not a valid device specification. The owning
+  // graph parses each distinct device name once, when it is interned, so
+  // algorithms that consult parsed assigned devices per node avoid re-parsing
+  // the same few strings.
+  const DeviceNameUtils::ParsedName* assigned_device_parsed_name() const;
   void set_assigned_device_name(const string& device_name);
   bool has_assigned_device_name() const {
     return assigned_device_name_index_ > 0;
@@ -478,6 +485,15 @@ class Graph {
   // Returns nullptr and sets *status on error.
   Node* AddNode(const NodeDef& node_def, Status* status);
 
+  // Like AddNode(node_def, status), but uses the given op definition and
+  // pre-resolved input/output types instead of computing them here. `op_def`
+  // must outlive this graph (e.g. be owned by op_registry()) and `inputs` and
+  // `outputs` must be the result of calling InOutTypesForNode() on `node_def`
+  // and `*op_def`. This lets callers resolve types for many nodes in parallel
+  // before serially adding them to the graph.
+  Node* AddNode(const NodeDef& node_def, const OpDef* op_def,
+                const DataTypeVector& inputs, const DataTypeVector& outputs);
+
   // Copies *node, which may belong to another graph, to a new node,
   // which is returned.  Does not copy any edges.  *this owns the
   // returned instance.
@@ -618,6 +634,20 @@ class Graph {
     return device_names_[node.assigned_device_name_index()];
   }
 
+  // Returns the cached parsed form of the index-th interned device name, or
+  // nullptr if that name is not a valid device specification. Names are
+  // parsed once, when they are interned. The returned pointer is invalidated
+  // when a new device name is interned.
+  const DeviceNameUtils::ParsedName* get_parsed_device_name(int index) const {
+    return parsed_device_name_is_valid_[index] ? &parsed_device_names_[index]
+                                               : nullptr;
+  }
+
+  const DeviceNameUtils::ParsedName* get_assigned_device_parsed_name(
+      const Node& node) const {
+    return get_parsed_device_name(node.assigned_device_name_index());
+  }
+
   void set_assigned_device_name_index(Node* node, int device_name_index) {
     CheckDeviceNameIndex(device_name_index);
     node->assigned_device_name_index_ = device_name_index;
@@ -715,6 +745,13 @@ class Graph {
   // to node IDs.  Index 0 is always the empty string.
   std::vector<string> device_names_;
 
+  // Cached parses of device_names_, parallel to it.  parsed_device_names_[i]
+  // holds the result of running DeviceNameUtils::ParseFullName() on
+  // device_names_[i] once, at interning time, and
+  // parsed_device_name_is_valid_[i] records whether that parse succeeded.
+  std::vector<DeviceNameUtils::ParsedName> parsed_device_names_;
+  std::vector<bool> parsed_device_name_is_valid_;
+
   // Maps unique device names to indices within device_names_[i].
   std::unordered_map<string, int> device_names_map_;
 
@@ -891,6 +928,11 @@ inline const string& Node::assigned_device_name() const {
   return graph_->get_assigned_device_name(*this);
 }
 
+inline const DeviceNameUtils::ParsedName* Node::assigned_device_parsed_name()
+    const {
+  return graph_->get_parsed_device_name(assigned_device_name_index_);
+}
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_GRAPH_GRAPH_H_
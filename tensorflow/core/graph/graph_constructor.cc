@@ -37,11 +37,14 @@ limitations under the License.
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/tensor_id.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/public/version.h"
 
@@ -53,6 +56,11 @@ namespace {
 // can skip expensive duplicates check in 'AddControlEdge'.
 static constexpr const bool kDoNotCheckDuplicates = true;
 
+// Below this many NodeDefs the cost of spinning up a thread pool outweighs
+// the savings from resolving node types in parallel, so smaller graphs are
+// converted single-threaded.
+static constexpr int kMinNodesForParallelConversion = 4096;
+
 inline bool IsMerge(const NodeDef& node_def) {
   return node_def.op() == "Merge" || node_def.op() == "RefMerge";
 }
@@ -204,7 +212,14 @@ class GraphConstructor {
            absl::flat_hash_set<int>* unvisited);
   Status IsNodeFullyMapped(const NodeDef& node_def, bool* is_node_mapped);
   Status ValidateColocationConstraints(const NodeDef& node_def);
-  Status MakeNode(const NodeDef& node_def, Node** node);
+  Status MakeNode(const NodeDef& node_def, int gdef_index, Node** node);
+  // Resolves the op definition and input/output types of every NodeDef in
+  // node_defs_ across a thread pool so MakeNode() can skip that work. Only
+  // used for large non-importing conversions, where the NodeDefs are added to
+  // the graph unmodified. Nodes whose types cannot be resolved are left for
+  // MakeNode() to re-resolve serially, so errors are reported on the same
+  // node and with the same message as the single-threaded path.
+  void MaybePrecomputeNodeTypes();
   Status MakeEdge(Node* src, int output_index, Node* dst, int input_index);
   Status ValidateShape(Node* node);
   Status ModifyNodeDefForImport(NodeDef* node_def);
@@ -302,6 +317,17 @@ class GraphConstructor {
   // (sorted) set so nodes are created in the order defined in the GraphDef.
   std::set<int> ready_;
 
+  // Pre-resolved op definition and input/output types for each NodeDef,
+  // parallel to node_defs_ and filled in by MaybePrecomputeNodeTypes(). Empty
+  // if precomputation was skipped; an entry with a null op_def means the node
+  // must be resolved serially by MakeNode().
+  struct NodeTypeInfo {
+    const OpDef* op_def = nullptr;
+    DataTypeVector input_types;
+    DataTypeVector output_types;
+  };
+  std::vector<NodeTypeInfo> node_type_info_;
+
   // Mapping between index within node_defs_ and the number of inputs that
   // still need to be converted.
   std::vector<int> pending_count_;
@@ -595,11 +621,61 @@ Status GraphConstructor::ValidateColocationConstraints(
   return Status::OK();
 }
 
-Status GraphConstructor::MakeNode(const NodeDef& node_def, Node** node) {
+void GraphConstructor::MaybePrecomputeNodeTypes() {
+  // Importing rewrites each NodeDef (input remapping, prefixes, defaults)
+  // before it's added to the graph, so precomputed types could go stale; only
+  // the plain conversion path adds node_defs_ unmodified.
+  if (opts_.importing) return;
+  const int num_nodes = node_defs_.size();
+  if (num_nodes < kMinNodesForParallelConversion) return;
+
+  // Resolve each distinct op type once up front: the registry lookup takes a
+  // lock, and hoisting it also keeps the parallel loop below lock-free.
+  std::unordered_map<string, const OpDef*> op_defs;
+  for (int i = 0; i < num_nodes; ++i) {
+    op_defs.emplace(node_defs_[i]->op(), nullptr);
+  }
+  for (auto& entry : op_defs) {
+    // Leave nullptr on failure; MakeNode() will re-run the lookup and report
+    // the error when the node is reached in topological order.
+    g_->op_registry()->LookUpOpDef(entry.first, &entry.second).IgnoreError();
+  }
+
+  node_type_info_.resize(num_nodes);
+  thread::ThreadPool pool(Env::Default(), "graph_constructor",
+                          port::NumSchedulableCPUs());
+  // Rough per-node cost of InOutTypesForNode in cycles, used by the sharder.
+  const int64 kCostPerUnit = 5000;
+  pool.ParallelFor(num_nodes, kCostPerUnit, [this, &op_defs](int64 start,
+                                                             int64 end) {
+    for (int64 i = start; i < end; ++i) {
+      NodeTypeInfo* info = &node_type_info_[i];
+      const NodeDef& node_def = *node_defs_[i];
+      auto iter = op_defs.find(node_def.op());
+      if (iter == op_defs.end() || iter->second == nullptr) continue;
+      if (!InOutTypesForNode(node_def, *iter->second, &info->input_types,
+                             &info->output_types)
+               .ok()) {
+        continue;
+      }
+      info->op_def = iter->second;
+    }
+  });
+}
+
+Status GraphConstructor::MakeNode(const NodeDef& node_def, int gdef_index,
+                                  Node** node) {
   // Add the node to the graph.
-  Status status;
-  *node = g_->AddNode(node_def, &status);
-  if (!status.ok()) return status;
+  const NodeTypeInfo* info =
+      node_type_info_.empty() ? nullptr : &node_type_info_[gdef_index];
+  if (info != nullptr && info->op_def != nullptr) {
+    *node = g_->AddNode(node_def, info->op_def, info->input_types,
+                        info->output_types);
+  } else {
+    Status status;
+    *node = g_->AddNode(node_def, &status);
+    if (!status.ok()) return status;
+  }
   if (opts_.expect_device_spec) {
     (*node)->set_assigned_device_name(node_def.device());
   }
@@ -983,6 +1059,11 @@ Status GraphConstructor::Convert() {
     TF_RETURN_IF_ERROR(g_->AddFunctionLibrary(*library_));
   }
 
+  // For large graphs, resolve node types in parallel before the serial
+  // conversion loop below. This must happen after the function library import
+  // so function ops resolve.
+  MaybePrecomputeNodeTypes();
+
   std::vector<InputInfo> inputs;
   int processed = 0;
 
@@ -1094,7 +1175,7 @@ Status GraphConstructor::Convert() {
       }
       TF_RETURN_IF_ERROR(ModifyNodeDefForImport(&imported_node_def));
     }
-    TF_RETURN_IF_ERROR(MakeNode(*node_def, &node));
+    TF_RETURN_IF_ERROR(MakeNode(*node_def, o, &node));
     // Use original_node_def so name StringPiece remains valid
     gdef_nodes_[original_node_def.name()].node = node;
 
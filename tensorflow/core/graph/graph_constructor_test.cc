@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/shape_inference.h"
 #include "tensorflow/core/framework/versions.pb.h"
+#include "tensorflow/core/graph/benchmark_testlib.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/kernels/ops_util.h"
@@ -32,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/version.h"
 
@@ -3254,5 +3256,37 @@ TEST_F(GraphConstructorTest, ImportGraphDef_UnknownOps) {
        "when the module is first accessed."});
 }
 
+// Covers both sides of the node-count threshold above which
+// ConvertGraphDefToGraph resolves node types in parallel, so scaling of large
+// graph imports is tracked.
+static void BM_ConvertGraphDefToGraph(int iters, int num_nodes,
+                                      int num_edges_per_node) {
+  testing::StopTiming();
+  const GraphDef graph_def =
+      test::CreateGraphDef(num_nodes, num_edges_per_node);
+  const auto registry = OpRegistry::Global();
+  GraphConstructorOptions opts;
+  // Warmup step.
+  Graph warmup_graph(registry);
+  TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &warmup_graph));
+  int64 sum = 0;
+  testing::StartTiming();
+  for (int i = 0; i < iters; ++i) {
+    Graph graph(registry);
+    TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &graph));
+    sum += graph.num_node_ids();
+  }
+  VLOG(1) << sum;
+  testing::StopTiming();
+}
+BENCHMARK(BM_ConvertGraphDefToGraph)->ArgPair(1 << 9, 2);
+BENCHMARK(BM_ConvertGraphDefToGraph)->ArgPair(1 << 12, 2);
+BENCHMARK(BM_ConvertGraphDefToGraph)->ArgPair(1 << 15, 2);
+BENCHMARK(BM_ConvertGraphDefToGraph)->ArgPair(1 << 17, 2);
+BENCHMARK(BM_ConvertGraphDefToGraph)->ArgPair(1 << 9, 8);
+BENCHMARK(BM_ConvertGraphDefToGraph)->ArgPair(1 << 12, 8);
+BENCHMARK(BM_ConvertGraphDefToGraph)->ArgPair(1 << 15, 8);
+BENCHMARK(BM_ConvertGraphDefToGraph)->ArgPair(1 << 17, 8);
+
 }  // namespace
 }  // namespace tensorflow
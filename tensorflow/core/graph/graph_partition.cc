@@ -576,19 +576,19 @@ Status BuildMemoryDeviceInfo(const Graph& g, GraphInfo* info) {
 
   info->device_types.resize(g.num_node_ids(), DEVICE_CPU);
   for (const Node* node : g.op_nodes()) {
-    DeviceNameUtils::ParsedName parsed;
-    if (!DeviceNameUtils::ParseFullName(node->assigned_device_name(),
-                                        &parsed)) {
+    const DeviceNameUtils::ParsedName* parsed =
+        node->assigned_device_parsed_name();
+    if (parsed == nullptr) {
       return errors::Internal("Malformed assigned device '",
                               node->assigned_device_name(), "'");
     }
 
     TF_RETURN_IF_ERROR(MemoryTypesForNode(
-        g.op_registry(), DeviceType(parsed.type), node->def(),
+        g.op_registry(), DeviceType(parsed->type), node->def(),
         &input_memory_types, &output_memory_types));
 
     int node_id = node->id();
-    info->device_types[node_id] = DeviceType(parsed.type);
+    info->device_types[node_id] = DeviceType(parsed->type);
     for (int i = 0; i < input_memory_types.size(); ++i) {
       info->input_types[{node_id, i}] = input_memory_types[i];
     }
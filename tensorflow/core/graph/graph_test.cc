@@ -660,6 +660,31 @@ TEST_F(GraphTest, BuildNodeNameIndex) {
   }
 }
 
+TEST_F(GraphTest, AssignedDeviceParsedName) {
+  Node* a = FromNodeDef("A", "OneOutput", 0);
+
+  // Unassigned nodes share interned index 0, the (valid) empty name.
+  const DeviceNameUtils::ParsedName* parsed = a->assigned_device_parsed_name();
+  ASSERT_NE(parsed, nullptr);
+  EXPECT_FALSE(DeviceNameUtils::HasSomeDetails(*parsed));
+
+  a->set_assigned_device_name("/job:a/replica:0/task:0/device:CPU:0");
+  parsed = a->assigned_device_parsed_name();
+  ASSERT_NE(parsed, nullptr);
+  EXPECT_EQ(parsed->job, "a");
+  EXPECT_EQ(parsed->type, "CPU");
+  EXPECT_EQ(parsed->id, 0);
+
+  // Interning the same name again yields the same cached parse.
+  Node* b = FromNodeDef("B", "OneOutput", 0);
+  b->set_assigned_device_name("/job:a/replica:0/task:0/device:CPU:0");
+  EXPECT_EQ(b->assigned_device_parsed_name(), parsed);
+
+  // Malformed names are interned but have no parsed form.
+  b->set_assigned_device_name("not a device name");
+  EXPECT_EQ(b->assigned_device_parsed_name(), nullptr);
+}
+
 static void BM_InEdgeIteration(int iters, int num_nodes,
                                int num_edges_per_node) {
   testing::StopTiming();
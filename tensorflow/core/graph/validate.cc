@@ -29,10 +29,12 @@ namespace tensorflow {
 namespace graph {
 
 Status ValidateGraphDef(const GraphDef& graph_def,
-                        const OpRegistryInterface& op_registry) {
+                        const OpRegistryInterface& op_registry,
+                        int start_node_index) {
   Status s;
   const int version = graph_def.versions().producer();
-  for (const NodeDef& node_def : graph_def.node()) {
+  for (int i = start_node_index; i < graph_def.node_size(); ++i) {
+    const NodeDef& node_def = graph_def.node(i);
     // Look up the OpDef for the node_def's op name.
     const OpDef* op_def;
     TF_RETURN_IF_ERROR(op_registry.LookUpOpDef(node_def.op(), &op_def));
@@ -24,15 +24,20 @@ limitations under the License.
 namespace tensorflow {
 namespace graph {
 
-// Returns OK if every NodeDef in `graph_def` is valid with respect to
-// its corresponding OpDef (as defined by ValidateNodeDef()) as
-// registered in `op_registry`.  Also checks for deprecated ops.
+// Returns OK if every NodeDef in `graph_def` starting at index
+// `start_node_index` is valid with respect to its corresponding OpDef (as
+// defined by ValidateNodeDef()) as registered in `op_registry`.  Also checks
+// for deprecated ops.  Callers that append nodes to an already-validated
+// graph (e.g. GraphExecutionState::Extend()) can pass the index of the first
+// new node to validate only the delta.
 //
 // REQUIRES:
 //  * `op_registry` is not nullptr.
 //  * `graph_def` has default attrs filled in (see AddDefaultAttrsToGraphDef()).
+//  * Nodes before `start_node_index` have already been validated.
 Status ValidateGraphDef(const GraphDef& graph_def,
-                        const OpRegistryInterface& op_registry);
+                        const OpRegistryInterface& op_registry,
+                        int start_node_index = 0);
 
 // Like ValidateGraphDef() except it makes a copy of `graph_def` and calls
 // AddDefaultAttrsToGraphDef() on the copy, removing that requirement from the
@@ -47,6 +47,22 @@ TEST(ValidateGraphDefTest, TestValidGraph) {
   TF_ASSERT_OK(graph::ValidateGraphDef(graph_def, *OpRegistry::Global()));
 }
 
+TEST(ValidateGraphDefTest, TestValidGraphFromStartNodeIndex) {
+  // Node 'A' is invalid (it is missing a required attr), but validation
+  // starting at node 'B' should skip it and succeed.
+  const string graph_def_str =
+      "node { name: 'A' op: 'Cast' input: ['B'] }"
+      "node { name: 'B' op: 'FloatInput' }"
+      "node { name: 'C' op: 'FloatInput' }";
+  GraphDef graph_def;
+  auto parser = protobuf::TextFormat::Parser();
+  CHECK(parser.MergeFromString(graph_def_str, &graph_def)) << graph_def_str;
+  Status s = graph::ValidateGraphDef(graph_def, *OpRegistry::Global());
+  EXPECT_FALSE(s.ok());
+  TF_ASSERT_OK(graph::ValidateGraphDef(graph_def, *OpRegistry::Global(),
+                                       /*start_node_index=*/1));
+}
+
 TEST(ValidateGraphDefTest, GraphWithUnspecifiedDefaultAttr) {
   const string graph_def_str =
       "node { name: 'A' op: 'FloatInput' }"
@@ -0,0 +1,178 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/critical_path_analyzer.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/stringprintf.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+struct NodeTiming {
+  const NodeDef* node = nullptr;  // may be null if not found in the graph
+  string device;
+  int64 start = 0;
+  int64 end = 0;
+  int64 op_start = 0;
+  int64 op_end = 0;
+};
+
+bool IsTransferOp(const string& op) {
+  return op == "_Send" || op == "_Recv" || op == "_HostSend" ||
+         op == "_HostRecv";
+}
+
+}  // namespace
+
+Status AnalyzeCriticalPath(const GraphDef& graph, const StepStats& step_stats,
+                           CriticalPathReport* report) {
+  std::unordered_map<string, const NodeDef*> nodes;
+  for (const NodeDef& node : graph.node()) {
+    nodes[node.name()] = &node;
+  }
+
+  std::unordered_map<string, NodeTiming> timings;
+  int64 step_start = kint64max;
+  for (const DeviceStepStats& dev_stats : step_stats.dev_stats()) {
+    // Hardware tracers report duplicate entries on pseudo-devices like
+    // "/device:GPU:0/stream:all"; dependency analysis only needs the
+    // executor's own stats.
+    if (dev_stats.device().find("/stream") != string::npos) continue;
+    for (const NodeExecStats& node_stats : dev_stats.node_stats()) {
+      NodeTiming timing;
+      timing.device = dev_stats.device();
+      timing.start = node_stats.all_start_micros();
+      timing.end = timing.start + node_stats.all_end_rel_micros();
+      timing.op_start = timing.start + node_stats.op_start_rel_micros();
+      timing.op_end = timing.start + node_stats.op_end_rel_micros();
+      auto it = nodes.find(node_stats.node_name());
+      if (it != nodes.end()) timing.node = it->second;
+      timings[node_stats.node_name()] = timing;
+      step_start = std::min(step_start, timing.start);
+    }
+  }
+  if (timings.empty()) {
+    return errors::InvalidArgument("step_stats contains no node stats");
+  }
+
+  // The critical path ends at the last node to finish.
+  const string* current = nullptr;
+  int64 latest_end = -1;
+  for (const auto& entry : timings) {
+    if (entry.second.end > latest_end) {
+      latest_end = entry.second.end;
+      current = &entry.first;
+    }
+  }
+
+  // Walk backwards, always following the dependency that finished latest;
+  // that dependency is what this node was actually waiting for.
+  std::unordered_set<string> visited;
+  while (current != nullptr) {
+    const NodeTiming& timing = timings[*current];
+    if (!visited.insert(*current).second) {
+      return errors::InvalidArgument("Cycle in step_stats dependencies at ",
+                                     *current);
+    }
+
+    CriticalPathEntry entry;
+    entry.node_name = *current;
+    entry.op = timing.node != nullptr ? timing.node->op() : "";
+    entry.device = timing.device;
+    entry.start_micros = timing.start;
+    entry.end_micros = timing.end;
+    const int64 duration = timing.end - timing.start;
+    const int64 compute = std::max<int64>(0, timing.op_end - timing.op_start);
+    if (IsTransferOp(entry.op)) {
+      // For rendezvous nodes, the whole duration (including the blocked wait
+      // for the peer) is time the step spent moving data.
+      entry.transfer_micros = duration;
+    } else {
+      entry.compute_micros = compute;
+      // Executor overhead around the kernel (input prep, output processing).
+      entry.gap_micros = std::max<int64>(0, duration - compute);
+    }
+
+    // Find the latest-finishing dependency with stats.
+    const string* pred = nullptr;
+    int64 pred_end = -1;
+    if (timing.node != nullptr) {
+      for (const string& input : timing.node->input()) {
+        auto it = timings.find(NodeName(input));
+        if (it == timings.end()) continue;
+        if (it->second.end > pred_end) {
+          pred_end = it->second.end;
+          pred = &it->first;
+        }
+      }
+    }
+    if (pred != nullptr) {
+      entry.gap_micros += std::max<int64>(0, timing.start - pred_end);
+    } else {
+      // Head of the path: any delay from step start is scheduling time.
+      entry.gap_micros += std::max<int64>(0, timing.start - step_start);
+    }
+    report->path.push_back(entry);
+    current = pred;
+  }
+  std::reverse(report->path.begin(), report->path.end());
+
+  report->step_micros = latest_end - step_start;
+  for (const CriticalPathEntry& entry : report->path) {
+    report->compute_micros += entry.compute_micros;
+    report->transfer_micros += entry.transfer_micros;
+    report->gap_micros += entry.gap_micros;
+  }
+  return Status::OK();
+}
+
+string CriticalPathReportToString(const CriticalPathReport& report) {
+  string result;
+  const double step = std::max<int64>(1, report.step_micros);
+  strings::Appendf(&result,
+                   "Critical path: %lld us = %lld us compute (%.1f%%) + "
+                   "%lld us transfer (%.1f%%) + %lld us gap (%.1f%%), "
+                   "%zu nodes\n",
+                   static_cast<long long>(report.step_micros),
+                   static_cast<long long>(report.compute_micros),
+                   100.0 * report.compute_micros / step,
+                   static_cast<long long>(report.transfer_micros),
+                   100.0 * report.transfer_micros / step,
+                   static_cast<long long>(report.gap_micros),
+                   100.0 * report.gap_micros / step, report.path.size());
+  strings::Appendf(&result, "%10s %8s %8s %8s %8s  %s\n", "start", "dur",
+                   "compute", "xfer", "gap", "node");
+  for (const CriticalPathEntry& entry : report.path) {
+    strings::Appendf(
+        &result, "%10lld %8lld %8lld %8lld %8lld  %s (%s) @ %s\n",
+        static_cast<long long>(entry.start_micros),
+        static_cast<long long>(entry.end_micros - entry.start_micros),
+        static_cast<long long>(entry.compute_micros),
+        static_cast<long long>(entry.transfer_micros),
+        static_cast<long long>(entry.gap_micros), entry.node_name.c_str(),
+        entry.op.c_str(), entry.device.c_str());
+  }
+  return result;
+}
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,74 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_CRITICAL_PATH_ANALYZER_H_
+#define TENSORFLOW_CORE_GRAPPLER_COSTS_CRITICAL_PATH_ANALYZER_H_
+
+#include <vector>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// One node on the critical path, with its time attributed to compute,
+// transfer (_Send/_Recv/memcpy nodes), and gap (time between the latest
+// finishing dependency and this node producing useful work: rendezvous waits,
+// scheduling delay, and executor overhead).
+struct CriticalPathEntry {
+  string node_name;
+  string op;
+  string device;
+  int64 start_micros = 0;
+  int64 end_micros = 0;
+  int64 compute_micros = 0;
+  int64 transfer_micros = 0;
+  int64 gap_micros = 0;
+};
+
+// A per-step critical path: the chain of dependencies that determined the
+// step's wall time, with every microsecond of it attributed to one of the
+// three buckets above.
+struct CriticalPathReport {
+  int64 step_micros = 0;
+  int64 compute_micros = 0;
+  int64 transfer_micros = 0;
+  int64 gap_micros = 0;
+  // In execution order (earliest node first).
+  std::vector<CriticalPathEntry> path;
+};
+
+// Computes the critical path through a completed step from the timings in
+// `step_stats` (e.g. RunMetadata.step_stats()) and the dependency structure
+// of `graph` (the graph that was executed, or the merged partition graphs).
+// Starting from the last node to finish, the analyzer repeatedly steps to the
+// dependency that finished latest, so waits on rendezvous and cross-device
+// copies appear on the path as the _Send/_Recv/memcpy nodes that caused them.
+//
+// Hardware tracer duplicates (devices with a "/stream:" component) are
+// ignored; only the executor's own per-node stats are used.
+Status AnalyzeCriticalPath(const GraphDef& graph, const StepStats& step_stats,
+                           CriticalPathReport* report);
+
+// Formats a report as a compact, human-readable per-step summary.
+string CriticalPathReportToString(const CriticalPathReport& report);
+
+}  // namespace grappler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_COSTS_CRITICAL_PATH_ANALYZER_H_
@@ -0,0 +1,143 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/critical_path_analyzer.h"
+
+#include <vector>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/step_stats.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+NodeDef* AddNode(GraphDef* graph, const string& name, const string& op,
+                 const std::vector<string>& inputs) {
+  NodeDef* node = graph->add_node();
+  node->set_name(name);
+  node->set_op(op);
+  for (const string& input : inputs) {
+    node->add_input(input);
+  }
+  return node;
+}
+
+NodeExecStats* AddNodeStats(DeviceStepStats* dev_stats, const string& name,
+                            int64 start, int64 duration, int64 op_start_rel,
+                            int64 op_end_rel) {
+  NodeExecStats* stats = dev_stats->add_node_stats();
+  stats->set_node_name(name);
+  stats->set_all_start_micros(start);
+  stats->set_all_end_rel_micros(duration);
+  stats->set_op_start_rel_micros(op_start_rel);
+  stats->set_op_end_rel_micros(op_end_rel);
+  return stats;
+}
+
+TEST(CriticalPathAnalyzerTest, LinearChainAttribution) {
+  GraphDef graph;
+  AddNode(&graph, "a", "Const", {});
+  AddNode(&graph, "b", "_Recv", {"a"});
+  AddNode(&graph, "c", "MatMul", {"b:0", "^a"});
+  // Off-path node that finishes early; must not appear in the report.
+  AddNode(&graph, "d", "Const", {});
+
+  StepStats step_stats;
+  DeviceStepStats* dev_stats = step_stats.add_dev_stats();
+  dev_stats->set_device("/job:localhost/replica:0/task:0/device:CPU:0");
+  // a: [0, 10], all compute.
+  AddNodeStats(dev_stats, "a", 0, 10, 0, 10);
+  // b: transfer node [10, 40].
+  AddNodeStats(dev_stats, "b", 10, 30, 0, 30);
+  // c: scheduled 5us after b finished, 20us kernel inside a 25us window.
+  AddNodeStats(dev_stats, "c", 45, 25, 0, 20);
+  AddNodeStats(dev_stats, "d", 0, 5, 0, 5);
+  // Tracer duplicates on a stream pseudo-device must be ignored.
+  DeviceStepStats* stream_stats = step_stats.add_dev_stats();
+  stream_stats->set_device("/device:GPU:0/stream:all");
+  AddNodeStats(stream_stats, "c", 1000, 1, 0, 1);
+
+  CriticalPathReport report;
+  TF_ASSERT_OK(AnalyzeCriticalPath(graph, step_stats, &report));
+
+  ASSERT_EQ(3, report.path.size());
+  EXPECT_EQ("a", report.path[0].node_name);
+  EXPECT_EQ("b", report.path[1].node_name);
+  EXPECT_EQ("c", report.path[2].node_name);
+
+  EXPECT_EQ(70, report.step_micros);
+  EXPECT_EQ(10 + 20, report.compute_micros);
+  EXPECT_EQ(30, report.transfer_micros);
+  // 5us wait before c plus c's 5us of executor overhead around the kernel.
+  EXPECT_EQ(10, report.gap_micros);
+  EXPECT_EQ(30, report.path[1].transfer_micros);
+  EXPECT_EQ(10, report.path[2].gap_micros);
+}
+
+TEST(CriticalPathAnalyzerTest, PicksLatestFinishingDependency) {
+  GraphDef graph;
+  AddNode(&graph, "fast", "Const", {});
+  AddNode(&graph, "slow", "Const", {});
+  AddNode(&graph, "sum", "Add", {"fast", "slow"});
+
+  StepStats step_stats;
+  DeviceStepStats* dev_stats = step_stats.add_dev_stats();
+  dev_stats->set_device("/job:localhost/replica:0/task:0/device:CPU:0");
+  AddNodeStats(dev_stats, "fast", 0, 5, 0, 5);
+  AddNodeStats(dev_stats, "slow", 0, 50, 0, 50);
+  AddNodeStats(dev_stats, "sum", 50, 10, 0, 10);
+
+  CriticalPathReport report;
+  TF_ASSERT_OK(AnalyzeCriticalPath(graph, step_stats, &report));
+
+  ASSERT_EQ(2, report.path.size());
+  EXPECT_EQ("slow", report.path[0].node_name);
+  EXPECT_EQ("sum", report.path[1].node_name);
+  EXPECT_EQ(60, report.step_micros);
+  EXPECT_EQ(0, report.gap_micros);
+}
+
+TEST(CriticalPathAnalyzerTest, EmptyStepStatsIsAnError) {
+  GraphDef graph;
+  StepStats step_stats;
+  CriticalPathReport report;
+  EXPECT_FALSE(AnalyzeCriticalPath(graph, step_stats, &report).ok());
+}
+
+TEST(CriticalPathAnalyzerTest, ReportToStringMentionsEveryPathNode) {
+  GraphDef graph;
+  AddNode(&graph, "a", "Const", {});
+  AddNode(&graph, "b", "Relu", {"a"});
+
+  StepStats step_stats;
+  DeviceStepStats* dev_stats = step_stats.add_dev_stats();
+  dev_stats->set_device("/job:localhost/replica:0/task:0/device:CPU:0");
+  AddNodeStats(dev_stats, "a", 0, 10, 0, 10);
+  AddNodeStats(dev_stats, "b", 10, 10, 0, 10);
+
+  CriticalPathReport report;
+  TF_ASSERT_OK(AnalyzeCriticalPath(graph, step_stats, &report));
+  const string summary = CriticalPathReportToString(report);
+  EXPECT_NE(summary.find("a (Const)"), string::npos);
+  EXPECT_NE(summary.find("b (Relu)"), string::npos);
+  EXPECT_NE(summary.find("20 us"), string::npos);
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/costs/graph_properties.h"
 
+#include <atomic>
+
 #include "absl/types/optional.h"
 #include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/framework/function.pb.h"
@@ -35,7 +37,9 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/topological_sort.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -48,6 +52,12 @@ using shape_inference::ShapeAndType;
 using shape_inference::ShapeHandle;
 using TensorVector = gtl::InlinedVector<TensorValue, 4>;
 
+// Process-wide time spent in static shape inference, in microseconds.
+std::atomic<int64>* CumulativeInferenceTimeUsCounter() {
+  static std::atomic<int64>* counter = new std::atomic<int64>(0);
+  return counter;
+}
+
 template <typename Handle>
 struct HashHandle {
   std::size_t operator()(const Handle& h) const { return h.Handle(); }
@@ -1126,6 +1136,53 @@ class SymbolicShapeRefiner {
     return s;
   }
 
+  // Seed the context of 'node' with previously inferred output properties, so
+  // that shape inference can restart from the boundary of a partially
+  // invalidated graph without reprocessing the fanin of 'node'. Symbolic
+  // dimensions are demoted to unknown since their ids are not comparable
+  // across inferences.
+  Status SeedNodeFromProperties(
+      const NodeDef* node,
+      const std::vector<OpInfo::TensorProperties>& output_properties) {
+    NodeContext* ctx = GetNodeContext(node);
+    if (ctx == nullptr) {
+      TF_RETURN_IF_ERROR(AddNode(node));
+      ctx = CHECK_NOTNULL(GetNodeContext(node));
+    }
+    InferenceContext* ic = ctx->inference_context.get();
+    if (ic->num_outputs() != static_cast<int>(output_properties.size())) {
+      return errors::InvalidArgument(
+          "Mismatched number of outputs for node ", node->name(), ": ",
+          ic->num_outputs(), " vs ", output_properties.size());
+    }
+    ctx->output_tensors_as_shapes.resize(ic->num_outputs());
+    ctx->output_tensor_protos.resize(ic->num_outputs(), nullptr);
+    for (int i = 0; i < ic->num_outputs(); ++i) {
+      const auto& outprop = output_properties[i];
+      TensorShapeProto shape = outprop.shape();
+      for (auto& dim : *shape.mutable_dim()) {
+        if (dim.size() < -1) {
+          dim.set_size(-1);
+        }
+      }
+      ShapeHandle out;
+      TF_RETURN_IF_ERROR(ic->MakeShapeFromShapeProto(shape, &out));
+      ic->set_output(i, out);
+      if (outprop.has_value()) {
+        // Forward the tensor value to the fanout, as if the node had been
+        // processed normally.
+        Tensor tensor;
+        if (tensor.FromProto(outprop.value())) {
+          MaybeTensorValueToShape(ic, tensor,
+                                  &ctx->output_tensors_as_shapes[i]);
+          const_tensors_to_propagate_.push_back(outprop.value());
+          ctx->output_tensor_protos[i] = &const_tensors_to_propagate_.back();
+        }
+      }
+    }
+    return Status::OK();
+  }
+
  private:
   // Return the one ShapeHandle used to denote a fully unknown shape for a node
   // output.
@@ -2067,6 +2124,13 @@ Status GraphProperties::UpdateEnqueue(
 
 Status GraphProperties::InferStatically(bool assume_valid_feeds,
                                         bool aggressive_shape_inference) {
+  const uint64 inference_start_us = Env::Default()->NowMicros();
+  auto accumulate_inference_time = gtl::MakeCleanup([inference_start_us] {
+    CumulativeInferenceTimeUsCounter()->fetch_add(
+        Env::Default()->NowMicros() - inference_start_us,
+        std::memory_order_relaxed);
+  });
+
   FunctionLibraryDefinition function_library(OpRegistry::Global(),
                                              item_.graph.library());
   std::unordered_map<string, std::unordered_set<int>> fed_ports;
@@ -2167,12 +2231,22 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
   TF_RETURN_IF_ERROR(
       PropagateShapes(&refiner, &new_shapes, resource_handles, num_loops));
 
+  TF_RETURN_IF_ERROR(ExtractInferredProperties(&refiner, graph_view, fed_ports,
+                                               /*restrict_to=*/nullptr));
+  RecordNodeFingerprints();
+  return Status::OK();
+}
+
+Status GraphProperties::ExtractInferredProperties(
+    SymbolicShapeRefiner* refiner, const GraphView& graph_view,
+    const std::unordered_map<string, std::unordered_set<int>>& fed_ports,
+    const std::unordered_set<const NodeDef*>* restrict_to) {
   // Track shapes globally across the graph.
   std::unique_ptr<SymbolicShapeManager> shape_manager =
       absl::make_unique<SymbolicShapeManager>();
   bool found_error = false;
   for (const NodeDef& node : item_.graph.node()) {
-    auto node_ctx = refiner.GetContext(&node);
+    auto node_ctx = refiner->GetContext(&node);
     if (!node_ctx) {
       continue;
     }
@@ -2203,8 +2277,11 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
   }
 
   for (const NodeDef& node : item_.graph.node()) {
+    if (restrict_to != nullptr && restrict_to->count(&node) == 0) {
+      continue;
+    }
     VLOG(3) << "Filling in graph properties for node: " << node.name();
-    auto ctx = refiner.GetNodeContext(&node);
+    auto ctx = refiner->GetNodeContext(&node);
     if (!ctx) {
       continue;
     }
@@ -2280,6 +2357,169 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
   return Status::OK();
 }
 
+Status GraphProperties::InferIncrementally(const GraphProperties& previous,
+                                           bool assume_valid_feeds,
+                                           bool aggressive_shape_inference) {
+  // Nothing to reuse: run a full inference.
+  if (&previous == this || previous.node_fingerprints_.empty() ||
+      !previous.has_properties()) {
+    return InferStatically(assume_valid_feeds, aggressive_shape_inference);
+  }
+
+  // Queues propagate shapes from enqueue to dequeue nodes outside of the
+  // regular edges of the graph, so the forward cone of the mutated nodes
+  // doesn't bound the set of stale shapes. Keep it simple and fall back.
+  int num_loops = 0;
+  for (const NodeDef& node : item_.graph.node()) {
+    if (IsQueue(node)) {
+      return InferStatically(assume_valid_feeds, aggressive_shape_inference);
+    }
+    if (IsNextIteration(node)) {
+      ++num_loops;
+    }
+  }
+
+  std::unordered_map<string, std::unordered_set<int>> fed_ports;
+  if (!assume_valid_feeds) {
+    for (const auto& feed : item_.feed) {
+      SafeTensorId tensor_id = ParseTensorName(feed.first);
+      fed_ports[tensor_id.node()].insert(tensor_id.index());
+    }
+  }
+
+  // Identify the nodes whose definition changed since `previous` was
+  // inferred. This includes rewired inputs, which are part of the NodeDef.
+  // Fed nodes are re-seeded on every inference, as in InferStatically().
+  node_fingerprints_.clear();
+  node_fingerprints_.reserve(item_.graph.node_size());
+  std::unordered_set<const NodeDef*> cone;
+  std::vector<const NodeDef*> work;
+  for (const NodeDef& node : item_.graph.node()) {
+    const uint64 fingerprint = DeterministicProtoHash64(node);
+    node_fingerprints_[node.name()] = fingerprint;
+    auto it = previous.node_fingerprints_.find(node.name());
+    if (it == previous.node_fingerprints_.end() || it->second != fingerprint ||
+        fed_ports.find(node.name()) != fed_ports.end()) {
+      cone.insert(&node);
+      work.push_back(&node);
+    }
+  }
+
+  if (work.empty()) {
+    // The graph didn't change: keep the previous properties as is.
+    input_properties_ = previous.input_properties_;
+    output_properties_ = previous.output_properties_;
+    return Status::OK();
+  }
+  // Re-inferring most of the graph incrementally isn't any cheaper than a
+  // fresh full inference.
+  if (static_cast<int>(work.size()) > item_.graph.node_size() / 2) {
+    return InferStatically(assume_valid_feeds, aggressive_shape_inference);
+  }
+
+  const uint64 inference_start_us = Env::Default()->NowMicros();
+  auto accumulate_inference_time = gtl::MakeCleanup([inference_start_us] {
+    CumulativeInferenceTimeUsCounter()->fetch_add(
+        Env::Default()->NowMicros() - inference_start_us,
+        std::memory_order_relaxed);
+  });
+
+  GraphView graph_view(&item_.graph);
+  SymbolicShapeRefiner refiner(graph_view, fed_ports,
+                               aggressive_shape_inference);
+
+  // Grow the dirty set to the forward cone of the mutated nodes, and seed the
+  // fanins on its boundary with the previously inferred shapes. A fanin we
+  // cannot seed is conservatively treated as mutated as well.
+  std::unordered_set<const NodeDef*> seeded;
+  while (!work.empty()) {
+    const NodeDef* n = work.back();
+    work.pop_back();
+    for (const auto& fanout :
+         graph_view.GetFanouts(*n, /*include_controlled_nodes=*/false)) {
+      if (cone.insert(fanout.node).second) {
+        work.push_back(fanout.node);
+      }
+    }
+    for (const auto& fanin :
+         graph_view.GetFanins(*n, /*include_controlling_nodes=*/false)) {
+      if (cone.count(fanin.node) > 0 || seeded.count(fanin.node) > 0) {
+        continue;
+      }
+      if (previous.HasOutputProperties(fanin.node->name()) &&
+          refiner
+              .SeedNodeFromProperties(
+                  fanin.node, previous.GetOutputProperties(fanin.node->name()))
+              .ok()) {
+        seeded.insert(fanin.node);
+      } else if (cone.insert(fanin.node).second) {
+        work.push_back(fanin.node);
+      }
+    }
+  }
+
+  std::vector<const NodeDef*> topo_order;
+  TF_RETURN_IF_ERROR(ComputeTopologicalOrder(item_.graph, &topo_order));
+
+  TopoQueue new_shapes(topo_order);
+  for (const NodeDef* node : cone) {
+    new_shapes.push(node);
+  }
+  const std::unordered_map<const NodeDef*, const NodeDef*> resource_handles;
+  TF_RETURN_IF_ERROR(
+      PropagateShapes(&refiner, &new_shapes, resource_handles, num_loops));
+
+  TF_RETURN_IF_ERROR(
+      ExtractInferredProperties(&refiner, graph_view, fed_ports, &cone));
+
+  // Carry over the properties of the unchanged nodes. Symbolic dimensions are
+  // demoted to unknown: their ids are not comparable with the ones assigned
+  // to the re-inferred part of the graph.
+  const auto demote_symbolic_dims =
+      [](std::vector<OpInfo::TensorProperties>* properties) {
+        for (auto& property : *properties) {
+          for (auto& dim : *property.mutable_shape()->mutable_dim()) {
+            if (dim.size() < -1) {
+              dim.set_size(-1);
+            }
+          }
+        }
+      };
+  for (const NodeDef& node : item_.graph.node()) {
+    if (cone.count(&node) > 0) {
+      continue;
+    }
+    auto input_it = previous.input_properties_.find(node.name());
+    if (input_it != previous.input_properties_.end()) {
+      auto& input_properties = input_properties_[node.name()];
+      input_properties = input_it->second;
+      demote_symbolic_dims(&input_properties);
+    }
+    auto output_it = previous.output_properties_.find(node.name());
+    if (output_it != previous.output_properties_.end()) {
+      auto& output_properties = output_properties_[node.name()];
+      output_properties = output_it->second;
+      demote_symbolic_dims(&output_properties);
+    }
+  }
+
+  VLOG(1) << "Incrementally re-inferred " << cone.size() << " nodes out of "
+          << item_.graph.node_size();
+  return Status::OK();
+}
+
+void GraphProperties::RecordNodeFingerprints() {
+  node_fingerprints_.clear();
+  node_fingerprints_.reserve(item_.graph.node_size());
+  for (const NodeDef& node : item_.graph.node()) {
+    node_fingerprints_[node.name()] = DeterministicProtoHash64(node);
+  }
+}
+
+int64 GraphProperties::CumulativeInferenceTimeUs() {
+  return CumulativeInferenceTimeUsCounter()->load(std::memory_order_relaxed);
+}
+
 Status GraphProperties::InferDynamically(Cluster* cluster) {
   TF_RETURN_IF_ERROR(cluster->Initialize(item_));
 
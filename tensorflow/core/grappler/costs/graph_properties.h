@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_GRAPPLER_COSTS_GRAPH_PROPERTIES_H_
 
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "tensorflow/core/framework/shape_inference.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
@@ -66,6 +67,7 @@ ABSL_CONST_INIT const char kOutputTypes[] = "_output_dtype_vector";
 // Outputs TensorShapeProto vector.
 ABSL_CONST_INIT const char kOutputShapes[] = "_output_shape_vector";
 
+class GraphView;
 class SymbolicShapeRefiner;
 class TopoQueue;
 
@@ -95,6 +97,23 @@ class GraphProperties {
     return InferStatically(assume_valid_feeds,
                            /*aggressive_shape_inference=*/false);
   }
+  // Like InferStatically(), but reuses the result of a previous static
+  // inference over an earlier version of the same graph: only the nodes whose
+  // definition changed since `previous` was inferred, and their transitive
+  // fanout, are re-processed. The properties of the remaining nodes are
+  // carried over from `previous` (with symbolic dimensions demoted to
+  // unknown, since symbolic ids are not comparable across inferences).
+  // Falls back to a full InferStatically() when there is nothing to reuse,
+  // when the graph contains queues, or when most of the graph changed.
+  Status InferIncrementally(const GraphProperties& previous,
+                            bool assume_valid_feeds,
+                            bool aggressive_shape_inference);
+
+  // Total time spent in static shape inference by all the GraphProperties
+  // instances of this process, in microseconds. The meta optimizer uses the
+  // deltas of this counter to report the inference time hidden in each
+  // optimization pass.
+  static int64 CumulativeInferenceTimeUs();
   // Infer the shape by running the graph on the specified cluster and recording
   // the shapes of the processed tensors.
   Status InferDynamically(Cluster* cluster);
@@ -169,6 +188,18 @@ class GraphProperties {
           resource_handles,
       int num_loops) const;
 
+  // Export the shapes tracked by 'shape_refiner' into input_properties_ and
+  // output_properties_. If 'restrict_to' is non-null, only the properties of
+  // the nodes it contains are filled in.
+  Status ExtractInferredProperties(
+      SymbolicShapeRefiner* shape_refiner, const GraphView& graph_view,
+      const std::unordered_map<string, std::unordered_set<int>>& fed_ports,
+      const std::unordered_set<const NodeDef*>* restrict_to);
+
+  // Record a per-node fingerprint of item_.graph, for use as the `previous`
+  // argument of a later InferIncrementally() call.
+  void RecordNodeFingerprints();
+
   // Data members
   const GrapplerItem& item_;
   std::unordered_map<string, std::vector<OpInfo::TensorProperties>>
@@ -176,6 +207,10 @@ class GraphProperties {
   std::unordered_map<string, std::vector<OpInfo::TensorProperties>>
       output_properties_;
   const std::vector<OpInfo::TensorProperties> missing_properties_;
+
+  // Fingerprint of each node definition at the time the properties were
+  // inferred, used to detect the mutated nodes in InferIncrementally().
+  std::unordered_map<string, uint64> node_fingerprints_;
 };
 
 }  // end namespace grappler
@@ -199,6 +199,48 @@ TEST_F(GraphPropertiesTest, ClearProperties) {
   }
 }
 
+TEST_F(GraphPropertiesTest, InferIncrementally) {
+  auto build_graph = [](int dim0, int dim1, GrapplerItem* item) {
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+    Output c = ops::Const(s.WithOpName("c"), 1.0f, {dim0, dim1});
+    Output i = ops::Identity(s.WithOpName("i"), c);
+    Output j = ops::Identity(s.WithOpName("j"), i);
+    // A disconnected part of the graph that never changes.
+    Output u = ops::Const(s.WithOpName("u"), 2.0f, {3});
+    Output v = ops::Identity(s.WithOpName("v"), u);
+    TF_CHECK_OK(s.ToGraphDef(&item->graph));
+  };
+
+  GrapplerItem item;
+  build_graph(5, 7, &item);
+  GraphProperties previous(item);
+  TF_CHECK_OK(previous.InferStatically(false));
+
+  // Change the shape of 'c': 'i' and 'j' must be re-inferred, while the
+  // properties of 'u' and 'v' are carried over.
+  GrapplerItem mutated_item;
+  build_graph(11, 13, &mutated_item);
+  GraphProperties properties(mutated_item);
+  TF_CHECK_OK(properties.InferIncrementally(previous, false, false));
+
+  for (const string& name : {"c", "i", "j"}) {
+    const auto props = properties.GetOutputProperties(name);
+    ASSERT_EQ(1, props.size());
+    EXPECT_EQ("float: [11,13]", PropToString(props[0]));
+  }
+  for (const string& name : {"u", "v"}) {
+    const auto props = properties.GetOutputProperties(name);
+    ASSERT_EQ(1, props.size());
+    EXPECT_EQ("float: [3]", PropToString(props[0]));
+  }
+
+  // An unchanged graph keeps the previous properties as is.
+  GraphProperties unchanged(item);
+  TF_CHECK_OK(unchanged.InferIncrementally(previous, false, false));
+  EXPECT_EQ("float: [5,7]",
+            PropToString(unchanged.GetOutputProperties("j")[0]));
+}
+
 TEST_F(GraphPropertiesTest, DynamicProperties) {
   TrivialTestGraphInputYielder fake_input(4, 1, 10, false,
                                           cluster_->GetDeviceNames());
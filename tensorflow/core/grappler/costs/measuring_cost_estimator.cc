@@ -20,12 +20,14 @@ limitations under the License.
 #include "tensorflow/core/framework/cost_graph.pb.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/costs/op_cost_table.h"
 #include "tensorflow/core/grappler/costs/robust_stats.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/public/session.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -141,6 +143,29 @@ Status MeasuringCostEstimator::PredictCosts(const GraphDef& optimized_graph,
     return status;
   }
 
+  // When calibration is requested, fold the measured per-node times into an
+  // op cost table for OpLevelCostEstimator to consult later.
+  string calibration_path;
+  TF_RETURN_IF_ERROR(ReadStringFromEnvVar(
+      "TF_GRAPPLER_OP_COST_TABLE_CALIBRATE", "", &calibration_path));
+  if (!calibration_path.empty() && cost_graph != nullptr) {
+    OpCostTable table;
+    // Aggregate with the measurements already on file, if any.
+    if (Env::Default()->FileExists(calibration_path).ok()) {
+      Status load_status = table.LoadFromFile(calibration_path);
+      if (!load_status.ok()) {
+        LOG(WARNING) << "Discarding unreadable op cost table "
+                     << calibration_path << ": " << load_status;
+      }
+    }
+    table.AddMeasurementsFromCostGraph(optimized_graph, *cost_graph);
+    Status save_status = table.SaveToFile(calibration_path);
+    if (!save_status.ok()) {
+      LOG(WARNING) << "Failed to save the op cost table to "
+                   << calibration_path << ": " << save_status;
+    }
+  }
+
   // Compute the average time of the measure steps. Use Huber statistics
   // to filter out outliers.
   RobustStats stats(times);
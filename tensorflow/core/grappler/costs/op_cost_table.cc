@@ -0,0 +1,140 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/op_cost_table.h"
+
+#include <vector>
+
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/lib/core/bits.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/util/device_name_utils.h"
+
+namespace tensorflow {
+namespace grappler {
+
+void OpCostTable::AddMeasurement(const string& op, const string& device_type,
+                                 int64 total_io_bytes,
+                                 int64 execution_time_ns) {
+  if (execution_time_ns <= 0) {
+    return;
+  }
+  Measurements& m = table_[Key(op, device_type, ShapeBucket(total_io_bytes))];
+  ++m.count;
+  m.total_time_ns += execution_time_ns;
+}
+
+void OpCostTable::AddMeasurementsFromCostGraph(const GraphDef& graph,
+                                               const CostGraphDef& cost_graph) {
+  std::unordered_map<string, const CostGraphDef::Node*> name_to_cost;
+  for (const auto& cost_node : cost_graph.node()) {
+    name_to_cost[cost_node.name()] = &cost_node;
+  }
+  for (const auto& node : graph.node()) {
+    auto it = name_to_cost.find(node.name());
+    if (it == name_to_cost.end()) {
+      continue;
+    }
+    const CostGraphDef::Node* cost_node = it->second;
+    if (cost_node->compute_cost() <= 0) {
+      continue;
+    }
+    DeviceNameUtils::ParsedName parsed;
+    if (!DeviceNameUtils::ParseFullName(cost_node->device(), &parsed) ||
+        !parsed.has_type) {
+      continue;
+    }
+    int64 total_io_bytes = 0;
+    for (const auto& output_info : cost_node->output_info()) {
+      total_io_bytes += output_info.size();
+    }
+    for (const string& input : node.input()) {
+      const int position = NodePosition(input);
+      if (position < 0) {
+        // Control inputs don't move data.
+        continue;
+      }
+      auto input_it = name_to_cost.find(NodeName(input));
+      if (input_it == name_to_cost.end() ||
+          position >= input_it->second->output_info_size()) {
+        continue;
+      }
+      total_io_bytes += input_it->second->output_info(position).size();
+    }
+    // The compute cost is reported in microseconds.
+    AddMeasurement(node.op(), parsed.type, total_io_bytes,
+                   cost_node->compute_cost() * 1000);
+  }
+}
+
+int64 OpCostTable::LookupExecutionTimeNs(const string& op,
+                                         const string& device_type,
+                                         int64 total_io_bytes) const {
+  auto it = table_.find(Key(op, device_type, ShapeBucket(total_io_bytes)));
+  if (it == table_.end() || it->second.count == 0) {
+    return -1;
+  }
+  return it->second.total_time_ns / it->second.count;
+}
+
+Status OpCostTable::LoadFromFile(const string& path) {
+  string content;
+  TF_RETURN_IF_ERROR(ReadFileToString(Env::Default(), path, &content));
+  for (const string& line : str_util::Split(content, '\n')) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    const std::vector<string> fields = str_util::Split(line, ' ');
+    int64 count, total_time_ns;
+    if (fields.size() != 5 || !strings::safe_strto64(fields[3], &count) ||
+        !strings::safe_strto64(fields[4], &total_time_ns) || count <= 0) {
+      return errors::InvalidArgument("Malformed op cost table line: ", line);
+    }
+    Measurements& m = table_[strings::StrCat(fields[0], " ", fields[1], " ",
+                                             fields[2])];
+    m.count += count;
+    m.total_time_ns += total_time_ns;
+  }
+  return Status::OK();
+}
+
+Status OpCostTable::SaveToFile(const string& path) const {
+  string content = "# op device_type shape_bucket count total_time_ns\n";
+  for (const auto& entry : table_) {
+    strings::StrAppend(&content, entry.first, " ", entry.second.count, " ",
+                       entry.second.total_time_ns, "\n");
+  }
+  return WriteStringToFile(Env::Default(), path, content);
+}
+
+int OpCostTable::ShapeBucket(int64 total_io_bytes) {
+  if (total_io_bytes <= 0) {
+    return 0;
+  }
+  return Log2Floor64(total_io_bytes) + 1;
+}
+
+string OpCostTable::Key(const string& op, const string& device_type,
+                        int bucket) {
+  return strings::StrCat(op, " ", device_type, " ", bucket);
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
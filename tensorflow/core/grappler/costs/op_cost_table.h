@@ -0,0 +1,82 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_OP_COST_TABLE_H_
+#define TENSORFLOW_CORE_GRAPPLER_COSTS_OP_COST_TABLE_H_
+
+#include <unordered_map>
+
+#include "tensorflow/core/framework/cost_graph.pb.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// A table of per-(op, device type, shape bucket) execution times measured on
+// the deployment hardware, used to calibrate the analytic cost predictions of
+// OpLevelCostEstimator. Shapes are bucketed by the log2 of the total number
+// of bytes the op reads and writes, which is coarse enough for measurements
+// of similar-sized invocations to aggregate, but fine enough to separate the
+// memory-bound small shapes (where analytic FLOP counts are wildly off) from
+// the compute-bound large ones.
+//
+// The table is typically populated from the cost graphs recorded by
+// MeasuringCostEstimator on real runs, saved to a file, and loaded back by
+// pointing the TF_GRAPPLER_OP_COST_TABLE environment variable at that file.
+class OpCostTable {
+ public:
+  OpCostTable() {}
+
+  // Record one measured execution of 'op' on 'device_type' that moved
+  // 'total_io_bytes' in inputs plus outputs and took 'execution_time_ns'.
+  void AddMeasurement(const string& op, const string& device_type,
+                      int64 total_io_bytes, int64 execution_time_ns);
+
+  // Record the per-node execution times of a measured run. 'graph' must be
+  // the graph the cost graph was recorded from; nodes missing from either
+  // side are ignored.
+  void AddMeasurementsFromCostGraph(const GraphDef& graph,
+                                    const CostGraphDef& cost_graph);
+
+  // Returns the average measured execution time in nanoseconds for the given
+  // op, device type and io volume, or -1 if nothing was measured for this
+  // bucket.
+  int64 LookupExecutionTimeNs(const string& op, const string& device_type,
+                              int64 total_io_bytes) const;
+
+  // Serialization to a text file, one bucket per line.
+  Status LoadFromFile(const string& path);
+  Status SaveToFile(const string& path) const;
+
+  bool empty() const { return table_.empty(); }
+
+ private:
+  struct Measurements {
+    int64 count = 0;
+    int64 total_time_ns = 0;
+  };
+
+  static int ShapeBucket(int64 total_io_bytes);
+  static string Key(const string& op, const string& device_type, int bucket);
+
+  std::unordered_map<string, Measurements> table_;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_COSTS_OP_COST_TABLE_H_
@@ -0,0 +1,92 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/op_cost_table.h"
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+TEST(OpCostTableTest, MeasurementsAggregatePerBucket) {
+  OpCostTable table;
+  EXPECT_TRUE(table.empty());
+
+  // 1100 and 1500 bytes fall in the same log2 bucket; 100000 doesn't.
+  table.AddMeasurement("MatMul", "CPU", 1100, 2000);
+  table.AddMeasurement("MatMul", "CPU", 1500, 4000);
+  table.AddMeasurement("MatMul", "CPU", 100000, 50000);
+
+  EXPECT_EQ(3000, table.LookupExecutionTimeNs("MatMul", "CPU", 1200));
+  EXPECT_EQ(50000, table.LookupExecutionTimeNs("MatMul", "CPU", 99000));
+  // Different bucket, op or device: nothing was measured.
+  EXPECT_EQ(-1, table.LookupExecutionTimeNs("MatMul", "CPU", 10));
+  EXPECT_EQ(-1, table.LookupExecutionTimeNs("Conv2D", "CPU", 1200));
+  EXPECT_EQ(-1, table.LookupExecutionTimeNs("MatMul", "GPU", 1200));
+}
+
+TEST(OpCostTableTest, SaveAndLoad) {
+  OpCostTable table;
+  table.AddMeasurement("MatMul", "CPU", 1000, 2000);
+  table.AddMeasurement("Conv2D", "GPU", 1 << 20, 123456);
+
+  const string path = io::JoinPath(testing::TmpDir(), "op_cost_table.txt");
+  TF_ASSERT_OK(table.SaveToFile(path));
+
+  OpCostTable loaded;
+  TF_ASSERT_OK(loaded.LoadFromFile(path));
+  EXPECT_EQ(2000, loaded.LookupExecutionTimeNs("MatMul", "CPU", 1000));
+  EXPECT_EQ(123456, loaded.LookupExecutionTimeNs("Conv2D", "GPU", 1 << 20));
+
+  // Loading on top of existing measurements aggregates them.
+  TF_ASSERT_OK(loaded.LoadFromFile(path));
+  EXPECT_EQ(2000, loaded.LookupExecutionTimeNs("MatMul", "CPU", 1000));
+}
+
+TEST(OpCostTableTest, AddMeasurementsFromCostGraph) {
+  GraphDef graph;
+  NodeDef* a = graph.add_node();
+  a->set_name("a");
+  a->set_op("Const");
+  NodeDef* b = graph.add_node();
+  b->set_name("b");
+  b->set_op("Square");
+  b->add_input("a");
+
+  CostGraphDef cost_graph;
+  CostGraphDef::Node* a_cost = cost_graph.add_node();
+  a_cost->set_name("a");
+  a_cost->set_device("/job:localhost/replica:0/task:0/device:CPU:0");
+  a_cost->add_output_info()->set_size(512);
+  CostGraphDef::Node* b_cost = cost_graph.add_node();
+  b_cost->set_name("b");
+  b_cost->set_device("/job:localhost/replica:0/task:0/device:CPU:0");
+  b_cost->add_output_info()->set_size(512);
+  b_cost->set_compute_cost(7);  // Microseconds.
+
+  OpCostTable table;
+  table.AddMeasurementsFromCostGraph(graph, cost_graph);
+
+  // 'a' has no measured compute cost; 'b' reads and writes 512 bytes each.
+  EXPECT_EQ(-1, table.LookupExecutionTimeNs("Const", "CPU", 512));
+  EXPECT_EQ(7000, table.LookupExecutionTimeNs("Square", "CPU", 1024));
+}
+
+}  // namespace
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
 
+#include "absl/memory/memory.h"
 #include "third_party/eigen3/Eigen/Core"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/attr_value_util.h"
@@ -23,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/grappler/clusters/utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -369,10 +371,47 @@ OpLevelCostEstimator::OpLevelCostEstimator() {
 
   // By default, use sum of memory_time and compute_time for execution_time.
   compute_memory_overlap_ = false;
+
+  // Load the execution times measured on the deployment hardware, if any.
+  string op_cost_table_path;
+  TF_CHECK_OK(ReadStringFromEnvVar("TF_GRAPPLER_OP_COST_TABLE", "",
+                                   &op_cost_table_path));
+  if (!op_cost_table_path.empty()) {
+    auto calibrated_costs = absl::make_unique<OpCostTable>();
+    Status s = calibrated_costs->LoadFromFile(op_cost_table_path);
+    if (s.ok()) {
+      calibrated_costs_ = std::move(calibrated_costs);
+    } else {
+      LOG(WARNING) << "Failed to load the op cost table from "
+                   << op_cost_table_path << ": " << s;
+    }
+  }
 }
 
 Costs OpLevelCostEstimator::PredictCosts(const OpContext& op_context) const {
   const auto& op_info = op_context.op_info;
+
+  // Prefer the times measured on the actual hardware over the analytic
+  // models, which can be wildly off for memory-bound and small ops.
+  if (calibrated_costs_ != nullptr) {
+    bool found_unknown_shapes = false;
+    const int64 total_io_bytes =
+        CalculateInputSize(op_info, &found_unknown_shapes) +
+        CalculateOutputSize(op_info, &found_unknown_shapes);
+    if (!found_unknown_shapes) {
+      const int64 execution_time_ns = calibrated_costs_->LookupExecutionTimeNs(
+          op_info.op(), op_info.device().type(), total_io_bytes);
+      if (execution_time_ns >= 0) {
+        Costs costs = Costs::ZeroCosts();
+        costs.compute_time = Costs::NanoSeconds(execution_time_ns);
+        costs.execution_time = costs.compute_time;
+        VLOG(1) << "Operation " << op_info.op() << " takes "
+                << costs.execution_time.count() << " ns (calibrated).";
+        return costs;
+      }
+    }
+  }
+
   auto it = device_cost_impl_.find(op_info.op());
   if (it != device_cost_impl_.end()) {
     std::function<Costs(const OpContext&)> estimator = it->second;
@@ -16,8 +16,11 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_OP_LEVEL_COST_ESTIMATOR_H_
 #define TENSORFLOW_CORE_GRAPPLER_COSTS_OP_LEVEL_COST_ESTIMATOR_H_
 
+#include <memory>
+
 #include "tensorflow/core/grappler/costs/cost_estimator.h"
 #include "tensorflow/core/grappler/costs/op_context.h"
+#include "tensorflow/core/grappler/costs/op_cost_table.h"
 #include "tensorflow/core/grappler/costs/op_performance_data.pb.h"
 #include "tensorflow/core/util/padding.h"
 
@@ -197,6 +200,10 @@ class OpLevelCostEstimator {
   // compute_time and memory_time, insteaf of sum of those two.
   bool compute_memory_overlap_;
   std::set<string> persistent_ops_;
+  // Execution times measured on the deployment hardware, consulted before
+  // falling back to the analytic models. Loaded from the file named by the
+  // TF_GRAPPLER_OP_COST_TABLE environment variable; null when unset.
+  std::unique_ptr<OpCostTable> calibrated_costs_;
 
  private:
   friend class OpLevelCostEstimatorTest;
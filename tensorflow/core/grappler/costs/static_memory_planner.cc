@@ -0,0 +1,117 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/static_memory_planner.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace grappler {
+
+namespace {
+
+struct PlacedTensor {
+  const GraphMemory::LiveTensor* tensor;
+  size_t offset;
+  size_t size;
+};
+
+bool LifetimesOverlap(const GraphMemory::LiveTensor& a,
+                      const GraphMemory::LiveTensor& b) {
+  return a.allocation_time < b.deallocation_time &&
+         b.allocation_time < a.deallocation_time;
+}
+
+size_t AlignUp(size_t bytes) {
+  return (bytes + Allocator::kAllocatorAlignment - 1) &
+         ~(Allocator::kAllocatorAlignment - 1);
+}
+
+}  // namespace
+
+Status StaticMemoryPlanner::ComputePlan(
+    const std::vector<GraphMemory::LiveTensor>& live_tensors, Plan* plan) {
+  plan->slab_bytes = 0;
+  plan->assignments.clear();
+
+  for (const GraphMemory::LiveTensor& tensor : live_tensors) {
+    if (tensor.memory_used == 0) {
+      return errors::InvalidArgument("Unknown size for output ",
+                                     tensor.output_id, " of node ",
+                                     tensor.node);
+    }
+    if (tensor.deallocation_time <= tensor.allocation_time) {
+      return errors::InvalidArgument("Invalid lifetime for output ",
+                                     tensor.output_id, " of node ",
+                                     tensor.node);
+    }
+  }
+
+  // Place the largest tensors first: the classic greedy decreasing-size
+  // heuristic keeps the big buffers tightly packed and lets the small ones
+  // fill the remaining gaps.
+  std::vector<const GraphMemory::LiveTensor*> order;
+  order.reserve(live_tensors.size());
+  for (const GraphMemory::LiveTensor& tensor : live_tensors) {
+    order.push_back(&tensor);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](const GraphMemory::LiveTensor* a,
+                      const GraphMemory::LiveTensor* b) {
+                     return a->memory_used > b->memory_used;
+                   });
+
+  std::vector<PlacedTensor> placed;
+  placed.reserve(order.size());
+  for (const GraphMemory::LiveTensor* tensor : order) {
+    const size_t size = AlignUp(tensor->memory_used);
+
+    // Collect the slab intervals already claimed by tensors whose lifetimes
+    // overlap this one, then place this tensor at the lowest offset that
+    // avoids them all.
+    std::vector<std::pair<size_t, size_t>> busy;
+    for (const PlacedTensor& other : placed) {
+      if (LifetimesOverlap(*tensor, *other.tensor)) {
+        busy.emplace_back(other.offset, other.offset + other.size);
+      }
+    }
+    std::sort(busy.begin(), busy.end());
+
+    size_t offset = 0;
+    for (const auto& interval : busy) {
+      if (offset + size <= interval.first) {
+        break;
+      }
+      offset = std::max(offset, interval.second);
+    }
+
+    placed.push_back({tensor, offset, size});
+    plan->slab_bytes = std::max(plan->slab_bytes, offset + size);
+  }
+
+  plan->assignments.reserve(placed.size());
+  for (const PlacedTensor& p : placed) {
+    plan->assignments.push_back(
+        {p.tensor->node, p.tensor->output_id, p.offset, p.size});
+  }
+  return Status::OK();
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
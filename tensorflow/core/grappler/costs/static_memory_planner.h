@@ -0,0 +1,58 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_STATIC_MEMORY_PLANNER_H_
+#define TENSORFLOW_CORE_GRAPPLER_COSTS_STATIC_MEMORY_PLANNER_H_
+
+#include <vector>
+
+#include "tensorflow/core/grappler/costs/graph_memory.h"
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Computes a static buffer assignment for a fixed-shape graph: given the
+// tensor lifetimes inferred by GraphMemory, assigns each tensor a fixed
+// offset into a single pre-reserved slab such that tensors with overlapping
+// lifetimes never overlap in memory. Executors serving fixed-shape graphs can
+// then satisfy per-step allocations with pointer arithmetic into the slab
+// instead of going through a dynamic allocator.
+class StaticMemoryPlanner {
+ public:
+  struct TensorAssignment {
+    string node;
+    int output_id;
+    size_t offset;
+    size_t size;
+  };
+
+  struct Plan {
+    // Total bytes to reserve for the slab.
+    size_t slab_bytes;
+    std::vector<TensorAssignment> assignments;
+  };
+
+  // Computes a plan for the given tensor lifetimes. Offsets are aligned to
+  // Allocator::kAllocatorAlignment. Fails if any tensor has an unknown size
+  // or an invalid lifetime, since a partial plan cannot be executed safely.
+  static Status ComputePlan(
+      const std::vector<GraphMemory::LiveTensor>& live_tensors, Plan* plan);
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_COSTS_STATIC_MEMORY_PLANNER_H_
@@ -0,0 +1,107 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/static_memory_planner.h"
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+GraphMemory::LiveTensor MakeTensor(const string& node, size_t size,
+                                   int64 alloc_time, int64 dealloc_time) {
+  GraphMemory::LiveTensor tensor;
+  tensor.node = node;
+  tensor.output_id = 0;
+  tensor.memory_used = size;
+  tensor.allocation_time = alloc_time;
+  tensor.deallocation_time = dealloc_time;
+  return tensor;
+}
+
+size_t OffsetOf(const StaticMemoryPlanner::Plan& plan, const string& node) {
+  for (const auto& assignment : plan.assignments) {
+    if (assignment.node == node) {
+      return assignment.offset;
+    }
+  }
+  ADD_FAILURE() << "No assignment for node " << node;
+  return 0;
+}
+
+TEST(StaticMemoryPlannerTest, DisjointLifetimesShareMemory) {
+  std::vector<GraphMemory::LiveTensor> tensors;
+  tensors.push_back(MakeTensor("a", 1024, 0, 10));
+  tensors.push_back(MakeTensor("b", 1024, 10, 20));
+
+  StaticMemoryPlanner::Plan plan;
+  TF_ASSERT_OK(StaticMemoryPlanner::ComputePlan(tensors, &plan));
+  ASSERT_EQ(2, plan.assignments.size());
+  // The lifetimes don't overlap, so both tensors fit in one buffer's worth of
+  // slab.
+  EXPECT_EQ(1024, plan.slab_bytes);
+  EXPECT_EQ(OffsetOf(plan, "a"), OffsetOf(plan, "b"));
+}
+
+TEST(StaticMemoryPlannerTest, OverlappingLifetimesDontOverlapInMemory) {
+  std::vector<GraphMemory::LiveTensor> tensors;
+  tensors.push_back(MakeTensor("a", 1024, 0, 15));
+  tensors.push_back(MakeTensor("b", 2048, 10, 20));
+  tensors.push_back(MakeTensor("c", 512, 18, 30));
+
+  StaticMemoryPlanner::Plan plan;
+  TF_ASSERT_OK(StaticMemoryPlanner::ComputePlan(tensors, &plan));
+  ASSERT_EQ(3, plan.assignments.size());
+  // "a" and "b" overlap, as do "b" and "c", so each pair must be disjoint in
+  // the slab; "a" and "c" don't overlap and may share.
+  EXPECT_NE(OffsetOf(plan, "a"), OffsetOf(plan, "b"));
+  EXPECT_NE(OffsetOf(plan, "b"), OffsetOf(plan, "c"));
+  EXPECT_EQ(3072, plan.slab_bytes);
+}
+
+TEST(StaticMemoryPlannerTest, OffsetsAreAligned) {
+  std::vector<GraphMemory::LiveTensor> tensors;
+  tensors.push_back(MakeTensor("a", 100, 0, 10));
+  tensors.push_back(MakeTensor("b", 100, 5, 15));
+
+  StaticMemoryPlanner::Plan plan;
+  TF_ASSERT_OK(StaticMemoryPlanner::ComputePlan(tensors, &plan));
+  for (const auto& assignment : plan.assignments) {
+    EXPECT_EQ(0, assignment.offset % Allocator::kAllocatorAlignment);
+  }
+}
+
+TEST(StaticMemoryPlannerTest, RejectsUnknownSizes) {
+  std::vector<GraphMemory::LiveTensor> tensors;
+  tensors.push_back(MakeTensor("a", 0, 0, 10));
+
+  StaticMemoryPlanner::Plan plan;
+  EXPECT_FALSE(StaticMemoryPlanner::ComputePlan(tensors, &plan).ok());
+}
+
+TEST(StaticMemoryPlannerTest, RejectsInvalidLifetimes) {
+  std::vector<GraphMemory::LiveTensor> tensors;
+  tensors.push_back(MakeTensor("a", 1024, 10, 10));
+
+  StaticMemoryPlanner::Plan plan;
+  EXPECT_FALSE(StaticMemoryPlanner::ComputePlan(tensors, &plan).ok());
+}
+
+}  // namespace
+}  // end namespace grappler
+}  // end namespace tensorflow
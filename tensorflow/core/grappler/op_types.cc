@@ -118,6 +118,8 @@ bool IsCheckNumerics(const NodeDef& node) {
   return node.op() == "CheckNumerics";
 }
 
+bool IsClipByValue(const NodeDef& node) { return node.op() == "ClipByValue"; }
+
 bool IsCollective(const NodeDef& node) {
   return node.op() == "CollectiveReduce" ||
          node.op() == "CollectiveBcastSend" ||
@@ -349,6 +351,8 @@ bool IsNextIteration(const NodeDef& node) {
   return op == "NextIteration" || op == "RefNextIteration";
 }
 
+bool IsOneHot(const NodeDef& node) { return node.op() == "OneHot"; }
+
 bool IsOnesLike(const NodeDef& node) { return node.op() == "OnesLike"; }
 
 bool IsPack(const NodeDef& node) { return node.op() == "Pack"; }
@@ -457,6 +461,8 @@ bool IsShapeN(const NodeDef& node) { return node.op() == "ShapeN"; }
 
 bool IsShuffle(const NodeDef& node) { return node.op() == "Shuffle"; }
 
+bool IsSigmoid(const NodeDef& node) { return node.op() == "Sigmoid"; }
+
 bool IsSigmoidGrad(const NodeDef& node) { return node.op() == "SigmoidGrad"; }
 
 bool IsSize(const NodeDef& node) { return node.op() == "Size"; }
@@ -528,6 +534,8 @@ bool IsSymbolicGradient(const NodeDef& node) {
   return node.op() == "SymbolicGradient";
 }
 
+bool IsTanh(const NodeDef& node) { return node.op() == "Tanh"; }
+
 bool IsTanhGrad(const NodeDef& node) { return node.op() == "TanhGrad"; }
 
 bool IsTensorArray(const NodeDef& node) {
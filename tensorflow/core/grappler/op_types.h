@@ -47,6 +47,7 @@ bool IsBiasAddGrad(const NodeDef& node);
 bool IsBitcast(const NodeDef& node);
 bool IsCast(const NodeDef& node);
 bool IsCheckNumerics(const NodeDef& node);
+bool IsClipByValue(const NodeDef& node);
 bool IsCollective(const NodeDef& node);
 bool IsComplex(const NodeDef& node);
 bool IsComplexAbs(const NodeDef& node);
@@ -115,6 +116,7 @@ bool IsNeg(const NodeDef& node);
 bool IsNextIteration(const NodeDef& node);
 bool IsNoOp(const NodeDef& node);
 bool IsNotEqual(const NodeDef& node);
+bool IsOneHot(const NodeDef& node);
 bool IsOnesLike(const NodeDef& node);
 bool IsPack(const NodeDef& node);
 bool IsPack(const NodeDef& node);
@@ -152,6 +154,7 @@ bool IsSend(const NodeDef& node);
 bool IsShape(const NodeDef& node);
 bool IsShapeN(const NodeDef& node);
 bool IsShuffle(const NodeDef& node);
+bool IsSigmoid(const NodeDef& node);
 bool IsSigmoidGrad(const NodeDef& node);
 bool IsSize(const NodeDef& node);
 bool IsSlice(const NodeDef& node);
@@ -178,6 +181,7 @@ bool IsSub(const NodeDef& node);
 bool IsSum(const NodeDef& node);
 bool IsSwitch(const NodeDef& node);
 bool IsSymbolicGradient(const NodeDef& node);
+bool IsTanh(const NodeDef& node);
 bool IsTanhGrad(const NodeDef& node);
 bool IsTensorArray(const NodeDef& node);
 bool IsTile(const NodeDef& node);
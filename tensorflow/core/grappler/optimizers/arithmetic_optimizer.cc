@@ -2169,6 +2169,42 @@ class FoldMultiplyIntoConv : public ArithmeticOptimizerStage {
   }
 };
 
+// Returns true if `perm` swaps the two innermost dimensions and leaves all
+// outer dimensions in place.
+template <typename T>
+bool IsInnerMatrixTranspose(const std::vector<T>& perm) {
+  const T n = perm.size();
+  if (n < 2) {
+    return false;
+  }
+  for (T i = 0; i < n - 2; ++i) {
+    if (perm[i] != i) {
+      return false;
+    }
+  }
+  return perm[n - 1] == n - 2 && perm[n - 2] == n - 1;
+}
+
+// Returns true if `transpose_node` is a (conjugate) transpose of the two
+// innermost dimensions, as determined by its constant perm input.
+bool IsInnerMatrixTransposeNode(const NodeDef& transpose_node,
+                                const NodeMap* node_map) {
+  if (transpose_node.op() != "Transpose" &&
+      transpose_node.op() != "ConjugateTranspose") {
+    return false;
+  }
+  const NodeDef* perm_node = node_map->GetNode(transpose_node.input(1));
+  std::vector<int> perm32;
+  if (ValuesFromConstNode(*perm_node, &perm32)) {
+    return IsInnerMatrixTranspose(perm32);
+  }
+  std::vector<int64> perm64;
+  if (ValuesFromConstNode(*perm_node, &perm64)) {
+    return IsInnerMatrixTranspose(perm64);
+  }
+  return false;
+}
+
 // Fold Transpose into matrix multiplication.
 class FoldTransposeIntoMatMul : public ArithmeticOptimizerStage {
  public:
@@ -2242,37 +2278,91 @@ class FoldTransposeIntoMatMul : public ArithmeticOptimizerStage {
         !node->attr().count(attr_name) ? false : node->attr().at(attr_name).b();
     (*node->mutable_attr())[attr_name].set_b(!old_value);
   }
+};
 
-  template <typename T>
-  bool IsInnerMatrixTranspose(const std::vector<T>& perm) {
-    const T n = perm.size();
-    if (n < 2) {
-      return false;
-    }
-    for (T i = 0; i < n - 2; ++i) {
-      if (perm[i] != i) {
-        return false;
-      }
-    }
-    return perm[n - 1] == n - 2 && perm[n - 2] == n - 1;
+// Fold Transpose of a matrix multiplication into the multiplication itself,
+// using the identity transpose(A * B) = transpose(B) * transpose(A). The
+// transposes of the operands are expressed through the multiplication's
+// transpose_a/transpose_b (adj_x/adj_y) attributes, so no intermediate tensor
+// is materialized. This is the output-side counterpart of
+// FoldTransposeIntoMatMul above.
+class FoldTransposeOfMatMul : public ArithmeticOptimizerStage {
+ public:
+  explicit FoldTransposeOfMatMul(const GraphOptimizerContext& ctx,
+                                 const ArithmeticOptimizerContext& ctx_ext)
+      : ArithmeticOptimizerStage("FoldTransposeOfMatMul", ctx, ctx_ext) {}
+  ~FoldTransposeOfMatMul() override = default;
+
+  bool IsSupported(const NodeDef* node) const override {
+    return IsTranspose(*node) || IsConjugateTranspose(*node);
   }
 
-  bool IsInnerMatrixTransposeNode(const NodeDef& transpose_node,
-                                  const NodeMap* node_map) {
-    if (transpose_node.op() != "Transpose" &&
-        transpose_node.op() != "ConjugateTranspose") {
-      return false;
+  Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
+    const NodeScopeAndName transpose = ParseNodeScopeAndName(node->name());
+    const string optimized_node_name = OptimizedNodeName(transpose);
+    if (ctx().node_map->NodeExists(optimized_node_name)) return Status::OK();
+
+    NodeDef* matmul;
+    TF_RETURN_IF_ERROR(GetInputNode(node->input(0), &matmul));
+    // SparseMatMul carries per-operand dtype attributes and QuantizedMatMul
+    // has extra min/max inputs and outputs, so swapping their operands is not
+    // a pure attribute rewrite; only plain and batched multiplications are
+    // handled here.
+    if (matmul->op() != "MatMul" && matmul->op() != "BatchMatMul") {
+      return Status::OK();
     }
-    const NodeDef* perm_node = node_map->GetNode(transpose_node.input(1));
-    std::vector<int> perm32;
-    if (ValuesFromConstNode(*perm_node, &perm32)) {
-      return IsInnerMatrixTranspose(perm32);
+    // Folding replaces the multiplication; if other nodes consume its result
+    // (or it must be preserved) the product would be computed twice.
+    if (IsInPreserveSet(*matmul) ||
+        NumNonControlOutputs(*matmul, *ctx().node_map) > 1) {
+      return Status::OK();
     }
-    std::vector<int64> perm64;
-    if (ValuesFromConstNode(*perm_node, &perm64)) {
-      return IsInnerMatrixTranspose(perm64);
+    if (!IsInnerMatrixTransposeNode(*node, ctx().node_map)) {
+      return Status::OK();
     }
-    return false;
+
+    // MatMul's transpose_a/transpose_b are plain transpositions, so a complex
+    // ConjugateTranspose cannot be absorbed; BatchMatMul's adj_x/adj_y are
+    // adjoints, so there a complex plain Transpose cannot. For real types the
+    // two coincide.
+    const DataType type = GetDataTypeFromAttr(*matmul, "T");
+    const bool is_complex = (type == DT_COMPLEX64) || (type == DT_COMPLEX128);
+    if (is_complex &&
+        IsConjugateTranspose(*node) != (matmul->op() == "BatchMatMul")) {
+      return Status::OK();
+    }
+
+    const string attr_a =
+        matmul->op() == "BatchMatMul" ? "adj_x" : "transpose_a";
+    const string attr_b =
+        matmul->op() == "BatchMatMul" ? "adj_y" : "transpose_b";
+
+    // transpose(A * B) = transpose(B) * transpose(A): swap the operands and
+    // flip both transposition attributes.
+    NodeDef* new_op = AddCopyNode(optimized_node_name, matmul);
+    // Swapping the operand positions leaves the set of fanins unchanged, so
+    // the node map created by AddCopyNode stays valid.
+    new_op->set_input(0, matmul->input(1));
+    new_op->set_input(1, matmul->input(0));
+    const bool old_a = GetBoolAttr(*matmul, attr_a);
+    const bool old_b = GetBoolAttr(*matmul, attr_b);
+    (*new_op->mutable_attr())[attr_a].set_b(!old_b);
+    (*new_op->mutable_attr())[attr_b].set_b(!old_a);
+
+    ForwardControlDependencies(new_op, {node, matmul});
+    *simplified_node_name = new_op->name();
+
+    return Status::OK();
+  }
+
+ private:
+  bool IsInPreserveSet(const NodeDef& node) const {
+    return ctx().nodes_to_preserve->find(node.name()) !=
+           ctx().nodes_to_preserve->end();
+  }
+
+  bool GetBoolAttr(const NodeDef& node, const string& attr_name) {
+    return node.attr().count(attr_name) > 0 && node.attr().at(attr_name).b();
   }
 };
 
@@ -3310,6 +3400,132 @@ class RemoveStackStridedSliceSameAxis : public ArithmeticOptimizerStage {
   }
 };
 
+// Eliminates the dense intermediate in MatMul(OneHot(indices), weights) by
+// gathering the weight rows directly:
+//
+//   MatMul(OneHot(indices, depth, 1, 0), weights) =>
+//   GatherV2(weights, indices, 0)
+//
+// The one-hot matrix has a single nonzero per row, so the matmul performs
+// O(batch * depth * cols) multiplies for what is a row lookup; for
+// categorical features with large depth the rewrite removes both the
+// materialization of the one-hot tensor and the multiply. The rewrite
+// applies when the one-hot axis is the trailing one, the on/off values are
+// the constants one and zero, neither matmul operand is transposed, and the
+// indices have rank 1. Note that OneHot maps an out-of-range index to an
+// all-zero row while the gathered form fails on it, so the rewrite assumes
+// indices are in range.
+class ReplaceOneHotMatMul : public ArithmeticOptimizerStage {
+ public:
+  explicit ReplaceOneHotMatMul(const GraphOptimizerContext& ctx,
+                               const ArithmeticOptimizerContext& ctx_ext)
+      : ArithmeticOptimizerStage("ReplaceOneHotMatMul", ctx, ctx_ext) {}
+  ~ReplaceOneHotMatMul() override = default;
+
+  bool IsSupported(const NodeDef* node) const override {
+    return IsMatMul(*node);
+  }
+
+  Status TrySimplify(NodeDef* node, string* simplified_node_name) override {
+    const auto& attr = node->attr();
+    if (attr.count("transpose_a") > 0 && attr.at("transpose_a").b()) {
+      return Status::OK();
+    }
+    if (attr.count("transpose_b") > 0 && attr.at("transpose_b").b()) {
+      return Status::OK();
+    }
+
+    NodeDef* one_hot;
+    TF_RETURN_IF_ERROR(GetInputNode(node->input(0), &one_hot));
+    if (!IsOneHot(*one_hot) || IsInPreserveSet(*one_hot) ||
+        NumNonControlOutputs(*one_hot, *ctx().node_map) != 1 ||
+        one_hot->input_size() != 4) {
+      return Status::OK();
+    }
+    // The one-hot axis must be the trailing dimension, so that row i of the
+    // one-hot output selects row indices[i] of the weight matrix.
+    if (one_hot->attr().count("axis") > 0 &&
+        one_hot->attr().at("axis").i() != -1) {
+      return Status::OK();
+    }
+    NodeDef* on_value;
+    NodeDef* off_value;
+    TF_RETURN_IF_ERROR(GetInputNode(one_hot->input(2), &on_value));
+    TF_RETURN_IF_ERROR(GetInputNode(one_hot->input(3), &off_value));
+    if (!IsScalarConstantWithValue(*on_value, 1.0) ||
+        !IsScalarConstantWithValue(*off_value, 0.0)) {
+      return Status::OK();
+    }
+    // The indices must have rank 1 so the one-hot output is a matrix.
+    OpInfo::TensorProperties indices_properties;
+    TF_RETURN_IF_ERROR(
+        GetTensorProperties(one_hot->input(0), &indices_properties));
+    if (indices_properties.shape().unknown_rank() ||
+        indices_properties.shape().dim_size() != 1) {
+      return Status::OK();
+    }
+
+    NodeDef* axis = AddEmptyNode(
+        OptimizedNodeName(ParseNodeScopeAndName(node->name()), "Axis"));
+    axis->set_op("Const");
+    axis->set_device(node->device());
+    SetDataTypeToAttr(DT_INT32, "dtype", axis);
+    auto* axis_t = (*axis->mutable_attr())["value"].mutable_tensor();
+    axis_t->set_dtype(DT_INT32);
+    axis_t->add_int_val(0);
+    AddToOptimizationQueue(axis);
+
+    NodeDef* gather =
+        AddEmptyNode(OptimizedNodeName(ParseNodeScopeAndName(node->name())));
+    gather->set_op("GatherV2");
+    gather->set_device(node->device());
+    gather->add_input(node->input(1));     // The weight matrix.
+    gather->add_input(one_hot->input(0));  // The indices.
+    gather->add_input(axis->name());
+    SetDataTypeToAttr(GetDataTypeFromAttr(*node, "T"), "Tparams", gather);
+    SetDataTypeToAttr(indices_properties.dtype(), "Tindices", gather);
+    SetDataTypeToAttr(DT_INT32, "Taxis", gather);
+
+    ForwardControlDependencies(gather, {node, one_hot});
+    AddToOptimizationQueue(gather);
+    *simplified_node_name = gather->name();
+
+    return Status::OK();
+  }
+
+ protected:
+  bool IsReallyConstant(const NodeDef& node) const {
+    if (!IsConstant(node)) {
+      return false;
+    }
+    // If the node is fed it's not constant anymore.
+    return ctx().feed_nodes->find(node.name()) == ctx().feed_nodes->end();
+  }
+
+  bool IsScalarConstantWithValue(const NodeDef& node, double expected) const {
+    if (!IsReallyConstant(node) || node.attr().count("value") == 0) {
+      return false;
+    }
+    Tensor t;
+    if (!t.FromProto(node.attr().at("value").tensor()) ||
+        t.NumElements() != 1) {
+      return false;
+    }
+    switch (t.dtype()) {
+      case DT_FLOAT:
+        return t.scalar<float>()() == expected;
+      case DT_DOUBLE:
+        return t.scalar<double>()() == expected;
+      case DT_INT32:
+        return t.scalar<int32>()() == expected;
+      case DT_INT64:
+        return t.scalar<int64>()() == expected;
+      default:
+        return false;
+    }
+  }
+};
+
 }  // namespace
 
 class UniqueNodes {
@@ -3552,6 +3768,8 @@ Status ArithmeticOptimizer::SimplifyArithmeticOps(bool can_use_shapes) {
     pipeline.AddStage<FoldMultiplyIntoConv>(ctx, ctx_ext);
   if (options_.fold_transpose_into_matmul)
     pipeline.AddStage<FoldTransposeIntoMatMul>(ctx, ctx_ext);
+  if (options_.fold_transpose_of_matmul)
+    pipeline.AddStage<FoldTransposeOfMatMul>(ctx, ctx_ext);
   if (options_.hoist_common_factor_out_of_aggregation && can_use_shapes)
     pipeline.AddStage<HoistCommonFactorOutOfAggregation>(ctx, ctx_ext);
   if (options_.minimize_broadcasts && can_use_shapes)
@@ -3597,6 +3815,8 @@ Status ArithmeticOptimizer::SimplifyArithmeticOps(bool can_use_shapes) {
     pipeline.AddStage<RemoveStackStridedSliceSameAxis>(ctx, ctx_ext);
   if (options_.fuse_squared_diff)
     pipeline.AddStage<FuseSquaredDiffStage>(ctx, ctx_ext);
+  if (options_.replace_onehot_matmul && can_use_shapes)
+    pipeline.AddStage<ReplaceOneHotMatMul>(ctx, ctx_ext);
 
   VLOG(1) << "Run " << pipeline.NumStages() << " arithmetic optimizer stages: "
           << str_util::Join(pipeline.StageNames(), ", ");
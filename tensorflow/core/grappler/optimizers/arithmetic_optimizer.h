@@ -61,6 +61,7 @@ class ArithmeticOptimizer : public GraphOptimizer {
     bool fold_conjugate_into_transpose = true;
     bool fold_multiply_into_conv = true;
     bool fold_transpose_into_matmul = true;
+    bool fold_transpose_of_matmul = true;
     bool fuse_squared_diff = true;
     bool hoist_common_factor_out_of_aggregation = true;
     bool hoist_cwise_unary_chains = true;
@@ -83,6 +84,7 @@ class ArithmeticOptimizer : public GraphOptimizer {
     bool convert_expm1 = true;
     bool unary_ops_composition = true;
     bool remove_stack_strided_slice_same_axis = true;
+    bool replace_onehot_matmul = true;
 
     // Choose which arithmetic optimizer stages will be enabled for a given
     // optimization level by default.
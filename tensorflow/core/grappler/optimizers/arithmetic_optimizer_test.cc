@@ -883,6 +883,67 @@ TEST_F(ArithmeticOptimizerTest, FoldTransposeIntoMatMul) {
   }
 }
 
+TEST_F(ArithmeticOptimizerTest, FoldTransposeOfMatMul) {
+  for (const string matmul_type : {"MatMul", "BatchMatMul"}) {
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+    Output a = ops::Const(s.WithOpName("a"), {1.0f, 2.0f, 3.0f, 4.0f}, {2, 2});
+    Output b = ops::Const(s.WithOpName("b"), {5.0f, 6.0f, 7.0f, 8.0f}, {2, 2});
+    Output perm = ops::Const(s.WithOpName("perm"), {1, 0}, {2});
+
+    Output matmul;
+    auto matmul_op = s.WithOpName("matmul");
+    if (matmul_type == "MatMul") {
+      matmul = ops::MatMul(matmul_op, a, b);
+    } else if (matmul_type == "BatchMatMul") {
+      matmul = ops::BatchMatMul(matmul_op, a, b);
+    }
+    Output trans = ops::Transpose(s.WithOpName("trans"), matmul, perm);
+    auto identity = ops::Identity(s.WithOpName("identity"), trans);
+
+    GrapplerItem item;
+    item.fetch = {"identity"};
+    TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+    auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+    ASSERT_EQ(tensors_expected.size(), 1);
+
+    ArithmeticOptimizer optimizer;
+    EnableOnlyFoldTransposeOfMatMul(&optimizer);
+    GraphDef output;
+    OptimizeTwice(&optimizer, &item, &output);
+    NodeMap node_map(&output);
+
+    EXPECT_EQ(output.node_size(), 7);
+
+    const string p = "ArithmeticOptimizer/FoldTransposeOfMatMul";
+    const string optimized_name = absl::StrCat(p, "_", "trans");
+
+    const NodeDef* folded_node = node_map.GetNode(optimized_name);
+    ASSERT_NE(folded_node, nullptr);
+    ASSERT_EQ(folded_node->input_size(), 2);
+    EXPECT_EQ(folded_node->input(0), "b");
+    EXPECT_EQ(folded_node->input(1), "a");
+
+    if (matmul_type == "BatchMatMul") {
+      EXPECT_TRUE(folded_node->attr().at("adj_x").b());
+      EXPECT_TRUE(folded_node->attr().at("adj_y").b());
+    } else {
+      EXPECT_TRUE(folded_node->attr().at("transpose_a").b());
+      EXPECT_TRUE(folded_node->attr().at("transpose_b").b());
+    }
+
+    const NodeDef* identity_node = node_map.GetNode("identity");
+    ASSERT_NE(identity_node, nullptr);
+    ASSERT_EQ(identity_node->input_size(), 1);
+    EXPECT_EQ(identity_node->input(0), optimized_name);
+
+    auto tensors = EvaluateNodes(output, item.fetch);
+    ASSERT_EQ(tensors.size(), 1);
+    test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+  }
+}
+
 TEST_F(ArithmeticOptimizerTest, FoldConjugateTransposeIntoBatchMatMul) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
 
@@ -3946,5 +4007,82 @@ TEST_F(ArithmeticOptimizerTest, SimplifyAggregationBFloat16) {
   test::ExpectTensorEqual<bfloat16>(tensors[0], tensors_expected[0]);
 }
 
+TEST_F(ArithmeticOptimizerTest, ReplaceOneHotMatMul) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto indices = ops::Const(s.WithOpName("indices"), {0, 2, 1, 3}, {4});
+  auto depth = ops::Const(s.WithOpName("depth"), 4);
+  auto on_value = ops::Const(s.WithOpName("on_value"), 1.0f);
+  auto off_value = ops::Const(s.WithOpName("off_value"), 0.0f);
+  auto one_hot =
+      ops::OneHot(s.WithOpName("one_hot"), indices, depth, on_value, off_value);
+  auto weights = ops::Const(s.WithOpName("weights"),
+                            {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f},
+                            {4, 2});
+  auto matmul = ops::MatMul(s.WithOpName("matmul"), one_hot, weights);
+  auto outputs = ops::Identity(s.WithOpName("outputs"), matmul);
+
+  GrapplerItem item;
+  item.fetch = {"outputs"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  EXPECT_EQ(1, tensors_expected.size());
+
+  GraphDef output;
+  ArithmeticOptimizer optimizer;
+  EnableOnlyReplaceOneHotMatMul(&optimizer);
+  OptimizeAndPrune(&optimizer, &item, &output);
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE("OneHot", node.op());
+    EXPECT_NE("MatMul", node.op());
+    if (node.op() == "GatherV2") {
+      found++;
+      ASSERT_EQ(3, node.input_size());
+      EXPECT_EQ("weights", node.input(0));
+      EXPECT_EQ("indices", node.input(1));
+    }
+  }
+  EXPECT_EQ(1, found);
+
+  auto tensors = EvaluateNodes(output, item.fetch);
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+}
+
+TEST_F(ArithmeticOptimizerTest, ReplaceOneHotMatMulSkipsTransposedMatMul) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  auto indices = ops::Const(s.WithOpName("indices"), {0, 2, 1, 3}, {4});
+  auto depth = ops::Const(s.WithOpName("depth"), 4);
+  auto on_value = ops::Const(s.WithOpName("on_value"), 1.0f);
+  auto off_value = ops::Const(s.WithOpName("off_value"), 0.0f);
+  auto one_hot =
+      ops::OneHot(s.WithOpName("one_hot"), indices, depth, on_value, off_value);
+  auto weights = ops::Const(s.WithOpName("weights"),
+                            {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f},
+                            {2, 4});
+  // The gather rewrite does not apply to a transposed weight matrix.
+  auto matmul = ops::MatMul(s.WithOpName("matmul"), one_hot, weights,
+                            ops::MatMul::TransposeB(true));
+  auto outputs = ops::Identity(s.WithOpName("outputs"), matmul);
+
+  GrapplerItem item;
+  item.fetch = {"outputs"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  EXPECT_EQ(1, tensors_expected.size());
+
+  GraphDef output;
+  ArithmeticOptimizer optimizer;
+  EnableOnlyReplaceOneHotMatMul(&optimizer);
+  OptimizeAndPrune(&optimizer, &item, &output);
+
+  VerifyGraphsMatch(item.graph, output, __LINE__);
+
+  auto tensors = EvaluateNodes(output, item.fetch);
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+}
+
 }  // namespace grappler
 }  // namespace tensorflow
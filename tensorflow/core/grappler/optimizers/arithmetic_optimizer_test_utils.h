@@ -81,6 +81,7 @@ class ArithmeticOptimizerTest : public GrapplerTest {
     options.fold_conjugate_into_transpose = false;
     options.fold_multiply_into_conv = false;
     options.fold_transpose_into_matmul = false;
+    options.fold_transpose_of_matmul = false;
     options.hoist_common_factor_out_of_aggregation = false;
     options.hoist_cwise_unary_chains = false;
     options.minimize_broadcasts = false;
@@ -123,6 +124,11 @@ class ArithmeticOptimizerTest : public GrapplerTest {
     optimizer->options_.fold_transpose_into_matmul = true;
   }
 
+  void EnableOnlyFoldTransposeOfMatMul(ArithmeticOptimizer* optimizer) {
+    DisableAllStages(optimizer);
+    optimizer->options_.fold_transpose_of_matmul = true;
+  }
+
   void EnableOnlyHoistCommonFactor(ArithmeticOptimizer* optimizer) {
     DisableAllStages(optimizer);
     optimizer->options_.hoist_common_factor_out_of_aggregation = true;
@@ -238,6 +244,11 @@ class ArithmeticOptimizerTest : public GrapplerTest {
     DisableAllStages(optimizer);
     optimizer->options_.remove_stack_strided_slice_same_axis = true;
   }
+
+  void EnableOnlyReplaceOneHotMatMul(ArithmeticOptimizer* optimizer) {
+    DisableAllStages(optimizer);
+    optimizer->options_.replace_onehot_matmul = true;
+  }
 };
 
 }  // end namespace grappler
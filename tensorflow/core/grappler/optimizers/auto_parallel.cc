@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/op_types.h"
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -61,6 +62,34 @@ NodeDef* AutoParallel::AddNodeDiv(const string& name, const string& input_a,
   return node;
 }
 
+NodeDef* AutoParallel::AddNodeNcclAllReduce(const string& name,
+                                            const string& input,
+                                            DataType dtype,
+                                            const string& shared_name,
+                                            GraphDef* graph) {
+  NodeDef* node = graph->add_node();
+  node->set_name(name);
+  node->set_op("NcclAllReduce");
+  node->add_input(input);
+
+  AttrValue attr_type;
+  attr_type.set_type(dtype);
+  node->mutable_attr()->insert({"T", attr_type});
+
+  AttrValue attr_reduction;
+  attr_reduction.set_s("sum");
+  node->mutable_attr()->insert({"reduction", attr_reduction});
+
+  AttrValue attr_num_devices;
+  attr_num_devices.set_i(num_replicas_);
+  node->mutable_attr()->insert({"num_devices", attr_num_devices});
+
+  AttrValue attr_shared_name;
+  attr_shared_name.set_s(shared_name);
+  node->mutable_attr()->insert({"shared_name", attr_shared_name});
+  return node;
+}
+
 NodeDef* AutoParallel::AddNodeControl(const string& name,
                                       const std::set<string>& deps,
                                       GraphDef* graph) {
@@ -76,6 +105,13 @@ NodeDef* AutoParallel::AddNodeControl(const string& name,
 Status AutoParallel::Initialize(const GrapplerItem& item) {
   num_gpus_ = GetNumAvailableGPUs();
   LOG(INFO) << "Number of GPUs: " << num_gpus_;
+  TF_CHECK_OK(
+      ReadBoolFromEnvVar("TF_GRAPPLER_AUTO_PARALLEL_NCCL", false, &use_nccl_));
+  if (use_nccl_ && num_gpus_ > 0 && num_gpus_ < num_replicas_) {
+    LOG(WARNING) << "NCCL gradient aggregation requested with "
+                 << num_replicas_ << " replicas but only " << num_gpus_
+                 << " GPUs; replicas will share devices.";
+  }
   item_ = &item;
   graph_ = item.graph;
   LOG(INFO) << "Original graph size: " << graph_.node_size();
@@ -174,6 +210,24 @@ Status AutoParallel::Initialize(const GrapplerItem& item) {
     dont_replicate_nodes.insert(NodeName(init));
   }
 
+  // With NCCL aggregation, each variable is updated once with the all-reduced
+  // gradient, so the update ops stay shared and colocated with the variables
+  // they update (which keeps any variable sharding intact).
+  if (use_nccl_) {
+    for (const auto& apply_gradient_node_name : apply_gradients_nodes_) {
+      DataType dtype =
+          all_nodes_[apply_gradient_node_name]->attr().at("T").type();
+      // NcclAllReduce only supports a subset of the types the update ops do.
+      if (dtype == DT_HALF || dtype == DT_FLOAT || dtype == DT_DOUBLE ||
+          dtype == DT_INT32 || dtype == DT_INT64) {
+        nccl_apply_nodes_.insert(apply_gradient_node_name);
+        dont_replicate_nodes.insert(apply_gradient_node_name);
+      }
+    }
+    LOG(INFO) << "Number of gradients aggregated with NCCL: "
+              << nccl_apply_nodes_.size();
+  }
+
   // Don't replicate all input nodes, except the dequeue node.
   for (const auto& input_node : input_nodes) {
     if (input_node->name() != dequeue_node->name()) {
@@ -240,8 +294,47 @@ void AutoParallel::BuildGraph(GraphDef* graph) {
   for (int i = 0; i < num_replicas_; i++) {
     AddOneReplica(graph, i);
   }
+
+  std::map<string, NodeDef*> new_nodes;
+  for (int i = 0; i < graph->node_size(); i++) {
+    new_nodes.insert(
+        std::make_pair(graph->node(i).name(), graph->mutable_node(i)));
+  }
+
   std::set<string> fetches;
+  // Rewire each replica's gradient through an all-reduce. The per-replica
+  // all-reduce nodes start as soon as their gradient is ready, so aggregation
+  // overlaps with the rest of the backward pass.
+  for (const auto& apply_gradient_node_name : nccl_apply_nodes_) {
+    DataType dtype =
+        all_nodes_[apply_gradient_node_name]->attr().at("T").type();
+    string shared_name = strings::StrCat(kAutoParallelPrefix, "-AllReduce-",
+                                         apply_gradient_node_name);
+    for (int i = 0; i < num_replicas_; i++) {
+      string prefix = strings::StrCat(kAutoParallelPrefix, "-Replica-", i);
+      string div_name = AddPrefixToNodeName(
+          strings::StrCat(kAutoParallelPrefix, "-Div-",
+                          apply_gradient_node_name),
+          prefix);
+      auto div_node = new_nodes[div_name];
+      auto all_reduce =
+          AddNodeNcclAllReduce(AddPrefixToNodeName(shared_name, prefix),
+                               div_node->input(0), dtype, shared_name, graph);
+      if (num_gpus_ > 0) {
+        all_reduce->set_device(strings::StrCat("/gpu:", i % num_gpus_));
+      }
+      *div_node->mutable_input(0) = all_reduce->name();
+      new_nodes.insert(std::make_pair(all_reduce->name(), all_reduce));
+      // An all-reduce completes only once every participant has launched, so
+      // all of them must be reachable from the fetch nodes.
+      fetches.insert(all_reduce->name());
+    }
+  }
+
   for (size_t i = 0; i < item_->fetch.size(); i++) {
+    if (!NotSharedNode(NodeName(item_->fetch[i]))) {
+      continue;
+    }
     for (int j = 0; j < num_replicas_; j++) {
       string prefix = strings::StrCat(kAutoParallelPrefix, "-Replica-", j);
       string fetch = AddPrefixToNodeName(item_->fetch[i], prefix);
@@ -253,7 +346,14 @@ void AutoParallel::BuildGraph(GraphDef* graph) {
   auto control = AddNodeControl(name_control, fetches, graph);
 
   for (const auto& fetch : item_->fetch) {
-    AddNodeControl(fetch, {control->name()}, graph);
+    if (NotSharedNode(NodeName(fetch))) {
+      AddNodeControl(fetch, {control->name()}, graph);
+    } else {
+      // Shared fetch nodes (e.g. the update ops under NCCL aggregation) keep
+      // their name; just make them wait for every replica to finish.
+      new_nodes[NodeName(fetch)]->add_input(
+          strings::StrCat("^", control->name()));
+    }
   }
   *graph->mutable_library() = item_->graph.library();
   *graph->mutable_versions() = item_->graph.versions();
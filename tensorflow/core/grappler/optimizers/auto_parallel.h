@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_AUTO_PARALLEL_H_
 #define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_AUTO_PARALLEL_H_
 
+#include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/framework/variable.pb.h"
 #include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -24,6 +25,10 @@ namespace tensorflow {
 namespace grappler {
 
 // Automatically parallelize a graph by splitting in the batch dimension.
+// When TF_GRAPPLER_AUTO_PARALLEL_NCCL is set, gradients are aggregated
+// across replicas with NcclAllReduce and each variable is updated once per
+// step with the averaged gradient; otherwise every replica applies its own
+// scaled partial gradient to the shared variables.
 class AutoParallel : public GraphOptimizer {
  public:
   AutoParallel(int num_replicas) : num_replicas_(num_replicas) {
@@ -43,15 +48,20 @@ class AutoParallel : public GraphOptimizer {
   GraphDef graph_;
   std::map<string, NodeDef*> all_nodes_;
   std::set<string> apply_gradients_nodes_;
+  std::set<string> nccl_apply_nodes_;
   std::set<string> replica_nodes_;
   std::set<string> shared_nodes_;
   const GrapplerItem* item_;
   int num_replicas_;
   int num_gpus_;
+  bool use_nccl_ = false;
   Status Initialize(const GrapplerItem& item);
   NodeDef* AddNodeDivConst();
   NodeDef* AddNodeDiv(const string& name, const string& input_a,
                       const string& input_b);
+  NodeDef* AddNodeNcclAllReduce(const string& name, const string& input,
+                                DataType dtype, const string& shared_name,
+                                GraphDef* graph);
   NodeDef* AddNodeControl(const string& name, const std::set<string>& deps,
                           GraphDef* graph);
   bool NotSharedNode(const string& name);
@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -126,6 +127,80 @@ TEST_F(AutoParallelTest, SimpleParallel) {
   EXPECT_EQ("^AutoParallel-Control-Fetch", node_gradient.input(0));
 }
 
+TEST_F(AutoParallelTest, NcclGradientAggregation) {
+  tensorflow::Scope s = tensorflow::Scope::DisabledShapeInferenceScope();
+  Output constant_a = ops::Const(s.WithOpName("constant_a"), 1.0f, {1});
+  Output constant_b = ops::Const(s.WithOpName("constant_b"), 1, {1});
+  Output var = ops::Variable(s.WithOpName("var"), {1}, DT_FLOAT);
+  Output assign = ops::Assign(s.WithOpName("assign"), {var}, {constant_a});
+  Output fifo_queue = ops::FIFOQueue(s.WithOpName("fifo_queue"), {DT_FLOAT});
+  auto dequeue = ops::QueueDequeueMany(s.WithOpName("dequeue"), {fifo_queue},
+                                       {constant_b}, {DT_FLOAT});
+  Output add = ops::AddN(s.WithOpName("add"), {constant_a, dequeue[0]});
+  Output learning_rate = ops::Const(s.WithOpName("learning_rate"), 0.01f, {1});
+  Output apply_gradient = ops::ApplyGradientDescent(
+      s.WithOpName("apply_gradient"), {var}, {learning_rate}, {add});
+
+  GrapplerItem item;
+  item.init_ops.push_back("assign");
+  item.fetch.push_back("apply_gradient");
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  setenv("TF_GRAPPLER_AUTO_PARALLEL_NCCL", "1", 1 /* overwrite */);
+  AutoParallel parallel(2);
+  GraphDef output;
+  Status status = parallel.Optimize(nullptr, item, &output);
+  unsetenv("TF_GRAPPLER_AUTO_PARALLEL_NCCL");
+  TF_EXPECT_OK(status);
+  EXPECT_EQ(20, output.node_size());
+
+  std::map<string, const NodeDef*> nodes;
+  for (const NodeDef& node : output.node()) {
+    nodes.insert(std::make_pair(node.name(), &node));
+  }
+
+  // The update op stays shared: it is applied once with the averaged
+  // all-reduced gradient from replica 0 and waits for every replica.
+  ASSERT_NE(nodes.end(), nodes.find("apply_gradient"));
+  const NodeDef& node_apply = *nodes["apply_gradient"];
+  EXPECT_EQ("ApplyGradientDescent", node_apply.op());
+  EXPECT_EQ("var", node_apply.input(0));
+  EXPECT_EQ("AutoParallel-Replica-0/AutoParallel-Div-apply_gradient",
+            node_apply.input(2));
+  EXPECT_EQ("^AutoParallel-Control-Fetch",
+            node_apply.input(node_apply.input_size() - 1));
+  EXPECT_EQ(nodes.end(), nodes.find("AutoParallel-Replica-0/apply_gradient"));
+
+  for (int i = 0; i < 2; i++) {
+    string prefix = strings::StrCat("AutoParallel-Replica-", i);
+    string all_reduce_name =
+        strings::StrCat(prefix, "/AutoParallel-AllReduce-apply_gradient");
+    ASSERT_NE(nodes.end(), nodes.find(all_reduce_name));
+    const NodeDef& node_all_reduce = *nodes[all_reduce_name];
+    EXPECT_EQ("NcclAllReduce", node_all_reduce.op());
+    EXPECT_EQ(strings::StrCat(prefix, "/add"), node_all_reduce.input(0));
+    EXPECT_EQ("sum", node_all_reduce.attr().at("reduction").s());
+    EXPECT_EQ(2, node_all_reduce.attr().at("num_devices").i());
+    EXPECT_EQ("AutoParallel-AllReduce-apply_gradient",
+              node_all_reduce.attr().at("shared_name").s());
+
+    const NodeDef& node_div =
+        *nodes[strings::StrCat(prefix, "/AutoParallel-Div-apply_gradient")];
+    EXPECT_EQ(all_reduce_name, node_div.input(0));
+  }
+
+  // Every all-reduce participant must be reachable from the fetch nodes.
+  const NodeDef& node_fetch = *nodes["AutoParallel-Control-Fetch"];
+  std::set<string> fetch_deps(node_fetch.input().begin(),
+                              node_fetch.input().end());
+  EXPECT_EQ(1, fetch_deps.count(
+                   "^AutoParallel-Replica-0/AutoParallel-AllReduce-"
+                   "apply_gradient"));
+  EXPECT_EQ(1, fetch_deps.count(
+                   "^AutoParallel-Replica-1/AutoParallel-AllReduce-"
+                   "apply_gradient"));
+}
+
 }  // namespace
 }  // namespace grappler
 }  // namespace tensorflow
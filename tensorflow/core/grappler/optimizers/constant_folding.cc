@@ -39,8 +39,10 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/evaluation_utils.h"
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/grappler/utils/symbolic_shapes.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/numbers.h"
@@ -52,6 +54,7 @@ limitations under the License.
 #include "tensorflow/core/platform/tensor_coding.h"
 #include "tensorflow/core/public/version.h"
 #include "tensorflow/core/util/bcast.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 
 namespace tensorflow {
@@ -1038,6 +1041,31 @@ bool IsValidConstShapeForMulConvPushDown(
   return false;
 }
 
+// Size budget for constants created by folding. Results that are larger than
+// both the folded inputs and this limit are rejected. The default keeps
+// graphdefs small, but large-but-worthwhile constant subgraphs (e.g.
+// normalization tables) can be folded at optimization time by raising the
+// budget through TF_GRAPPLER_CONSTANT_FOLDING_MAX_CONSTANT_SIZE (in bytes).
+int64 MaxConstantSizeInBytes() {
+  static const int64 max_size = [] {
+    int64 size;
+    TF_CHECK_OK(
+        ReadInt64FromEnvVar("TF_GRAPPLER_CONSTANT_FOLDING_MAX_CONSTANT_SIZE",
+                            10 * 1024 * 1024, &size));
+    return size;
+  }();
+  return max_size;
+}
+
+// Number of threads used to evaluate independent foldable nodes in parallel.
+// Anything below two keeps the evaluation sequential.
+int FoldEvaluationThreads() {
+  int64 num_threads;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRAPPLER_CONSTANT_FOLDING_THREADS", 1,
+                                  &num_threads));
+  return static_cast<int>(num_threads);
+}
+
 }  // namespace
 
 // static
@@ -1122,10 +1150,12 @@ Status ConstantFolding::CreateNodeDef(const string& name,
   }
   node->mutable_attr()->insert({"value", attr_tensor});
 
-  if (encoded_size > original_size && encoded_size >= 10 * 1024 * 1024) {
+  const int64 max_constant_size = MaxConstantSizeInBytes();
+  if (encoded_size > original_size &&
+      static_cast<int64>(encoded_size) >= max_constant_size) {
     return errors::InvalidArgument(
         strings::StrCat("Can't fold ", name, ", its size would be too large (",
-                        encoded_size, " >= ", 10 * 1024 * 1024, " bytes)"));
+                        encoded_size, " >= ", max_constant_size, " bytes)"));
   }
   return Status::OK();
 }
@@ -1303,7 +1333,13 @@ Status ConstantFolding::FoldNode(NodeDef* node, GraphDef* output_graph,
   TF_RETURN_IF_ERROR(
       EvaluateOneFoldable(*node, &const_nodes, result_too_large));
   VLOG(1) << "Folded node:\n" << node->DebugString();
+  return ReplaceFoldedNode(node, output_graph, &const_nodes);
+}
 
+Status ConstantFolding::ReplaceFoldedNode(NodeDef* node,
+                                          GraphDef* output_graph,
+                                          std::vector<NodeDef>* folded_nodes) {
+  std::vector<NodeDef>& const_nodes = *folded_nodes;
   NodeDef* constant_output = nullptr;
   for (int i = 0; i < const_nodes.size(); i++) {
     NodeDef* const_node = &const_nodes[i];
@@ -1418,34 +1454,122 @@ Status ConstantFolding::FoldGraph(
       queue.push_back(graph_->mutable_node(i));
     }
   }
+  const int num_threads = FoldEvaluationThreads();
   while (!queue.empty()) {
-    NodeDef* node = queue.front();
-    queue.pop_front();
-    if (processed_nodes.count(node->name())) {
+    // Give up on the remaining foldable nodes when we run out of time; the
+    // graph is in a consistent state after any prefix of the folding steps.
+    if (DeadlineExceeded()) {
+      VLOG(1) << "Interrupting constant folding: deadline exceeded with "
+              << queue.size() << " foldable node(s) left.";
+      break;
+    }
+
+    if (num_threads <= 1) {
+      NodeDef* node = queue.front();
+      queue.pop_front();
+      if (processed_nodes.count(node->name())) {
+        continue;
+      }
+      // We need to record a copy of output nodes before FoldNode() modifies
+      // it. We also need to ensure that the fanout is sorted
+      // deterministically.
+      const std::set<NodeDef*>& outputs = node_map_->GetOutputs(node->name());
+      std::vector<NodeDef*> fanout(outputs.begin(), outputs.end());
+      std::sort(fanout.begin(), fanout.end(),
+                [](const NodeDef* n1, const NodeDef* n2) {
+                  return n1->name() < n2->name();
+                });
+
+      bool result_too_large = false;
+      Status s = FoldNode(node, output, &result_too_large);
+      processed_nodes.insert(node->name());
+      if (!s.ok()) {
+        VLOG(1) << "Failed to fold node " << node->DebugString()
+                << "\nError message: " << s;
+        if (result_too_large) {
+          nodes_to_not_simplify->emplace(node->name());
+        }
+      } else {
+        for (auto& output : fanout) {
+          if (IsFoldable(*output)) {
+            queue.push_back(output);
+          }
+        }
+      }
       continue;
     }
-    // We need to record a copy of output nodes before FoldNode() modifies it.
-    // We also need to ensure that the fanout is sorted deterministically.
-    const std::set<NodeDef*>& outputs = node_map_->GetOutputs(node->name());
-    std::vector<NodeDef*> fanout(outputs.begin(), outputs.end());
-    std::sort(fanout.begin(), fanout.end(),
-              [](const NodeDef* n1, const NodeDef* n2) {
-                return n1->name() < n2->name();
-              });
-
-    bool result_too_large = false;
-    Status s = FoldNode(node, output, &result_too_large);
-    processed_nodes.insert(node->name());
-    if (!s.ok()) {
-      VLOG(1) << "Failed to fold node " << node->DebugString()
-              << "\nError message: " << s;
-      if (result_too_large) {
-        nodes_to_not_simplify->emplace(node->name());
+
+    // Batched evaluation: drain the queue into a batch of distinct nodes.
+    // All of them had constant inputs when they were enqueued and evaluation
+    // only reads the graph, so the batch can be evaluated concurrently. The
+    // graph rewrites are applied sequentially afterwards, in batch order, to
+    // keep the result deterministic.
+    std::vector<NodeDef*> batch;
+    std::unordered_set<string> batched_nodes;
+    while (!queue.empty()) {
+      NodeDef* node = queue.front();
+      queue.pop_front();
+      if (processed_nodes.count(node->name()) ||
+          !batched_nodes.insert(node->name()).second) {
+        continue;
       }
-    } else {
-      for (auto& output : fanout) {
-        if (IsFoldable(*output)) {
-          queue.push_back(output);
+      batch.push_back(node);
+    }
+
+    const int batch_size = batch.size();
+    std::vector<std::vector<NodeDef>> evaluated(batch_size);
+    std::vector<Status> statuses(batch_size);
+    std::vector<char> result_too_large(batch_size, 0);
+    {
+      thread::ThreadPool thread_pool(Env::Default(), "constant_folding",
+                                     std::min(num_threads, batch_size));
+      BlockingCounter barrier(batch_size);
+      for (int i = 0; i < batch_size; ++i) {
+        thread_pool.Schedule([this, &batch, &evaluated, &statuses,
+                              &result_too_large, &barrier, i]() {
+          NodeDef* node = batch[i];
+          // Merge nodes are folded without evaluation, in the apply phase.
+          if (!IsMerge(*node)) {
+            bool too_large = false;
+            statuses[i] = EvaluateOneFoldable(*node, &evaluated[i], &too_large);
+            result_too_large[i] = too_large;
+          }
+          barrier.DecrementCount();
+        });
+      }
+      barrier.Wait();
+    }
+
+    for (int i = 0; i < batch_size; ++i) {
+      NodeDef* node = batch[i];
+      const std::set<NodeDef*>& outputs = node_map_->GetOutputs(node->name());
+      std::vector<NodeDef*> fanout(outputs.begin(), outputs.end());
+      std::sort(fanout.begin(), fanout.end(),
+                [](const NodeDef* n1, const NodeDef* n2) {
+                  return n1->name() < n2->name();
+                });
+
+      Status s = statuses[i];
+      if (s.ok()) {
+        if (IsMerge(*node)) {
+          s = FoldMergeNode(node, output);
+        } else {
+          VLOG(1) << "Folded node:\n" << node->DebugString();
+          s = ReplaceFoldedNode(node, output, &evaluated[i]);
+        }
+      }
+      processed_nodes.insert(node->name());
+      if (!s.ok()) {
+        VLOG(1) << "Failed to fold node " << node->DebugString()
+                << "\nError message: " << s;
+        if (result_too_large[i]) {
+          nodes_to_not_simplify->emplace(node->name());
+        }
+      } else {
+        for (auto& output_node : fanout) {
+          if (IsFoldable(*output_node)) {
+            queue.push_back(output_node);
+          }
         }
       }
     }
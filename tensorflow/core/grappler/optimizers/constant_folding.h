@@ -83,6 +83,10 @@ class ConstantFolding : public GraphOptimizer {
   Status FoldMergeNode(NodeDef* node, GraphDef* output_graph);
   Status FoldNode(NodeDef* node, GraphDef* output_graph,
                   bool* result_too_large);
+  // Rewrites the graph to use the materialized values in 'folded_nodes' in
+  // place of 'node', as produced by EvaluateOneFoldable().
+  Status ReplaceFoldedNode(NodeDef* node, GraphDef* output_graph,
+                           std::vector<NodeDef>* folded_nodes);
 
   bool IsOnes(const NodeDef& node) const;
   bool IsZeros(const NodeDef& node) const;
@@ -252,6 +252,50 @@ TEST_F(ConstantFoldingTest, SimpleFolding) {
   test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
 }
 
+TEST_F(ConstantFoldingTest, BatchedFoldEvaluation) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  // Two independent foldable subexpressions feeding a third one.
+  Output a = ops::Const(s.WithOpName("a"), 1.0f, {16});
+  Output b = ops::Const(s.WithOpName("b"), 2.0f, {16});
+  Output add = ops::Add(s.WithOpName("add"), a, b);
+  Output mul = ops::Mul(s.WithOpName("mul"), a, b);
+  Output sub = ops::Sub(s.WithOpName("sub"), add, mul);
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape(TensorShape({16})));
+  Output out = ops::Add(s.WithOpName("out"), x, sub);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"out"};
+
+  GraphDef sequential_output;
+  {
+    ConstantFolding optimizer(/*cpu_device=*/nullptr);
+    TF_EXPECT_OK(
+        optimizer.Optimize(/*cluster=*/nullptr, item, &sequential_output));
+  }
+
+  // Evaluate batches of independent foldable nodes on a thread pool.
+  setenv("TF_GRAPPLER_CONSTANT_FOLDING_THREADS", "4", 1 /* overwrite */);
+  GraphDef output;
+  {
+    ConstantFolding optimizer(/*cpu_device=*/nullptr);
+    const Status status = optimizer.Optimize(/*cluster=*/nullptr, item, &output);
+    unsetenv("TF_GRAPPLER_CONSTANT_FOLDING_THREADS");
+    TF_EXPECT_OK(status);
+  }
+
+  // Batched evaluation must be deterministic and match the sequential result.
+  CompareGraphs(sequential_output, output);
+
+  auto x_t = GenerateRandomTensor<DT_FLOAT>(TensorShape({16}));
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, {{"x", x_t}});
+  auto tensors = EvaluateNodes(output, item.fetch, {{"x", x_t}});
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
+}
+
 TEST_F(ConstantFoldingTest, AddTree) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
 
@@ -568,7 +568,7 @@ class NodeProcessor : public GraphProcessor {
     return nodes_to_preserve_.find(node_->name()) != nodes_to_preserve_.end();
   }
 
-  bool IsOnGPU() const {
+  bool IsOnDevice(const char* device_type) const {
     string device_name;
     if (node_->device().empty()) {
       device_name = virtual_placer_.get_canonical_device_name(*node_);
@@ -579,15 +579,38 @@ class NodeProcessor : public GraphProcessor {
     string not_used;
     if (DeviceNameUtils::SplitDeviceName(device_name, &not_used, &device) &&
         str_util::StrContains(str_util::Lowercase(device),
-                              str_util::Lowercase(DEVICE_GPU))) {
+                              str_util::Lowercase(device_type))) {
       return true;
     }
     return false;
   }
 
+  bool IsOnGPU() const { return IsOnDevice(DEVICE_GPU); }
+
+  bool IsOnCPU() const { return IsOnDevice(DEVICE_CPU); }
+
+  // Whether the node runs on a device whose kernels prefer the NCHW layout.
+  // This is always the case on GPU. On CPU it depends on the build: with
+  // MKL-DNN, the MKL layout pass keeps NCHW tensors in blocked (NCHWc)
+  // layouts between the rewritten _Mkl* kernels and converts back to a
+  // TensorFlow layout only at the boundaries of the rewritten subgraph, so
+  // converting the graph to NCHW here removes the per-op layout shuffles
+  // that NHWC would otherwise cause. Without MKL-DNN most CPU kernels only
+  // support NHWC, so we leave the graph alone.
+  bool PrefersNCHW() const {
+    if (IsOnGPU()) {
+      return true;
+    }
+#ifdef INTEL_MKL
+    return IsOnCPU();
+#else
+    return false;
+#endif
+  }
+
   virtual bool ShouldProcess() const {
     return !MustPreserve() && IsNHWC() && IsPortZeroDimsFour(*node_) &&
-           HasOutputs() && IsOnGPU();
+           HasOutputs() && PrefersNCHW();
   }
 
   virtual void UpdateAttrShape() {
@@ -1025,7 +1048,7 @@ class BiasAddGradProcessor : public NodeProcessor {
     if (MustPreserve()) {
       return false;
     }
-    if (!IsOnGPU()) {
+    if (!PrefersNCHW()) {
       return false;
     }
     auto input = node_map_->GetNode(node_->input(0));
@@ -1050,7 +1073,7 @@ class Conv2DProcessor : public NodeProcessor {
  protected:
   bool ShouldProcess() const override {
     return !MustPreserve() && IsNHWC() && IsPortZeroDimsFour(*node_) &&
-           HasOutputs() && (!IsGemmUsed() || no_gemm_) && IsOnGPU();
+           HasOutputs() && (!IsGemmUsed() || no_gemm_) && PrefersNCHW();
   }
 
   TensorShapeProto GetShape(const string& input_name) const {
@@ -1212,7 +1235,7 @@ class MaxPoolV2Processor : public NodeProcessor {
     int port;
     ParseNodeName(node_->input(0), &port);
     return !MustPreserve() && IsNHWC() && IsPortDimsFour(*data_input, port) &&
-           HasOutputs() && IsOnGPU();
+           HasOutputs() && PrefersNCHW();
   }
 
   Status CustomizedProcessing() override {
@@ -1232,7 +1255,7 @@ class AgnosticNodeProcessor : public NodeProcessor {
  protected:
   bool ShouldProcess() const override {
     return !MustPreserve() && IsPortZeroDimsFour(*node_) && HasOutputs() &&
-           IsNodeAfterNCHWToNHWC() && IsOnGPU();
+           IsNodeAfterNCHWToNHWC() && PrefersNCHW();
   }
 
   bool IsNodeAfterNCHWToNHWC(const NodeDef& node) const {
@@ -1298,7 +1321,7 @@ class BinaryOpProcessor : public AgnosticNodeProcessor {
            (IsNDOperateWithMD(4, 0) || IsNDOperateWithMD(4, 1) ||
             IsNDOperateWithMD(4, 4) || IsNDOperateWithMD(0, 4) ||
             IsNDOperateWithMD(1, 4)) &&
-           IsOnGPU();
+           PrefersNCHW();
   }
 
   std::vector<int> GetInputPos() const override {
@@ -1473,7 +1496,7 @@ class HistogramSummaryProcessor : public AgnosticNodeProcessor {
     int port;
     ParseNodeName(node_->input(1), &port);
     return !MustPreserve() && HasOutputs() && IsNodeAfterNCHWToNHWC() &&
-           IsPortDimsFour(*input1, port) && IsOnGPU();
+           IsPortDimsFour(*input1, port) && PrefersNCHW();
   }
 
   std::vector<int> GetInputPos() const override { return {1}; }
@@ -1506,7 +1529,7 @@ class IdentityNProcessor : public AgnosticNodeProcessor {
  protected:
   bool ShouldProcess() const override {
     return !MustPreserve() && HasOutputs() && IsNodeAfterNCHWToNHWC() &&
-           IsOnGPU();
+           PrefersNCHW();
   }
 
   std::vector<int> GetInputPos() const override { return input_pos_; }
@@ -1544,7 +1567,7 @@ class MergeProcessor : public AgnosticNodeProcessor {
  protected:
   bool ShouldProcess() const override {
     return !MustPreserve() && IsPortZeroDimsFour(*node_) && HasOutputs() &&
-           IsEveryInputAfterNCHWToNHWC() && IsOnGPU();
+           IsEveryInputAfterNCHWToNHWC() && PrefersNCHW();
   }
 
   std::vector<int> GetInputPos() const override {
@@ -1804,7 +1827,7 @@ class SqueezeProcessor : public AgnosticNodeProcessor {
     bool is_dims_supported = (IsPortZeroDimsN(*node_, 2) && IsAlongHW()) ||
                              (IsPortZeroDimsN(*node_, 1) && IsAlongNHW());
     return !MustPreserve() && HasOutputs() && IsNodeAfterNCHWToNHWC() &&
-           IsInputConvertible() && is_dims_supported && IsOnGPU();
+           IsInputConvertible() && is_dims_supported && PrefersNCHW();
   }
 
   Status AddLayoutTransposeToOutputs() override { return Status::OK(); }
@@ -1874,7 +1897,7 @@ class ReduceProcessor : public AgnosticNodeProcessor {
     ParseNodeName(node_->input(0), &port);
     return !MustPreserve() && HasOutputs() && IsNodeAfterNCHWToNHWC() &&
            IsPortDimsFour(*input0, port) && IsReduceAxisSupported() &&
-           IsOnGPU();
+           PrefersNCHW();
   }
 
   Status CustomizedProcessing() override {
@@ -2202,9 +2225,16 @@ Status LayoutOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   }
 
   if (GetNumGPUs(*cluster) < 1) {
-    // LayoutOptimizer is currently only tuned for GPU.
+#ifndef INTEL_MKL
+    // Without MKL-DNN, LayoutOptimizer is only tuned for GPU.
     *output = item.graph;
     return Status::OK();
+#else
+    // With MKL-DNN, converting CPU graphs to NCHW pays off as well: the MKL
+    // layout pass carries NCHW tensors in blocked (NCHWc) layouts between
+    // _Mkl* kernels, with conversions only at the subgraph boundaries.
+    VLOG(1) << "No GPU available: tuning layouts for MKL-DNN on CPU.";
+#endif
   }
 
   virtual_placer_.reset(new VirtualPlacer(cluster->GetDevices()));
@@ -502,7 +502,12 @@ TEST_F(LayoutOptimizerTest, CPUDeviceLowercase) {
   Status status = optimizer.Optimize(virtual_cluster_.get(), item, &output);
   NodeMap node_map(&output);
   auto conv_node = node_map.GetNode("Conv2D");
+#ifdef INTEL_MKL
+  // With MKL-DNN, CPU convolutions prefer NCHW as well.
+  EXPECT_EQ(conv_node->attr().at({"data_format"}).s(), "NCHW");
+#else
   EXPECT_EQ(conv_node->attr().at({"data_format"}).s(), "NHWC");
+#endif
 }
 
 TEST_F(LayoutOptimizerTest, CPUDeviceUppercase) {
@@ -516,7 +521,11 @@ TEST_F(LayoutOptimizerTest, CPUDeviceUppercase) {
   Status status = optimizer.Optimize(virtual_cluster_.get(), item, &output);
   NodeMap node_map(&output);
   auto conv_node = node_map.GetNode("Conv2D");
+#ifdef INTEL_MKL
+  EXPECT_EQ(conv_node->attr().at({"data_format"}).s(), "NCHW");
+#else
   EXPECT_EQ(conv_node->attr().at({"data_format"}).s(), "NHWC");
+#endif
 }
 
 TEST_F(LayoutOptimizerTest, FusedBatchNormGradTrainingTrue) {
@@ -26,9 +26,12 @@ limitations under the License.
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/tensor.pb.h"  // NOLINT
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/grappler/clusters/virtual_cluster.h"
 #include "tensorflow/core/grappler/costs/graph_memory.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/costs/op_context.h"
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
 #include "tensorflow/core/grappler/costs/utils.h"
 #include "tensorflow/core/grappler/graph_topology_view.h"
 #include "tensorflow/core/grappler/grappler_item.h"
@@ -67,6 +70,59 @@ std::unordered_set<string> GetCheapToRecomputeOps() {
   return cheap_ops;
 }
 
+// Estimated effective PCIe bandwidth available for host<->device transfers.
+constexpr double kSwapBandwidthBytesPerNanosecond = 12.0;  // ~12 GB/s
+
+// Returns true if recomputing 'node' is estimated to be cheaper than moving
+// its outputs to host memory and back over PCIe when memory is tight.
+bool IsCheaperToRecomputeThanSwap(
+    const NodeDef& node, const GraphProperties& properties,
+    const std::unordered_map<string, DeviceProperties>& devices,
+    const OpLevelCostEstimator& estimator) {
+  // Stateful ops can't be recomputed, and recomputing a placeholder would
+  // leave the copy unfed.
+  if (!IsFreeOfSideEffect(node) || IsPlaceholder(node)) {
+    return false;
+  }
+  if (!properties.HasOutputProperties(node.name())) {
+    return false;
+  }
+  OpContext op_context;
+  op_context.op_info.set_op(node.op());
+  *op_context.op_info.mutable_attr() = node.attr();
+  for (const auto& input : properties.GetInputProperties(node.name())) {
+    *op_context.op_info.add_inputs() = input;
+  }
+  int64 output_bytes = 0;
+  for (const auto& output : properties.GetOutputProperties(node.name())) {
+    *op_context.op_info.add_outputs() = output;
+    if (output.shape().unknown_rank()) {
+      return false;
+    }
+    int64 bytes = DataTypeSize(BaseType(output.dtype()));
+    for (const auto& dim : output.shape().dim()) {
+      if (dim.size() < 0) {
+        return false;
+      }
+      bytes *= dim.size();
+    }
+    output_bytes += bytes;
+  }
+  auto it = devices.find(node.device());
+  if (it != devices.end()) {
+    *op_context.op_info.mutable_device() = it->second;
+  }
+  Costs costs = estimator.PredictCosts(op_context);
+  if (costs.inaccurate) {
+    return false;
+  }
+  // A swapped tensor crosses the PCIe bus twice: out after it is produced,
+  // and back in before its deferred uses.
+  const double swap_time_ns =
+      2.0 * output_bytes / kSwapBandwidthBytesPerNanosecond;
+  return static_cast<double>(costs.compute_time.count()) < swap_time_ns;
+}
+
 // Find recomputable ops which feed into target nodes.
 std::unordered_set<const NodeDef*> FindCandidateRecomputeNodes(
     const NodeMap& node_map, const GraphDef* graph,
@@ -422,7 +478,8 @@ void RecomputeSubgraph(
 
 void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
                                 const string& recomputation_targets_name_scope,
-                                GraphDef* graph, const GrapplerItem& item) {
+                                GraphDef* graph, const GrapplerItem& item,
+                                Cluster* cluster) {
   if (optimization_level != RewriterConfig::RECOMPUTATION_HEURISTICS &&
       optimization_level != RewriterConfig::HEURISTICS &&
       optimization_level != RewriterConfig::MANUAL) {
@@ -464,12 +521,26 @@ void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
     // separated by identity ops).
     std::unordered_set<string> cheap_to_recompute_ops =
         GetCheapToRecomputeOps();
+    // Refine the static op list with a cost model when we know enough about
+    // the graph and the devices: any op whose recompute cost is below the
+    // PCIe round-trip cost of swapping its outputs becomes a candidate.
+    GraphProperties properties(item);
+    OpLevelCostEstimator estimator;
+    std::unordered_map<string, DeviceProperties> devices;
+    bool use_cost_model = false;
+    if (cluster != nullptr && properties.InferStatically(false).ok()) {
+      devices = cluster->GetDevices();
+      use_cost_model = true;
+    }
     recomputed_subgraphs = GetOpGroupsToRecompute(
         graph, node_map,
-        [&cheap_to_recompute_ops, &feeds, &is_target](const NodeDef& node) {
+        [&cheap_to_recompute_ops, &feeds, &is_target, &properties, &devices,
+         &estimator, use_cost_model](const NodeDef& node) {
           return !is_target(node) && feeds.count(node.name()) == 0 &&
                  (cheap_to_recompute_ops.count(node.op()) > 0 ||
-                  node.attr().count(kRecomputeHint) > 0);
+                  node.attr().count(kRecomputeHint) > 0 ||
+                  (use_cost_model && IsCheaperToRecomputeThanSwap(
+                                         node, properties, devices, estimator)));
         },
         is_target);
   } else if (optimization_level == RewriterConfig::MANUAL) {
@@ -1342,7 +1413,7 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
 
   RecomputationRewritingPass(optimization_level_,
                              recomputation_targets_name_scope_,
-                             &optimized_item.graph, item);
+                             &optimized_item.graph, item, cluster);
 
   std::unordered_set<string> skip_list;
   // Bound the number of rewrite passes to avoid long processing times on graphs
@@ -447,6 +447,43 @@ TEST_F(MemoryOptimizerTest, AccumulationRewrites) {
   }
 }
 
+TEST_F(MemoryOptimizerTest, CostModelBasedRecomputation) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  // Identity is not on the static cheap-op list, so without a cost model the
+  // heuristics leave this graph alone.
+  Output a = ops::Variable(s.WithOpName("a"), {2, 3, 4}, DT_FLOAT);
+  Output b = ops::Identity(s.WithOpName("b"), a);  // Recomputed
+  Output c = ops::Identity(s.WithOpName("c"), b);
+  Output d = ops::AddN(s.WithOpName("gradients/d"), {c});
+  Output e = ops::AddN(s.WithOpName("gradients/e"), {d, b});
+  Output f = ops::AddN(s.WithOpName("gradients/f"), {e, a});
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  EXPECT_EQ(6, item.graph.node_size());
+
+  // Without a cluster there is no cost model, so nothing gets rewritten.
+  MemoryOptimizer no_cluster_optimizer(
+      RewriterConfig::RECOMPUTATION_HEURISTICS);
+  GraphDef unchanged;
+  TF_EXPECT_OK(no_cluster_optimizer.Optimize(nullptr, item, &unchanged));
+  EXPECT_EQ(6, unchanged.node_size());
+
+  // With device information, recomputing the cheap identities is estimated to
+  // be faster than swapping their outputs, so they become candidates. The
+  // stateful variable 'a' must not.
+  std::unique_ptr<VirtualCluster> cluster(CreateVirtualCluster());
+  MemoryOptimizer optimizer(RewriterConfig::RECOMPUTATION_HEURISTICS);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(cluster.get(), item, &output));
+
+  NodeMap post_transform_node_map(&output);
+  EXPECT_NE(post_transform_node_map.GetNode("Recomputed/b"), nullptr);
+  EXPECT_NE(post_transform_node_map.GetNode("RecomputeTrigger/b"), nullptr);
+  EXPECT_EQ(post_transform_node_map.GetNode("Recomputed/a"), nullptr);
+}
+
 class RelaxAllocatorConstraintsTest : public GrapplerTest {};
 
 TEST_F(RelaxAllocatorConstraintsTest, SameDevice) {
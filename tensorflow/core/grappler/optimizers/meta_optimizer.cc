@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/graph_constructor.h"
 #include "tensorflow/core/grappler/clusters/virtual_cluster.h"
+#include "tensorflow/core/grappler/costs/graph_properties.h"
 #include "tensorflow/core/grappler/optimizers/arithmetic_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/auto_mixed_precision.h"
 #include "tensorflow/core/grappler/optimizers/auto_parallel.h"
@@ -45,9 +46,13 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/topological_sort.h"
 #include "tensorflow/core/grappler/utils/tpu.h"
 #include "tensorflow/core/grappler/verifiers/structure_verifier.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
@@ -85,6 +90,27 @@ bool IsRunOnceOptimizer(const string& name) {
          name == "loop_optimizer" || name == "auto_mixed_precision";
 }
 
+// Whether to keep re-running the cheap simplification passes after the main
+// iterations until the graph stops changing. FunctionOptimizer inlines
+// functions after most passes have already seen the graph, and defun-heavy
+// models instantiate the same subgraph in every inlined function body, so a
+// fixed number of iterations can leave substantial duplicate compute behind.
+bool PostInliningFixpointEnabled() {
+  bool enabled = false;
+  TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRAPPLER_POST_INLINING_FIXPOINT", false,
+                                 &enabled));
+  return enabled;
+}
+
+// Number of threads used to optimize independent function bodies in parallel.
+// Anything below two keeps the optimization sequential.
+int FunctionOptimizationThreads() {
+  int64 num_threads = 1;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS",
+                                  1, &num_threads));
+  return static_cast<int>(num_threads);
+}
+
 uint64 DeadlineMicroSeconds(const RewriterConfig& cfg) {
   const uint64 kFiveMinutesInUsec = 5 * 60 * 1000 * 1000;
   if (cfg.meta_optimizer_timeout_ms() < 0) {
@@ -429,6 +455,46 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
     }
   }
 
+  // Re-run the dedup/folding passes to fixpoint on the inlined graph when
+  // requested. The rounds are bounded both by a fixed cap and by the meta
+  // optimizer deadline.
+  if (PostInliningFixpointEnabled()) {
+    std::vector<std::unique_ptr<GraphOptimizer>> cleanup;
+    if (cfg_.constant_folding() != RewriterConfig::OFF) {
+      cleanup.push_back(
+          MakeUnique<ConstantFolding>(cfg_.constant_folding(), cpu_device_));
+    }
+    if (cfg_.arithmetic_optimization() != RewriterConfig::OFF) {
+      cleanup.push_back(
+          MakeUnique<ArithmeticOptimizer>(cfg_.arithmetic_optimization()));
+    }
+    if (cfg_.dependency_optimization() != RewriterConfig::OFF) {
+      cleanup.push_back(
+          MakeUnique<DependencyOptimizer>(cfg_.dependency_optimization()));
+    }
+    if (!cfg_.disable_model_pruning()) {
+      cleanup.push_back(MakeUnique<ModelPruner>());
+    }
+    constexpr int kMaxCleanupRounds = 10;
+    for (int round = 0; round < kMaxCleanupRounds && !cleanup.empty();
+         ++round) {
+      const int num_nodes_before = optimized_graph->node_size();
+      const int64 num_edges_before = NumEdges(*optimized_graph);
+      for (const auto& optimizer : cleanup) {
+        GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
+        TF_RETURN_IF_ERROR(RunOptimizer(optimizer.get(), cluster,
+                                        &optimized_item, optimized_graph,
+                                        &optimization_result));
+      }
+      if (optimized_graph->node_size() == num_nodes_before &&
+          NumEdges(*optimized_graph) == num_edges_before) {
+        VLOG(1) << "Post-inlining cleanup converged after " << round + 1
+                << " round(s)";
+        break;
+      }
+    }
+  }
+
   // Run fusion optimizer if requested after all other optimizers since: 1) it
   // doesn't need to be called more than once. 2) we don't want subsequent
   // optimization passes to break the fusion clusters. We could potentially
@@ -456,7 +522,10 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
                                    }) != optimization_result.results.end();
 
   // Record graph optimization result.
-  optimization_results_.push_back(optimization_result);
+  {
+    mutex_lock lock(optimization_results_mu_);
+    optimization_results_.push_back(optimization_result);
+  }
 
   if (is_optimized) {
     TF_RETURN_IF_ERROR(TopologicalSort(optimized_graph));
@@ -473,6 +542,7 @@ Status MetaOptimizer::RunOptimizer(
     GraphOptimizer* optimizer, Cluster* cluster, GrapplerItem* optimized_item,
     GraphDef* optimized_graph, GraphOptimizationResult* optimization_result) {
   uint64 start_us = Env::Default()->NowMicros();
+  int64 inference_start_us = GraphProperties::CumulativeInferenceTimeUs();
   // This swaps the current optimized_graph into optimized item and
   // resets optimized_graph to an empty graph.
   optimized_graph->Swap(&optimized_item->graph);
@@ -482,6 +552,9 @@ Status MetaOptimizer::RunOptimizer(
       optimizer->Optimize(cluster, *optimized_item, optimized_graph);
   uint64 end_us = Env::Default()->NowMicros();
   float duration_ms = (end_us - start_us) / 1000.0f;
+  float inference_ms =
+      (GraphProperties::CumulativeInferenceTimeUs() - inference_start_us) /
+      1000.0f;
 
   string message;
   if (!status.ok()) {
@@ -497,7 +570,8 @@ Status MetaOptimizer::RunOptimizer(
   } else {
     message = strings::StrCat(
         PrintSizesBeforeAfter(optimized_item->graph, *optimized_graph),
-        ", time = ", duration_ms, "ms.");
+        ", time = ", duration_ms, "ms (shape inference ", inference_ms,
+        "ms).");
     VLOG(1) << optimizer->name() << ": " << message;
   }
 
@@ -512,7 +586,10 @@ Status MetaOptimizer::RunOptimizer(
 Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
                                GraphDef* optimized_graph) {
   VLOG(1) << "Starting optimization for grappler item: " << item.id;
-  optimization_results_.clear();
+  {
+    mutex_lock lock(optimization_results_mu_);
+    optimization_results_.clear();
+  }
 
   // Constructs a FunctionLibraryDefinition with functions that are reachable
   // from the nodes of the graph.
@@ -575,12 +652,17 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   bool optimize_function_library =
       item.optimization_options().optimize_function_library;
 
+  // Function bodies are independent subgraphs, so they can be optimized in
+  // parallel and merged back in library order to keep the result
+  // deterministic.
+  const int function_optimization_threads = FunctionOptimizationThreads();
+
   while (optimize_function_library) {
     optimize_function_library = false;
 
+    // Collect the functions to optimize in this round, in library order.
+    std::vector<const FunctionDef*> funcs_to_optimize;
     for (const FunctionDef& func : optimized_graph->library().function()) {
-      GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
-
       const string& func_name = func.signature().name();
 
       // Skip functions that are not reachable from the optimized graph.
@@ -595,17 +677,34 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       // the function optimizer, before we can optimize function body.
       if (IsParametrized(func)) continue;
 
-      VLOG(3) << "Optimize function: function=" << func_name;
-
       // Function optimization might specialize nested function calls, so we
       // have to reset the flag and do at least one more pass over the library.
       optimize_function_library = true;
       optimized_funcs.insert(func_name);
+      funcs_to_optimize.push_back(&func);
+    }
+
+    const int num_funcs = funcs_to_optimize.size();
+    std::vector<GrapplerFunctionItem> func_items(num_funcs);
+    std::vector<GraphDef> optimized_func_graphs(num_funcs);
+    std::vector<Status> statuses(num_funcs);
+
+    // Optimizes the body of funcs_to_optimize[i] into
+    // optimized_func_graphs[i]. Only reads the shared state (flib, the
+    // optimized graph and the library), so invocations for different
+    // functions are safe to run concurrently.
+    const auto optimize_function = [&](int i) {
+      const FunctionDef& func = *funcs_to_optimize[i];
+      const string& func_name = func.signature().name();
+      GrapplerFunctionItem& func_item = func_items[i];
+      Status& status = statuses[i];
+
+      VLOG(3) << "Optimize function: function=" << func_name;
 
       // Make a GrapplerItem from a FunctionDef.
-      GrapplerFunctionItem func_item;
-      TF_RETURN_IF_ERROR(MakeGrapplerFunctionItem(
-          func, flib, trimmed_item.graph.versions().producer(), &func_item));
+      status = MakeGrapplerFunctionItem(
+          func, flib, trimmed_item.graph.versions().producer(), &func_item);
+      if (!status.ok()) return;
 
       // If we need to compute the gradient of optimized function at runtime, we
       // can't perform non-differentiable rewrites.
@@ -617,7 +716,8 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       // available to the main graph, because after partitioning the function
       // call node might execute on a remote worker.
       if (!func_item.devices().empty()) {
-        return errors::Internal("GrapplerFunctionItem devices must be empty.");
+        status = errors::Internal("GrapplerFunctionItem devices must be empty.");
+        return;
       }
 
       // We are not allowed to prune certain types of ops from the graph
@@ -647,7 +747,6 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       }
 
       // Optimize function body graph.
-      GraphDef optimized_func_graph;
       if (IsTPUGraphDef(*optimized_graph)) {
         // Skip optimizing functions if this is a TPU graph. Currently, Grappler
         // passes do not handle TPU functions correctly in a variety of ways
@@ -661,12 +760,39 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
         // implementation selector what is required to swap in some TPU specific
         // lowering code and is verified the work correctly on TPUs.
         ImplementationSelector implementation_selector;
-        TF_RETURN_IF_ERROR(implementation_selector.Optimize(
-            cluster, func_item, &optimized_func_graph));
+        status = implementation_selector.Optimize(cluster, func_item,
+                                                  &optimized_func_graphs[i]);
       } else {
-        TF_RETURN_IF_ERROR(
-            OptimizeGraph(cluster, func_item, &optimized_func_graph));
+        status = OptimizeGraph(cluster, func_item, &optimized_func_graphs[i]);
       }
+    };
+
+    if (function_optimization_threads > 1 && num_funcs > 1) {
+      thread::ThreadPool thread_pool(
+          Env::Default(), "grappler_function_optimization",
+          std::min(function_optimization_threads, num_funcs));
+      BlockingCounter barrier(num_funcs);
+      for (int i = 0; i < num_funcs; ++i) {
+        thread_pool.Schedule([&optimize_function, &barrier, i]() {
+          optimize_function(i);
+          barrier.DecrementCount();
+        });
+      }
+      barrier.Wait();
+    } else {
+      for (int i = 0; i < num_funcs; ++i) {
+        GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
+        optimize_function(i);
+      }
+    }
+
+    // Merge the optimized bodies back into the library in library order, so
+    // the result does not depend on the completion order of the workers.
+    for (int i = 0; i < num_funcs; ++i) {
+      TF_RETURN_IF_ERROR(statuses[i]);
+      const string& func_name = funcs_to_optimize[i]->signature().name();
+      GrapplerFunctionItem& func_item = func_items[i];
+      GraphDef& optimized_func_graph = optimized_func_graphs[i];
 
       // Function body optimization might have created new specialized
       // functions for each instantiation context. Add them to the library.
@@ -705,6 +831,7 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
 }
 
 void MetaOptimizer::PrintResult() {
+  mutex_lock lock(optimization_results_mu_);
   for (const GraphOptimizationResult& graph_result : optimization_results_) {
     LOG(INFO) << "Optimization results for grappler item: " << graph_result.id;
     for (const OptimizerResult& result : graph_result.results) {
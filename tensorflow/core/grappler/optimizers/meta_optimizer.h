@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
 #include "tensorflow/core/grappler/verifiers/graph_verifier.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 #include "tensorflow/core/protobuf/verifier_config.pb.h"
@@ -96,7 +97,11 @@ class MetaOptimizer : public GraphOptimizer {
                       GrapplerItem* optimized_item, GraphDef* optimized_graph,
                       GraphOptimizationResult* optimization_result);
 
-  std::vector<GraphOptimizationResult> optimization_results_;
+  // Function bodies may be optimized concurrently, so recording their
+  // optimization results requires synchronization.
+  mutex optimization_results_mu_;
+  std::vector<GraphOptimizationResult> optimization_results_
+      GUARDED_BY(optimization_results_mu_);
 };
 
 bool MetaOptimizerEnabled(const ConfigProto& cfg);
@@ -212,6 +212,26 @@ TEST_F(MetaOptimizerTest, RunOptimizersTwice) {
   TF_EXPECT_OK(status);
 }
 
+TEST_F(MetaOptimizerTest, PostInliningFixpoint) {
+  TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {"CPU:0"});
+  GrapplerItem item;
+  CHECK(fake_input.NextItem(&item));
+
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::TWO);
+  rewriter_config.set_min_graph_nodes(-1);
+
+  // Re-run the dedup/folding passes to fixpoint after the main iterations.
+  setenv("TF_GRAPPLER_POST_INLINING_FIXPOINT", "1", 1 /* overwrite */);
+  MetaOptimizer optimizer(nullptr, config_proto);
+  GraphDef output;
+  const Status status = optimizer.Optimize(nullptr, item, &output);
+  unsetenv("TF_GRAPPLER_POST_INLINING_FIXPOINT");
+  TF_EXPECT_OK(status);
+}
+
 TEST_F(MetaOptimizerTest, RunToggleOptimizersAndCustomGraphOptimizerTwice) {
   TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {"CPU:0"});
   GrapplerItem item;
@@ -404,6 +424,80 @@ TEST_F(MetaOptimizerTest, OptimizeFunctionLibrary) {
   test::ExpectTensorEqual<int>(tensors_expected[1], tensors[1]);
 }
 
+TEST_F(MetaOptimizerTest, OptimizeFunctionLibraryInParallel) {
+  using test::function::NDef;
+
+  // Enable only function optimization.
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::TWO);
+  rewriter_config.set_function_optimization(RewriterConfig::ON);
+  rewriter_config.add_optimizers("function");
+  rewriter_config.set_min_graph_nodes(-1);
+
+  // Optimize independent function bodies on a thread pool.
+  setenv("TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS", "4", 1 /* overwrite */);
+  MetaOptimizer optimizer(nullptr, config_proto);
+
+  // Two unrelated functions called from the main graph.
+  FunctionDef square_func = FunctionDefHelper::Create(
+      "MySquare", {"x:T"}, {"z:T"}, {"T: {float, double}"},
+      {{{"my_mul"}, "Mul", {"x", "x"}, {{"T", "$T"}}}},
+      /*ret_def=*/
+      {{"z", "my_mul:z:0"}});
+  (*square_func.mutable_attr())["_noinline"].set_b(true);
+
+  FunctionDef cube_func = FunctionDefHelper::Create(
+      "MyCube", {"x:T"}, {"z:T"}, {"T: {float, double}"},
+      {{{"sq"}, "Mul", {"x", "x"}, {{"T", "$T"}}},
+       {{"cube"}, "Mul", {"sq:z", "x"}, {{"T", "$T"}}}},
+      /*ret_def=*/
+      {{"z", "cube:z:0"}});
+  (*cube_func.mutable_attr())["_noinline"].set_b(true);
+
+  GrapplerItem item;
+  item.id = "tf_graph";
+  item.graph = test::function::GDef(
+      {NDef("a", "Placeholder", {}, {{"dtype", DT_FLOAT}}, kDevice),
+       NDef("square", "MySquare", {"a"}, {{"T", DT_FLOAT}}, kDevice),
+       NDef("cube", "MyCube", {"a"}, {{"T", DT_FLOAT}}, kDevice),
+       NDef("out_s", "Identity", {"square:0"}, {{"T", DT_FLOAT}}, kDevice),
+       NDef("out_c", "Identity", {"cube:0"}, {{"T", DT_FLOAT}}, kDevice)},
+      /*funcs=*/
+      {square_func, cube_func});
+
+  GraphDef output;
+  const Status status = optimizer.Optimize(nullptr, item, &output);
+  unsetenv("TF_GRAPPLER_FUNCTION_OPTIMIZATION_THREADS");
+  TF_EXPECT_OK(status);
+
+  // Both functions should be specialized for their call sites, exactly as in
+  // the sequential case.
+  FunctionLibraryDefinition optimized_flib(OpRegistry::Global(),
+                                           output.library());
+  EXPECT_EQ(4, optimized_flib.num_functions());
+  EXPECT_NE(optimized_flib.Find(absl::Substitute(
+                "$0_specialized_for_$1_at_$2", "MySquare", "square",
+                "tf_graph")),
+            nullptr);
+  EXPECT_NE(optimized_flib.Find(absl::Substitute("$0_specialized_for_$1_at_$2",
+                                                 "MyCube", "cube", "tf_graph")),
+            nullptr);
+
+  // The optimized graph computes the same values.
+  item.fetch = {"out_s", "out_c"};
+  item.feed.emplace_back("a", test::AsScalar<float>(2.0f));
+  auto tensors_expected = EvaluateFetchNodes(item);
+
+  GrapplerItem optimized = item.WithGraph(std::move(output));
+  auto tensors = EvaluateFetchNodes(optimized);
+
+  test::ExpectTensorEqual<float>(tensors_expected[0], tensors[0]);
+  test::ExpectTensorEqual<float>(tensors_expected[1], tensors[1]);
+}
+
 TEST_F(MetaOptimizerTest, OptimizeFunctionLibraryPruneUnusedOutputs) {
   using test::function::NDef;
 
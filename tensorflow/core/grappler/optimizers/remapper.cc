@@ -42,10 +42,14 @@ namespace grappler {
 //
 // Both Conv2D and MatMul implemented as Tensor contraction (on CPU), so all the
 // patterns are "ContractionWith...".
+//
+// Sub + RealDiv + ClipByValue (with scalar statistics) -> _FusedNormalizeClip,
+// the per-feature normalization pattern in serving graphs.
 namespace {
 
 constexpr char kFusedConv2D[] = "_FusedConv2D";
 constexpr char kFusedMatMul[] = "_FusedMatMul";
+constexpr char kFusedNormalizeClip[] = "_FusedNormalizeClip";
 
 constexpr char kDataFormat[] = "data_format";
 constexpr char kIsTraining[] = "is_training";
@@ -149,6 +153,19 @@ struct ContractionWithBatchNormAndActivation {
   float epsilon = 0.0;
 };
 
+// Sub followed by a RealDiv and a ClipByValue with scalar statistics: the
+// per-feature normalization pattern emitted for serving-time feature columns.
+struct NormalizeClip {
+  NormalizeClip() = default;
+  NormalizeClip(const NodeDef* sub, const NodeDef* real_div,
+                const NodeDef* clip)
+      : sub(sub), real_div(real_div), clip(clip) {}
+
+  const NodeDef* sub = nullptr;
+  const NodeDef* real_div = nullptr;
+  const NodeDef* clip = nullptr;
+};
+
 bool IsInPreserveSet(const RemapperContext& ctx, const NodeDef* node) {
   return ctx.nodes_to_preserve.count(node->name()) > 0;
 }
@@ -287,6 +304,17 @@ bool IsSupportedActivation(const NodeDef& node) {
 #endif  // !INTEL_MKL
 }
 
+// Returns true if the activation is supported only by the `_FusedMatMul`
+// kernel, and not by `_FusedConv2D`.
+bool IsMatMulOnlyActivation(const NodeDef& node) {
+// Tanh and Sigmoid output kernels are implemented only for the fused MatMul.
+#ifndef INTEL_MKL
+  return IsTanh(node) || IsSigmoid(node);
+#else
+  return false;
+#endif  // !INTEL_MKL
+}
+
 bool FindContractionWithBias(const RemapperContext& ctx,
                              const NodeDef* bias_add,
                              ContractionWithBiasAdd* matched,
@@ -329,7 +357,9 @@ bool FindContractionWithBiasAndActivation(
   if (!EigenSupportsContractionOutputKernel()) return false;
 
   // Root of the pattern must be an activation node.
-  if (!activation || !IsSupportedActivation(*activation) ||
+  if (!activation ||
+      !(IsSupportedActivation(*activation) ||
+        IsMatMulOnlyActivation(*activation)) ||
       HasControlFaninOrFanout(ctx.graph_view, activation))
     return false;
 
@@ -345,6 +375,10 @@ bool FindContractionWithBiasAndActivation(
       IsInPreserveSet(ctx, base.bias_add))
     return false;
 
+  // Tanh and Sigmoid can be fused only with the MatMul contraction.
+  if (IsMatMulOnlyActivation(*activation) && !IsMatMul(*base.contraction))
+    return false;
+
   // Check that data type and data format are supported on assigned device.
   const ContractionWithBiasAddAndActivation pattern{base.contraction,
                                                     base.bias_add, activation};
@@ -531,6 +565,66 @@ bool FindFusedBatchNorm(const RemapperContext& ctx, const NodeDef* node,
   return true;
 }
 
+// Check that given node meets some basic NormalizeClip optimization
+// preconditions. As for FusedBatchNorm above, we use this check to lazily
+// infer graph properties which is rather expensive.
+bool IsNormalizeClipCandidate(const NodeDef& node) {
+  if (!IsClipByValue(node)) return false;
+  if (!NodeIsOnCpu(&node)) return false;
+
+  // The fused kernel is registered for floating point types only.
+  DataType dtype = GetDataTypeFromAttr(node, "T");
+  return dtype == DT_HALF || dtype == DT_FLOAT || dtype == DT_DOUBLE;
+}
+
+bool FindNormalizeClip(const RemapperContext& ctx, const NodeDef* clip,
+                       NormalizeClip* matched) {
+  // Root of the pattern must be a ClipByValue.
+  if (clip == nullptr || !IsNormalizeClipCandidate(*clip) ||
+      HasControlFaninOrFanout(ctx.graph_view, clip))
+    return false;
+
+  // Input to the ClipByValue must be a RealDiv.
+  const auto clip_input_port = GraphView::InputPort(clip, 0);
+  const auto real_div = ctx.graph_view.GetRegularFanin(clip_input_port);
+
+  if (!real_div.node || !IsRealDiv(*real_div.node) ||
+      !HaveSameDataType(clip, real_div.node) ||
+      HasControlFaninOrFanout(ctx.graph_view, real_div.node) ||
+      !HasSingleFanoutNode(ctx.graph_view, real_div.node) ||
+      IsInPreserveSet(ctx, real_div.node))
+    return false;
+
+  // Dividend of the RealDiv must be a Sub.
+  const auto div_input_port = GraphView::InputPort(real_div.node, 0);
+  const auto sub = ctx.graph_view.GetRegularFanin(div_input_port);
+
+  if (!sub.node || !IsSub(*sub.node) ||
+      !HaveSameDataType(clip, sub.node) ||
+      HasControlFaninOrFanout(ctx.graph_view, sub.node) ||
+      !HasSingleFanoutNode(ctx.graph_view, sub.node) ||
+      IsInPreserveSet(ctx, sub.node))
+    return false;
+
+  // The fused kernel supports only scalar statistics: the subtrahend, the
+  // divisor, and both clip bounds must be rank 0.
+  const auto is_scalar_input = [&](const NodeDef* node, int port) {
+    const auto& props = ctx.graph_properties.GetInputProperties(node->name());
+    return static_cast<int>(props.size()) > port &&
+           Rank(props[port].shape()) == 0;
+  };
+  if (!is_scalar_input(sub.node, 1) || !is_scalar_input(real_div.node, 1) ||
+      !is_scalar_input(clip, 1) || !is_scalar_input(clip, 2))
+    return false;
+
+  // We successfully found a Sub+RealDiv+ClipByValue pattern.
+  matched->sub = sub.node;
+  matched->real_div = real_div.node;
+  matched->clip = clip;
+
+  return true;
+}
+
 void CopyConv2DAttributes(const NodeDef* conv2d, NodeDef* fused_conv2d) {
   DCHECK(IsConv2D(*conv2d)) << "Input node must be a Conv2D";
 
@@ -727,6 +821,30 @@ void AddFusedConv2DNode(
   invalidated_nodes->insert(matched.contraction);
 }
 
+void AddFusedNormalizeClipNode(
+    const NormalizeClip& matched, GraphDef* optimized_graph,
+    absl::flat_hash_set<const NodeDef*>* invalidated_nodes) {
+  VLOG(2) << "Fuse Sub with RealDiv and ClipByValue:"
+          << " clip=" << matched.clip->name()
+          << " real_div=" << matched.real_div->name()
+          << " sub=" << matched.sub->name();
+
+  NodeDef* fused_op = optimized_graph->add_node();
+  fused_op->set_name(matched.clip->name());
+  fused_op->set_op(kFusedNormalizeClip);
+  fused_op->set_device(matched.clip->device());
+  fused_op->add_input(matched.sub->input(0));       // 0: t
+  fused_op->add_input(matched.sub->input(1));       // 1: shift
+  fused_op->add_input(matched.real_div->input(1));  // 2: scale
+  fused_op->add_input(matched.clip->input(1));      // 3: clip_value_min
+  fused_op->add_input(matched.clip->input(2));      // 4: clip_value_max
+  (*fused_op->mutable_attr())["T"] = matched.clip->attr().at("T");
+
+  invalidated_nodes->insert(matched.clip);
+  invalidated_nodes->insert(matched.real_div);
+  invalidated_nodes->insert(matched.sub);
+}
+
 void AddBatchNormNodes(const FusedBatchNorm& matched,
                        GraphDef* optimized_graph) {
   const NodeDef& fused_node = *matched.fused_batch_norm;
@@ -881,6 +999,7 @@ Status Remapper::Optimize(Cluster* /*cluster*/, const GrapplerItem& item,
   ContractionWithBatchNorm              contract_with_batch_norm;
   ContractionWithBatchNormAndActivation contract_with_batch_norm_and_activation;
   ContractionWithSqueezeAndBiasAdd      contract_with_squeeze_and_bias;
+  NormalizeClip                         normalize_clip;
   // clang-format on
 
   // Processing graph in reverse-topological sorted order allows to remap
@@ -960,11 +1079,20 @@ Status Remapper::Optimize(Cluster* /*cluster*/, const GrapplerItem& item,
 #endif  // !INTEL_MKL
 
     // Infer properties lazily in case they are not needed.
-    if (!ctx.inferred_graph_properties && IsFusedBatchNormCandidate(node)) {
+    if (!ctx.inferred_graph_properties &&
+        (IsFusedBatchNormCandidate(node) || IsNormalizeClipCandidate(node))) {
       TF_RETURN_IF_ERROR(ctx.graph_properties.InferStatically(false));
       ctx.inferred_graph_properties = true;
     }
 
+    // Remap Sub+RealDiv+ClipByValue into the _FusedNormalizeClip.
+    if (allow_non_differentiable_rewrites &&
+        FindNormalizeClip(ctx, &node, &normalize_clip)) {
+      AddFusedNormalizeClipNode(normalize_clip, optimized_graph,
+                                &invalidated_nodes);
+      continue;
+    }
+
     // During inference, most of the inputs to FusedBatchNorm are constant, and
     // we can therefore replace the op with a much cheaper set of primitives.
     if (FindFusedBatchNorm(ctx, &node, &fused_batch_norm)) {
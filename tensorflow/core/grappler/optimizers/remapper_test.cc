@@ -313,7 +313,8 @@ TEST_F(RemapperTest, FuseMatMulWithBiasAndActivation) {
 
   using ::tensorflow::ops::Placeholder;
 
-  for (const string& activation : {"Relu", "Relu6", "Elu"}) {
+  for (const string& activation :
+       {"Relu", "Relu6", "Elu", "Tanh", "Sigmoid"}) {
     tensorflow::Scope s = tensorflow::Scope::NewRootScope();
 
     auto lhs_shape = ops::Placeholder::Shape({8, 32});
@@ -337,6 +338,10 @@ TEST_F(RemapperTest, FuseMatMulWithBiasAndActivation) {
         return ops::Identity(fetch, ops::Relu6(activate, bias_add));
       } else if (activation == "Elu") {
         return ops::Identity(fetch, ops::Elu(activate, bias_add));
+      } else if (activation == "Tanh") {
+        return ops::Identity(fetch, ops::Tanh(activate, bias_add));
+      } else if (activation == "Sigmoid") {
+        return ops::Identity(fetch, ops::Sigmoid(activate, bias_add));
       }
 
       return ops::Identity(fetch, bias);
@@ -632,5 +637,61 @@ TEST_F(RemapperTest, FuseConv2DWithSqueezeAndBias) {
   test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-6);
 }
 
+TEST_F(RemapperTest, FuseNormalizeClip) {
+  using ::tensorflow::ops::Placeholder;
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto input_shape = ops::Placeholder::Shape({8, 32});
+  auto input = Placeholder(s.WithOpName("input"), DT_FLOAT, input_shape);
+
+  // Scalar statistics, as produced for serving-time feature normalization.
+  auto shift = ops::Const(s.WithOpName("shift"), 2.5f, {});
+  auto scale = ops::Const(s.WithOpName("scale"), 3.0f, {});
+  auto clip_min = ops::Const(s.WithOpName("clip_min"), -1.0f, {});
+  auto clip_max = ops::Const(s.WithOpName("clip_max"), 1.0f, {});
+
+  auto sub = ops::Sub(s.WithOpName("sub"), input, shift);
+  auto div = ops::RealDiv(s.WithOpName("div"), sub, scale);
+  auto clip = ops::ClipByValue(s.WithOpName("clip"), div, clip_min, clip_max);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), clip);
+
+  auto input_t = GenerateRandomTensor<DT_FLOAT>({8, 32});
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"input", input_t}};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  // Place all nodes on CPU.
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_CHECK_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "clip") {
+      EXPECT_EQ("_FusedNormalizeClip", node.op());
+      EXPECT_EQ("input", node.input(0));
+      EXPECT_EQ("shift", node.input(1));
+      EXPECT_EQ("scale", node.input(2));
+      EXPECT_EQ("clip_min", node.input(3));
+      EXPECT_EQ("clip_max", node.input(4));
+      found++;
+    }
+  }
+  EXPECT_EQ(1, found);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  EXPECT_EQ(1, tensors_expected.size());
+  EXPECT_EQ(1, tensors.size());
+  test::ExpectTensorNear<float>(tensors_expected[0], tensors[0], 1e-6);
+}
+
 }  // namespace grappler
 }  // namespace tensorflow
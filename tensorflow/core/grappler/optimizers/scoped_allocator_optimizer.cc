@@ -17,6 +17,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/scoped_allocator.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
 #include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/graph/graph.h"
@@ -25,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/op_types.h"
 #include "tensorflow/core/grappler/utils/frame.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/util/device_name_utils.h"
 
 // Like TF_RETURN_IF_ERROR, but also logs a WARNING.
 #define LOG_WARNING_AND_RETURN_IF_ERROR(...)            \
@@ -710,12 +712,306 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
   }
 };
 
+// Eliminates the data movement performed by an eligible CPU ConcatV2:
+// a new ScopedAllocator is arranged to hand the upstream ops output
+// buffers that are adjacent fields of a single backing tensor, and the
+// ConcatV2 is replaced by a ScopedAllocatorConcat that merely outputs a
+// reshaped reference to that backing tensor.
+//
+// A ConcatV2 is eligible if it concatenates along axis 0 (the only case
+// in which the result is a byte-wise merge of the inputs), all of its
+// inputs have statically known shapes, are produced on the same device
+// solely for its consumption, and every input but the last occupies a
+// multiple of Allocator::kAllocatorAlignment bytes so that the fields
+// pack into the backing tensor without gaps.
+class CPUConcatRewriter : public ScopedAllocatorOptimizer::Rewriter {
+ public:
+  ~CPUConcatRewriter() override {}
+
+  bool RewritesSingleInstances() const override { return true; }
+
+  Status Rewrite(ScopedAllocatorOptimizer* sa_opti, int64 invocation_count,
+                 GraphDef* graph, const string& op_name,
+                 const std::vector<NodeDef*>& ops, bool* applied) override {
+    *applied = false;
+    for (NodeDef* n : ops) {
+      ConcatGroup group;
+      if (!AnalyzeConcat(sa_opti, n, &group)) {
+        continue;
+      }
+      LOG_WARNING_AND_RETURN_IF_ERROR(
+          RewriteConcat(sa_opti, invocation_count, graph, n, group));
+      *applied = true;
+    }
+    return Status::OK();
+  }
+
+ private:
+  struct ConcatGroup {
+    DataType dtype;
+    std::vector<InputDesc> inputs;
+    std::vector<TensorShape> input_shapes;
+    TensorShape output_shape;
+  };
+
+  // Returns true and populates *group iff node is a ConcatV2 that can
+  // safely be replaced by a no-copy ScopedAllocatorConcat.
+  bool AnalyzeConcat(ScopedAllocatorOptimizer* sa_opti, NodeDef* node,
+                     ConcatGroup* group) {
+    CHECK(graph_properties_);
+    NodeMap* node_map = sa_opti->node_map();
+    if (sa_opti->nodes_to_preserve().count(node->name()) > 0) {
+      VLOG(2) << "Not fusing " << node->name() << ": must be preserved";
+      return false;
+    }
+    DeviceNameUtils::ParsedName parsed_device;
+    if (!DeviceNameUtils::ParseFullName(node->device(), &parsed_device) ||
+        !parsed_device.has_type || parsed_device.type != DEVICE_CPU) {
+      VLOG(2) << "Not fusing " << node->name() << ": not placed on a CPU";
+      return false;
+    }
+    if (HasNodeAttr(*node, "_scoped_allocator")) {
+      VLOG(2) << "Not fusing " << node->name()
+              << ": output already committed to a ScopedAllocator";
+      return false;
+    }
+    AttrSlice n_attrs = AttrSlice(*node);
+    int32 num_inputs;
+    if (!GetNodeAttr(n_attrs, "N", &num_inputs).ok() ||
+        !GetNodeAttr(n_attrs, "T", &group->dtype).ok() || num_inputs < 2 ||
+        node->input_size() < num_inputs + 1) {
+      return false;
+    }
+    // Only a concatenation along the leading axis lays its result out as
+    // the byte-wise merge of its inputs.
+    int64 axis;
+    if (!GetConstantAxis(node_map, node->input(num_inputs), &axis) ||
+        axis != 0) {
+      VLOG(2) << "Not fusing " << node->name()
+              << ": axis is not a constant zero";
+      return false;
+    }
+    if (!GetKnownShape(node->name(), 0, group->dtype, &group->output_shape)) {
+      VLOG(2) << "Not fusing " << node->name() << ": unknown output shape";
+      return false;
+    }
+    std::set<string> seen_inputs;
+    for (int i = 0; i < num_inputs; ++i) {
+      const string& input_name = node->input(i);
+      if (IsControlInput(input_name) ||
+          !seen_inputs.insert(input_name).second) {
+        // A duplicated input would need to alias two distinct fields.
+        return false;
+      }
+      int output_slot = 0;
+      string producer_name = ParseNodeName(input_name, &output_slot);
+      NodeDef* producer = node_map->GetNode(input_name);
+      if (producer == nullptr || IsExit(*producer) ||
+          producer->device() != node->device()) {
+        VLOG(2) << "Not fusing " << node->name() << ": ineligible input "
+                << input_name;
+        return false;
+      }
+      if (HasNodeAttr(*producer, "_scoped_allocator")) {
+        VLOG(2) << "Not fusing " << node->name() << ": input " << input_name
+                << " is already assigned to a ScopedAllocator";
+        return false;
+      }
+      // Require the concat to be the producer's only consumer: its output
+      // becomes an alias into the backing tensor and we don't want that
+      // buffer also retained on some unrelated path.
+      const std::set<NodeDef*>& consumers =
+          node_map->GetOutputs(producer->name());
+      if (consumers.size() != 1) {
+        VLOG(2) << "Not fusing " << node->name() << ": input " << input_name
+                << " has other consumers";
+        return false;
+      }
+      TensorShape shape;
+      if (!GetKnownShape(producer_name, output_slot, group->dtype, &shape)) {
+        VLOG(2) << "Not fusing " << node->name() << ": unknown shape for "
+                << input_name;
+        return false;
+      }
+      group->inputs.emplace_back(producer, output_slot, node);
+      group->input_shapes.push_back(shape);
+    }
+    // PopulateFields aligns each field to kAllocatorAlignment.  The backing
+    // tensor is the exact concatenation only if no padding is introduced,
+    // i.e. every field but the last ends on an alignment boundary.
+    for (int i = 0; i < group->input_shapes.size() - 1; ++i) {
+      const int64 bytes =
+          group->input_shapes[i].num_elements() * DataTypeSize(group->dtype);
+      if (bytes % Allocator::kAllocatorAlignment != 0) {
+        VLOG(2) << "Not fusing " << node->name() << ": input " << i
+                << " does not end on an alignment boundary";
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Returns true and sets *axis iff edge_name comes from a Const scalar.
+  bool GetConstantAxis(NodeMap* node_map, const string& edge_name,
+                       int64* axis) {
+    NodeDef* axis_node = node_map->GetNode(edge_name);
+    if (axis_node == nullptr || !IsConstant(*axis_node)) {
+      return false;
+    }
+    Tensor axis_tensor;
+    if (!GetNodeAttr(AttrSlice(*axis_node), "value", &axis_tensor).ok() ||
+        axis_tensor.NumElements() != 1) {
+      return false;
+    }
+    if (axis_tensor.dtype() == DT_INT32) {
+      *axis = axis_tensor.scalar<int32>()();
+    } else if (axis_tensor.dtype() == DT_INT64) {
+      *axis = axis_tensor.scalar<int64>()();
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // Returns true and sets *shape iff output output_slot of node_name has
+  // the expected type and a fully known shape.
+  bool GetKnownShape(const string& node_name, int output_slot, DataType dtype,
+                     TensorShape* shape) {
+    if (!graph_properties_->HasOutputProperties(node_name)) {
+      return false;
+    }
+    const std::vector<OpInfo::TensorProperties>& props =
+        graph_properties_->GetOutputProperties(node_name);
+    if (output_slot < 0 || output_slot >= props.size() ||
+        props[output_slot].dtype() != dtype ||
+        !TensorShape::IsValid(props[output_slot].shape())) {
+      return false;
+    }
+    PartialTensorShape partial(props[output_slot].shape());
+    if (!partial.IsFullyDefined()) {
+      return false;
+    }
+    *shape = TensorShape(props[output_slot].shape());
+    return true;
+  }
+
+  Status RewriteConcat(ScopedAllocatorOptimizer* sa_opti,
+                       int64 invocation_count, GraphDef* graph, NodeDef* node,
+                       const ConcatGroup& group) {
+    VLOG(1) << "Fusing ConcatV2 " << node->name() << " with "
+            << group.inputs.size() << " inputs into a ScopedAllocator";
+    NodeMap* node_map = sa_opti->node_map();
+    const string& device_name = node->device();
+
+    // Build the ScopedAllocator node that owns the backing tensor.
+    std::vector<ScopedAllocator::Field> sa_fields;
+    int64 num_bytes = ScopedAllocatorMgr::PopulateFields(
+        0 /*scope_id*/, group.input_shapes, group.dtype, &sa_fields);
+    int64 num_elts = num_bytes / DataTypeSize(group.dtype);
+    TensorShape sa_shape({num_elts});
+    int sa_id = sa_opti->NewScopedAllocatorId(group.inputs.size());
+    string sa_name =
+        strings::StrCat("scoped_allocator_", sa_id, "_", invocation_count);
+    NodeDefBuilder sa_builder(sa_name, "_ScopedAllocator");
+    sa_builder.Device(device_name);
+    sa_builder.Attr("sa_name", sa_name);
+    sa_builder.Attr("T", group.dtype);
+    sa_builder.Attr("id", sa_id);
+    sa_builder.Attr("shapes", group.input_shapes);
+    sa_builder.Attr("shape", sa_shape);
+    sa_builder.Attr("expected_call_count",
+                    static_cast<int64>(group.inputs.size()));
+    NodeDef* sa_node = graph->add_node();
+    LOG_WARNING_AND_RETURN_IF_ERROR(sa_builder.Finalize(sa_node));
+    node_map->AddNode(sa_name, sa_node);
+
+    // Mark the upstream ops to allocate their outputs from the backing
+    // tensor, gated on the ScopedAllocator by a control edge.
+    for (int i = 0; i < group.inputs.size(); ++i) {
+      const InputDesc& nd = group.inputs[i];
+      nd.from_node_def->add_input(strings::StrCat("^", sa_name));
+      ScopedAllocatorOptimizer::ExtendNodeAttr(
+          "_scoped_allocator", {nd.output_slot, sa_id + 1 + i},
+          nd.from_node_def);
+      node_map->AddOutput(sa_name, nd.from_node_def->name());
+    }
+
+    // Build the ScopedAllocatorConcat that replaces the ConcatV2.  With
+    // reshape set it outputs the backing tensor reshaped to the concat
+    // result: no bytes move.
+    string sac_name = strings::StrCat("scoped_allocator_concat_", sa_id, "_",
+                                      invocation_count);
+    NodeDefBuilder sac_builder(sac_name, "_ScopedAllocatorConcat");
+    sac_builder.Device(device_name);
+    sac_builder.Attr("sa_name", sa_name);
+    sac_builder.Attr("id", sa_id);
+    sac_builder.Attr("T", group.dtype);
+    sac_builder.Attr("shape", group.output_shape);
+    sac_builder.Attr("reshape", true);
+    sac_builder.Attr("N", static_cast<int>(group.inputs.size()));
+    sac_builder.Input(NodeDefBuilder::NodeOut(sa_name, 0, group.dtype));
+    std::vector<NodeDefBuilder::NodeOut> sac_inputs;
+    for (int i = 0; i < group.inputs.size(); ++i) {
+      sac_inputs.push_back(
+          NodeDefBuilder::NodeOut(node->input(i), 0, group.dtype));
+    }
+    sac_builder.Input(sac_inputs);
+    NodeDef* sac_node = graph->add_node();
+    LOG_WARNING_AND_RETURN_IF_ERROR(sac_builder.Finalize(sac_node));
+    node_map->AddNode(sac_name, sac_node);
+    node_map->AddOutput(sa_name, sac_name);
+    for (const InputDesc& nd : group.inputs) {
+      node_map->AddOutput(nd.from_node_def->name(), sac_name);
+    }
+
+    // Transfer the old concat's control inputs to the new node.
+    for (const string& input_name : node->input()) {
+      if (IsControlInput(input_name)) {
+        sac_node->add_input(input_name);
+        int position = 0;
+        string ctl_name = ParseNodeName(input_name, &position);
+        node_map->AddOutput(ctl_name, sac_name);
+      }
+    }
+
+    // Redirect the old concat's consumers to the new node.
+    std::set<NodeDef*> output_nodes = node_map->GetOutputs(node->name());
+    for (NodeDef* consumer : output_nodes) {
+      for (int i = 0; i < consumer->input_size(); ++i) {
+        int position = 0;
+        string input_node = ParseNodeName(consumer->input(i), &position);
+        if (input_node != node->name()) {
+          continue;
+        }
+        if (position == -1) {
+          *consumer->mutable_input(i) = strings::StrCat("^", sac_name);
+        } else {
+          CHECK_EQ(0, position)
+              << "name " << consumer->input(i) << " pos " << position;
+          *consumer->mutable_input(i) = strings::StrCat(sac_name, ":", 0);
+        }
+        node_map->AddOutput(sac_name, consumer->name());
+      }
+      node_map->RemoveOutput(node->name(), consumer->name());
+    }
+
+    // The old concat (and its edge to the axis constant) is now dead.
+    node_map->RemoveInputs(node->name());
+    node->clear_input();
+    node_map->RemoveOutputs(node->name());
+    RemoveNode(node, graph, node_map);
+    return Status::OK();
+  }
+};
+
 ScopedAllocatorOptimizer::ScopedAllocatorOptimizer(
     RewriterConfig::Toggle opt_level, const ScopedAllocatorOptions& opts)
     : opt_level_(opt_level) {
   VLOG(1) << "ScopedAllocatorOptimizer::ScopedAllocatorOptimizer";
   Rewriter* r = new UnaryElementwiseRewriter();
   to_delete_.push_back(r);
+  Rewriter* concat_rewriter = new CPUConcatRewriter();
+  to_delete_.push_back(concat_rewriter);
   if (opts.enable_op_size() == 0) {
     // Opts handled by default:
     for (const auto& op_name : {"CollectiveReduce"}) {
@@ -725,7 +1021,7 @@ ScopedAllocatorOptimizer::ScopedAllocatorOptimizer(
   } else {
     for (const auto& op_name : opts.enable_op()) {
       op_name_set_.insert(op_name);
-      rewriters_[op_name] = r;
+      rewriters_[op_name] = (op_name == "ConcatV2") ? concat_rewriter : r;
     }
   }
 }
@@ -915,15 +1211,20 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
         // Nodes with a common depth and root path are now grouped
         // in the same Tree struct.  Split those groups into subgroups that
         // share identical loop nesting.
+        // Rewriters that apply to a single Op instance get groups of any
+        // size; the coalescing Rewriters need at least two instances.
+        const size_t min_group_size =
+            rewriter->RewritesSingleInstances() ? 1 : 2;
         status = ApplyToAll(root.get(), [this, rewriter, graph, &frame_view,
-                                         &op_name, invocation_count](Tree* t) {
+                                         &op_name, invocation_count,
+                                         min_group_size](Tree* t) {
           VLOG(2) << "applied to tree node " << t->edge_ << " at depth "
                   << t->depth_ << " of size " << t->nodes_.size();
-          if (t->nodes_.size() > 1) {
+          if (t->nodes_.size() >= min_group_size) {
             std::vector<std::vector<NodeDef*>> loop_groups;
             PartitionByLoopStructure(frame_view, t->nodes_, &loop_groups);
             for (auto& lg : loop_groups) {
-              if (lg.size() > 1) {
+              if (lg.size() >= min_group_size) {
                 bool applied = false;
                 Status s = OrderNodeSet(&lg);
                 TF_RETURN_IF_ERROR(s);
@@ -70,6 +70,10 @@ class ScopedAllocatorOptimizer : public GraphOptimizer {
 
   NodeMap* node_map() { return node_map_.get(); }
 
+  const std::unordered_set<string>& nodes_to_preserve() const {
+    return nodes_to_preserve_;
+  }
+
   // Appends values to the attr value under name in node_def, if present.
   // If not present does an assignment.
   static void ExtendNodeAttr(StringPiece name, const std::vector<int32>& values,
@@ -87,6 +91,11 @@ class ScopedAllocatorOptimizer : public GraphOptimizer {
                            const std::vector<NodeDef*>& nodes,
                            bool* applied) = 0;
 
+    // Returns true if this Rewriter is usefully applied to a single
+    // instance of its Op.  The default Rewriters coalesce multiple
+    // parallel instances and so need at least two.
+    virtual bool RewritesSingleInstances() const { return false; }
+
     void SetGraphProperties(const GraphProperties& graph_properties) {
       graph_properties_ = &graph_properties;
       CHECK(graph_properties_);
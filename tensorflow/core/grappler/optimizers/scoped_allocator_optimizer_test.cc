@@ -104,6 +104,34 @@ class ScopedAllocatorOptimizerTest : public ::testing::Test {
     TF_CHECK_OK(s.ToGraphDef(graph_def));
   }
 
+  // Constructs the following graph.
+  //
+  // a and b are 4x4 and 2x4 float constants, so x1's 64 output bytes end
+  // on an alignment boundary and the concat is eligible for rewrite into
+  // a ScopedAllocatorConcat.
+  /*
+          a    b
+          |    |
+          x1   x2
+           \  /
+          concat
+            |
+            r
+  */
+  void BuildConcatGraph(GraphDef* graph_def) {
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+    s = s.WithDevice("/job:localhost/replica:0/task:0/device:CPU:0");
+
+    Output a = ops::Const<float>(s.WithOpName("a"), -2.0f, {4, 4});
+    Output b = ops::Const<float>(s.WithOpName("b"), 3.0f, {2, 4});
+    Output x1 = ops::Abs(s.WithOpName("x1"), a);
+    Output x2 = ops::Abs(s.WithOpName("x2"), b);
+    Output axis = ops::Const(s.WithOpName("axis"), 0);
+    Output concat = ops::Concat(s.WithOpName("concat"), {x1, x2}, axis);
+    Output r = ops::Identity(s.WithOpName("r"), concat);
+    TF_CHECK_OK(s.ToGraphDef(graph_def));
+  }
+
   void SetShapes(GraphDef* graph_def) {
     TensorShapeProto shape_proto;
     shape_proto.add_dim()->set_size(2);
@@ -261,6 +289,91 @@ TEST_F(ScopedAllocatorOptimizerTest, Extend) {
   VLOG(0) << "nd2: " << nd2.DebugString();
 }
 
+TEST_F(ScopedAllocatorOptimizerTest, ConcatRewrite) {
+  // Tests that an eligible CPU ConcatV2 is replaced by a ScopedAllocator
+  // and a no-copy ScopedAllocatorConcat.
+  GrapplerItem item;
+  BuildConcatGraph(&item.graph);
+  item.fetch = {"r"};
+
+  ScopedAllocatorOptions opts;
+  opts.add_enable_op("ConcatV2");
+  ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+
+  GraphDef optimized_graph;
+  TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+
+  // The ConcatV2 should be gone, replaced by a _ScopedAllocator and a
+  // _ScopedAllocatorConcat.
+  NodeMap node_map(&optimized_graph);
+  EXPECT_TRUE(node_map.GetNode("concat") == nullptr);
+  NodeDef* sa_node = nullptr;
+  NodeDef* sac_node = nullptr;
+  for (NodeDef& n : *optimized_graph.mutable_node()) {
+    if (n.op() == "_ScopedAllocator") {
+      sa_node = &n;
+    } else if (n.op() == "_ScopedAllocatorConcat") {
+      sac_node = &n;
+    }
+  }
+  ASSERT_TRUE(sa_node);
+  ASSERT_TRUE(sac_node);
+  {
+    auto& nd_set = node_map.GetOutputs(sa_node->name());
+    ASSERT_EQ(3, nd_set.size());
+    std::unordered_set<string> expected = {sac_node->name(), "x1", "x2"};
+    for (auto it : nd_set) {
+      ASSERT_NE(expected.find(it->name()), expected.end())
+          << "Failed to find " << it->name();
+    }
+  }
+  {
+    auto& nd_set = node_map.GetOutputs(sac_node->name());
+    ASSERT_EQ(1, nd_set.size());
+    for (auto it : nd_set) {
+      ASSERT_EQ("r", it->name());
+    }
+  }
+  // The upstream ops should be marked to allocate their outputs from the
+  // backing tensor.
+  for (const auto& input_name : {"x1", "x2"}) {
+    std::vector<int32> scoped_allocator_attrs;
+    AttrSlice slice(*node_map.GetNode(input_name));
+    TF_EXPECT_OK(
+        GetNodeAttr(slice, "_scoped_allocator", &scoped_allocator_attrs));
+  }
+}
+
+TEST_F(ScopedAllocatorOptimizerTest, ConcatExecute) {
+  // Builds the same graph as ConcatRewrite but also executes it and
+  // validates the output.
+  GrapplerItem item;
+  BuildConcatGraph(&item.graph);
+
+  ConfigProto config;
+  GraphOptions* gopt = config.mutable_graph_options();
+  OptimizerOptions* opts = gopt->mutable_optimizer_options();
+  opts->set_do_common_subexpression_elimination(false);
+  opts->set_do_constant_folding(false);
+  opts->set_do_function_inlining(false);
+  opts->set_opt_level(OptimizerOptions::L0);
+  RewriterConfig* rwcfg = gopt->mutable_rewrite_options();
+  rwcfg->clear_optimizers();
+  (*rwcfg->add_optimizers()) = "scoped_allocator";
+  rwcfg->mutable_scoped_allocator_opts()->add_enable_op("ConcatV2");
+  std::unique_ptr<Session> session(CreateSession(item.graph, config));
+
+  std::vector<std::pair<string, Tensor>> inputs;
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run(inputs, {"r:0"}, {}, &outputs));
+  ASSERT_EQ(1, outputs.size());
+  ASSERT_EQ(24, outputs[0].NumElements());
+  // abs(-2) x 16 followed by abs(3) x 8.
+  for (int i = 0; i < 24; ++i) {
+    EXPECT_EQ(i < 16 ? 2.0 : 3.0, outputs[0].flat<float>()(i));
+  }
+}
+
 TEST_F(ScopedAllocatorOptimizerTest, ForwardInputToOutput) {
   // Test that kernels that forward the input to output using `set_output` work
   // well with scoped allocator optimization.
@@ -0,0 +1,230 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/signature_pruner.h"
+
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/op_types.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+// Side effects that only matter during training: state mutation, checkpoint
+// and summary I/O. Control dependencies whose sole purpose is to trigger such
+// subgraphs can be dropped from a serving graph.
+bool IsTrainingSideEffect(const NodeDef& node) {
+  const string& op = node.op();
+  return str_util::StartsWith(op, "Assign") ||
+         str_util::StartsWith(op, "Apply") ||
+         str_util::StartsWith(op, "SparseApply") ||
+         str_util::StartsWith(op, "ResourceApply") ||
+         str_util::StartsWith(op, "Scatter") ||
+         str_util::StartsWith(op, "ResourceScatter") ||
+         str_util::EndsWith(op, "Summary") || op == "Print" ||
+         op == "PrintV2" || op == "Save" || op == "SaveV2" ||
+         op == "SaveSlices" || op == "WriteFile";
+}
+
+// Returns the set of nodes whose transitive fanin (including the node itself)
+// contains a training side effect, by propagating forward from the mutating
+// nodes.
+std::unordered_set<const NodeDef*> ComputeTaintedNodes(
+    const GraphDef& graph, const NodeMap& node_map) {
+  std::unordered_set<const NodeDef*> tainted;
+  std::deque<const NodeDef*> queue;
+  for (const NodeDef& node : graph.node()) {
+    if (IsTrainingSideEffect(node)) {
+      tainted.insert(&node);
+      queue.push_back(&node);
+    }
+  }
+  while (!queue.empty()) {
+    const NodeDef* node = queue.front();
+    queue.pop_front();
+    for (const NodeDef* fanout : node_map.GetOutputs(node->name())) {
+      if (tainted.insert(fanout).second) {
+        queue.push_back(fanout);
+      }
+    }
+  }
+  return tainted;
+}
+
+// Returns the set of nodes reachable from the terminal nodes following only
+// data edges.
+std::unordered_set<const NodeDef*> ComputeDataFanin(
+    const NodeMap& node_map, const std::vector<string>& terminal_nodes) {
+  std::unordered_set<const NodeDef*> reachable;
+  std::deque<const NodeDef*> queue;
+  for (const string& terminal : terminal_nodes) {
+    const NodeDef* node = node_map.GetNode(terminal);
+    if (node != nullptr && reachable.insert(node).second) {
+      queue.push_back(node);
+    }
+  }
+  while (!queue.empty()) {
+    const NodeDef* node = queue.front();
+    queue.pop_front();
+    for (const string& input : node->input()) {
+      if (IsControlInput(input)) {
+        continue;
+      }
+      const NodeDef* fanin = node_map.GetNode(input);
+      if (fanin != nullptr && reachable.insert(fanin).second) {
+        queue.push_back(fanin);
+      }
+    }
+  }
+  return reachable;
+}
+
+// Replaces a read-only variable with its constant initial value, if the
+// initializer assigns a Const to it. Returns true if the variable was frozen.
+bool FreezeVariable(const NodeMap& node_map,
+                    const std::unordered_set<const NodeDef*>& keep,
+                    NodeDef* variable) {
+  const NodeDef* init_value = nullptr;
+  for (const NodeDef* consumer : node_map.GetOutputs(variable->name())) {
+    if (IsAssign(*consumer) &&
+        NodeName(consumer->input(0)) == variable->name()) {
+      if (keep.find(consumer) != keep.end()) {
+        // The assignment itself is part of the serving graph.
+        return false;
+      }
+      const NodeDef* value = node_map.GetNode(consumer->input(1));
+      if (value == nullptr || !IsConstant(*value)) {
+        return false;
+      }
+      init_value = value;
+    } else if (keep.find(consumer) != keep.end() &&
+               IsTrainingSideEffect(*consumer)) {
+      // The variable is still written in the serving graph.
+      return false;
+    }
+  }
+  if (init_value == nullptr) {
+    return false;
+  }
+  AttrValue dtype = variable->attr().at("dtype");
+  AttrValue value = init_value->attr().at("value");
+  variable->set_op("Const");
+  variable->clear_attr();
+  variable->mutable_attr()->insert({"dtype", dtype});
+  variable->mutable_attr()->insert({"value", value});
+  return true;
+}
+
+}  // namespace
+
+Status SignaturePruner::Optimize(Cluster* cluster, const GrapplerItem& item,
+                                 GraphDef* output) {
+  if (item.fetch.empty()) {
+    return errors::InvalidArgument(
+        "A serving signature with fetch nodes is required.");
+  }
+  std::vector<string> terminal_nodes = item.fetch;
+  for (const auto& feed : item.feed) {
+    terminal_nodes.push_back(feed.first);
+  }
+
+  GraphDef graph = item.graph;
+  NodeMap node_map(&graph);
+  const std::unordered_set<const NodeDef*> tainted =
+      ComputeTaintedNodes(graph, node_map);
+  const std::unordered_set<const NodeDef*> data_reachable =
+      ComputeDataFanin(node_map, terminal_nodes);
+
+  // Drop control dependencies on subgraphs that only exist to trigger
+  // training side effects.
+  int num_dropped_controls = 0;
+  for (NodeDef& node : *graph.mutable_node()) {
+    int pos = 0;
+    for (int i = 0; i < node.input_size(); ++i) {
+      bool keep_input = true;
+      const string& input = node.input(i);
+      if (IsControlInput(input)) {
+        const NodeDef* source = node_map.GetNode(input);
+        if (source != nullptr && tainted.count(source) > 0 &&
+            data_reachable.count(source) == 0) {
+          keep_input = false;
+          ++num_dropped_controls;
+        }
+      }
+      if (keep_input) {
+        node.mutable_input()->SwapElements(pos++, i);
+      }
+    }
+    node.mutable_input()->DeleteSubrange(pos, node.input_size() - pos);
+  }
+
+  // Prune everything no longer reachable from the signature.
+  bool ill_formed = false;
+  std::vector<const NodeDef*> keep_list =
+      ComputeTransitiveFanin(graph, terminal_nodes, &ill_formed);
+  if (ill_formed) {
+    return errors::InvalidArgument("Invalid input graph.");
+  }
+  const std::unordered_set<const NodeDef*> keep(keep_list.begin(),
+                                                keep_list.end());
+
+  // Freeze read-only variables whose initial value is a constant. The
+  // initializer lives outside the serving fanin but is still present in the
+  // working copy of the graph at this point.
+  int num_frozen_variables = 0;
+  for (const NodeDef* node : keep_list) {
+    const string& op = node->op();
+    if ((op == "Variable" || op == "VariableV2") &&
+        FreezeVariable(node_map, keep, node_map.GetNode(node->name()))) {
+      ++num_frozen_variables;
+    }
+  }
+
+  output->Clear();
+  *output->mutable_library() = item.graph.library();
+  *output->mutable_versions() = item.graph.versions();
+  // Keep the nodes ordered somewhat topologically since this helps further
+  // optimizations perform better.
+  output->mutable_node()->Reserve(keep_list.size());
+  for (int i = keep_list.size() - 1; i >= 0; --i) {
+    *output->add_node() = *keep_list[i];
+  }
+
+  VLOG(1) << "Specialized graph for signature: dropped "
+          << num_dropped_controls << " control edge(s), froze "
+          << num_frozen_variables << " variable(s), kept "
+          << output->node_size() << " of " << item.graph.node_size()
+          << " nodes.";
+  return Status::OK();
+}
+
+void SignaturePruner::Feedback(Cluster* cluster, const GrapplerItem& item,
+                               const GraphDef& optimize_output, double result) {
+  // Nothing to do for SignaturePruner.
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(SignaturePruner, "SignaturePruner");
+
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,62 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_SIGNATURE_PRUNER_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_SIGNATURE_PRUNER_H_
+
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Specializes a training graph for serving. The item's feeds and fetches are
+// expected to come from the serving signature (e.g. as extracted by the
+// SavedModel loader). Training-only subgraphs (summaries, global-step
+// plumbing, moving-average updates, auxiliary heads) often survive regular
+// pruning because control edges keep them reachable from the serving outputs.
+// This pass:
+//  - drops control dependencies whose source subgraph mutates state or
+//    performs I/O but is not needed to compute the fetches;
+//  - prunes everything that is no longer reachable from the signature;
+//  - replaces read-only variables that have constant initializers with the
+//    initial value (checkpoint-backed variables require a session to resolve
+//    their value and are left alone).
+//
+// The pass is destructive to training semantics by design, so it is only
+// available as an opt-in custom optimizer ("SignaturePruner" in
+// RewriterConfig.custom_optimizers).
+class SignaturePruner : public CustomGraphOptimizer {
+ public:
+  SignaturePruner() {}
+  ~SignaturePruner() override {}
+
+  string name() const override { return "signature_pruner"; };
+
+  Status Init(const tensorflow::RewriterConfig_CustomGraphOptimizer* config =
+                  nullptr) override {
+    return Status::OK();
+  }
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* output) override;
+
+  void Feedback(Cluster* cluster, const GrapplerItem& item,
+                const GraphDef& optimize_output, double result) override;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_SIGNATURE_PRUNER_H_
@@ -0,0 +1,92 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/signature_pruner.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/grappler_test.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+class SignaturePrunerTest : public GrapplerTest {};
+
+TEST_F(SignaturePrunerTest, PrunesTrainingPlumbingAndFreezesVariables) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output x = ops::Placeholder(s.WithOpName("x"), DT_FLOAT,
+                              ops::Placeholder::Shape(TensorShape({2})));
+  Output w = ops::Variable(s.WithOpName("w"), {2}, DT_FLOAT);
+  Output w_init = ops::Const(s.WithOpName("w_init"), 3.0f, {2});
+  Output w_assign = ops::Assign(s.WithOpName("w_assign"), w, w_init);
+  // Global-step style plumbing, kept alive only by a control edge.
+  Output step = ops::Variable(s.WithOpName("step"), {1}, DT_FLOAT);
+  Output one = ops::Const(s.WithOpName("one"), 1.0f, {1});
+  Output incr = ops::AssignAdd(s.WithOpName("incr"), step, one);
+  Output out = ops::Mul(
+      s.WithOpName("out").WithControlDependencies({incr.op()}), x, w);
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"out"};
+  item.feed = {{"x", test::AsTensor<float>({1.5f, -2.0f})}};
+  item.init_ops = {"w_assign"};
+
+  SignaturePruner pruner;
+  GraphDef output;
+  TF_EXPECT_OK(pruner.Optimize(nullptr, item, &output));
+
+  NodeMap node_map(&output);
+  EXPECT_TRUE(node_map.NodeExists("x"));
+  ASSERT_TRUE(node_map.NodeExists("out"));
+  EXPECT_FALSE(node_map.NodeExists("step"));
+  EXPECT_FALSE(node_map.NodeExists("incr"));
+  EXPECT_FALSE(node_map.NodeExists("one"));
+  EXPECT_FALSE(node_map.NodeExists("w_assign"));
+  EXPECT_FALSE(node_map.NodeExists("w_init"));
+
+  // The control edge that kept the global-step update alive is gone.
+  const NodeDef* out_node = node_map.GetNode("out");
+  for (const string& input : out_node->input()) {
+    EXPECT_FALSE(IsControlInput(input));
+  }
+
+  // The read-only weight with a constant initializer has been frozen.
+  const NodeDef* w_node = node_map.GetNode("w");
+  ASSERT_NE(nullptr, w_node);
+  EXPECT_EQ("Const", w_node->op());
+
+  auto tensors = EvaluateNodes(output, item.fetch,
+                               {{"x", test::AsTensor<float>({1.5f, -2.0f})}});
+  ASSERT_EQ(1, tensors.size());
+  test::ExpectTensorEqual<float>(test::AsTensor<float>({4.5f, -6.0f}),
+                                 tensors[0]);
+}
+
+TEST_F(SignaturePrunerTest, RequiresFetch) {
+  GrapplerItem item;
+  SignaturePruner pruner;
+  GraphDef output;
+  EXPECT_FALSE(pruner.Optimize(nullptr, item, &output).ok());
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
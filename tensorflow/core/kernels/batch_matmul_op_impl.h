@@ -20,6 +20,7 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <functional>
 #include <vector>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
@@ -197,6 +198,49 @@ struct SequentialMatMulKernel {
   }
 };
 
+// Batched small-GEMM kernel for square matrices whose size is known at
+// compile time. With fixed dimensions Eigen emits a register-blocked product
+// and skips the dynamic blocking setup that the general gemm performs on
+// every call; for large batches of small matrices (e.g. per-head products in
+// attention layers) that setup dominates the actual arithmetic.
+template <typename Scalar, int Size>
+struct FixedSizeMatMulKernel {
+  using Matrix = Eigen::Matrix<Scalar, Size, Size, Eigen::RowMajor>;
+  using ConstMatrixMap = Eigen::Map<const Matrix>;
+  using MatrixMap = Eigen::Map<Matrix>;
+
+  static void Run(const Tensor& in_x, const Tensor& in_y, bool adj_x,
+                  bool adj_y, const MatMulBCast& bcast, Tensor* out, int start,
+                  int limit) {
+    const bool should_bcast = bcast.IsBroadcastingRequired();
+    const auto& x_batch_indices = bcast.x_batch_indices();
+    const auto& y_batch_indices = bcast.y_batch_indices();
+    const Scalar* x_base = in_x.flat<Scalar>().data();
+    const Scalar* y_base = in_y.flat<Scalar>().data();
+    Scalar* z_base = out->flat<Scalar>().data();
+    for (int64 i = start; i < limit; ++i) {
+      const int64 x_batch_index = should_bcast ? x_batch_indices[i] : i;
+      const int64 y_batch_index = should_bcast ? y_batch_indices[i] : i;
+      ConstMatrixMap x(x_base + x_batch_index * Size * Size);
+      ConstMatrixMap y(y_base + y_batch_index * Size * Size);
+      MatrixMap z(z_base + i * Size * Size);
+      if (!adj_x) {
+        if (!adj_y) {
+          z.noalias() = x * y;
+        } else {
+          z.noalias() = x * y.adjoint();
+        }
+      } else {
+        if (!adj_y) {
+          z.noalias() = x.adjoint() * y;
+        } else {
+          z.noalias() = x.adjoint() * y.adjoint();
+        }
+      }
+    }
+  }
+};
+
 }  // namespace
 
 template <typename Device, typename Scalar>
@@ -230,12 +274,40 @@ struct LaunchBatchMatMul<CPUDevice, Scalar> {
     } else {
       // Parallelize over outer dims. For small matrices and large batches, it
       // is counter-productive to parallelize the inner matrix multiplies.
+      // Square matrices of a few common small sizes are dispatched to a
+      // kernel with compile-time dimensions; everything else takes the
+      // dynamic-size kernel.
+      std::function<void(int, int)> shard_fn;
+      if (in_x.dim_size(1) == in_x.dim_size(2) &&
+          in_y.dim_size(1) == in_y.dim_size(2) &&
+          in_x.dim_size(1) == in_y.dim_size(1)) {
+        switch (in_x.dim_size(1)) {
+#define SMALL_MATMUL_CASE(SIZE)                                     \
+  case SIZE:                                                        \
+    shard_fn = [&in_x, &in_y, adj_x, adj_y, &bcast, out](int start, \
+                                                         int limit) {         \
+      FixedSizeMatMulKernel<Scalar, SIZE>::Run(in_x, in_y, adj_x, adj_y,      \
+                                               bcast, out, start, limit);     \
+    };                                                              \
+    break
+          SMALL_MATMUL_CASE(8);
+          SMALL_MATMUL_CASE(16);
+          SMALL_MATMUL_CASE(32);
+          SMALL_MATMUL_CASE(64);
+#undef SMALL_MATMUL_CASE
+          default:
+            break;
+        }
+      }
+      if (!shard_fn) {
+        shard_fn = [&in_x, &in_y, adj_x, adj_y, &bcast, out](int start,
+                                                             int limit) {
+          SequentialMatMulKernel<Scalar>::Run(in_x, in_y, adj_x, adj_y, bcast,
+                                              out, start, limit);
+        };
+      }
       Shard(worker_threads.num_threads, worker_threads.workers, batch_size,
-            cost_per_unit,
-            [&in_x, &in_y, adj_x, adj_y, &bcast, out](int start, int limit) {
-              SequentialMatMulKernel<Scalar>::Run(in_x, in_y, adj_x, adj_y,
-                                                  bcast, out, start, limit);
-            });
+            cost_per_unit, shard_fn);
     }
     if (conjugate_result) {
       // We used one of the identities
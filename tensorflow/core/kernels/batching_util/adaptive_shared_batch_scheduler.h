@@ -24,6 +24,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
+#include "tensorflow/core/kernels/batching_util/batch_size_tuner.h"
 #include "tensorflow/core/kernels/batching_util/periodic_function.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -129,6 +130,15 @@ class AdaptiveSharedBatchScheduler
     // A non-zero value can improve performance by limiting the scheduling of
     // nearly empty batches.
     int64 batch_timeout_micros = 0;
+    // If positive, the queue adaptively tunes its effective batch size and
+    // timeout: it continuously estimates the batch-size -> latency curve
+    // from completed batches (latency measured from batch creation to batch
+    // completion) and forms the largest batches whose estimated p99 latency
+    // stays within this target.  max_batch_size acts as an upper bound and
+    // batch_timeout_micros applies until the curve has been learned.  Each
+    // queue learns its own curve, so models sharing the scheduler threads
+    // are tuned in isolation.
+    int64 target_p99_latency_micros = 0;
   };
 
   using BatchProcessor = std::function<void(std::unique_ptr<Batch<TaskType>>)>;
@@ -257,8 +267,21 @@ class ASBSQueue : public BatchScheduler<TaskType> {
   size_t max_task_size() const override { return options_.max_batch_size; }
 
  private:
+  // Effective limit on the size of newly formed batches: the tuner's
+  // recommendation when adaptive batching is enabled, otherwise the static
+  // max_batch_size.
+  int32 effective_max_batch_size() const;
+
+  // Amount of time newly formed non-full batches must wait before becoming
+  // schedulable.
+  int64 effective_batch_timeout_micros() const;
+
   std::shared_ptr<AdaptiveSharedBatchScheduler<TaskType>> scheduler_;
   const QueueOptions options_;
+  // Present iff options_.target_p99_latency_micros > 0.  Shared with the
+  // batches created by this queue so that latencies observed after the queue
+  // is destroyed can still be recorded.
+  std::shared_ptr<BatchSizeTuner> tuner_;
   // Owned by scheduler_.
   ASBSBatch<TaskType>* current_batch_ GUARDED_BY(mu_) = nullptr;
   int64 num_enqueued_batches_ GUARDED_BY(mu_) = 0;
@@ -272,10 +295,12 @@ template <typename TaskType>
 class ASBSBatch : public Batch<TaskType> {
  public:
   ASBSBatch(ASBSQueue<TaskType>* queue, int64 creation_time_micros,
-            int64 batch_timeout_micros)
+            int64 batch_timeout_micros,
+            std::shared_ptr<BatchSizeTuner> tuner = nullptr)
       : queue_(queue),
         creation_time_micros_(creation_time_micros),
-        schedulable_time_micros_(creation_time_micros + batch_timeout_micros) {}
+        schedulable_time_micros_(creation_time_micros + batch_timeout_micros),
+        tuner_(std::move(tuner)) {}
 
   ~ASBSBatch() override {}
 
@@ -285,10 +310,15 @@ class ASBSBatch : public Batch<TaskType> {
 
   int64 schedulable_time_micros() const { return schedulable_time_micros_; }
 
+  // Tuner to report this batch's latency to, or nullptr if the creating
+  // queue does not use adaptive batching.
+  const std::shared_ptr<BatchSizeTuner>& tuner() const { return tuner_; }
+
  private:
   ASBSQueue<TaskType>* queue_;
   const int64 creation_time_micros_;
   const int64 schedulable_time_micros_;
+  const std::shared_ptr<BatchSizeTuner> tuner_;
   TF_DISALLOW_COPY_AND_ASSIGN(ASBSBatch);
 };
 }  // namespace internal
@@ -373,6 +403,11 @@ Status AdaptiveSharedBatchScheduler<TaskType>::AddQueue(
         "max_enqueued_batches must be positive; was ",
         options.max_enqueued_batches);
   }
+  if (options.target_p99_latency_micros < 0) {
+    return errors::InvalidArgument(
+        "target_p99_latency_micros can't be negative; was ",
+        options.target_p99_latency_micros);
+  }
   internal::ASBSQueue<TaskType>* asbs_queue_raw;
   queue->reset(asbs_queue_raw = new internal::ASBSQueue<TaskType>(
                    this->shared_from_this(), options));
@@ -467,9 +502,15 @@ void AdaptiveSharedBatchScheduler<TaskType>::CallbackWrapper(
     AdaptiveSharedBatchScheduler<TaskType>::BatchProcessor callback,
     bool is_express) {
   int64 start_time = batch->creation_time_micros();
+  // The callback may destroy the batch, so copy what the tuner needs first.
+  const std::shared_ptr<BatchSizeTuner> tuner = batch->tuner();
+  const int32 batch_size = batch->size();
   callback(std::unique_ptr<Batch<TaskType>>(
       const_cast<internal::ASBSBatch<TaskType>*>(batch)));
   int64 end_time = GetEnv()->NowMicros();
+  if (tuner) {
+    tuner->RecordLatency(batch_size, end_time - start_time);
+  }
   mutex_lock l(mu_);
   if (is_express) {
     in_flight_express_batches_--;
@@ -525,7 +566,29 @@ template <typename TaskType>
 ASBSQueue<TaskType>::ASBSQueue(
     std::shared_ptr<AdaptiveSharedBatchScheduler<TaskType>> scheduler,
     const QueueOptions& options)
-    : scheduler_(scheduler), options_(options) {}
+    : scheduler_(scheduler), options_(options) {
+  if (options.target_p99_latency_micros > 0) {
+    BatchSizeTuner::Options tuner_options;
+    tuner_options.max_batch_size = options.max_batch_size;
+    tuner_options.target_p99_latency_micros =
+        options.target_p99_latency_micros;
+    tuner_ = std::make_shared<BatchSizeTuner>(tuner_options);
+  }
+}
+
+template <typename TaskType>
+int32 ASBSQueue<TaskType>::effective_max_batch_size() const {
+  if (!tuner_) return options_.max_batch_size;
+  return std::min<int32>(tuner_->TunedBatchSize(), options_.max_batch_size);
+}
+
+template <typename TaskType>
+int64 ASBSQueue<TaskType>::effective_batch_timeout_micros() const {
+  if (!tuner_) return options_.batch_timeout_micros;
+  const int64 tuned_timeout = tuner_->TunedTimeoutMicros();
+  // Until the tuner has a trusted estimate, stay with the static timeout.
+  return tuned_timeout > 0 ? tuned_timeout : options_.batch_timeout_micros;
+}
 
 template <typename TaskType>
 ASBSQueue<TaskType>::~ASBSQueue() {
@@ -555,9 +618,11 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
   bool is_old_batch_closed = false;
   {
     mutex_lock l(mu_);
-    // Current batch is full, create another if allowed.
+    // Current batch is full, create another if allowed.  When adaptive
+    // batching is enabled, "full" is determined by the tuner's current
+    // recommendation rather than the static max_batch_size.
     if (current_batch_ &&
-        current_batch_->size() + size > options_.max_batch_size) {
+        current_batch_->size() + size > effective_max_batch_size()) {
       if (num_enqueued_batches_ >= options_.max_enqueued_batches) {
         return errors::Unavailable("The batch scheduling queue is full");
       }
@@ -569,7 +634,7 @@ Status ASBSQueue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
       num_enqueued_batches_++;
       current_batch_ = new_batch =
           new ASBSBatch<TaskType>(this, scheduler_->GetEnv()->NowMicros(),
-                                  options_.batch_timeout_micros);
+                                  effective_batch_timeout_micros(), tuner_);
     }
     current_batch_->AddTask(std::move(*task));
     num_enqueued_tasks_++;
@@ -0,0 +1,108 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_size_tuner.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace serving {
+
+BatchSizeTuner::BatchSizeTuner(const Options& options) : options_(options) {
+  DCHECK_GT(options_.max_batch_size, 0);
+  DCHECK_GT(options_.target_p99_latency_micros, 0);
+  DCHECK_GT(options_.num_buckets, 0);
+  DCHECK_GT(options_.observations_per_bucket, 0);
+  DCHECK_LE(options_.min_observations_per_bucket,
+            options_.observations_per_bucket);
+  buckets_.resize(std::min(options_.num_buckets, options_.max_batch_size));
+}
+
+int32 BatchSizeTuner::BucketIndex(int32 batch_size) const {
+  const int32 num_buckets = buckets_.size();
+  const int32 index =
+      static_cast<int64>(batch_size - 1) * num_buckets / options_.max_batch_size;
+  return std::max(0, std::min(index, num_buckets - 1));
+}
+
+int32 BatchSizeTuner::BucketUpperBound(int32 index) const {
+  const int32 num_buckets = buckets_.size();
+  return static_cast<int64>(options_.max_batch_size) * (index + 1) /
+         num_buckets;
+}
+
+void BatchSizeTuner::RecordLatency(int32 batch_size, int64 latency_micros) {
+  mutex_lock l(mu_);
+  Bucket& bucket = buckets_[BucketIndex(batch_size)];
+  if (bucket.latencies.size() <
+      static_cast<size_t>(options_.observations_per_bucket)) {
+    bucket.latencies.push_back(latency_micros);
+  } else {
+    bucket.latencies[bucket.next_index] = latency_micros;
+    bucket.next_index = (bucket.next_index + 1) % bucket.latencies.size();
+  }
+  bucket.num_observations++;
+}
+
+int64 BatchSizeTuner::BucketPercentile(const Bucket& bucket) const {
+  if (bucket.num_observations < options_.min_observations_per_bucket) {
+    return -1;
+  }
+  // 99th percentile by order statistic on a copy of the window; for windows
+  // of up to 100 observations this is the window maximum.
+  std::vector<int64> latencies = bucket.latencies;
+  const int rank = static_cast<int>(latencies.size() * 0.99);
+  std::nth_element(latencies.begin(), latencies.begin() + rank,
+                   latencies.end());
+  return latencies[rank];
+}
+
+int32 BatchSizeTuner::TunedBucketIndex() const {
+  // Latency is treated as non-decreasing in batch size, so the recommended
+  // size is capped just below the smallest bucket whose estimate violates
+  // the target.  Buckets without a trusted estimate do not constrain the
+  // recommendation; a fresh tuner therefore recommends max_batch_size and
+  // backs off as measurements come in.
+  const int32 num_buckets = buckets_.size();
+  for (int32 i = 0; i < num_buckets; ++i) {
+    const int64 p99 = BucketPercentile(buckets_[i]);
+    if (p99 >= 0 && p99 > options_.target_p99_latency_micros) {
+      return std::max(0, i - 1);
+    }
+  }
+  return num_buckets - 1;
+}
+
+int32 BatchSizeTuner::TunedBatchSize() const {
+  mutex_lock l(mu_);
+  return BucketUpperBound(TunedBucketIndex());
+}
+
+int64 BatchSizeTuner::TunedTimeoutMicros() const {
+  mutex_lock l(mu_);
+  const int64 p99 = BucketPercentile(buckets_[TunedBucketIndex()]);
+  if (p99 < 0) return 0;
+  return std::max(int64{0}, options_.target_p99_latency_micros - p99);
+}
+
+int64 BatchSizeTuner::EstimatePercentileLatency(int32 batch_size) const {
+  mutex_lock l(mu_);
+  return BucketPercentile(buckets_[BucketIndex(batch_size)]);
+}
+
+}  // namespace serving
+}  // namespace tensorflow
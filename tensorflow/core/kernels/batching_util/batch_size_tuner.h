@@ -0,0 +1,113 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_SIZE_TUNER_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_SIZE_TUNER_H_
+
+#include <vector>
+
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace serving {
+
+// Continuously estimates the batch-size -> latency curve of a batch
+// processing pipeline from observed executions, and recommends the batch
+// size and batch timeout which maximize throughput subject to a tail
+// latency target.
+//
+// Batch sizes are quantized into a fixed number of buckets; each bucket
+// keeps a sliding window of recently observed latencies from which a p99
+// estimate is computed.  Because per-example work is (at worst) additive in
+// batch size, latency is treated as non-decreasing in batch size: the
+// recommended batch size is capped just below the smallest bucket whose
+// estimated p99 exceeds the target, and the recommended timeout is the
+// slack between the target and the estimated p99 at the recommended size.
+// Until a bucket has accumulated enough observations its estimate is not
+// trusted, so a fresh tuner recommends the configured maximum batch size
+// and behaves like a statically configured queue.
+//
+// Each queue (i.e. each model or model version) should own its own tuner so
+// that models sharing scheduler threads do not pollute each other's curves.
+//
+// This class is thread-safe.
+class BatchSizeTuner {
+ public:
+  struct Options {
+    // Upper bound for the recommended batch size.
+    int32 max_batch_size = 1000;
+    // Tail latency target.  Observed latencies should measure the quantity
+    // the target constrains; schedulers typically record the time from task
+    // creation to batch completion so that queueing delay is included.
+    int64 target_p99_latency_micros = 0;
+    // Number of buckets the range [1, max_batch_size] is quantized into.
+    int32 num_buckets = 8;
+    // Sliding window length per bucket.  With 100 observations the p99
+    // estimate is the maximum of the window; larger windows give a less
+    // noisy estimate but adapt more slowly to load changes.
+    int32 observations_per_bucket = 100;
+    // Minimum number of observations before a bucket's estimate is trusted.
+    int32 min_observations_per_bucket = 10;
+  };
+
+  explicit BatchSizeTuner(const Options& options);
+
+  // Records one observed latency for a batch of the given size.
+  void RecordLatency(int32 batch_size, int64 latency_micros);
+
+  // The largest batch size whose estimated p99 latency is within the
+  // target.  Returns options.max_batch_size while no measured bucket
+  // violates the target.
+  int32 TunedBatchSize() const;
+
+  // How long a non-full batch may wait before being scheduled: the slack
+  // between the target and the estimated p99 latency at TunedBatchSize().
+  // Returns 0 while the corresponding bucket has no trusted estimate.
+  int64 TunedTimeoutMicros() const;
+
+  // Estimated p99 latency for batches of the given size, or -1 if the
+  // bucket containing it has no trusted estimate yet.
+  int64 EstimatePercentileLatency(int32 batch_size) const;
+
+ private:
+  // Sliding window of latencies for one range of batch sizes.
+  struct Bucket {
+    std::vector<int64> latencies;  // circular buffer
+    int32 next_index = 0;
+    int64 num_observations = 0;
+  };
+
+  int32 BucketIndex(int32 batch_size) const;
+  // Upper bound (inclusive) of the batch sizes covered by bucket 'index'.
+  int32 BucketUpperBound(int32 index) const;
+  // p99 of the bucket's window, or -1 without min_observations_per_bucket.
+  int64 BucketPercentile(const Bucket& bucket) const
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Index of the bucket containing TunedBatchSize().
+  int32 TunedBucketIndex() const EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const Options options_;
+  mutable mutex mu_;
+  std::vector<Bucket> buckets_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(BatchSizeTuner);
+};
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_SIZE_TUNER_H_
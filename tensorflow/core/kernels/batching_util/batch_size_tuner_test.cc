@@ -0,0 +1,110 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_size_tuner.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+BatchSizeTuner::Options DefaultOptions() {
+  BatchSizeTuner::Options options;
+  options.max_batch_size = 800;
+  options.target_p99_latency_micros = 10000;
+  options.num_buckets = 8;
+  options.observations_per_bucket = 100;
+  options.min_observations_per_bucket = 10;
+  return options;
+}
+
+// Records enough observations of the given latency to make the bucket
+// containing batch_size trusted.
+void Observe(BatchSizeTuner* tuner, int32 batch_size, int64 latency_micros,
+             int count = 10) {
+  for (int i = 0; i < count; ++i) {
+    tuner->RecordLatency(batch_size, latency_micros);
+  }
+}
+
+TEST(BatchSizeTunerTest, RecommendsMaxBatchSizeWithoutObservations) {
+  BatchSizeTuner tuner(DefaultOptions());
+  EXPECT_EQ(800, tuner.TunedBatchSize());
+  // No trusted estimate, so no timeout recommendation either.
+  EXPECT_EQ(0, tuner.TunedTimeoutMicros());
+  EXPECT_EQ(-1, tuner.EstimatePercentileLatency(100));
+}
+
+TEST(BatchSizeTunerTest, BacksOffBelowViolatingBucket) {
+  BatchSizeTuner tuner(DefaultOptions());
+  // Batches of up to 400 meet the target; batches of ~500 exceed it.
+  Observe(&tuner, 100, 2000);
+  Observe(&tuner, 400, 8000);
+  Observe(&tuner, 500, 15000);
+  // Bucket [401, 500] violates the target, so the recommendation is the
+  // upper bound of the preceding bucket.
+  EXPECT_EQ(400, tuner.TunedBatchSize());
+  // Timeout is the slack at the recommended size: 10000 - 8000.
+  EXPECT_EQ(2000, tuner.TunedTimeoutMicros());
+}
+
+TEST(BatchSizeTunerTest, UntrustedBucketsDoNotConstrain) {
+  auto options = DefaultOptions();
+  BatchSizeTuner tuner(options);
+  // Fewer than min_observations_per_bucket observations of a bad latency.
+  Observe(&tuner, 500, 15000, options.min_observations_per_bucket - 1);
+  EXPECT_EQ(800, tuner.TunedBatchSize());
+  // One more observation makes the estimate trusted.
+  Observe(&tuner, 500, 15000, 1);
+  EXPECT_EQ(400, tuner.TunedBatchSize());
+}
+
+TEST(BatchSizeTunerTest, AdaptsToLoadChanges) {
+  auto options = DefaultOptions();
+  options.observations_per_bucket = 10;
+  BatchSizeTuner tuner(options);
+  Observe(&tuner, 500, 15000);
+  EXPECT_EQ(400, tuner.TunedBatchSize());
+  // Latency at size 500 improves; once the bad observations age out of the
+  // sliding window the recommendation recovers.
+  Observe(&tuner, 500, 5000, options.observations_per_bucket);
+  EXPECT_EQ(800, tuner.TunedBatchSize());
+}
+
+TEST(BatchSizeTunerTest, FirstBucketViolationRecommendsSmallestBucket) {
+  BatchSizeTuner tuner(DefaultOptions());
+  Observe(&tuner, 50, 20000);
+  // Even the smallest bucket misses the target; recommend its upper bound,
+  // since batch sizes cannot shrink further, and no wait time.
+  EXPECT_EQ(100, tuner.TunedBatchSize());
+  EXPECT_EQ(0, tuner.TunedTimeoutMicros());
+}
+
+TEST(BatchSizeTunerTest, PercentileEstimateIgnoresOutliersBelowP99) {
+  auto options = DefaultOptions();
+  options.observations_per_bucket = 200;
+  options.min_observations_per_bucket = 200;
+  BatchSizeTuner tuner(options);
+  // 198 fast observations and two slow ones: the slow observations make up
+  // the top 1% of the window and must dominate the p99 estimate.
+  Observe(&tuner, 300, 1000, 198);
+  Observe(&tuner, 300, 50000, 2);
+  EXPECT_EQ(50000, tuner.EstimatePercentileLatency(300));
+}
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
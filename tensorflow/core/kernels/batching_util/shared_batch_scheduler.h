@@ -17,15 +17,18 @@ limitations under the License.
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_SHARED_BATCH_SCHEDULER_H_
 
 #include <stddef.h>
+#include <algorithm>
 #include <deque>
 #include <functional>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
+#include "tensorflow/core/kernels/batching_util/batch_size_tuner.h"
 #include "tensorflow/core/kernels/batching_util/periodic_function.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -75,6 +78,15 @@ namespace serving {
 // BasicBatchScheduler instance, in the sense that it has maximum batch size and
 // timeout parameters, which govern when a batch is eligible to be processed.
 //
+// Queues can additionally be assigned a priority class, so that e.g.
+// interactive traffic does not queue behind bulk backfill work colocated in
+// the same process. Batch threads always prefer batches from the
+// highest-priority queues that have one ready, with round-robin servicing
+// within a class; see QueueOptions::priority. Under sustained high-priority
+// load this starves lower classes, so a bounded share of batches can be
+// reserved for them via
+// Options::high_priority_batches_per_low_priority_batch.
+//
 // Each queue is independently configured with a maximum size (in terms of the
 // maximum number of batches worth of enqueued tasks). For online serving, it is
 // recommended that the queue sizes be configured such that the sum of the sizes
@@ -111,6 +123,14 @@ class SharedBatchScheduler
     // Must be >= 1, and should be tuned carefully.
     int num_batch_threads = port::NumSchedulableCPUs();
 
+    // If positive, bounds how much lower-priority queues can be starved by
+    // higher-priority ones: each time this many consecutive batches have
+    // been scheduled from higher-priority queues while a lower-priority
+    // batch was waiting, one batch is scheduled from the lowest-priority
+    // class with work.  Zero means strict priority ordering.  Irrelevant
+    // when all queues have the same priority.
+    int32 high_priority_batches_per_low_priority_batch = 0;
+
     // The environment to use.
     // (Typically only overridden by test code.)
     Env* env = Env::Default();
@@ -158,6 +178,33 @@ class SharedBatchScheduler
     // See the class documentation above for guidelines on how to tune this
     // parameter.
     size_t max_enqueued_batches = 10;
+
+    // If positive, the queue adaptively tunes its effective batch size and
+    // timeout instead of using the static values above directly: it
+    // continuously estimates the batch-size -> latency curve from completed
+    // batches (latency measured from the batch's first task arriving to the
+    // batch being fully processed) and forms the largest batches whose
+    // estimated p99 latency stays within this target.  'max_batch_size'
+    // acts as an upper bound and 'batch_timeout_micros' applies until the
+    // curve has been learned.  Each queue learns its own curve, so models
+    // sharing the scheduler's batch threads are tuned in isolation.
+    int64 target_p99_latency_micros = 0;
+
+    // Scheduling priority class of this queue.  Batch threads always prefer
+    // schedulable batches from higher-priority queues; queues of equal
+    // priority are serviced round-robin.  See
+    // Options::high_priority_batches_per_low_priority_batch for bounding
+    // the resulting starvation of low-priority queues.
+    int32 priority = 0;
+
+    // If true, enqueueing a task into any higher-priority queue of the same
+    // scheduler immediately closes this queue's partially filled open
+    // batch, rather than letting it keep filling until max_batch_size or
+    // the timeout.  Keeping bulk batches small while interactive traffic is
+    // active bounds how long a newly arrived high-priority batch can be
+    // blocked behind a bulk batch already on a thread, at some cost in
+    // batching efficiency for this queue.
+    bool close_open_batch_on_higher_priority_arrival = false;
   };
   Status AddQueue(const QueueOptions& options,
                   std::function<void(std::unique_ptr<Batch<TaskType>>)>
@@ -173,6 +220,19 @@ class SharedBatchScheduler
   // no queues provide a batch to process, just sleeps briefly and exits.
   void ThreadLogic();
 
+  // Determines the priority class batch threads should currently draw from:
+  // the highest priority among queues with a schedulable batch, except that
+  // with a positive high_priority_batches_per_low_priority_batch the lowest
+  // such class is periodically selected instead.  Returns false if no queue
+  // has a schedulable batch.
+  bool ChooseTargetPriority(int32* target_priority)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Called when a task is enqueued into a queue with priority > 0.  Closes
+  // the partially filled open batches of lower-priority queues that have
+  // opted in via close_open_batch_on_higher_priority_arrival.
+  void OnHighPriorityTaskEnqueued(int32 priority);
+
   const Options options_;
 
   mutex mu_;
@@ -195,6 +255,11 @@ class SharedBatchScheduler
   // whenever a batch becomes schedulable.
   condition_variable schedulable_batch_cv_;
 
+  // Number of consecutive batches scheduled from higher-priority queues
+  // while a lower-priority batch was waiting.  Only maintained when
+  // options_.high_priority_batches_per_low_priority_batch is positive.
+  int64 consecutive_priority_overrides_ GUARDED_BY(mu_) = 0;
+
   // Threads that process batches obtained from the queues.
   std::vector<std::unique_ptr<PeriodicFunction>> batch_threads_;
 
@@ -230,9 +295,14 @@ class Queue {
   using ProcessBatchCallback =
       std::function<void(std::unique_ptr<Batch<TaskType>>)>;
   using SchedulableBatchCallback = std::function<void()>;
+  // Invoked after a task is enqueued into a queue with priority > 0, so the
+  // scheduler can react (e.g. close lower-priority open batches).  May be
+  // nullptr.
+  using HighPriorityTaskCallback = std::function<void()>;
   Queue(const typename SharedBatchScheduler<TaskType>::QueueOptions& options,
         Env* env, ProcessBatchCallback process_batch_callback,
-        SchedulableBatchCallback schdulable_batch_callback);
+        SchedulableBatchCallback schdulable_batch_callback,
+        HighPriorityTaskCallback high_priority_task_callback = nullptr);
 
   // Illegal to destruct unless the queue is empty.
   ~Queue();
@@ -261,6 +331,20 @@ class Queue {
   // Processes a batch that has been returned earlier by ScheduleBatch().
   void ProcessBatch(std::unique_ptr<Batch<TaskType>> batch);
 
+  // Whether a call to ScheduleBatch() would currently return a batch.
+  bool IsSchedulable() const;
+
+  // This queue's scheduling priority class.
+  int32 priority() const { return options_.priority; }
+
+  // Closes the open batch if it is partially filled, this queue has opted in
+  // via close_open_batch_on_higher_priority_arrival, and 'priority' is
+  // strictly higher than this queue's priority.  Called by the scheduler
+  // while holding its own mutex, so unlike Schedule() this does not invoke
+  // the schedulable-batch callback; the caller is responsible for waking a
+  // batch thread.
+  void MaybeCloseOpenBatchForPriority(int32 priority);
+
   // Determines whether the queue is empty, i.e. has no tasks waiting or being
   // processed.
   bool IsEmpty() const;
@@ -285,8 +369,21 @@ class Queue {
   // currently schedulable.
   bool IsOpenBatchSchedulable() const EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Effective limit on the size of the open batch: the tuner's current
+  // recommendation when adaptive batching is enabled, otherwise the static
+  // 'options_.max_batch_size'.
+  size_t effective_max_batch_size() const;
+
+  // Effective amount of time a non-full open batch waits before becoming
+  // schedulable.
+  int64 effective_batch_timeout_micros() const;
+
   const typename SharedBatchScheduler<TaskType>::QueueOptions options_;
 
+  // Estimates the batch-size -> latency curve and recommends batch sizes and
+  // timeouts.  Present iff 'options_.target_p99_latency_micros' > 0.
+  std::unique_ptr<BatchSizeTuner> tuner_;
+
   // The environment to use.
   Env* env_;
 
@@ -298,6 +395,10 @@ class Queue {
   // schedulable.
   SchedulableBatchCallback schedulable_batch_callback_;
 
+  // A callback invoked after a task has been enqueued, iff this queue's
+  // priority is > 0.  May be nullptr.
+  HighPriorityTaskCallback high_priority_task_callback_;
+
   mutable mutex mu_;
 
   // Whether this queue can accept new tasks. This variable is monotonic: it
@@ -312,6 +413,12 @@ class Queue {
   // in 'batches_'. Valid iff that batch contains at least one task.
   uint64 open_batch_start_time_micros_ GUARDED_BY(mu_);
 
+  // The time at which the first task was added to each non-empty batch, for
+  // batches not yet handed to ProcessBatch().  Only maintained when adaptive
+  // batching is enabled.
+  std::unordered_map<const Batch<TaskType>*, uint64> batch_start_times_
+      GUARDED_BY(mu_);
+
   // Whether this queue contains a batch that is eligible to be scheduled. Used
   // to keep track of when to call 'schedulable_batch_callback_'.
   bool schedulable_batch_ GUARDED_BY(mu_) = false;
@@ -365,6 +472,12 @@ Status SharedBatchScheduler<TaskType>::Create(
     return errors::InvalidArgument("num_batch_threads must be positive; was ",
                                    options.num_batch_threads);
   }
+  if (options.high_priority_batches_per_low_priority_batch < 0) {
+    return errors::InvalidArgument(
+        "high_priority_batches_per_low_priority_batch must be non-negative; "
+        "was ",
+        options.high_priority_batches_per_low_priority_batch);
+  }
   scheduler->reset(new SharedBatchScheduler<TaskType>(options));
   return Status::OK();
 }
@@ -408,15 +521,32 @@ Status SharedBatchScheduler<TaskType>::AddQueue(
         "max_enqueued_batches must be non-negative; was ",
         options.max_enqueued_batches);
   }
+  if (options.target_p99_latency_micros < 0) {
+    return errors::InvalidArgument(
+        "target_p99_latency_micros must be non-negative; was ",
+        options.target_p99_latency_micros);
+  }
+  if (options.priority < 0) {
+    return errors::InvalidArgument("priority must be non-negative; was ",
+                                   options.priority);
+  }
 
   auto schedulable_batch_callback = [this] {
     mutex_lock l(mu_);
     schedulable_batch_cv_.notify_one();
   };
+  typename internal::Queue<TaskType>::HighPriorityTaskCallback
+      high_priority_task_callback = nullptr;
+  if (options.priority > 0) {
+    const int32 priority = options.priority;
+    high_priority_task_callback = [this, priority] {
+      this->OnHighPriorityTaskEnqueued(priority);
+    };
+  }
   auto internal_queue =
       std::unique_ptr<internal::Queue<TaskType>>(new internal::Queue<TaskType>(
           options, options_.env, process_batch_callback,
-          schedulable_batch_callback));
+          schedulable_batch_callback, high_priority_task_callback));
   auto handle = std::unique_ptr<BatchScheduler<TaskType>>(
       new internal::QueueHandle<TaskType>(this->shared_from_this(),
                                           internal_queue.get()));
@@ -455,6 +585,12 @@ void SharedBatchScheduler<TaskType>::ThreadLogic() {
   {
     mutex_lock l(mu_);
 
+    // Determine the priority class to draw from.  With all queues at equal
+    // priority every queue belongs to the target class, and the servicing
+    // order below degenerates to plain round-robin.
+    int32 target_priority = 0;
+    const bool have_schedulable_queue = ChooseTargetPriority(&target_priority);
+
     const int num_queues = queues_.size();
     for (int num_queues_tried = 0;
          batch_to_process == nullptr && num_queues_tried < num_queues;
@@ -467,8 +603,12 @@ void SharedBatchScheduler<TaskType>::ThreadLogic() {
       // calling ScheduleBatch().
       const bool queue_closed = (*next_queue_to_schedule_)->closed();
 
-      // Ask '*next_queue_to_schedule_' if it wants us to process a batch.
-      batch_to_process = (*next_queue_to_schedule_)->ScheduleBatch();
+      // Ask '*next_queue_to_schedule_' if it wants us to process a batch, but
+      // only if it belongs to the priority class being serviced.
+      if (have_schedulable_queue &&
+          (*next_queue_to_schedule_)->priority() == target_priority) {
+        batch_to_process = (*next_queue_to_schedule_)->ScheduleBatch();
+      }
       if (batch_to_process != nullptr) {
         queue_for_batch = next_queue_to_schedule_->get();
       }
@@ -500,17 +640,70 @@ void SharedBatchScheduler<TaskType>::ThreadLogic() {
   queue_for_batch->ProcessBatch(std::move(batch_to_process));
 }
 
+template <typename TaskType>
+bool SharedBatchScheduler<TaskType>::ChooseTargetPriority(
+    int32* target_priority) {
+  bool found = false;
+  int32 max_priority = 0;
+  int32 min_priority = 0;
+  for (const auto& queue : queues_) {
+    if (!queue->IsSchedulable()) continue;
+    if (!found) {
+      max_priority = min_priority = queue->priority();
+      found = true;
+    } else {
+      max_priority = std::max(max_priority, queue->priority());
+      min_priority = std::min(min_priority, queue->priority());
+    }
+  }
+  if (!found) return false;
+  *target_priority = max_priority;
+  if (max_priority == min_priority) {
+    consecutive_priority_overrides_ = 0;
+  } else if (options_.high_priority_batches_per_low_priority_batch > 0 &&
+             consecutive_priority_overrides_ >=
+                 options_.high_priority_batches_per_low_priority_batch) {
+    // Lower-priority batches have been passed over long enough; give the
+    // most starved class a turn.
+    *target_priority = min_priority;
+    consecutive_priority_overrides_ = 0;
+  } else {
+    ++consecutive_priority_overrides_;
+  }
+  return true;
+}
+
+template <typename TaskType>
+void SharedBatchScheduler<TaskType>::OnHighPriorityTaskEnqueued(
+    int32 priority) {
+  mutex_lock l(mu_);
+  for (const auto& queue : queues_) {
+    queue->MaybeCloseOpenBatchForPriority(priority);
+  }
+  // Closed batches, if any, are now schedulable.
+  schedulable_batch_cv_.notify_one();
+}
+
 namespace internal {
 
 template <typename TaskType>
 Queue<TaskType>::Queue(
     const typename SharedBatchScheduler<TaskType>::QueueOptions& options,
     Env* env, ProcessBatchCallback process_batch_callback,
-    SchedulableBatchCallback schedulable_batch_callback)
+    SchedulableBatchCallback schedulable_batch_callback,
+    HighPriorityTaskCallback high_priority_task_callback)
     : options_(options),
       env_(env),
       process_batch_callback_(process_batch_callback),
-      schedulable_batch_callback_(schedulable_batch_callback) {
+      schedulable_batch_callback_(schedulable_batch_callback),
+      high_priority_task_callback_(high_priority_task_callback) {
+  if (options.target_p99_latency_micros > 0) {
+    BatchSizeTuner::Options tuner_options;
+    tuner_options.max_batch_size = options.max_batch_size;
+    tuner_options.target_p99_latency_micros =
+        options.target_p99_latency_micros;
+    tuner_.reset(new BatchSizeTuner(tuner_options));
+  }
   // Create an initial, open batch.
   batches_.emplace_back(new Batch<TaskType>);
 }
@@ -538,7 +731,8 @@ Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
 
     DCHECK(!closed_);
 
-    if (batches_.back()->size() + (*task)->size() > options_.max_batch_size) {
+    if (batches_.back()->size() + (*task)->size() >
+        effective_max_batch_size()) {
       if (batches_.size() >= options_.max_enqueued_batches) {
         return errors::Unavailable(
             "The batch scheduling queue to which this task was submitted is "
@@ -548,6 +742,10 @@ Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
     }
     if (batches_.back()->empty()) {
       open_batch_start_time_micros_ = env_->NowMicros();
+      if (tuner_) {
+        batch_start_times_[batches_.back().get()] =
+            open_batch_start_time_micros_;
+      }
     }
     batches_.back()->AddTask(std::move(*task));
 
@@ -562,6 +760,9 @@ Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
   if (notify_of_schedulable_batch) {
     schedulable_batch_callback_();
   }
+  if (options_.priority > 0 && high_priority_task_callback_ != nullptr) {
+    high_priority_task_callback_();
+  }
 
   return Status::OK();
 }
@@ -616,8 +817,24 @@ std::unique_ptr<Batch<TaskType>> Queue<TaskType>::ScheduleBatch() {
 
 template <typename TaskType>
 void Queue<TaskType>::ProcessBatch(std::unique_ptr<Batch<TaskType>> batch) {
+  uint64 batch_start_time_micros = 0;
+  if (tuner_) {
+    mutex_lock l(mu_);
+    auto it = batch_start_times_.find(batch.get());
+    if (it != batch_start_times_.end()) {
+      batch_start_time_micros = it->second;
+      batch_start_times_.erase(it);
+    }
+  }
+  const int32 batch_size = batch->size();
+
   process_batch_callback_(std::move(batch));
 
+  if (tuner_ && batch_start_time_micros > 0) {
+    tuner_->RecordLatency(batch_size,
+                          env_->NowMicros() - batch_start_time_micros);
+  }
+
   {
     mutex_lock l(mu_);
     --num_batches_being_processed_;
@@ -627,6 +844,27 @@ void Queue<TaskType>::ProcessBatch(std::unique_ptr<Batch<TaskType>> batch) {
   }
 }
 
+template <typename TaskType>
+bool Queue<TaskType>::IsSchedulable() const {
+  mutex_lock l(mu_);
+  return batches_.size() >= 2 || IsOpenBatchSchedulable();
+}
+
+template <typename TaskType>
+void Queue<TaskType>::MaybeCloseOpenBatchForPriority(int32 priority) {
+  if (!options_.close_open_batch_on_higher_priority_arrival ||
+      priority <= options_.priority) {
+    return;
+  }
+  mutex_lock l(mu_);
+  if (batches_.back()->empty()) return;
+  // Respect the max_enqueued_batches invariant; if the queue is at capacity
+  // the open batch will be scheduled soon enough anyway.
+  if (batches_.size() >= options_.max_enqueued_batches) return;
+  StartNewBatch();
+  schedulable_batch_ = true;
+}
+
 template <typename TaskType>
 bool Queue<TaskType>::IsEmpty() const {
   mutex_lock l(mu_);
@@ -667,9 +905,23 @@ bool Queue<TaskType>::IsOpenBatchSchedulable() const {
   if (open_batch->empty()) {
     return false;
   }
-  return closed_ || open_batch->size() >= options_.max_batch_size ||
+  return closed_ || open_batch->size() >= effective_max_batch_size() ||
          env_->NowMicros() >=
-             open_batch_start_time_micros_ + options_.batch_timeout_micros;
+             open_batch_start_time_micros_ + effective_batch_timeout_micros();
+}
+
+template <typename TaskType>
+size_t Queue<TaskType>::effective_max_batch_size() const {
+  if (!tuner_) return options_.max_batch_size;
+  return std::min<size_t>(tuner_->TunedBatchSize(), options_.max_batch_size);
+}
+
+template <typename TaskType>
+int64 Queue<TaskType>::effective_batch_timeout_micros() const {
+  if (!tuner_) return options_.batch_timeout_micros;
+  const int64 tuned_timeout = tuner_->TunedTimeoutMicros();
+  // Until the tuner has a trusted estimate, stay with the static timeout.
+  return tuned_timeout > 0 ? tuned_timeout : options_.batch_timeout_micros;
 }
 
 template <typename TaskType>
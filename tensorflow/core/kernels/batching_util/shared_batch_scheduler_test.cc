@@ -591,6 +591,145 @@ TEST(SharedBatchSchedulerTest, QueueDestructorBlocksUntilAllTasksProcessed) {
   stop_teardown.Notify();
 }
 
+TEST(SharedBatchSchedulerTest, HigherPriorityQueueServicedFirst) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    mutex mu;
+    std::vector<string> processing_order;
+    Notification blocker_started, blocker_proceed, interactive_processed;
+    auto bulk_callback = [&mu, &processing_order, &blocker_started,
+                          &blocker_proceed](
+                             std::unique_ptr<Batch<FakeTask>> batch) {
+      if (!blocker_started.HasBeenNotified()) {
+        // The first bulk batch occupies the sole batch thread until the
+        // backlog below has been enqueued.
+        blocker_started.Notify();
+        blocker_proceed.WaitForNotification();
+        return;
+      }
+      mutex_lock l(mu);
+      processing_order.push_back("bulk");
+    };
+    auto interactive_callback =
+        [&mu, &processing_order,
+         &interactive_processed](std::unique_ptr<Batch<FakeTask>> batch) {
+          {
+            mutex_lock l(mu);
+            processing_order.push_back("interactive");
+          }
+          interactive_processed.Notify();
+        };
+
+    SharedBatchScheduler<FakeTask>::Options options;
+    options.num_batch_threads = 1;
+    options.env = &env;
+    std::shared_ptr<SharedBatchScheduler<FakeTask>> scheduler;
+    TF_ASSERT_OK(SharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+
+    SharedBatchScheduler<FakeTask>::QueueOptions bulk_options;
+    bulk_options.max_batch_size = 10;
+    bulk_options.batch_timeout_micros = 0;
+    bulk_options.max_enqueued_batches = 100;
+    std::unique_ptr<BatchScheduler<FakeTask>> bulk_queue;
+    TF_ASSERT_OK(scheduler->AddQueue(bulk_options, bulk_callback, &bulk_queue));
+
+    SharedBatchScheduler<FakeTask>::QueueOptions interactive_options =
+        bulk_options;
+    interactive_options.priority = 1;
+    std::unique_ptr<BatchScheduler<FakeTask>> interactive_queue;
+    TF_ASSERT_OK(scheduler->AddQueue(interactive_options, interactive_callback,
+                                     &interactive_queue));
+
+    // Occupy the batch thread with a bulk batch, then build up a bulk backlog
+    // with one interactive batch behind it.
+    TF_ASSERT_OK(ScheduleTask(10, bulk_queue.get()));
+    blocker_started.WaitForNotification();
+    TF_ASSERT_OK(ScheduleTask(10, bulk_queue.get()));
+    TF_ASSERT_OK(ScheduleTask(10, bulk_queue.get()));
+    TF_ASSERT_OK(ScheduleTask(10, interactive_queue.get()));
+    blocker_proceed.Notify();
+
+    // Despite being enqueued last, the interactive batch must be processed
+    // before the remaining bulk batches.
+    interactive_processed.WaitForNotification();
+    {
+      mutex_lock l(mu);
+      ASSERT_FALSE(processing_order.empty());
+      EXPECT_EQ("interactive", processing_order.front());
+    }
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST(SharedBatchSchedulerTest, HighPriorityArrivalClosesOpenBulkBatch) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    Notification bulk_batch_processed;
+    size_t bulk_batch_size = 0;
+    auto bulk_callback = [&bulk_batch_processed, &bulk_batch_size](
+                             std::unique_ptr<Batch<FakeTask>> batch) {
+      bulk_batch_size = batch->size();
+      bulk_batch_processed.Notify();
+    };
+    Notification interactive_processed;
+    auto interactive_callback =
+        [&interactive_processed](std::unique_ptr<Batch<FakeTask>> batch) {
+          interactive_processed.Notify();
+        };
+
+    SharedBatchScheduler<FakeTask>::Options options;
+    options.num_batch_threads = 2;
+    options.env = &env;
+    std::shared_ptr<SharedBatchScheduler<FakeTask>> scheduler;
+    TF_ASSERT_OK(SharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+
+    // The bulk queue would wait an hour for its batch to fill, but opts in to
+    // having the open batch closed when interactive traffic arrives.
+    SharedBatchScheduler<FakeTask>::QueueOptions bulk_options;
+    bulk_options.max_batch_size = 10;
+    bulk_options.batch_timeout_micros = 60 * 60 * 1000000LL;
+    bulk_options.max_enqueued_batches = 100;
+    bulk_options.close_open_batch_on_higher_priority_arrival = true;
+    std::unique_ptr<BatchScheduler<FakeTask>> bulk_queue;
+    TF_ASSERT_OK(scheduler->AddQueue(bulk_options, bulk_callback, &bulk_queue));
+
+    SharedBatchScheduler<FakeTask>::QueueOptions interactive_options;
+    interactive_options.max_batch_size = 1;
+    interactive_options.batch_timeout_micros = 0;
+    interactive_options.max_enqueued_batches = 100;
+    interactive_options.priority = 1;
+    std::unique_ptr<BatchScheduler<FakeTask>> interactive_queue;
+    TF_ASSERT_OK(scheduler->AddQueue(interactive_options, interactive_callback,
+                                     &interactive_queue));
+
+    // A partial bulk batch accumulates; nothing is schedulable yet.
+    TF_ASSERT_OK(ScheduleTask(2, bulk_queue.get()));
+    TF_ASSERT_OK(ScheduleTask(1, bulk_queue.get()));
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+    EXPECT_FALSE(bulk_batch_processed.HasBeenNotified());
+
+    // An interactive task truncates the bulk batch instead of letting it keep
+    // filling for up to an hour.
+    TF_ASSERT_OK(ScheduleTask(1, interactive_queue.get()));
+    interactive_processed.WaitForNotification();
+    bulk_batch_processed.WaitForNotification();
+    EXPECT_EQ(3, bulk_batch_size);
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
 }  // namespace
 }  // namespace serving
 }  // namespace tensorflow
@@ -23,6 +23,24 @@ typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
 
 CastFunctorType GetCpuCastFromBfloat(DataType dst_dtype) {
+  if (dst_dtype == DT_FLOAT) {
+    // The Eigen scalar_cast_op for bfloat16 has no packet access, so the
+    // expression-based cast converts one element at a time. The bulk
+    // BFloat16ToFloat conversion is a plain widening byte shuffle that the
+    // compiler vectorizes, so route through it and shard large tensors over
+    // the worker threads.
+    return [](OpKernelContext* ctx, const Tensor& inp, Tensor* out,
+              bool truncate) {
+      int64 N = out->NumElements();
+      auto worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+      Shard(worker_threads->num_threads, worker_threads->workers, N, 2,
+            [&inp, &out](int64 start, int64 limit) {
+              BFloat16ToFloat(inp.flat<bfloat16>().data() + start,
+                              out->flat<float>().data() + start,
+                              limit - start);
+            });
+    };
+  }
   CURRY_TYPES3(CAST_CASE, CPUDevice, bfloat16);
   return nullptr;
 }
@@ -23,6 +23,29 @@ typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
 
 CastFunctorType GetCpuCastFromFloat(DataType dst_dtype) {
+  if (dst_dtype == DT_BFLOAT16) {
+    return [](OpKernelContext* ctx, const Tensor& inp, Tensor* out,
+              bool truncate) {
+      // With the Truncate attribute the cast is a pure byte shuffle, which
+      // the bulk FloatToBFloat16 conversion performs in a form the compiler
+      // vectorizes; the LSB-zeroing Eigen expression it replaces converts one
+      // element at a time. Rounding casts keep the Eigen expression.
+      if (truncate) {
+        int64 N = out->NumElements();
+        auto worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+        Shard(worker_threads->num_threads, worker_threads->workers, N, 2,
+              [&inp, &out](int64 start, int64 limit) {
+                FloatToBFloat16(inp.flat<float>().data() + start,
+                                out->flat<bfloat16>().data() + start,
+                                limit - start);
+              });
+      } else {
+        functor::CastFunctor<CPUDevice, bfloat16, float> func;
+        func(ctx->eigen_device<CPUDevice>(), out->flat<bfloat16>(),
+             inp.flat<float>(), false);
+      }
+    };
+  }
   CURRY_TYPES3(CAST_CASE, CPUDevice, float);
   return nullptr;
 }
@@ -15,12 +15,33 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/cast_op_impl.h"
 
+#include "tensorflow/core/util/work_sharder.h"
+
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
 
 CastFunctorType GetCpuCastFromUint8(DataType dst_dtype) {
+  if (dst_dtype == DT_FLOAT) {
+    // Eigen has no packet conversion from uint8 to float, so the
+    // expression-based cast is a scalar loop. A plain indexed loop compiles
+    // to a SIMD widen-and-convert; shard large tensors over the worker
+    // threads since this conversion dominates image input pipelines.
+    return [](OpKernelContext* ctx, const Tensor& inp, Tensor* out,
+              bool truncate) {
+      int64 N = out->NumElements();
+      auto worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+      Shard(worker_threads->num_threads, worker_threads->workers, N, 2,
+            [&inp, &out](int64 start, int64 limit) {
+              const uint8* src = inp.flat<uint8>().data();
+              float* dst = out->flat<float>().data();
+              for (int64 i = start; i < limit; ++i) {
+                dst[i] = static_cast<float>(src[i]);
+              }
+            });
+    };
+  }
   CURRY_TYPES3(CAST_CASE, CPUDevice, uint8);
   return nullptr;
 }
@@ -19,6 +19,7 @@ limitations under the License.
 #include <vector>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -149,6 +150,44 @@ class ConcatBaseOp : public OpKernel {
     } else {
       output_shape.set_dim(axis, output_concat_dim);
     }
+    // If every input is a sub-buffer of one backing allocation, laid out
+    // contiguously in concat order starting at the allocation's base — e.g.
+    // zero-copy slices of one tensor being reassembled — then the
+    // concatenation is already materialized in that allocation, and the
+    // output can alias it instead of copying every byte. This requires the
+    // concat to be a pure memory concatenation (no leading dimensions, so
+    // inputs_flat_dim0 == 1).
+    if (std::is_same<Device, CPUDevice>::value && N > 1 &&
+        inputs_flat_dim0 == 1 && output_shape.num_elements() > 0) {
+      bool alias_inputs = true;
+      for (int i = 0; i < N && alias_inputs; ++i) {
+        alias_inputs = values[i].NumElements() > 0;
+      }
+      if (alias_inputs) {
+        TensorBuffer* root_buf =
+            const_cast<TensorBuffer*>(DMAHelper::buffer(&values[0]))
+                ->root_buffer();
+        StringPiece prev = values[0].tensor_data();
+        alias_inputs = prev.data() == root_buf->data();
+        size_t total_bytes = prev.size();
+        for (int i = 1; i < N && alias_inputs; ++i) {
+          const StringPiece curr = values[i].tensor_data();
+          alias_inputs =
+              const_cast<TensorBuffer*>(DMAHelper::buffer(&values[i]))
+                      ->root_buffer() == root_buf &&
+              curr.data() == prev.data() + prev.size();
+          total_bytes += curr.size();
+          prev = curr;
+        }
+        if (alias_inputs && total_bytes <= root_buf->size()) {
+          VLOG(1) << "Concat aliasing backing buffer of contiguous inputs";
+          c->set_output(0, DMAHelper::MakeTensor(values[0].dtype(),
+                                                 output_shape, root_buf));
+          return;
+        }
+      }
+    }
+
     Tensor* output = nullptr;
     OP_REQUIRES_OK(c, c->allocate_output(0, output_shape, &output));
     if (output->NumElements() > 0) {
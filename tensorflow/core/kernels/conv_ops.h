@@ -68,6 +68,32 @@ struct Im2ColBufferResource : public ResourceBase {
   string DebugString() const { return "Im2ColBufferResource"; }
 };
 
+// Like Im2ColBufferResource, but sized at runtime rather than at compile time.
+// The buffer grows to the largest size requested so far and is then reused
+// across op invocations, so steady-state serving performs no scratch
+// allocations.
+template <class T>
+struct ConvScratchBufferResource : public ResourceBase {
+  ~ConvScratchBufferResource() { port::Free(data); }
+  // Returns a buffer holding at least 'size' elements, growing the
+  // allocation if needed. The contents of the buffer are undefined. Callers
+  // must hold 'mu'.
+  T* Reserve(size_t size) {
+    if (size > capacity) {
+      port::Free(data);
+      data = static_cast<T*>(port::Malloc(size * sizeof(T)));
+      capacity = size;
+    }
+    return data;
+  }
+  // This mutex ensures that only a single operation at a time is able to use
+  // the buffer memory held by this resource.
+  mutex mu;
+  T* data = nullptr;
+  size_t capacity = 0;
+  string DebugString() const { return "ConvScratchBufferResource"; }
+};
+
 // Convolution parameters specified by Op attributes.
 struct Conv2DParameters {
   std::vector<int32> dilations;
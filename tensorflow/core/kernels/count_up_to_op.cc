@@ -88,6 +88,9 @@ class ResourceCountUpToOp : public OpKernel {
     Tensor* tmp;
     OP_REQUIRES_OK(context, context->allocate_persistent(
                                 dtype_, TensorShape({}), &unused, &tmp, attr));
+    // Drop any frozen snapshot before replacing the buffer, so readers see
+    // the post-increment value rather than aliasing the old one.
+    variable->Unfreeze();
     *variable->tensor() = *tmp;
     tmp->scalar<T>()() = before_increment.scalar<T>()() + 1;
     context->set_output(0, before_increment);
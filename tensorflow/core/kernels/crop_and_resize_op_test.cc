@@ -455,4 +455,77 @@ TEST_F(CropAndResizeOpTest, TestWithSharding) {
   test::ExpectTensorEqual<float>(expected, *GetOutput(0));
 }
 
+class CropAndResizeNormalizeOpTest : public OpsTestBase {
+ protected:
+  template <typename T>
+  void MakeOp(float extrapolation_value) {
+    TF_EXPECT_OK(
+        NodeDefBuilder("crop_and_resize_normalize_op", "CropAndResizeNormalize")
+            .Input(FakeInput(DataTypeToEnum<T>::value))
+            .Input(FakeInput(DT_FLOAT))
+            .Input(FakeInput(DT_INT32))
+            .Input(FakeInput(DT_INT32))
+            .Input(FakeInput(DT_FLOAT))
+            .Input(FakeInput(DT_FLOAT))
+            .Attr("extrapolation_value", extrapolation_value)
+            .Finalize(node_def()));
+    TF_EXPECT_OK(InitOp());
+  }
+};
+
+TEST_F(CropAndResizeNormalizeOpTest, TestCropAndResizeNormalize2x2To3x3) {
+  MakeOp<float>(0);
+  // Input:
+  //  1, 2
+  //  3, 4
+  AddInputFromArray<float>(TensorShape({1, 2, 2, 1}), {1, 2, 3, 4});
+  AddInputFromArray<float>(TensorShape({1, 4}), {0, 0, 1, 1});
+  AddInputFromArray<int32>(TensorShape({1}), {0});
+  AddInputFromArray<int32>(TensorShape({2}), {3, 3});
+  AddInputFromArray<float>(TensorShape({1}), {1.0});
+  AddInputFromArray<float>(TensorShape({1}), {0.5});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // The bilinear samples are {1, 1.5, 2, 2, 2.5, 3, 3, 3.5, 4}, normalized
+  // as (sample - 1) * 0.5.
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({1, 3, 3, 1}));
+  test::FillValues<float>(&expected,
+                          {0, 0.25, 0.5, 0.5, 0.75, 1, 1, 1.25, 1.5});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(CropAndResizeNormalizeOpTest, TestPerChannelAndExtrapolation) {
+  MakeOp<uint8>(3);
+  // One 1x2 image with two channels.
+  AddInputFromArray<uint8>(TensorShape({1, 1, 2, 2}), {10, 20, 30, 40});
+  // The second half of the box extends past the right edge of the image.
+  AddInputFromArray<float>(TensorShape({1, 4}), {0, 0, 1, 2});
+  AddInputFromArray<int32>(TensorShape({1}), {0});
+  AddInputFromArray<int32>(TensorShape({2}), {1, 3});
+  AddInputFromArray<float>(TensorShape({2}), {10, 20});
+  AddInputFromArray<float>(TensorShape({2}), {0.1, 0.5});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Samples per channel are {10, 30, extrapolated 3} and
+  // {20, 40, extrapolated 3}; extrapolated values are normalized too.
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({1, 1, 3, 2}));
+  test::FillValues<float>(&expected, {0, 0, 2, 10, -0.7, -8.5});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(CropAndResizeNormalizeOpTest, TestInvalidMeanShape) {
+  MakeOp<float>(0);
+  AddInputFromArray<float>(TensorShape({1, 2, 2, 1}), {1, 2, 3, 4});
+  AddInputFromArray<float>(TensorShape({1, 4}), {0, 0, 1, 1});
+  AddInputFromArray<int32>(TensorShape({1}), {0});
+  AddInputFromArray<int32>(TensorShape({2}), {1, 1});
+  AddInputFromArray<float>(TensorShape({2}), {1.0, 2.0});
+  AddInputFromArray<float>(TensorShape({1}), {1.0});
+  Status s = RunOpKernel();
+  ASSERT_FALSE(s.ok());
+  EXPECT_TRUE(
+      str_util::StrContains(s.ToString(), "mean must be 1-D with size"))
+      << s;
+}
+
 }  // namespace tensorflow
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/ctc/ctc_beam_search.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
 #include "tensorflow/core/util/work_sharder.h"
@@ -298,35 +299,56 @@ class CTCBeamSearchDecoderOp : public OpKernel {
                                 batch_size, num_classes);
     }
 
-    ctc::CTCBeamSearchDecoder<> beam_search(num_classes, beam_width_,
-                                            &beam_scorer_, 1 /* batch_size */,
-                                            merge_repeated_);
-    Tensor input_chip(DT_FLOAT, TensorShape({num_classes}));
-    auto input_chip_t = input_chip.flat<float>();
-
     std::vector<std::vector<std::vector<int> > > best_paths(batch_size);
-    std::vector<float> log_probs;
 
-    // Assumption: the blank index is num_classes - 1
-    for (int b = 0; b < batch_size; ++b) {
-      auto& best_paths_b = best_paths[b];
-      best_paths_b.resize(decode_helper_.GetTopPaths());
-      for (int t = 0; t < seq_len_t(b); ++t) {
-        input_chip_t = input_list_t[t].chip(b, 0);
-        auto input_bi =
-            Eigen::Map<const Eigen::ArrayXf>(input_chip_t.data(), num_classes);
-        beam_search.Step(input_bi);
-      }
-      OP_REQUIRES_OK(
-          ctx, beam_search.TopPaths(decode_helper_.GetTopPaths(), &best_paths_b,
-                                    &log_probs, merge_repeated_));
+    // Utterances are decoded independently, so shard across the batch.  Each
+    // shard runs its own decoder: the beam state (and its entry pool) cannot
+    // be shared between threads.  The default scorer is stateless and safe to
+    // share.  Writes are disjoint: shard b only touches best_paths[b] and row
+    // b of log_prob_t.
+    mutex status_mu;
+    Status decode_status;
+    auto decode = [&](const int64 begin, const int64 end) {
+      ctc::CTCBeamSearchDecoder<> beam_search(num_classes, beam_width_,
+                                              &beam_scorer_, 1 /* batch_size */,
+                                              merge_repeated_);
+      Tensor input_chip(DT_FLOAT, TensorShape({num_classes}));
+      auto input_chip_t = input_chip.flat<float>();
+      std::vector<float> log_probs;
+
+      // Assumption: the blank index is num_classes - 1
+      for (int64 b = begin; b < end; ++b) {
+        auto& best_paths_b = best_paths[b];
+        best_paths_b.resize(decode_helper_.GetTopPaths());
+        for (int t = 0; t < seq_len_t(b); ++t) {
+          input_chip_t = input_list_t[t].chip(b, 0);
+          auto input_bi = Eigen::Map<const Eigen::ArrayXf>(input_chip_t.data(),
+                                                           num_classes);
+          beam_search.Step(input_bi);
+        }
+        Status s = beam_search.TopPaths(decode_helper_.GetTopPaths(),
+                                        &best_paths_b, &log_probs,
+                                        merge_repeated_);
+        if (!s.ok()) {
+          mutex_lock l(status_mu);
+          decode_status.Update(s);
+          return;
+        }
 
-      beam_search.Reset();
+        beam_search.Reset();
 
-      for (int bp = 0; bp < decode_helper_.GetTopPaths(); ++bp) {
-        log_prob_t(b, bp) = log_probs[bp];
+        for (int bp = 0; bp < decode_helper_.GetTopPaths(); ++bp) {
+          log_prob_t(b, bp) = log_probs[bp];
+        }
       }
-    }
+    };
+
+    const int64 kCostPerUnit = 50 * max_time * num_classes * beam_width_;
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, batch_size,
+          kCostPerUnit, decode);
+    OP_REQUIRES_OK(ctx, decode_status);
 
     OP_REQUIRES_OK(ctx, decode_helper_.StoreAllDecodedSequences(
                             best_paths, &decoded_indices, &decoded_values,
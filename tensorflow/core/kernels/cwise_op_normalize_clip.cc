@@ -0,0 +1,99 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+// Computes clip((t - shift) / scale, clip_value_min, clip_value_max) in a
+// single pass over the input.  The grappler remapper creates this op from
+// Sub + RealDiv + ClipByValue chains with scalar statistics, the per-feature
+// normalization pattern in serving graphs; fusing the three elementwise ops
+// avoids materializing two intermediate tensors.
+template <typename Device, typename T>
+class FusedNormalizeClipOp : public OpKernel {
+ public:
+  explicit FusedNormalizeClipOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor& in0 = ctx->input(0);
+    const Tensor& in1 = ctx->input(1);
+    const Tensor& in2 = ctx->input(2);
+    const Tensor& in3 = ctx->input(3);
+    const Tensor& in4 = ctx->input(4);
+    OP_REQUIRES(ctx,
+                TensorShapeUtils::IsScalar(in1.shape()) &&
+                    TensorShapeUtils::IsScalar(in2.shape()) &&
+                    TensorShapeUtils::IsScalar(in3.shape()) &&
+                    TensorShapeUtils::IsScalar(in4.shape()),
+                errors::InvalidArgument(
+                    "shift, scale, clip_value_min and clip_value_max must be "
+                    "scalars. ",
+                    "shift shape: ", in1.shape().DebugString(),
+                    "scale shape: ", in2.shape().DebugString(),
+                    "clip_value_min shape: ", in3.shape().DebugString(),
+                    "clip_value_max shape: ", in4.shape().DebugString()));
+
+    Tensor* out = nullptr;
+    OP_REQUIRES_OK(
+        ctx, ctx->forward_input_or_allocate_output({0}, 0, in0.shape(), &out));
+    if (out->NumElements() == 0) return;  // Nothing to do for empty output
+
+    auto in0_flat = in0.flat<T>();
+    auto out_flat = out->flat<T>();
+    const Device& d = ctx->eigen_device<Device>();
+
+    const T shift = in1.scalar<T>()();
+    const T scale = in2.scalar<T>()();
+    // Clipping matches the scalar-bounds path of ClipByValue bit for bit, and
+    // the division is kept as a division so results are identical to the
+    // unfused Sub + RealDiv + ClipByValue chain.
+    out_flat.device(d) =
+        ((in0_flat - in0_flat.constant(shift)) / in0_flat.constant(scale))
+            .unaryExpr(NormalizeClipFunc(in3.scalar<T>()(), in4.scalar<T>()()));
+  }
+
+ private:
+  struct NormalizeClipFunc {
+    NormalizeClipFunc(const T& value_min, const T& value_max)
+        : value_min(value_min), value_max(value_max) {}
+    const T operator()(const T& value) const {
+      return std::max(std::min(value, value_max), value_min);
+    }
+    T value_min;
+    T value_max;
+  };
+};
+
+#define REGISTER_CPU_KERNEL(type)                             \
+  REGISTER_KERNEL_BUILDER(Name("_FusedNormalizeClip")         \
+                              .Device(DEVICE_CPU)             \
+                              .TypeConstraint<type>("T"),     \
+                          FusedNormalizeClipOp<CPUDevice, type>);
+
+REGISTER_CPU_KERNEL(Eigen::half);
+REGISTER_CPU_KERNEL(float);
+REGISTER_CPU_KERNEL(double);
+#undef REGISTER_CPU_KERNEL
+
+}  // namespace tensorflow
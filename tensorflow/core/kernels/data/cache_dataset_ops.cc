@@ -16,8 +16,13 @@ limitations under the License.
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
 namespace tensorflow {
@@ -27,6 +32,22 @@ namespace {
 // See documentation in ../../ops/dataset_ops.cc for a high-level description of
 // the following op.
 
+// Returns true if newly created file caches should use the indexed cache
+// format instead of a `TensorBundle`. The indexed format stores the cached
+// elements in an append-only record file next to a fixed-stride offset index,
+// so re-opening the cache positions at any element in O(1) instead of
+// replaying bundle metadata. Existing caches are always read back in the
+// format they were written in, regardless of this setting.
+bool IndexedCacheFormatEnabled() {
+  static const bool result = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_CACHE_INDEXED_FORMAT",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
 class CacheDatasetOp : public UnaryDatasetOpKernel {
  public:
   explicit CacheDatasetOp(OpKernelConstruction* ctx)
@@ -109,14 +130,35 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
                              tensor_index);
     }
 
+    // Filenames used by the indexed cache format. The index file is written
+    // under a temporary name while the cache is incomplete and renamed to
+    // `IndexedIndexFilename()` once the input has been exhausted, so its
+    // presence under the final name marks a fully written cache.
+    string IndexedDataFilename() const {
+      return strings::StrCat(filename_, ".indexed-data");
+    }
+    string IndexedIndexFilename() const {
+      return strings::StrCat(filename_, ".indexed-index");
+    }
+    string IndexedIndexTempFilename() const {
+      return strings::StrCat(IndexedIndexFilename(), ".tmp");
+    }
+    string IndexedLockFilename() const {
+      return strings::StrCat(filename_, ".indexed.lockfile");
+    }
+
     class FileIterator : public DatasetIterator<FileDataset> {
      public:
       explicit FileIterator(const Params& params)
           : DatasetIterator<FileDataset>(params) {
-        if (params.dataset->env_
-                ->FileExists(MetaFilename(params.dataset->filename_))
-                .ok()) {
+        Env* env = params.dataset->env_;
+        if (env->FileExists(params.dataset->IndexedIndexFilename()).ok()) {
+          mode_ = Mode::indexed_read;
+        } else if (env->FileExists(MetaFilename(params.dataset->filename_))
+                       .ok()) {
           mode_ = Mode::read;
+        } else if (IndexedCacheFormatEnabled()) {
+          mode_ = Mode::indexed_write;
         } else {
           mode_ = Mode::write;
         }
@@ -170,6 +212,20 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
               << "and try running again.";
           mode_ = Mode::read;
         }
+        if (mode_ == Mode::indexed_write &&
+            dataset()
+                ->env_->FileExists(dataset()->IndexedIndexFilename())
+                .ok()) {
+          // Same as above, for the indexed cache format.
+          LOG(WARNING)
+              << "It looks like the cache was already completely written("
+              << dataset()->IndexedIndexFilename()
+              << ") after the last checkpoint was saved. "
+              << "Attempting to read the cache instead of continuing to "
+              << "write. If this is a mistake, please remove the above file "
+              << "and try running again.";
+          mode_ = Mode::indexed_read;
+        }
         InitializeIterator();
         TF_RETURN_IF_ERROR(iterator_->Initialize(ctx));
         return RestoreInput(ctx, reader, iterator_);
@@ -436,6 +492,256 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
         bool iteration_completed_ GUARDED_BY(mu_);
       };  // FileWriterIterator
 
+      // IndexedWriterIterator writes the cache in the indexed format: the
+      // elements go into an append-only data file as TFRecord-framed
+      // serialized `TensorProto`s (`num_tensors_` consecutive records per
+      // element), and the byte offset of each element's first record goes
+      // into a fixed-stride index file (one little-endian uint64 per
+      // element). Because both files are append-only, a checkpoint simply
+      // records how far they have been written and a restore continues
+      // appending in place; there is no per-checkpoint shard merging. The
+      // index is written under a temporary name and renamed once the input
+      // has been exhausted, which marks the cache as complete.
+      class IndexedWriterIterator : public DatasetIterator<FileDataset> {
+       public:
+        explicit IndexedWriterIterator(const Params& params)
+            : DatasetIterator<FileDataset>(params),
+              cur_index_(0),
+              data_offset_(0),
+              lockfile_created_(false),
+              iteration_completed_(false) {}
+
+        Status Initialize(IteratorContext* ctx) override {
+          return dataset()->input_->MakeIterator(ctx, prefix(), &input_impl_);
+        }
+
+        Status GetNextInternal(IteratorContext* ctx,
+                               std::vector<Tensor>* out_tensors,
+                               bool* end_of_sequence) override {
+          mutex_lock l(mu_);
+          TF_RETURN_IF_ERROR(EnsureFilesCreated());
+
+          TF_RETURN_IF_ERROR(
+              input_impl_->GetNext(ctx, out_tensors, end_of_sequence));
+          if (*end_of_sequence && out_tensors->empty()) {
+            TF_RETURN_IF_ERROR(Finish());
+            cur_index_++;
+            return Status::OK();
+          }
+          if (out_tensors->size() != dataset()->num_tensors_) {
+            return errors::Internal(
+                "Upstream iterator returned invalid number of tensors. "
+                "Expected ",
+                dataset()->num_tensors_, " got: ", out_tensors->size());
+          }
+          char index_entry[sizeof(uint64)];
+          core::EncodeFixed64(index_entry, data_offset_);
+          TF_RETURN_IF_ERROR(index_file_->Append(
+              StringPiece(index_entry, sizeof(index_entry))));
+          for (const Tensor& t : *out_tensors) {
+            TensorProto proto;
+            t.AsProtoTensorContent(&proto);
+            const string serialized = proto.SerializeAsString();
+            TF_RETURN_IF_ERROR(writer_->WriteRecord(serialized));
+            data_offset_ += io::RecordWriter::kHeaderSize + serialized.size() +
+                            io::RecordWriter::kFooterSize;
+          }
+          if (*end_of_sequence) {
+            TF_RETURN_IF_ERROR(Finish());
+          }
+          cur_index_++;
+          return Status::OK();
+        }
+
+       protected:
+        std::shared_ptr<model::Node> CreateNode(
+            IteratorContext* ctx, model::Node::Args args) const override {
+          return model::MakeKnownRatioNode(std::move(args),
+                                           /*ratio=*/1);
+        }
+
+        Status SaveInternal(IteratorStateWriter* writer) override {
+          mutex_lock l(mu_);
+          if (iteration_completed_) {
+            TF_RETURN_IF_ERROR(
+                writer->WriteScalar(full_name("iteration_completed"), ""));
+            return Status::OK();
+          }
+          if (lockfile_created_) {
+            // Make sure everything written so far is on disk, so that the
+            // saved (cur_index_, data_offset_) pair describes the file
+            // contents a restore will find.
+            TF_RETURN_IF_ERROR(writer_->Flush());
+            TF_RETURN_IF_ERROR(data_file_->Sync());
+            TF_RETURN_IF_ERROR(index_file_->Sync());
+          }
+          TF_RETURN_IF_ERROR(SaveInput(writer, input_impl_));
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(full_name("cur_index"), cur_index_));
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(full_name("data_offset"), data_offset_));
+          return Status::OK();
+        }
+
+        Status RestoreInternal(IteratorContext* ctx,
+                               IteratorStateReader* reader) override {
+          mutex_lock l(mu_);
+          if (reader->Contains(full_name("iteration_completed"))) {
+            iteration_completed_ = true;
+            return Status::OK();
+          }
+
+          TF_RETURN_IF_ERROR(RestoreInput(ctx, reader, input_impl_));
+          int64 temp;
+          // TODO(b/78048575): Update this when saving size_t tensors directly
+          // is supported.
+          {
+            TF_RETURN_IF_ERROR(
+                reader->ReadScalar(full_name("cur_index"), &temp));
+            cur_index_ = static_cast<size_t>(temp);
+            if (cur_index_ != temp) {
+              return errors::Internal("Invalid value for cur_index ", temp);
+            }
+          }
+          TF_RETURN_IF_ERROR(
+              reader->ReadScalar(full_name("data_offset"), &temp));
+          data_offset_ = static_cast<uint64>(temp);
+          if (cur_index_ == 0 && data_offset_ == 0) {
+            // Nothing was written before the checkpoint; the files will be
+            // created on the first call to GetNextInternal.
+            return Status::OK();
+          }
+
+          // Verify that the partial cache on disk matches the checkpoint
+          // before continuing to append to it.
+          uint64 file_size;
+          TF_RETURN_IF_ERROR(dataset()->env_->GetFileSize(
+              dataset()->IndexedDataFilename(), &file_size));
+          if (file_size != data_offset_) {
+            return errors::FailedPrecondition(
+                "Partial cache file ", dataset()->IndexedDataFilename(),
+                " has size ", file_size, " but the checkpoint expects ",
+                data_offset_,
+                ". Delete the partial cache files and re-run to rebuild the "
+                "cache.");
+          }
+          TF_RETURN_IF_ERROR(dataset()->env_->GetFileSize(
+              dataset()->IndexedIndexTempFilename(), &file_size));
+          if (file_size != cur_index_ * sizeof(uint64)) {
+            return errors::FailedPrecondition(
+                "Partial cache index ", dataset()->IndexedIndexTempFilename(),
+                " has size ", file_size, " but the checkpoint expects ",
+                cur_index_ * sizeof(uint64),
+                ". Delete the partial cache files and re-run to rebuild the "
+                "cache.");
+          }
+
+          TF_RETURN_IF_ERROR(dataset()->env_->NewAppendableFile(
+              dataset()->IndexedDataFilename(), &data_file_));
+          TF_RETURN_IF_ERROR(dataset()->env_->NewAppendableFile(
+              dataset()->IndexedIndexTempFilename(), &index_file_));
+          writer_ = absl::make_unique<io::RecordWriter>(data_file_.get());
+          // Re-create the lockfile if the previous session removed it on
+          // exit; either way this iterator now owns the cache files.
+          if (!dataset()
+                   ->env_->FileExists(dataset()->IndexedLockFilename())
+                   .ok()) {
+            TF_RETURN_IF_ERROR(CreateLockFile());
+          }
+          lockfile_created_ = true;
+          return Status::OK();
+        }
+
+       private:
+        Status EnsureFilesCreated() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+          if (iteration_completed_)
+            return errors::OutOfRange(
+                "Attempting to call get_next after iteration should have "
+                "finished.");
+          if (lockfile_created_) return Status::OK();
+
+          // Perform the same rudimentary locking as FileWriterIterator to
+          // help catch concurrent writes to the same cache files.
+          if (dataset()
+                  ->env_->FileExists(dataset()->IndexedIndexFilename())
+                  .ok()) {
+            return errors::AlreadyExists(
+                "Existing cache files found: \n",
+                dataset()->IndexedIndexFilename(), "\n",
+                dataset()->IndexedDataFilename(), "\n",
+                "To continue delete the above files.");
+          }
+          if (dataset()
+                  ->env_->FileExists(dataset()->IndexedLockFilename())
+                  .ok()) {
+            char contents_scratch[151] = {0};  // Initialize all to 0.
+            StringPiece contents;
+            std::unique_ptr<RandomAccessFile> file;
+            if (dataset()
+                    ->env_
+                    ->NewRandomAccessFile(dataset()->IndexedLockFilename(),
+                                          &file)
+                    .ok()) {
+              file->Read(0, 150, &contents, contents_scratch).IgnoreError();
+            }
+            return errors::AlreadyExists(
+                "There appears to be a concurrent caching iterator running - "
+                "cache lockfile already exists ('",
+                dataset()->IndexedLockFilename(),
+                "'). If you are sure no other running TF computations are "
+                "using this cache prefix, delete the lockfile and "
+                "re-initialize the iterator. Lockfile contents: ",
+                contents);
+          }
+          TF_RETURN_IF_ERROR(CreateLockFile());
+          TF_RETURN_IF_ERROR(dataset()->env_->NewWritableFile(
+              dataset()->IndexedDataFilename(), &data_file_));
+          TF_RETURN_IF_ERROR(dataset()->env_->NewWritableFile(
+              dataset()->IndexedIndexTempFilename(), &index_file_));
+          writer_ = absl::make_unique<io::RecordWriter>(data_file_.get());
+          data_offset_ = 0;
+          lockfile_created_ = true;
+          return Status::OK();
+        }
+
+        Status CreateLockFile() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+          std::unique_ptr<WritableFile> lockfile;
+          TF_RETURN_IF_ERROR(dataset()->env_->NewWritableFile(
+              dataset()->IndexedLockFilename(), &lockfile));
+          TF_RETURN_IF_ERROR(lockfile->Append(
+              strings::StrCat("Created at: ", dataset()->env_->NowSeconds())));
+          return Status::OK();
+        }
+
+        Status Finish() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+          iteration_completed_ = true;
+          TF_RETURN_IF_ERROR(writer_->Close());
+          TF_RETURN_IF_ERROR(data_file_->Close());
+          TF_RETURN_IF_ERROR(index_file_->Close());
+          // Publishing the index under its final name marks the cache as
+          // completely written, so the next call to `MakeIterator` builds an
+          // `IndexedReaderIterator`.
+          TF_RETURN_IF_ERROR(
+              dataset()->env_->RenameFile(dataset()->IndexedIndexTempFilename(),
+                                          dataset()->IndexedIndexFilename()));
+          TF_RETURN_IF_ERROR(
+              dataset()->env_->DeleteFile(dataset()->IndexedLockFilename()));
+          return Status::OK();
+        }
+
+        mutex mu_;
+        size_t cur_index_ GUARDED_BY(mu_);
+        std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
+        std::unique_ptr<WritableFile> data_file_ GUARDED_BY(mu_);
+        std::unique_ptr<WritableFile> index_file_ GUARDED_BY(mu_);
+        std::unique_ptr<io::RecordWriter> writer_ GUARDED_BY(mu_);
+        // Size of the data file in bytes; equivalently, the offset at which
+        // the next element's first record will start.
+        uint64 data_offset_ GUARDED_BY(mu_);
+        bool lockfile_created_ GUARDED_BY(mu_);
+        bool iteration_completed_ GUARDED_BY(mu_);
+      };  // IndexedWriterIterator
+
       class FileReaderIterator : public DatasetIterator<FileDataset> {
        public:
         explicit FileReaderIterator(const Params& params)
@@ -527,6 +833,135 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
         bool iterator_restored_ GUARDED_BY(mu_);
       };  // FileReaderIterator
 
+      // IndexedReaderIterator reads back a cache written in the indexed
+      // format. The data file is memory-mapped and decoded through
+      // `MemoryRegionRecordReader`, and the fixed-stride index maps any
+      // element index to its byte offset with a single 8-byte read. As a
+      // result a restored (or second-epoch) iterator starts streaming
+      // immediately instead of replaying bundle metadata, and arbitrary
+      // element ranges can be addressed directly, e.g. to shard a finished
+      // cache across training workers.
+      class IndexedReaderIterator : public DatasetIterator<FileDataset> {
+       public:
+        explicit IndexedReaderIterator(const Params& params)
+            : DatasetIterator<FileDataset>(params),
+              cur_index_(0),
+              num_elements_(0),
+              data_offset_(0) {}
+
+        Status Initialize(IteratorContext* ctx) override {
+          mutex_lock l(mu_);
+          TF_RETURN_IF_ERROR(
+              dataset()->env_->NewReadOnlyMemoryRegionFromFile(
+                  dataset()->IndexedDataFilename(), &data_region_));
+          reader_ = absl::make_unique<io::MemoryRegionRecordReader>(
+              data_region_.get());
+          uint64 index_size;
+          TF_RETURN_IF_ERROR(dataset()->env_->GetFileSize(
+              dataset()->IndexedIndexFilename(), &index_size));
+          if (index_size % sizeof(uint64) != 0) {
+            return errors::DataLoss("Cache index file ",
+                                    dataset()->IndexedIndexFilename(),
+                                    " has invalid size ", index_size);
+          }
+          num_elements_ = index_size / sizeof(uint64);
+          return dataset()->env_->NewRandomAccessFile(
+              dataset()->IndexedIndexFilename(), &index_file_);
+        }
+
+        Status GetNextInternal(IteratorContext* ctx,
+                               std::vector<Tensor>* out_tensors,
+                               bool* end_of_sequence) override {
+          mutex_lock l(mu_);
+          if (cur_index_ >= num_elements_) {
+            *end_of_sequence = true;
+            return Status::OK();
+          }
+          *end_of_sequence = false;
+          out_tensors->clear();
+          out_tensors->reserve(dataset()->num_tensors_);
+          for (size_t i = 0; i < dataset()->num_tensors_; ++i) {
+            StringPiece record;
+            TF_RETURN_IF_ERROR(reader_->ReadRecord(&data_offset_, &record));
+            TensorProto proto;
+            if (!proto.ParseFromArray(record.data(), record.size())) {
+              return errors::DataLoss("Unable to parse tensor ", i,
+                                      " of cached element ", cur_index_);
+            }
+            Tensor t;
+            if (!t.FromProto(proto)) {
+              return errors::DataLoss("Unable to restore tensor ", i,
+                                      " of cached element ", cur_index_);
+            }
+            out_tensors->emplace_back(std::move(t));
+          }
+          cur_index_++;
+          return Status::OK();
+        }
+
+       protected:
+        std::shared_ptr<model::Node> CreateNode(
+            IteratorContext* ctx, model::Node::Args args) const override {
+          return model::MakeKnownRatioNode(std::move(args),
+                                           /*ratio=*/1);
+        }
+
+        Status SaveInternal(IteratorStateWriter* writer) override {
+          mutex_lock l(mu_);
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(full_name("cur_index"), cur_index_));
+          return Status::OK();
+        }
+
+        Status RestoreInternal(
+            IteratorContext* ctx,
+            IteratorStateReader* iterator_state_reader) override {
+          mutex_lock l(mu_);
+          {
+            // TODO(b/78048575): Update this when saving size_t tensors directly
+            // is supported.
+            int64 temp;
+            TF_RETURN_IF_ERROR(iterator_state_reader->ReadScalar(
+                full_name("cur_index"), &temp));
+            cur_index_ = static_cast<size_t>(temp);
+            if (cur_index_ != temp) {
+              return errors::Internal("Invalid value for cur_index ", temp);
+            }
+          }
+          if (cur_index_ > num_elements_) {
+            return errors::Internal("Invalid value for cur_index ", cur_index_,
+                                    "; the cache holds only ", num_elements_,
+                                    " elements.");
+          }
+          if (cur_index_ < num_elements_) {
+            TF_RETURN_IF_ERROR(ElementOffset(cur_index_, &data_offset_));
+          }
+          return Status::OK();
+        }
+
+       private:
+        // Sets *offset to the byte offset of element `index` in the data
+        // file with a single read of the fixed-stride index.
+        Status ElementOffset(size_t index, uint64* offset)
+            EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+          char scratch[sizeof(uint64)];
+          StringPiece entry;
+          TF_RETURN_IF_ERROR(index_file_->Read(
+              index * sizeof(uint64), sizeof(uint64), &entry, scratch));
+          *offset = core::DecodeFixed64(entry.data());
+          return Status::OK();
+        }
+
+        mutex mu_;
+        size_t cur_index_ GUARDED_BY(mu_);
+        size_t num_elements_ GUARDED_BY(mu_);
+        std::unique_ptr<ReadOnlyMemoryRegion> data_region_ GUARDED_BY(mu_);
+        std::unique_ptr<io::MemoryRegionRecordReader> reader_ GUARDED_BY(mu_);
+        std::unique_ptr<RandomAccessFile> index_file_ GUARDED_BY(mu_);
+        // Offset of the next record to read from the data file.
+        uint64 data_offset_ GUARDED_BY(mu_);
+      };  // IndexedReaderIterator
+
       void InitializeIterator() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         // We intentionally use the same prefix for both `FileReaderIterator`
         // and `FileWriterIterator`. Since at any time there will be at most
@@ -546,11 +981,21 @@ class CacheDatasetOp : public UnaryDatasetOpKernel {
             iterator_ = absl::make_unique<FileWriterIterator>(
                 FileWriterIterator::Params{dataset(),
                                            strings::StrCat(prefix(), "Impl")});
+            break;
+          case Mode::indexed_read:
+            iterator_ = absl::make_unique<IndexedReaderIterator>(
+                IndexedReaderIterator::Params{
+                    dataset(), strings::StrCat(prefix(), "Impl")});
+            break;
+          case Mode::indexed_write:
+            iterator_ = absl::make_unique<IndexedWriterIterator>(
+                IndexedWriterIterator::Params{
+                    dataset(), strings::StrCat(prefix(), "Impl")});
         }
       }
 
       mutex mu_;
-      enum Mode { read, write };
+      enum Mode { read, write, indexed_read, indexed_write };
       Mode mode_ GUARDED_BY(mu_);
       std::unique_ptr<IteratorBase> iterator_ GUARDED_BY(mu_);
     };  // FileIterator
@@ -44,6 +44,13 @@ constexpr char kDatasetName[] = "MapAndBatch";
 // Maximum number of batch results to buffer.
 constexpr int64 kMaxBatchResults = 16;
 
+bool ShapesFullyDefined(const std::vector<PartialTensorShape>& shapes) {
+  for (const PartialTensorShape& shape : shapes) {
+    if (!shape.IsFullyDefined()) return false;
+  }
+  return true;
+}
+
 // See documentation in ../../ops/dataset_ops.cc for a high-level
 // description of the following op.
 class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
@@ -109,6 +116,7 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
           drop_remainder_(drop_remainder),
           output_types_(output_types),
           output_shapes_(output_shapes),
+          output_shapes_fully_defined_(ShapesFullyDefined(output_shapes)),
           captured_func_(std::move(captured_func)),
           preserve_cardinality_(preserve_cardinality) {
       input_->Ref();
@@ -477,6 +485,44 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
         return Status::OK();
       }
 
+      // Allocates the output batch from the statically known output shapes,
+      // so that completing map invocations can copy their results straight
+      // into their slices without first synchronizing on whichever call
+      // happens to finish first.  Only valid when every component of the
+      // dataset's output shapes is fully defined.
+      void PreallocateOutput(IteratorContext* ctx,
+                             const std::shared_ptr<BatchResult>& result) {
+        DCHECK(dataset()->output_shapes_fully_defined_);
+        mutex_lock l(result->mu);
+        if (result->output_allocated) {
+          return;
+        }
+        const size_t num_components = dataset()->output_shapes_.size();
+        for (size_t i = 0; i < num_components; ++i) {
+          TensorShape element_shape;
+          dataset()->output_shapes_[i].AsTensorShape(&element_shape);
+          TensorShape component_shape({dataset()->batch_size_});
+          component_shape.AppendShape(element_shape);
+          AllocatorAttributes attr;
+          attr.set_gpu_compatible(true);
+          result->output.emplace_back(ctx->allocator(attr),
+                                      dataset()->output_types_[i],
+                                      component_shape);
+          if (!result->output.back().IsInitialized()) {
+            // Inline instead of UpdateStatus(), which would re-acquire
+            // result->mu.
+            if (result->status.ok()) {
+              result->status = errors::ResourceExhausted(
+                  "Failed to allocate memory for the batch of component ", i);
+              result->status_offset = 0;
+            }
+            result->output.clear();
+            return;
+          }
+        }
+        result->output_allocated = true;
+      }
+
       Status ProcessResult(IteratorContext* ctx,
                            const std::shared_ptr<BatchResult>& result,
                            std::vector<Tensor>* out_tensors,
@@ -541,6 +587,7 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
                   (batch_results_.size() == max_batch_results_ &&
                    call_counter_ % dataset()->batch_size_ == 0));
         };
+        std::vector<std::shared_ptr<BatchResult>> new_batches;
         while (true) {
           {
             mutex_lock l(*mu_);
@@ -567,6 +614,9 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
               if (call_counter_ % dataset()->batch_size_ == 0) {
                 batch_results_.push_back(
                     std::make_shared<BatchResult>(dataset()->batch_size_));
+                if (dataset()->output_shapes_fully_defined_) {
+                  new_batches.push_back(batch_results_.back());
+                }
               }
               int64 offset = call_counter_++ % dataset()->batch_size_;
               new_calls.emplace_back(batch_results_.back(), offset);
@@ -583,6 +633,12 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
                     static_cast<float>(num_parallel_calls_->value),
                 num_elements());
           }
+          // Allocate new batches outside of `*mu_` so that consumers are not
+          // blocked on potentially large allocations.
+          for (const auto& batch : new_batches) {
+            PreallocateOutput(ctx.get(), batch);
+          }
+          new_batches.clear();
           for (const auto& call : new_calls) {
             CallFunction(ctx, call.first, call.second);
           }
@@ -744,6 +800,10 @@ class MapAndBatchDatasetOp : public UnaryDatasetOpKernel {
     const bool drop_remainder_;
     const DataTypeVector output_types_;
     const std::vector<PartialTensorShape> output_shapes_;
+    // True iff every component of `output_shapes_` is fully defined, in
+    // which case batches can be allocated before any map invocation
+    // completes.
+    const bool output_shapes_fully_defined_;
     const std::unique_ptr<CapturedFunction> captured_func_;
     const bool preserve_cardinality_;
   };
@@ -150,9 +150,7 @@ class MultiDeviceIterator : public ResourceBase {
         if (background_thread_ && !background_thread_finished_) {
           cancelled_ = true;
           // Wake up the background thread.
-          for (int i = 0; i < size_; ++i) {
-            buffer_[i].cond_var.notify_all();
-          }
+          buffer_space_cond_var_.notify_all();
 
           // Make sure background thread has finished first.
           while (!background_thread_finished_) {
@@ -188,9 +186,10 @@ class MultiDeviceIterator : public ResourceBase {
           produced_output = true;
           std::swap(elem, buffer_[shard_num].data.front());
           buffer_[shard_num].data.pop_front();
-          // Wake up background thread if it is blocked on this element.
+          // Wake up background thread if it is blocked waiting for buffer
+          // space.
           if (buffer_[shard_num].data.size() == max_buffer_size_ - 1) {
-            buffer_[shard_num].cond_var.notify_all();
+            buffer_space_cond_var_.notify_all();
           }
         } else {
           if (end_of_iterator_) {
@@ -269,9 +268,20 @@ class MultiDeviceIterator : public ResourceBase {
 
         {
           mutex_lock l(mu_);
-          while (!cancelled_ &&
-                 buffer_[shard_to_fetch].data.size() >= max_buffer_size_) {
-            buffer_[shard_to_fetch].cond_var.wait(l);
+          // A full shard whose consumer is slow must not block delivery to
+          // the other shards, so instead of waiting for the round-robin
+          // shard to drain, fetch for the next shard that has buffer space
+          // and wait only when every shard is full.
+          auto all_shards_full = [this]() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+            for (auto& hb : buffer_) {
+              if (hb.data.size() < max_buffer_size_) {
+                return false;
+              }
+            }
+            return true;
+          };
+          while (!cancelled_ && all_shards_full()) {
+            buffer_space_cond_var_.wait(l);
           }
 
           if (cancelled_) {
@@ -279,6 +289,14 @@ class MultiDeviceIterator : public ResourceBase {
             shutdown_cond_var_.notify_all();
             return;
           }
+
+          for (int i = 0; i < size_; ++i) {
+            int candidate = (shard_to_fetch + i) % size_;
+            if (buffer_[candidate].data.size() < max_buffer_size_) {
+              shard_to_fetch = candidate;
+              break;
+            }
+          }
         }
 
         elem.status = host_iterator_->GetNext(ctx.get(), &elem.value,
@@ -321,12 +339,13 @@ class MultiDeviceIterator : public ResourceBase {
     }
 
     struct HostBuffer {
-      condition_variable cond_var;
       std::deque<HostBufferElement> data;
       std::deque<MultiDeviceIteratorCallback> callbacks;
     };
 
     mutex mu_;
+    // Signalled when a consumer frees up buffer space in its shard.
+    condition_variable buffer_space_cond_var_ GUARDED_BY(mu_);
     std::unique_ptr<Thread> background_thread_ GUARDED_BY(mu_);
     bool background_thread_finished_ GUARDED_BY(mu_) = false;
     bool background_thread_started_ GUARDED_BY(mu_) = false;
@@ -324,6 +324,13 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
         std::deque<std::shared_ptr<Result>> results GUARDED_BY(mu);
         // Indicates whether the element is used by a worker thread.
         bool in_use = false;
+        // Indicates whether `iterator` is yet to be created from `inputs` by
+        // a worker thread. Creating the iterator invokes the captured
+        // function, which may perform slow I/O (e.g. opening a remote file
+        // while constructing its dataset); deferring it to a worker keeps
+        // that work out of the critical section protecting the interleave
+        // state.
+        bool iterator_creation_pending = false;
       };
 
       // Advances the position in the interleave cycle to the next cycle
@@ -378,7 +385,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
                 // Wait for the result to become ready.
                 return false;
               }
-            } else if (!element->iterator) {
+            } else if (!element->iterator && !element->iterator_creation_pending) {
               // We reached the end of input for this element. Reset
               // it and move on to the next cycle element.
               current_elements_[cycle_index_].reset();
@@ -470,7 +477,8 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
               }
             }
             std::shared_ptr<Element> element = current_elements_[idx];
-            if (!element->in_use && element->iterator) {
+            if (!element->in_use &&
+                (element->iterator || element->iterator_creation_pending)) {
               int64 num_results;
               {
                 mutex_lock l(element->mu);
@@ -521,6 +529,36 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
                         int64 num_results) LOCKS_EXCLUDED(*mu_) {
         RecordStart(ctx.get());
         auto cleanup = gtl::MakeCleanup([this, ctx] { RecordStop(ctx.get()); });
+        bool create_iterator;
+        {
+          mutex_lock l(*mu_);
+          create_iterator = element->iterator_creation_pending;
+        }
+        if (create_iterator) {
+          std::unique_ptr<IteratorBase> iterator;
+          Status status = MakeIteratorFromInputElement(
+              ctx.get(), element->inputs, element->id,
+              *instantiated_captured_func_, prefix(), &iterator);
+          mutex_lock l(*mu_);
+          element->iterator_creation_pending = false;
+          if (!status.ok()) {
+            // Surface the error to the consumer and account for the
+            // iterator that will never open.
+            {
+              mutex_lock l2(element->mu);
+              auto result = std::make_shared<Result>();
+              result->is_ready = true;
+              result->status = status;
+              element->results.push_back(std::move(result));
+            }
+            --num_open_;
+            element->in_use = false;
+            --num_calls_;
+            cond_var_->notify_all();
+            return;
+          }
+          element->iterator = std::move(iterator);
+        }
         bool end_of_input = false;
         for (int64 i = 0; i < num_results; ++i) {
           auto result = std::make_shared<Result>();
@@ -592,7 +630,8 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
               break;
             }
             future_elements_.push_front(element);
-            if (!element->iterator) {
+            if (!element->iterator_creation_pending) {
+              // `element` holds an error result instead of an iterator.
               continue;
             }
             ++num_calls_;
@@ -631,17 +670,10 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
           return element;
         }
         if (!end_of_input_) {
-          Status status = MakeIteratorFromInputElement(
-              ctx.get(), element->inputs, element->id,
-              *instantiated_captured_func_, prefix(), &element->iterator);
-          if (!status.ok()) {
-            auto result = std::make_shared<Result>();
-            result->is_ready = true;
-            result->status = status;
-            mutex_lock l(element->mu);
-            element->results.push_back(std::move(result));
-            return element;
-          }
+          // Defer the creation of the iterator from `inputs` to the worker
+          // thread that first fetches from the element, so that the captured
+          // function's potentially slow work runs outside of `*mu_`.
+          element->iterator_creation_pending = true;
           ++num_open_;
         } else {
           element.reset();
@@ -890,7 +922,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
       // Identifies whether the global end of input has been reached.
       bool end_of_input_ GUARDED_BY(*mu_) = false;
 
-      // Identifies the number of open iterators.
+      // Identifies the number of open (or opening) iterators.
       int64 num_open_ GUARDED_BY(*mu_) = 0;
 
       // Identifies the number of outstanding calls.
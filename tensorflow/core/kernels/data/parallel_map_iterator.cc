@@ -14,7 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/parallel_map_iterator.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <deque>
 #include <functional>
 #include <memory>
@@ -25,11 +27,41 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/stats_utils.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
+// Returns true if iterators created with `num_parallel_calls == AUTOTUNE`
+// should adapt their parallelism from measured per-call cost instead of
+// pinning it to the runner threadpool size. The feedback loop sizes the
+// number of in-flight calls to what is needed to keep up with the consumer,
+// so map functions that are expensive (or internally parallel) no longer
+// schedule a full threadpool's worth of concurrent invocations. Only applies
+// when model-based autotuning is not managing the parameter.
+bool CostFeedbackEnabled() {
+  static const bool result = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_PARALLEL_MAP_COST_FEEDBACK",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Decay used for the exponential moving averages of per-call duration and
+// consumption interval.
+constexpr double kCostDecay = 0.9;
+
+// Number of samples each average must accumulate before the feedback loop
+// starts adjusting parallelism.
+constexpr int64 kMinCostSamples = 16;
+
+// Minimum time between two parallelism adjustments.
+constexpr int64 kAdjustmentIntervalMicros = 100 * 1000;  // 100ms
+
 class ParallelMapIterator : public DatasetBaseIterator {
  public:
   struct Params {
@@ -76,6 +108,10 @@ class ParallelMapIterator : public DatasetBaseIterator {
     mutex_lock l(*mu_);
     if (num_parallel_calls_->value == model::kAutoTune) {
       num_parallel_calls_->value = ctx->runner_threadpool_size();
+      // When model-based autotuning is active it owns the parameter, so the
+      // cost feedback loop must stay out of its way.
+      adaptive_ = CostFeedbackEnabled() && !ctx->model();
+      max_parallel_calls_ = ctx->runner_threadpool_size();
     }
     TF_RETURN_IF_ERROR(
         input_dataset_->MakeIterator(ctx, prefix(), &input_impl_));
@@ -88,6 +124,10 @@ class ParallelMapIterator : public DatasetBaseIterator {
     {
       mutex_lock l(*mu_);
       EnsureRunnerThreadStarted(ctx);
+      if (adaptive_) {
+        RecordConsumption();
+        MaybeAdjustParallelism();
+      }
       while (ShouldWait(&result)) {
         RecordStop(ctx);
         cond_var_->wait(l);
@@ -186,6 +226,9 @@ class ParallelMapIterator : public DatasetBaseIterator {
     Status status;
     std::vector<Tensor> return_values;
     bool end_of_input;
+    // Time at which the map function was invoked; 0 if the call was never
+    // issued (e.g. end of input) or cost feedback is disabled.
+    int64 start_time_usec = 0;
   };
 
   void EnsureRunnerThreadStarted(IteratorContext* ctx)
@@ -203,6 +246,17 @@ class ParallelMapIterator : public DatasetBaseIterator {
       LOCKS_EXCLUDED(*mu_) {
     mutex_lock l(*mu_);
     num_calls_--;
+    if (result->start_time_usec > 0) {
+      const double elapsed = static_cast<double>(Env::Default()->NowMicros() -
+                                                 result->start_time_usec);
+      if (num_call_duration_samples_ == 0) {
+        call_duration_usec_ = elapsed;
+      } else {
+        call_duration_usec_ =
+            kCostDecay * call_duration_usec_ + (1.0 - kCostDecay) * elapsed;
+      }
+      num_call_duration_samples_++;
+    }
     const auto& stats_aggregator = ctx->stats_aggregator();
     if (stats_aggregator) {
       stats_aggregator->AddScalar(
@@ -233,6 +287,10 @@ class ParallelMapIterator : public DatasetBaseIterator {
       CallCompleted(ctx, result);
     };
 
+    if (adaptive_) {
+      result->start_time_usec = Env::Default()->NowMicros();
+    }
+
     // Apply the map function on `input_element`, storing the result in
     // `result->return_values`, and invoking `done` when finished.
     parallel_map_functor_->MapFunc(ctx.get(), prefix(),
@@ -316,6 +374,55 @@ class ParallelMapIterator : public DatasetBaseIterator {
     }
   }
 
+  // Updates the moving average of the interval between consumer requests.
+  void RecordConsumption() EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+    const int64 now_usec = Env::Default()->NowMicros();
+    if (last_consume_usec_ > 0) {
+      const double elapsed = static_cast<double>(now_usec - last_consume_usec_);
+      if (num_consume_interval_samples_ == 0) {
+        consume_interval_usec_ = elapsed;
+      } else {
+        consume_interval_usec_ = kCostDecay * consume_interval_usec_ +
+                                 (1.0 - kCostDecay) * elapsed;
+      }
+      num_consume_interval_samples_++;
+    }
+    last_consume_usec_ = now_usec;
+  }
+
+  // Adjusts the number of parallel calls to the smallest value that keeps up
+  // with the measured consumer demand: the ratio of the average map function
+  // duration to the average interval between consumer requests. With an
+  // expensive (or internally parallel) map function and a consumer that is
+  // not a bottleneck this converges to a small number of in-flight calls
+  // instead of a full threadpool's worth, avoiding oversubscription.
+  // Rate-limited and sample-gated so that startup noise does not cause
+  // thrashing.
+  void MaybeAdjustParallelism() EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
+    if (num_call_duration_samples_ < kMinCostSamples ||
+        num_consume_interval_samples_ < kMinCostSamples) {
+      return;
+    }
+    const int64 now_usec = Env::Default()->NowMicros();
+    if (now_usec - last_adjustment_usec_ < kAdjustmentIntervalMicros) {
+      return;
+    }
+    last_adjustment_usec_ = now_usec;
+    const double interval = std::max(consume_interval_usec_, 1.0);
+    const int64 target = std::min(
+        max_parallel_calls_,
+        std::max(int64{1},
+                 static_cast<int64>(std::ceil(call_duration_usec_ / interval))));
+    if (target != num_parallel_calls_->value) {
+      VLOG(2) << "Adjusting parallelism of " << key_prefix_ << " from "
+              << num_parallel_calls_->value << " to " << target
+              << " (call duration: " << call_duration_usec_
+              << "us, consume interval: " << consume_interval_usec_ << "us)";
+      num_parallel_calls_->value = target;
+      cond_var_->notify_all();
+    }
+  }
+
   // Determines whether the caller needs to wait for a result. Upon returning
   // false, `result` will point to the result.
   bool ShouldWait(std::shared_ptr<InvocationResult>* result)
@@ -393,6 +500,19 @@ class ParallelMapIterator : public DatasetBaseIterator {
   // Determines whether outputs can be produced in non-deterministic order.
   const bool sloppy_;
   const bool preserve_cardinality_;
+  // Whether the cost feedback loop manages `num_parallel_calls_`. Written
+  // once in `Initialize` before the runner thread is started.
+  bool adaptive_ = false;
+  // Upper bound for the cost feedback loop; the runner threadpool size
+  // observed in `Initialize`.
+  int64 max_parallel_calls_ = 1;
+  // Moving averages maintained by the cost feedback loop.
+  double call_duration_usec_ GUARDED_BY(*mu_) = 0.0;
+  double consume_interval_usec_ GUARDED_BY(*mu_) = 0.0;
+  int64 num_call_duration_samples_ GUARDED_BY(*mu_) = 0;
+  int64 num_consume_interval_samples_ GUARDED_BY(*mu_) = 0;
+  int64 last_consume_usec_ GUARDED_BY(*mu_) = 0;
+  int64 last_adjustment_usec_ GUARDED_BY(*mu_) = 0;
   // Counts the number of outstanding calls.
   int64 num_calls_ GUARDED_BY(*mu_) = 0;
   std::unique_ptr<IteratorBase> input_impl_;
@@ -15,6 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/data/prefetch_autotuner.h"
 
+#include <algorithm>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/util/env_var.h"
+
 namespace tensorflow {
 namespace data {
 
@@ -31,9 +37,87 @@ namespace {
 // limits less than the threshold, an exponential increase is used, while for
 // limits greater than or equal to the threshold, a linear increase is used.
 size_t kBufferLimitThreshold = 2048;
+
+// Smoothing factor for the inter-arrival moving averages.
+constexpr double kIntervalDecay = 0.9;
+
+// Number of gaps each moving average must observe before the rate comparison
+// is trusted.
+constexpr int64 kMinIntervalSamples = 16;
+
+// Free-RAM checks are rate limited to once per this interval.
+constexpr uint64 kMemoryCheckIntervalUsec = 1000 * 1000;
+
+// Free-RAM floor, in bytes, below which the buffer limit is halved.
+// Configured with TF_DATA_PREFETCH_MIN_FREE_RAM_MB; <= 0 disables shrinking.
+int64 MinFreeRamBytes() {
+  static int64 min_free_ram_bytes = [] {
+    int64 min_free_ram_mb;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_DATA_PREFETCH_MIN_FREE_RAM_MB", 0,
+                                    &min_free_ram_mb));
+    return min_free_ram_mb << 20;
+  }();
+  return min_free_ram_bytes;
+}
+
+void UpdateInterval(uint64 now_usec, uint64* last_usec, double* interval_usec,
+                    int64* num_intervals) {
+  if (*last_usec != 0) {
+    const double gap_usec = static_cast<double>(now_usec - *last_usec);
+    if (*num_intervals == 0) {
+      *interval_usec = gap_usec;
+    } else {
+      *interval_usec =
+          kIntervalDecay * *interval_usec + (1.0 - kIntervalDecay) * gap_usec;
+    }
+    ++*num_intervals;
+  }
+  *last_usec = now_usec;
+}
 }  // namespace
 
+bool PrefetchAutotuner::ConsumerOutpacingProducer() const {
+  if (num_consume_intervals_ < kMinIntervalSamples ||
+      num_produce_intervals_ < kMinIntervalSamples) {
+    return false;
+  }
+  // Require a clear gap between the rates to avoid growing on noise;
+  // sub-100us intervals are dominated by scheduling jitter.
+  return produce_interval_usec_ >= 100.0 &&
+         consume_interval_usec_ * 2.0 < produce_interval_usec_;
+}
+
+bool PrefetchAutotuner::MaybeShrinkForMemoryPressure(uint64 now_usec) {
+  const int64 min_free_ram_bytes = MinFreeRamBytes();
+  if (min_free_ram_bytes <= 0 || buffer_limit_ <= 1) return false;
+  if (now_usec - last_memory_check_usec_ < kMemoryCheckIntervalUsec) {
+    return false;
+  }
+  last_memory_check_usec_ = now_usec;
+  if (port::AvailableRam() >= min_free_ram_bytes) return false;
+  buffer_limit_ = std::max(int64{1}, buffer_limit_ / 2);
+  // Require the producer to refill the smaller buffer before growing again.
+  mode_ = Mode::kUpswing;
+  return true;
+}
+
+void PrefetchAutotuner::GrowBufferLimit() {
+  if (buffer_limit_ >= kBufferLimitThreshold) {
+    buffer_limit_ += kBufferLimitThreshold;
+  } else {
+    buffer_limit_ *= 2;
+  }
+  mode_ = Mode::kUpswing;
+}
+
 void PrefetchAutotuner::RecordConsumption(size_t current_buffer_size) {
+  if (mode_ == Mode::kDisabled) return;
+
+  const uint64 now_usec = Env::Default()->NowMicros();
+  UpdateInterval(now_usec, &last_consume_usec_, &consume_interval_usec_,
+                 &num_consume_intervals_);
+  if (MaybeShrinkForMemoryPressure(now_usec)) return;
+
   switch (mode_) {
     case Mode::kDisabled:
       return;
@@ -44,16 +128,22 @@ void PrefetchAutotuner::RecordConsumption(size_t current_buffer_size) {
       return;
     case Mode::kDownswing:
       if (current_buffer_size == 0) {
-        if (buffer_limit_ >= kBufferLimitThreshold) {
-          buffer_limit_ += kBufferLimitThreshold;
-        } else {
-          buffer_limit_ *= 2;
-        }
-        mode_ = Mode::kUpswing;
+        GrowBufferLimit();
+      } else if (current_buffer_size * 2 < buffer_limit_ &&
+                 ConsumerOutpacingProducer()) {
+        // The buffer is draining and the rate estimates say it will empty;
+        // grow before the consumer actually blocks.
+        GrowBufferLimit();
       }
       return;
   }
 }
 
+void PrefetchAutotuner::RecordProduction(size_t /*current_buffer_size*/) {
+  if (mode_ == Mode::kDisabled) return;
+  UpdateInterval(Env::Default()->NowMicros(), &last_produce_usec_,
+                 &produce_interval_usec_, &num_produce_intervals_);
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -33,8 +33,14 @@ namespace data {
 // if the prefetching thread is able to successfully fill the buffer at its
 // current size.
 //
-// Note: in the current implementation, we never decrease the buffer_limit().
-// This should change in the future!
+// In addition to the occupancy-driven state machine, the autotuner keeps
+// moving averages of the consumer's inter-arrival time and the producer's
+// inter-production time. When the consumer is demonstrably outpacing the
+// producer it grows the buffer before the buffer fully drains, which reacts
+// faster on bursty consumers. If TF_DATA_PREFETCH_MIN_FREE_RAM_MB is set to a
+// positive value, the buffer limit is also halved whenever the host's free
+// RAM drops below that many megabytes, so that many concurrently autotuning
+// pipelines do not grow themselves into an OOM.
 //
 // PrefetchAutotuner is NOT thread safe.
 class PrefetchAutotuner {
@@ -48,6 +54,10 @@ class PrefetchAutotuner {
   void RecordConsumption(size_t current_buffer_size);
   void RecordEmpty() { RecordConsumption(0); }
 
+  // Informs the autotuner that the prefetch thread added an element to the
+  // buffer, for tracking the producer's rate.
+  void RecordProduction(size_t current_buffer_size);
+
  private:
   // PrefetchAutotuner operates as a state machine.
   enum class Mode {
@@ -63,8 +73,29 @@ class PrefetchAutotuner {
     kDownswing,
   };
 
+  // Returns true if the rate estimates show the consumer arriving faster than
+  // the producer can produce, i.e. the buffer is draining.
+  bool ConsumerOutpacingProducer() const;
+
+  // Halves the buffer limit if the host is low on free RAM. Returns true if
+  // the limit was reduced.
+  bool MaybeShrinkForMemoryPressure(uint64 now_usec);
+
+  void GrowBufferLimit();
+
   int64 buffer_limit_;
   Mode mode_ = Mode::kDisabled;
+
+  // Exponential moving averages of the gaps between successive
+  // RecordConsumption() and RecordProduction() calls, in microseconds, and
+  // the number of gaps observed. Zero-valued timestamps mean "not yet seen".
+  double consume_interval_usec_ = 0.0;
+  double produce_interval_usec_ = 0.0;
+  int64 num_consume_intervals_ = 0;
+  int64 num_produce_intervals_ = 0;
+  uint64 last_consume_usec_ = 0;
+  uint64 last_produce_usec_ = 0;
+  uint64 last_memory_check_usec_ = 0;
 };
 
 }  // namespace data
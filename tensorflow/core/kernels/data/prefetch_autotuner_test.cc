@@ -79,6 +79,24 @@ TEST(PrefetchAutotuner, EnabledSteady) {
   }
 }
 
+TEST(PrefetchAutotuner, ProductionTrackingPreservesOccupancySignal) {
+  // Back-to-back calls observe (near-)equal producer and consumer rates, so
+  // the rate-based early growth must not fire; growth still follows the
+  // occupancy state machine exactly.
+  PrefetchAutotuner t(PrefetchAutotuner::kAutoTune);
+  EXPECT_EQ(1, t.buffer_limit());
+  t.RecordProduction(1);
+  t.RecordConsumption(1);
+  EXPECT_EQ(1, t.buffer_limit());
+  t.RecordConsumption(0);  // Expect buffer limit to increase.
+  EXPECT_EQ(2, t.buffer_limit());
+  for (int i = 0; i < 100; ++i) {
+    t.RecordProduction(2);
+    t.RecordConsumption(1);
+  }
+  EXPECT_EQ(2, t.buffer_limit());
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -20,10 +20,12 @@ limitations under the License.
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/stats_aggregator.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/data/stats_utils.h"
 #include "tensorflow/core/lib/core/error_codes.pb.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -33,6 +35,21 @@ namespace data {
 
 constexpr char kDatasetName[] = "Prefetch";
 
+// Whether prefetched elements should be held in cuda-pinned host memory (see
+// Iterator::MaybePinBufferElement below). Opt-in via environment variable
+// since the pinned pool is a finite resource shared by all transfers to GPU.
+bool PinnedPrefetchBuffersEnabled() {
+  static const bool enabled = [] {
+    bool b = false;
+    Status s = ReadBoolFromEnvVar("TF_DATA_PREFETCH_PINNED", false, &b);
+    if (!s.ok()) {
+      LOG(ERROR) << "PinnedPrefetchBuffersEnabled: " << s.error_message();
+    }
+    return b;
+  }();
+  return enabled;
+}
+
 class PrefetchDatasetOp::Dataset : public DatasetBase {
  public:
   Dataset(OpKernelContext* ctx, const DatasetBase* input, int64 buffer_size)
@@ -314,17 +331,55 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
           cond_var_.notify_all();
           return;
         }
+        if (buffer_element.status.ok()) {
+          MaybePinBufferElement(ctx.get(), &buffer_element.value);
+        }
 
         // 3. Signal that the element has been produced.
         {
           mutex_lock l(mu_);
           RecordBufferEnqueue(ctx.get(), buffer_element.value);
           buffer_.push_back(std::move(buffer_element));
+          auto_tuner_.RecordProduction(buffer_.size());
           cond_var_.notify_all();
         }
       }
     }
 
+    // Copies the element's tensors into cuda-pinned host memory, so that a
+    // downstream copy onto a GPU runs as asynchronous DMA instead of the
+    // driver staging pageable memory. On hosts without a GPU the
+    // gpu-compatible allocator degrades to the ordinary CPU allocator and
+    // the element is left untouched.
+    void MaybePinBufferElement(IteratorContext* ctx,
+                               std::vector<Tensor>* value) {
+      if (!PinnedPrefetchBuffersEnabled()) {
+        return;
+      }
+      AllocatorAttributes pinned_attrs;
+      pinned_attrs.set_on_host(true);
+      pinned_attrs.set_gpu_compatible(true);
+      Allocator* pinned_allocator = ctx->allocator(pinned_attrs);
+      if (pinned_allocator == ctx->allocator(AllocatorAttributes())) {
+        return;
+      }
+      for (Tensor& t : *value) {
+        if (!DataTypeCanUseMemcpy(t.dtype()) || t.NumElements() == 0) {
+          continue;
+        }
+        Tensor pinned(pinned_allocator, t.dtype(), t.shape());
+        if (!pinned.IsInitialized()) {
+          // The pinned pool is exhausted; keep the remaining tensors in
+          // pageable memory rather than failing the iterator.
+          return;
+        }
+        StringPiece from = t.tensor_data();
+        StringPiece to = pinned.tensor_data();
+        memcpy(const_cast<char*>(to.data()), from.data(), from.size());
+        t = std::move(pinned);
+      }
+    }
+
     Status WriteStatus(IteratorStateWriter* writer, size_t index,
                        const Status& status) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       TF_RETURN_IF_ERROR(writer->WriteScalar(
@@ -12,6 +12,9 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <algorithm>
+#include <deque>
+
 #include "tensorflow/core/common_runtime/metrics.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
@@ -22,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -737,6 +741,39 @@ REGISTER_KERNEL_BUILDER(Name("FixedLengthRecordDatasetV2").Device(DEVICE_CPU),
 
 constexpr char kTFRecordDatasetName[] = "TFRecord";
 
+// If enabled, uncompressed TFRecord files are memory-mapped and records are
+// read as views into the mapping, instead of being copied out of a buffered
+// input stream. Files on filesystems that do not support mapping silently
+// fall back to the stream path.
+bool MmapTFRecordsEnabled() {
+  static bool enabled = [] {
+    bool mmap_enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_TFRECORD_USE_MMAP", false,
+                                   &mmap_enabled));
+    return mmap_enabled;
+  }();
+  return enabled;
+}
+
+// If > 1, each memory-mapped TFRecord file is split into that many byte
+// ranges, resynchronized on record boundaries, and read by that many
+// threads in parallel.  Records from one file are then interleaved across
+// ranges rather than produced in file order, and iterator checkpointing is
+// not supported.  Implies the mmap path for uncompressed files.
+int64 ParallelTFRecordReads() {
+  static int64 num_reads = [] {
+    int64 parallel_reads = 1;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_DATA_TFRECORD_PARALLEL_READS", 1,
+                                    &parallel_reads));
+    return std::max(int64{1}, parallel_reads);
+  }();
+  return num_reads;
+}
+
+// Bounds the number of records buffered by the parallel TFRecord shard
+// readers ahead of the consumer.
+constexpr size_t kParallelReadQueueCapacity = 256;
+
 class TFRecordDatasetOp : public DatasetOpKernel {
  public:
   using DatasetOpKernel::DatasetOpKernel;
@@ -825,17 +862,64 @@ class TFRecordDatasetOp : public DatasetOpKernel {
       explicit Iterator(const Params& params)
           : DatasetIterator<Dataset>(params) {}
 
+      ~Iterator() override {
+        mutex_lock l(mu_);
+        shards_cancelled_ = true;
+        shard_cond_var_.notify_all();
+        // `shard_threads_` is declared last, so the worker threads are
+        // joined before any state they use is destroyed.
+      }
+
       Status GetNextInternal(IteratorContext* ctx,
                              std::vector<Tensor>* out_tensors,
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
         do {
-          // We are currently processing a file, so try to read the next record.
-          if (reader_) {
+          // Sharded parallel reads: consume records from the queue fed by
+          // the shard threads.
+          if (!shard_threads_.empty()) {
+            while (record_queue_.empty() && num_active_shards_ > 0) {
+              shard_cond_var_.wait(l);
+            }
+            if (!record_queue_.empty()) {
+              out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
+                                        TensorShape({}));
+              out_tensors->back().scalar<string>()() =
+                  std::move(record_queue_.front());
+              record_queue_.pop_front();
+              // Wake shard threads waiting for queue space.
+              shard_cond_var_.notify_all();
+              metrics::RecordTFDataBytesRead(
+                  kTFRecordDatasetName,
+                  out_tensors->back().scalar<string>()().size());
+              *end_of_sequence = false;
+              return Status::OK();
+            }
+            // All shards have finished (or failed); move on to the next
+            // file, surfacing any shard error the way the sequential path
+            // does so that it works with ignore_errors.
+            Status s = shard_status_;
+            ResetStreamsLocked();
+            ++current_file_index_;
+            if (!s.ok()) {
+              return s;
+            }
+          } else if (reader_ || region_reader_) {
             out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
                                       TensorShape({}));
-            Status s =
-                reader_->ReadRecord(&out_tensors->back().scalar<string>()());
+            string* record = &out_tensors->back().scalar<string>()();
+            Status s;
+            if (region_reader_) {
+              // The view aliases the mapped file, so the only copy left is
+              // the one into the output tensor.
+              StringPiece view;
+              s = region_reader_->ReadRecord(&region_offset_, &view);
+              if (s.ok()) {
+                record->assign(view.data(), view.size());
+              }
+            } else {
+              s = reader_->ReadRecord(record);
+            }
             if (s.ok()) {
               metrics::RecordTFDataBytesRead(
                   kTFRecordDatasetName,
@@ -877,12 +961,22 @@ class TFRecordDatasetOp : public DatasetOpKernel {
 
       Status SaveInternal(IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
+        if (!shard_threads_.empty()) {
+          // The interleaved order of in-flight shard reads cannot be
+          // reconstructed from a scalar offset.
+          return errors::Unimplemented(
+              "Cannot save the state of a TFRecordDataset iterator while "
+              "TF_DATA_TFRECORD_PARALLEL_READS > 1.");
+        }
         TF_RETURN_IF_ERROR(writer->WriteScalar(full_name("current_file_index"),
                                                current_file_index_));
 
         if (reader_) {
           TF_RETURN_IF_ERROR(
               writer->WriteScalar(full_name("offset"), reader_->TellOffset()));
+        } else if (region_reader_) {
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(full_name("offset"), region_offset_));
         }
         return Status::OK();
       }
@@ -898,15 +992,23 @@ class TFRecordDatasetOp : public DatasetOpKernel {
         if (reader->Contains(full_name("offset"))) {
           int64 offset;
           TF_RETURN_IF_ERROR(reader->ReadScalar(full_name("offset"), &offset));
-          TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
-          TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+          // A restored offset refers to the sequential read order, so do not
+          // start sharded parallel reads for this file.
+          TF_RETURN_IF_ERROR(
+              SetupStreamsLocked(ctx->env(), /*allow_parallel=*/false));
+          if (region_reader_) {
+            region_offset_ = offset;
+          } else {
+            TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+          }
         }
         return Status::OK();
       }
 
      private:
       // Sets up reader streams to read from the file at `current_file_index_`.
-      Status SetupStreamsLocked(Env* env) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      Status SetupStreamsLocked(Env* env, bool allow_parallel = true)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         if (current_file_index_ >= dataset()->filenames_.size()) {
           return errors::InvalidArgument(
               "current_file_index_:", current_file_index_,
@@ -916,16 +1018,121 @@ class TFRecordDatasetOp : public DatasetOpKernel {
         // Actually move on to next file.
         const string& next_filename =
             dataset()->filenames_[current_file_index_];
+        const int64 parallel_reads = ParallelTFRecordReads();
+        if ((MmapTFRecordsEnabled() || parallel_reads > 1) &&
+            dataset()->options_.compression_type ==
+                io::RecordReaderOptions::NONE) {
+          Status s =
+              env->NewReadOnlyMemoryRegionFromFile(next_filename, &region_);
+          if (s.ok()) {
+            region_reader_ =
+                absl::make_unique<io::MemoryRegionRecordReader>(region_.get());
+            region_offset_ = 0;
+            if (allow_parallel && parallel_reads > 1) {
+              StartShardThreadsLocked(env, parallel_reads);
+            }
+            return Status::OK();
+          }
+          // Fall back to the stream path, e.g. for filesystems that do not
+          // support memory mapping.
+          VLOG(2) << "Could not memory-map " << next_filename << ": " << s
+                  << "; falling back to streaming reads.";
+        }
         TF_RETURN_IF_ERROR(env->NewRandomAccessFile(next_filename, &file_));
         reader_ = absl::make_unique<io::SequentialRecordReader>(
             file_.get(), dataset()->options_);
         return Status::OK();
       }
 
+      // Splits the mapped file into `parallel_reads` byte ranges, each
+      // resynchronized on a record boundary, and starts one reader thread
+      // per non-empty range.  A record belongs to the range containing its
+      // start offset, so the ranges partition the file exactly.
+      void StartShardThreadsLocked(Env* env, int64 parallel_reads)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const uint64 size = region_->length();
+        const uint64 chunk = size / parallel_reads;
+        if (chunk == 0) {
+          // File too small to shard; read it sequentially.
+          return;
+        }
+        shards_cancelled_ = false;
+        shard_status_ = Status::OK();
+        for (int64 i = 0; i < parallel_reads; ++i) {
+          const uint64 range_start = i * chunk;
+          const uint64 range_limit =
+              (i + 1 == parallel_reads) ? size : (i + 1) * chunk;
+          uint64 start_offset = 0;
+          if (i > 0) {
+            Status s =
+                region_reader_->FindRecordBoundary(range_start, &start_offset);
+            if (!s.ok() || start_offset >= range_limit) {
+              // No record starts in this range.
+              continue;
+            }
+          }
+          num_active_shards_++;
+          shard_threads_.emplace_back(env->StartThread(
+              {}, strings::StrCat("tf_data_tfrecord_shard_", i),
+              [this, start_offset, range_limit]() {
+                ReadShard(start_offset, range_limit);
+              }));
+        }
+      }
+
+      // Reads the records starting in [offset, limit) and feeds them into
+      // `record_queue_`.  Record parsing and checksum validation run outside
+      // the lock; only queue operations synchronize.
+      void ReadShard(uint64 offset, uint64 limit) {
+        while (offset < limit) {
+          StringPiece view;
+          Status s = region_reader_->ReadRecord(&offset, &view);
+          if (!s.ok()) {
+            mutex_lock l(mu_);
+            // The sequential path treats trailing EOF as end of file, so
+            // only propagate real errors.
+            if (!errors::IsOutOfRange(s)) {
+              shard_status_.Update(s);
+            }
+            break;
+          }
+          string record(view.data(), view.size());
+          mutex_lock l(mu_);
+          while (record_queue_.size() >= kParallelReadQueueCapacity &&
+                 !shards_cancelled_) {
+            shard_cond_var_.wait(l);
+          }
+          if (shards_cancelled_) {
+            break;
+          }
+          record_queue_.push_back(std::move(record));
+          shard_cond_var_.notify_all();
+        }
+        mutex_lock l(mu_);
+        num_active_shards_--;
+        shard_cond_var_.notify_all();
+      }
+
       // Resets all reader streams.
       void ResetStreamsLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (!shard_threads_.empty()) {
+          shards_cancelled_ = true;
+          shard_cond_var_.notify_all();
+          // Joining needs the shard threads to make progress, so release
+          // the lock; GetNextInternal() is the only caller and holds no
+          // other relevant state across this call.
+          mu_.unlock();
+          shard_threads_.clear();
+          mu_.lock();
+          shards_cancelled_ = false;
+          record_queue_.clear();
+          num_active_shards_ = 0;
+          shard_status_ = Status::OK();
+        }
         reader_.reset();
         file_.reset();
+        region_reader_.reset();
+        region_.reset();
       }
 
       mutex mu_;
@@ -935,6 +1142,25 @@ class TFRecordDatasetOp : public DatasetOpKernel {
       // we must destroy `reader_` before `file_`.
       std::unique_ptr<RandomAccessFile> file_ GUARDED_BY(mu_);
       std::unique_ptr<io::SequentialRecordReader> reader_ GUARDED_BY(mu_);
+
+      // Memory-mapped alternative to `file_` + `reader_`, used when
+      // TF_DATA_TFRECORD_USE_MMAP is set and the file can be mapped.
+      // `region_reader_` borrows `region_`, so it must be destroyed first.
+      std::unique_ptr<ReadOnlyMemoryRegion> region_ GUARDED_BY(mu_);
+      std::unique_ptr<io::MemoryRegionRecordReader> region_reader_
+          GUARDED_BY(mu_);
+      uint64 region_offset_ GUARDED_BY(mu_) = 0;
+
+      // State for sharded parallel reads of the mapped file
+      // (TF_DATA_TFRECORD_PARALLEL_READS > 1).
+      std::deque<string> record_queue_ GUARDED_BY(mu_);
+      int64 num_active_shards_ GUARDED_BY(mu_) = 0;
+      Status shard_status_ GUARDED_BY(mu_);
+      bool shards_cancelled_ GUARDED_BY(mu_) = false;
+      condition_variable shard_cond_var_;
+      // Last member so the shard threads, which use everything above, are
+      // joined first on destruction.
+      std::vector<std::unique_ptr<Thread>> shard_threads_;
     };
 
     const std::vector<string> filenames_;
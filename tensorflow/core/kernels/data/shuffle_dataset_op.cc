@@ -88,98 +88,59 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
                              std::vector<Tensor>* out_tensors,
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
-        int64 start_micros = ctx->env()->NowMicros();
-        int64 num_log_entries = 0;
-        bool first_call = false;
-        if (!input_impl_ && epoch_ == 0) {
-          first_call = true;
-          TF_RETURN_IF_ERROR(this->dataset()->input_->MakeIterator(
-              ctx, this->prefix(), &input_impl_));
-        }
-        while (input_impl_ && num_elements_ < this->dataset()->buffer_size_) {
-          if (ctx->env()->NowMicros() >
-              ((num_log_entries + 1) * kLogIntervalMicros) + start_micros) {
-            num_log_entries++;
-            LOG(INFO) << "Filling up shuffle buffer (this may take a while): "
-                      << num_elements_ << " of "
-                      << this->dataset()->buffer_size_;
-          }
-          std::vector<Tensor> input_element;
-          bool end_of_input_sequence = false;
-          while (this->dataset()->count_ == -1 ||
-                 epoch_ < this->dataset()->count_) {
-            TF_RETURN_IF_ERROR(input_impl_->GetNext(ctx, &input_element,
-                                                    &end_of_input_sequence));
-            if (!end_of_input_sequence) {
-              first_call = false;
-              break;
-            }
-            if (first_call && this->dataset()->count_ == -1) {
-              // If the first call to GetNext() fails because the end
-              // of sequence has been reached, we terminate the
-              // iteration immediately. (Otherwise, this iterator
-              // would loop infinitely and never produce a value.)
-              *end_of_sequence = true;
+        *end_of_sequence = false;
+        while (true) {
+          if (!fill_in_progress_ &&
+              num_elements_ < this->dataset()->buffer_size_ &&
+              (input_impl_ || epoch_ == 0)) {
+            // Become the (unique) filler. FillBufferLocked() releases `mu_`
+            // while it is blocked on the upstream iterator, so concurrent
+            // GetNext() callers can keep extracting from the buffer instead
+            // of serializing behind the refill.
+            fill_in_progress_ = true;
+            Status s = FillBufferLocked(ctx, end_of_sequence);
+            fill_in_progress_ = false;
+            cond_var_.notify_all();
+            TF_RETURN_IF_ERROR(s);
+            if (*end_of_sequence) {
               return Status::OK();
             }
-            epoch_++;
-            int64 n = slices_.back()->end;
-            slices_.push_back(absl::make_unique<Slice>(n, n));
-            TF_RETURN_IF_ERROR(this->dataset()->input_->MakeIterator(
-                ctx, this->prefix(), &input_impl_));
           }
-          if (!end_of_input_sequence) {
-            if (num_elements_ == 0) {
-              VLOG(1) << "Starting to fill up shuffle buffer of size: "
-                      << this->dataset()->buffer_size_;
+
+          if (num_elements_ > 0) {
+            // Garbage collect all empty slices.
+            while (!slices_.empty() &&
+                   slices_.front()->start == slices_.front()->end) {
+              slices_.pop_front();
             }
-            this->RecordBufferEnqueue(ctx, input_element);
-            buffer_[slices_.back()->end % this->dataset()->buffer_size_] =
-                std::move(input_element);
-            num_elements_++;
-            slices_.back()->end++;
-          } else {
-            input_impl_.reset();
+            DCHECK(!slices_.empty());
+            // Choose an element to produce uniformly at random from the first
+            // slice, and then remove the element from the slice.
+            int64 offset =
+                Random() % (slices_.front()->end - slices_.front()->start);
+            int64 index = (slices_.front()->start + offset) %
+                          this->dataset()->buffer_size_;
+            *out_tensors = std::move(buffer_[index]);
+            this->RecordBufferDequeue(ctx, *out_tensors);
+            std::swap(buffer_[index],
+                      buffer_[slices_.front()->start %
+                              this->dataset()->buffer_size_]);
+            slices_.front()->start++;
+            num_elements_--;
+            return Status::OK();
           }
-          if (slices_.size() > kMaxEpochsInBuffer) {
-            // When the elements stored in `buffer_` span more than
-            // `kMaxEpochsInBuffer` epochs, we do not fill the buffer further to
-            // conserve memory. This means that the upper bound on the size of
-            // `buffer_` is `kMaxEpochsInBuffer * cardinality(input_dataset) +
-            // 1`.
-            break;
-          }
-        }
-        if (num_log_entries > 0) {
-          LOG(INFO) << "Shuffle buffer filled.";
-        }
 
-        if (num_elements_ > 0) {
-          *end_of_sequence = false;
-          // Garbage collect all empty slices.
-          while (!slices_.empty() &&
-                 slices_.front()->start == slices_.front()->end) {
-            slices_.pop_front();
+          if (fill_in_progress_) {
+            // Another caller is refilling the buffer; wait for elements
+            // rather than returning a premature end of sequence.
+            cond_var_.wait(l);
+            continue;
           }
-          DCHECK(!slices_.empty());
-          // Choose an element to produce uniformly at random from the first
-          // slice, and then remove the element from the slice.
-          int64 offset =
-              Random() % (slices_.front()->end - slices_.front()->start);
-          int64 index =
-              (slices_.front()->start + offset) % this->dataset()->buffer_size_;
-          *out_tensors = std::move(buffer_[index]);
-          this->RecordBufferDequeue(ctx, *out_tensors);
-          std::swap(
-              buffer_[index],
-              buffer_[slices_.front()->start % this->dataset()->buffer_size_]);
-          slices_.front()->start++;
-          num_elements_--;
-        } else {
+
           DCHECK(input_impl_ == nullptr);
           *end_of_sequence = true;
+          return Status::OK();
         }
-        return Status::OK();
       }
 
      protected:
@@ -199,6 +160,10 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
 
       Status SaveInternal(IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
+        // Wait until no refill is touching `input_impl_` outside the lock.
+        while (fill_in_progress_) {
+          cond_var_.wait(l);
+        }
         // Save state needed to restore the random number generators.
         TF_RETURN_IF_ERROR(writer->WriteScalar(
             this->full_name("num_random_samples"), num_random_samples_));
@@ -248,6 +213,10 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
       Status RestoreInternal(IteratorContext* ctx,
                              IteratorStateReader* reader) override {
         mutex_lock l(mu_);
+        // Wait until no refill is touching `input_impl_` outside the lock.
+        while (fill_in_progress_) {
+          cond_var_.wait(l);
+        }
         // Restore the random number generators.
         TF_RETURN_IF_ERROR(reader->ReadScalar(
             this->full_name("num_random_samples"), &num_random_samples_));
@@ -329,7 +298,95 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
         return out;
       }
 
+      // Fills `buffer_` from the input until it is full or the input is
+      // exhausted.  Must be called with `fill_in_progress_` set, which makes
+      // this thread the only one touching `input_impl_`; `mu_` is released
+      // around each upstream GetNext() call.  Sets `*end_of_sequence` iff the
+      // very first upstream call hits end of sequence on an infinite repeat.
+      Status FillBufferLocked(IteratorContext* ctx, bool* end_of_sequence)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        int64 start_micros = ctx->env()->NowMicros();
+        int64 num_log_entries = 0;
+        bool first_call = false;
+        if (!input_impl_ && epoch_ == 0) {
+          first_call = true;
+          TF_RETURN_IF_ERROR(this->dataset()->input_->MakeIterator(
+              ctx, this->prefix(), &input_impl_));
+        }
+        while (input_impl_ && num_elements_ < this->dataset()->buffer_size_) {
+          if (ctx->env()->NowMicros() >
+              ((num_log_entries + 1) * kLogIntervalMicros) + start_micros) {
+            num_log_entries++;
+            LOG(INFO) << "Filling up shuffle buffer (this may take a while): "
+                      << num_elements_ << " of "
+                      << this->dataset()->buffer_size_;
+          }
+          std::vector<Tensor> input_element;
+          bool end_of_input_sequence = false;
+          while (this->dataset()->count_ == -1 ||
+                 epoch_ < this->dataset()->count_) {
+            // Consumers only remove elements, so the slot reserved for this
+            // element cannot disappear while the lock is dropped.
+            mu_.unlock();
+            Status s = input_impl_->GetNext(ctx, &input_element,
+                                            &end_of_input_sequence);
+            mu_.lock();
+            TF_RETURN_IF_ERROR(s);
+            if (!end_of_input_sequence) {
+              first_call = false;
+              break;
+            }
+            if (first_call && this->dataset()->count_ == -1) {
+              // If the first call to GetNext() fails because the end
+              // of sequence has been reached, we terminate the
+              // iteration immediately. (Otherwise, this iterator
+              // would loop infinitely and never produce a value.)
+              *end_of_sequence = true;
+              return Status::OK();
+            }
+            epoch_++;
+            int64 n = slices_.back()->end;
+            slices_.push_back(absl::make_unique<Slice>(n, n));
+            TF_RETURN_IF_ERROR(this->dataset()->input_->MakeIterator(
+                ctx, this->prefix(), &input_impl_));
+          }
+          if (!end_of_input_sequence) {
+            if (num_elements_ == 0) {
+              VLOG(1) << "Starting to fill up shuffle buffer of size: "
+                      << this->dataset()->buffer_size_;
+            }
+            this->RecordBufferEnqueue(ctx, input_element);
+            buffer_[slices_.back()->end % this->dataset()->buffer_size_] =
+                std::move(input_element);
+            num_elements_++;
+            slices_.back()->end++;
+          } else {
+            input_impl_.reset();
+          }
+          if (slices_.size() > kMaxEpochsInBuffer) {
+            // When the elements stored in `buffer_` span more than
+            // `kMaxEpochsInBuffer` epochs, we do not fill the buffer further to
+            // conserve memory. This means that the upper bound on the size of
+            // `buffer_` is `kMaxEpochsInBuffer * cardinality(input_dataset) +
+            // 1`.
+            break;
+          }
+        }
+        if (num_log_entries > 0) {
+          LOG(INFO) << "Shuffle buffer filled.";
+        }
+        return Status::OK();
+      }
+
       std::unique_ptr<std::vector<Tensor>[]> buffer_ GUARDED_BY(mu_);
+      // True while some GetNext() caller is inside FillBufferLocked(). That
+      // caller has exclusive use of `input_impl_` even while `mu_` is
+      // released around upstream GetNext() calls.
+      bool fill_in_progress_ GUARDED_BY(mu_) = false;
+      // Signals both the completion of a refill and buffer availability to
+      // callers waiting in GetNextInternal(), SaveInternal() or
+      // RestoreInternal().
+      condition_variable cond_var_;
       std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
       int64 epoch_ GUARDED_BY(mu_);
       int64 num_elements_ GUARDED_BY(mu_);
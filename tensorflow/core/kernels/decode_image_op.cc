@@ -129,6 +129,23 @@ class DecodeImageOp : public OpKernel {
                      context->GetAttr("acceptable_fraction",
                                       &flags_.min_acceptable_fraction));
 
+      if (type_string() == "DecodeJpeg") {
+        std::vector<int32> size_hint;
+        OP_REQUIRES_OK(context, context->GetAttr("size_hint", &size_hint));
+        OP_REQUIRES(context, size_hint.empty() || size_hint.size() == 2,
+                    errors::InvalidArgument(
+                        "size_hint must be empty or have two elements, got ",
+                        size_hint.size()));
+        if (size_hint.size() == 2) {
+          OP_REQUIRES(context, size_hint[0] > 0 && size_hint[1] > 0,
+                      errors::InvalidArgument(
+                          "size_hint elements must be positive, got [",
+                          size_hint[0], ", ", size_hint[1], "]"));
+          flags_.min_output_height = size_hint[0];
+          flags_.min_output_width = size_hint[1];
+        }
+      }
+
       string dct_method;
       OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
       OP_REQUIRES(
@@ -21,6 +21,8 @@ limitations under the License.
 #include <stdlib.h>
 
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/kernels/conv_ops.h"
 #include "tensorflow/core/kernels/winograd_transform.h"
 #include "tensorflow/core/util/work_sharder.h"
 
@@ -961,15 +963,47 @@ struct DeepConv2D<CPUDevice, T> {
         std::max(int64{0}, args.filter_cols - base_filter_rows);
     const int64 filter_shards_col = 1 + (filter_residual_col + 2 - 1) / 2;
 
-    // Allocate buffer for transformed filters.
-    Tensor filter_transform;
-    OP_REQUIRES_OK(
-        ctx, ctx->allocate_temp(
-                 DataTypeToEnum<T>::value,
-                 TensorShape({tile_rows, tile_cols, out_depth,
-                              filter_shards_row, filter_shards_col, in_depth}),
-                 &filter_transform));
-    T* filter_transform_data = filter_transform.template flat<T>().data();
+    // The transformed-filter buffer and the two transform matrices are
+    // reallocated with the same sizes on every invocation, which shows up as
+    // allocator churn when serving small batches. Keep a persistent scratch
+    // buffer around between calls (sized to the worst case seen) through
+    // TensorFlow's resource management, as conv_ops_using_gemm.cc does for
+    // its im2col buffer, so the memory is released when the session is over.
+    ConvScratchBufferResource<T>* scratch_resource;
+    std::function<Status(ConvScratchBufferResource<T>**)> creator =
+        [](ConvScratchBufferResource<T>** resource) {
+          *resource = new ConvScratchBufferResource<T>();
+          return Status::OK();
+        };
+    OP_REQUIRES_OK(ctx, ctx->resource_manager()->LookupOrCreate(
+                            "DeepConv2d", "scratch_buffer", &scratch_resource,
+                            creator));
+    // This means that multiple DeepConv2D ops can't run simultaneously on
+    // different threads, because they share a single scratch resource. The
+    // buffers below are read by the compute shards, so the lock must be held
+    // until sharded execution completes at the end of this function.
+    mutex_lock lock_buffer(scratch_resource->mu);
+    core::ScopedUnref unref_buffer(scratch_resource);
+
+    // Partition the scratch buffer into the transformed filters:
+    //   [tile_rows, tile_cols, out_depth, shard_rows, shard_cols, in_depth]
+    // the tile transform matrix: [tile_spatial_size, tile_spatial_size]
+    // and the output transform matrix:
+    //   [out_tile_spatial_size, tile_spatial_size]
+    const int64 filter_transform_size = tile_spatial_size * out_depth *
+                                        filter_shards_row * filter_shards_col *
+                                        in_depth;
+    const int64 tile_transform_matrix_size =
+        tile_spatial_size * tile_spatial_size;
+    const int64 output_transform_matrix_size =
+        out_tile_spatial_size * tile_spatial_size;
+    T* scratch_data = scratch_resource->Reserve(
+        filter_transform_size + tile_transform_matrix_size +
+        output_transform_matrix_size);
+    T* filter_transform_data = scratch_data;
+    T* tile_transform_matrix = filter_transform_data + filter_transform_size;
+    T* output_transform_matrix =
+        tile_transform_matrix + tile_transform_matrix_size;
 
     // Transform filters.
     TransformFilters<T>()(ctx, args, transform.get(), filter_shards_row,
@@ -980,25 +1014,9 @@ struct DeepConv2D<CPUDevice, T> {
     PackFilters<T>()(ctx, args, tile_spatial_size, filter_shards_row,
                      filter_shards_col, filter_transform_data, &packed_filters);
 
-    // Allocate buffer for tile transform matrix.
-    Tensor tile_transform_matrix_tensor;
-    OP_REQUIRES_OK(ctx, ctx->allocate_temp(
-                            DataTypeToEnum<T>::value,
-                            TensorShape({tile_spatial_size, tile_spatial_size}),
-                            &tile_transform_matrix_tensor));
-    T* tile_transform_matrix =
-        tile_transform_matrix_tensor.template flat<T>().data();
     transform->GetInputTransformMatrix(tile_spatial_size, tile_spatial_size,
                                        tile_transform_matrix);
 
-    // Allocate buffer for output transform matrix.
-    Tensor output_transform_matrix_tensor;
-    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::value,
-                                           TensorShape({out_tile_spatial_size,
-                                                        tile_spatial_size}),
-                                           &output_transform_matrix_tensor));
-    T* output_transform_matrix =
-        output_transform_matrix_tensor.template flat<T>().data();
     transform->GetOutputTransformMatrix(
         out_tile_spatial_size, tile_spatial_size, output_transform_matrix);
 
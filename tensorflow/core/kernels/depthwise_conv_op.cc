@@ -139,6 +139,64 @@ struct DepthwiseConv2DKernel {
   }
 };
 
+// Specialized kernel for 3x3 filters with depth_multiplier == 1, the shape
+// that dominates MobileNet-style graphs. With no depth replication the NHWC
+// input is already laid out for vectorization across channels, so the kernel
+// reads it in place instead of staging each patch through the input buffer,
+// with the nine taps fully unrolled per channel register. Only valid for
+// output columns whose entire 3x3 receptive field is in bounds; the caller
+// routes boundary columns through the buffered kernel above.
+template <typename T>
+struct DepthwiseConv2DKernel3x3 {
+  typedef typename Eigen::internal::packet_traits<T>::type Packet;
+
+  // 'input' and 'output' point at the current image (batch element).
+  static void Run(const DepthwiseArgs& args, const int64 out_r,
+                  const int64 out_c_begin, const int64 out_c_end,
+                  const T* input, const T* filter, T* output) {
+    static const int64 kPacketSize = (sizeof(Packet) / sizeof(T));
+    const int64 depth = args.in_depth;
+    const int64 in_row_size = args.in_cols * depth;
+    const int64 vectorized_size = (depth / kPacketSize) * kPacketSize;
+    const int64 in_r = out_r * args.stride - args.pad_rows;
+
+    for (int64 out_c = out_c_begin; out_c < out_c_end; ++out_c) {
+      const int64 in_c = out_c * args.stride - args.pad_cols;
+      const T* in_base = input + in_r * in_row_size + in_c * depth;
+      T* out = output + (out_r * args.out_cols + out_c) * depth;
+
+      int64 d = 0;
+      for (; d < vectorized_size; d += kPacketSize) {
+        auto vaccum = Eigen::internal::pset1<Packet>(static_cast<T>(0));
+        for (int64 f_r = 0; f_r < 3; ++f_r) {
+          const T* in_row = in_base + f_r * in_row_size + d;
+          const T* filter_row = filter + f_r * 3 * depth + d;
+          vaccum = Eigen::internal::pmadd<Packet>(
+              Eigen::internal::ploadu<Packet>(filter_row),
+              Eigen::internal::ploadu<Packet>(in_row), vaccum);
+          vaccum = Eigen::internal::pmadd<Packet>(
+              Eigen::internal::ploadu<Packet>(filter_row + depth),
+              Eigen::internal::ploadu<Packet>(in_row + depth), vaccum);
+          vaccum = Eigen::internal::pmadd<Packet>(
+              Eigen::internal::ploadu<Packet>(filter_row + 2 * depth),
+              Eigen::internal::ploadu<Packet>(in_row + 2 * depth), vaccum);
+        }
+        Eigen::internal::pstoreu<T>(out + d, vaccum);
+      }
+      for (; d < depth; ++d) {
+        T accum = static_cast<T>(0);
+        for (int64 f_r = 0; f_r < 3; ++f_r) {
+          for (int64 f_c = 0; f_c < 3; ++f_c) {
+            accum += filter[(f_r * 3 + f_c) * depth + d] *
+                     in_base[f_r * in_row_size + f_c * depth + d];
+          }
+        }
+        out[d] = accum;
+      }
+    }
+  }
+};
+
 // Computes the depthwise conv2d of 'input' by 'depthwise_filter' and stores
 // the result in 'output'. This implementation trades off copying small patches
 // of the input to achieve better data alignment, which enables vectorized
@@ -183,8 +241,15 @@ struct LaunchDepthwiseConvOp<CPUDevice, T> {
     const T* filter_data =
         pad_filter ? padded_filter.template flat<T>().data() : depthwise_filter;
 
+    // The 3x3 multiplier-1 kernel reads the unpadded filter and the input in
+    // place, so it needs neither the padded filter nor the input buffer.
+    const bool use_3x3_kernel =
+        args.filter_rows == 3 && args.filter_cols == 3 &&
+        args.depth_multiplier == 1 && args.in_rows >= 3 && args.in_cols >= 3;
+
     // Computes one shard of depthwise conv2d output.
-    auto shard = [&ctx, &args, &input, &filter_data, &output, data_format](
+    auto shard = [&ctx, &args, &input, &depthwise_filter, &filter_data,
+                  &output, data_format, use_3x3_kernel](
                      int64 start, int64 limit) {
       static const int64 kPacketSize = (sizeof(Packet) / sizeof(T));
       const int64 input_image_size =
@@ -211,7 +276,8 @@ struct LaunchDepthwiseConvOp<CPUDevice, T> {
 
         const int64 out_r = i % args.out_rows;
 
-        for (int64 out_c = 0; out_c < args.out_cols; ++out_c) {
+        // Computes output column 'out_c' through the buffered kernel.
+        auto process_buffered = [&](int64 out_c) {
           // Populate 'input_buffer_data' with data from local input region.
           functor::DepthwiseInputCopyOp<T>()(args, padded_filter_inner_dim_size,
                                              out_r, out_c, input + in_base,
@@ -221,6 +287,34 @@ struct LaunchDepthwiseConvOp<CPUDevice, T> {
           DepthwiseConv2DKernel<T>::Run(
               args, padded_filter_inner_dim_size, out_r, out_c, filter_data,
               input_buffer_data, output + out_base, data_format);
+        };
+
+        const int64 in_r = out_r * args.stride - args.pad_rows;
+        if (use_3x3_kernel && in_r >= 0 && in_r + 3 <= args.in_rows) {
+          // Columns [fast_begin, fast_end) have their whole 3x3 receptive
+          // field in bounds; boundary columns go through the buffered kernel.
+          int64 fast_begin =
+              (args.pad_cols + args.stride - 1) / args.stride;
+          int64 fast_end =
+              (args.in_cols + args.pad_cols - 3) / args.stride + 1;
+          fast_begin = std::min<int64>(fast_begin, args.out_cols);
+          fast_end = std::min<int64>(std::max(fast_end, fast_begin),
+                                     args.out_cols);
+          for (int64 out_c = 0; out_c < fast_begin; ++out_c) {
+            process_buffered(out_c);
+          }
+          if (fast_end > fast_begin) {
+            DepthwiseConv2DKernel3x3<T>::Run(args, out_r, fast_begin, fast_end,
+                                             input + in_base, depthwise_filter,
+                                             output + out_base);
+          }
+          for (int64 out_c = fast_end; out_c < args.out_cols; ++out_c) {
+            process_buffered(out_c);
+          }
+        } else {
+          for (int64 out_c = 0; out_c < args.out_cols; ++out_c) {
+            process_buffered(out_c);
+          }
         }
       }
     };
@@ -15,6 +15,7 @@ limitations under the License.
 
 // See docs in ../ops/data_flow_ops.cc.
 
+#include <algorithm>
 #include <vector>
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -23,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -99,6 +101,113 @@ class DynamicPartitionOp : public DynamicPartitionOp_Shared {
     const int64 N = e_partitions.dimension(0);
     gtl::InlinedVector<int, 32> output_index(num_partitions_);
 
+    // Parallel path: a sharded counting pass computes per-block partition
+    // counts, a serial prefix sum over blocks turns them into starting
+    // offsets, and a second sharded pass scatters slices into the
+    // preallocated outputs. Blocks cover disjoint contiguous index ranges
+    // and every output position is owned by exactly one block, so no
+    // synchronization is needed and the result is identical to the serial
+    // walk below.
+    auto worker_threads = c->device()->tensorflow_cpu_worker_threads();
+    static const int64 kMinElemsForParallelPartition = 1 << 16;
+    const int64 slice_size = data->NumElements() / N;
+    const int64 num_blocks =
+        std::min(static_cast<int64>(worker_threads->num_threads), N);
+    if (num_blocks > 1 &&
+        data->NumElements() >= kMinElemsForParallelPartition) {
+      std::vector<std::vector<int64>> block_counts(
+          num_blocks, std::vector<int64>(num_partitions_, 0));
+      std::vector<int64> block_bad_index(num_blocks, -1);
+      auto count_blocks = [&](int64 start_block, int64 limit_block) {
+        for (int64 b = start_block; b < limit_block; ++b) {
+          const int64 start = N * b / num_blocks;
+          const int64 limit = N * (b + 1) / num_blocks;
+          std::vector<int64>& counts = block_counts[b];
+          for (int64 i = start; i < limit; ++i) {
+            const int32 p = internal::SubtleMustCopy(e_partitions(i));
+            if (!FastBoundsCheck(p, num_partitions_)) {
+              block_bad_index[b] = i;
+              break;
+            }
+            counts[p]++;
+          }
+        }
+      };
+      Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+            N / num_blocks, count_blocks);
+      for (int64 b = 0; b < num_blocks; ++b) {
+        OP_REQUIRES(c, block_bad_index[b] < 0,
+                    errors::InvalidArgument("indices[", block_bad_index[b],
+                                            "] is out of range"));
+      }
+      // Prefix-sum the per-block counts into per-block starting offsets,
+      // and verify the totals still match the allocated outputs (the counts
+      // were taken again in case partitions was asynchronously overwritten
+      // after allocation).
+      for (int p = 0; p < num_partitions_; ++p) {
+        int64 running = 0;
+        for (int64 b = 0; b < num_blocks; ++b) {
+          const int64 count = block_counts[b][p];
+          block_counts[b][p] = running;
+          running += count;
+        }
+        OP_REQUIRES(c, running == outputs[p]->dim_size(0),
+                    errors::InvalidArgument(
+                        "Size of output ", p, ": ", outputs[p]->dim_size(0),
+                        " is no longer in range."));
+      }
+      const auto data_flat = data->shaped<T, 2>({N, slice_size});
+      std::vector<Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
+                                   Eigen::Aligned> >
+          out_flat;
+      out_flat.reserve(num_partitions_);
+      for (int p = 0; p < num_partitions_; p++) {
+        out_flat.push_back(outputs[p]->flat_outer_dims<T>());
+      }
+      const bool use_memcpy = DataTypeCanUseMemcpy(DataTypeToEnum<T>::v());
+      const size_t slice_bytes = slice_size * sizeof(T);
+      auto scatter_blocks = [&](int64 start_block, int64 limit_block) {
+        Eigen::DSizes<Eigen::DenseIndex, 2> sizes(1, slice_size);
+        for (int64 b = start_block; b < limit_block; ++b) {
+          const int64 start = N * b / num_blocks;
+          const int64 limit = N * (b + 1) / num_blocks;
+          // Each block owns its offsets exclusively; advance them in place.
+          std::vector<int64>& offsets = block_counts[b];
+          for (int64 i = start; i < limit; ++i) {
+            const int32 p = internal::SubtleMustCopy(e_partitions(i));
+            if (!FastBoundsCheck(p, num_partitions_)) {
+              block_bad_index[b] = i;
+              break;
+            }
+            const int64 oi = offsets[p]++;
+            if (!FastBoundsCheck(oi, out_flat[p].dimension(0))) {
+              block_bad_index[b] = i;
+              break;
+            }
+            if (use_memcpy) {
+              memcpy(out_flat[p].data() + oi * slice_size,
+                     data_flat.data() + i * slice_size, slice_bytes);
+            } else {
+              Eigen::DSizes<Eigen::DenseIndex, 2> out_indices(oi, 0);
+              Eigen::DSizes<Eigen::DenseIndex, 2> data_indices(i, 0);
+              out_flat[p].slice(out_indices, sizes) =
+                  data_flat.slice(data_indices, sizes);
+            }
+          }
+        }
+      };
+      Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+            (N / num_blocks) * slice_size, scatter_blocks);
+      for (int64 b = 0; b < num_blocks; ++b) {
+        OP_REQUIRES(c, block_bad_index[b] < 0,
+                    errors::InvalidArgument("indices[", block_bad_index[b],
+                                            "] has been asynchronously "
+                                            "overwritten and is no longer "
+                                            "in range!"));
+      }
+      return;
+    }
+
     if (partitions->dims() == data->dims()) {
       // Walk through data and copy the data to the appropriate output tensor
       const auto data_flat = data->flat<T>();
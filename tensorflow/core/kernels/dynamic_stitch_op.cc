@@ -15,6 +15,8 @@ limitations under the License.
 
 // See docs in ../ops/data_flow_ops.cc.
 
+#include <vector>
+
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -251,6 +253,46 @@ class DynamicStitchOpImplCPU : public DynamicStitchOpImplBase<T> {
       auto merged_flat = merged->flat_outer_dims<T>();
       const int slice_size = merged_flat.dimension(1);
       const size_t slice_bytes = slice_size * sizeof(T);
+
+      // Parallel path for large memcpy-able stitches: a serial pre-pass
+      // resolves each output row to the last slice written to it (the same
+      // structure the GPU implementation uses to deal with collisions), then
+      // the row copies — which are now collision free — run in parallel.
+      // Rows not covered by any index are left untouched, as in the serial
+      // path below.
+      static const int64 kMinBytesForParallelStitch = 1 << 16;
+      auto thread_pool = c->device()->tensorflow_cpu_worker_threads()->workers;
+      const int num_threads =
+          c->device()->tensorflow_cpu_worker_threads()->num_threads;
+      if (num_threads > 1 && DataTypeCanUseMemcpy(DataTypeToEnum<T>::v()) &&
+          static_cast<int64>(first_dim_size) * slice_bytes >=
+              kMinBytesForParallelStitch) {
+        std::vector<const T*> row_source(first_dim_size, nullptr);
+        for (int input_num = 0; input_num < indices_inputs.size();
+             ++input_num) {
+          auto indices_vec = indices_inputs[input_num].flat<int32>();
+          const T* data_base = data_inputs[input_num].template flat<T>().data();
+          for (int i = 0; i < indices_vec.size(); ++i) {
+            int32 index = internal::SubtleMustCopy(indices_vec(i));
+            OP_REQUIRES(
+                c, FastBoundsCheck(index, first_dim_size),
+                errors::InvalidArgument("indices[", i, "] is out of range"));
+            row_source[index] = data_base + i * slice_size;
+          }
+        }
+        T* merged_base = merged_flat.data();
+        auto CopyRows = [&](int first, int last) {
+          for (int row = first; row < last; ++row) {
+            if (row_source[row] != nullptr) {
+              memcpy(merged_base + row * slice_size, row_source[row],
+                     slice_bytes);
+            }
+          }
+        };
+        thread_pool->ParallelFor(first_dim_size, slice_bytes, CopyRows);
+        return;
+      }
+
       auto OnInputNumber = [&](int input_num) {
         const Tensor& indices = indices_inputs[input_num];
         auto indices_vec = indices.flat<int32>();
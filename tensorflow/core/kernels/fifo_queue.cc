@@ -16,6 +16,7 @@ limitations under the License.
 // See docs in ../ops/data_flow_ops.cc.
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <vector>
 
@@ -33,10 +34,19 @@ limitations under the License.
 
 namespace tensorflow {
 
+constexpr int FIFOQueue::kStagingSlots;
+
 FIFOQueue::FIFOQueue(int capacity, const DataTypeVector& component_dtypes,
                      const std::vector<TensorShape>& component_shapes,
                      const string& name)
-    : TypedQueue(capacity, component_dtypes, component_shapes, name) {}
+    : TypedQueue(capacity, component_dtypes, component_shapes, name),
+      num_elements_(0),
+      staging_head_(0),
+      staging_tail_(0) {
+  for (int i = 0; i < kStagingSlots; ++i) {
+    staging_[i].seq.store(i, std::memory_order_relaxed);
+  }
+}
 
 void FIFOQueue::DequeueLocked(OpKernelContext* ctx, Tuple* tuple) {
   DCHECK_GT(queues_[0].size(), size_t{0});
@@ -45,10 +55,89 @@ void FIFOQueue::DequeueLocked(OpKernelContext* ctx, Tuple* tuple) {
     (*tuple).push_back(*queues_[i][0].AccessTensor(ctx));
     queues_[i].pop_front();
   }
+  num_elements_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool FIFOQueue::TryReserveElement() {
+  int64 size = num_elements_.load(std::memory_order_relaxed);
+  while (size < capacity_) {
+    if (num_elements_.compare_exchange_weak(size, size + 1)) {
+      return true;
+    }
+    // 'size' was reloaded by compare_exchange_weak; re-check the bound.
+  }
+  return false;
+}
+
+bool FIFOQueue::TryStageElement(const Tuple& tuple) {
+  uint64 head = staging_head_.load(std::memory_order_relaxed);
+  while (true) {
+    StagedSlot* slot = &staging_[head % kStagingSlots];
+    const uint64 seq = slot->seq.load(std::memory_order_acquire);
+    const int64 dif = static_cast<int64>(seq - head);
+    if (dif == 0) {
+      // The slot is free in the current lap; try to claim it.
+      if (staging_head_.compare_exchange_weak(head, head + 1,
+                                              std::memory_order_relaxed)) {
+        slot->tuple = tuple;
+        slot->seq.store(head + 1, std::memory_order_release);
+        return true;
+      }
+      // 'head' was reloaded by compare_exchange_weak; retry.
+    } else if (dif < 0) {
+      // The slot still holds an element from the previous lap: the ring is
+      // full.
+      return false;
+    } else {
+      // Another producer claimed the slot; move to the current head.
+      head = staging_head_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void FIFOQueue::DrainStagedElementsLocked() {
+  while (true) {
+    StagedSlot* slot = &staging_[staging_tail_ % kStagingSlots];
+    if (slot->seq.load(std::memory_order_acquire) != staging_tail_ + 1) {
+      // Either the ring is empty, or the next producer has claimed its slot
+      // but not yet published it. In the latter case that producer flushes
+      // once it publishes, so the element is picked up by a later drain.
+      return;
+    }
+    for (int i = 0; i < num_components(); ++i) {
+      queues_[i].push_back(PersistentTensor(slot->tuple[i]));
+    }
+    slot->tuple.clear();
+    slot->seq.store(staging_tail_ + kStagingSlots, std::memory_order_release);
+    ++staging_tail_;
+  }
 }
 
 void FIFOQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
                            DoneCallback callback) {
+  // Fast path: stage the element in the lock-free ring without registering a
+  // cancellation callback or creating an attempt. This is only safe while no
+  // enqueue attempts are waiting (so element order is preserved) and the
+  // queue has not been closed; capacity is enforced by the reservation.
+  if (!closed_nolock_.load(std::memory_order_acquire) &&
+      num_enqueue_attempts_.load(std::memory_order_relaxed) == 0 &&
+      TryReserveElement()) {
+    if (TryStageElement(tuple)) {
+      // A dequeue attempt may have gone to sleep just before the element
+      // became visible. The fence orders the publication above against the
+      // waiter check below, so either we observe the waiter here or the
+      // waiter's own flush observes the element.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (num_dequeue_attempts_.load(std::memory_order_relaxed) > 0) {
+        FlushUnlocked();
+      }
+      callback();
+      return;
+    }
+    // The staging ring is full; fall back to the locked path.
+    UnreserveElement();
+  }
+
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
@@ -60,12 +149,13 @@ void FIFOQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
       enqueue_attempts_.emplace_back(
           1, callback, ctx, cm, token,
           [tuple, this](Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+            DrainStagedElementsLocked();
             if (closed_) {
               attempt->context->SetStatus(
                   errors::Cancelled("FIFOQueue '", name_, "' is closed."));
               return kComplete;
             }
-            if (queues_[0].size() < static_cast<size_t>(capacity_)) {
+            if (TryReserveElement()) {
               for (int i = 0; i < num_components(); ++i) {
                 queues_[i].push_back(PersistentTensor(tuple[i]));
               }
@@ -74,6 +164,7 @@ void FIFOQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
               return kNoProgress;
             }
           });
+      ++num_enqueue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -118,13 +209,14 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
       enqueue_attempts_.emplace_back(
           batch_size, callback, ctx, cm, token,
           [tuple, this](Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+            DrainStagedElementsLocked();
             if (closed_) {
               attempt->context->SetStatus(
                   errors::Cancelled("FIFOQueue '", name_, "' is closed."));
               return kComplete;
             }
             RunResult result = kNoProgress;
-            while (queues_[0].size() < static_cast<size_t>(capacity_)) {
+            while (TryReserveElement()) {
               result = kProgress;
               const int64 index =
                   tuple[0].dim_size(0) - attempt->elements_requested;
@@ -132,7 +224,10 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
                 PersistentTensor element;
                 attempt->context->SetStatus(GetElementComponentFromBatch(
                     tuple, index, i, attempt->context, &element));
-                if (!attempt->context->status().ok()) return kComplete;
+                if (!attempt->context->status().ok()) {
+                  if (i == 0) UnreserveElement();
+                  return kComplete;
+                }
                 queues_[i].push_back(element);
               }
               --attempt->elements_requested;
@@ -142,6 +237,7 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
             }
             return result;
           });
+      ++num_enqueue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -153,6 +249,33 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
 }
 
 void FIFOQueue::TryDequeue(OpKernelContext* ctx, CallbackWithTuple callback) {
+  // Fast path: if no dequeue attempts are waiting ahead of us and an element
+  // is available, dequeue it immediately without registering a cancellation
+  // callback or creating an attempt; the callback runs outside the lock.
+  {
+    bool dequeued = false;
+    bool flush_needed = false;
+    Tuple tuple;
+    {
+      mutex_lock l(mu_);
+      if (dequeue_attempts_.empty()) {
+        DrainStagedElementsLocked();
+        if (!queues_[0].empty()) {
+          DequeueLocked(ctx, &tuple);
+          dequeued = true;
+          // The dequeue freed capacity, so a waiting enqueue may be able to
+          // make progress.
+          flush_needed = !enqueue_attempts_.empty();
+        }
+      }
+    }
+    if (dequeued) {
+      if (flush_needed) FlushUnlocked();
+      callback(tuple);
+      return;
+    }
+  }
+
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
@@ -165,6 +288,7 @@ void FIFOQueue::TryDequeue(OpKernelContext* ctx, CallbackWithTuple callback) {
       dequeue_attempts_.emplace_back(
           1, [callback]() { callback(Tuple()); }, ctx, cm, token,
           [callback, this](Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+            DrainStagedElementsLocked();
             const int64 queue_size = queues_[0].size();
             if (closed_ && queue_size == 0) {
               attempt->context->SetStatus(errors::OutOfRange(
@@ -182,6 +306,7 @@ void FIFOQueue::TryDequeue(OpKernelContext* ctx, CallbackWithTuple callback) {
               return kNoProgress;
             }
           });
+      ++num_dequeue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -257,6 +382,7 @@ void FIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
           num_elements, [callback]() { callback(Tuple()); }, ctx, cm, token,
           [callback, allow_small_batch,
            this](Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+            DrainStagedElementsLocked();
             int64 queue_size = queues_[0].size();
 
             if (closed_ && queue_size < attempt->elements_requested) {
@@ -281,6 +407,7 @@ void FIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
                     }
                     queues_[j].push_front(element);
                   }
+                  num_elements_.fetch_add(1, std::memory_order_relaxed);
                 }
               }
               if (allow_small_batch && !queues_[0].empty()) {
@@ -345,6 +472,7 @@ void FIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
             }
             return result;
           });
+      ++num_dequeue_attempts_;
     }
   }
   if (!already_cancelled) {
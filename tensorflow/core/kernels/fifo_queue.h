@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_FIFO_QUEUE_H_
 #define TENSORFLOW_CORE_KERNELS_FIFO_QUEUE_H_
 
+#include <atomic>
 #include <deque>
 #include <vector>
 
@@ -50,8 +51,7 @@ class FIFOQueue : public TypedQueue<std::deque<PersistentTensor> > {
   Status MatchesNodeDef(const NodeDef& node_def) override;
 
   int32 size() const override {
-    mutex_lock lock(mu_);
-    return queues_[0].size();
+    return num_elements_.load(std::memory_order_relaxed);
   }
 
  protected:
@@ -66,7 +66,47 @@ class FIFOQueue : public TypedQueue<std::deque<PersistentTensor> > {
                                              OpKernelContext* ctx,
                                              PersistentTensor* out_element);
 
+  // Moves every published element out of the staging ring into queues_, in
+  // enqueue order. Must be called before any code that inspects or modifies
+  // queues_ directly, so that staged elements are not reordered with respect
+  // to elements added under the lock.
+  void DrainStagedElementsLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Reserves room for one element against capacity_ and returns true, or
+  // returns false if the queue is full. The reservation must be released
+  // with UnreserveElement() if no element is added, and is otherwise
+  // released by DequeueLocked().
+  bool TryReserveElement();
+  void UnreserveElement() {
+    num_elements_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // Number of elements in the queue: staged, in queues_, or reserved by an
+  // enqueue in flight. The authoritative count for capacity checks.
+  std::atomic<int64> num_elements_;
+
  private:
+  // Multi-producer staging ring for the lock-free enqueue fast path, in the
+  // style of a bounded MPMC ring with per-slot sequence numbers. Producers
+  // claim a slot by advancing staging_head_ and publish it by storing
+  // seq = claim + 1; the consumer side is serialized by mu_ and moves
+  // published elements into queues_ (see DrainStagedElementsLocked), making
+  // the ring effectively multi-producer/single-consumer.
+  struct StagedSlot {
+    std::atomic<uint64> seq;
+    Tuple tuple;
+  };
+
+  static constexpr int kStagingSlots = 64;
+
+  // Claims a slot and publishes 'tuple' in it. Returns false (leaving the
+  // ring unchanged) if the ring is full.
+  bool TryStageElement(const Tuple& tuple);
+
+  std::atomic<uint64> staging_head_;
+  uint64 staging_tail_ GUARDED_BY(mu_);
+  StagedSlot staging_[kStagingSlots];
+
   TF_DISALLOW_COPY_AND_ASSIGN(FIFOQueue);
 };
 
@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/fill_functor.h"
 #include "tensorflow/core/kernels/fused_batch_norm_op.h"
 #include "tensorflow/core/util/tensor_format.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 using CPUDevice = Eigen::ThreadPoolDevice;
@@ -62,6 +63,82 @@ struct CastIfNecessary<true, Y, X, T> {
   }
 };
 
+// Fast path for inference mode (is_training=false) when T == U. The
+// estimated statistics are constants, so they are folded once per invocation
+// into a per-channel multiplier and offset:
+//   scaling_factor = scale * rsqrt(variance + epsilon)
+//   shifted_offset = offset - mean * scaling_factor
+// which are then applied along each NHWC row with a packet fused
+// multiply-add, writing the output in a single pass. Rows are distributed
+// over the worker threads. Returns false when T != U (the mixed-precision
+// case keeps the Eigen expression below, which fuses the cast).
+template <bool IsSame, typename T, typename U>
+struct FusedBatchNormFrozenInference {
+  static inline bool process(OpKernelContext* context,
+                             typename TTypes<T, 4>::ConstTensor x,
+                             typename TTypes<U>::ConstVec scale,
+                             typename TTypes<U>::ConstVec offset,
+                             typename TTypes<U>::ConstVec estimated_mean,
+                             typename TTypes<U>::ConstVec estimated_variance,
+                             U epsilon, typename TTypes<T, 4>::Tensor y) {
+    return false;
+  }
+};
+
+template <typename T, typename U>
+struct FusedBatchNormFrozenInference<true, T, U> {
+  static inline bool process(OpKernelContext* context,
+                             typename TTypes<T, 4>::ConstTensor x,
+                             typename TTypes<U>::ConstVec scale,
+                             typename TTypes<U>::ConstVec offset,
+                             typename TTypes<U>::ConstVec estimated_mean,
+                             typename TTypes<U>::ConstVec estimated_variance,
+                             U epsilon, typename TTypes<T, 4>::Tensor y) {
+    const int64 depth = x.dimension(3);
+    const int64 rest_size = x.size() / depth;
+
+    Eigen::Tensor<U, 1, Eigen::RowMajor> scaling_factor(depth);
+    Eigen::Tensor<U, 1, Eigen::RowMajor> shifted_offset(depth);
+    for (int64 c = 0; c < depth; ++c) {
+      const U factor =
+          scale(c) / Eigen::numext::sqrt(estimated_variance(c) + epsilon);
+      scaling_factor(c) = factor;
+      shifted_offset(c) = offset(c) - estimated_mean(c) * factor;
+    }
+
+    const T* x_data = x.data();
+    const U* factor_data = scaling_factor.data();
+    const U* offset_data = shifted_offset.data();
+    T* y_data = y.data();
+
+    auto shard = [x_data, factor_data, offset_data, y_data, depth](
+                     int64 start, int64 limit) {
+      typedef typename Eigen::internal::packet_traits<T>::type Packet;
+      static const int64 kPacketSize =
+          Eigen::internal::packet_traits<T>::size;
+      for (int64 r = start; r < limit; ++r) {
+        const T* x_row = x_data + r * depth;
+        T* y_row = y_data + r * depth;
+        int64 c = 0;
+        for (; c + kPacketSize <= depth; c += kPacketSize) {
+          const Packet vx = Eigen::internal::ploadu<Packet>(x_row + c);
+          const Packet vf = Eigen::internal::ploadu<Packet>(factor_data + c);
+          const Packet vo = Eigen::internal::ploadu<Packet>(offset_data + c);
+          Eigen::internal::pstoreu<T>(y_row + c,
+                                      Eigen::internal::pmadd(vx, vf, vo));
+        }
+        for (; c < depth; ++c) {
+          y_row[c] = x_row[c] * factor_data[c] + offset_data[c];
+        }
+      }
+    };
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, rest_size,
+          depth, shard);
+    return true;
+  }
+};
+
 template <typename T, typename U>
 struct FusedBatchNorm<CPUDevice, T, U> {
   void operator()(OpKernelContext* context, const Tensor& x_input,
@@ -87,6 +164,18 @@ struct FusedBatchNorm<CPUDevice, T, U> {
     typename TTypes<U>::Vec saved_mean(saved_mean_output->vec<U>());
     typename TTypes<U>::Vec saved_var(saved_var_output->vec<U>());
 
+    // In inference mode the output only depends on the estimated statistics,
+    // so apply the folded per-channel multiply-add directly and skip the
+    // Eigen expressions below (which broadcast per element).
+    if (!is_training &&
+        FusedBatchNormFrozenInference<std::is_same<T, U>::value, T,
+                                      U>::process(context, x, scale, offset,
+                                                  estimated_mean,
+                                                  estimated_variance, epsilon,
+                                                  y)) {
+      return;
+    }
+
     const CPUDevice& d = context->eigen_device<CPUDevice>();
 
     const int depth = x.dimension(3);
@@ -38,6 +38,8 @@ enum class FusedComputationType {
   kBiasAdd,
   kBiasAddWithRelu,
   kBiasAddWithRelu6,
+  kBiasAddWithTanh,
+  kBiasAddWithSigmoid,
   kBiasAddWithElu,
   kFusedBatchNorm,
   kFusedBatchNormWithRelu,
@@ -96,6 +98,22 @@ struct Relu6 {
   };
 };
 
+// Applies `Tanh` to the passed input expression.
+struct Tanh {
+  template <typename XprType>
+  static auto apply(XprType expr) -> decltype(expr.tanh()) {
+    return expr.tanh();
+  };
+};
+
+// Applies `Sigmoid` to the passed input expression.
+struct Sigmoid {
+  template <typename XprType>
+  static auto apply(XprType expr) -> decltype(expr.sigmoid()) {
+    return expr.sigmoid();
+  };
+};
+
 // Applies `Elu` to the passed input expression.
 struct Elu {
   template <typename XprType>
@@ -119,6 +137,8 @@ struct BiasAddArgs {
     return fusion == FusedComputationType::kBiasAdd ||
            fusion == FusedComputationType::kBiasAddWithRelu ||
            fusion == FusedComputationType::kBiasAddWithRelu6 ||
+           fusion == FusedComputationType::kBiasAddWithTanh ||
+           fusion == FusedComputationType::kBiasAddWithSigmoid ||
            fusion == FusedComputationType::kBiasAddWithElu;
   }
 };
@@ -256,6 +276,10 @@ using WithBiasAddAndRelu = BiasAddOutputKernel<T, Relu>;
 template <typename T>
 using WithBiasAddAndRelu6 = BiasAddOutputKernel<T, Relu6>;
 template <typename T>
+using WithBiasAddAndTanh = BiasAddOutputKernel<T, Tanh>;
+template <typename T>
+using WithBiasAddAndSigmoid = BiasAddOutputKernel<T, Sigmoid>;
+template <typename T>
 using WithBiasAddAndElu = BiasAddOutputKernel<T, Elu>;
 template <typename T>
 using WithFusedBatchNorm = FusedBatchNormOutputKernel<T>;
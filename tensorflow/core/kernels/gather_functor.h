@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/platform/prefetch.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
@@ -33,6 +34,25 @@ typedef Eigen::GpuDevice GPUDevice;
 
 namespace functor {
 
+// Number of indices the gather copy loop prefetches ahead of the copy
+// position. When the params tensor is much larger than the cache (e.g. big
+// embedding tables) every row lookup is a miss, and the short memcpy per row
+// cannot hide it; issuing the loads several rows early overlaps the misses
+// with copying. Overridable with the TF_GATHER_PREFETCH_DISTANCE environment
+// variable for tuning.
+inline int64 GatherPrefetchDistance() {
+  static const int64 distance = [] {
+    int64 d;
+    Status status = ReadInt64FromEnvVar("TF_GATHER_PREFETCH_DISTANCE",
+                                        /*default_val=*/8, &d);
+    if (!status.ok()) {
+      LOG(ERROR) << status.error_message();
+    }
+    return d < 1 ? 1 : d;
+  }();
+  return distance;
+}
+
 // Helper method to copy using memcpy.
 template <typename T, typename Index, typename SliceIndex,
           SliceIndex static_slice_elems>
@@ -57,25 +77,43 @@ SliceIndex HandleCopies(OpKernelContext* ctx,
   // Store the value of invalidate index for printing error information, it's a
   // shared variable.
   SliceIndex result = -1;
+  const SliceIndex prefetch_distance =
+      static_cast<SliceIndex>(GatherPrefetchDistance());
   auto work = [&](int64 start, int64 end) {
     SliceIndex batch_idx = static_cast<SliceIndex>(start / indices_size);
     SliceIndex indices_idx = static_cast<SliceIndex>(start % indices_size);
     SliceIndex batch_idx_end = static_cast<SliceIndex>(end / indices_size);
     SliceIndex indices_idx_end = static_cast<SliceIndex>(end % indices_size);
 
+    // Issues prefetches for the params row selected by position 'i' of the
+    // current batch, touching each cache line of the row, along with the
+    // corresponding output slot.
+    auto prefetch_position = [&](SliceIndex batch, SliceIndex i) {
+      const char* row =
+          reinterpret_cast<const char*>(&params(batch, indices(i), 0));
+      for (size_t offset = 0; offset < slice_bytes; offset += 64) {
+        port::prefetch<port::PREFETCH_HINT_T0>(row + offset);
+      }
+      port::prefetch<port::PREFETCH_HINT_T0>(&out(batch, i, 0));
+    };
+
     while ((batch_idx < batch_idx_end) ||
            (batch_idx == batch_idx_end && indices_idx < indices_idx_end)) {
       SliceIndex i_next = indices_idx + 1;
       SliceIndex b_next = batch_idx + 1;
       if ((batch_idx == batch_idx_end && i_next < indices_idx_end) ||
           (i_next < indices_size)) {
-        port::prefetch<port::PREFETCH_HINT_T0>(
-            &params(batch_idx, indices(i_next), 0));
-        port::prefetch<port::PREFETCH_HINT_T0>(&out(batch_idx, i_next, 0));
+        // Prefetch 'prefetch_distance' positions ahead of the copy, clamped
+        // to this shard's portion of the batch; near the end of a segment
+        // this re-prefetches the last row, which is harmless.
+        const SliceIndex segment_end =
+            (batch_idx == batch_idx_end) ? indices_idx_end : indices_size;
+        const SliceIndex i_ahead =
+            std::min(indices_idx + prefetch_distance, segment_end - 1);
+        prefetch_position(batch_idx, i_ahead);
         b_next = batch_idx;
       } else if (b_next <= batch_idx_end) {
-        port::prefetch<port::PREFETCH_HINT_T0>(&params(b_next, indices(0), 0));
-        port::prefetch<port::PREFETCH_HINT_T0>(&out(b_next, 0, 0));
+        prefetch_position(b_next, 0);
         i_next = 0;
       }
       const Index index = internal::SubtleMustCopy(indices(indices_idx));
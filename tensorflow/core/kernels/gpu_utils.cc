@@ -17,7 +17,12 @@ limitations under the License.
 
 #if GOOGLE_CUDA
 
+#include <cstdlib>
+
 #include "google/protobuf/any.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logger.h"
 #include "tensorflow/core/protobuf/autotuning.pb.h"
 #include "tensorflow/core/protobuf/conv_autotuning.pb.h"
@@ -145,6 +150,189 @@ Status BestCudnnConvAlgorithm(absl::Span<const AutotuneResult> results,
   return Status::OK();
 }
 
+// Persistence of autotune results.
+//
+// The cache file is line oriented; each line holds one accepted entry as
+//   <map name> '\t' <parameters key> '\t' <serialized config>
+// None of the three fields contains a tab (parameter keys and configs are
+// comma/semicolon separated), so the format needs no escaping.
+
+string AutoTuneConfigCodec<se::dnn::AlgorithmConfig>::Serialize(
+    const se::dnn::AlgorithmConfig& config) {
+  string serialized;
+  if (config.algorithm().has_value()) {
+    strings::StrAppend(&serialized, config.algorithm()->algo_id(), ",",
+                       config.algorithm()->tensor_ops_enabled() ? 1 : 0);
+  } else {
+    strings::StrAppend(&serialized, "none");
+  }
+  strings::StrAppend(&serialized, ";");
+  if (config.algorithm_no_scratch().has_value()) {
+    strings::StrAppend(&serialized, config.algorithm_no_scratch()->algo_id(),
+                       ",",
+                       config.algorithm_no_scratch()->tensor_ops_enabled()
+                           ? 1
+                           : 0);
+  } else {
+    strings::StrAppend(&serialized, "none");
+  }
+  return serialized;
+}
+
+namespace {
+
+// Parses one side of the dnn config format: either "none" or
+// "<algo_id>,<tensor_ops_enabled>".
+bool ParseAlgorithmDesc(const string& serialized, bool* has_desc,
+                        se::dnn::AlgorithmDesc* desc) {
+  *has_desc = false;
+  if (serialized == "none") return true;
+  std::vector<string> fields = str_util::Split(serialized, ',');
+  int64 algo_id;
+  int32 tensor_ops;
+  if (fields.size() != 2 || !strings::safe_strto64(fields[0], &algo_id) ||
+      !strings::safe_strto32(fields[1], &tensor_ops)) {
+    return false;
+  }
+  *has_desc = true;
+  *desc = se::dnn::AlgorithmDesc(algo_id, tensor_ops != 0);
+  return true;
+}
+
+}  // namespace
+
+bool AutoTuneConfigCodec<se::dnn::AlgorithmConfig>::Deserialize(
+    const string& serialized, se::dnn::AlgorithmConfig* config) {
+  std::vector<string> sides = str_util::Split(serialized, ';');
+  bool has_desc;
+  se::dnn::AlgorithmDesc desc;
+  *config = se::dnn::AlgorithmConfig();
+  if (sides.size() != 2) return false;
+  if (!ParseAlgorithmDesc(sides[0], &has_desc, &desc)) return false;
+  if (has_desc) config->set_algorithm(desc);
+  if (!ParseAlgorithmDesc(sides[1], &has_desc, &desc)) return false;
+  if (has_desc) config->set_algorithm_no_scratch(desc);
+  return true;
+}
+
+string AutoTuneConfigCodec<se::blas::AlgorithmConfig>::Serialize(
+    const se::blas::AlgorithmConfig& config) {
+  return strings::StrCat(config.algorithm());
+}
+
+bool AutoTuneConfigCodec<se::blas::AlgorithmConfig>::Deserialize(
+    const string& serialized, se::blas::AlgorithmConfig* config) {
+  int64 algorithm;
+  if (!strings::safe_strto64(serialized, &algorithm)) return false;
+  *config = se::blas::AlgorithmConfig(algorithm);
+  return true;
+}
+
+namespace internal {
+
+struct AutoTuneCacheEntry {
+  string map_name;
+  string params_key;
+  string config;
+};
+
+struct PersistentAutoTuneMapRegistry {
+  struct Map {
+    string name;
+    std::function<std::vector<std::pair<string, string>>()> exporter;
+    std::function<void(const string&, const string&)> importer;
+  };
+
+  mutex mu;
+  std::vector<Map> maps GUARDED_BY(mu);
+  // Entries loaded from cache files, retained for maps that register later.
+  std::vector<AutoTuneCacheEntry> entries GUARDED_BY(mu);
+  bool env_cache_loaded GUARDED_BY(mu) = false;
+};
+
+PersistentAutoTuneMapRegistry* GetRegistry() {
+  static PersistentAutoTuneMapRegistry* registry =
+      new PersistentAutoTuneMapRegistry;
+  return registry;
+}
+
+Status ParseAutoTuneCacheFile(Env* env, const string& path,
+                              std::vector<AutoTuneCacheEntry>* entries) {
+  string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, path, &contents));
+  for (const string& line : str_util::Split(contents, '\n')) {
+    if (line.empty()) continue;
+    std::vector<string> fields = str_util::Split(line, '\t');
+    if (fields.size() != 3) {
+      return errors::InvalidArgument("Malformed autotune cache line in ", path,
+                                     ": ", line);
+    }
+    entries->push_back(AutoTuneCacheEntry{fields[0], fields[1], fields[2]});
+  }
+  return Status::OK();
+}
+
+void RegisterPersistentAutoTuneMap(
+    const string& name,
+    std::function<std::vector<std::pair<string, string>>()> exporter,
+    std::function<void(const string& params_key, const string& config)>
+        importer) {
+  PersistentAutoTuneMapRegistry* registry = GetRegistry();
+  mutex_lock lock(registry->mu);
+  if (!registry->env_cache_loaded) {
+    registry->env_cache_loaded = true;
+    const char* path = getenv("TF_AUTOTUNE_CACHE_PATH");
+    if (path != nullptr && path[0] != '\0') {
+      Status s =
+          ParseAutoTuneCacheFile(Env::Default(), path, &registry->entries);
+      if (!s.ok()) {
+        LOG(WARNING) << "Ignoring autotune cache file " << path << ": " << s;
+      }
+    }
+  }
+  for (const AutoTuneCacheEntry& entry : registry->entries) {
+    if (entry.map_name == name) {
+      importer(entry.params_key, entry.config);
+    }
+  }
+  registry->maps.push_back(
+      PersistentAutoTuneMapRegistry::Map{name, std::move(exporter),
+                                         std::move(importer)});
+}
+
+}  // namespace internal
+
+Status SaveAutoTuneMaps(Env* env, const string& path) {
+  internal::PersistentAutoTuneMapRegistry* registry = internal::GetRegistry();
+  string contents;
+  {
+    mutex_lock lock(registry->mu);
+    for (const auto& map : registry->maps) {
+      for (const auto& entry : map.exporter()) {
+        strings::StrAppend(&contents, map.name, "\t", entry.first, "\t",
+                           entry.second, "\n");
+      }
+    }
+  }
+  return WriteStringToFile(env, path, contents);
+}
+
+Status LoadAutoTuneMaps(Env* env, const string& path) {
+  std::vector<internal::AutoTuneCacheEntry> entries;
+  TF_RETURN_IF_ERROR(internal::ParseAutoTuneCacheFile(env, path, &entries));
+  internal::PersistentAutoTuneMapRegistry* registry = internal::GetRegistry();
+  mutex_lock lock(registry->mu);
+  for (const auto& entry : entries) {
+    for (const auto& map : registry->maps) {
+      if (map.name == entry.map_name) {
+        map.importer(entry.params_key, entry.config);
+      }
+    }
+    registry->entries.push_back(entry);
+  }
+  return Status::OK();
+}
+
 }  // namespace tensorflow
 
 #endif  // GOOGLE_CUDA
@@ -18,7 +18,11 @@ limitations under the License.
 
 #if GOOGLE_CUDA
 
+#include <functional>
+#include <map>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "absl/types/span.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -31,6 +35,7 @@ limitations under the License.
 
 namespace tensorflow {
 
+class Env;
 class NodeDef;
 class AutotuneResult;
 
@@ -54,9 +59,24 @@ inline se::DeviceMemory<T> AsDeviceMemory(const T* cuda_memory, uint64 size) {
 template <typename Parameters, typename Config>
 class AutoTuneMap {
  public:
-  bool Find(const Parameters& params, Config* config) const {
+  bool Find(const Parameters& params, Config* config) {
     mutex_lock lock(mu_);
     auto iter = params_config_map_.find(params);
+    if (iter == params_config_map_.end() && !imported_configs_.empty()) {
+      // Falls back to configs imported from a previous process's autotune
+      // cache.  An imported entry was accepted before, so it is accepted
+      // outright here and a warm restart does not re-autotune shapes it has
+      // already tuned.
+      auto imported = imported_configs_.find(params.ToString());
+      if (imported != imported_configs_.end()) {
+        VLOG(1) << GetActionSummary("imports", params, imported->second);
+        iter = params_config_map_
+                   .insert(std::make_pair(
+                       params,
+                       ValueType{imported->second, min_score_threshold_, 1}))
+                   .first;
+      }
+    }
     if (iter == params_config_map_.end() ||
         (iter->second.score < min_score_threshold_ &&
          iter->second.count <= max_autotune_count_)) {
@@ -99,6 +119,33 @@ class AutoTuneMap {
     }
   }
 
+  // Seeds the map with an entry exported by a previous process, keyed by
+  // Parameters::ToString().  Imported entries satisfy Find() directly, so a
+  // warm restart does not pay for re-autotuning.
+  void ImportEntry(const string& params_key, const Config& config) {
+    mutex_lock lock(mu_);
+    imported_configs_[params_key] = config;
+  }
+
+  // Returns the entries whose config has been accepted -- plus any imported
+  // entries that have not been re-observed -- keyed by
+  // Parameters::ToString(), in a stable order.
+  std::vector<std::pair<string, Config>> ExportAcceptedEntries() const {
+    mutex_lock lock(mu_);
+    std::map<string, Config> accepted(imported_configs_.begin(),
+                                      imported_configs_.end());
+    for (const auto& p : params_config_map_) {
+      if (p.second.score >= min_score_threshold_ ||
+          p.second.count > max_autotune_count_) {
+        accepted[p.first.ToString()] = p.second.config;
+      }
+    }
+    return std::vector<std::pair<string, Config>>(accepted.begin(),
+                                                  accepted.end());
+  }
+
+  const string& name() const { return name_; }
+
  private:
   AutoTuneMap(const string& name) : name_(name) {
     min_score_threshold_ = 1;
@@ -141,6 +188,9 @@ class AutoTuneMap {
   };
   std::unordered_map<Parameters, ValueType, Hasher> params_config_map_
       GUARDED_BY(mu_);
+  // Configs imported from a previous process's autotune cache, keyed by
+  // Parameters::ToString().  Consulted by Find() when the live map misses.
+  std::unordered_map<string, Config> imported_configs_ GUARDED_BY(mu_);
   string name_;
   int32 min_score_threshold_;
   int32 max_autotune_count_;
@@ -148,6 +198,85 @@ class AutoTuneMap {
   TF_DISALLOW_COPY_AND_ASSIGN(AutoTuneMap);
 };
 
+// Codec used to persist autotune configs across process restarts.
+// Specialized for the config types that can round-trip through a string;
+// autotune maps with other config types keep working but are not persisted.
+template <typename Config>
+struct AutoTuneConfigCodec {
+  static bool Supported() { return false; }
+  static string Serialize(const Config& config) { return ""; }
+  static bool Deserialize(const string& serialized, Config* config) {
+    return false;
+  }
+};
+
+template <>
+struct AutoTuneConfigCodec<se::dnn::AlgorithmConfig> {
+  static bool Supported() { return true; }
+  static string Serialize(const se::dnn::AlgorithmConfig& config);
+  static bool Deserialize(const string& serialized,
+                          se::dnn::AlgorithmConfig* config);
+};
+
+template <>
+struct AutoTuneConfigCodec<se::blas::AlgorithmConfig> {
+  static bool Supported() { return true; }
+  static string Serialize(const se::blas::AlgorithmConfig& config);
+  static bool Deserialize(const string& serialized,
+                          se::blas::AlgorithmConfig* config);
+};
+
+namespace internal {
+
+// Registers a live autotune map with the persistence registry.  "exporter"
+// returns the map's accepted entries as (parameters key, serialized config)
+// pairs; "importer" seeds the map with one such pair.  Entries already
+// loaded for "name" -- from the file named by the TF_AUTOTUNE_CACHE_PATH
+// environment variable or an earlier LoadAutoTuneMaps() call -- are
+// delivered to the importer immediately.
+void RegisterPersistentAutoTuneMap(
+    const string& name,
+    std::function<std::vector<std::pair<string, string>>()> exporter,
+    std::function<void(const string& params_key, const string& config)>
+        importer);
+
+// Registers "map" for persistence iff its config type has a codec.
+template <typename Parameters, typename Config>
+void MaybeRegisterPersistentAutoTuneMap(AutoTuneMap<Parameters, Config>* map) {
+  if (!AutoTuneConfigCodec<Config>::Supported()) return;
+  RegisterPersistentAutoTuneMap(
+      map->name(),
+      [map] {
+        std::vector<std::pair<string, string>> entries;
+        for (const auto& entry : map->ExportAcceptedEntries()) {
+          entries.emplace_back(
+              entry.first,
+              AutoTuneConfigCodec<Config>::Serialize(entry.second));
+        }
+        return entries;
+      },
+      [map](const string& params_key, const string& serialized) {
+        Config config;
+        if (AutoTuneConfigCodec<Config>::Deserialize(serialized, &config)) {
+          map->ImportEntry(params_key, config);
+        }
+      });
+}
+
+}  // namespace internal
+
+// Writes the accepted entries of every registered autotune map to an
+// autotune cache file at "path".  Serving binaries call this once warmup
+// traffic has settled the autotune scores; a process restarted with
+// TF_AUTOTUNE_CACHE_PATH naming the file then skips re-autotuning the
+// recorded shapes.
+Status SaveAutoTuneMaps(Env* env, const string& path);
+
+// Seeds the registered autotune maps from an autotune cache file written by
+// SaveAutoTuneMaps().  Entries for maps that are not live yet are retained
+// and delivered when the map registers.
+Status LoadAutoTuneMaps(Env* env, const string& path);
+
 // A Singleton helper that manages the global autotune results by groups.
 // The caller specified arbitrary Group type that can distinguish between
 // different autotune results, even if their Parameters and Configs are the
@@ -157,7 +286,11 @@ class AutoTuneSingleton {
  public:
   typedef AutoTuneMap<Parameters, Config> AutoTuneType;
   static AutoTuneType* GetInstance() {
-    static AutoTuneType* instance = new AutoTuneType(Group::name());
+    static AutoTuneType* instance = [] {
+      AutoTuneType* autotune_map = new AutoTuneType(Group::name());
+      internal::MaybeRegisterPersistentAutoTuneMap(autotune_map);
+      return autotune_map;
+    }();
     return instance;
   }
 };
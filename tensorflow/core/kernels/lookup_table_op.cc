@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
 
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -26,10 +27,32 @@ limitations under the License.
 #include "tensorflow/core/kernels/initializable_lookup_table.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace lookup {
 
+// Serving workloads against mutable hash tables are almost entirely Find
+// calls, which still contend on the table mutex as readers and can be
+// stalled by mutations. When this is enabled, every mutation publishes an
+// immutable snapshot of the table and Find runs against the snapshot
+// without holding the table mutex, so concurrent lookups proceed
+// independently and are never blocked by writers. Mutations copy the whole
+// table before publishing, so this mode is only worthwhile for tables that
+// are read-mostly (e.g. serving), which is why it is off by default.
+inline bool SnapshotReadsEnabled() {
+  static const bool enabled = [] {
+    bool b = false;
+    Status status = ReadBoolFromEnvVar("TF_MUTABLE_HASH_TABLE_SNAPSHOT_READS",
+                                       /*default_val=*/false, &b);
+    if (!status.ok()) {
+      LOG(ERROR) << status.error_message();
+    }
+    return b;
+  }();
+  return enabled;
+}
+
 // Lookup table that wraps an unordered_map, where the key and value data type
 // is specified. Each individual value must be a scalar. If vector values are
 // required, use MutableHashTableOfTensors.
@@ -47,7 +70,12 @@ namespace lookup {
 template <class K, class V>
 class MutableHashTableOfScalars final : public LookupInterface {
  public:
-  MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
+  MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel)
+      : snapshot_reads_(SnapshotReadsEnabled()) {
+    if (snapshot_reads_) {
+      snapshot_ = std::make_shared<const Table>();
+    }
+  }
 
   size_t size() const override {
     tf_shared_lock l(mu_);
@@ -60,6 +88,21 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = key.flat<K>();
     auto value_values = value->flat<V>();
 
+    if (snapshot_reads_) {
+      // Grab the current snapshot — the lock is held only for the pointer
+      // copy — and run the lookups against it without any locking.
+      std::shared_ptr<const Table> snapshot;
+      {
+        tf_shared_lock l(mu_);
+        snapshot = snapshot_;
+      }
+      for (int64 i = 0; i < key_values.size(); ++i) {
+        value_values(i) = gtl::FindWithDefault(
+            *snapshot, SubtleMustCopyIfIntegral(key_values(i)), default_val);
+      }
+      return Status::OK();
+    }
+
     tf_shared_lock l(mu_);
     for (int64 i = 0; i < key_values.size(); ++i) {
       value_values(i) = gtl::FindWithDefault(
@@ -81,6 +124,9 @@ class MutableHashTableOfScalars final : public LookupInterface {
       gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
                           SubtleMustCopyIfIntegral(value_values(i)));
     }
+    if (snapshot_reads_) {
+      snapshot_ = std::make_shared<const Table>(table_);
+    }
     return Status::OK();
   }
 
@@ -96,6 +142,9 @@ class MutableHashTableOfScalars final : public LookupInterface {
     for (int64 i = 0; i < key_values.size(); ++i) {
       table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
     }
+    if (snapshot_reads_) {
+      snapshot_ = std::make_shared<const Table>(table_);
+    }
     return Status::OK();
   }
 
@@ -148,8 +197,13 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
  private:
+  typedef std::unordered_map<K, V> Table;
+  const bool snapshot_reads_;
   mutable mutex mu_;
-  std::unordered_map<K, V> table_ GUARDED_BY(mu_);
+  Table table_ GUARDED_BY(mu_);
+  // Immutable copy of 'table_' republished by each mutation; only used (and
+  // only non-null) when 'snapshot_reads_' is set.
+  std::shared_ptr<const Table> snapshot_ GUARDED_BY(mu_);
 };
 
 // Lookup table that wraps an unordered_map. Behaves identical to
@@ -157,13 +211,17 @@ class MutableHashTableOfScalars final : public LookupInterface {
 template <class K, class V>
 class MutableHashTableOfTensors final : public LookupInterface {
  public:
-  MutableHashTableOfTensors(OpKernelContext* ctx, OpKernel* kernel) {
+  MutableHashTableOfTensors(OpKernelContext* ctx, OpKernel* kernel)
+      : snapshot_reads_(SnapshotReadsEnabled()) {
     OP_REQUIRES_OK(ctx,
                    GetNodeAttr(kernel->def(), "value_shape", &value_shape_));
     OP_REQUIRES(
         ctx, TensorShapeUtils::IsVector(value_shape_),
         errors::InvalidArgument("Default value must be a vector, got shape ",
                                 value_shape_.DebugString()));
+    if (snapshot_reads_) {
+      snapshot_ = std::make_shared<const Table>();
+    }
   }
 
   size_t size() const override {
@@ -178,6 +236,30 @@ class MutableHashTableOfTensors final : public LookupInterface {
     auto value_values = value->flat_inner_dims<V, 2>();
     int64 value_dim = value_shape_.dim_size(0);
 
+    if (snapshot_reads_) {
+      // Grab the current snapshot — the lock is held only for the pointer
+      // copy — and run the lookups against it without any locking.
+      std::shared_ptr<const Table> snapshot;
+      {
+        tf_shared_lock l(mu_);
+        snapshot = snapshot_;
+      }
+      for (int64 i = 0; i < key_values.size(); ++i) {
+        const ValueArray* value_vec = gtl::FindOrNull(
+            *snapshot, SubtleMustCopyIfIntegral(key_values(i)));
+        if (value_vec != nullptr) {
+          for (int64 j = 0; j < value_dim; j++) {
+            value_values(i, j) = value_vec->at(j);
+          }
+        } else {
+          for (int64 j = 0; j < value_dim; j++) {
+            value_values(i, j) = default_flat(j);
+          }
+        }
+      }
+      return Status::OK();
+    }
+
     tf_shared_lock l(mu_);
     for (int64 i = 0; i < key_values.size(); ++i) {
       ValueArray* value_vec =
@@ -214,6 +296,9 @@ class MutableHashTableOfTensors final : public LookupInterface {
       gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
                           value_vec);
     }
+    if (snapshot_reads_) {
+      snapshot_ = std::make_shared<const Table>(table_);
+    }
     return Status::OK();
   }
 
@@ -229,6 +314,9 @@ class MutableHashTableOfTensors final : public LookupInterface {
     for (int64 i = 0; i < key_values.size(); ++i) {
       table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
     }
+    if (snapshot_reads_) {
+      snapshot_ = std::make_shared<const Table>(table_);
+    }
     return Status::OK();
   }
 
@@ -286,10 +374,15 @@ class MutableHashTableOfTensors final : public LookupInterface {
   }
 
  private:
+  typedef gtl::InlinedVector<V, 4> ValueArray;
+  typedef std::unordered_map<K, ValueArray> Table;
   TensorShape value_shape_;
+  const bool snapshot_reads_;
   mutable mutex mu_;
-  typedef gtl::InlinedVector<V, 4> ValueArray;
-  std::unordered_map<K, ValueArray> table_ GUARDED_BY(mu_);
+  Table table_ GUARDED_BY(mu_);
+  // Immutable copy of 'table_' republished by each mutation; only used (and
+  // only non-null) when 'snapshot_reads_' is set.
+  std::shared_ptr<const Table> snapshot_ GUARDED_BY(mu_);
 };
 
 namespace {
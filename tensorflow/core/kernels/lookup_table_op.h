@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_LOOKUP_TABLE_OP_H_
 #define TENSORFLOW_CORE_KERNELS_LOOKUP_TABLE_OP_H_
 
+#include <type_traits>
+
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/lookup_interface.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -146,8 +149,10 @@ inline const Variant& SubtleMustCopyIfIntegral(const Variant& value) {
   return value;
 }
 
-// Lookup table that wraps an unordered_map, where the key and value data type
-// is specified.
+// Lookup table that wraps an absl::flat_hash_map, where the key and value data
+// type is specified.  The flat (open-addressed) layout keeps each probe within
+// one or two cache lines and compares a group of control bytes per step, which
+// matters for the large read-mostly vocabulary tables this class backs.
 //
 // This table is recommended for any variations to key values.
 //
@@ -214,15 +219,21 @@ class HashTable : public InitializableLookupTable {
       return errors::Aborted("HashTable already initialized.");
     }
     if (!table_) {
-      table_ = std::unique_ptr<std::unordered_map<K, V>>(
-          new std::unordered_map<K, V>());
+      table_ = std::unique_ptr<absl::flat_hash_map<K, V>>(
+          new absl::flat_hash_map<K, V>());
     }
     return Status::OK();
   };
 
-  Status DoLazyPrepare(std::function<int64(void)> unused) override {
+  Status DoLazyPrepare(std::function<int64(void)> size_fn) override {
     constexpr size_t kUnusedSize = 0;
-    return DoPrepare(kUnusedSize);
+    TF_RETURN_IF_ERROR(DoPrepare(kUnusedSize));
+    // Reserve up front so initialization does not rehash as it inserts.
+    const int64 expected_size = size_fn();
+    if (expected_size > 0) {
+      table_->reserve(expected_size);
+    }
+    return Status::OK();
   }
 
   Status DoInsert(const Tensor& keys, const Tensor& values) override {
@@ -250,8 +261,26 @@ class HashTable : public InitializableLookupTable {
     const V default_val = default_value.flat<V>()(0);
     const auto key_values = key.flat<K>();
     auto value_values = value->flat<V>();
+    const int64 num_keys = key_values.size();
+
+    // For cheaply hashable keys, software-pipeline the probes: issue the
+    // prefetch for a key several iterations ahead so its control and slot
+    // cache lines are in flight while earlier keys resolve.  Skipped for
+    // string keys, where prefetch would hash each key a second time.
+    static constexpr int64 kPrefetchDistance = 16;
+    if (std::is_fundamental<K>::value && num_keys > kPrefetchDistance) {
+      for (int64 i = 0; i < num_keys; ++i) {
+        if (i + kPrefetchDistance < num_keys) {
+          table_->prefetch(
+              SubtleMustCopyIfIntegral(key_values(i + kPrefetchDistance)));
+        }
+        value_values(i) = gtl::FindWithDefault(
+            *table_, SubtleMustCopyIfIntegral(key_values(i)), default_val);
+      }
+      return Status::OK();
+    }
 
-    for (int64 i = 0; i < key_values.size(); ++i) {
+    for (int64 i = 0; i < num_keys; ++i) {
       value_values(i) = gtl::FindWithDefault(
           *table_, SubtleMustCopyIfIntegral(key_values(i)), default_val);
     }
@@ -268,7 +297,7 @@ class HashTable : public InitializableLookupTable {
   }
 
  private:
-  std::unique_ptr<std::unordered_map<K, V>> table_;
+  std::unique_ptr<absl::flat_hash_map<K, V>> table_;
 };
 
 }  // namespace lookup
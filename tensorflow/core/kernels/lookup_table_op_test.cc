@@ -0,0 +1,77 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/lookup_table_op.h"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/initializable_lookup_table.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+// Benchmarks int64->int64 HashTable lookups, the vocabulary-remapping
+// pattern: a read-only table initialized once and then probed with large
+// batches of keys.  Only even keys are inserted, so roughly half the
+// uniformly drawn queries miss and take the default value.
+static void BM_HashTableInt64Find(int iters, int table_size, int num_keys) {
+  testing::StopTiming();
+  Tensor keys(DT_INT64, TensorShape({table_size}));
+  Tensor values(DT_INT64, TensorShape({table_size}));
+  auto keys_flat = keys.flat<int64>();
+  auto values_flat = values.flat<int64>();
+  for (int64 i = 0; i < table_size; ++i) {
+    keys_flat(i) = i * 2;
+    values_flat(i) = i;
+  }
+
+  auto* table = new lookup::HashTable<int64, int64>(nullptr, nullptr);
+  core::ScopedUnref unref_table(table);
+  lookup::KeyValueTensorIterator iter(&keys, &values);
+  TF_CHECK_OK(table->Initialize(iter));
+
+  random::PhiloxRandom philox(301, 17);
+  random::SimplePhilox rnd(&philox);
+  Tensor queries(DT_INT64, TensorShape({num_keys}));
+  auto queries_flat = queries.flat<int64>();
+  for (int64 i = 0; i < num_keys; ++i) {
+    queries_flat(i) = rnd.Uniform64(static_cast<uint64>(table_size) * 2);
+  }
+  Tensor default_value(DT_INT64, TensorShape({}));
+  default_value.scalar<int64>()() = -1;
+  Tensor out(DT_INT64, TensorShape({num_keys}));
+
+  testing::ItemsProcessed(static_cast<int64>(iters) * num_keys);
+  testing::StartTiming();
+  while (iters-- > 0) {
+    TF_CHECK_OK(table->Find(nullptr /* ctx */, queries, &out, default_value));
+  }
+}
+
+// Table sizes spanning L2-resident through far larger than last-level cache.
+BENCHMARK(BM_HashTableInt64Find)
+    ->ArgPair(1 << 10, 1 << 16)
+    ->ArgPair(1 << 16, 1 << 16)
+    ->ArgPair(1 << 20, 1 << 16)
+    ->ArgPair(1 << 24, 1 << 16);
+
+}  // namespace
+}  // namespace tensorflow
@@ -23,6 +23,8 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/matmul_autotune.h"
 #if GOOGLE_CUDA
 #include "cuda/include/cuda.h"
@@ -42,6 +44,28 @@ template <typename Device, typename T, bool USE_CUBLAS>
 struct LaunchMatMul;
 
 namespace {
+
+// Returns true if CPU MatMul kernels may cache a transposed copy of a
+// transposed weight operand across invocations. Eigen's contraction packs a
+// transposed operand with strided reads on every step; caching the transposed
+// copy in kernel state lets repeated executions run the cheaper non-transposed
+// path. The cache is keyed by the operand's buffer address and shape, so it is
+// only safe when the operand's contents never change in place (e.g. Const
+// weights in frozen inference graphs); variables that are assigned in place
+// would be read stale. Hence this is opt-in.
+bool TransposedWeightCacheEnabled() {
+  static bool result = [] {
+    bool value;
+    Status s = ReadBoolFromEnvVar("TF_MATMUL_CACHE_TRANSPOSED_WEIGHTS", false,
+                                  &value);
+    if (!s.ok()) {
+      LOG(ERROR) << s.error_message();
+    }
+    return value;
+  }();
+  return result;
+}
+
 // Converts a TensorFlow Tensor to an Eigen Matrix.
 template <typename T>
 Eigen::Map<
@@ -109,6 +133,65 @@ bool ExplicitVectorMatrixOptimization<Eigen::half>(
   return false;
 }
 
+// Execution strategies for CPU matmuls. The strategy for a given set of
+// dimensions is resolved once per kernel instance and then invoked directly
+// on subsequent steps, skipping the per-step checks (see
+// MatMulOp::RunCpuDispatch).
+enum class MatMulDispatch : uint8 {
+  kUnresolved,
+  // One operand is a vector; use ExplicitVectorMatrixOptimization.
+  kVectorMatrix,
+  // Small product; run inline on the calling thread with plain Eigen.
+  kSequential,
+  // Everything else; use the threaded Eigen Tensor contraction.
+  kThreaded,
+};
+
+// Upper bound on m * k * n below which the contraction is executed inline on
+// the calling thread with plain Eigen. For products this small the fixed cost
+// of evaluating the Eigen Tensor contraction expression and dispatching it to
+// the thread pool dominates the arithmetic.
+static const int64 kSequentialMatMulMaxSize = 64 * 64 * 64;
+
+// Computes out = op(a) * op(b) with plain Eigen on the calling thread, where
+// op is determined by dim_pair. Returns false for types where this is not
+// profitable so the caller falls back to the threaded contraction.
+template <typename T>
+bool SequentialMatMul(
+    const Tensor& a, const Tensor& b,
+    const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+    Tensor* out) {
+  auto a_m = ToEigenMatrix<T>(a);
+  auto b_m = ToEigenMatrix<T>(b);
+  auto out_m =
+      Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>::Map(
+          out->matrix<T>().data(), out->dim_size(0), out->dim_size(1));
+  const bool transpose_a = dim_pair[0].first == 0;
+  const bool transpose_b = dim_pair[0].second == 1;
+  if (transpose_a) {
+    if (transpose_b) {
+      out_m.noalias() = a_m.transpose() * b_m.transpose();
+    } else {
+      out_m.noalias() = a_m.transpose() * b_m;
+    }
+  } else {
+    if (transpose_b) {
+      out_m.noalias() = a_m * b_m.transpose();
+    } else {
+      out_m.noalias() = a_m * b_m;
+    }
+  }
+  return true;
+}
+// Half is not supported.
+template <>
+bool SequentialMatMul<Eigen::half>(
+    const Tensor& a, const Tensor& b,
+    const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+    Tensor* out) {
+  return false;
+}
+
 template <typename Device, typename T>
 struct LaunchMatMulBase {
 #if GOOGLE_CUDA
@@ -514,17 +597,128 @@ class MatMulOp : public OpKernel {
       FloatToBFloat16(out_float.flat<float>().data(),
                       out->flat<bfloat16>().data(), out->NumElements());
     } else {
+      if (!USE_CUBLAS && std::is_same<Device, CPUDevice>::value &&
+          RunCpuDispatch(a, b, dim_pair, out)) {
+        return;
+      }
+      if (!USE_CUBLAS && transpose_b_ && TransposedWeightCacheEnabled()) {
+        Tensor b_transposed;
+        if (MaybeUseTransposedWeight(ctx, b, &b_transposed,
+                                     std::is_same<Device, CPUDevice>())) {
+          dim_pair[0].second = 0;
+          LaunchMatMul<Device, T, USE_CUBLAS>::launch(
+              ctx, a, b_transposed, dim_pair, &algorithms_, use_autotune_,
+              out);
+          return;
+        }
+      }
       LaunchMatMul<Device, T, USE_CUBLAS>::launch(
           ctx, a, b, dim_pair, &algorithms_, use_autotune_, out);
     }
   }
 
  private:
+  // Returns a cached transposed copy of the weight operand `b`, creating it on
+  // the first invocation. The cache is invalidated when `b`'s buffer address
+  // or shape changes; callers must only enable this for operands whose
+  // contents are immutable (see TransposedWeightCacheEnabled()). Only
+  // implemented for the CPU device; the std::false_type overload below keeps
+  // other device instantiations on the regular path.
+  bool MaybeUseTransposedWeight(OpKernelContext* ctx, const Tensor& b,
+                                Tensor* b_transposed,
+                                std::true_type /* is_cpu */) {
+    const void* data = b.tensor_data().data();
+    const TensorShape transposed_shape({b.dim_size(1), b.dim_size(0)});
+    mutex_lock l(weight_cache_mu_);
+    if (transposed_weight_src_ != data ||
+        transposed_weight_.AccessTensor(ctx)->shape() != transposed_shape) {
+      Tensor* transposed = nullptr;
+      if (!ctx->allocate_persistent(b.dtype(), transposed_shape,
+                                    &transposed_weight_, &transposed)
+               .ok()) {
+        return false;
+      }
+      Eigen::array<int, 2> perm({1, 0});
+      transposed->matrix<T>().device(ctx->eigen_device<CPUDevice>()) =
+          b.matrix<T>().shuffle(perm);
+      transposed_weight_src_ = data;
+    }
+    *b_transposed = *transposed_weight_.AccessTensor(ctx);
+    return true;
+  }
+  bool MaybeUseTransposedWeight(OpKernelContext* ctx, const Tensor& b,
+                                Tensor* b_transposed,
+                                std::false_type /* is_cpu */) {
+    return false;
+  }
+
+  // Resolves which CPU execution strategy to use for a product with the
+  // given dimensions (m x k times k x n).
+  static MatMulDispatch ResolveCpuDispatch(
+      const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+      int64 m, int64 k, int64 n) {
+    if (std::is_same<T, Eigen::half>::value) {
+      return MatMulDispatch::kThreaded;
+    }
+    // Mirrors the applicability conditions of
+    // ExplicitVectorMatrixOptimization; the (m == 1, contraction over a's
+    // dim 0) case is already well optimized by Eigen Tensors.
+    if ((m == 1 && dim_pair[0].second != 0) || n == 1) {
+      return MatMulDispatch::kVectorMatrix;
+    }
+    if (m * k * n <= kSequentialMatMulMaxSize) {
+      return MatMulDispatch::kSequential;
+    }
+    return MatMulDispatch::kThreaded;
+  }
+
+  // Runs the dispatch plan cached for the current dimensions, resolving it
+  // on the first execution (or when the shapes change). Returns false if the
+  // plan is the default threaded contraction, which the caller launches as
+  // usual.
+  bool RunCpuDispatch(
+      const Tensor& a, const Tensor& b,
+      const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+      Tensor* out) {
+    const int64 m = out->dim_size(0);
+    const int64 n = out->dim_size(1);
+    const int64 k = a.dim_size(dim_pair[0].first);
+    MatMulDispatch plan;
+    {
+      mutex_lock l(dispatch_mu_);
+      if (m != dispatch_m_ || k != dispatch_k_ || n != dispatch_n_) {
+        cached_dispatch_ = ResolveCpuDispatch(dim_pair, m, k, n);
+        dispatch_m_ = m;
+        dispatch_k_ = k;
+        dispatch_n_ = n;
+      }
+      plan = cached_dispatch_;
+    }
+    switch (plan) {
+      case MatMulDispatch::kVectorMatrix:
+        return ExplicitVectorMatrixOptimization<T>(a, b, dim_pair, out);
+      case MatMulDispatch::kSequential:
+        return SequentialMatMul<T>(a, b, dim_pair, out);
+      default:
+        return false;
+    }
+  }
+
   std::vector<int64> algorithms_;
   bool algorithms_set_already_;
   bool use_autotune_;
   bool transpose_a_;
   bool transpose_b_;
+  mutex weight_cache_mu_;
+  PersistentTensor transposed_weight_ GUARDED_BY(weight_cache_mu_);
+  const void* transposed_weight_src_ GUARDED_BY(weight_cache_mu_) = nullptr;
+  // Per-instance CPU dispatch cache (see RunCpuDispatch).
+  mutex dispatch_mu_;
+  MatMulDispatch cached_dispatch_ GUARDED_BY(dispatch_mu_) =
+      MatMulDispatch::kUnresolved;
+  int64 dispatch_m_ GUARDED_BY(dispatch_mu_) = -1;
+  int64 dispatch_k_ GUARDED_BY(dispatch_mu_) = -1;
+  int64 dispatch_n_ GUARDED_BY(dispatch_mu_) = -1;
 };
 
 namespace functor {
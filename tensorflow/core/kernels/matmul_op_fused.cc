@@ -88,6 +88,14 @@ struct LaunchFusedMatMulOp<CPUDevice, T> {
         out.device(d) =
             lhs.contract(rhs, dim_pair, WithBiasAddAndRelu6<T>(bias_add_args));
         break;
+      case FusedComputationType::kBiasAddWithTanh:
+        out.device(d) =
+            lhs.contract(rhs, dim_pair, WithBiasAddAndTanh<T>(bias_add_args));
+        break;
+      case FusedComputationType::kBiasAddWithSigmoid:
+        out.device(d) = lhs.contract(rhs, dim_pair,
+                                     WithBiasAddAndSigmoid<T>(bias_add_args));
+        break;
       case FusedComputationType::kBiasAddWithElu:
         out.device(d) =
             lhs.contract(rhs, dim_pair, WithBiasAddAndElu<T>(bias_add_args));
@@ -116,6 +124,8 @@ class FusedMatMulOp : public OpKernel {
       patterns = {{FCT::kBiasAdd, {"BiasAdd"}},
                   {FCT::kBiasAddWithRelu, {"BiasAdd", "Relu"}},
                   {FCT::kBiasAddWithRelu6, {"BiasAdd", "Relu6"}},
+                  {FCT::kBiasAddWithTanh, {"BiasAdd", "Tanh"}},
+                  {FCT::kBiasAddWithSigmoid, {"BiasAdd", "Sigmoid"}},
                   {FCT::kBiasAddWithElu, {"BiasAdd", "Elu"}}};
     }
 
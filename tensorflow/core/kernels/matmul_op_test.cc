@@ -16,7 +16,10 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/platform/test.h"
@@ -135,6 +138,10 @@ class FusedMatMulOpTest : public OpsTestBase {
       ops::Relu6(root.WithOpName("with_activation"), with_bias);
     } else if (activation_type == "Elu") {
       ops::Elu(root.WithOpName("with_activation"), with_bias);
+    } else if (activation_type == "Tanh") {
+      ops::Tanh(root.WithOpName("with_activation"), with_bias);
+    } else if (activation_type == "Sigmoid") {
+      ops::Sigmoid(root.WithOpName("with_activation"), with_bias);
     } else {
       ops::Identity(root.WithOpName("with_activation"), with_bias);
     }
@@ -289,7 +296,8 @@ TYPED_TEST_P(FusedMatMulWithBiasOpTest, MatMul1x256x1) {
 }
 
 TYPED_TEST_P(FusedMatMulWithBiasOpTest, MatMul256x256x256WithActivation) {
-  for (const string& activation : {"Relu", "Relu6", "Elu"}) {
+  for (const string& activation :
+       {"Relu", "Relu6", "Elu", "Tanh", "Sigmoid"}) {
     this->VerifyConv2DWithBiasAndActivation(256, 256, 256, false, false,
                                             activation);
     this->VerifyConv2DWithBiasAndActivation(256, 256, 256, true, false,
@@ -302,21 +310,24 @@ TYPED_TEST_P(FusedMatMulWithBiasOpTest, MatMul256x256x256WithActivation) {
 }
 
 TYPED_TEST_P(FusedMatMulWithBiasOpTest, MatMul1x256x256WithActivation) {
-  for (const string& activation : {"Relu", "Relu6", "Elu"}) {
+  for (const string& activation :
+       {"Relu", "Relu6", "Elu", "Tanh", "Sigmoid"}) {
     this->VerifyConv2DWithBiasAndActivation(1, 256, 256, false, false,
                                             activation);
   }
 }
 
 TYPED_TEST_P(FusedMatMulWithBiasOpTest, MatMul256x256x1WithActivation) {
-  for (const string& activation : {"Relu", "Relu6", "Elu"}) {
+  for (const string& activation :
+       {"Relu", "Relu6", "Elu", "Tanh", "Sigmoid"}) {
     this->VerifyConv2DWithBiasAndActivation(256, 256, 1, false, false,
                                             activation);
   }
 }
 
 TYPED_TEST_P(FusedMatMulWithBiasOpTest, MatMul1x256x1WithActivation) {
-  for (const string& activation : {"Relu", "Relu6", "Elu"}) {
+  for (const string& activation :
+       {"Relu", "Relu6", "Elu", "Tanh", "Sigmoid"}) {
     this->VerifyConv2DWithBiasAndActivation(1, 256, 1, false, false,
                                             activation);
   }
@@ -337,6 +348,72 @@ using FusedBiasAddDataTypes = ::testing::Types<float>;
 INSTANTIATE_TYPED_TEST_SUITE_P(Test, FusedMatMulWithBiasOpTest,
                                FusedBiasAddDataTypes);
 
+class MatMulDispatchTest : public OpsTestBase {
+ protected:
+  // Runs a small MatMul twice on the same kernel instance, so the second
+  // execution takes the cached dispatch plan, and checks both results
+  // against a reference computed with simple loops.
+  void VerifySmallMatMul(int m, int k, int n, bool transpose_a,
+                         bool transpose_b) {
+    TF_ASSERT_OK(NodeDefBuilder("matmul", "MatMul")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_FLOAT))
+                     .Attr("transpose_a", transpose_a)
+                     .Attr("transpose_b", transpose_b)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+
+    std::vector<float> a_data(m * k);
+    std::vector<float> b_data(k * n);
+    for (int i = 0; i < m * k; ++i) a_data[i] = 0.25f * i - 1.0f;
+    for (int i = 0; i < k * n; ++i) b_data[i] = 3.0f - 0.5f * i;
+    AddInputFromArray<float>(
+        transpose_a ? TensorShape({k, m}) : TensorShape({m, k}), a_data);
+    AddInputFromArray<float>(
+        transpose_b ? TensorShape({n, k}) : TensorShape({k, n}), b_data);
+
+    auto a_at = [&](int i, int j) {
+      return transpose_a ? a_data[j * m + i] : a_data[i * k + j];
+    };
+    auto b_at = [&](int i, int j) {
+      return transpose_b ? b_data[j * k + i] : b_data[i * n + j];
+    };
+    Tensor expected(DT_FLOAT, TensorShape({m, n}));
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < n; ++j) {
+        float sum = 0.0f;
+        for (int l = 0; l < k; ++l) sum += a_at(i, l) * b_at(l, j);
+        expected.matrix<float>()(i, j) = sum;
+      }
+    }
+
+    for (int run = 0; run < 2; ++run) {
+      TF_ASSERT_OK(RunOpKernel());
+      test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-4);
+    }
+  }
+};
+
+TEST_F(MatMulDispatchTest, SmallNoTranspose) {
+  VerifySmallMatMul(3, 4, 5, false, false);
+}
+
+TEST_F(MatMulDispatchTest, SmallTransposeA) {
+  VerifySmallMatMul(3, 4, 5, true, false);
+}
+
+TEST_F(MatMulDispatchTest, SmallTransposeB) {
+  VerifySmallMatMul(3, 4, 5, false, true);
+}
+
+TEST_F(MatMulDispatchTest, SmallTransposeBoth) {
+  VerifySmallMatMul(3, 4, 5, true, true);
+}
+
+TEST_F(MatMulDispatchTest, MatrixVector) {
+  VerifySmallMatMul(3, 4, 1, false, false);
+}
+
 //----------------------------------------------------------------------------//
 // Performance benchmarks are below.                                          //
 //----------------------------------------------------------------------------//
@@ -1371,6 +1371,15 @@ BM_TopKCPU(128, 1000, 100, 16, "topk_r_128_c_1000_k_100_th_16");
 BM_TopKCPU(128, 1000, 500, 16, "topk_r_128_c_1000_k_500_th_16");
 BM_TopKCPU(128, 1000, 1000, 16, "topk_r_128_c_1000_k_1000_th_16");
 
+// Retrieval-style scoring: large k over very wide rows. The k=10 variants
+// stay on the heap-based selection path, the k=1000 variants exercise the
+// partition-based path.
+BM_TopKCPU(1, 1000000, 10, 16, "topk_r_1_c_1000000_k_10_th_16");
+BM_TopKCPU(1, 1000000, 1000, 16, "topk_r_1_c_1000000_k_1000_th_16");
+BM_TopKCPU(1, 10000000, 1000, 16, "topk_r_1_c_10000000_k_1000_th_16");
+BM_TopKCPU(8, 1000000, 10, 16, "topk_r_8_c_1000000_k_10_th_16");
+BM_TopKCPU(8, 1000000, 1000, 16, "topk_r_8_c_1000000_k_1000_th_16");
+
 // From NMT Codebase:
 //   batch_sizes: 16, 128
 //   vocab_sizes: 10000 for small dataset, 35000 for large.
@@ -0,0 +1,297 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Curated regression benchmark suite over the kernels that dominate
+// production workloads. Each benchmark family sweeps a small set of shapes
+// drawn from production shape distributions; the built-in defaults can be
+// replaced with TF_BENCHMARK_SHAPE_CORPUS=<file>, where each line is
+//
+//   <family>/<shape index> <dim> <dim> ...
+//
+// e.g. "MatMul/1 256 1024 4096". Record a baseline with
+// TF_BENCHMARK_BASELINE_OUT=<file> and compare later runs against it with
+// TF_BENCHMARK_BASELINE=<file>; the harness fails the run on statistically
+// significant throughput regressions (see platform/default/test_benchmark.cc).
+
+#include <map>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns the dims for one benchmark shape, either from the corpus file named
+// by TF_BENCHMARK_SHAPE_CORPUS or from the built-in defaults.
+std::vector<int64> CorpusShape(const string& family, int index,
+                               std::initializer_list<int64> default_dims) {
+  static const auto* overrides = []() {
+    auto* result = new std::map<string, std::vector<int64>>;
+    const char* path = getenv("TF_BENCHMARK_SHAPE_CORPUS");
+    if (path == nullptr || path[0] == '\0') return result;
+    string contents;
+    TF_CHECK_OK(ReadFileToString(Env::Default(), path, &contents));
+    for (const string& line : str_util::Split(contents, '\n')) {
+      std::vector<string> fields =
+          str_util::Split(line, ' ', str_util::SkipEmpty());
+      if (fields.empty() || str_util::StartsWith(fields[0], "#")) continue;
+      CHECK_GE(fields.size(), 2) << "Bad shape corpus line: " << line;
+      std::vector<int64> dims;
+      for (size_t i = 1; i < fields.size(); ++i) {
+        int64 dim;
+        CHECK(strings::safe_strto64(fields[i], &dim))
+            << "Bad shape corpus line: " << line;
+        dims.push_back(dim);
+      }
+      (*result)[fields[0]] = dims;
+    }
+    return result;
+  }();
+  auto it = overrides->find(strings::StrCat(family, "/", index));
+  if (it != overrides->end()) {
+    CHECK_EQ(it->second.size(), default_dims.size())
+        << "Shape corpus entry for " << family << "/" << index
+        << " has the wrong rank";
+    return it->second;
+  }
+  return std::vector<int64>(default_dims);
+}
+
+Tensor RandomFloats(gtl::ArraySlice<int64> dims) {
+  Tensor t(DT_FLOAT, TensorShape(dims));
+  t.flat<float>().setRandom();
+  return t;
+}
+
+// ----------------------------------------------------------------------------
+// Dense linear algebra.
+// ----------------------------------------------------------------------------
+
+void BM_MatMul(int iters, int shape) {
+  // {M, K, N}: small-batch training GEMM, large training GEMM, and a
+  // batch-1 inference GEMV-like multiply.
+  static const std::initializer_list<int64> kDefaults[] = {
+      {32, 512, 512}, {128, 1024, 1024}, {1, 2048, 4096}};
+  std::vector<int64> d = CorpusShape("MatMul", shape, kDefaults[shape]);
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[0] * d[1] * d[2] * 2);
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* a = test::graph::Constant(g, RandomFloats({d[0], d[1]}));
+  Node* b = test::graph::Constant(g, RandomFloats({d[1], d[2]}));
+  test::graph::Matmul(g, a, b, false, false);
+  test::Benchmark("cpu", g).Run(iters);
+}
+BENCHMARK(BM_MatMul)->Arg(0)->Arg(1)->Arg(2);
+
+void BM_BatchMatMul(int iters, int shape) {
+  // {B, M, K, N}: attention-style batched multiplies.
+  static const std::initializer_list<int64> kDefaults[] = {
+      {32, 128, 64, 128}, {8, 512, 64, 512}};
+  std::vector<int64> d = CorpusShape("BatchMatMul", shape, kDefaults[shape]);
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[0] * d[1] * d[2] *
+                          d[3] * 2);
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* a = test::graph::Constant(g, RandomFloats({d[0], d[1], d[2]}));
+  Node* b = test::graph::Constant(g, RandomFloats({d[0], d[2], d[3]}));
+  test::graph::BatchMatmul(g, a, b, false, false);
+  test::Benchmark("cpu", g).Run(iters);
+}
+BENCHMARK(BM_BatchMatMul)->Arg(0)->Arg(1);
+
+void BM_Conv2D(int iters, int shape) {
+  // {N, H, W, Cin, Cout, filter}: 3x3 convolutions from the early, middle
+  // and late stages of a ResNet-style image model.
+  static const std::initializer_list<int64> kDefaults[] = {
+      {8, 56, 56, 64, 64, 3}, {8, 28, 28, 128, 128, 3},
+      {8, 14, 14, 256, 256, 3}};
+  std::vector<int64> d = CorpusShape("Conv2D", shape, kDefaults[shape]);
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[0] * d[1] * d[2] *
+                          d[3] * d[4] * d[5] * d[5] * 2);
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* in = test::graph::Constant(g, RandomFloats({d[0], d[1], d[2], d[3]}));
+  Node* filter =
+      test::graph::Constant(g, RandomFloats({d[5], d[5], d[3], d[4]}));
+  test::graph::Conv2D(g, in, filter);
+  test::Benchmark("cpu", g).Run(iters);
+}
+BENCHMARK(BM_Conv2D)->Arg(0)->Arg(1)->Arg(2);
+
+// ----------------------------------------------------------------------------
+// Elementwise and activation kernels.
+// ----------------------------------------------------------------------------
+
+void BM_UnaryOp(Graph* g, const string& op, const std::vector<int64>& d,
+                int iters) {
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[0] * d[1]);
+  test::graph::Unary(g, op, test::graph::Constant(g, RandomFloats(d)));
+  test::Benchmark("cpu", g).Run(iters);
+}
+
+void BM_Relu(int iters, int shape) {
+  static const std::initializer_list<int64> kDefaults[] = {{64, 4096},
+                                                           {256, 65536}};
+  BM_UnaryOp(new Graph(OpRegistry::Global()), "Relu",
+             CorpusShape("Relu", shape, kDefaults[shape]), iters);
+}
+BENCHMARK(BM_Relu)->Arg(0)->Arg(1);
+
+void BM_Sigmoid(int iters, int shape) {
+  static const std::initializer_list<int64> kDefaults[] = {{64, 4096}};
+  BM_UnaryOp(new Graph(OpRegistry::Global()), "Sigmoid",
+             CorpusShape("Sigmoid", shape, kDefaults[shape]), iters);
+}
+BENCHMARK(BM_Sigmoid)->Arg(0);
+
+void BM_Tanh(int iters, int shape) {
+  static const std::initializer_list<int64> kDefaults[] = {{64, 4096}};
+  BM_UnaryOp(new Graph(OpRegistry::Global()), "Tanh",
+             CorpusShape("Tanh", shape, kDefaults[shape]), iters);
+}
+BENCHMARK(BM_Tanh)->Arg(0);
+
+void BM_Softmax(int iters, int shape) {
+  // {batch, classes}: image-model head and a large-vocabulary LM head.
+  static const std::initializer_list<int64> kDefaults[] = {{64, 1000},
+                                                           {32, 32768}};
+  BM_UnaryOp(new Graph(OpRegistry::Global()), "Softmax",
+             CorpusShape("Softmax", shape, kDefaults[shape]), iters);
+}
+BENCHMARK(BM_Softmax)->Arg(0)->Arg(1);
+
+void BM_BinaryOp(Graph* g, const string& op, const std::vector<int64>& d,
+                 int iters) {
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[0] * d[1]);
+  Node* a = test::graph::Constant(g, RandomFloats(d));
+  Node* b = test::graph::Constant(g, RandomFloats(d));
+  test::graph::Binary(g, op, a, b);
+  test::Benchmark("cpu", g).Run(iters);
+}
+
+void BM_Add(int iters, int shape) {
+  static const std::initializer_list<int64> kDefaults[] = {{64, 4096},
+                                                           {256, 65536}};
+  BM_BinaryOp(new Graph(OpRegistry::Global()), "Add",
+              CorpusShape("Add", shape, kDefaults[shape]), iters);
+}
+BENCHMARK(BM_Add)->Arg(0)->Arg(1);
+
+void BM_Mul(int iters, int shape) {
+  static const std::initializer_list<int64> kDefaults[] = {{64, 4096},
+                                                           {256, 65536}};
+  BM_BinaryOp(new Graph(OpRegistry::Global()), "Mul",
+              CorpusShape("Mul", shape, kDefaults[shape]), iters);
+}
+BENCHMARK(BM_Mul)->Arg(0)->Arg(1);
+
+void BM_BiasAdd(int iters, int shape) {
+  static const std::initializer_list<int64> kDefaults[] = {{64, 4096},
+                                                           {256, 65536}};
+  std::vector<int64> d = CorpusShape("BiasAdd", shape, kDefaults[shape]);
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[0] * d[1]);
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* value = test::graph::Constant(g, RandomFloats(d));
+  Node* bias = test::graph::Constant(g, RandomFloats({d[1]}));
+  test::graph::BiasAdd(g, value, bias);
+  test::Benchmark("cpu", g).Run(iters);
+}
+BENCHMARK(BM_BiasAdd)->Arg(0)->Arg(1);
+
+// ----------------------------------------------------------------------------
+// Reductions and data movement.
+// ----------------------------------------------------------------------------
+
+void BM_ReduceOp(const string& op, const std::vector<int64>& d, int iters) {
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[0] * d[1]);
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* data = test::graph::Constant(g, RandomFloats(d));
+  Tensor axes(DT_INT32, TensorShape({1}));
+  axes.flat<int32>()(0) = 1;
+  test::graph::Reduce(g, op, data, test::graph::Constant(g, axes));
+  test::Benchmark("cpu", g).Run(iters);
+}
+
+void BM_Sum(int iters, int shape) {
+  static const std::initializer_list<int64> kDefaults[] = {{64, 4096},
+                                                           {256, 65536}};
+  BM_ReduceOp("Sum", CorpusShape("Sum", shape, kDefaults[shape]), iters);
+}
+BENCHMARK(BM_Sum)->Arg(0)->Arg(1);
+
+void BM_Mean(int iters, int shape) {
+  static const std::initializer_list<int64> kDefaults[] = {{256, 65536}};
+  BM_ReduceOp("Mean", CorpusShape("Mean", shape, kDefaults[shape]), iters);
+}
+BENCHMARK(BM_Mean)->Arg(0);
+
+void BM_Cast(int iters, int shape) {
+  static const std::initializer_list<int64> kDefaults[] = {{64, 4096},
+                                                           {256, 65536}};
+  std::vector<int64> d = CorpusShape("Cast", shape, kDefaults[shape]);
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[0] * d[1]);
+  Graph* g = new Graph(OpRegistry::Global());
+  test::graph::Cast(g, test::graph::Constant(g, RandomFloats(d)), DT_HALF);
+  test::Benchmark("cpu", g).Run(iters);
+}
+BENCHMARK(BM_Cast)->Arg(0)->Arg(1);
+
+void BM_ConcatV2(int iters, int shape) {
+  // {N, D}: concatenation of four feature tensors along the last axis.
+  static const std::initializer_list<int64> kDefaults[] = {{64, 1024},
+                                                           {256, 16384}};
+  std::vector<int64> d = CorpusShape("ConcatV2", shape, kDefaults[shape]);
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[0] * d[1] * 4);
+  Graph* g = new Graph(OpRegistry::Global());
+  std::vector<Node*> tensors;
+  for (int i = 0; i < 4; ++i) {
+    tensors.push_back(test::graph::Constant(g, RandomFloats(d)));
+  }
+  Tensor axis(DT_INT32, TensorShape({}));
+  axis.scalar<int32>()() = 1;
+  test::graph::ConcatV2(g, tensors, test::graph::Constant(g, axis));
+  test::Benchmark("cpu", g).Run(iters);
+}
+BENCHMARK(BM_ConcatV2)->Arg(0)->Arg(1);
+
+void BM_GatherV2(int iters, int shape) {
+  // {vocab, width, lookups}: embedding lookups from small to large tables.
+  static const std::initializer_list<int64> kDefaults[] = {
+      {10000, 64, 512}, {100000, 128, 1024}, {1000000, 256, 4096}};
+  std::vector<int64> d = CorpusShape("GatherV2", shape, kDefaults[shape]);
+  testing::ItemsProcessed(static_cast<int64>(iters) * d[2] * d[1]);
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* params = test::graph::Constant(g, RandomFloats({d[0], d[1]}));
+  Tensor indices(DT_INT32, TensorShape({d[2]}));
+  for (int64 i = 0; i < d[2]; ++i) {
+    indices.flat<int32>()(i) = (i * 2654435761u) % d[0];
+  }
+  Tensor axis(DT_INT32, TensorShape({}));
+  axis.scalar<int32>()() = 0;
+  test::graph::Gather(g, params, test::graph::Constant(g, indices),
+                      test::graph::Constant(g, axis));
+  test::Benchmark("cpu", g).Run(iters);
+}
+BENCHMARK(BM_GatherV2)->Arg(0)->Arg(1)->Arg(2);
+
+}  // namespace
+}  // namespace tensorflow
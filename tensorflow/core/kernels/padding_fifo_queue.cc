@@ -99,6 +99,7 @@ void PaddingFIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
           num_elements, [callback]() { callback(Tuple()); }, ctx, cm, token,
           [callback, allow_small_batch,
            this](Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+            DrainStagedElementsLocked();
             int32 queue_size = queues_[0].size();
             if (closed_ && queue_size < attempt->elements_requested) {
               // If we don't have enough for a full dequeue, we have
@@ -119,6 +120,7 @@ void PaddingFIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
                     }
                     queues_[j].push_front(element);
                   }
+                  num_elements_.fetch_add(1, std::memory_order_relaxed);
                 }
               }
               if (allow_small_batch && !queues_[0].empty()) {
@@ -225,6 +227,7 @@ void PaddingFIFOQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
             }
             return result;
           });
+      ++num_dequeue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -70,6 +70,35 @@ void PriorityQueue::DequeueLocked(OpKernelContext* ctx, Tuple* tuple) {
 
 void PriorityQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
                                DoneCallback callback) {
+  // Fast path: if no enqueue attempts are waiting ahead of us and there is
+  // room, insert the element immediately without registering a cancellation
+  // callback or creating an attempt; the callback runs outside the lock.
+  // A non-scalar priority component falls through to the slow path, which
+  // reports the error.
+  {
+    bool enqueued = false;
+    bool flush_needed = false;
+    {
+      mutex_lock l(mu_);
+      if (!closed_ && enqueue_attempts_.empty() &&
+          queues_[0].size() < static_cast<size_t>(capacity_) &&
+          TensorShapeUtils::IsScalar(tuple[0].shape())) {
+        const int64 priority = tuple[0].scalar<int64>()();
+        for (int i = 0; i < num_components(); ++i) {
+          queues_[i].emplace(priority, PersistentTensor(tuple[i]));
+        }
+        enqueued = true;
+        // A waiting dequeue may now be able to make progress.
+        flush_needed = !dequeue_attempts_.empty();
+      }
+    }
+    if (enqueued) {
+      if (flush_needed) FlushUnlocked();
+      callback();
+      return;
+    }
+  }
+
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
@@ -103,6 +132,7 @@ void PriorityQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
               return kNoProgress;
             }
           });
+      ++num_enqueue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -184,6 +214,7 @@ void PriorityQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
             }
             return result;
           });
+      ++num_enqueue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -196,6 +227,31 @@ void PriorityQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
 
 void PriorityQueue::TryDequeue(OpKernelContext* ctx,
                                CallbackWithTuple callback) {
+  // Fast path: if no dequeue attempts are waiting ahead of us and an element
+  // is available, dequeue the top-priority element immediately without
+  // registering a cancellation callback or creating an attempt; the callback
+  // runs outside the lock.
+  {
+    bool dequeued = false;
+    bool flush_needed = false;
+    Tuple tuple;
+    {
+      mutex_lock l(mu_);
+      if (dequeue_attempts_.empty() && !queues_[0].empty()) {
+        DequeueLocked(ctx, &tuple);
+        dequeued = true;
+        // The dequeue freed capacity, so a waiting enqueue may be able to
+        // make progress.
+        flush_needed = !enqueue_attempts_.empty();
+      }
+    }
+    if (dequeued) {
+      if (flush_needed) FlushUnlocked();
+      callback(tuple);
+      return;
+    }
+  }
+
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
@@ -225,6 +281,7 @@ void PriorityQueue::TryDequeue(OpKernelContext* ctx,
               return kNoProgress;
             }
           });
+      ++num_dequeue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -375,6 +432,7 @@ void PriorityQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
             }
             return result;
           });
+      ++num_dequeue_attempts_;
     }
   }
   if (!already_cancelled) {
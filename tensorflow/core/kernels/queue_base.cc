@@ -56,7 +56,10 @@ QueueBase::QueueBase(int32 capacity, const DataTypeVector& component_dtypes,
       component_dtypes_(component_dtypes),
       component_shapes_(component_shapes),
       name_(name),
-      closed_(false) {}
+      closed_(false),
+      closed_nolock_(false),
+      num_enqueue_attempts_(0),
+      num_dequeue_attempts_(0) {}
 
 QueueBase::~QueueBase() {}
 
@@ -222,6 +225,7 @@ void QueueBase::CloseAndCancel() {
   {
     mutex_lock lock(mu_);
     closed_ = true;
+    closed_nolock_.store(true, std::memory_order_release);
     for (Attempt& attempt : enqueue_attempts_) {
       if (!attempt.is_cancelled) {
         attempt.is_cancelled = true;
@@ -253,9 +257,11 @@ void QueueBase::Close(OpKernelContext* ctx, bool cancel_pending_enqueues,
                   errors::Cancelled("Queue '", name_, "' is already closed."));
             } else {
               closed_ = true;
+              closed_nolock_.store(true, std::memory_order_release);
             }
             return kComplete;
           });
+      ++num_enqueue_attempts_;
     }
     FlushUnlocked();
   }
@@ -265,6 +271,8 @@ bool QueueBase::TryAttemptLocked(Action action,
                                  std::vector<CleanUp>* clean_up) {
   std::deque<Attempt>* attempts =
       action == kEnqueue ? &enqueue_attempts_ : &dequeue_attempts_;
+  std::atomic<int64>* num_attempts =
+      action == kEnqueue ? &num_enqueue_attempts_ : &num_dequeue_attempts_;
 
   bool progress = false;
   bool done = false;
@@ -288,6 +296,7 @@ bool QueueBase::TryAttemptLocked(Action action,
         }
       }
       attempts->pop_front();
+      --(*num_attempts);
     } else {
       Attempt* cur_attempt = &attempts->front();
       switch (cur_attempt->run_callback(cur_attempt)) {
@@ -304,6 +313,7 @@ bool QueueBase::TryAttemptLocked(Action action,
                                  cur_attempt->cancellation_token,
                                  cur_attempt->context->cancellation_manager());
           attempts->pop_front();
+          --(*num_attempts);
           break;
       }
     }
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_QUEUE_BASE_H_
 #define TENSORFLOW_CORE_KERNELS_QUEUE_BASE_H_
 
+#include <atomic>
 #include <deque>
 #include <vector>
 
@@ -153,6 +154,16 @@ class QueueBase : public QueueInterface {
   mutable mutex mu_;
   bool closed_ GUARDED_BY(mu_);
 
+  // Lock-free mirrors of state guarded by mu_, for subclasses that implement
+  // fast paths without holding the lock (see FIFOQueue). closed_nolock_
+  // tracks closed_; the attempt counters track the sizes of
+  // enqueue_attempts_ and dequeue_attempts_ and must be updated wherever an
+  // attempt is appended (in the subclasses) or popped (in TryAttemptLocked).
+  // All writes happen while holding mu_; reads may happen anywhere.
+  std::atomic<bool> closed_nolock_;
+  std::atomic<int64> num_enqueue_attempts_;
+  std::atomic<int64> num_dequeue_attempts_;
+
   struct Attempt;
   typedef std::function<RunResult(Attempt*)> RunCallback;
   struct Attempt {
@@ -14,11 +14,13 @@ limitations under the License.
 ==============================================================================*/
 
 #include <random>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/math/math_util.h"
 #include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/lib/random/philox_random_simd.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 
@@ -117,6 +119,28 @@ void BM_PhiloxRandom(int iters) {
 }
 BENCHMARK(BM_PhiloxRandom);
 
+void BM_PhiloxRandomBlocks(int iters) {
+  // Fill 2M random numbers with the batched (SIMD where available) generator.
+  int count = 2 << 20;
+
+  testing::ItemsProcessed(static_cast<int64>(iters) * count);
+
+  random::PhiloxRandom gen(0x12345);
+
+  std::vector<uint32> buffer(count);
+  uint32 val = 1;
+  for (int i = 0; i < iters; ++i) {
+    random::FillPhiloxRandomBlocks(&gen, &buffer[0], count / 4);
+
+    // use the result trivially so the compiler does not optimize it away
+    val ^= buffer[0] ^ buffer[count - 1];
+  }
+
+  // A anchor point to make sure the compiler does not cut corners
+  CHECK(val) << val;
+}
+BENCHMARK(BM_PhiloxRandomBlocks);
+
 void BM_StdMTRandom(int iters) {
   // Fill 2M random numbers
   int count = 2 << 20;
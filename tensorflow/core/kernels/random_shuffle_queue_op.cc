@@ -151,6 +151,7 @@ void RandomShuffleQueue::TryEnqueue(const Tuple& tuple, OpKernelContext* ctx,
               return kNoProgress;
             }
           });
+      ++num_enqueue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -219,6 +220,7 @@ void RandomShuffleQueue::TryEnqueueMany(const Tuple& tuple,
             }
             return result;
           });
+      ++num_enqueue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -261,6 +263,7 @@ void RandomShuffleQueue::TryDequeue(OpKernelContext* ctx,
               return kNoProgress;
             }
           });
+      ++num_dequeue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -423,6 +426,7 @@ void RandomShuffleQueue::TryDequeueMany(int num_elements, OpKernelContext* ctx,
             }
             return result;
           });
+      ++num_dequeue_attempts_;
     }
   }
   if (!already_cancelled) {
@@ -26,6 +26,9 @@ limitations under the License.
 #include "third_party/eigen3/Eigen/Core"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
+#include <algorithm>
+#include <vector>
+
 #include "tensorflow/core/framework/numeric_op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -36,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -269,6 +273,165 @@ struct ReduceFunctorBase {
 template <typename Reducer>
 struct ReduceFunctor<CPUDevice, Reducer>
     : ReduceFunctorBase<CPUDevice, Reducer> {};
+
+#if defined(EIGEN_HAS_INDEX_LIST)
+
+// Large float Sum/Mean reductions bypass Eigen's generic reducers below:
+// a single serial accumulator cannot cover the floating point add latency,
+// which leaves inner-dimension reductions of big tensors far below memory
+// bandwidth.
+
+// Sums `data[0, n)` with 32 independent scalar accumulators, which the
+// compiler turns into several independent SIMD accumulators on vector
+// targets. The accumulators are combined pairwise in a fixed order, so the
+// result depends only on the input.
+inline float MultiAccumulatorSum(const float* data, int64 n) {
+  constexpr int kNumAccumulators = 32;
+  float acc[kNumAccumulators] = {0.0f};
+  int64 i = 0;
+  for (; i + kNumAccumulators <= n; i += kNumAccumulators) {
+    for (int j = 0; j < kNumAccumulators; ++j) {
+      acc[j] += data[i + j];
+    }
+  }
+  float tail = 0.0f;
+  for (; i < n; ++i) {
+    tail += data[i];
+  }
+  for (int width = kNumAccumulators / 2; width > 0; width /= 2) {
+    for (int j = 0; j < width; ++j) {
+      acc[j] += acc[j + width];
+    }
+  }
+  return acc[0] + tail;
+}
+
+// Below this size the sharding and combine overhead is not worth paying and
+// the Eigen reducers are left in place.
+constexpr int64 kLargeReductionMinSize = 1 << 16;
+// Elements per partial-reduction block; 1MB of floats, sized to stay within
+// a core's L2 while a shard streams through it.
+constexpr int64 kReductionBlockSize = 1 << 18;
+
+// Fully reduces `data[0, n)` by sharding fixed-size blocks over the worker
+// threads and combining the per-block partial sums pairwise in block order.
+// The block layout and both combine steps are independent of the number of
+// threads, so the result is deterministic for a given input.
+inline float ShardedDeterministicSum(OpKernelContext* ctx, const float* data,
+                                     int64 n) {
+  const int64 num_blocks =
+      (n + kReductionBlockSize - 1) / kReductionBlockSize;
+  std::vector<float> partials(num_blocks);
+  auto worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+        kReductionBlockSize, [data, n, &partials](int64 start, int64 limit) {
+          for (int64 b = start; b < limit; ++b) {
+            const int64 begin = b * kReductionBlockSize;
+            const int64 end = std::min(n, begin + kReductionBlockSize);
+            partials[b] = MultiAccumulatorSum(data + begin, end - begin);
+          }
+        });
+  int64 m = num_blocks;
+  while (m > 1) {
+    int64 next_m = 0;
+    for (int64 j = 0; j + 1 < m; j += 2) {
+      partials[next_m++] = partials[j] + partials[j + 1];
+    }
+    if (m % 2 == 1) {
+      partials[next_m++] = partials[m - 1];
+    }
+    m = next_m;
+  }
+  return partials[0];
+}
+
+// Reduces each row of `in` independently, sharding rows over the worker
+// threads. Each output element is written by exactly one shard, so the
+// result does not depend on the thread count.
+template <typename Combine>
+void ShardedRowSum(OpKernelContext* ctx, TTypes<float, 2>::ConstTensor in,
+                   TTypes<float, 1>::Tensor out, Combine combine) {
+  const int64 rows = in.dimension(0);
+  const int64 cols = in.dimension(1);
+  const float* data = in.data();
+  float* out_data = out.data();
+  auto worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads->num_threads, worker_threads->workers, rows, cols,
+        [data, out_data, cols, combine](int64 start, int64 limit) {
+          for (int64 r = start; r < limit; ++r) {
+            out_data[r] = combine(MultiAccumulatorSum(data + r * cols, cols));
+          }
+        });
+}
+
+template <>
+struct ReduceFunctor<CPUDevice, Eigen::internal::SumReducer<float>>
+    : ReduceFunctorBase<CPUDevice, Eigen::internal::SumReducer<float>> {
+  typedef Eigen::internal::SumReducer<float> Reducer;
+  typedef ReduceFunctorBase<CPUDevice, Reducer> Base;
+  using Base::Reduce;
+
+  // Full reduction of a large vector.
+  static void Reduce(OpKernelContext* ctx, TTypes<float, 0>::Tensor out,
+                     TTypes<float, 1>::ConstTensor in,
+                     const Eigen::IndexList<Eigen::type2index<0>>& axes,
+                     const Reducer& reducer) {
+    if (in.size() < kLargeReductionMinSize) {
+      Base::Reduce(ctx, out, in, axes, reducer);
+      return;
+    }
+    out() = ShardedDeterministicSum(ctx, in.data(), in.size());
+  }
+
+  // Reduction of a large matrix along its inner dimension.
+  static void Reduce(OpKernelContext* ctx, TTypes<float, 1>::Tensor out,
+                     TTypes<float, 2>::ConstTensor in,
+                     const Eigen::IndexList<Eigen::type2index<1>>& axes,
+                     const Reducer& reducer) {
+    if (in.size() < kLargeReductionMinSize) {
+      Base::Reduce(ctx, out, in, axes, reducer);
+      return;
+    }
+    ShardedRowSum(ctx, in, out, [](float sum) { return sum; });
+  }
+};
+
+template <>
+struct ReduceFunctor<CPUDevice, functor::MeanReducer<float>>
+    : ReduceFunctorBase<CPUDevice, functor::MeanReducer<float>> {
+  typedef functor::MeanReducer<float> Reducer;
+  typedef ReduceFunctorBase<CPUDevice, Reducer> Base;
+  using Base::Reduce;
+
+  // Full reduction of a large vector.
+  static void Reduce(OpKernelContext* ctx, TTypes<float, 0>::Tensor out,
+                     TTypes<float, 1>::ConstTensor in,
+                     const Eigen::IndexList<Eigen::type2index<0>>& axes,
+                     const Reducer& reducer) {
+    if (in.size() < kLargeReductionMinSize) {
+      Base::Reduce(ctx, out, in, axes, reducer);
+      return;
+    }
+    out() = ShardedDeterministicSum(ctx, in.data(), in.size()) /
+            static_cast<float>(in.size());
+  }
+
+  // Reduction of a large matrix along its inner dimension.
+  static void Reduce(OpKernelContext* ctx, TTypes<float, 1>::Tensor out,
+                     TTypes<float, 2>::ConstTensor in,
+                     const Eigen::IndexList<Eigen::type2index<1>>& axes,
+                     const Reducer& reducer) {
+    if (in.size() < kLargeReductionMinSize) {
+      Base::Reduce(ctx, out, in, axes, reducer);
+      return;
+    }
+    const float denom = static_cast<float>(in.dimension(1));
+    ShardedRowSum(ctx, in, out, [denom](float sum) { return sum / denom; });
+  }
+};
+
+#endif  // EIGEN_HAS_INDEX_LIST
+
 #if TENSORFLOW_USE_SYCL
 template <typename Reducer>
 struct ReduceFunctor<SYCLDevice, Reducer>
@@ -58,23 +58,18 @@ class ResizeBilinearOp : public OpKernel {
 
     functor::ResizeBilinear<Device, T>()(
         context->eigen_device<Device>(), image_data, st.height_scale,
-        st.width_scale, half_pixel_centers_, output_data);
+        st.width_scale, half_pixel_centers_, output_data, &weights_cache_);
   }
 
  private:
   bool align_corners_;
   bool half_pixel_centers_;
+  functor::ResizeBilinearWeightsCache weights_cache_;
 };
 
 namespace {
 // Compute the interpolation indices only once.
-struct CachedInterpolation {
-  int64 lower;  // Lower source index used in the interpolation
-  int64 upper;  // Upper source index used in the interpolation
-  // 1-D linear iterpolation scale (see:
-  // https://en.wikipedia.org/wiki/Bilinear_interpolation)
-  float lerp;
-};
+using CachedInterpolation = functor::ResizeBilinearWeights::Interpolation;
 
 template <typename Scaler>
 inline void compute_interpolation_weights(const Scaler scaler,
@@ -183,17 +178,22 @@ void resize_image(typename TTypes<T, 4>::ConstTensor images,
         const T* ys_input_upper_ptr = input_b_ptr + ys[y].upper * in_row_size;
         const float ys_lerp = ys[y].lerp;
         for (int64 x = 0; x < out_width; ++x) {
-          auto xs_lower = xs[x].lower;
-          auto xs_upper = xs[x].upper;
-          auto xs_lerp = xs[x].lerp;
+          // The four interpolation corners are each contiguous over the
+          // channel dimension, which lets the compiler vectorize the inner
+          // loop.
+          const T* top_left_ptr = ys_input_lower_ptr + xs[x].lower;
+          const T* top_right_ptr = ys_input_lower_ptr + xs[x].upper;
+          const T* bottom_left_ptr = ys_input_upper_ptr + xs[x].lower;
+          const T* bottom_right_ptr = ys_input_upper_ptr + xs[x].upper;
+          const float xs_lerp = xs[x].lerp;
+          float* output_x_ptr = output_y_ptr + x * channels;
           for (int c = 0; c < channels; ++c) {
-            const float top_left(ys_input_lower_ptr[xs_lower + c]);
-            const float top_right(ys_input_lower_ptr[xs_upper + c]);
-            const float bottom_left(ys_input_upper_ptr[xs_lower + c]);
-            const float bottom_right(ys_input_upper_ptr[xs_upper + c]);
-            output_y_ptr[x * channels + c] =
-                compute_lerp(top_left, top_right, bottom_left, bottom_right,
-                             xs_lerp, ys_lerp);
+            const float top_left(top_left_ptr[c]);
+            const float top_right(top_right_ptr[c]);
+            const float bottom_left(bottom_left_ptr[c]);
+            const float bottom_right(bottom_right_ptr[c]);
+            output_x_ptr[c] = compute_lerp(top_left, top_right, bottom_left,
+                                           bottom_right, xs_lerp, ys_lerp);
           }
         }
         output_y_ptr += out_row_size;
@@ -212,7 +212,8 @@ struct ResizeBilinear<CPUDevice, T> {
   void operator()(const CPUDevice& d, typename TTypes<T, 4>::ConstTensor images,
                   const float height_scale, const float width_scale,
                   bool half_pixel_centers,
-                  typename TTypes<float, 4>::Tensor output) {
+                  typename TTypes<float, 4>::Tensor output,
+                  ResizeBilinearWeightsCache* cache) {
     const int batch_size = images.dimension(0);
     const int64 in_height = images.dimension(1);
     const int64 in_width = images.dimension(2);
@@ -227,30 +228,44 @@ struct ResizeBilinear<CPUDevice, T> {
       return;
     }
 
-    std::vector<CachedInterpolation> ys(out_height + 1);
-    std::vector<CachedInterpolation> xs(out_width + 1);
-
-    if (half_pixel_centers) {
-      compute_interpolation_weights(HalfPixelScaler(), out_height, in_height,
-                                    height_scale, ys.data());
-      compute_interpolation_weights(HalfPixelScaler(), out_width, in_width,
-                                    width_scale, xs.data());
-
-    } else {
-      // Compute the cached interpolation weights on the x and y dimensions.
-      compute_interpolation_weights(LegacyScaler(), out_height, in_height,
-                                    height_scale, ys.data());
-      compute_interpolation_weights(LegacyScaler(), out_width, in_width,
-                                    width_scale, xs.data());
+    std::shared_ptr<const ResizeBilinearWeights> weights;
+    if (cache != nullptr) {
+      weights =
+          cache->Lookup(in_height, in_width, out_height, out_width, channels);
     }
-    // Scale x interpolation weights to avoid a multiplication during iteration.
-    for (int i = 0; i < xs.size(); ++i) {
-      xs[i].lower *= channels;
-      xs[i].upper *= channels;
+    if (weights == nullptr) {
+      auto computed = std::make_shared<ResizeBilinearWeights>();
+      computed->ys.resize(out_height + 1);
+      computed->xs.resize(out_width + 1);
+
+      if (half_pixel_centers) {
+        compute_interpolation_weights(HalfPixelScaler(), out_height, in_height,
+                                      height_scale, computed->ys.data());
+        compute_interpolation_weights(HalfPixelScaler(), out_width, in_width,
+                                      width_scale, computed->xs.data());
+
+      } else {
+        // Compute the cached interpolation weights on the x and y dimensions.
+        compute_interpolation_weights(LegacyScaler(), out_height, in_height,
+                                      height_scale, computed->ys.data());
+        compute_interpolation_weights(LegacyScaler(), out_width, in_width,
+                                      width_scale, computed->xs.data());
+      }
+      // Scale x interpolation weights to avoid a multiplication during
+      // iteration.
+      for (int i = 0; i < computed->xs.size(); ++i) {
+        computed->xs[i].lower *= channels;
+        computed->xs[i].upper *= channels;
+      }
+      if (cache != nullptr) {
+        cache->Insert(in_height, in_width, out_height, out_width, channels,
+                      computed);
+      }
+      weights = std::move(computed);
     }
 
     resize_image<T>(images, batch_size, in_height, in_width, out_height,
-                    out_width, channels, xs, ys, output);
+                    out_width, channels, weights->xs, weights->ys, output);
   }
 };
 }  // namespace functor
@@ -16,19 +16,85 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_RESIZE_BILINEAR_OP_H_
 #define TENSORFLOW_CORE_KERNELS_RESIZE_BILINEAR_OP_H_
 
+#include <memory>
+#include <vector>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/numeric_types.h"
 #include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
 namespace functor {
 
+// Per-axis interpolation tables for a bilinear resize, computed once for a
+// given resize geometry and shared across kernel invocations.
+struct ResizeBilinearWeights {
+  struct Interpolation {
+    int64 lower;  // Lower source index used in the interpolation
+    int64 upper;  // Upper source index used in the interpolation
+    // 1-D linear iterpolation scale (see:
+    // https://en.wikipedia.org/wiki/Bilinear_interpolation)
+    float lerp;
+  };
+  std::vector<Interpolation> ys;
+  // Indices in `xs` are pre-scaled by the number of channels.
+  std::vector<Interpolation> xs;
+};
+
+// Remembers the interpolation tables for the most recently seen resize
+// geometry. Pipelines that resize every image to the same target size hit
+// the cache on every invocation after the first. The scaler choice comes
+// from kernel attrs, which are fixed for the kernel's lifetime, so it is
+// not part of the key. Safe for concurrent Compute calls.
+class ResizeBilinearWeightsCache {
+ public:
+  // Returns the cached tables if the geometry matches, else nullptr.
+  std::shared_ptr<const ResizeBilinearWeights> Lookup(int64 in_height,
+                                                      int64 in_width,
+                                                      int64 out_height,
+                                                      int64 out_width,
+                                                      int64 channels) {
+    mutex_lock l(mu_);
+    if (in_height == in_height_ && in_width == in_width_ &&
+        out_height == out_height_ && out_width == out_width_ &&
+        channels == channels_) {
+      return weights_;
+    }
+    return nullptr;
+  }
+
+  void Insert(int64 in_height, int64 in_width, int64 out_height,
+              int64 out_width, int64 channels,
+              std::shared_ptr<const ResizeBilinearWeights> weights) {
+    mutex_lock l(mu_);
+    in_height_ = in_height;
+    in_width_ = in_width;
+    out_height_ = out_height;
+    out_width_ = out_width;
+    channels_ = channels;
+    weights_ = std::move(weights);
+  }
+
+ private:
+  mutex mu_;
+  int64 in_height_ GUARDED_BY(mu_) = -1;
+  int64 in_width_ GUARDED_BY(mu_) = -1;
+  int64 out_height_ GUARDED_BY(mu_) = -1;
+  int64 out_width_ GUARDED_BY(mu_) = -1;
+  int64 channels_ GUARDED_BY(mu_) = -1;
+  std::shared_ptr<const ResizeBilinearWeights> weights_ GUARDED_BY(mu_);
+};
+
 template <typename Device, typename T>
 struct ResizeBilinear {
+  // `cache` may be null; the GPU implementation ignores it.
   void operator()(const Device& d, typename TTypes<T, 4>::ConstTensor images,
                   const float height_scale, const float width_scale,
                   const bool half_pixel_centers,
-                  typename TTypes<float, 4>::Tensor resized_images);
+                  typename TTypes<float, 4>::Tensor resized_images,
+                  ResizeBilinearWeightsCache* cache);
 };
 
 template <typename Device, typename T>
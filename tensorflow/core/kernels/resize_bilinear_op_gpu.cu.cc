@@ -266,7 +266,10 @@ struct ResizeBilinear<GPUDevice, T> {
   void operator()(const GPUDevice& d, typename TTypes<T, 4>::ConstTensor images,
                   const float height_scale, const float width_scale,
                   const bool half_pixel_centers,
-                  typename TTypes<float, 4>::Tensor output) {
+                  typename TTypes<float, 4>::Tensor output,
+                  ResizeBilinearWeightsCache* cache) {
+    // The interpolation weights are computed inside the kernel launch, so
+    // `cache` is unused on GPU.
     const int batch = images.dimension(0);
     const int in_height = images.dimension(1);
     const int in_width = images.dimension(2);
@@ -186,6 +186,15 @@ TEST_F(ResizeBilinearOpTest, TestResizeRandomDataSeveralInputsSizes4Channels) {
   RunManyRandomTests(4);
 }
 
+TEST_F(ResizeBilinearOpTest, TestResizeReusesCachedWeights) {
+  // Run the same geometry twice on one kernel instance; the second run is
+  // served from the kernel's interpolation weights cache. Then change the
+  // input size to make sure the cache is keyed on the geometry.
+  TestResize(2, 4, 7, 3, 9, 5);
+  TestResize(2, 4, 7, 3, 9, 5);
+  TestResize(2, 8, 7, 3, 9, 5);
+}
+
 TEST_F(ResizeBilinearOpTest, TestBilinear2x2To1x1) {
   // Input:
   //  1, 2
@@ -68,13 +68,13 @@ class ResizeNearestNeighborOp : public OpKernel {
                                                 /*half_pixe_centers=*/true,
                                                 /*align_corners=*/true>()(
             context->eigen_device<Device>(), input_data, st.height_scale,
-            st.width_scale, output_data);
+            st.width_scale, output_data, &index_cache_);
       } else {
         status = functor::ResizeNearestNeighbor<Device, T,
                                                 /*half_pixe_centers=*/true,
                                                 /*align_corners=*/false>()(
             context->eigen_device<Device>(), input_data, st.height_scale,
-            st.width_scale, output_data);
+            st.width_scale, output_data, &index_cache_);
       }
     } else {
       if (align_corners_) {
@@ -82,13 +82,13 @@ class ResizeNearestNeighborOp : public OpKernel {
                                                 /*half_pixe_centers=*/false,
                                                 /*align_corners=*/true>()(
             context->eigen_device<Device>(), input_data, st.height_scale,
-            st.width_scale, output_data);
+            st.width_scale, output_data, &index_cache_);
       } else {
         status = functor::ResizeNearestNeighbor<Device, T,
                                                 /*half_pixe_centers=*/false,
                                                 /*align_corners=*/false>()(
             context->eigen_device<Device>(), input_data, st.height_scale,
-            st.width_scale, output_data);
+            st.width_scale, output_data, &index_cache_);
       }
     }
     if (!status) {
@@ -100,6 +100,7 @@ class ResizeNearestNeighborOp : public OpKernel {
  private:
   bool align_corners_;
   bool half_pixel_centers_;
+  functor::ResizeNearestNeighborIndexCache index_cache_;
 };
 
 // Helper struct to convert a bool to the correct scaler type.
@@ -132,7 +133,8 @@ template <typename T, bool half_pixel_centers, bool align_corners>
 struct ResizeNearestNeighbor<CPUDevice, T, half_pixel_centers, align_corners> {
   bool operator()(const CPUDevice& d, typename TTypes<T, 4>::ConstTensor input,
                   const float height_scale, const float width_scale,
-                  typename TTypes<T, 4>::Tensor output) {
+                  typename TTypes<T, 4>::Tensor output,
+                  ResizeNearestNeighborIndexCache* cache) {
     typename BoolToScaler<half_pixel_centers>::Scaler scaler;
     const Eigen::Index batch_size = input.dimension(0);
     const Eigen::Index in_height = input.dimension(1);
@@ -142,7 +144,14 @@ struct ResizeNearestNeighbor<CPUDevice, T, half_pixel_centers, align_corners> {
     const Eigen::Index out_height = output.dimension(1);
     const Eigen::Index out_width = output.dimension(2);
 
-    for (Eigen::Index b = 0; b < batch_size; ++b) {
+    std::shared_ptr<const ResizeNearestNeighborIndices> indices;
+    if (cache != nullptr) {
+      indices = cache->Lookup(in_height, in_width, out_height, out_width);
+    }
+    if (indices == nullptr) {
+      auto computed = std::make_shared<ResizeNearestNeighborIndices>();
+      computed->ys.resize(out_height);
+      computed->xs.resize(out_width);
       for (Eigen::Index y = 0; y < out_height; ++y) {
         Eigen::Index in_y = std::min(
             (align_corners)
@@ -152,16 +161,32 @@ struct ResizeNearestNeighbor<CPUDevice, T, half_pixel_centers, align_corners> {
         if (half_pixel_centers) {
           in_y = std::max(static_cast<Eigen::Index>(0), in_y);
         }
+        computed->ys[y] = in_y;
+      }
+      for (Eigen::Index x = 0; x < out_width; ++x) {
+        Eigen::Index in_x = std::min(
+            (align_corners)
+                ? static_cast<Eigen::Index>(roundf(scaler(x, width_scale)))
+                : static_cast<Eigen::Index>(floorf(scaler(x, width_scale))),
+            in_width - 1);
+        if (half_pixel_centers) {
+          in_x = std::max(static_cast<Eigen::Index>(0), in_x);
+        }
+        computed->xs[x] = in_x;
+      }
+      if (cache != nullptr) {
+        cache->Insert(in_height, in_width, out_height, out_width, computed);
+      }
+      indices = std::move(computed);
+    }
+
+    const int64* ys = indices->ys.data();
+    const int64* xs = indices->xs.data();
+    for (Eigen::Index b = 0; b < batch_size; ++b) {
+      for (Eigen::Index y = 0; y < out_height; ++y) {
         for (Eigen::Index x = 0; x < out_width; ++x) {
-          Eigen::Index in_x = std::min(
-              (align_corners)
-                  ? static_cast<Eigen::Index>(roundf(scaler(x, width_scale)))
-                  : static_cast<Eigen::Index>(floorf(scaler(x, width_scale))),
-              in_width - 1);
-          if (half_pixel_centers) {
-            in_x = std::max(static_cast<Eigen::Index>(0), in_x);
-          }
-          std::copy_n(&input(b, in_y, in_x, 0), channels, &output(b, y, x, 0));
+          std::copy_n(&input(b, ys[y], xs[x], 0), channels,
+                      &output(b, y, x, 0));
         }
       }
     }
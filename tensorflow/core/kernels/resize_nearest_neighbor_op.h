@@ -16,18 +16,70 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_RESIZE_NEAREST_NEIGHBOR_OP_H_
 #define TENSORFLOW_CORE_KERNELS_RESIZE_NEAREST_NEIGHBOR_OP_H_
 
+#include <memory>
+#include <vector>
+
 #include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 
 namespace tensorflow {
 namespace functor {
 
+// Nearest-source row and column indices for a resize geometry, computed once
+// and shared across kernel invocations.
+struct ResizeNearestNeighborIndices {
+  std::vector<int64> ys;
+  std::vector<int64> xs;
+};
+
+// Remembers the source indices for the most recently seen resize geometry.
+// The scaler choice comes from kernel attrs, which are fixed for the
+// kernel's lifetime, so it is not part of the key. Safe for concurrent
+// Compute calls.
+class ResizeNearestNeighborIndexCache {
+ public:
+  // Returns the cached indices if the geometry matches, else nullptr.
+  std::shared_ptr<const ResizeNearestNeighborIndices> Lookup(int64 in_height,
+                                                             int64 in_width,
+                                                             int64 out_height,
+                                                             int64 out_width) {
+    mutex_lock l(mu_);
+    if (in_height == in_height_ && in_width == in_width_ &&
+        out_height == out_height_ && out_width == out_width_) {
+      return indices_;
+    }
+    return nullptr;
+  }
+
+  void Insert(int64 in_height, int64 in_width, int64 out_height,
+              int64 out_width,
+              std::shared_ptr<const ResizeNearestNeighborIndices> indices) {
+    mutex_lock l(mu_);
+    in_height_ = in_height;
+    in_width_ = in_width;
+    out_height_ = out_height;
+    out_width_ = out_width;
+    indices_ = std::move(indices);
+  }
+
+ private:
+  mutex mu_;
+  int64 in_height_ GUARDED_BY(mu_) = -1;
+  int64 in_width_ GUARDED_BY(mu_) = -1;
+  int64 out_height_ GUARDED_BY(mu_) = -1;
+  int64 out_width_ GUARDED_BY(mu_) = -1;
+  std::shared_ptr<const ResizeNearestNeighborIndices> indices_ GUARDED_BY(mu_);
+};
+
 template <typename Device, typename T, bool half_pixel_centers,
           bool align_corners>
 struct ResizeNearestNeighbor {
+  // `cache` may be null; the GPU implementation ignores it.
   bool operator()(const Device& d, typename TTypes<T, 4>::ConstTensor input,
                   const float height_scale, const float width_scale,
-                  typename TTypes<T, 4>::Tensor output);
+                  typename TTypes<T, 4>::Tensor output,
+                  ResizeNearestNeighborIndexCache* cache);
 };
 
 template <typename Device, typename T, bool half_pixel_centers,
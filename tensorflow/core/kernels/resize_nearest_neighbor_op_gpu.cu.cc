@@ -160,7 +160,10 @@ template <typename T, bool half_pixel_centers, bool align_corners>
 struct ResizeNearestNeighbor<GPUDevice, T, half_pixel_centers, align_corners> {
   bool operator()(const GPUDevice& d, typename TTypes<T, 4>::ConstTensor input,
                   const float height_scale, const float width_scale,
-                  typename TTypes<T, 4>::Tensor output) {
+                  typename TTypes<T, 4>::Tensor output,
+                  ResizeNearestNeighborIndexCache* cache) {
+    // The source indices are computed inside the kernel launch, so `cache`
+    // is unused on GPU.
     const int batch_size = input.dimension(0);
     const int64 in_height = input.dimension(1);
     const int64 in_width = input.dimension(2);
@@ -125,6 +125,38 @@ TEST_F(ResizeNearestNeighborOpTest, TestNearest2x2To3x3) {
   test::ExpectTensorEqual<float>(expected, *GetOutput(0));
 }
 
+TEST_F(ResizeNearestNeighborOpTest, TestNearestReusesCachedIndices) {
+  // Run the same geometry twice on one kernel instance; the second run is
+  // served from the kernel's source-index cache. Then change the output
+  // size to make sure the cache is keyed on the geometry.
+  for (int run = 0; run < 2; ++run) {
+    inputs_.clear();
+    AddInputFromArray<float>(TensorShape({1, 2, 2, 1}), {1, 2, 3, 4});
+    AddInputFromArray<int32>(TensorShape({2}), {3, 3});
+    TF_ASSERT_OK(RunOpKernel());
+
+    Tensor expected(allocator(), DT_FLOAT, TensorShape({1, 3, 3, 1}));
+
+    // clang-format off
+    test::FillValues<float>(&expected,
+      {1, 1, 2,
+       1, 1, 2,
+       3, 3, 4});
+
+    // clang-format on
+    test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+  }
+
+  inputs_.clear();
+  AddInputFromArray<float>(TensorShape({1, 2, 2, 1}), {1, 2, 3, 4});
+  AddInputFromArray<int32>(TensorShape({2}), {1, 1});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({1, 1, 1, 1}));
+  test::FillValues<float>(&expected, {1});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
 TEST_F(ResizeNearestNeighborOpAlignCornersTest,
        TestNearestAlignCorners2x2To3x3) {
   // Input:
@@ -131,7 +131,7 @@ Status CopyVariable(int output_idx, OpKernelContext* ctx, const Tensor* t) {
 void ReadVariableOp::Compute(OpKernelContext* ctx) {
   Var* variable = nullptr;
   const ResourceHandle& handle = HandleFromInput(ctx, 0);
-  const auto status = LookupResource(ctx, handle, &variable);
+  const auto status = handle_cache_.Lookup(ctx, handle, &variable);
   OP_REQUIRES(ctx, status.ok(),
               errors::FailedPrecondition(
                   "Error while reading resource variable ", handle.name(),
@@ -140,6 +140,20 @@ void ReadVariableOp::Compute(OpKernelContext* ctx) {
                   status.ToString()));
 
   core::ScopedUnref s(variable);
+
+  // Frozen variables serve reads from an immutable snapshot without taking
+  // the variable's mutex; the snapshot holds the buffer alive.
+  std::shared_ptr<const Tensor> snapshot = variable->SnapshotIfFrozen();
+  if (snapshot != nullptr) {
+    OP_REQUIRES(ctx, dtype_ == snapshot->dtype(),
+                errors::InvalidArgument(
+                    "Trying to read variable with wrong dtype. Expected ",
+                    DataTypeString(dtype_), " got ",
+                    DataTypeString(snapshot->dtype())));
+    ctx->set_output(0, *snapshot);
+    return;
+  }
+
   // We're acquiring a reference to the underlying buffer while
   // holding a shared lock to guarantee ordering of reads and
   // writes.
@@ -190,6 +204,20 @@ void ReadVariablesOp::Compute(OpKernelContext* ctx) {
                               absl::StrJoin(uninitialized_vars, ", ")));
 
   for (size_t i = 0; i < dtypes_.size(); ++i) {
+    // Frozen variables serve reads from an immutable snapshot without taking
+    // the variable's mutex.
+    std::shared_ptr<const Tensor> snapshot = variables[i]->SnapshotIfFrozen();
+    if (snapshot != nullptr) {
+      OP_REQUIRES(
+          ctx, dtypes_[i] == snapshot->dtype(),
+          errors::InvalidArgument(
+              "Trying to read variable ", handles[i]->name(),
+              " from Container: ", handles[i]->container(),
+              " with wrong dtype. Expected ", DataTypeString(dtypes_[i]),
+              " got ", DataTypeString(snapshot->dtype())));
+      ctx->set_output(i, *snapshot);
+      continue;
+    }
     // We're acquiring a reference to the underlying buffer while
     // holding a shared lock to guarantee ordering of reads and
     // writes.
@@ -317,6 +345,22 @@ REGISTER_KERNEL_BUILDER(
     Name("DestroyResourceOp").Device(DEVICE_GPU).HostMemory("resource"),
     DestroyResourceOp);
 
+FreezeVariableOp::FreezeVariableOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
+
+void FreezeVariableOp::Compute(OpKernelContext* ctx) {
+  Var* variable = nullptr;
+  OP_REQUIRES_OK(ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &variable));
+  core::ScopedUnref s(variable);
+  mutex_lock ml(*variable->mu());
+  OP_REQUIRES_OK(ctx, variable->Freeze());
+}
+
+REGISTER_KERNEL_BUILDER(Name("FreezeVariableOp").Device(DEVICE_CPU),
+                        FreezeVariableOp);
+REGISTER_KERNEL_BUILDER(
+    Name("FreezeVariableOp").Device(DEVICE_GPU).HostMemory("resource"),
+    FreezeVariableOp);
+
 template <typename Device, typename T>
 class AssignVariableOp : public OpKernel {
  public:
@@ -355,6 +399,7 @@ class AssignVariableOp : public OpKernel {
                                 }));
     core::ScopedUnref s(variable);
     mutex_lock ml(*variable->mu());
+    variable->Unfreeze();
     OP_REQUIRES(context, variable->tensor()->dtype() == dtype_,
                 errors::InvalidArgument(
                     "Trying to assign variable with wrong dtype. Expected ",
@@ -425,6 +470,7 @@ class AssignVariableOp<Device, Variant> : public OpKernel {
         attr);
 
     mutex_lock ml(*variable->mu());
+    variable->Unfreeze();
     OP_REQUIRES(context, variable->tensor()->dtype() == DT_VARIANT,
                 errors::InvalidArgument(
                     "Trying to assign variable with wrong dtype. Expected ",
@@ -502,6 +548,7 @@ class AssignUpdateVariableOp : public OpKernel {
     // PrepareToUpdateVariable() for commutative operations like Op ==
     // ADD if value's refcount was 1.
     mutex_lock ml(*variable->mu());
+    variable->Unfreeze();
     Tensor* var_tensor = variable->tensor();
     OP_REQUIRES(context, var_tensor->shape().IsSameSize(value.shape()),
                 errors::InvalidArgument("Cannot update variable with shape ",
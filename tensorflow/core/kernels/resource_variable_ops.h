@@ -16,6 +16,8 @@ limitations under the License.
 #define TENSORFLOW_CORE_KERNELS_RESOURCE_VARIABLE_OPS_H_
 
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/resource_var.h"
 
 namespace tensorflow {
 
@@ -26,6 +28,9 @@ class ReadVariableOp : public OpKernel {
 
  private:
   DataType dtype_;
+  // Caches the handle -> Var* resolution so repeated executions of this
+  // kernel skip the resource manager's table lookup.
+  ResourceHandleCache<Var> handle_cache_;
 };
 
 class ReadVariablesOp : public OpKernel {
@@ -38,6 +43,12 @@ class ReadVariablesOp : public OpKernel {
   DataTypeVector dtypes_;
 };
 
+class FreezeVariableOp : public OpKernel {
+ public:
+  explicit FreezeVariableOp(OpKernelConstruction* ctx);
+  void Compute(OpKernelContext* ctx) override;
+};
+
 class DestroyResourceOp : public OpKernel {
  public:
   explicit DestroyResourceOp(OpKernelConstruction* ctx);
@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -236,6 +237,20 @@ namespace {
 // Tensors larger than this threshold will be restored from a thread-pool.
 const int64 kLargeShapeThreshold = 16 << 20;  // 16M
 
+// If TF_TENSOR_BUNDLE_MMAP_RESTORE is set, eligible tensors are restored as
+// read-only memory mappings of the checkpoint data files rather than copies
+// (see BundleReader::LookupMemoryMapped).  Only safe when the restored values
+// are never mutated, e.g. inference-only weights.
+bool MmapRestoreEnabled() {
+  static const bool enabled = [] {
+    bool mmap_restore = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_TENSOR_BUNDLE_MMAP_RESTORE", false,
+                                   &mmap_restore));
+    return mmap_restore;
+  }();
+  return enabled;
+}
+
 // A restore operation for a single tensor.  Small tensors may be restored
 // directly from the op thread to improve read locality.  Large tensors can be
 // restored from a thread pool: this requires creating a separate BundleReader
@@ -274,6 +289,16 @@ struct RestoreOp {
             << restored_full_shape.num_elements();
     Tensor* restored_tensor;
     if (shape_and_slice.empty()) {
+      if (MmapRestoreEnabled()) {
+        // Back the output with a read-only mapping of the checkpoint data
+        // file where possible (LookupMemoryMapped falls back to a copy
+        // otherwise).
+        Tensor mapped_tensor;
+        TF_RETURN_IF_ERROR(
+            reader->LookupMemoryMapped(tensor_name, &mapped_tensor));
+        context->set_output(idx, mapped_tensor);
+        return Status::OK();
+      }
       // Lookup the full tensor.
       TF_RETURN_IF_ERROR(
           context->allocate_output(idx, restored_full_shape, &restored_tensor));
@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_SCATTER_FUNCTOR_H_
 #define TENSORFLOW_CORE_KERNELS_SCATTER_FUNCTOR_H_
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 #include "third_party/eigen3/Eigen/Core"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
@@ -26,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/framework/variant_op_registry.h"
 #include "tensorflow/core/kernels/dense_update_functor.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -280,6 +283,81 @@ struct ScatterFunctorBase<SYCLDevice, T, Index, op> {
 };
 #endif  // TENSORFLOW_USE_SYCL
 
+// Minimum number of updated elements before the CPU scatter runs in
+// parallel; below this the bucketing overhead outweighs the work.
+static const int64 kMinParallelScatterElems = 1 << 16;
+
+// CPU specialization for the arithmetic update ops. Small updates take the
+// serial loop above; large batches of updates (e.g. sparse optimizers
+// touching millions of rows) are bucketed by destination row into one bin
+// per worker and the bins are applied in parallel. Each destination row is
+// owned by exactly one bin, so no two workers ever write the same params
+// row and no synchronization is needed. Within a bin, updates are applied
+// in their original order, so the result is bit-identical to the serial
+// path even with duplicate indices.
+template <typename T, typename Index, scatter_op::UpdateOp op>
+struct ScatterFunctorBase<CPUDevice, T, Index, op> {
+  Index operator()(OpKernelContext* c, const CPUDevice& d,
+                   typename TTypes<T>::Matrix params,
+                   typename TTypes<T>::ConstMatrix updates,
+                   typename TTypes<Index>::ConstFlat indices) {
+    // indices and params sizes were validated in DoCompute().
+    const Index N = static_cast<Index>(indices.size());
+    const Index limit = static_cast<Index>(params.dimension(0));
+    const int64 cols = static_cast<int64>(updates.dimension(1));
+
+    auto* worker_threads = c->device()->tensorflow_cpu_worker_threads();
+    if (worker_threads->num_threads > 1 && limit > 1 &&
+        static_cast<int64>(N) * cols >= kMinParallelScatterElems) {
+      // Validate all indices and record each update's destination row up
+      // front; unlike the serial path no update is applied when an invalid
+      // index is found.
+      std::vector<Index> row(N);
+      for (Index i = 0; i < N; i++) {
+        // Grab the index and check its validity.  Do this carefully,
+        // to avoid checking the value and grabbing it again from
+        // memory a second time (a security risk since it may change in
+        // between).
+        const Index index = ::tensorflow::internal::SubtleMustCopy(indices(i));
+        if (!FastBoundsCheck(index, limit)) return i;
+        row[i] = index;
+      }
+      // Bucket updates by destination row; each bin owns a contiguous range
+      // of rows so bins also preserve locality in params.
+      const int64 num_bins = std::min<int64>(worker_threads->num_threads,
+                                             static_cast<int64>(limit));
+      std::vector<std::vector<Index>> bins(num_bins);
+      for (Index i = 0; i < N; i++) {
+        bins[static_cast<int64>(row[i]) * num_bins / limit].push_back(i);
+      }
+      auto apply_bins = [&](int64 bin_begin, int64 bin_end) {
+        for (int64 b = bin_begin; b < bin_end; ++b) {
+          for (const Index i : bins[b]) {
+            scatter_op::internal::Assign<op>::Run(
+                params.template chip<0>(row[i]), updates.template chip<0>(i));
+          }
+        }
+      };
+      Shard(worker_threads->num_threads, worker_threads->workers, num_bins,
+            (static_cast<int64>(N) / num_bins) * cols, apply_bins);
+      return -1;
+    }
+
+    for (Index i = 0; i < N; i++) {
+      // Grab the index and check its validity.  Do this carefully,
+      // to avoid checking the value and grabbing it again from
+      // memory a second time (a security risk since it may change in
+      // between).
+      const Index index = ::tensorflow::internal::SubtleMustCopy(indices(i));
+      if (!FastBoundsCheck(index, limit)) return i;
+      // Copy last Ndim-1 dimensions of updates[i] to params[index]
+      scatter_op::internal::Assign<op>::Run(params.template chip<0>(index),
+                                            updates.template chip<0>(i));
+    }
+    return -1;
+  }
+};
+
 template <typename T, typename Index>
 struct ScatterFunctorBase<CPUDevice, T, Index, scatter_op::UpdateOp::ASSIGN> {
   Index operator()(OpKernelContext* c, const CPUDevice& d,
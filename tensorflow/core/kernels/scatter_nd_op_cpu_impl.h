@@ -20,7 +20,9 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
 #include <atomic>
+#include <vector>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 
@@ -112,6 +114,68 @@ struct ScatterNdFunctor<CPUDevice, T, Index, OP, IXDIM> {
       }
     }
 
+    const Eigen::DenseIndex num_rows = Toutput.dimension(0);
+    const Eigen::DenseIndex update_elems = Tupdates.dimension(1);
+
+    // Minimum number of updated elements before the scatter runs in
+    // parallel; below this the bucketing overhead outweighs the work.
+    static const Eigen::DenseIndex kMinParallelElems = 1 << 16;
+
+    if (d.numThreads() > 1 && num_rows > 1 &&
+        batch_size * update_elems >= kMinParallelElems) {
+      // Validate all indices and record each update's destination row up
+      // front; unlike the serial path no update is applied when an
+      // out-of-bounds index is found.
+      std::vector<Index> row(batch_size);
+      for (Eigen::DenseIndex loc = 0; loc < batch_size; ++loc) {
+        Index i = 0;
+        bool out_of_bounds = false;
+        for (int dim = 0; dim < IXDIM; ++dim) {
+          const Index ix_d = internal::SubtleMustCopy(Tindices(loc, dim));
+          out_of_bounds |= !FastBoundsCheck(ix_d, output_shape_prefix[dim]);
+          i += ix_d * batch_strides[dim];
+        }
+        if (TF_PREDICT_FALSE(out_of_bounds)) {
+          return loc;
+        }
+        row[loc] = i;
+      }
+      // Bucket updates by destination row into one bin per worker; each row
+      // is owned by exactly one bin, so no two workers ever write the same
+      // output slice and no synchronization is needed. Bins cover
+      // contiguous row ranges to preserve locality, and updates within a
+      // bin keep their original order, so the result matches the serial
+      // path even with duplicate indices.
+      const Eigen::DenseIndex num_bins =
+          std::min<Eigen::DenseIndex>(d.numThreads(), num_rows);
+      std::vector<std::vector<Eigen::DenseIndex>> bins(num_bins);
+      for (Eigen::DenseIndex loc = 0; loc < batch_size; ++loc) {
+        bins[static_cast<Eigen::DenseIndex>(row[loc]) * num_bins / num_rows]
+            .push_back(loc);
+      }
+      auto apply_bins = [&](Eigen::DenseIndex bin_begin,
+                            Eigen::DenseIndex bin_end) {
+        for (Eigen::DenseIndex b = bin_begin; b < bin_end; ++b) {
+          for (const Eigen::DenseIndex loc : bins[b]) {
+            auto input_chip = Toutput.template chip<0>(row[loc]);
+            auto update_chip = Tupdates.template chip<0>(loc);
+            update_executor::UpdateExecutor<
+                decltype(input_chip), decltype(update_chip),
+                decltype(input_chip)&, OP>::Execute(input_chip, update_chip,
+                                                    input_chip);
+          }
+        }
+      };
+      const Eigen::DenseIndex elems_per_bin =
+          (batch_size / num_bins + 1) * update_elems;
+      const Eigen::TensorOpCost cost(
+          elems_per_bin * sizeof(T) * 2 /* bytes loaded */,
+          elems_per_bin * sizeof(T) /* bytes stored */,
+          elems_per_bin * Eigen::TensorOpCost::AddCost<T>());
+      d.parallelFor(num_bins, cost, apply_bins);
+      return -1;
+    }
+
     for (Eigen::DenseIndex loc = 0; loc < batch_size; ++loc) {
       Index i = 0;
       bool out_of_bounds = false;
@@ -36,6 +36,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
@@ -113,26 +114,98 @@ class SegmentReductionOp : public OpKernel {
                 errors::InvalidArgument("segment ids must be >= 0"));
     auto output_flat = output->flat_outer_dims<T>();
 
+    // For large inputs, shard segment-aligned row ranges over the worker
+    // threads. Each range owns a distinct span of output rows (plus the gap
+    // rows preceding it), so the shards write disjoint memory. The sharded
+    // path relies on the ids being sorted and non-negative, which is
+    // verified up front; otherwise the serial call below reports the error
+    // exactly as before.
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    if (worker_threads.num_threads > 1 && num_indices >= 4096 &&
+        internal::SubtleMustCopy(segment_vec(0)) >= 0) {
+      bool sorted = true;
+      for (int64 i = 1; i < num_indices; ++i) {
+        if (internal::SubtleMustCopy(segment_vec(i)) <
+            internal::SubtleMustCopy(segment_vec(i - 1))) {
+          sorted = false;
+          break;
+        }
+      }
+      if (sorted) {
+        // Advance each split point to the next segment boundary so that no
+        // segment is split across shards; range s covers input rows
+        // [bounds[s], bounds[s + 1]).
+        const int64 num_shards = worker_threads.num_threads;
+        std::vector<Index> bounds;
+        bounds.push_back(0);
+        for (int64 s = 1; s < num_shards; ++s) {
+          Index t = static_cast<Index>(num_indices * s / num_shards);
+          while (t < num_indices &&
+                 internal::SubtleMustCopy(segment_vec(t)) ==
+                     internal::SubtleMustCopy(segment_vec(t - 1))) {
+            ++t;
+          }
+          if (t > bounds.back() && t < num_indices) {
+            bounds.push_back(t);
+          }
+        }
+        bounds.push_back(static_cast<Index>(num_indices));
+        const int64 num_ranges = bounds.size() - 1;
+        const int64 cost_per_range = num_indices * num_col / num_ranges;
+        Shard(worker_threads.num_threads, worker_threads.workers, num_ranges,
+              cost_per_range, [&](int64 range_start, int64 range_limit) {
+                for (int64 s = range_start; s < range_limit; ++s) {
+                  const Index row_begin = bounds[s];
+                  const Index row_end = bounds[s + 1];
+                  const Index uninitialized_index =
+                      s == 0 ? 0
+                             : internal::SubtleMustCopy(
+                                   segment_vec(row_begin - 1)) +
+                                   1;
+                  ReduceRows(context, input_flat, output_flat, segment_vec,
+                             row_begin, row_end, uninitialized_index,
+                             output_rows, num_col);
+                }
+              });
+        return;
+      }
+    }
+
+    ReduceRows(context, input_flat, output_flat, segment_vec, Index(0),
+               static_cast<Index>(num_indices), Index(0), output_rows,
+               num_col);
+  }
+
+ private:
+  // Reduces input rows [row_begin, row_end) into their segments' output
+  // rows, filling output rows in [first_uninitialized_index, first segment
+  // id) and any later gaps with the default value. Extracted from the
+  // former in-line loop so that it can run serially or per shard.
+  template <typename InputFlat, typename OutputFlat, typename SegmentVec>
+  void ReduceRows(OpKernelContext* context, const InputFlat& input_flat,
+                  OutputFlat& output_flat, const SegmentVec& segment_vec,
+                  const Index row_begin, const Index row_end,
+                  const Index first_uninitialized_index,
+                  const Index output_rows, const int64 num_col) {
 #if !defined(EIGEN_HAS_INDEX_LIST)
     Eigen::DSizes<Eigen::DenseIndex, 1> dims_to_reduce;
     dims_to_reduce[0] = 0;
 #else
     Eigen::IndexList<Eigen::type2index<0> > dims_to_reduce;
 #endif
-    Index start = 0, end = 1;
+    Index start = row_begin, end = row_begin + 1;
 
-    Index uninitialized_index = 0;  // Index from which the output is not set.
+    // Index from which the output is not set.
+    Index uninitialized_index = first_uninitialized_index;
     Index out_index = internal::SubtleMustCopy(segment_vec(start));
 
-    // TODO(agarwal): if this loop becomes a bottleneck, consider sharding it
-    // across threads.
     Eigen::DSizes<Eigen::DenseIndex, 1> out_slice_shape(num_col);
-    while (end <= num_indices) {
+    while (end <= row_end) {
       // We initialize next_index to 0 to avoid "warning: 'next_index' may be
       // used uninitialized in this function" in the Mac build (since the
       // compiler isn't smart enough to realize the code is safe).
       Index next_index = 0;
-      if (end < num_indices) {
+      if (end < row_end) {
         next_index = internal::SubtleMustCopy(segment_vec(end));
         if (out_index == next_index) {
           ++end;
@@ -187,7 +260,7 @@ class SegmentReductionOp : public OpKernel {
 
         out_slice = in_slice.reduce(dims_to_reduce, Reducer());
       }
-      if (end >= num_indices) break;
+      if (end >= row_end) break;
       start = end;
       ++end;
       uninitialized_index = out_index + 1;
@@ -381,6 +454,68 @@ struct UnsortedSegmentFunctor<CPUDevice, T, Index, InitialValueF, ReductionF> {
     const int64 N = segment_ids.dimension(0);
     ReductionF reduction;
     auto data_flat = typename TTypes<T, 2>::ConstTensor(data, N, data_size / N);
+
+    // For large inputs, shard contiguous ranges of segment ids over the
+    // worker threads. Every output row belongs to exactly one range, so the
+    // shards need no atomics or per-thread partial outputs, and rows within
+    // a segment are applied in the same order as the serial loop. A
+    // histogram pre-pass balances the ranges by input rows so skewed segment
+    // sizes do not leave threads idle. The histogram is only worthwhile when
+    // the segment space is not much larger than the input.
+    auto worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+    if (worker_threads->num_threads > 1 && N >= 4096 &&
+        num_segments > 1 && static_cast<int64>(num_segments) <= 8 * N) {
+      std::vector<int64> histogram(num_segments, 0);
+      for (int64 i = 0; i < N; ++i) {
+        Index j = internal::SubtleMustCopy(segment_ids(i));
+        if (j < 0) {
+          continue;
+        }
+        OP_REQUIRES(ctx, FastBoundsCheck(j, num_segments),
+                    errors::InvalidArgument(
+                        "segment_ids", SliceDebugString(segment_ids_shape, i),
+                        " = ", j, " is out of range [0, ", num_segments, ")"));
+        ++histogram[j];
+      }
+      // Close a range whenever it has accumulated its share of the input
+      // rows; range s covers segments [bounds[s], bounds[s + 1]).
+      const int64 num_shards = std::min<int64>(worker_threads->num_threads,
+                                               num_segments);
+      const int64 rows_per_shard = (N + num_shards - 1) / num_shards;
+      std::vector<Index> bounds;
+      bounds.push_back(0);
+      int64 rows_in_range = 0;
+      for (Index seg = 0; seg < num_segments; ++seg) {
+        rows_in_range += histogram[seg];
+        if (rows_in_range >= rows_per_shard &&
+            static_cast<int64>(bounds.size()) < num_shards) {
+          bounds.push_back(seg + 1);
+          rows_in_range = 0;
+        }
+      }
+      bounds.push_back(num_segments);
+      const int64 num_ranges = bounds.size() - 1;
+      const int64 cost_per_range = data_size / num_ranges;
+      Shard(worker_threads->num_threads, worker_threads->workers, num_ranges,
+            cost_per_range,
+            [&segment_ids, &data_flat, &output, &bounds, &reduction,
+             N](int64 start, int64 limit) {
+              for (int64 s = start; s < limit; ++s) {
+                const Index range_begin = bounds[s];
+                const Index range_end = bounds[s + 1];
+                for (int64 i = 0; i < N; ++i) {
+                  const Index j = internal::SubtleMustCopy(segment_ids(i));
+                  if (j < range_begin || j >= range_end) {
+                    continue;
+                  }
+                  reduction(data_flat.template chip<0>(i),
+                            output.template chip<0>(j));
+                }
+              }
+            });
+      return;
+    }
+
     for (int64 i = 0; i < N; ++i) {
       Index j = internal::SubtleMustCopy(segment_ids(i));
       if (j < 0) {
@@ -18,6 +18,8 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -43,8 +45,95 @@ struct SoftmaxFunctorBase {
     SoftmaxEigenImpl<Device, T>::Compute(d, logits, softmax, log);
   }
 };
+
+// Row-at-a-time softmax used on CPU instead of SoftmaxEigenImpl. The Eigen
+// implementation evaluates four expressions (max, exp, sum, scale), each of
+// which streams the full logits tensor through memory, so for wide rows
+// (e.g. large vocabulary heads) it is memory bound. Here each row is
+// processed in cache-sized blocks with the online max-sum recurrence: one
+// read pass maintains the running maximum and the sum of exponentials
+// relative to it, and one output pass writes the normalized result, so the
+// output is written exactly once and blocks stay resident between passes.
+// Rows are distributed over the device's thread pool.
 template <typename T>
-struct SoftmaxFunctor<CPUDevice, T> : SoftmaxFunctorBase<CPUDevice, T> {};
+struct SoftmaxRowImpl {
+  static void Compute(const CPUDevice& d,
+                      typename TTypes<T>::ConstMatrix logits,
+                      typename TTypes<T>::Matrix softmax, const bool log) {
+    const int64 batch_size = logits.dimension(0);
+    const int64 num_classes = logits.dimension(1);
+
+    // Block of logits plus its exponentials stays within L1.
+    static const int64 kBlockSize = 4096;
+
+    const T* logits_data = logits.data();
+    T* softmax_data = softmax.data();
+
+    auto compute_rows = [logits_data, softmax_data, num_classes, log](
+                            int64 start, int64 limit) {
+      typedef Eigen::Array<T, Eigen::Dynamic, 1> ArrayT;
+      typedef Eigen::Map<const ArrayT> ConstArrayMap;
+      typedef Eigen::Map<ArrayT> ArrayMap;
+      for (int64 r = start; r < limit; ++r) {
+        const T* row_in = logits_data + r * num_classes;
+        T* row_out = softmax_data + r * num_classes;
+
+        // Online pass: 'row_max' is the maximum over the blocks seen so far
+        // and 'sum' accumulates exponentials relative to it; when a block
+        // raises the maximum the partial sum is rescaled.
+        T row_max = Eigen::NumTraits<T>::lowest();
+        T sum = T(0);
+        for (int64 c = 0; c < num_classes; c += kBlockSize) {
+          const int64 size = std::min(kBlockSize, num_classes - c);
+          ConstArrayMap block(row_in + c, size);
+          const T block_max = block.maxCoeff();
+          if (block_max > row_max) {
+            sum *= Eigen::numext::exp(row_max - block_max);
+            row_max = block_max;
+          }
+          sum += (block - row_max).exp().sum();
+        }
+
+        // Output pass: a single write of the normalized result.
+        if (log) {
+          const T log_sum = Eigen::numext::log(sum);
+          for (int64 c = 0; c < num_classes; c += kBlockSize) {
+            const int64 size = std::min(kBlockSize, num_classes - c);
+            ConstArrayMap block(row_in + c, size);
+            ArrayMap out(row_out + c, size);
+            out = block - row_max - log_sum;
+          }
+        } else {
+          const T scale = T(1) / sum;
+          for (int64 c = 0; c < num_classes; c += kBlockSize) {
+            const int64 size = std::min(kBlockSize, num_classes - c);
+            ConstArrayMap block(row_in + c, size);
+            ArrayMap out(row_out + c, size);
+            out = (block - row_max).exp() * scale;
+          }
+        }
+      }
+    };
+
+    // Cost of one row: the logits are read twice, the output written once,
+    // and exp dominates the arithmetic.
+    const double exp_cost =
+        Eigen::internal::functor_traits<Eigen::internal::scalar_exp_op<T>>::Cost;
+    Eigen::TensorOpCost cost(
+        2 * sizeof(T) * num_classes /* bytes loaded */,
+        sizeof(T) * num_classes /* bytes stored */,
+        num_classes * (2 * exp_cost + 2 * Eigen::TensorOpCost::AddCost<T>()));
+    d.parallelFor(batch_size, cost, compute_rows);
+  }
+};
+
+template <typename T>
+struct SoftmaxFunctor<CPUDevice, T> {
+  void operator()(const CPUDevice& d, typename TTypes<T>::ConstMatrix logits,
+                  typename TTypes<T>::Matrix softmax, const bool log) {
+    SoftmaxRowImpl<T>::Compute(d, logits, softmax, log);
+  }
+};
 
 #ifdef TENSORFLOW_USE_SYCL
 template <typename T>
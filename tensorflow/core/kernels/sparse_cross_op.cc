@@ -27,7 +27,6 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
-#include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/util/work_sharder.h"
 
@@ -57,6 +56,7 @@ class SparseTensorColumn : public ColumnInterface<InternalType> {
         feature_counts_(std::move(feature_counts)),
         feature_start_indices_(std::move(feature_start_indices)) {
     CHECK_EQ(feature_counts_.size(), feature_start_indices_.size());
+    MaybePrecomputeFingerprints();
   }
 
   int64 FeatureCount(int64 batch) const override {
@@ -68,17 +68,35 @@ class SparseTensorColumn : public ColumnInterface<InternalType> {
   ~SparseTensorColumn() override {}
 
  private:
+  // No-op except for the int64 (hashed) instantiation; see below.
+  void MaybePrecomputeFingerprints() {}
+
   const Tensor& values_;
   std::vector<int64> feature_counts_;
   std::vector<int64> feature_start_indices_;
+  // Populated only by the int64 instantiation over string values.
+  std::vector<int64> fingerprints_;
 };
 
+// Each feature participates in as many crosses as the product of the other
+// columns' feature counts, so fingerprint every string value once up front
+// instead of on each cross that touches it.
+template <>
+void SparseTensorColumn<int64>::MaybePrecomputeFingerprints() {
+  if (DT_STRING == values_.dtype()) {
+    const auto strings = values_.vec<string>();
+    fingerprints_.resize(strings.size());
+    for (int64 i = 0; i < strings.size(); ++i) {
+      fingerprints_[i] = Fingerprint64(strings(i));
+    }
+  }
+}
+
 // InternalType is int64 only when using HashCrosser.
 template <>
 int64 SparseTensorColumn<int64>::Feature(int64 batch, int64 n) const {
   const int64 start = feature_start_indices_[batch];
-  if (DT_STRING == values_.dtype())
-    return Fingerprint64(values_.vec<string>().data()[start + n]);
+  if (DT_STRING == values_.dtype()) return fingerprints_[start + n];
   return values_.vec<int64>().data()[start + n];
 }
 
@@ -102,7 +120,9 @@ StringPiece SparseTensorColumn<StringPiece>::Feature(int64 batch,
 template <typename InternalType>
 class DenseTensorColumn : public ColumnInterface<InternalType> {
  public:
-  explicit DenseTensorColumn(const Tensor& tensor) : tensor_(tensor) {}
+  explicit DenseTensorColumn(const Tensor& tensor) : tensor_(tensor) {
+    MaybePrecomputeFingerprints();
+  }
 
   int64 FeatureCount(int64 batch) const override { return tensor_.dim_size(1); }
 
@@ -111,14 +131,34 @@ class DenseTensorColumn : public ColumnInterface<InternalType> {
   ~DenseTensorColumn() override {}
 
  private:
+  // No-op except for the int64 (hashed) instantiation; see below.
+  void MaybePrecomputeFingerprints() {}
+
   const Tensor& tensor_;
+  // Populated only by the int64 instantiation over string values.
+  std::vector<int64> fingerprints_;
 };
 
+// As for SparseTensorColumn: fingerprint every string value exactly once.
+template <>
+void DenseTensorColumn<int64>::MaybePrecomputeFingerprints() {
+  if (DT_STRING == tensor_.dtype()) {
+    const auto strings = tensor_.matrix<string>();
+    fingerprints_.resize(strings.size());
+    const int64 num_features = tensor_.dim_size(1);
+    for (int64 b = 0; b < tensor_.dim_size(0); ++b) {
+      for (int64 n = 0; n < num_features; ++n) {
+        fingerprints_[b * num_features + n] = Fingerprint64(strings(b, n));
+      }
+    }
+  }
+}
+
 // InternalType is int64 only when using HashCrosser.
 template <>
 int64 DenseTensorColumn<int64>::Feature(int64 batch, int64 n) const {
   if (DT_STRING == tensor_.dtype())
-    return Fingerprint64(tensor_.matrix<string>()(batch, n));
+    return fingerprints_[batch * tensor_.dim_size(1) + n];
   return tensor_.matrix<int64>()(batch, n);
 }
 
@@ -146,7 +186,7 @@ class OutputUpdater {
         values_out_(values_out) {}
 
   void Update(const int64 batch_index, const int64 cross_count,
-              const OutType& cross) const {
+              OutType cross) const {
     const int64 output_index = output_start_indices_[batch_index] + cross_count;
 
     auto indices_matrix = indices_out_->matrix<int64>();
@@ -154,7 +194,7 @@ class OutputUpdater {
     indices_matrix(output_index, 1) = cross_count;
 
     auto value_vec = values_out_->vec<OutType>();
-    value_vec(output_index) = cross;
+    value_vec(output_index) = std::move(cross);
   }
 
  private:
@@ -174,15 +214,27 @@ class StringCrosser {
 
   string Generate(const int64 batch_index,
                   const std::vector<int>& permutation) const {
-    static const auto k_feature_separator = "_X_";
+    static const StringPiece k_feature_separator = "_X_";
 
+    // Gather the parts first so the result can be built with one exact-size
+    // allocation instead of the grow-and-copy a join would do.
     gtl::InlinedVector<InternalType, 6> cross_vec(columns_.size());
+    size_t total_size =
+        columns_.empty() ? 0
+                         : (columns_.size() - 1) * k_feature_separator.size();
     for (int i = 0; i < permutation.size(); i++) {
       cross_vec[i] = columns_[i]->Feature(batch_index, permutation[i]);
+      total_size += cross_vec[i].size();
+    }
+    string cross;
+    cross.reserve(total_size);
+    for (int i = 0; i < cross_vec.size(); i++) {
+      if (i > 0) {
+        cross.append(k_feature_separator.data(), k_feature_separator.size());
+      }
+      cross.append(cross_vec[i].data(), cross_vec[i].size());
     }
-    // TODO(zakaria): this will copy the string twice, might effect
-    // performance.
-    return str_util::Join(cross_vec, k_feature_separator);
+    return cross;
   }
 
  private:
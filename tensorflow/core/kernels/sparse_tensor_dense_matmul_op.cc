@@ -19,6 +19,9 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/sparse_tensor_dense_matmul_op.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -244,6 +247,108 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
   // Vectorize certain operations above this size.
   static const std::size_t kNumVectorize = 32;
 
+  // Use the multi-threaded path only when there is enough work per thread
+  // that the final merge of per-thread partial outputs is a small fraction
+  // of it.
+  static const std::size_t kMinNnzForParallel = 1 << 13;
+
+  // Multi-threaded implementation: the nonzeros are split into equal-size
+  // chunks with no regard for row boundaries, so skewed row degrees (common
+  // in power-law graphs) cannot starve threads.  Each chunk accumulates
+  // rank-1 updates into a private dense partial of the output, and the
+  // partials are summed into `out` in a second parallel pass over rows.
+  // Ignoring row boundaries means two chunks may touch the same output row,
+  // which is exactly what the private partials make safe.
+  template <int B_CHIP, typename BTensor>
+  static Status ComputeParallel(const CPUDevice& d,
+                                typename TTypes<T>::Matrix out,
+                                typename TTypes<Tindices>::ConstMatrix a_indices,
+                                typename TTypes<T>::ConstVec a_values,
+                                const BTensor& b_ref,
+                                const std::size_t lhs_right,
+                                const int64 num_blocks) {
+    const std::size_t nnz = a_values.size();
+    const int64 out_rows = out.dimension(0);
+    const int64 rhs_right = out.dimension(1);
+    const int lhs_index_a = ADJ_A ? 1 : 0;
+    const int rhs_index_a = ADJ_A ? 0 : 1;
+
+    const int64 partial_size = out_rows * rhs_right;
+    std::vector<T> scratch(num_blocks * partial_size, T());
+    // First out-of-bounds nonzero seen by each block, or -1.  OP_REQUIRES
+    // cannot run in worker threads, so errors are reported after the fact.
+    std::vector<int64> block_bad_index(num_blocks, -1);
+
+    auto accumulate_blocks = [&](int64 block_begin, int64 block_end) {
+      for (int64 blk = block_begin; blk < block_end; ++blk) {
+        const std::size_t begin = nnz * blk / num_blocks;
+        const std::size_t end = nnz * (blk + 1) / num_blocks;
+        typename TTypes<T>::Matrix partial(scratch.data() + blk * partial_size,
+                                           out_rows, rhs_right);
+        for (std::size_t i = begin; i < end; ++i) {
+          const Tindices m =
+              internal::SubtleMustCopy(a_indices(i, lhs_index_a));
+          const Tindices k =
+              internal::SubtleMustCopy(a_indices(i, rhs_index_a));
+          if (!FastBoundsCheck(k, lhs_right) ||
+              !FastBoundsCheck(m, out_rows)) {
+            block_bad_index[blk] = i;
+            break;
+          }
+          const T a_value = (ADJ_A) ? MaybeConj(a_values(i)) : a_values(i);
+          partial.template chip<0>(m) +=
+              b_ref.template chip<B_CHIP>(k) * a_value;
+        }
+      }
+    };
+    const int64 nnz_per_block = nnz / num_blocks;
+    d.parallelFor(
+        num_blocks,
+        Eigen::TensorOpCost(nnz_per_block * rhs_right * sizeof(T) * 2,
+                            nnz_per_block * rhs_right * sizeof(T),
+                            nnz_per_block * rhs_right),
+        accumulate_blocks);
+
+    // Report the earliest bad nonzero with the same message the serial path
+    // produces.  Each block stops at its first bad index, so the minimum
+    // over blocks is the first bad index overall.
+    int64 first_bad = -1;
+    for (int64 blk = 0; blk < num_blocks; ++blk) {
+      if (block_bad_index[blk] >= 0 &&
+          (first_bad < 0 || block_bad_index[blk] < first_bad)) {
+        first_bad = block_bad_index[blk];
+      }
+    }
+    if (TF_PREDICT_FALSE(first_bad >= 0)) {
+      const Tindices m =
+          internal::SubtleMustCopy(a_indices(first_bad, lhs_index_a));
+      const Tindices k =
+          internal::SubtleMustCopy(a_indices(first_bad, rhs_index_a));
+      if (!FastBoundsCheck(k, lhs_right)) {
+        return KOutOfBoundsError(k, first_bad, rhs_index_a, lhs_right);
+      }
+      return MOutOfBoundsError(m, first_bad, lhs_index_a, out_rows);
+    }
+
+    auto merge_rows = [&](int64 row_begin, int64 row_end) {
+      for (int64 blk = 0; blk < num_blocks; ++blk) {
+        const T* partial = scratch.data() + blk * partial_size;
+        for (int64 r = row_begin; r < row_end; ++r) {
+          for (int64 n = 0; n < rhs_right; ++n) {
+            out(r, n) += partial[r * rhs_right + n];
+          }
+        }
+      }
+    };
+    d.parallelFor(out_rows,
+                  Eigen::TensorOpCost(num_blocks * rhs_right * sizeof(T) * 2,
+                                      rhs_right * sizeof(T),
+                                      num_blocks * rhs_right),
+                  merge_rows);
+
+    return Status::OK();
+  }
+
   static Status Compute(const CPUDevice& d, typename TTypes<T>::Matrix out,
                         typename TTypes<Tindices>::ConstMatrix a_indices,
                         typename TTypes<T>::ConstVec a_values,
@@ -259,6 +364,32 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
     // TODO(ebrevdo): After many failed experiments, can't find a multi-threaded
     // approach that achieves the performance of the single threaded
     // one.  Perhaps Eigen threadpool implementation is just too slow?
+    //
+    // Sharding the nonzeros directly races on output rows, and per-row
+    // sharding load-balances poorly on skewed degree distributions.  The
+    // parallel path below instead gives each thread an equal-size nonzero
+    // chunk and a private output partial, merging the partials afterwards;
+    // it is only selected when the merge is provably cheap relative to the
+    // accumulation.
+    if (rhs_right >= kNumVectorize && nnz >= kMinNnzForParallel) {
+      const int64 out_rows = out.dimension(0);
+      // Keep the merge (num_blocks * out_rows rank-1 row additions) under a
+      // quarter of the accumulation work (nnz row additions).
+      int64 num_blocks = std::min<int64>(
+          d.numThreads(), static_cast<int64>(nnz) / (4 * std::max<int64>(1, out_rows)));
+      if (num_blocks >= 2) {
+        if (ADJ_B) {
+          Eigen::array<int, 2> shuffle(1, 0);  // preserve dimension order
+          Eigen::Tensor<T, 2, Eigen::ColMajor> col_major_conj_b =
+              b.swap_layout().shuffle(shuffle).conjugate();
+          return ComputeParallel<1>(d, out, a_indices, a_values,
+                                    col_major_conj_b, lhs_right, num_blocks);
+        } else {
+          return ComputeParallel<0>(d, out, a_indices, a_values, b, lhs_right,
+                                    num_blocks);
+        }
+      }
+    }
 
     if (rhs_right < kNumVectorize) {
       // Disable vectorization if the RHS of output is too small
@@ -117,4 +117,12 @@ BM_SparseTensorDenseMatmul(16384, 4096, 4096, 4096, false, true);
 BM_SparseTensorDenseMatmul(16384, 4096, 4096, 4096, true, false);
 BM_SparseTensorDenseMatmul(16384, 4096, 4096, 4096, true, true);
 
+// Many nonzeros relative to the number of output rows: these shapes take the
+// multi-threaded chunked path on CPU.
+BM_SparseTensorDenseMatmul(131072, 128, 1024, 64, false, false);
+BM_SparseTensorDenseMatmul(131072, 1024, 1024, 64, false, false);
+BM_SparseTensorDenseMatmul(1048576, 1024, 4096, 128, false, false);
+BM_SparseTensorDenseMatmul(1048576, 1024, 4096, 128, false, true);
+BM_SparseTensorDenseMatmul(1048576, 1024, 4096, 128, true, false);
+
 }  // end namespace tensorflow
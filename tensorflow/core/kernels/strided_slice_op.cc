@@ -133,6 +133,50 @@ class StridedSliceOp : public OpKernel {
       return;
     }
 
+    // Optimization #2b, slice is memory contiguous but deeper than dim 0.
+    // This occurs when every dimension before some dimension `r` has slice
+    // extent 1, dimension `r` is sliced with stride 1, and every dimension
+    // after `r` is taken in full. The sliced region is then a contiguous
+    // run of rows in a collapsed [outer, inner] view of the input, so the
+    // output can share the input buffer just like the dim 0 case above.
+    if (is_simple_slice && input.dims() > 1 &&
+        processing_shape.num_elements() > 0) {
+      int r = 0;
+      while (r < input.dims() - 1 && end[r] - begin[r] == 1) ++r;
+      bool inner_full = true;
+      for (int i = r + 1; i < input.dims(); ++i) {
+        inner_full = inner_full && begin[i] == 0 && end[i] == input.dim_size(i);
+      }
+      if (inner_full) {
+        int64 outer = 1;
+        int64 start_row = 0;
+        for (int i = 0; i <= r; ++i) {
+          outer *= input.dim_size(i);
+          start_row = start_row * input.dim_size(i) + begin[i];
+        }
+        int64 inner = 1;
+        for (int i = r + 1; i < input.dims(); ++i) {
+          inner *= input.dim_size(i);
+        }
+        const int64 num_rows = end[r] - begin[r];
+        const TensorShape collapsed_shape({outer, inner});
+        if (IsDim0SliceAligned<T>(collapsed_shape, start_row,
+                                  start_row + num_rows)) {
+          VLOG(1) << "Strided slice contiguous dim " << r << ": "
+                  << input.shape().DebugString();
+          Tensor collapsed;
+          OP_REQUIRES(context, collapsed.CopyFrom(input, collapsed_shape),
+                      errors::Internal("Copy failed"));
+          Tensor slice = collapsed.Slice(start_row, start_row + num_rows);
+          Tensor tmp;
+          OP_REQUIRES(context, tmp.CopyFrom(slice, final_shape),
+                      errors::Internal("Copy failed"));
+          context->set_output(0, tmp);
+          return;
+        }
+      }
+    }
+
     Tensor* result = nullptr;
     OP_REQUIRES_OK(context, context->allocate_output(0, final_shape, &result));
     const int input_dims = input.dims();
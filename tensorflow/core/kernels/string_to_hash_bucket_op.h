@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -45,14 +46,30 @@ class StringToHashBucketOp : public OpKernel {
     auto output_flat = output_tensor->flat<int64>();
 
     typedef decltype(input_flat.size()) Index;
-    for (Index i = 0; i < input_flat.size(); ++i) {
-      const uint64 input_hash = hash(input_flat(i));
-      const uint64 bucket_id = input_hash % num_buckets_;
-      // The number of buckets is always in the positive range of int64 so is
-      // the resulting bucket_id. Casting the bucket_id from uint64 to int64 is
-      // safe.
-      output_flat(i) = static_cast<int64>(bucket_id);
+    const Index total = input_flat.size();
+    // The hash is pure and every output element is written exactly once, so
+    // the loop shards cleanly across the input tensor; each element's bucket
+    // id is bit-identical to the serial result.
+    int64 total_bytes = 0;
+    for (Index i = 0; i < total; ++i) {
+      total_bytes += input_flat(i).size();
     }
+    // Rough cycle estimate: a few cycles per hashed byte plus a fixed
+    // per-element cost for the modulo and the store.
+    const int64 cost_per_unit = 10 + (total > 0 ? 3 * total_bytes / total : 0);
+    auto do_work = [this, &input_flat, &output_flat](int64 start, int64 limit) {
+      for (int64 i = start; i < limit; ++i) {
+        const uint64 input_hash = hash(input_flat(i));
+        const uint64 bucket_id = input_hash % num_buckets_;
+        // The number of buckets is always in the positive range of int64 so is
+        // the resulting bucket_id. Casting the bucket_id from uint64 to int64
+        // is safe.
+        output_flat(i) = static_cast<int64>(bucket_id);
+      }
+    };
+    auto worker_threads = *context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, total,
+          cost_per_unit, do_work);
   }
 
  private:
@@ -87,14 +104,26 @@ class StringToKeyedHashBucketOp : public OpKernel {
     auto output_flat = output_tensor->flat<int64>();
 
     typedef decltype(input_flat.size()) Index;
-    for (Index i = 0; i < input_flat.size(); ++i) {
-      const uint64 input_hash = hash(key_, input_flat(i));
-      const uint64 bucket_id = input_hash % num_buckets_;
-      // The number of buckets is always in the positive range of int64 so is
-      // the resulting bucket_id. Casting the bucket_id from uint64 to int64 is
-      // safe.
-      output_flat(i) = static_cast<int64>(bucket_id);
+    const Index total = input_flat.size();
+    // Sharded for the same reason as StringToHashBucketOp above.
+    int64 total_bytes = 0;
+    for (Index i = 0; i < total; ++i) {
+      total_bytes += input_flat(i).size();
     }
+    const int64 cost_per_unit = 10 + (total > 0 ? 3 * total_bytes / total : 0);
+    auto do_work = [this, &input_flat, &output_flat](int64 start, int64 limit) {
+      for (int64 i = start; i < limit; ++i) {
+        const uint64 input_hash = hash(key_, input_flat(i));
+        const uint64 bucket_id = input_hash % num_buckets_;
+        // The number of buckets is always in the positive range of int64 so is
+        // the resulting bucket_id. Casting the bucket_id from uint64 to int64
+        // is safe.
+        output_flat(i) = static_cast<int64>(bucket_id);
+      }
+    };
+    auto worker_threads = *context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, total,
+          cost_per_unit, do_work);
   }
 
  private:
@@ -33,6 +33,7 @@ Status EnsureSparseVariableAccess(OpKernelContext* ctx, Var* var) {
     return Status::OK();
   }
   mutex_lock ml(*var->mu());
+  var->Unfreeze();
   // Once copy-on-read mode is True the refcount is guaranteed to be 1. This can
   // also happen if there are no concurrent reads of the variable and
   // copy-on-read mode is false.
@@ -249,6 +250,10 @@ Status GetInputTensorFromVariable(OpKernelContext* ctx, int input,
       *out = *var->tensor();
       return Status::OK();
     }
+    // The variable's mutex is held exclusively here (acquired by the caller
+    // via MaybeLockVariableInputMutexesInOrder), so the frozen snapshot, if
+    // any, can be dropped before updating.
+    var->Unfreeze();
     TF_RETURN_IF_ERROR(PrepareToUpdateVariable<Device, T>(
         ctx, var->tensor(), var->copy_on_read_mode.load()));
     *out = *var->tensor();
@@ -13,9 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <functional>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -23,7 +24,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -106,13 +109,80 @@ class UniqueOp : public OpKernel {
       auto Tin = input.flat<T>();
       const int64 N = static_cast<int64>(Tin.size());
 
-      std::unordered_map<T, TIndex> uniq;
-      uniq.reserve(2 * N);
-      for (Eigen::Index i = 0, j = 0; i < N; ++i) {
-        auto it = uniq.insert(std::make_pair(Tin(i), j));
-        idx_vec(i) = it.first->second;
-        if (it.second) {
-          ++j;
+      // Open-addressing FlatMap instead of std::unordered_map: no per-node
+      // allocations, and pre-sizing the table avoids rehashes during the
+      // insertion loop.
+      gtl::FlatMap<T, TIndex> uniq(2 * N);
+
+      auto* worker_threads = context->device()->tensorflow_cpu_worker_threads();
+      // For large inputs, deduplicate in two phases: each worker builds a
+      // local table for a contiguous block of the input (recording
+      // block-local ids in idx_vec), a serial merge walks the blocks in
+      // order assigning global ids by first occurrence, and a final parallel
+      // pass rewrites idx_vec through the per-block remap tables. The output
+      // matches the serial loop exactly, including first-occurrence
+      // ordering of the unique values.
+      static const int64 kMinElemsForParallelUnique = 1 << 20;
+      const int64 num_blocks = std::min<int64>(worker_threads->num_threads,
+                                               N / (kMinElemsForParallelUnique / 4));
+      if (num_blocks > 1 && N >= kMinElemsForParallelUnique) {
+        std::vector<std::vector<T>> block_keys(num_blocks);
+        auto dedup_block = [&](int64 block_begin, int64 block_end) {
+          for (int64 b = block_begin; b < block_end; ++b) {
+            const int64 start = N * b / num_blocks;
+            const int64 limit = N * (b + 1) / num_blocks;
+            gtl::FlatMap<T, TIndex> local(2 * (limit - start));
+            std::vector<T>& keys = block_keys[b];
+            TIndex j = 0;
+            for (int64 i = start; i < limit; ++i) {
+              auto it = local.insert(std::make_pair(Tin(i), j));
+              idx_vec(i) = it.first->second;
+              if (it.second) {
+                keys.push_back(Tin(i));
+                ++j;
+              }
+            }
+          }
+        };
+        // One unit of work per block; the cost estimate makes the sharder
+        // hand each block to its own thread.
+        Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+              N / num_blocks * 50, dedup_block);
+
+        // Serial merge in block order: assign global ids by first
+        // occurrence and build the local-id -> global-id remap per block.
+        std::vector<std::vector<TIndex>> remap(num_blocks);
+        TIndex j = 0;
+        for (int64 b = 0; b < num_blocks; ++b) {
+          remap[b].reserve(block_keys[b].size());
+          for (const T& key : block_keys[b]) {
+            auto it = uniq.insert(std::make_pair(key, j));
+            remap[b].push_back(it.first->second);
+            if (it.second) {
+              ++j;
+            }
+          }
+        }
+
+        auto rewrite_block = [&](int64 block_begin, int64 block_end) {
+          for (int64 b = block_begin; b < block_end; ++b) {
+            const int64 start = N * b / num_blocks;
+            const int64 limit = N * (b + 1) / num_blocks;
+            const std::vector<TIndex>& block_remap = remap[b];
+            for (int64 i = start; i < limit; ++i) {
+              idx_vec(i) = block_remap[idx_vec(i)];
+            }
+          }
+        };
+        Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+              N / num_blocks * 2, rewrite_block);
+      } else {
+        for (Eigen::Index i = 0, j = 0; i < N; ++i) {
+          auto it = uniq.insert(std::make_pair(Tin(i), j));
+          idx_vec(i) = it.first->second;
+          if (it.second) {
+            ++j;
+          }
         }
       }
 
@@ -124,7 +194,7 @@ class UniqueOp : public OpKernel {
                      context->allocate_output(0, output_shape, &output));
       auto Tout = output->flat<T>();
 
-      for (auto it : uniq) {
+      for (const auto& it : uniq) {
         Tout(it.second) = it.first;
       }
     } else {
@@ -153,10 +223,8 @@ class UniqueOp : public OpKernel {
         return true;
       };
 
-      std::unordered_map<int64, int64, decltype(hash_fn), decltype(equal_to_fn)>
-          uniq(0, hash_fn, equal_to_fn);
-
-      uniq.reserve(2 * Tin.dimension(1));
+      gtl::FlatMap<int64, int64, decltype(hash_fn), decltype(equal_to_fn)> uniq(
+          2 * Tin.dimension(1), hash_fn, equal_to_fn);
 
       for (int64 i = 0, j = 0; i < Tin.dimension(1); ++i) {
         auto it = uniq.insert(std::make_pair(i, j));
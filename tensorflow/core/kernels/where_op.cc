@@ -23,8 +23,10 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/where_op.h"
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
+#include <vector>
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -33,9 +35,11 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_types.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
@@ -136,6 +140,85 @@ class WhereCPUOp : public OpKernel {
 
     const int input_dims = input.dims();
 
+    // Parallel path, replacing the single-threaded copy below: blocks of the
+    // flattened input are counted in parallel, an exclusive scan over the
+    // block counts yields each block's starting output row, and the blocks
+    // then write their index rows concurrently into disjoint output ranges.
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    static const int64 kMinElemsForParallelWhere = 1 << 18;
+    const int64 N = input.NumElements();
+    const int64 num_blocks =
+        std::min(static_cast<int64>(worker_threads->num_threads), N);
+    if (input_dims >= 1 && input_dims <= 5 && num_blocks > 1 &&
+        N >= kMinElemsForParallelWhere) {
+      const T* input_data = input.flat<T>().data();
+      std::vector<int64> block_offsets(num_blocks + 1, 0);
+      auto count_blocks = [&](int64 start_block, int64 limit_block) {
+        for (int64 b = start_block; b < limit_block; ++b) {
+          block_offsets[b + 1] = functor::CountAccumulator<T>(
+              input_data + N * b / num_blocks,
+              input_data + N * (b + 1) / num_blocks);
+        }
+      };
+      Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+            N / num_blocks, count_blocks);
+      for (int64 b = 0; b < num_blocks; ++b) {
+        block_offsets[b + 1] += block_offsets[b];
+      }
+      const int64 parallel_num_true = block_offsets[num_blocks];
+
+      Tensor* output = nullptr;
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(
+                         0, TensorShape({parallel_num_true, input_dims}),
+                         &output));
+      gtl::InlinedVector<int64, 8> strides(input_dims);
+      strides[input_dims - 1] = 1;
+      for (int i = input_dims - 2; i >= 0; --i) {
+        strides[i] = strides[i + 1] * input.dim_size(i + 1);
+      }
+      auto output_mat = output->matrix<int64>();
+      std::vector<int64> block_found_true(num_blocks, 0);
+      auto write_blocks = [&](int64 start_block, int64 limit_block) {
+        for (int64 b = start_block; b < limit_block; ++b) {
+          const int64 start = N * b / num_blocks;
+          const int64 limit = N * (b + 1) / num_blocks;
+          int64 true_n = block_offsets[b];
+          const int64 block_end = block_offsets[b + 1];
+          for (int64 n = start; n < limit; ++n) {
+            if (input_data[n] != T(0)) {
+              // Guard against the input changing between the counting and
+              // writing passes, as the serial path does; extra true values
+              // are counted but not written.
+              if (true_n < block_end) {
+                int64 index = n;
+                for (int i = 0; i < input_dims; ++i) {
+                  output_mat(true_n, i) = index / strides[i];
+                  index -= output_mat(true_n, i) * strides[i];
+                }
+              }
+              ++true_n;
+            }
+          }
+          block_found_true[b] = true_n - block_offsets[b];
+        }
+      };
+      Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+            (N / num_blocks) * (1 + input_dims), write_blocks);
+      int64 parallel_found_true = 0;
+      for (int64 b = 0; b < num_blocks; ++b) {
+        parallel_found_true += block_found_true[b];
+      }
+      OP_REQUIRES(
+          context, parallel_found_true == parallel_num_true,
+          errors::InvalidArgument(
+              "WhereOp: Race condition between counting the number of true "
+              "elements and writing them.  When counting, saw ",
+              parallel_num_true, " elements; but when writing their indices, "
+              "saw ", parallel_found_true, " elements."));
+      return;
+    }
+
     Tensor num_true;
     AllocatorAttributes attr;
     attr.set_on_host(true);
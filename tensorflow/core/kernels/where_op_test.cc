@@ -0,0 +1,86 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+
+static SessionOptions GetOptions(int intra_threads) {
+  SessionOptions opts;
+  opts.config.set_intra_op_parallelism_threads(intra_threads);
+  opts.config.set_inter_op_parallelism_threads(1);
+  return opts;
+}
+
+// Creates a Graph that runs Where over a 1D bool mask of `num_elems`
+// elements of which `density_pct` percent are true, spread uniformly.
+static Graph* Where(int64 num_elems, int density_pct) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor mask(DT_BOOL, TensorShape({num_elems}));
+  auto mask_flat = mask.flat<bool>();
+  for (int64 i = 0; i < num_elems; ++i) {
+    mask_flat(i) = (i % 100) < density_pct;
+  }
+  Node* ret;
+  TF_CHECK_OK(NodeBuilder(g->NewName("where"), "Where")
+                  .Input(test::graph::Constant(g, mask))
+                  .Finalize(g, &ret));
+  return g;
+}
+
+static void RunWhereBenchmark(int iters, int num_elems, int density_pct,
+                              int intra_threads) {
+  SessionOptions opts = GetOptions(intra_threads);
+  const int64 num_items = static_cast<int64>(iters) * num_elems;
+  testing::ItemsProcessed(num_items);
+  testing::BytesProcessed(num_items * sizeof(bool));
+  testing::UseRealTime();
+  test::Benchmark("cpu", Where(num_elems, density_pct), &opts).Run(iters);
+}
+
+// With one intra-op thread Where takes the serial path; with more threads it
+// counts and compacts in parallel. Densities span nearly-empty to
+// nearly-full masks.
+static void BM_WhereCPUSerial(int iters, int num_elems, int density_pct) {
+  RunWhereBenchmark(iters, num_elems, density_pct, 1 /* intra_threads */);
+}
+
+BENCHMARK(BM_WhereCPUSerial)
+    ->ArgPair(1 << 20, 1)
+    ->ArgPair(1 << 20, 10)
+    ->ArgPair(1 << 20, 50)
+    ->ArgPair(1 << 20, 90)
+    ->ArgPair(1 << 26, 10);
+
+static void BM_WhereCPUParallel(int iters, int num_elems, int density_pct) {
+  RunWhereBenchmark(iters, num_elems, density_pct, 16 /* intra_threads */);
+}
+
+BENCHMARK(BM_WhereCPUParallel)
+    ->ArgPair(1 << 20, 1)
+    ->ArgPair(1 << 20, 10)
+    ->ArgPair(1 << 20, 50)
+    ->ArgPair(1 << 20, 90)
+    ->ArgPair(1 << 26, 10);
+
+}  // namespace tensorflow
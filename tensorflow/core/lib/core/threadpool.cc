@@ -16,8 +16,15 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 
 #define EIGEN_USE_THREADS
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/context.h"
 #include "tensorflow/core/platform/denormal.h"
 #include "tensorflow/core/platform/logging.h"
@@ -30,12 +37,130 @@ limitations under the License.
 namespace tensorflow {
 namespace thread {
 
+namespace {
+
+// The node the current thread is doing work for, if any (see
+// ScopedPoolTaskTag). Propagated into pool tasks alongside Context.
+struct PoolTaskTag {
+  uint64 node_id = 0;
+  const string* node_name = nullptr;
+};
+
+thread_local PoolTaskTag pool_task_tag;
+
+// Per-pool scheduling activity, labeled by pool name.  Steals are detected
+// at the wrapper level: a task that was scheduled by one pool worker but
+// executed by another was stolen from the scheduler's queue.  Injections are
+// tasks submitted from threads outside the pool; with spinning disabled each
+// injection typically has to wake a parked worker.
+auto* pool_tasks_scheduled = monitoring::Counter<1>::New(
+    "/tensorflow/core/threadpool/tasks_scheduled",
+    "Number of tasks scheduled on a thread pool.", "pool_name");
+auto* pool_tasks_stolen = monitoring::Counter<1>::New(
+    "/tensorflow/core/threadpool/tasks_stolen",
+    "Number of thread pool tasks executed by a different worker thread than "
+    "the one that scheduled them.",
+    "pool_name");
+auto* pool_tasks_injected = monitoring::Counter<1>::New(
+    "/tensorflow/core/threadpool/tasks_injected",
+    "Number of thread pool tasks submitted from threads outside the pool.",
+    "pool_name");
+
+// Identifies the pool worker thread running the current code, if any.
+struct PoolWorkerTag {
+  const void* pool = nullptr;
+  int index = -1;
+};
+
+thread_local PoolWorkerTag pool_worker_tag;
+
+struct PoolProfilerState {
+  mutex mu;
+  std::unordered_map<uint64, PoolProfiler::NodeStats> stats GUARDED_BY(mu);
+};
+
+PoolProfilerState* GlobalPoolProfilerState() {
+  static PoolProfilerState* state = new PoolProfilerState;
+  return state;
+}
+
+PoolProfiler::NodeStats* LookupStats(PoolProfilerState* state, uint64 node_id,
+                                     const string* node_name)
+    EXCLUSIVE_LOCKS_REQUIRED(state->mu) {
+  PoolProfiler::NodeStats* stats = &state->stats[node_id];
+  if (stats->name.empty() && node_name != nullptr) {
+    stats->name = *node_name;
+  }
+  return stats;
+}
+
+}  // namespace
+
+/* static */ bool PoolProfiler::Enabled() {
+  static const bool enabled = []() {
+    const char* env = getenv("TF_POOL_PROFILE");
+    return env != nullptr && env[0] != '\0' && env[0] != '0';
+  }();
+  return enabled;
+}
+
+/* static */ std::vector<PoolProfiler::NodeStats> PoolProfiler::Collect() {
+  std::vector<NodeStats> result;
+  PoolProfilerState* state = GlobalPoolProfilerState();
+  mutex_lock l(state->mu);
+  result.reserve(state->stats.size());
+  for (auto& entry : state->stats) {
+    result.push_back(std::move(entry.second));
+  }
+  state->stats.clear();
+  return result;
+}
+
+/* static */ string PoolProfiler::Report() {
+  std::vector<NodeStats> stats = PoolProfiler::Collect();
+  // Most interesting nodes first: by total shard execution time.
+  std::sort(stats.begin(), stats.end(),
+            [](const NodeStats& a, const NodeStats& b) {
+              return a.cpu_nanos > b.cpu_nanos;
+            });
+  string report =
+      "node                             regions   shards  wall_ms   cpu_ms "
+      "parallelism imbalance\n";
+  for (const NodeStats& s : stats) {
+    if (s.shards == 0 || s.wall_nanos == 0) continue;
+    const double parallelism =
+        static_cast<double>(s.cpu_nanos) / s.wall_nanos;
+    const double mean_shard_nanos =
+        static_cast<double>(s.cpu_nanos) / s.shards;
+    const double imbalance = s.max_shard_nanos / mean_shard_nanos;
+    strings::Appendf(&report, "%-32s %8lld %8lld %8.2f %8.2f %11.2f %9.2f\n",
+                     s.name.c_str(), static_cast<long long>(s.regions),
+                     static_cast<long long>(s.shards), s.wall_nanos * 1e-6,
+                     s.cpu_nanos * 1e-6, parallelism, imbalance);
+  }
+  return report;
+}
+
+ScopedPoolTaskTag::ScopedPoolTaskTag(uint64 node_id, const string* node_name)
+    : prev_node_id_(pool_task_tag.node_id),
+      prev_node_name_(pool_task_tag.node_name) {
+  pool_task_tag.node_id = node_id;
+  pool_task_tag.node_name = node_name;
+}
+
+ScopedPoolTaskTag::~ScopedPoolTaskTag() {
+  pool_task_tag.node_id = prev_node_id_;
+  pool_task_tag.node_name = prev_node_name_;
+}
+
 struct EigenEnvironment {
   typedef Thread EnvThread;
   struct TaskImpl {
     std::function<void()> f;
     Context context;
     uint64 trace_id;
+    PoolTaskTag tag;
+    PoolWorkerTag scheduler;
   };
   struct Task {
     std::unique_ptr<TaskImpl> f;
@@ -44,10 +169,22 @@ struct EigenEnvironment {
   Env* const env_;
   const ThreadOptions thread_options_;
   const string name_;
+  // Shared by all copies of this environment; its address also serves as the
+  // pool identity in PoolWorkerTag.
+  std::shared_ptr<std::atomic<int>> next_worker_index_;
+  monitoring::CounterCell* tasks_scheduled_cell_;
+  monitoring::CounterCell* tasks_stolen_cell_;
+  monitoring::CounterCell* tasks_injected_cell_;
 
   EigenEnvironment(Env* env, const ThreadOptions& thread_options,
                    const string& name)
-      : env_(env), thread_options_(thread_options), name_(name) {}
+      : env_(env),
+        thread_options_(thread_options),
+        name_(name),
+        next_worker_index_(std::make_shared<std::atomic<int>>(0)),
+        tasks_scheduled_cell_(pool_tasks_scheduled->GetCell(name)),
+        tasks_stolen_cell_(pool_tasks_stolen->GetCell(name)),
+        tasks_injected_cell_(pool_tasks_injected->GetCell(name)) {}
 
   EnvThread* CreateThread(std::function<void()> f) {
     return env_->StartThread(thread_options_, name_, [=]() {
@@ -58,6 +195,8 @@ struct EigenEnvironment {
       if (thread_options_.numa_node != port::kNUMANoAffinity) {
         port::NUMASetThreadNodeAffinity(thread_options_.numa_node);
       }
+      pool_worker_tag.pool = next_worker_index_.get();
+      pool_worker_tag.index = next_worker_index_->fetch_add(1);
       f();
     });
   }
@@ -68,17 +207,30 @@ struct EigenEnvironment {
       id = tracing::GetUniqueArg();
       tracing::RecordEvent(tracing::EventCategory::kScheduleClosure, id);
     }
+    tasks_scheduled_cell_->IncrementBy(1);
+    if (pool_worker_tag.pool != next_worker_index_.get()) {
+      tasks_injected_cell_->IncrementBy(1);
+    }
     return Task{
         std::unique_ptr<TaskImpl>(new TaskImpl{
             std::move(f),
             Context(ContextKind::kThread),
             id,
+            pool_task_tag,
+            pool_worker_tag,
         }),
     };
   }
 
   void ExecuteTask(const Task& t) {
     WithContext wc(t.f->context);
+    // Restore the scheduling thread's node tag so that work this task does
+    // (or shards further) is attributed to the originating node.
+    ScopedPoolTaskTag tag(t.f->tag.node_id, t.f->tag.node_name);
+    if (t.f->scheduler.pool == next_worker_index_.get() &&
+        t.f->scheduler.index != pool_worker_tag.index) {
+      tasks_stolen_cell_->IncrementBy(1);
+    }
     tracing::ScopedRegion region(tracing::EventCategory::kRunClosure,
                                  t.f->trace_id);
     t.f->f();
@@ -98,6 +250,37 @@ struct ThreadPool::Impl : Eigen::ThreadPoolTempl<EigenEnvironment> {
     CHECK_GE(total, 0);
     CHECK_EQ(total, (int64)(Eigen::Index)total);
     Eigen::ThreadPoolDevice device(this, this->NumThreads(), allocator_);
+    if (PoolProfiler::Enabled() && pool_task_tag.node_name != nullptr) {
+      // Time the parallel region and each shard, attributed to the node that
+      // issued this ParallelFor.
+      const uint64 node_id = pool_task_tag.node_id;
+      const string* node_name = pool_task_tag.node_name;
+      const int64 wall_start = Env::Default()->NowNanos();
+      device.parallelFor(total, Eigen::TensorOpCost(0, 0, cost_per_unit),
+                         [&fn, node_id, node_name](Eigen::Index first,
+                                                   Eigen::Index last) {
+                           const int64 start = Env::Default()->NowNanos();
+                           fn(first, last);
+                           const int64 nanos =
+                               Env::Default()->NowNanos() - start;
+                           PoolProfilerState* state = GlobalPoolProfilerState();
+                           mutex_lock l(state->mu);
+                           PoolProfiler::NodeStats* stats =
+                               LookupStats(state, node_id, node_name);
+                           ++stats->shards;
+                           stats->cpu_nanos += nanos;
+                           if (nanos > stats->max_shard_nanos) {
+                             stats->max_shard_nanos = nanos;
+                           }
+                         });
+      const int64 wall_nanos = Env::Default()->NowNanos() - wall_start;
+      PoolProfilerState* state = GlobalPoolProfilerState();
+      mutex_lock l(state->mu);
+      PoolProfiler::NodeStats* stats = LookupStats(state, node_id, node_name);
+      ++stats->regions;
+      stats->wall_nanos += wall_nanos;
+      return;
+    }
     device.parallelFor(
         total, Eigen::TensorOpCost(0, 0, cost_per_unit),
         [&fn](Eigen::Index first, Eigen::Index last) { fn(first, last); });
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/macros.h"
@@ -30,6 +31,51 @@ class ThreadPoolInterface;
 namespace tensorflow {
 namespace thread {
 
+// Accumulates per-node timing of work sharded onto thread pools, keyed by the
+// graph node tagged via ScopedPoolTaskTag below. Enabled with the
+// TF_POOL_PROFILE environment variable. For every tagged ParallelFor this
+// records the wall time of the parallel region and the execution time of each
+// shard, which makes intra-op parallel inefficiency (pool imbalance, poor
+// sharding) attributable to individual nodes.
+class PoolProfiler {
+ public:
+  struct NodeStats {
+    string name;
+    int64 regions = 0;          // number of parallel regions
+    int64 shards = 0;           // total shards across all regions
+    int64 wall_nanos = 0;       // sum of parallel region wall times
+    int64 cpu_nanos = 0;        // sum of shard execution times
+    int64 max_shard_nanos = 0;  // slowest shard seen
+  };
+
+  // Whether pool profiling is enabled (TF_POOL_PROFILE, read once).
+  static bool Enabled();
+
+  // Returns the collected per-node stats and clears them.
+  static std::vector<NodeStats> Collect();
+
+  // Returns a formatted per-node report of parallel efficiency
+  // (average parallelism = cpu/wall, shard imbalance = max_shard/mean_shard)
+  // and clears the collected stats.
+  static string Report();
+};
+
+// Tags work sharded onto thread pools from the current thread (and,
+// transitively, from tasks it schedules) with the originating graph node.
+// The executor installs one of these around each kernel launch so that
+// PoolProfiler can attribute shard timings back to the node. The referenced
+// name must outlive the tagged work.
+class ScopedPoolTaskTag {
+ public:
+  ScopedPoolTaskTag(uint64 node_id, const string* node_name);
+  ~ScopedPoolTaskTag();
+
+ private:
+  uint64 prev_node_id_;
+  const string* prev_node_name_;
+  TF_DISALLOW_COPY_AND_ASSIGN(ScopedPoolTaskTag);
+};
+
 class ThreadPool {
  public:
   // Constructs a pool that contains "num_threads" threads with specified
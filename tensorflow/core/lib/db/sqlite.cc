@@ -140,6 +140,9 @@ Status Sqlite::Open(const string& path, int flags, Sqlite** db) {
   s.Update(EnvPragma(*db, "secure_delete", "TF_SQLITE_SECURE_DELETE"));
   s.Update(EnvPragma(*db, "page_size", "TF_SQLITE_PAGE_SIZE"));
   s.Update(EnvPragma(*db, "journal_mode", "TF_SQLITE_JOURNAL_MODE"));
+  // Only meaningful with journal_mode=wal; controls how many WAL pages
+  // accumulate before they're checkpointed back into the main database.
+  s.Update(EnvPragma(*db, "wal_autocheckpoint", "TF_SQLITE_WAL_AUTOCHECKPOINT"));
   s.Update(EnvPragma(*db, "synchronous", "TF_SQLITE_SYNCHRONOUS"));
   s.Update(EnvPragma(*db, "mmap_size", "TF_SQLITE_MMAP_SIZE"));
   s.Update(EnvPragma(*db, "locking_mode", "TF_SQLITE_LOCKING_MODE"));
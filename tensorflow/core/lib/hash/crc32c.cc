@@ -26,6 +26,8 @@ namespace crc32c {
 
 extern bool CanAccelerate();
 extern uint32_t AcceleratedExtend(uint32_t crc, const char *buf, size_t size);
+extern void AcceleratedValueMany(const char *const *data, const size_t *sizes,
+                                 uint32_t *crcs, size_t n);
 
 static const uint32 table0_[256] = {
     0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
@@ -263,5 +265,17 @@ uint32 Extend(uint32 crc, const char *buf, size_t size) {
   return l ^ 0xffffffffu;
 }
 
+void ValueMany(const char *const *data, const size_t *sizes, uint32 *crcs,
+               size_t n) {
+  static bool can_accelerate = CanAccelerate();
+  if (can_accelerate) {
+    AcceleratedValueMany(data, sizes, crcs, n);
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    crcs[i] = Extend(0, data[i], sizes[i]);
+  }
+}
+
 }  // namespace crc32c
 }  // namespace tensorflow
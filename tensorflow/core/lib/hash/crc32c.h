@@ -30,6 +30,13 @@ extern uint32 Extend(uint32 init_crc, const char* data, size_t n);
 // Return the crc32c of data[0,n-1]
 inline uint32 Value(const char* data, size_t n) { return Extend(0, data, n); }
 
+// Compute crcs[i] = crc32c of data[i][0,sizes[i]-1] for each of the n
+// buffers.  When hardware CRC instructions are available, independent
+// buffers are checksummed in interleaved pairs to hide the instruction
+// latency, making this faster than n separate calls to Value().
+extern void ValueMany(const char* const* data, const size_t* sizes,
+                      uint32* crcs, size_t n);
+
 static const uint32 kMaskDelta = 0xa282ead8ul;
 
 // Return a masked representation of crc.
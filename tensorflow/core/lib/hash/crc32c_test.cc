@@ -62,6 +62,27 @@ TEST(CRC, Extend) {
   ASSERT_EQ(Value("hello world", 11), Extend(Value("hello ", 6), "world", 5));
 }
 
+TEST(CRC, ValueMany) {
+  // Batched results must match per-buffer Value() for assorted lengths,
+  // including empty buffers, tails shorter than 8 bytes, and an odd buffer
+  // count (which leaves one buffer unpaired).
+  static const size_t kLengths[] = {0, 1, 7, 8, 13, 1024, 32};
+  static const size_t kNumBuffers = sizeof(kLengths) / sizeof(kLengths[0]);
+  std::string bufs[kNumBuffers];
+  const char* data[kNumBuffers];
+  size_t sizes[kNumBuffers];
+  for (size_t i = 0; i < kNumBuffers; i++) {
+    bufs[i] = std::string(kLengths[i], 'a' + i);
+    data[i] = bufs[i].data();
+    sizes[i] = bufs[i].size();
+  }
+  uint32 crcs[kNumBuffers];
+  ValueMany(data, sizes, crcs, kNumBuffers);
+  for (size_t i = 0; i < kNumBuffers; i++) {
+    ASSERT_EQ(Value(data[i], sizes[i]), crcs[i]) << "buffer " << i;
+  }
+}
+
 TEST(CRC, Mask) {
   uint32 crc = Value("foo", 3);
   ASSERT_NE(crc, Mask(crc));
@@ -81,5 +102,19 @@ static void BM_CRC(int iters, int len) {
 }
 BENCHMARK(BM_CRC)->Range(1, 256 * 1024);
 
+static void BM_CRCBatch(int iters, int len) {
+  std::string a(len, 'x');
+  std::string b(len, 'y');
+  const char* data[2] = {a.data(), b.data()};
+  const size_t sizes[2] = {static_cast<size_t>(len), static_cast<size_t>(len)};
+  uint32 crcs[2] = {0, 0};
+  for (int i = 0; i < iters; i++) {
+    ValueMany(data, sizes, crcs, 2);
+  }
+  testing::BytesProcessed(static_cast<int64>(iters) * len * 2);
+  VLOG(1) << crcs[0] << " " << crcs[1];
+}
+BENCHMARK(BM_CRCBatch)->Range(1, 256 * 1024);
+
 }  // namespace crc32c
 }  // namespace tensorflow
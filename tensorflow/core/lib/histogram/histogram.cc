@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/lib/histogram/histogram.h"
 #include <float.h>
 #include <math.h>
+#include <string.h>
 #include <vector>
 #include "tensorflow/core/framework/summary.pb.h"
 
@@ -275,5 +276,154 @@ std::string ThreadSafeHistogram::ToString() const {
   return histogram_.ToString();
 }
 
+// ShardedHistogram implementation.
+namespace {
+
+inline uint64 DoubleToBits(double value) {
+  uint64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline double BitsToDouble(uint64 bits) {
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Atomically sets *cell (the bit pattern of a double) to f(current, value)
+// with a compare-and-swap loop.  Uncontended in the common case since each
+// thread updates its own shard.
+template <typename F>
+inline void AtomicDoubleUpdate(std::atomic<uint64>* cell, double value, F f) {
+  uint64 current = cell->load(std::memory_order_relaxed);
+  while (true) {
+    double updated = f(BitsToDouble(current), value);
+    if (cell->compare_exchange_weak(current, DoubleToBits(updated),
+                                    std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+// Returns the calling thread's shard index.  Threads are assigned shards
+// round-robin on first use, which spreads a fixed thread pool evenly; the
+// assignment is process-wide so that a thread maps to the same shard in
+// every ShardedHistogram.
+inline int CurrentShard(int num_shards) {
+  static std::atomic<uint32> next_thread_index(0);
+  static thread_local uint32 thread_index =
+      next_thread_index.fetch_add(1, std::memory_order_relaxed);
+  return thread_index % num_shards;
+}
+
+}  // namespace
+
+ShardedHistogram::ShardedHistogram() : bucket_limits_(InitDefaultBuckets()) {
+  Init();
+}
+
+ShardedHistogram::ShardedHistogram(gtl::ArraySlice<double> custom_bucket_limits)
+    : custom_bucket_limits_(custom_bucket_limits.begin(),
+                            custom_bucket_limits.end()),
+      bucket_limits_(custom_bucket_limits_) {
+#ifndef NDEBUG
+  DCHECK_GT(bucket_limits_.size(), size_t{0});
+  // Verify that the bucket boundaries are strictly increasing
+  for (size_t i = 1; i < bucket_limits_.size(); i++) {
+    DCHECK_GT(bucket_limits_[i], bucket_limits_[i - 1]);
+  }
+#endif
+  Init();
+}
+
+void ShardedHistogram::Init() {
+  for (int s = 0; s < kNumShards; s++) {
+    shards_[s].buckets.reset(new std::atomic<int64>[bucket_limits_.size()]);
+  }
+  Clear();
+}
+
+void ShardedHistogram::Clear() {
+  for (int s = 0; s < kNumShards; s++) {
+    Shard& shard = shards_[s];
+    shard.num.store(0, std::memory_order_relaxed);
+    shard.sum_bits.store(DoubleToBits(0.0), std::memory_order_relaxed);
+    shard.sum_squares_bits.store(DoubleToBits(0.0), std::memory_order_relaxed);
+    shard.min_bits.store(DoubleToBits(DBL_MAX), std::memory_order_relaxed);
+    shard.max_bits.store(DoubleToBits(-DBL_MAX), std::memory_order_relaxed);
+    for (size_t i = 0; i < bucket_limits_.size(); i++) {
+      shard.buckets[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void ShardedHistogram::Add(double value) {
+  Shard& shard = shards_[CurrentShard(kNumShards)];
+  int b =
+      std::upper_bound(bucket_limits_.begin(), bucket_limits_.end(), value) -
+      bucket_limits_.begin();
+  shard.buckets[b].fetch_add(1, std::memory_order_relaxed);
+  shard.num.fetch_add(1, std::memory_order_relaxed);
+  AtomicDoubleUpdate(&shard.sum_bits, value,
+                     [](double sum, double v) { return sum + v; });
+  AtomicDoubleUpdate(&shard.sum_squares_bits, value * value,
+                     [](double sum, double v) { return sum + v; });
+  AtomicDoubleUpdate(&shard.min_bits, value,
+                     [](double min, double v) { return v < min ? v : min; });
+  AtomicDoubleUpdate(&shard.max_bits, value,
+                     [](double max, double v) { return v > max ? v : max; });
+}
+
+void ShardedHistogram::MergeTo(Histogram* result) const {
+  DCHECK_EQ(result->buckets_.size(), bucket_limits_.size());
+  result->Clear();
+  for (int s = 0; s < kNumShards; s++) {
+    const Shard& shard = shards_[s];
+    int64 num = shard.num.load(std::memory_order_relaxed);
+    if (num == 0) continue;
+    result->num_ += num;
+    result->sum_ += BitsToDouble(shard.sum_bits.load(std::memory_order_relaxed));
+    result->sum_squares_ +=
+        BitsToDouble(shard.sum_squares_bits.load(std::memory_order_relaxed));
+    double min = BitsToDouble(shard.min_bits.load(std::memory_order_relaxed));
+    double max = BitsToDouble(shard.max_bits.load(std::memory_order_relaxed));
+    if (min < result->min_) result->min_ = min;
+    if (max > result->max_) result->max_ = max;
+    for (size_t i = 0; i < bucket_limits_.size(); i++) {
+      result->buckets_[i] += shard.buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+}
+
+std::unique_ptr<Histogram> ShardedHistogram::Snapshot() const {
+  std::unique_ptr<Histogram> snapshot(
+      custom_bucket_limits_.empty() ? new Histogram()
+                                    : new Histogram(custom_bucket_limits_));
+  MergeTo(snapshot.get());
+  return snapshot;
+}
+
+void ShardedHistogram::EncodeToProto(HistogramProto* proto,
+                                     bool preserve_zero_buckets) const {
+  Snapshot()->EncodeToProto(proto, preserve_zero_buckets);
+}
+
+double ShardedHistogram::Median() const { return Percentile(50.0); }
+
+double ShardedHistogram::Percentile(double p) const {
+  return Snapshot()->Percentile(p);
+}
+
+double ShardedHistogram::Average() const { return Snapshot()->Average(); }
+
+double ShardedHistogram::StandardDeviation() const {
+  return Snapshot()->StandardDeviation();
+}
+
+std::string ShardedHistogram::ToString() const {
+  return Snapshot()->ToString();
+}
+
 }  // namespace histogram
 }  // namespace tensorflow
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_LIB_HISTOGRAM_HISTOGRAM_H_
 #define TENSORFLOW_CORE_LIB_HISTOGRAM_HISTOGRAM_H_
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 #include "tensorflow/core/lib/gtl/array_slice.h"
@@ -97,6 +99,8 @@ class Histogram {
 
   double Remap(double x, double x0, double x1, double y0, double y1) const;
 
+  friend class ShardedHistogram;
+
   TF_DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
@@ -133,6 +137,70 @@ class ThreadSafeHistogram {
   Histogram histogram_ GUARDED_BY(mu_);
 };
 
+// Thread-safe histogram that records into one of several independent shards,
+// chosen per thread, using only atomic operations.  Unlike
+// ThreadSafeHistogram, Add() never takes a lock, so heavily concurrent
+// recording (e.g. per-request latencies from hundreds of threads) does not
+// serialize on a single mutex.  Queries merge the shards into a snapshot on
+// demand and are therefore more expensive than on Histogram; this is the
+// right trade-off for metrics that are recorded often and read rarely.
+//
+// Concurrent Add() calls are never lost, but a query that runs concurrently
+// with Add() may observe the value's bucket count without its contribution to
+// sum/min/max (or vice versa); counts and statistics are exact once recording
+// threads have quiesced.
+//
+// See Histogram for documentation of the query methods.
+class ShardedHistogram {
+ public:
+  ShardedHistogram();
+  explicit ShardedHistogram(gtl::ArraySlice<double> custom_bucket_limits);
+
+  ~ShardedHistogram() {}
+
+  // Records "value" in the calling thread's shard.  Lock-free.
+  void Add(double value);
+
+  // Resets all shards.  Must not run concurrently with Add().
+  void Clear();
+
+  void EncodeToProto(HistogramProto* proto, bool preserve_zero_buckets) const;
+  double Median() const;
+  double Percentile(double p) const;
+  double Average() const;
+  double StandardDeviation() const;
+  std::string ToString() const;
+
+ private:
+  // Shards are padded to a cache line so that threads recording into
+  // different shards do not contend on the same line.
+  struct alignas(64) Shard {
+    std::atomic<int64> num{0};
+    std::atomic<uint64> sum_bits{0};          // bit pattern of a double
+    std::atomic<uint64> sum_squares_bits{0};  // bit pattern of a double
+    std::atomic<uint64> min_bits;             // bit pattern of a double
+    std::atomic<uint64> max_bits;             // bit pattern of a double
+    std::unique_ptr<std::atomic<int64>[]> buckets;
+  };
+
+  static const int kNumShards = 16;
+
+  void Init();
+
+  // Merges all shards into "*result", which must have been constructed with
+  // the same bucket limits.
+  void MergeTo(Histogram* result) const;
+
+  // Returns a merged snapshot of all shards.
+  std::unique_ptr<Histogram> Snapshot() const;
+
+  std::vector<double> custom_bucket_limits_;
+  gtl::ArraySlice<double> bucket_limits_;
+  Shard shards_[kNumShards];
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ShardedHistogram);
+};
+
 }  // namespace histogram
 }  // namespace tensorflow
 
@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow/core/lib/histogram/histogram.h"
 #include <float.h>
 #include "tensorflow/core/framework/summary.pb.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -149,5 +151,66 @@ TEST(ThreadSafeHistogram, Basic) {
   EXPECT_EQ(h.ToString(), tsh.ToString());
 }
 
+TEST(ShardedHistogram, MatchesHistogram) {
+  // Fill a normal histogram and a sharded one with the same values and
+  // verify every query agrees.
+  Histogram h;
+  ShardedHistogram sh;
+  for (int i = 0; i < 100; i++) {
+    h.Add(i);
+    sh.Add(i);
+  }
+
+  EXPECT_EQ(h.Median(), sh.Median());
+  EXPECT_EQ(h.Percentile(40.0), sh.Percentile(40.0));
+  EXPECT_EQ(h.Average(), sh.Average());
+  EXPECT_EQ(h.StandardDeviation(), sh.StandardDeviation());
+  EXPECT_EQ(h.ToString(), sh.ToString());
+
+  HistogramProto h_proto;
+  h.EncodeToProto(&h_proto, true /* preserve_zero_buckets */);
+  HistogramProto sh_proto;
+  sh.EncodeToProto(&sh_proto, true /* preserve_zero_buckets */);
+  EXPECT_EQ(h_proto.DebugString(), sh_proto.DebugString());
+
+  sh.Clear();
+  EXPECT_EQ(0.0, sh.Average());
+}
+
+TEST(ShardedHistogram, CustomBuckets) {
+  Histogram h({-10, -5, 0, 5, 10, 100, 1000, 10000, DBL_MAX});
+  ShardedHistogram sh({-10, -5, 0, 5, 10, 100, 1000, 10000, DBL_MAX});
+  for (double val : {-20.0, -3.0, 1.0, 5.0, 500.0, 1000.0, 1e6}) {
+    h.Add(val);
+    sh.Add(val);
+  }
+  EXPECT_EQ(h.ToString(), sh.ToString());
+  EXPECT_EQ(h.Percentile(75.0), sh.Percentile(75.0));
+}
+
+TEST(ShardedHistogram, ConcurrentAdd) {
+  static const int kNumThreads = 8;
+  static const int kAddsPerThread = 10000;
+  ShardedHistogram sh;
+  {
+    thread::ThreadPool pool(Env::Default(), "concurrent_add", kNumThreads);
+    for (int t = 0; t < kNumThreads; t++) {
+      pool.Schedule([&sh]() {
+        for (int i = 0; i < kAddsPerThread; i++) {
+          sh.Add(i % 100);
+        }
+      });
+    }
+  }
+
+  HistogramProto proto;
+  sh.EncodeToProto(&proto, true /* preserve_zero_buckets */);
+  EXPECT_EQ(kNumThreads * kAddsPerThread, proto.num());
+  EXPECT_EQ(0.0, proto.min());
+  EXPECT_EQ(99.0, proto.max());
+  // Each thread adds 0..99 in equal proportion, so the sum is exact.
+  EXPECT_EQ(kNumThreads * kAddsPerThread * 99.0 / 2, proto.sum());
+}
+
 }  // namespace histogram
 }  // namespace tensorflow
@@ -0,0 +1,153 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/async_outputbuffer.h"
+
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace io {
+
+AsyncOutputBuffer::AsyncOutputBuffer(WritableFile* file, size_t buffer_bytes,
+                                     int64 sync_every_bytes, Env* env)
+    : file_(file),
+      buffer_capacity_(buffer_bytes),
+      sync_every_bytes_(sync_every_bytes),
+      writer_busy_(false),
+      stop_requested_(false) {
+  thread_.reset(env->StartThread(ThreadOptions(), "async_output_buffer",
+                                 [this]() { WriterLoop(); }));
+}
+
+AsyncOutputBuffer::~AsyncOutputBuffer() {
+  if (thread_) {
+    LOG(WARNING) << "AsyncOutputBuffer::Close() not called. Possible data loss";
+    Close().IgnoreError();
+  }
+}
+
+void AsyncOutputBuffer::WriterLoop() {
+  string active;
+  int64 bytes_since_sync = 0;
+  while (true) {
+    {
+      mutex_lock l(mu_);
+      writer_busy_ = false;
+      drain_cond_var_.notify_all();
+      while (pending_.empty() && !stop_requested_) {
+        work_cond_var_.wait(l);
+      }
+      if (pending_.empty()) {
+        return;  // Stop was requested and there is nothing left to write.
+      }
+      active.clear();
+      pending_.swap(active);
+      // After an error we keep draining buffers without writing them so that
+      // a blocked Append() can wake up and report the error.
+      if (!status_.ok()) {
+        continue;
+      }
+      writer_busy_ = true;
+    }
+    Status s = file_->Append(active);
+    if (s.ok() && sync_every_bytes_ > 0) {
+      bytes_since_sync += active.size();
+      if (bytes_since_sync >= sync_every_bytes_) {
+        s = file_->Sync();
+        bytes_since_sync = 0;
+      }
+    }
+    if (!s.ok()) {
+      mutex_lock l(mu_);
+      if (status_.ok()) {
+        status_ = s;
+      }
+    }
+  }
+}
+
+Status AsyncOutputBuffer::WaitForDrain(mutex_lock* l) {
+  while (status_.ok() && (!pending_.empty() || writer_busy_)) {
+    drain_cond_var_.wait(*l);
+  }
+  return status_;
+}
+
+Status AsyncOutputBuffer::Append(StringPiece data) {
+  mutex_lock l(mu_);
+  if (stop_requested_) {
+    return errors::FailedPrecondition(
+        "Append() called on a closed AsyncOutputBuffer");
+  }
+  // Backpressure: wait for the writer thread to drain staged data. A record
+  // larger than the whole buffer is let through on its own rather than
+  // rejected.
+  while (status_.ok() && !pending_.empty() &&
+         pending_.size() + data.size() > buffer_capacity_) {
+    drain_cond_var_.wait(l);
+  }
+  if (!status_.ok()) {
+    return status_;
+  }
+  pending_.append(data.data(), data.size());
+  work_cond_var_.notify_one();
+  return Status::OK();
+}
+
+Status AsyncOutputBuffer::Flush() {
+  {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(WaitForDrain(&l));
+  }
+  return file_->Flush();
+}
+
+Status AsyncOutputBuffer::Sync() {
+  {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(WaitForDrain(&l));
+  }
+  return file_->Sync();
+}
+
+Status AsyncOutputBuffer::Close() {
+  Status s;
+  {
+    mutex_lock l(mu_);
+    if (stop_requested_) {
+      return Status::OK();
+    }
+    s = WaitForDrain(&l);
+    stop_requested_ = true;
+    work_cond_var_.notify_all();
+  }
+  thread_.reset();  // Joins the writer thread.
+  return s;
+}
+
+Status AsyncOutputBuffer::Name(StringPiece* result) const {
+  return file_->Name(result);
+}
+
+Status AsyncOutputBuffer::Tell(int64* position) {
+  {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(WaitForDrain(&l));
+  }
+  return file_->Tell(position);
+}
+
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,106 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_IO_ASYNC_OUTPUTBUFFER_H_
+#define TENSORFLOW_CORE_LIB_IO_ASYNC_OUTPUTBUFFER_H_
+
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace io {
+
+// A WritableFile that stages appended data in an in-memory buffer and writes
+// it to the wrapped file from a dedicated background thread, so that file I/O
+// overlaps with whatever work the appending thread does between Append calls.
+//
+// Append() only blocks when more than `buffer_bytes` of data is waiting to be
+// written (backpressure). Errors from background writes are sticky and are
+// reported by the next Append/Flush/Sync/Close call.
+//
+// Like other WritableFile wrappers in this directory, a given instance is NOT
+// safe for concurrent use by multiple appending threads.
+class AsyncOutputBuffer : public WritableFile {
+ public:
+  // Stages up to `buffer_bytes` bytes before applying backpressure. If
+  // `sync_every_bytes` is greater than zero, the background thread calls
+  // Sync() on `file` after every such number of bytes written, bounding the
+  // amount of data lost if the process dies.
+  // Does not take ownership of `file`.
+  AsyncOutputBuffer(WritableFile* file, size_t buffer_bytes,
+                    int64 sync_every_bytes, Env* env);
+
+  // Calls Close() if it was not called explicitly.
+  ~AsyncOutputBuffer() override;
+
+  Status Append(StringPiece data) override;
+
+  // Waits until all staged data has been written and flushes the wrapped
+  // file.
+  Status Flush() override;
+
+  // Waits until all staged data has been written and syncs the wrapped file.
+  Status Sync() override;
+
+  // Waits until all staged data has been written and stops the background
+  // thread. Does *not* close the wrapped file.
+  //
+  // After calling this, any further calls to Append() will fail.
+  Status Close() override;
+
+  // Returns the name of the wrapped file.
+  Status Name(StringPiece* result) const override;
+
+  // Returns the write position in the wrapped file after draining staged
+  // data.
+  Status Tell(int64* position) override;
+
+ private:
+  // Body of the background writer thread.
+  void WriterLoop();
+
+  // Blocks until the background thread has written all staged data.
+  // Returns the sticky error status, if any.
+  Status WaitForDrain(mutex_lock* l) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  WritableFile* file_;  // Not owned
+  const size_t buffer_capacity_;
+  const int64 sync_every_bytes_;
+
+  mutable mutex mu_;
+  condition_variable work_cond_var_;   // Signalled when there is work to do.
+  condition_variable drain_cond_var_;  // Signalled when the writer drains.
+  string pending_ GUARDED_BY(mu_);     // Data not yet handed to the writer.
+  bool writer_busy_ GUARDED_BY(mu_);   // A write to file_ is in progress.
+  bool stop_requested_ GUARDED_BY(mu_);
+  Status status_ GUARDED_BY(mu_);  // First error from a background write.
+
+  std::unique_ptr<Thread> thread_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(AsyncOutputBuffer);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_IO_ASYNC_OUTPUTBUFFER_H_
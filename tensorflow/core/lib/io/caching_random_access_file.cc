@@ -0,0 +1,114 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/caching_random_access_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace io {
+
+BlockCache::BlockCache(size_t block_size, size_t max_bytes)
+    : block_size_(block_size), max_bytes_(max_bytes), cache_size_(0) {}
+
+size_t BlockCache::CacheSize() const {
+  mutex_lock lock(mu_);
+  return cache_size_;
+}
+
+Status BlockCache::GetBlock(const RandomAccessFile* file, uint64 block_offset,
+                            string* data) {
+  Key key = std::make_pair(file, block_offset);
+  {
+    mutex_lock lock(mu_);
+    auto entry = blocks_.find(key);
+    if (entry != blocks_.end()) {
+      // Move the block to the front of the LRU list.
+      if (entry->second.lru_iterator != lru_list_.begin()) {
+        lru_list_.erase(entry->second.lru_iterator);
+        lru_list_.push_front(key);
+        entry->second.lru_iterator = lru_list_.begin();
+      }
+      *data = entry->second.data;
+      return Status::OK();
+    }
+  }
+
+  // Miss: read the block without holding the lock. Two threads racing on the
+  // same block may both read it; the loser's copy simply replaces an
+  // identical one.
+  std::unique_ptr<char[]> scratch(new char[block_size_]);
+  StringPiece contents;
+  Status s = file->Read(block_offset, block_size_, &contents, scratch.get());
+  if (!s.ok() && !errors::IsOutOfRange(s)) {
+    return s;
+  }
+  // A short read (OutOfRange) marks the end of the file; the partial block
+  // is cached like any other.
+  data->assign(contents.data(), contents.size());
+
+  mutex_lock lock(mu_);
+  auto entry = blocks_.find(key);
+  if (entry == blocks_.end()) {
+    lru_list_.push_front(key);
+    Block& block = blocks_[key];
+    block.data = *data;
+    block.lru_iterator = lru_list_.begin();
+    cache_size_ += block.data.size();
+    while (cache_size_ > max_bytes_ && !lru_list_.empty()) {
+      auto evicted = blocks_.find(lru_list_.back());
+      cache_size_ -= evicted->second.data.size();
+      blocks_.erase(evicted);
+      lru_list_.pop_back();
+    }
+  }
+  return Status::OK();
+}
+
+Status BlockCache::Read(const RandomAccessFile* file, uint64 offset, size_t n,
+                        StringPiece* result, char* scratch) {
+  size_t bytes_copied = 0;
+  string block;
+  uint64 pos = (offset / block_size_) * block_size_;
+  while (bytes_copied < n) {
+    TF_RETURN_IF_ERROR(GetBlock(file, pos, &block));
+    if (offset + bytes_copied >= pos + block.size()) {
+      // The requested range starts at or beyond the end of the file.
+      break;
+    }
+    size_t begin = offset + bytes_copied - pos;
+    size_t bytes_to_copy =
+        std::min(n - bytes_copied, block.size() - begin);
+    memcpy(scratch + bytes_copied, block.data() + begin, bytes_to_copy);
+    bytes_copied += bytes_to_copy;
+    if (block.size() < block_size_) {
+      break;  // A partial block signals EOF at its upper bound.
+    }
+    pos += block_size_;
+  }
+  *result = StringPiece(scratch, bytes_copied);
+  if (bytes_copied < n) {
+    return errors::OutOfRange("EOF reached, ", bytes_copied,
+                              " bytes were read out of ", n,
+                              " bytes requested.");
+  }
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace tensorflow
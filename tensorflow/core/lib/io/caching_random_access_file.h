@@ -0,0 +1,120 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_IO_CACHING_RANDOM_ACCESS_FILE_H_
+#define TENSORFLOW_CORE_LIB_IO_CACHING_RANDOM_ACCESS_FILE_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace io {
+
+// An LRU cache of fixed-size file blocks, keyed by (file, block-aligned
+// offset). A single cache may be shared by any number of readers over any
+// number of files; this is useful for mixed sequential/seek workloads (for
+// example the two-level table iterators) that re-read the same disk blocks
+// many times with interleaved offsets, which a single linear buffer cannot
+// serve.
+//
+// The cache assumes files are immutable while cached: a block read once is
+// served from memory until it is evicted. Safe for concurrent use by
+// multiple threads.
+class BlockCache {
+ public:
+  // Caches blocks of `block_size` bytes, holding at most `max_bytes` bytes
+  // of block data in total.
+  BlockCache(size_t block_size, size_t max_bytes);
+
+  // Reads `n` bytes of `file` starting at `offset` through the cache, with
+  // the same contract as RandomAccessFile::Read. `file` must remain live
+  // until all blocks cached for it have been evicted or the cache is
+  // destroyed.
+  Status Read(const RandomAccessFile* file, uint64 offset, size_t n,
+              StringPiece* result, char* scratch);
+
+  size_t block_size() const { return block_size_; }
+
+  // The number of block-data bytes currently held, for tests.
+  size_t CacheSize() const LOCKS_EXCLUDED(mu_);
+
+ private:
+  // Cache key: the file and the block-aligned offset within it.
+  typedef std::pair<const RandomAccessFile*, uint64> Key;
+
+  struct Block {
+    string data;
+    std::list<Key>::iterator lru_iterator;
+  };
+
+  // Looks up (and possibly loads) the block at `block_offset` of `file` and
+  // copies it into *data. A block shorter than block_size() marks the end of
+  // the file.
+  Status GetBlock(const RandomAccessFile* file, uint64 block_offset,
+                  string* data) LOCKS_EXCLUDED(mu_);
+
+  const size_t block_size_;
+  const size_t max_bytes_;
+
+  mutable mutex mu_;
+  std::map<Key, Block> blocks_ GUARDED_BY(mu_);
+  // Least-recently used block is at the back of the list.
+  std::list<Key> lru_list_ GUARDED_BY(mu_);
+  size_t cache_size_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(BlockCache);
+};
+
+// A RandomAccessFile that serves reads from a (possibly shared) BlockCache.
+// Drop-in replacement for the wrapped file wherever a RandomAccessFile is
+// consumed, e.g. under table::Table or RecordReader.
+class CachingRandomAccessFile : public RandomAccessFile {
+ public:
+  // Does not take ownership of `file`, which must remain live while this
+  // object is in use.
+  CachingRandomAccessFile(RandomAccessFile* file,
+                          std::shared_ptr<BlockCache> cache)
+      : file_(file), cache_(std::move(cache)) {}
+
+  Status Name(StringPiece* result) const override {
+    return file_->Name(result);
+  }
+
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override {
+    return cache_->Read(file_, offset, n, result, scratch);
+  }
+
+ private:
+  RandomAccessFile* file_;  // Not owned
+  std::shared_ptr<BlockCache> cache_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(CachingRandomAccessFile);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_IO_CACHING_RANDOM_ACCESS_FILE_H_
@@ -0,0 +1,155 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/caching_random_access_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+// A file over an in-memory string that counts the reads it serves.
+class CountingFile : public RandomAccessFile {
+ public:
+  explicit CountingFile(const string& contents)
+      : contents_(contents), reads_(0) {}
+
+  Status Name(StringPiece* result) const override {
+    return errors::Unimplemented("CountingFile does not support Name()");
+  }
+
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override {
+    reads_++;
+    if (offset >= contents_.size()) {
+      *result = StringPiece(scratch, 0);
+      return errors::OutOfRange("EOF reached");
+    }
+    size_t can_read = std::min(n, contents_.size() - static_cast<size_t>(offset));
+    memcpy(scratch, contents_.data() + offset, can_read);
+    *result = StringPiece(scratch, can_read);
+    if (can_read < n) {
+      return errors::OutOfRange("EOF reached");
+    }
+    return Status::OK();
+  }
+
+  int reads() const { return reads_; }
+
+ private:
+  const string contents_;
+  mutable int reads_;
+};
+
+string MakeContents(size_t n) {
+  string contents;
+  for (size_t i = 0; i < n; i++) {
+    contents.push_back('a' + (i % 26));
+  }
+  return contents;
+}
+
+TEST(CachingRandomAccessFileTest, RepeatedReadsHitTheCache) {
+  const string contents = MakeContents(256);
+  CountingFile file(contents);
+  auto cache = std::make_shared<BlockCache>(64 /* block_size */,
+                                            1024 /* max_bytes */);
+  CachingRandomAccessFile cached(&file, cache);
+
+  char scratch[64];
+  StringPiece result;
+  TF_EXPECT_OK(cached.Read(0, 10, &result, scratch));
+  EXPECT_EQ(result, contents.substr(0, 10));
+  EXPECT_EQ(file.reads(), 1);
+
+  // Interleaved offsets within cached blocks do not touch the file again.
+  TF_EXPECT_OK(cached.Read(20, 10, &result, scratch));
+  EXPECT_EQ(result, contents.substr(20, 10));
+  TF_EXPECT_OK(cached.Read(5, 32, &result, scratch));
+  EXPECT_EQ(result, contents.substr(5, 32));
+  EXPECT_EQ(file.reads(), 1);
+
+  // A read spanning two blocks loads only the missing one.
+  TF_EXPECT_OK(cached.Read(60, 10, &result, scratch));
+  EXPECT_EQ(result, contents.substr(60, 10));
+  EXPECT_EQ(file.reads(), 2);
+}
+
+TEST(CachingRandomAccessFileTest, SharedAcrossReadersOfTheSameFile) {
+  const string contents = MakeContents(128);
+  CountingFile file(contents);
+  auto cache = std::make_shared<BlockCache>(64, 1024);
+  CachingRandomAccessFile reader1(&file, cache);
+  CachingRandomAccessFile reader2(&file, cache);
+
+  char scratch[64];
+  StringPiece result;
+  TF_EXPECT_OK(reader1.Read(0, 64, &result, scratch));
+  TF_EXPECT_OK(reader2.Read(0, 64, &result, scratch));
+  EXPECT_EQ(result, contents.substr(0, 64));
+  EXPECT_EQ(file.reads(), 1);
+}
+
+TEST(CachingRandomAccessFileTest, EvictsLeastRecentlyUsedBlocks) {
+  const string contents = MakeContents(256);
+  CountingFile file(contents);
+  // Room for two blocks.
+  auto cache = std::make_shared<BlockCache>(64, 128);
+  CachingRandomAccessFile cached(&file, cache);
+
+  char scratch[64];
+  StringPiece result;
+  TF_EXPECT_OK(cached.Read(0, 1, &result, scratch));    // Loads block 0.
+  TF_EXPECT_OK(cached.Read(64, 1, &result, scratch));   // Loads block 1.
+  TF_EXPECT_OK(cached.Read(0, 1, &result, scratch));    // Hit; touches block 0.
+  TF_EXPECT_OK(cached.Read(128, 1, &result, scratch));  // Evicts block 1.
+  EXPECT_EQ(file.reads(), 3);
+  EXPECT_EQ(cache->CacheSize(), 128);
+
+  TF_EXPECT_OK(cached.Read(0, 1, &result, scratch));   // Still cached.
+  EXPECT_EQ(file.reads(), 3);
+  TF_EXPECT_OK(cached.Read(64, 1, &result, scratch));  // Reloaded.
+  EXPECT_EQ(file.reads(), 4);
+}
+
+TEST(CachingRandomAccessFileTest, ReadPastEndOfFile) {
+  const string contents = MakeContents(100);
+  CountingFile file(contents);
+  auto cache = std::make_shared<BlockCache>(64, 1024);
+  CachingRandomAccessFile cached(&file, cache);
+
+  char scratch[128];
+  StringPiece result;
+  // Read straddling EOF returns the available bytes and OutOfRange.
+  Status s = cached.Read(90, 20, &result, scratch);
+  EXPECT_TRUE(errors::IsOutOfRange(s));
+  EXPECT_EQ(result, contents.substr(90, 10));
+
+  // Read entirely past EOF.
+  s = cached.Read(200, 10, &result, scratch);
+  EXPECT_TRUE(errors::IsOutOfRange(s));
+  EXPECT_EQ(result.size(), 0);
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,85 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_IO_FILTER_BLOCK_H_
+#define TENSORFLOW_CORE_LIB_IO_FILTER_BLOCK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace table {
+
+// Name under which the Bloom filter block handle is registered in the
+// metaindex block of a table.
+extern const char kFilterBlockMetaKey[];
+
+// A FilterBlockBuilder is used to construct all of the filters for a
+// particular Table.  It generates a single string which is stored as
+// a special block in the Table.
+//
+// The sequence of calls to FilterBlockBuilder must match the regexp:
+//      (StartBlock AddKey*)* Finish
+class FilterBlockBuilder {
+ public:
+  // Creates Bloom filters with approximately `bits_per_key` bits per key.
+  explicit FilterBlockBuilder(int bits_per_key);
+
+  void StartBlock(uint64 block_offset);
+  void AddKey(const StringPiece& key);
+  StringPiece Finish();
+
+ private:
+  void GenerateFilter();
+
+  const int bits_per_key_;
+  string keys_;                      // Flattened key contents
+  std::vector<size_t> start_;        // Starting index in keys_ of each key
+  string result_;                    // Filter data computed so far
+  std::vector<StringPiece> tmp_keys_;  // GenerateFilter() argument scratch
+  std::vector<uint32> filter_offsets_;
+
+  // No copying allowed
+  FilterBlockBuilder(const FilterBlockBuilder&);
+  void operator=(const FilterBlockBuilder&);
+};
+
+class FilterBlockReader {
+ public:
+  // REQUIRES: "contents" and the backing storage must stay live while
+  // *this is in use.
+  explicit FilterBlockReader(const StringPiece& contents);
+
+  // Returns false iff the key is certainly not in the data block that
+  // starts at "block_offset".
+  bool KeyMayMatch(uint64 block_offset, const StringPiece& key);
+
+ private:
+  const char* data_;    // Pointer to filter data (at block-start)
+  const char* offset_;  // Pointer to beginning of offset array (at block-end)
+  size_t num_;          // Number of entries in offset array
+  size_t base_lg_;      // Encoding parameter (see kFilterBaseLg in .cc file)
+};
+
+}  // namespace table
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_IO_FILTER_BLOCK_H_
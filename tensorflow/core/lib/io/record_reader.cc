@@ -27,6 +27,13 @@ limitations under the License.
 
 namespace tensorflow {
 namespace io {
+namespace {
+// Buffer sizes for SNAPPY_COMPRESSION.  The output buffer must fit one whole
+// decompressed block, whose size is bounded by the writer's input buffer
+// (see record_writer.cc); the input buffer must fit one compressed block.
+constexpr size_t kSnappyReaderInputBufferSize = 2 << 20;   // 2MB
+constexpr size_t kSnappyReaderOutputBufferSize = 1 << 20;  // 1MB
+}  // namespace
 
 RecordReaderOptions RecordReaderOptions::CreateRecordReaderOptions(
     const string& compression_type) {
@@ -47,6 +54,8 @@ RecordReaderOptions RecordReaderOptions::CreateRecordReaderOptions(
 #else
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
 #endif  // IS_SLIM_BUILD
+  } else if (compression_type == compression::kSnappy) {
+    options.compression_type = io::RecordReaderOptions::SNAPPY_COMPRESSION;
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
                << ". No compression will be used.";
@@ -58,12 +67,20 @@ RecordReader::RecordReader(RandomAccessFile* file,
                            const RecordReaderOptions& options)
     : options_(options),
       input_stream_(new RandomAccessInputStream(file)),
+      snappy_input_(nullptr),
       last_read_failed_(false) {
   if (options.buffer_size > 0) {
     input_stream_.reset(new BufferedInputStream(input_stream_.release(),
                                                 options.buffer_size, true));
   }
-  if (options.compression_type == RecordReaderOptions::ZLIB_COMPRESSION) {
+  if (options.compression_type == RecordReaderOptions::SNAPPY_COMPRESSION) {
+    // SnappyInputBuffer does its own file buffering, so it reads from `file`
+    // directly and options.buffer_size is ignored.
+    snappy_input_ = new SnappyInputBuffer(file, kSnappyReaderInputBufferSize,
+                                          kSnappyReaderOutputBufferSize);
+    input_stream_.reset(snappy_input_);
+  } else if (options.compression_type ==
+             RecordReaderOptions::ZLIB_COMPRESSION) {
 // We don't have zlib available on all embedded platforms, so fail.
 #if defined(IS_SLIM_BUILD)
     LOG(FATAL) << "Zlib compression is unsupported on mobile platforms.";
@@ -108,6 +125,31 @@ Status RecordReader::ReadChecksummed(uint64 offset, size_t n, string* result) {
   return Status::OK();
 }
 
+Status RecordReader::ReadChecksummedView(uint64 offset, size_t n,
+                                         StringPiece* result) {
+  if (n >= SIZE_MAX - sizeof(uint32)) {
+    return errors::DataLoss("record size too large");
+  }
+
+  const size_t expected = n + sizeof(uint32);
+  Status s = snappy_input_->ReadNBytesView(expected, result);
+
+  if (!s.ok() || result->size() != expected) {
+    if (result->empty()) {
+      return errors::OutOfRange("eof");
+    } else {
+      return errors::DataLoss("truncated record at ", offset);
+    }
+  }
+
+  const uint32 masked_crc = core::DecodeFixed32(result->data() + n);
+  if (crc32c::Unmask(masked_crc) != crc32c::Value(result->data(), n)) {
+    return errors::DataLoss("corrupted record at ", offset);
+  }
+  *result = StringPiece(result->data(), n);
+  return Status::OK();
+}
+
 Status RecordReader::GetMetadata(Metadata* md) {
   if (!md) {
     return errors::InvalidArgument(
@@ -161,10 +203,9 @@ Status RecordReader::GetMetadata(Metadata* md) {
   return Status::OK();
 }
 
-Status RecordReader::ReadRecord(uint64* offset, string* record) {
-  // Position the input stream.
+Status RecordReader::PositionInputStream(uint64 offset) {
   int64 curr_pos = input_stream_->Tell();
-  int64 desired_pos = static_cast<int64>(*offset);
+  int64 desired_pos = static_cast<int64>(offset);
   if (curr_pos > desired_pos || curr_pos < 0 /* EOF */ ||
       (curr_pos == desired_pos && last_read_failed_)) {
     last_read_failed_ = false;
@@ -174,6 +215,11 @@ Status RecordReader::ReadRecord(uint64* offset, string* record) {
     TF_RETURN_IF_ERROR(input_stream_->SkipNBytes(desired_pos - curr_pos));
   }
   DCHECK_EQ(desired_pos, input_stream_->Tell());
+  return Status::OK();
+}
+
+Status RecordReader::ReadRecord(uint64* offset, string* record) {
+  TF_RETURN_IF_ERROR(PositionInputStream(*offset));
 
   // Read header data.
   Status s = ReadChecksummed(*offset, sizeof(uint64), record);
@@ -198,6 +244,170 @@ Status RecordReader::ReadRecord(uint64* offset, string* record) {
   return Status::OK();
 }
 
+Status RecordReader::ReadRecordView(uint64* offset, StringPiece* record) {
+  if (snappy_input_ == nullptr) {
+    // The underlying stream cannot return views; stage the record in the
+    // scratch buffer and view that.
+    TF_RETURN_IF_ERROR(ReadRecord(offset, &view_scratch_));
+    *record = StringPiece(view_scratch_);
+    return Status::OK();
+  }
+
+  TF_RETURN_IF_ERROR(PositionInputStream(*offset));
+
+  // Read header data.
+  StringPiece header;
+  Status s = ReadChecksummedView(*offset, sizeof(uint64), &header);
+  if (!s.ok()) {
+    last_read_failed_ = true;
+    return s;
+  }
+  const uint64 length = core::DecodeFixed64(header.data());
+
+  // Read data.  This invalidates the header view, but the length has
+  // already been decoded.
+  s = ReadChecksummedView(*offset + kHeaderSize, length, record);
+  if (!s.ok()) {
+    last_read_failed_ = true;
+    if (errors::IsOutOfRange(s)) {
+      s = errors::DataLoss("truncated record at ", *offset);
+    }
+    return s;
+  }
+
+  *offset += kHeaderSize + length + kFooterSize;
+  DCHECK_EQ(*offset, input_stream_->Tell());
+  return Status::OK();
+}
+
+MemoryRegionRecordReader::MemoryRegionRecordReader(ReadOnlyMemoryRegion* region)
+    : data_(static_cast<const char*>(region->data())),
+      size_(region->length()) {}
+
+Status MemoryRegionRecordReader::ReadChecksummed(uint64 offset, size_t n,
+                                                 StringPiece* result) {
+  if (n >= SIZE_MAX - sizeof(uint32)) {
+    return errors::DataLoss("record size too large");
+  }
+
+  const uint64 expected = n + sizeof(uint32);
+  if (offset >= size_) {
+    return errors::OutOfRange("eof");
+  }
+  if (size_ - offset < expected) {
+    return errors::DataLoss("truncated record at ", offset);
+  }
+
+  const char* data = data_ + offset;
+  const uint32 masked_crc = core::DecodeFixed32(data + n);
+  if (crc32c::Unmask(masked_crc) != crc32c::Value(data, n)) {
+    return errors::DataLoss("corrupted record at ", offset);
+  }
+  *result = StringPiece(data, n);
+  return Status::OK();
+}
+
+Status MemoryRegionRecordReader::ReadRecords(uint64* offset,
+                                             size_t max_records,
+                                             std::vector<StringPiece>* records) {
+  // Parse the framing of up to max_records records, verifying the (cheap,
+  // 8-byte) length checksums as we go so that a corrupted length field
+  // cannot send us off into the weeds.  The data checksums are collected and
+  // verified in one batched call at the end.
+  std::vector<StringPiece> parsed;
+  std::vector<const char*> data_ptrs;
+  std::vector<size_t> data_sizes;
+  std::vector<uint32> masked_crcs;
+  std::vector<uint64> record_offsets;
+  uint64 pos = *offset;
+  while (parsed.size() < max_records && pos < size_) {
+    if (size_ - pos < RecordReader::kHeaderSize) {
+      return errors::DataLoss("truncated record at ", pos);
+    }
+    const char* p = data_ + pos;
+    const uint32 header_crc = core::DecodeFixed32(p + sizeof(uint64));
+    if (crc32c::Unmask(header_crc) != crc32c::Value(p, sizeof(uint64))) {
+      return errors::DataLoss("corrupted record at ", pos);
+    }
+    const uint64 length = core::DecodeFixed64(p);
+    if (length >= SIZE_MAX - sizeof(uint32)) {
+      return errors::DataLoss("record size too large");
+    }
+    if (size_ - pos - RecordReader::kHeaderSize <
+        length + RecordReader::kFooterSize) {
+      return errors::DataLoss("truncated record at ", pos);
+    }
+    const char* data = p + RecordReader::kHeaderSize;
+    data_ptrs.push_back(data);
+    data_sizes.push_back(length);
+    masked_crcs.push_back(core::DecodeFixed32(data + length));
+    record_offsets.push_back(pos);
+    parsed.push_back(StringPiece(data, length));
+    pos += RecordReader::kHeaderSize + length + RecordReader::kFooterSize;
+  }
+  if (parsed.empty()) {
+    return errors::OutOfRange("eof");
+  }
+
+  std::vector<uint32> crcs(parsed.size());
+  crc32c::ValueMany(data_ptrs.data(), data_sizes.data(), crcs.data(),
+                    parsed.size());
+  for (size_t i = 0; i < parsed.size(); i++) {
+    if (crc32c::Unmask(masked_crcs[i]) != crcs[i]) {
+      return errors::DataLoss("corrupted record at ", record_offsets[i]);
+    }
+  }
+
+  records->insert(records->end(), parsed.begin(), parsed.end());
+  *offset = pos;
+  return Status::OK();
+}
+
+Status MemoryRegionRecordReader::FindRecordBoundary(
+    uint64 search_start, uint64* record_offset) const {
+  for (uint64 pos = search_start;
+       pos + RecordReader::kHeaderSize <= size_; ++pos) {
+    const char* p = data_ + pos;
+    const uint32 masked_crc = core::DecodeFixed32(p + sizeof(uint64));
+    if (crc32c::Unmask(masked_crc) != crc32c::Value(p, sizeof(uint64))) {
+      continue;
+    }
+    // Reject candidates whose framing would run past the region.
+    const uint64 length = core::DecodeFixed64(p);
+    if (length > size_ ||
+        pos + RecordReader::kHeaderSize + length + RecordReader::kFooterSize >
+            size_) {
+      continue;
+    }
+    *record_offset = pos;
+    return Status::OK();
+  }
+  return errors::OutOfRange("no record boundary at or after offset ",
+                            search_start);
+}
+
+Status MemoryRegionRecordReader::ReadRecord(uint64* offset,
+                                            StringPiece* record) {
+  // Read header data.
+  StringPiece header;
+  TF_RETURN_IF_ERROR(ReadChecksummed(*offset, sizeof(uint64), &header));
+  const uint64 length = core::DecodeFixed64(header.data());
+
+  // Read data.
+  Status s =
+      ReadChecksummed(*offset + RecordReader::kHeaderSize, length, record);
+  if (!s.ok()) {
+    if (errors::IsOutOfRange(s)) {
+      s = errors::DataLoss("truncated record at ", *offset);
+    }
+    return s;
+  }
+
+  *offset +=
+      RecordReader::kHeaderSize + length + RecordReader::kFooterSize;
+  return Status::OK();
+}
+
 SequentialRecordReader::SequentialRecordReader(
     RandomAccessFile* file, const RecordReaderOptions& options)
     : underlying_(file, options), offset_(0) {}
@@ -16,9 +16,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_LIB_IO_RECORD_READER_H_
 #define TENSORFLOW_CORE_LIB_IO_RECORD_READER_H_
 
+#include <vector>
+
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/io/inputstream_interface.h"
+#include "tensorflow/core/lib/io/snappy/snappy_inputbuffer.h"
 #if !defined(IS_SLIM_BUILD)
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
@@ -29,12 +32,17 @@ limitations under the License.
 namespace tensorflow {
 
 class RandomAccessFile;
+class ReadOnlyMemoryRegion;
 
 namespace io {
 
 class RecordReaderOptions {
  public:
-  enum CompressionType { NONE = 0, ZLIB_COMPRESSION = 1 };
+  enum CompressionType {
+    NONE = 0,
+    ZLIB_COMPRESSION = 1,
+    SNAPPY_COMPRESSION = 2
+  };
   CompressionType compression_type = NONE;
 
   // If buffer_size is non-zero, then all reads must be sequential, and no
@@ -91,6 +99,14 @@ class RecordReader {
   // OUT_OF_RANGE for end of file, or something else for an error.
   Status ReadRecord(uint64* offset, string* record);
 
+  // Like ReadRecord, but points *record at the payload instead of copying it
+  // out.  With SNAPPY_COMPRESSION the view typically aliases the
+  // decompressed block directly, so the record is decompressed exactly once
+  // and never copied; for the other compression types the record is staged
+  // in an internal buffer first.  The view is invalidated by the next call
+  // on this reader.
+  Status ReadRecordView(uint64* offset, StringPiece* record);
+
   // Return the metadata of the Record file.
   //
   // The current implementation scans the file to completion,
@@ -103,17 +119,83 @@ class RecordReader {
   Status GetMetadata(Metadata* md);
 
  private:
+  // Positions input_stream_ at `offset`, resetting it if it cannot seek
+  // forward from its current position.
+  Status PositionInputStream(uint64 offset);
+
   Status ReadChecksummed(uint64 offset, size_t n, string* result);
 
+  // View-returning flavor of ReadChecksummed over snappy_input_; the view is
+  // invalidated by the next read.
+  Status ReadChecksummedView(uint64 offset, size_t n, StringPiece* result);
+
   RecordReaderOptions options_;
   std::unique_ptr<InputStreamInterface> input_stream_;
+  // Points at input_stream_ when SNAPPY_COMPRESSION is in use (which
+  // supports view-returning reads), or is null.  Not owned.
+  SnappyInputBuffer* snappy_input_;
   bool last_read_failed_;
+  // Backing storage for ReadRecordView when the underlying stream cannot
+  // return views itself.
+  string view_scratch_;
 
   std::unique_ptr<Metadata> cached_metadata_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(RecordReader);
 };
 
+// Zero-copy interface to read uncompressed TFRecord data out of a read-only
+// memory region, typically a memory-mapped file.
+//
+// ReadRecord returns a StringPiece aliasing the region instead of copying the
+// payload into a string. The view is valid for as long as "*region" stays
+// live; callers that outlive the region must copy. Compression is not
+// supported, since compressed payloads cannot be viewed in place.
+//
+// Note: this class is not thread safe; external synchronization required.
+class MemoryRegionRecordReader {
+ public:
+  // Creates a reader over "*region". "*region" must remain live while this
+  // reader (and any record views it has returned) is in use.
+  explicit MemoryRegionRecordReader(ReadOnlyMemoryRegion* region);
+
+  // Reads the record at "*offset" into *record and updates *offset to point
+  // to the offset of the next record.  Returns OK on success, OUT_OF_RANGE
+  // for end of data, or something else for an error.
+  Status ReadRecord(uint64* offset, StringPiece* record);
+
+  // Reads up to "max_records" consecutive records starting at "*offset",
+  // appends them to *records and updates *offset to point past the last one.
+  // The data checksums of all the records read are verified with a single
+  // batched crc32c call, which keeps hardware CRC units busier than
+  // per-record verification.  Returns OK if at least one record was read,
+  // OUT_OF_RANGE if "*offset" is at the end of the data, or DATA_LOSS on a
+  // truncated or corrupted record.
+  Status ReadRecords(uint64* offset, size_t max_records,
+                     std::vector<StringPiece>* records);
+
+  // Sets *record_offset to the offset of the first record that starts at or
+  // after "search_start", scanning forward for a position whose length field
+  // matches its masked crc32.  This makes it possible to split a file into
+  // arbitrary byte ranges and resynchronize each range on a record boundary,
+  // despite the format having no sync markers.  A checksum match at a
+  // non-boundary position is possible but has probability ~2^-32 per scanned
+  // byte, and such a false positive surfaces as a DataLoss error from the
+  // subsequent ReadRecord.  Returns OUT_OF_RANGE if no boundary exists at or
+  // after "search_start".
+  Status FindRecordBoundary(uint64 search_start, uint64* record_offset) const;
+
+ private:
+  // Verifies the checksum of the n bytes at "offset" and points *result at
+  // them.
+  Status ReadChecksummed(uint64 offset, size_t n, StringPiece* result);
+
+  const char* const data_;
+  const uint64 size_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(MemoryRegionRecordReader);
+};
+
 // High-level interface to read TFRecord files.
 //
 // Note: this class is not thread safe; external synchronization required.
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -41,9 +42,18 @@ io::RecordReaderOptions GetMatchingReaderOptions(
   if (options.compression_type == io::RecordWriterOptions::ZLIB_COMPRESSION) {
     return io::RecordReaderOptions::CreateRecordReaderOptions("ZLIB");
   }
+  if (options.compression_type == io::RecordWriterOptions::SNAPPY_COMPRESSION) {
+    return io::RecordReaderOptions::CreateRecordReaderOptions("SNAPPY");
+  }
   return io::RecordReaderOptions::CreateRecordReaderOptions("");
 }
 
+bool SnappyCompressionSupported() {
+  string out;
+  StringPiece in = "This is a test";
+  return port::Snappy_Compress(in.data(), in.size(), &out);
+}
+
 uint64 GetFileSize(const string& fname) {
   Env* env = Env::Default();
   uint64 fsize;
@@ -158,6 +168,177 @@ TEST(RecordReaderWriterTest, TestBasics) {
   }
 }
 
+TEST(RecordReaderWriterTest, TestMemoryRegionReader) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_mmap_test";
+
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+    io::RecordWriter writer(file.get());
+    TF_EXPECT_OK(writer.WriteRecord("abc"));
+    TF_EXPECT_OK(writer.WriteRecord("defg"));
+    TF_CHECK_OK(writer.Flush());
+  }
+
+  {
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    TF_CHECK_OK(env->NewReadOnlyMemoryRegionFromFile(fname, &region));
+    io::MemoryRegionRecordReader reader(region.get());
+    uint64 offset = 0;
+    StringPiece record;
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ("abc", record);
+    // The view must alias the mapping, not a copy.
+    EXPECT_GE(record.data(), static_cast<const char*>(region->data()));
+    EXPECT_LE(record.data() + record.size(),
+              static_cast<const char*>(region->data()) + region->length());
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ("defg", record);
+    EXPECT_EQ(region->length(), offset);
+    Status s = reader.ReadRecord(&offset, &record);
+    EXPECT_TRUE(errors::IsOutOfRange(s)) << s;
+  }
+}
+
+TEST(RecordReaderWriterTest, TestMemoryRegionReaderBatchedReads) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_mmap_batch_test";
+
+  std::vector<string> records;
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+    io::RecordWriter writer(file.get());
+    for (int i = 0; i < 10; i++) {
+      records.push_back(strings::StrCat("record-", i));
+      TF_EXPECT_OK(writer.WriteRecord(records.back()));
+    }
+    TF_CHECK_OK(writer.Flush());
+  }
+
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  TF_CHECK_OK(env->NewReadOnlyMemoryRegionFromFile(fname, &region));
+
+  {
+    io::MemoryRegionRecordReader reader(region.get());
+    uint64 offset = 0;
+    std::vector<StringPiece> batch;
+    // A batch smaller than the file, then one clipped at end of data.
+    TF_ASSERT_OK(reader.ReadRecords(&offset, 4, &batch));
+    EXPECT_EQ(4, batch.size());
+    TF_ASSERT_OK(reader.ReadRecords(&offset, 100, &batch));
+    EXPECT_EQ(10, batch.size());
+    for (int i = 0; i < 10; i++) {
+      EXPECT_EQ(records[i], batch[i]);
+    }
+    EXPECT_EQ(region->length(), offset);
+    Status s = reader.ReadRecords(&offset, 1, &batch);
+    EXPECT_TRUE(errors::IsOutOfRange(s)) << s;
+  }
+
+  // Flip a byte in the payload of the third record; a batch spanning it must
+  // fail with DataLoss and leave the offset untouched.
+  {
+    string contents;
+    TF_CHECK_OK(ReadFileToString(env, fname, &contents));
+    const uint64 per_record = io::RecordReader::kHeaderSize +
+                              records[0].size() +
+                              io::RecordReader::kFooterSize;
+    contents[2 * per_record + io::RecordReader::kHeaderSize] ^= 1;
+    TF_CHECK_OK(WriteStringToFile(env, fname, contents));
+
+    std::unique_ptr<ReadOnlyMemoryRegion> corrupt_region;
+    TF_CHECK_OK(env->NewReadOnlyMemoryRegionFromFile(fname, &corrupt_region));
+    io::MemoryRegionRecordReader reader(corrupt_region.get());
+    uint64 offset = 0;
+    std::vector<StringPiece> batch;
+    Status s = reader.ReadRecords(&offset, 10, &batch);
+    EXPECT_TRUE(errors::IsDataLoss(s)) << s;
+    EXPECT_EQ(0, offset);
+    EXPECT_EQ(0, batch.size());
+  }
+}
+
+TEST(RecordReaderWriterTest, TestMemoryRegionReaderFindRecordBoundary) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_boundary_test";
+
+  std::vector<string> records;
+  std::vector<uint64> offsets;
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+    io::RecordWriter writer(file.get());
+    uint64 offset = 0;
+    for (int i = 0; i < 10; i++) {
+      records.push_back(strings::StrCat("record-", i));
+      offsets.push_back(offset);
+      TF_EXPECT_OK(writer.WriteRecord(records.back()));
+      offset += io::RecordReader::kHeaderSize + records.back().size() +
+                io::RecordReader::kFooterSize;
+    }
+    TF_CHECK_OK(writer.Flush());
+  }
+
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  TF_CHECK_OK(env->NewReadOnlyMemoryRegionFromFile(fname, &region));
+  io::MemoryRegionRecordReader reader(region.get());
+
+  // Every byte position must resynchronize to the next true boundary.
+  size_t next_record = 0;
+  for (uint64 pos = 0; pos <= offsets.back(); ++pos) {
+    while (offsets[next_record] < pos) next_record++;
+    uint64 boundary = 0;
+    TF_ASSERT_OK(reader.FindRecordBoundary(pos, &boundary));
+    EXPECT_EQ(offsets[next_record], boundary) << "at position " << pos;
+    uint64 offset = boundary;
+    StringPiece record;
+    TF_ASSERT_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ(records[next_record], record);
+  }
+
+  // Past the start of the last record there is nothing to find.
+  uint64 boundary = 0;
+  Status s = reader.FindRecordBoundary(offsets.back() + 1, &boundary);
+  EXPECT_TRUE(errors::IsOutOfRange(s)) << s;
+}
+
+TEST(RecordReaderWriterTest, TestMemoryRegionReaderCorruption) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_mmap_corrupt_test";
+
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+    io::RecordWriter writer(file.get());
+    TF_EXPECT_OK(writer.WriteRecord("abc"));
+    TF_CHECK_OK(writer.Flush());
+  }
+
+  // Flip a payload byte; the data checksum must catch it.
+  {
+    string contents;
+    TF_CHECK_OK(ReadFileToString(env, fname, &contents));
+    contents[io::RecordReader::kHeaderSize] ^= 1;
+    TF_CHECK_OK(WriteStringToFile(env, fname, contents));
+  }
+
+  {
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    TF_CHECK_OK(env->NewReadOnlyMemoryRegionFromFile(fname, &region));
+    io::MemoryRegionRecordReader reader(region.get());
+    uint64 offset = 0;
+    StringPiece record;
+    Status s = reader.ReadRecord(&offset, &record);
+    EXPECT_TRUE(errors::IsDataLoss(s)) << s;
+  }
+}
+
 TEST(RecordReaderWriterTest, TestZlib) {
   Env* env = Env::Default();
   string fname = testing::TmpDir() + "/record_reader_writer_zlib_test";
@@ -196,6 +377,153 @@ TEST(RecordReaderWriterTest, TestZlib) {
   }
 }
 
+TEST(RecordReaderWriterTest, TestSnappy) {
+  if (!SnappyCompressionSupported()) {
+    LOG(WARNING) << "Snappy not supported. Skipping.";
+    return;
+  }
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_snappy_test";
+
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+    io::RecordWriterOptions options;
+    options.compression_type = io::RecordWriterOptions::SNAPPY_COMPRESSION;
+    io::RecordWriter writer(file.get(), options);
+    TF_EXPECT_OK(writer.WriteRecord("abc"));
+    TF_EXPECT_OK(writer.WriteRecord("defg"));
+    TF_CHECK_OK(writer.Close());
+  }
+
+  {
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReaderOptions options;
+    options.compression_type = io::RecordReaderOptions::SNAPPY_COMPRESSION;
+    io::RecordReader reader(read_file.get(), options);
+    uint64 offset = 0;
+    string record;
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ("abc", record);
+    TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ("defg", record);
+    EXPECT_TRUE(
+        errors::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+  }
+}
+
+TEST(RecordReaderWriterTest, TestReadRecordView) {
+  Env* env = Env::Default();
+  const std::vector<string> records = {"abc", "defg",
+                                       string(1000, 'x'), ""};
+
+  std::vector<io::RecordWriterOptions> cases;
+  cases.emplace_back();  // Uncompressed: exercises the copying fallback.
+  if (SnappyCompressionSupported()) {
+    io::RecordWriterOptions snappy_options;
+    snappy_options.compression_type =
+        io::RecordWriterOptions::SNAPPY_COMPRESSION;
+    cases.push_back(snappy_options);
+  } else {
+    LOG(WARNING) << "Snappy not supported. Testing uncompressed only.";
+  }
+
+  for (const auto& options : cases) {
+    string fname = testing::TmpDir() + "/record_reader_view_test";
+    {
+      std::unique_ptr<WritableFile> file;
+      TF_CHECK_OK(env->NewWritableFile(fname, &file));
+      io::RecordWriter writer(file.get(), options);
+      for (const string& record : records) {
+        TF_EXPECT_OK(writer.WriteRecord(record));
+      }
+      TF_CHECK_OK(writer.Close());
+    }
+
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReader reader(read_file.get(),
+                            GetMatchingReaderOptions(options));
+    uint64 offset = 0;
+    StringPiece record;
+    for (const string& expected : records) {
+      TF_CHECK_OK(reader.ReadRecordView(&offset, &record));
+      EXPECT_EQ(expected, record);
+    }
+    EXPECT_TRUE(
+        errors::IsOutOfRange(reader.ReadRecordView(&offset, &record)));
+  }
+}
+
+TEST(RecordReaderWriterTest, TestAsyncWriter) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_async_test";
+
+  const int kNumRecords = 1000;
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+    io::RecordWriterOptions options;
+    // Small enough that writing all the records exercises backpressure.
+    options.async_buffer_bytes = 256;
+    io::RecordWriter writer(file.get(), options);
+    for (int i = 0; i < kNumRecords; i++) {
+      TF_EXPECT_OK(writer.WriteRecord(strings::StrCat("record-", i)));
+    }
+    TF_CHECK_OK(writer.Flush());
+    TF_CHECK_OK(writer.Close());
+  }
+
+  {
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReader reader(read_file.get(), io::RecordReaderOptions());
+    uint64 offset = 0;
+    string record;
+    for (int i = 0; i < kNumRecords; i++) {
+      TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+      EXPECT_EQ(strings::StrCat("record-", i), record);
+    }
+  }
+}
+
+TEST(RecordReaderWriterTest, TestAsyncZlibWriter) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/record_reader_writer_async_zlib_test";
+
+  const int kNumRecords = 100;
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file));
+
+    io::RecordWriterOptions options;
+    options.compression_type = io::RecordWriterOptions::ZLIB_COMPRESSION;
+    options.async_buffer_bytes = 256;
+    io::RecordWriter writer(file.get(), options);
+    for (int i = 0; i < kNumRecords; i++) {
+      TF_EXPECT_OK(writer.WriteRecord(strings::StrCat("record-", i)));
+    }
+    TF_CHECK_OK(writer.Close());
+  }
+
+  {
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env->NewRandomAccessFile(fname, &read_file));
+    io::RecordReaderOptions options;
+    options.compression_type = io::RecordReaderOptions::ZLIB_COMPRESSION;
+    io::RecordReader reader(read_file.get(), options);
+    uint64 offset = 0;
+    string record;
+    for (int i = 0; i < kNumRecords; i++) {
+      TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+      EXPECT_EQ(strings::StrCat("record-", i), record);
+    }
+  }
+}
+
 TEST(RecordReaderWriterTest, TestUseAfterClose) {
   Env* env = Env::Default();
   string fname = testing::TmpDir() + "/record_reader_writer_flush_close_test";
@@ -26,6 +26,15 @@ namespace {
 bool IsZlibCompressed(RecordWriterOptions options) {
   return options.compression_type == RecordWriterOptions::ZLIB_COMPRESSION;
 }
+
+bool IsSnappyCompressed(RecordWriterOptions options) {
+  return options.compression_type == RecordWriterOptions::SNAPPY_COMPRESSION;
+}
+
+// Size of the uncompressed blocks fed to snappy.  Readers must be able to
+// buffer one whole decompressed block, see record_reader.cc.
+constexpr size_t kSnappyInputBufferSize = 1 << 20;   // 1MB
+constexpr size_t kSnappyOutputBufferSize = 1 << 20;  // 1MB
 }  // namespace
 
 RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
@@ -47,6 +56,8 @@ RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
 #else
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
 #endif  // IS_SLIM_BUILD
+  } else if (compression_type == compression::kSnappy) {
+    options.compression_type = io::RecordWriterOptions::SNAPPY_COMPRESSION;
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
                << ". No compression will be used.";
@@ -56,14 +67,23 @@ RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
 
 RecordWriter::RecordWriter(WritableFile* dest,
                            const RecordWriterOptions& options)
-    : dest_(dest), options_(options) {
+    : dest_(dest), async_dest_(nullptr), options_(options) {
+  if (options.async_buffer_bytes > 0) {
+    // The write-behind buffer sits closest to the file, so that with
+    // compression enabled the deflated bytes are what gets handed off to the
+    // background thread.
+    async_dest_ = new AsyncOutputBuffer(dest_, options.async_buffer_bytes,
+                                        options.async_sync_every_bytes,
+                                        Env::Default());
+    dest_ = async_dest_;
+  }
   if (IsZlibCompressed(options)) {
 // We don't have zlib available on all embedded platforms, so fail.
 #if defined(IS_SLIM_BUILD)
     LOG(FATAL) << "Zlib compression is unsupported on mobile platforms.";
 #else   // IS_SLIM_BUILD
     ZlibOutputBuffer* zlib_output_buffer = new ZlibOutputBuffer(
-        dest, options.zlib_options.input_buffer_size,
+        dest_, options.zlib_options.input_buffer_size,
         options.zlib_options.output_buffer_size, options.zlib_options);
     Status s = zlib_output_buffer->Init();
     if (!s.ok()) {
@@ -72,6 +92,11 @@ RecordWriter::RecordWriter(WritableFile* dest,
     }
     dest_ = zlib_output_buffer;
 #endif  // IS_SLIM_BUILD
+  } else if (IsSnappyCompressed(options)) {
+    // port::Snappy_Compress fails at runtime if snappy was not compiled in,
+    // so no IS_SLIM_BUILD special case is needed here.
+    dest_ = new SnappyOutputBuffer(dest_, kSnappyInputBufferSize,
+                                   kSnappyOutputBufferSize);
   } else if (options.compression_type == RecordWriterOptions::NONE) {
     // Nothing to do
   } else {
@@ -100,8 +125,7 @@ Status RecordWriter::WriteRecord(StringPiece data) {
   //  uint32    masked crc of data
   char header[kHeaderSize];
   char footer[kFooterSize];
-  PopulateHeader(header, data.data(), data.size());
-  PopulateFooter(footer, data.data(), data.size());
+  PopulateHeaderAndFooter(header, footer, data.data(), data.size());
   TF_RETURN_IF_ERROR(dest_->Append(StringPiece(header, sizeof(header))));
   TF_RETURN_IF_ERROR(dest_->Append(data));
   return dest_->Append(StringPiece(footer, sizeof(footer)));
@@ -109,15 +133,26 @@ Status RecordWriter::WriteRecord(StringPiece data) {
 
 Status RecordWriter::Close() {
   if (dest_ == nullptr) return Status::OK();
+  Status s;
 #if !defined(IS_SLIM_BUILD)
   if (IsZlibCompressed(options_)) {
-    Status s = dest_->Close();
+    s = dest_->Close();
     delete dest_;
     dest_ = nullptr;
-    return s;
   }
 #endif  // IS_SLIM_BUILD
-  return Status::OK();
+  if (IsSnappyCompressed(options_)) {
+    s = dest_->Close();
+    delete dest_;
+    dest_ = nullptr;
+  }
+  if (async_dest_ != nullptr) {
+    s.Update(async_dest_->Close());
+    delete async_dest_;
+    async_dest_ = nullptr;
+    dest_ = nullptr;
+  }
+  return s;
 }
 
 Status RecordWriter::Flush() {
@@ -125,8 +160,12 @@ Status RecordWriter::Flush() {
     return Status(::tensorflow::error::FAILED_PRECONDITION,
                   "Writer not initialized or previously closed");
   }
-  if (IsZlibCompressed(options_)) {
-    return dest_->Flush();
+  if (IsZlibCompressed(options_) || IsSnappyCompressed(options_)) {
+    TF_RETURN_IF_ERROR(dest_->Flush());
+  }
+  if (async_dest_ != nullptr) {
+    // Wait for the background thread to drain everything staged so far.
+    return async_dest_->Flush();
   }
   return Status::OK();
 }
@@ -20,6 +20,8 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/io/async_outputbuffer.h"
+#include "tensorflow/core/lib/io/snappy/snappy_outputbuffer.h"
 #if !defined(IS_SLIM_BUILD)
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_outputbuffer.h"
@@ -35,12 +37,29 @@ namespace io {
 
 class RecordWriterOptions {
  public:
-  enum CompressionType { NONE = 0, ZLIB_COMPRESSION = 1 };
+  enum CompressionType {
+    NONE = 0,
+    ZLIB_COMPRESSION = 1,
+    SNAPPY_COMPRESSION = 2
+  };
   CompressionType compression_type = NONE;
 
   static RecordWriterOptions CreateRecordWriterOptions(
       const string& compression_type);
 
+  // If greater than zero, framed (and compressed) output is staged in an
+  // in-memory buffer of this many bytes and written to the file by a
+  // background thread, so that file I/O overlaps with record serialization.
+  // WriteRecord() then only blocks when the buffer is full. Errors from
+  // background writes surface on a later WriteRecord/Flush/Close call.
+  int64 async_buffer_bytes = 0;
+
+  // Only used when async_buffer_bytes is greater than zero. If also greater
+  // than zero, the background thread calls Sync() on the file after every
+  // such number of bytes written, bounding the amount of data lost if the
+  // process dies between flushes.
+  int64 async_sync_every_bytes = 0;
+
 // Options specific to zlib compression.
 #if !defined(IS_SLIM_BUILD)
   tensorflow::io::ZlibCompressionOptions zlib_options;
@@ -90,8 +109,18 @@ class RecordWriter {
   // "footer[0,kFooterSize-1]".  The record-footer is based on data[0, n-1].
   inline static void PopulateFooter(char* footer, const char* data, size_t n);
 
+  // Populates both the record-header and the record-footer for data[0, n-1].
+  // Equivalent to PopulateHeader + PopulateFooter, but the two checksums are
+  // computed in a single batched crc32c call.
+  inline static void PopulateHeaderAndFooter(char* header, char* footer,
+                                             const char* data, size_t n);
+
  private:
   WritableFile* dest_;
+  // Owned write-behind wrapper around the caller's file, or null if async
+  // writing is disabled. When compression is also enabled, dest_ is the
+  // compressing file which in turn appends to async_dest_.
+  AsyncOutputBuffer* async_dest_;
   RecordWriterOptions options_;
 
   inline static uint32 MaskedCrc(const char* data, size_t n) {
@@ -111,6 +140,19 @@ void RecordWriter::PopulateFooter(char* footer, const char* data, size_t n) {
   core::EncodeFixed32(footer, MaskedCrc(data, n));
 }
 
+void RecordWriter::PopulateHeaderAndFooter(char* header, char* footer,
+                                           const char* data, size_t n) {
+  core::EncodeFixed64(header + 0, n);
+  // The length crc and the data crc are independent, so they can share one
+  // batched call and overlap on hardware with CRC instructions.
+  const char* bufs[2] = {header, data};
+  const size_t sizes[2] = {sizeof(uint64), n};
+  uint32 crcs[2];
+  crc32c::ValueMany(bufs, sizes, crcs, 2);
+  core::EncodeFixed32(header + sizeof(uint64), crc32c::Mask(crcs[0]));
+  core::EncodeFixed32(footer, crc32c::Mask(crcs[1]));
+}
+
 }  // namespace io
 }  // namespace tensorflow
 
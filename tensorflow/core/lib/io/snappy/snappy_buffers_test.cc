@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
 #include "tensorflow/core/lib/io/snappy/snappy_inputbuffer.h"
@@ -177,6 +179,50 @@ TEST(SnappyBuffers, CorruptBlock) {
                             " bytes from file. ", "Possible data corruption."));
 }
 
+TEST(SnappyBuffers, ReadNBytesView) {
+  if (!SnappyCompressionSupported()) {
+    fprintf(stderr, "skipping compression tests\n");
+    return;
+  }
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/snappy_view_test";
+  string data = GenTestString(2);
+
+  {
+    std::unique_ptr<WritableFile> file_writer;
+    TF_CHECK_OK(env->NewWritableFile(fname, &file_writer));
+    // A small compress input buffer forces the data into many compressed
+    // blocks, so views have to cross block boundaries below.
+    io::SnappyOutputBuffer out(file_writer.get(), 500, 10000);
+    TF_CHECK_OK(out.Write(StringPiece(data)));
+    TF_CHECK_OK(out.Flush());
+    TF_CHECK_OK(file_writer->Flush());
+    TF_CHECK_OK(file_writer->Close());
+  }
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_CHECK_OK(env->NewRandomAccessFile(fname, &file_reader));
+  io::SnappyInputBuffer in(file_reader.get(), 10000, 10000);
+
+  // Chunk sizes chosen to land both fully inside decompressed blocks (served
+  // as zero-copy views) and across block boundaries (assembled in scratch).
+  for (size_t chunk_size : {1, 100, 300, 750}) {
+    size_t pos = 0;
+    while (pos < data.size()) {
+      size_t n = std::min(chunk_size, data.size() - pos);
+      StringPiece chunk;
+      TF_CHECK_OK(in.ReadNBytesView(n, &chunk));
+      EXPECT_EQ(data.substr(pos, n), chunk);
+      pos += n;
+      EXPECT_EQ(pos, in.Tell());
+    }
+    StringPiece chunk;
+    EXPECT_TRUE(errors::IsOutOfRange(in.ReadNBytesView(1, &chunk)));
+    TF_CHECK_OK(in.Reset());
+    EXPECT_EQ(0, in.Tell());
+  }
+}
+
 TEST(SnappyBuffers, CorruptBlockLargeInputBuffer) {
   if (!SnappyCompressionSupported()) {
     fprintf(stderr, "skipping compression tests\n");
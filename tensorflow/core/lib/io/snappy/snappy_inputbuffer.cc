@@ -47,16 +47,36 @@ Status SnappyInputBuffer::ReadNBytes(int64 bytes_to_read, string* result) {
   return Status::OK();
 }
 
-int64 SnappyInputBuffer::Tell() const {
-  // TODO(srbs): Implement this.
-  return -1;
+Status SnappyInputBuffer::ReadNBytesView(int64 bytes_to_read,
+                                         StringPiece* result) {
+  *result = StringPiece();
+  if (avail_out_ == 0 && bytes_to_read > 0) {
+    TF_RETURN_IF_ERROR(Inflate());
+  }
+  // Serve the request directly out of the decompressed block whenever it is
+  // fully contained in it.
+  if (static_cast<size_t>(bytes_to_read) <= avail_out_) {
+    *result = StringPiece(next_out_, bytes_to_read);
+    next_out_ += bytes_to_read;
+    avail_out_ -= bytes_to_read;
+    bytes_read_ += bytes_to_read;
+    return Status::OK();
+  }
+  // The requested range straddles a decompressed block boundary: assemble it
+  // in the scratch buffer and return a view of that.
+  Status s = ReadNBytes(bytes_to_read, &view_scratch_);
+  *result = StringPiece(view_scratch_);
+  return s;
 }
 
+int64 SnappyInputBuffer::Tell() const { return bytes_read_; }
+
 Status SnappyInputBuffer::Reset() {
   file_pos_ = 0;
   avail_in_ = 0;
   avail_out_ = 0;
   next_in_ = input_buffer_.get();
+  bytes_read_ = 0;
 
   return Status::OK();
 }
@@ -68,6 +88,7 @@ size_t SnappyInputBuffer::ReadBytesFromCache(size_t bytes_to_read,
     result->append(next_out_, can_read_bytes);
     next_out_ += can_read_bytes;
     avail_out_ -= can_read_bytes;
+    bytes_read_ += can_read_bytes;
   }
 
   return can_read_bytes;
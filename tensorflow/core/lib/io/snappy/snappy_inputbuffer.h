@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <string>
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/io/inputstream_interface.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/macros.h"
@@ -56,6 +57,18 @@ class SnappyInputBuffer : public InputStreamInterface {
   //   If reading from file failed.
   Status ReadNBytes(int64 bytes_to_read, string* result) override;
 
+  // Like ReadNBytes, but points *result at the bytes instead of copying them
+  // out.  When the requested range is fully contained in the current
+  // decompressed block -- the common case for record-sized reads -- the view
+  // aliases the internal output buffer and no copy is made; otherwise the
+  // bytes are assembled in an internal scratch buffer first (a single copy).
+  //
+  // The view is invalidated by the next call to ReadNBytes,
+  // ReadNBytesView or Reset.  Error status codes are the same as for
+  // ReadNBytes; on error *result views whatever prefix could be read.
+  Status ReadNBytesView(int64 bytes_to_read, StringPiece* result);
+
+  // Returns the number of (uncompressed) bytes consumed so far.
   int64 Tell() const override;
 
   Status Reset() override;
@@ -119,6 +132,13 @@ class SnappyInputBuffer : public InputStreamInterface {
   // Number of unread bytes bytes available at `next_out_` in `output_buffer_`.
   size_t avail_out_ = 0;
 
+  // Number of uncompressed bytes consumed so far, as reported by Tell().
+  int64 bytes_read_ = 0;
+
+  // Backing storage for ReadNBytesView() results that straddle a
+  // decompressed block boundary.
+  string view_scratch_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(SnappyInputBuffer);
 };
 
@@ -70,12 +70,30 @@ Status SnappyOutputBuffer::Write(StringPiece data) {
   return Status::OK();
 }
 
+Status SnappyOutputBuffer::Append(StringPiece data) { return Write(data); }
+
+Status SnappyOutputBuffer::Close() {
+  // Given that we do not own `file`, we don't close it.
+  return Flush();
+}
+
 Status SnappyOutputBuffer::Flush() {
   TF_RETURN_IF_ERROR(DeflateBuffered());
   TF_RETURN_IF_ERROR(FlushOutputBufferToFile());
   return Status::OK();
 }
 
+Status SnappyOutputBuffer::Name(StringPiece* result) const {
+  return file_->Name(result);
+}
+
+Status SnappyOutputBuffer::Sync() {
+  TF_RETURN_IF_ERROR(Flush());
+  return file_->Sync();
+}
+
+Status SnappyOutputBuffer::Tell(int64* position) { return file_->Tell(position); }
+
 int32 SnappyOutputBuffer::AvailableInputSpace() const {
   return input_buffer_capacity_ - avail_in_;
 }
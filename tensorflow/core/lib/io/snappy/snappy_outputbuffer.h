@@ -19,6 +19,7 @@ limitations under the License.
 #include <string>
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/types.h"
@@ -43,7 +44,10 @@ namespace io {
 // _compressed_ block _excluding_ this header. The compressed
 // block (excluding the 4 byte header) is a valid snappy block and can directly
 // be uncompressed using Snappy_Uncompress.
-class SnappyOutputBuffer {
+//
+// The class is also a WritableFile, so it can be stacked under other
+// file wrappers wherever one is expected (e.g. RecordWriter).
+class SnappyOutputBuffer : public WritableFile {
  public:
   // Create an SnappyOutputBuffer for `file` with two buffers that cache the
   // 1. input data to be deflated
@@ -63,9 +67,28 @@ class SnappyOutputBuffer {
   // To immediately write contents to file call `Flush()`.
   Status Write(StringPiece data);
 
+  // WritableFile interface.  Writes through the compression pipeline; the
+  // wrapped file itself is not closed by Close().
+
+  // Equivalent to Write().
+  Status Append(StringPiece data) override;
+
+  // Compresses any cached input and writes all output to file.
+  Status Close() override;
+
   // Compresses any cached input and writes all output to file. This must be
   // called before the destructor to avoid any data loss.
-  Status Flush();
+  Status Flush() override;
+
+  // Returns the name of the underlying file.
+  Status Name(StringPiece* result) const override;
+
+  // Compresses any cached input, writes all output to file and syncs it.
+  Status Sync() override;
+
+  // Returns the write position in the underlying file. The position does not
+  // reflect buffered, un-compressed data.
+  Status Tell(int64* position) override;
 
  private:
   // Appends `data` to `input_buffer_`.
@@ -18,6 +18,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/coding.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/io/block.h"
+#include "tensorflow/core/lib/io/filter_block.h"
 #include "tensorflow/core/lib/io/format.h"
 #include "tensorflow/core/lib/io/table_options.h"
 #include "tensorflow/core/lib/io/two_level_iterator.h"
@@ -27,12 +28,18 @@ namespace tensorflow {
 namespace table {
 
 struct Table::Rep {
-  ~Rep() { delete index_block; }
+  ~Rep() {
+    delete filter;
+    delete[] filter_data;
+    delete index_block;
+  }
 
   Options options;
   Status status;
   RandomAccessFile* file;
   // XXX  uint64 cache_id;
+  FilterBlockReader* filter;
+  const char* filter_data;
 
   BlockHandle metaindex_handle;  // Handle to metaindex_block: saved from footer
   Block* index_block;
@@ -75,7 +82,10 @@ Status Table::Open(const Options& options, RandomAccessFile* file, uint64 size,
     rep->index_block = index_block;
     // XXX    rep->cache_id = (options.block_cache ?
     // options.block_cache->NewId() : 0);
+    rep->filter_data = nullptr;
+    rep->filter = nullptr;
     *table = new Table(rep);
+    (*table)->ReadMeta(footer);
   } else {
     if (index_block) delete index_block;
   }
@@ -83,6 +93,46 @@ Status Table::Open(const Options& options, RandomAccessFile* file, uint64 size,
   return s;
 }
 
+void Table::ReadMeta(const Footer& footer) {
+  if (rep_->options.filter_bits_per_key <= 0) {
+    return;  // Do not need any metadata
+  }
+
+  BlockContents contents;
+  if (!ReadBlock(rep_->file, footer.metaindex_handle(), &contents).ok()) {
+    // Do not propagate errors since meta info is not needed for operation
+    return;
+  }
+  Block* meta = new Block(contents);
+
+  Iterator* iter = meta->NewIterator();
+  iter->Seek(kFilterBlockMetaKey);
+  if (iter->Valid() && iter->key() == StringPiece(kFilterBlockMetaKey)) {
+    ReadFilter(iter->value());
+  }
+  delete iter;
+  delete meta;
+}
+
+void Table::ReadFilter(const StringPiece& filter_handle_value) {
+  StringPiece v = filter_handle_value;
+  BlockHandle filter_handle;
+  if (!filter_handle.DecodeFrom(&v).ok()) {
+    return;
+  }
+
+  // We might want to unify with ReadBlock() if we start
+  // requiring checksum verification in Table::Open.
+  BlockContents block;
+  if (!ReadBlock(rep_->file, filter_handle, &block).ok()) {
+    return;
+  }
+  if (block.heap_allocated) {
+    rep_->filter_data = block.data.data();  // Will need to delete later
+  }
+  rep_->filter = new FilterBlockReader(block.data);
+}
+
 Table::~Table() { delete rep_; }
 
 static void DeleteBlock(void* arg, void* ignored) {
@@ -133,13 +183,21 @@ Status Table::InternalGet(const StringPiece& k, void* arg,
   Iterator* iiter = rep_->index_block->NewIterator();
   iiter->Seek(k);
   if (iiter->Valid()) {
-    Iterator* block_iter = BlockReader(this, iiter->value());
-    block_iter->Seek(k);
-    if (block_iter->Valid()) {
-      (*saver)(arg, block_iter->key(), block_iter->value());
+    StringPiece handle_value = iiter->value();
+    FilterBlockReader* filter = rep_->filter;
+    BlockHandle handle;
+    if (filter != nullptr && handle.DecodeFrom(&handle_value).ok() &&
+        !filter->KeyMayMatch(handle.offset(), k)) {
+      // Not found; the filter block lets us skip reading the data block.
+    } else {
+      Iterator* block_iter = BlockReader(this, iiter->value());
+      block_iter->Seek(k);
+      if (block_iter->Valid()) {
+        (*saver)(arg, block_iter->key(), block_iter->value());
+      }
+      s = block_iter->status();
+      delete block_iter;
     }
-    s = block_iter->status();
-    delete block_iter;
   }
   if (s.ok()) {
     s = iiter->status();
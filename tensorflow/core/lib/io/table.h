@@ -62,6 +62,14 @@ class Table {
   // be close to the file length.
   uint64 ApproximateOffsetOf(const StringPiece& key) const;
 
+  // Calls (*handle_result)(arg, ...) with the entry found after a call
+  // to Seek(key).  May not make such a call if the table's Bloom filter
+  // block reports that the key is not present, in which case the data
+  // block is not read at all.
+  Status InternalGet(const StringPiece& key, void* arg,
+                     void (*handle_result)(void* arg, const StringPiece& k,
+                                           const StringPiece& v));
+
  private:
   struct Rep;
   Rep* rep_;
@@ -69,12 +77,8 @@ class Table {
   explicit Table(Rep* rep) { rep_ = rep; }
   static Iterator* BlockReader(void*, const StringPiece&);
 
-  // Calls (*handle_result)(arg, ...) with the entry found after a call
-  // to Seek(key).  May not make such a call if filter policy says
-  // that key is not present.
-  Status InternalGet(const StringPiece& key, void* arg,
-                     void (*handle_result)(void* arg, const StringPiece& k,
-                                           const StringPiece& v));
+  void ReadMeta(const Footer& footer);
+  void ReadFilter(const StringPiece& filter_handle_value);
 
   // No copying allowed
   Table(const Table&);
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/io/block_builder.h"
+#include "tensorflow/core/lib/io/filter_block.h"
 #include "tensorflow/core/lib/io/format.h"
 #include "tensorflow/core/lib/io/table_options.h"
 #include "tensorflow/core/platform/env.h"
@@ -75,6 +76,7 @@ struct TableBuilder::Rep {
   Status status;
   BlockBuilder data_block;
   BlockBuilder index_block;
+  FilterBlockBuilder* filter_block;  // Null if filters are disabled
   string last_key;
   int64 num_entries;
   bool closed;  // Either Finish() or Abandon() has been called.
@@ -100,15 +102,24 @@ struct TableBuilder::Rep {
         offset(0),
         data_block(&options),
         index_block(&index_block_options),
+        filter_block(opt.filter_bits_per_key > 0
+                         ? new FilterBlockBuilder(opt.filter_bits_per_key)
+                         : nullptr),
         num_entries(0),
         closed(false),
         pending_index_entry(false) {
     index_block_options.block_restart_interval = 1;
   }
+
+  ~Rep() { delete filter_block; }
 };
 
 TableBuilder::TableBuilder(const Options& options, WritableFile* file)
-    : rep_(new Rep(options, file)) {}
+    : rep_(new Rep(options, file)) {
+  if (rep_->filter_block != nullptr) {
+    rep_->filter_block->StartBlock(0);
+  }
+}
 
 TableBuilder::~TableBuilder() {
   assert(rep_->closed);  // Catch errors where caller forgot to call Finish()
@@ -139,6 +150,10 @@ void TableBuilder::Add(const StringPiece& key, const StringPiece& value) {
     r->pending_index_entry = false;
   }
 
+  if (r->filter_block != nullptr) {
+    r->filter_block->AddKey(key);
+  }
+
   r->last_key.assign(key.data(), key.size());
   r->num_entries++;
   r->data_block.Add(key, value);
@@ -160,6 +175,9 @@ void TableBuilder::Flush() {
     r->pending_index_entry = true;
     // We don't flush the underlying file as that can be slow.
   }
+  if (r->filter_block != nullptr) {
+    r->filter_block->StartBlock(r->offset);
+  }
 }
 
 void TableBuilder::WriteBlock(BlockBuilder* block, BlockHandle* handle) {
@@ -225,11 +243,22 @@ Status TableBuilder::Finish() {
   assert(!r->closed);
   r->closed = true;
 
-  BlockHandle metaindex_block_handle, index_block_handle;
+  BlockHandle filter_block_handle, metaindex_block_handle, index_block_handle;
+
+  // Write filter block
+  if (ok() && r->filter_block != nullptr) {
+    WriteRawBlock(r->filter_block->Finish(), kNoCompression,
+                  &filter_block_handle);
+  }
 
   // Write metaindex block
   if (ok()) {
     BlockBuilder meta_index_block(&r->options);
+    if (r->filter_block != nullptr) {
+      string handle_encoding;
+      filter_block_handle.EncodeTo(&handle_encoding);
+      meta_index_block.Add(kFilterBlockMetaKey, StringPiece(handle_encoding));
+    }
     // TODO(postrelease): Add stats and other meta blocks
     WriteBlock(&meta_index_block, &metaindex_block_handle);
   }
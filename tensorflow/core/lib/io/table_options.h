@@ -60,6 +60,17 @@ struct Options {
   // incompressible, the kSnappyCompression implementation will
   // efficiently detect that and will switch to uncompressed mode.
   CompressionType compression = kSnappyCompression;
+
+  // If non-zero, build a Bloom filter with approximately this many bits
+  // per key and store it in a filter meta block.  Negative lookups through
+  // Table::InternalGet can then usually be answered without reading any
+  // data block.  A good value is 10, which yields a filter with a ~1%
+  // false positive rate.
+  //
+  // The same option must be non-zero when opening a table for the filter
+  // block to be consulted; tables written with filters remain fully
+  // readable by readers that leave it at zero.
+  int filter_bits_per_key = 0;
 };
 
 }  // namespace table
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/table_builder.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/test.h"
@@ -632,5 +633,85 @@ TEST(TableTest, SeekToFirstKeyDoesNotReadTooMuch) {
   EXPECT_LT(c.BytesRead(), 200);
 }
 
+static void SaveValue(void* arg, const StringPiece& k, const StringPiece& v) {
+  string* result = reinterpret_cast<string*>(arg);
+  result->assign(v.data(), v.size());
+}
+
+TEST(TableTest, FilterBlockSkipsDataReadsOnNegativeLookups) {
+  Options options;
+  options.block_size = 1024;
+  options.compression = kNoCompression;
+  options.filter_bits_per_key = 10;
+
+  StringSink sink;
+  TableBuilder builder(options, &sink);
+  for (int i = 0; i < 1000; i++) {
+    // Keys have equal width so numeric order matches lexicographic order.
+    builder.Add(strings::StrCat("key", 100000 + i),
+                strings::StrCat("value", i));
+    TF_CHECK_OK(builder.status());
+  }
+  TF_ASSERT_OK(builder.Finish());
+
+  StringSource source(sink.contents());
+  Table* table = nullptr;
+  TF_ASSERT_OK(Table::Open(options, &source, sink.contents().size(), &table));
+
+  // Positive lookups still find their entries.
+  for (int i = 0; i < 1000; i += 97) {
+    string value;
+    TF_ASSERT_OK(table->InternalGet(strings::StrCat("key", 100000 + i), &value,
+                                    SaveValue));
+    EXPECT_EQ(value, strings::StrCat("value", i));
+  }
+
+  // Negative lookups should almost always be rejected by the Bloom filters
+  // without touching any data block. With 10 bits per key the false positive
+  // rate is ~1%, so allow for a few blocks to be read.
+  const uint64 bytes_before = source.BytesRead();
+  for (int i = 0; i < 100; i++) {
+    string value;
+    TF_ASSERT_OK(
+        table->InternalGet(strings::StrCat("nosuchkey", i), &value, SaveValue));
+    EXPECT_EQ(value, "");
+  }
+  EXPECT_LT(source.BytesRead() - bytes_before,
+            10 * (options.block_size + kBlockTrailerSize));
+
+  delete table;
+}
+
+TEST(TableTest, TablesWithFiltersAreReadableWithoutThem) {
+  Options write_options;
+  write_options.block_size = 1024;
+  write_options.compression = kNoCompression;
+  write_options.filter_bits_per_key = 10;
+
+  StringSink sink;
+  TableBuilder builder(write_options, &sink);
+  for (int i = 0; i < 100; i++) {
+    builder.Add(strings::StrCat("key", 100000 + i), strings::StrCat("v", i));
+    TF_CHECK_OK(builder.status());
+  }
+  TF_ASSERT_OK(builder.Finish());
+
+  // A reader that does not enable filters simply ignores the filter block.
+  StringSource source(sink.contents());
+  Table* table = nullptr;
+  TF_ASSERT_OK(
+      Table::Open(Options(), &source, sink.contents().size(), &table));
+  Iterator* iter = table->NewIterator();
+  int found = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    EXPECT_EQ(iter->value(), strings::StrCat("v", found));
+    found++;
+  }
+  TF_ASSERT_OK(iter->status());
+  EXPECT_EQ(found, 100);
+  delete iter;
+  delete table;
+}
+
 }  // namespace table
 }  // namespace tensorflow
@@ -106,6 +106,29 @@ TEST(ZlibBuffers, Gzip) {
   TestAllCombinations(CompressionOptions::GZIP(), CompressionOptions::GZIP());
 }
 
+TEST(ZlibBuffers, PresetDictionary) {
+  CompressionOptions input_options = CompressionOptions::DEFAULT();
+  CompressionOptions output_options = CompressionOptions::DEFAULT();
+  input_options.dictionary = GetRecord();
+  output_options.dictionary = GetRecord();
+  TestAllCombinations(input_options, output_options);
+}
+
+TEST(ZlibBuffers, PresetDictionaryRawDeflate) {
+  CompressionOptions input_options = CompressionOptions::RAW();
+  CompressionOptions output_options = CompressionOptions::RAW();
+  input_options.dictionary = GetRecord();
+  output_options.dictionary = GetRecord();
+  TestAllCombinations(input_options, output_options);
+}
+
+TEST(ZlibBuffers, FullFlushMarkers) {
+  CompressionOptions output_options = CompressionOptions::DEFAULT();
+  // Small enough that every test string spans several markers.
+  output_options.full_flush_bytes = 256;
+  TestAllCombinations(CompressionOptions::DEFAULT(), output_options);
+}
+
 void TestMultipleWrites(uint8 input_buf_size, uint8 output_buf_size,
                         int num_writes, bool with_flush = false) {
   Env* env = Env::Default();
@@ -192,6 +215,38 @@ TEST(ZlibInputStream, FailsToReadIfWindowBitsAreIncompatible) {
   CHECK(read_status.error_message().find("inflate() failed") != string::npos);
 }
 
+TEST(ZlibInputStream, FailsToReadIfDictionaryIsMissing) {
+  Env* env = Env::Default();
+  string fname = testing::TmpDir() + "/zlib_buffers_test";
+  CompressionOptions output_options = CompressionOptions::DEFAULT();
+  // The reader is not configured with the writer's dictionary.
+  CompressionOptions input_options = CompressionOptions::DEFAULT();
+  int input_buf_size = 200, output_buf_size = 200;
+  output_options.dictionary = GetRecord();
+
+  string data = GenTestString(10);
+  std::unique_ptr<WritableFile> file_writer;
+  TF_ASSERT_OK(env->NewWritableFile(fname, &file_writer));
+  string result;
+  ZlibOutputBuffer out(file_writer.get(), input_buf_size, output_buf_size,
+                       output_options);
+  TF_ASSERT_OK(out.Init());
+
+  TF_ASSERT_OK(out.Append(StringPiece(data)));
+  TF_ASSERT_OK(out.Close());
+  TF_ASSERT_OK(file_writer->Flush());
+  TF_ASSERT_OK(file_writer->Close());
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &file_reader));
+  std::unique_ptr<RandomAccessInputStream> input_stream(
+      new RandomAccessInputStream(file_reader.get()));
+  ZlibInputStream in(input_stream.get(), input_buf_size, output_buf_size,
+                     input_options);
+  Status read_status = in.ReadNBytes(data.size(), &result);
+  CHECK_EQ(read_status.code(), error::DATA_LOSS);
+}
+
 void WriteCompressedFile(Env* env, const string& fname, int input_buf_size,
                          int output_buf_size,
                          const CompressionOptions& output_options,
@@ -110,6 +110,22 @@ class ZlibCompressionOptions {
   // appropriately. Z_FIXED prevents the use of dynamic Huffman codes, allowing
   // for a simpler decoder for special applications.
   int8 compression_strategy;
+
+  // If non-empty, a preset dictionary used to prime the compression history
+  // before any input is consumed. The decompressing side must be configured
+  // with the same dictionary. Most useful for improving the compression ratio
+  // of many small records that share common substrings.
+  string dictionary;
+
+  // If greater than zero, a Z_FULL_FLUSH marker is emitted once at least this
+  // many uncompressed bytes have been compressed since the previous marker.
+  // A full flush erases the compression history, so the data following a
+  // marker can be decompressed without the data preceding it. A writer that
+  // records the compressed offset of each marker (via Tell() after a Flush())
+  // produces chunks that readers can decompress independently, e.g. on
+  // multiple threads. Each marker costs a few bytes and resets the history,
+  // slightly degrading the compression ratio.
+  int64 full_flush_bytes = 0;
 };
 
 inline ZlibCompressionOptions ZlibCompressionOptions::DEFAULT() {
@@ -106,6 +106,19 @@ void ZlibInputStream::InitZlibBuffer() {
 
   CHECK_EQ(status, Z_OK) << "inflateInit failed with status " << status;
 
+  if (zlib_options_.window_bits < 0 && !zlib_options_.dictionary.empty()) {
+    // Raw deflate streams carry no dictionary checkpoint, so a preset
+    // dictionary has to be installed before any input is inflated. Streams
+    // with a zlib header announce their dictionary via Z_NEED_DICT instead,
+    // which is handled in Inflate().
+    status = inflateSetDictionary(
+        z_stream_def_->stream.get(),
+        reinterpret_cast<const Bytef*>(zlib_options_.dictionary.data()),
+        zlib_options_.dictionary.size());
+    CHECK_EQ(status, Z_OK) << "inflateSetDictionary failed with status "
+                           << status;
+  }
+
   z_stream_def_->stream->next_in = z_stream_def_->input.get();
   z_stream_def_->stream->next_out = z_stream_def_->output.get();
   next_unread_byte_ = reinterpret_cast<char*>(z_stream_def_->output.get());
@@ -224,6 +237,19 @@ int64 ZlibInputStream::Tell() const { return bytes_read_; }
 
 Status ZlibInputStream::Inflate() {
   int error = inflate(z_stream_def_->stream.get(), zlib_options_.flush_mode);
+  if (error == Z_NEED_DICT && !zlib_options_.dictionary.empty()) {
+    // The stream was compressed against a preset dictionary. Install it and
+    // resume inflating. If the configured dictionary does not match the one
+    // announced by the stream, inflateSetDictionary returns Z_DATA_ERROR and
+    // the error path below reports it.
+    error = inflateSetDictionary(
+        z_stream_def_->stream.get(),
+        reinterpret_cast<const Bytef*>(zlib_options_.dictionary.data()),
+        zlib_options_.dictionary.size());
+    if (error == Z_OK) {
+      error = inflate(z_stream_def_->stream.get(), zlib_options_.flush_mode);
+    }
+  }
   if (error != Z_OK && error != Z_STREAM_END) {
     string error_string =
         strings::StrCat("inflate() failed with error ", error);
@@ -33,6 +33,7 @@ ZlibOutputBuffer::ZlibOutputBuffer(
       z_stream_input_(new Bytef[input_buffer_bytes]),
       z_stream_output_(new Bytef[output_buffer_bytes]),
       zlib_options_(zlib_options),
+      uncompressed_bytes_since_full_flush_(0),
       z_stream_(new z_stream) {}
 
 ZlibOutputBuffer::~ZlibOutputBuffer() {
@@ -61,6 +62,18 @@ Status ZlibOutputBuffer::Init() {
     z_stream_.reset(nullptr);
     return errors::InvalidArgument("deflateInit failed with status", status);
   }
+  if (!zlib_options_.dictionary.empty()) {
+    status = deflateSetDictionary(
+        z_stream_.get(),
+        reinterpret_cast<const Bytef*>(zlib_options_.dictionary.data()),
+        zlib_options_.dictionary.size());
+    if (status != Z_OK) {
+      deflateEnd(z_stream_.get());
+      z_stream_.reset(nullptr);
+      return errors::InvalidArgument("deflateSetDictionary failed with status ",
+                                     status);
+    }
+  }
   z_stream_->next_in = z_stream_input_.get();
   z_stream_->next_out = z_stream_output_.get();
   z_stream_->avail_in = 0;
@@ -106,8 +119,7 @@ void ZlibOutputBuffer::AddToInputBuffer(StringPiece data) {
   z_stream_->avail_in += bytes_to_write;
 }
 
-Status ZlibOutputBuffer::DeflateBuffered(bool last) {
-  int flush_mode = last ? Z_FINISH : zlib_options_.flush_mode;
+Status ZlibOutputBuffer::DeflateBuffered(int flush_mode) {
   do {
     // From zlib manual (http://www.zlib.net/manual.html):
     //
@@ -157,15 +169,15 @@ Status ZlibOutputBuffer::Append(StringPiece data) {
 
   if (bytes_to_write <= AvailableInputSpace()) {
     AddToInputBuffer(data);
-    return Status::OK();
+    return MaybeEmitFullFlushMarker(bytes_to_write);
   }
 
-  TF_RETURN_IF_ERROR(DeflateBuffered());
+  TF_RETURN_IF_ERROR(DeflateBuffered(zlib_options_.flush_mode));
 
   // At this point input stream should be empty.
   if (bytes_to_write <= AvailableInputSpace()) {
     AddToInputBuffer(data);
-    return Status::OK();
+    return MaybeEmitFullFlushMarker(bytes_to_write);
   }
 
   // `data` is too large to fit in input buffer so we deflate it directly.
@@ -188,11 +200,27 @@ Status ZlibOutputBuffer::Append(StringPiece data) {
   // Restore z_stream input pointers.
   z_stream_->next_in = z_stream_input_.get();
 
+  return MaybeEmitFullFlushMarker(bytes_to_write);
+}
+
+Status ZlibOutputBuffer::MaybeEmitFullFlushMarker(size_t appended_bytes) {
+  if (zlib_options_.full_flush_bytes <= 0) {
+    return Status::OK();
+  }
+  uncompressed_bytes_since_full_flush_ += appended_bytes;
+  if (uncompressed_bytes_since_full_flush_ < zlib_options_.full_flush_bytes) {
+    return Status::OK();
+  }
+  // Deflate everything buffered so far and emit a full flush marker. This
+  // erases the compression history, so the output that follows can be
+  // decompressed without the output that precedes the marker.
+  TF_RETURN_IF_ERROR(DeflateBuffered(Z_FULL_FLUSH));
+  uncompressed_bytes_since_full_flush_ = 0;
   return Status::OK();
 }
 
 Status ZlibOutputBuffer::Flush() {
-  TF_RETURN_IF_ERROR(DeflateBuffered());
+  TF_RETURN_IF_ERROR(DeflateBuffered(zlib_options_.flush_mode));
   TF_RETURN_IF_ERROR(FlushOutputBufferToFile());
   return Status::OK();
 }
@@ -208,7 +236,7 @@ Status ZlibOutputBuffer::Sync() {
 
 Status ZlibOutputBuffer::Close() {
   if (z_stream_) {
-    TF_RETURN_IF_ERROR(DeflateBuffered(true));
+    TF_RETURN_IF_ERROR(DeflateBuffered(Z_FINISH));
     TF_RETURN_IF_ERROR(FlushOutputBufferToFile());
     deflateEnd(z_stream_.get());
     z_stream_.reset(nullptr);
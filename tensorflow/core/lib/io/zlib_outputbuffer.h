@@ -104,6 +104,10 @@ class ZlibOutputBuffer : public WritableFile {
 
   ZlibCompressionOptions const zlib_options_;
 
+  // Number of uncompressed bytes appended since the last Z_FULL_FLUSH marker.
+  // Only maintained if zlib_options_.full_flush_bytes is greater than zero.
+  int64 uncompressed_bytes_since_full_flush_;
+
   // Configuration passed to `deflate`.
   //
   // z_stream_->next_in:
@@ -132,7 +136,13 @@ class ZlibOutputBuffer : public WritableFile {
   //
   // Note: This method does not flush contents to file.
   // Returns non-ok status if writing contents to file fails.
-  Status DeflateBuffered(bool last = false);
+  Status DeflateBuffered(int flush_mode);
+
+  // Called after `appended_bytes` bytes have been added to the compression
+  // pipeline. If `zlib_options_.full_flush_bytes` is positive and at least
+  // that many bytes have accumulated since the last marker, deflates all
+  // buffered input with Z_FULL_FLUSH to create an independent restart point.
+  Status MaybeEmitFullFlushMarker(size_t appended_bytes);
 
   // Appends contents of `z_stream_output_` to `file_`.
   // Returns non-OK status if writing to file fails.
@@ -91,7 +91,7 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
   // unpack the argball
   const int datasize = argball->datasize_;
   const auto& flags = argball->flags_;
-  const int ratio = flags.ratio;
+  int ratio = flags.ratio;
   int components = flags.components;
   int stride = flags.stride;              // may be 0
   int64* const nwarn = argball->pnwarn_;  // may be NULL
@@ -159,6 +159,29 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
       return nullptr;
   }
   cinfo.do_fancy_upsampling = boolean(flags.fancy_upscaling);
+
+  // If the caller only needs an image at least min_output_width x
+  // min_output_height large (e.g. because it will be resized down
+  // afterwards), raise the downscaling ratio to the cheapest one that still
+  // honors that size. libjpeg rounds scaled dimensions up.
+  if (!flags.crop && flags.min_output_width > 0 &&
+      flags.min_output_height > 0) {
+    while (ratio < 8) {
+      const int next_ratio = ratio * 2;
+      const int64 scaled_width =
+          (static_cast<int64>(cinfo.image_width) + next_ratio - 1) /
+          next_ratio;
+      const int64 scaled_height =
+          (static_cast<int64>(cinfo.image_height) + next_ratio - 1) /
+          next_ratio;
+      if (scaled_width < flags.min_output_width ||
+          scaled_height < flags.min_output_height) {
+        break;
+      }
+      ratio = next_ratio;
+    }
+  }
+
   cinfo.scale_num = 1;
   cinfo.scale_denom = ratio;
   cinfo.dct_method = flags.dct_method;
@@ -38,6 +38,15 @@ struct UncompressFlags {
   // size in both directions).
   int ratio = 1;
 
+  // If both are positive, `ratio` is raised to the largest value libjpeg
+  // supports (2, 4 or 8) whose scaled output is still at least
+  // min_output_width x min_output_height. Callers that resize the decoded
+  // image down to a known size can use this to skip most of the decode work
+  // without changing the final result of the resize. Ignored when `crop` is
+  // set, since the crop window is expressed in the scaled coordinate space.
+  int min_output_width = 0;
+  int min_output_height = 0;
+
   // The number of bytes per pixel (1, 3 or 4), or 0 for autodetect.
   int components = 0;
 
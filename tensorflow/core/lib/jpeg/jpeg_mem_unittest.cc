@@ -199,6 +199,49 @@ TEST(JpegMemTest, CropAndDecodeJpegWithRatio) {
   }
 }
 
+TEST(JpegMemTest, DecodeWithMinOutputSize) {
+  Env* env = Env::Default();
+  const string data_path = kTestData;
+  string jpeg;
+  ReadFileToStringOrDie(env, data_path + "jpeg_merge_test1.jpg", &jpeg);
+  const int fsize = jpeg.size();
+  const uint8* const temp = bit_cast<const uint8*>(jpeg.data());
+
+  // Full-size decode to learn the image dimensions.
+  UncompressFlags flags;
+  flags.components = 3;
+  int w, h, c;
+  std::unique_ptr<uint8[]> imgdata;
+  imgdata.reset(Uncompress(temp, fsize, flags, &w, &h, &c, nullptr));
+  ASSERT_NE(imgdata, nullptr);
+
+  // A hint of half the image size is served at ratio 2; libjpeg rounds
+  // scaled dimensions up.
+  flags.min_output_height = (h + 1) / 2;
+  flags.min_output_width = (w + 1) / 2;
+  int w2, h2, c2;
+  imgdata.reset(Uncompress(temp, fsize, flags, &w2, &h2, &c2, nullptr));
+  ASSERT_NE(imgdata, nullptr);
+  EXPECT_EQ(w2, (w + 1) / 2);
+  EXPECT_EQ(h2, (h + 1) / 2);
+
+  // A tiny hint saturates at the largest supported ratio, 8.
+  flags.min_output_height = 1;
+  flags.min_output_width = 1;
+  imgdata.reset(Uncompress(temp, fsize, flags, &w2, &h2, &c2, nullptr));
+  ASSERT_NE(imgdata, nullptr);
+  EXPECT_EQ(w2, (w + 7) / 8);
+  EXPECT_EQ(h2, (h + 7) / 8);
+
+  // A hint at least as large as the image keeps the full resolution.
+  flags.min_output_height = h;
+  flags.min_output_width = w;
+  imgdata.reset(Uncompress(temp, fsize, flags, &w2, &h2, &c2, nullptr));
+  ASSERT_NE(imgdata, nullptr);
+  EXPECT_EQ(w2, w);
+  EXPECT_EQ(h2, h);
+}
+
 TEST(JpegMemTest, CropAndDecodeJpegWithComponents) {
   Env* env = Env::Default();
   const string data_path = kTestData;
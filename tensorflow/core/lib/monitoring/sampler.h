@@ -62,7 +62,9 @@ class SamplerCell {
   HistogramProto value() const;
 
  private:
-  histogram::ThreadSafeHistogram histogram_;
+  // Sharded so that concurrent Add() calls from many threads do not
+  // serialize on a single histogram mutex.
+  histogram::ShardedHistogram histogram_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(SamplerCell);
 };
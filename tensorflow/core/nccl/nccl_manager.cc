@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/nccl/nccl_manager.h"
 
+#include <algorithm>
 #include <utility>
 
 #ifdef GOOGLE_CUDA
@@ -21,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/cuda.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -42,6 +44,14 @@ namespace tensorflow {
 
 using se::cuda::ScopedActivateExecutorContext;
 
+// One entry in a stream's launch queue: either a single collective or a
+// fused group of collectives, for the given participant rank.
+struct NcclManager::LaunchItem {
+  Collective* collective = nullptr;
+  FusedCollective* fused = nullptr;
+  int participant_idx = 0;
+};
+
 // Contains data for a single stream used for nccl communication; this includes
 // a background thread that calls NcclManager::LoopKernelLaunches.
 struct NcclManager::NcclStream {
@@ -59,12 +69,18 @@ struct NcclManager::NcclStream {
   // This is a different stream than the tensorflow compute stream.
   std::unique_ptr<se::Stream> stream;
 
+  // Device scratch buffer of TF_NCCL_FUSION_THRESHOLD_BYTES used to pack
+  // fused all-reduces (see EnsureFusionBuffersLocked).  Work on this stream
+  // is serialized by the launch thread, so consecutive fused launches may
+  // reuse the buffer.  Like the communicators, it is kept for the life of
+  // the process.
+  void* fusion_buffer = nullptr;
+
   // See NcclManager::LoopKernelLaunches for information on these.
   std::unique_ptr<Thread> thread;
   mutex mu;
   condition_variable cv;
-  // Has collective,participant_idx pairs.
-  std::deque<std::pair<Collective*, int>> pending_launches_ GUARDED_BY(mu);
+  std::deque<LaunchItem> pending_launches_ GUARDED_BY(mu);
   bool shutdown_requested GUARDED_BY(mu) = false;
 };
 
@@ -179,8 +195,49 @@ struct NcclManager::Collective {
   Status status;
 };
 
-NcclManager::NcclManager() {}
-NcclManager::~NcclManager() {}
+// A group of all-reduce `Collective`s launched as a single NCCL call per
+// device: each rank packs its inputs into the stream's fusion buffer,
+// all-reduces the buffer once, and unpacks into the outputs.  All members
+// share a communicator, data type and reduction op.
+struct NcclManager::FusedCollective {
+  explicit FusedCollective(int num_ranks) : remaining_ranks(num_ranks) {}
+
+  std::vector<Collective*> collectives;
+  Communicator* communicator = nullptr;
+  DataType data_type = DT_FLOAT;
+  ncclRedOp_t reduction_op = ncclSum;
+  int64 total_elements = 0;
+
+  // Number of device ranks whose done callbacks have not run yet; the last
+  // one deletes this object.
+  mutable std::atomic_int_fast32_t remaining_ranks;
+};
+
+NcclManager::NcclManager() {
+  // Fusion of small all-reduces is enabled by setting
+  // TF_NCCL_FUSION_THRESHOLD_BYTES to a positive number of bytes: all-reduce
+  // tensors no larger than the threshold are packed into a per-device fusion
+  // buffer of that size and reduced with one ncclAllReduce per bucket.  A
+  // bucket is launched when it fills up or when it has been pending for
+  // TF_NCCL_FUSION_TIMEOUT_USECS (default 500us), whichever comes first.
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_NCCL_FUSION_THRESHOLD_BYTES", 0,
+                                  &fusion_threshold_bytes_));
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_NCCL_FUSION_TIMEOUT_USECS", 500,
+                                  &fusion_timeout_usecs_));
+  if (fusion_threshold_bytes_ > 0) {
+    fusion_thread_.reset(Env::Default()->StartThread(
+        ThreadOptions(), "nccl_fusion_flush", [this] { FusionFlushLoop(); }));
+  }
+}
+
+NcclManager::~NcclManager() {
+  {
+    mutex_lock l(launch_mu_);
+    fusion_shutdown_ = true;
+    fusion_cv_.notify_all();
+  }
+  fusion_thread_.reset();
+}
 NcclManager* NcclManager::instance() {
   static NcclManager* instance = new NcclManager();
   return instance;
@@ -488,8 +545,6 @@ NcclManager::Collective* NcclManager::CheckReady(const string& collective_key,
 }
 
 void NcclManager::RunCollective(Collective* collective) {
-  static mutex collective_mu(LINKER_INITIALIZED);
-
   Status s = collective->status;
   if (s.ok()) {
     s = GetCommunicator(collective, &collective->communicator);
@@ -529,13 +584,143 @@ void NcclManager::RunCollective(Collective* collective) {
     // is to prevent collectives from deadlocking each other.
     // Note that it would be possible to run multiple collectives at once, if
     // they have non-intersecting sets of devices.
-    mutex_lock l(collective_mu);
-    for (int i = 0; i < collective->num_local_devices; ++i) {
-      NcclStream* nccl_stream =
-          collective->communicator->members[i].nccl_stream;
-      mutex_lock l(nccl_stream->mu);
-      nccl_stream->pending_launches_.push_front(std::make_pair(collective, i));
-      nccl_stream->cv.notify_all();
+    mutex_lock l(launch_mu_);
+    if (CanFuseLocked(collective)) {
+      Communicator* communicator = collective->communicator;
+      FusionGroup* group = &pending_fusion_[communicator];
+      const int64 bytes = collective->participants[0]->input->TotalBytes();
+      const bool matches =
+          group->collectives.empty() ||
+          (group->collectives[0]->data_type == collective->data_type &&
+           group->collectives[0]->reduction_op == collective->reduction_op);
+      if (!matches || group->total_bytes + bytes > fusion_threshold_bytes_) {
+        FlushFusionGroupLocked(communicator);
+      }
+      if (group->collectives.empty()) {
+        group->created_usec = Env::Default()->NowMicros();
+      }
+      group->collectives.push_back(collective);
+      group->total_bytes += bytes;
+      if (group->total_bytes >= fusion_threshold_bytes_) {
+        FlushFusionGroupLocked(communicator);
+      }
+    } else {
+      // This collective must not overtake a pending fusion group on the same
+      // communicator; every stream has to see launches in the same order.
+      FlushFusionGroupLocked(collective->communicator);
+      QueueLaunchesLocked(collective);
+    }
+  }
+}
+
+bool NcclManager::CanFuseLocked(const Collective* collective) const {
+  if (fusion_threshold_bytes_ <= 0 || fusion_disabled_) return false;
+  if (collective->type != kAllReduce || !collective->single_node) return false;
+  if (DataTypeSize(collective->data_type) == 0) return false;
+  for (const std::unique_ptr<Participant>& p : collective->participants) {
+    if (p->input == nullptr || p->output == nullptr) return false;
+  }
+  const int64 bytes = collective->participants[0]->input->TotalBytes();
+  return bytes > 0 && bytes <= fusion_threshold_bytes_;
+}
+
+void NcclManager::QueueLaunchesLocked(Collective* collective) {
+  for (int i = 0; i < collective->num_local_devices; ++i) {
+    NcclStream* nccl_stream = collective->communicator->members[i].nccl_stream;
+    LaunchItem item;
+    item.collective = collective;
+    item.participant_idx = i;
+    mutex_lock queue_lock(nccl_stream->mu);
+    nccl_stream->pending_launches_.push_front(item);
+    nccl_stream->cv.notify_all();
+  }
+}
+
+void NcclManager::FlushFusionGroupLocked(Communicator* communicator) {
+  auto group_it = pending_fusion_.find(communicator);
+  if (group_it == pending_fusion_.end() ||
+      group_it->second.collectives.empty()) {
+    return;
+  }
+  std::vector<Collective*> collectives;
+  collectives.swap(group_it->second.collectives);
+  group_it->second.total_bytes = 0;
+
+  // A group of one gains nothing from packing; and if a fusion buffer cannot
+  // be allocated, each collective is launched individually.  Both decisions
+  // are made here, under launch_mu_, so they are identical for every stream.
+  if (collectives.size() == 1 || !EnsureFusionBuffersLocked(communicator)) {
+    for (Collective* collective : collectives) {
+      QueueLaunchesLocked(collective);
+    }
+    return;
+  }
+
+  const int num_ranks = communicator->members.size();
+  FusedCollective* fused = new FusedCollective(num_ranks);
+  fused->collectives = std::move(collectives);
+  fused->communicator = communicator;
+  fused->data_type = fused->collectives[0]->data_type;
+  fused->reduction_op = fused->collectives[0]->reduction_op;
+  for (const Collective* collective : fused->collectives) {
+    fused->total_elements +=
+        collective->participants[0]->input->NumElements();
+  }
+
+  VLOG(2) << "fusing " << fused->collectives.size()
+          << " all-reduce collectives with " << fused->total_elements
+          << " total elements";
+  for (int i = 0; i < num_ranks; ++i) {
+    NcclStream* nccl_stream = communicator->members[i].nccl_stream;
+    LaunchItem item;
+    item.fused = fused;
+    item.participant_idx = i;
+    mutex_lock queue_lock(nccl_stream->mu);
+    nccl_stream->pending_launches_.push_front(item);
+    nccl_stream->cv.notify_all();
+  }
+}
+
+bool NcclManager::EnsureFusionBuffersLocked(Communicator* communicator) {
+  if (fusion_disabled_) return false;
+  int saved_device = 0;
+  if (cudaGetDevice(&saved_device) != cudaSuccess) {
+    fusion_disabled_ = true;
+    return false;
+  }
+  for (const CommunicatorMember& member : communicator->members) {
+    NcclStream* nccl_stream = member.nccl_stream;
+    if (nccl_stream->fusion_buffer != nullptr) continue;
+    void* buffer = nullptr;
+    if (cudaSetDevice(nccl_stream->executor->device_ordinal()) !=
+            cudaSuccess ||
+        cudaMalloc(&buffer, fusion_threshold_bytes_) != cudaSuccess) {
+      LOG(WARNING) << "Failed to allocate a " << fusion_threshold_bytes_
+                   << " byte NCCL fusion buffer on device "
+                   << nccl_stream->executor->device_ordinal()
+                   << "; disabling all-reduce fusion.";
+      fusion_disabled_ = true;
+      break;
+    }
+    nccl_stream->fusion_buffer = buffer;
+  }
+  cudaSetDevice(saved_device);
+  return !fusion_disabled_;
+}
+
+void NcclManager::FusionFlushLoop() {
+  const int64 timeout_ms = std::max(int64{1}, fusion_timeout_usecs_ / 1000);
+  mutex_lock l(launch_mu_);
+  while (!fusion_shutdown_) {
+    WaitForMilliseconds(&l, &fusion_cv_, timeout_ms);
+    if (fusion_shutdown_) return;
+    const uint64 now = Env::Default()->NowMicros();
+    for (auto& entry : pending_fusion_) {
+      if (!entry.second.collectives.empty() &&
+          now - entry.second.created_usec >=
+              static_cast<uint64>(fusion_timeout_usecs_)) {
+        FlushFusionGroupLocked(entry.first);
+      }
     }
   }
 }
@@ -548,7 +733,7 @@ void NcclManager::LoopKernelLaunches(NcclStream* nccl_stream) {
 
   while (true) {
     // Find collective to run.
-    std::pair<Collective*, int> next_launch;
+    LaunchItem next_launch;
     {
       mutex_lock l(nccl_stream->mu);
       while (nccl_stream->pending_launches_.empty()) {
@@ -562,10 +747,86 @@ void NcclManager::LoopKernelLaunches(NcclStream* nccl_stream) {
       nccl_stream->pending_launches_.pop_back();
     }
 
+    if (next_launch.fused != nullptr) {
+      // Fused launch: pack the inputs into the stream's fusion buffer, run
+      // one ncclAllReduce over the packed elements, and unpack into the
+      // outputs.  The packing and unpacking copies run on the communication
+      // stream, so they are ordered with the NCCL kernel and with any
+      // earlier use of the buffer.
+      FusedCollective* fused = next_launch.fused;
+      const int p_idx = next_launch.participant_idx;
+      auto nccl_comm = fused->communicator->members[p_idx].nccl_comm;
+      char* buffer = static_cast<char*>(nccl_stream->fusion_buffer);
+      cudaError_t cuda_result = cudaSuccess;
+      size_t offset = 0;
+      for (const Collective* c : fused->collectives) {
+        const Tensor* input = c->participants[p_idx]->input;
+        cuda_result = cudaMemcpyAsync(
+            buffer + offset, input->tensor_data().data(), input->TotalBytes(),
+            cudaMemcpyDeviceToDevice, *cu_stream);
+        if (cuda_result != cudaSuccess) break;
+        offset += input->TotalBytes();
+      }
+      ncclResult_t nccl_result = ncclSuccess;
+      if (cuda_result == cudaSuccess) {
+        VLOG(2) << "call fused NcclAllReduce participant " << p_idx
+                << " tensors " << fused->collectives.size() << " elements "
+                << fused->total_elements << " nccl_comm " << nccl_comm
+                << " comm_stream " << comm_stream << " cuda_stream "
+                << cu_stream;
+        nccl_result = ncclAllReduce(buffer, buffer, fused->total_elements,
+                                    ToNcclType(fused->data_type),
+                                    fused->reduction_op, nccl_comm, *cu_stream);
+      }
+      if (cuda_result == cudaSuccess && nccl_result == ncclSuccess) {
+        offset = 0;
+        for (const Collective* c : fused->collectives) {
+          Tensor* output = c->participants[p_idx]->output;
+          cuda_result = cudaMemcpyAsync(
+              const_cast<char*>(output->tensor_data().data()), buffer + offset,
+              output->TotalBytes(), cudaMemcpyDeviceToDevice, *cu_stream);
+          if (cuda_result != cudaSuccess) break;
+          offset += output->TotalBytes();
+        }
+      }
+
+      // Run all the member done_callbacks for this rank when the unpack
+      // copies finish.
+      auto done_callback = [fused, p_idx, cuda_result, nccl_result]() {
+        Status status;
+        if (cuda_result != cudaSuccess) {
+          status = errors::Unknown("Error in fused NCCL all-reduce copy: ",
+                                   cudaGetErrorString(cuda_result));
+        } else if (nccl_result != ncclSuccess) {
+          // Propagate the error, but note that if other members of the
+          // collective did launch their kernels, then they are hanging.
+          status = errors::Unknown("Error invoking NCCL: ",
+                                   ncclGetErrorString(nccl_result));
+        }
+        for (Collective* c : fused->collectives) {
+          c->participants[p_idx]->done_callback(status);
+          // See tensorflow/core/lib/core/refcount.h for details on this
+          // locking.
+          if (c->remaining_participants.load(std::memory_order_acquire) ==
+                  1 ||
+              c->remaining_participants.fetch_sub(1) == 1) {
+            delete c;
+          }
+        }
+        if (fused->remaining_ranks.load(std::memory_order_acquire) == 1 ||
+            fused->remaining_ranks.fetch_sub(1) == 1) {
+          delete fused;
+        }
+      };
+      fused->collectives[0]->participants[p_idx]->event_mgr->ThenExecute(
+          comm_stream, done_callback);
+      continue;
+    }
+
     // Launch the nccl kernel.
-    Collective* collective = next_launch.first;
+    Collective* collective = next_launch.collective;
     ncclDataType_t data_type = ToNcclType(collective->data_type);
-    int p_idx = next_launch.second;
+    int p_idx = next_launch.participant_idx;
     Participant* p = collective->participants[p_idx].get();
     auto nccl_comm = collective->communicator->members[p_idx].nccl_comm;
     ncclResult_t nccl_result = ncclSuccess;
@@ -30,6 +30,7 @@ limitations under the License.
 #include "third_party/nccl/nccl.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/stream_executor.h"
 
@@ -179,6 +180,8 @@ class NcclManager {
   struct Collective;
   struct Communicator;
   struct CommunicatorMember;
+  struct FusedCollective;
+  struct LaunchItem;
   struct NcclStream;
 
   // Gets the `Communicator` object that will be used to enqueue NCCL kernels
@@ -211,6 +214,38 @@ class NcclManager {
   void RunCollective(Collective* collective);
   void LoopKernelLaunches(NcclStream* stream);
 
+  // Fusion of small single-node all-reduces: instead of one NCCL launch per
+  // tensor, eligible collectives on the same communicator are packed into a
+  // per-device fusion buffer and reduced with a single ncclAllReduce, then
+  // unpacked (see the comment on TF_NCCL_FUSION_THRESHOLD_BYTES in
+  // nccl_manager.cc).  All fusion decisions are made under launch_mu_ so
+  // that every device's launch queue sees the identical sequence of fused
+  // and unfused launches; a divergent decision between the per-device
+  // launch threads would deadlock NCCL.
+
+  // Returns true if `collective` may be added to a fusion group.
+  bool CanFuseLocked(const Collective* collective) const
+      EXCLUSIVE_LOCKS_REQUIRED(launch_mu_);
+
+  // Adds one launch per participant of `collective` to the member streams'
+  // launch queues.
+  void QueueLaunchesLocked(Collective* collective)
+      EXCLUSIVE_LOCKS_REQUIRED(launch_mu_);
+
+  // Queues the pending fusion group of `communicator` (if any) for launch.
+  void FlushFusionGroupLocked(Communicator* communicator)
+      EXCLUSIVE_LOCKS_REQUIRED(launch_mu_);
+
+  // Ensures every member stream of `communicator` has a fusion buffer,
+  // allocating them if needed.  On allocation failure disables fusion for
+  // the process and returns false.
+  bool EnsureFusionBuffersLocked(Communicator* communicator)
+      EXCLUSIVE_LOCKS_REQUIRED(launch_mu_);
+
+  // Background loop that flushes fusion groups older than the fusion
+  // timeout, so the tail bucket of a step is not stranded.
+  void FusionFlushLoop();
+
   mutex mu_;
 
   // Maps key to collectives currently being assembled or run.
@@ -225,6 +260,29 @@ class NcclManager {
 
   std::vector<std::unique_ptr<Communicator>> communicators_;
 
+  // Serializes additions to the per-stream launch queues, so that all
+  // streams see collectives (and fusion groups) in the same order.
+  mutex launch_mu_;
+
+  // Pending fusion group per communicator.
+  struct FusionGroup {
+    std::vector<Collective*> collectives;
+    int64 total_bytes = 0;
+    uint64 created_usec = 0;
+  };
+  std::unordered_map<Communicator*, FusionGroup> pending_fusion_
+      GUARDED_BY(launch_mu_);
+
+  condition_variable fusion_cv_ GUARDED_BY(launch_mu_);
+  bool fusion_shutdown_ GUARDED_BY(launch_mu_) = false;
+  bool fusion_disabled_ GUARDED_BY(launch_mu_) = false;
+  std::unique_ptr<Thread> fusion_thread_;
+
+  // Fusion configuration, read from the environment at construction.
+  // fusion_threshold_bytes_ == 0 means fusion is off.
+  int64 fusion_threshold_bytes_ = 0;
+  int64 fusion_timeout_usecs_ = 0;
+
   TF_DISALLOW_COPY_AND_ASSIGN(NcclManager);
 };
 
@@ -389,6 +389,7 @@ REGISTER_OP("DecodeJpeg")
     .Attr("try_recover_truncated: bool = false")
     .Attr("acceptable_fraction: float = 1.0")
     .Attr("dct_method: string = ''")
+    .Attr("size_hint: list(int) = []")
     .Output("image: uint8")
     .SetShapeFn(DecodeImageShapeFn);
 
@@ -757,6 +758,49 @@ REGISTER_OP("CropAndResize")
                                    c->Dim(input, 3));
     });
 
+REGISTER_OP("CropAndResizeNormalize")
+    .Input("image: T")
+    .Input("boxes: float")
+    .Input("box_ind: int32")
+    .Input("crop_size: int32")
+    .Input("mean: float")
+    .Input("scale: float")
+    .Output("crops: float")
+    .Attr("T: {uint8, uint16, int8, int16, int32, int64, half, float, double}")
+    .Attr("extrapolation_value: float = 0")
+    .SetShapeFn([](InferenceContext* c) {
+      // Get inputs and validate ranks.
+      ShapeHandle input;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 4, &input));
+      ShapeHandle boxes;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 2, &boxes));
+      ShapeHandle box_ind;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &box_ind));
+      ShapeHandle mean;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(4), 1, &mean));
+      ShapeHandle scale;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(5), 1, &scale));
+
+      // boxes[0] and box_ind[0] are both num_boxes.
+      DimensionHandle num_boxes_dim;
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(boxes, 0), c->Dim(box_ind, 0), &num_boxes_dim));
+
+      // boxes.dim(1) is 4.
+      DimensionHandle unused;
+      TF_RETURN_IF_ERROR(c->WithValue(c->Dim(boxes, 1), 4, &unused));
+
+      // mean and scale have one value per channel.
+      DimensionHandle depth_dim;
+      TF_RETURN_IF_ERROR(
+          c->Merge(c->Dim(input, 3), c->Dim(mean, 0), &depth_dim));
+      TF_RETURN_IF_ERROR(
+          c->Merge(depth_dim, c->Dim(scale, 0), &depth_dim));
+
+      return SetOutputToSizedImage(c, num_boxes_dim, 3 /* size_input_idx */,
+                                   depth_dim);
+    });
+
 REGISTER_OP("CropAndResizeGradImage")
     .Input("grads: float")
     .Input("boxes: float")
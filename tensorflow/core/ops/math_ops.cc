@@ -1768,6 +1768,23 @@ REGISTER_OP("ClipByValue")
     .Attr("T: numbertype")
     .SetShapeFn(shape_inference::UnchangedShape);
 
+REGISTER_OP("_FusedNormalizeClip")
+    .Input("t: T")
+    .Input("shift: T")
+    .Input("scale: T")
+    .Input("clip_value_min: T")
+    .Input("clip_value_max: T")
+    .Output("output: T")
+    .Attr("T: {half, float, double}")
+    .SetShapeFn(shape_inference::UnchangedShape)
+    .Doc(R"doc(
+Computes `clip((t - shift) / scale, clip_value_min, clip_value_max)` with
+scalar `shift`, `scale`, `clip_value_min` and `clip_value_max` in one pass.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators.
+)doc");
+
 #ifdef INTEL_MKL
 // Note: This op is not commutative w.r.t. to all its inputs.
 REGISTER_OP("_MklAddN")
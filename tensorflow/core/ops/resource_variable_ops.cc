@@ -165,6 +165,11 @@ REGISTER_OP("DestroyResourceOp")
     .SetIsStateful()
     .SetShapeFn(shape_inference::NoOutputs);
 
+REGISTER_OP("FreezeVariableOp")
+    .Input("resource: resource")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::NoOutputs);
+
 Status CreateAssignShapeFn(InferenceContext* c) {
   std::vector<ShapeAndType> handle_shape_and_type;
   TF_RETURN_IF_ERROR(shape_inference::ValidateVariableResourceHandle(
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
+#include <map>
 
 #include "tensorflow/core/platform/cloud/curl_http_request.h"
 
@@ -22,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/public/version.h"
 
@@ -112,6 +114,102 @@ class LibCurlProxy : public LibCurl {
   }
 
   void curl_free(void* p) override { ::curl_free(p); }
+
+  CURLSH* curl_share_init() override { return ::curl_share_init(); }
+
+  CURLSHcode curl_share_setopt(CURLSH* share, CURLSHoption option,
+                               int param) override {
+    return ::curl_share_setopt(share, option, param);
+  }
+
+  CURLSHcode curl_share_setopt(CURLSH* share, CURLSHoption option,
+                               void (*param)(CURL*, curl_lock_data,
+                                             curl_lock_access,
+                                             void*)) override {
+    return ::curl_share_setopt(share, option, param);
+  }
+
+  CURLSHcode curl_share_setopt(CURLSH* share, CURLSHoption option,
+                               void (*param)(CURL*, curl_lock_data,
+                                             void*)) override {
+    return ::curl_share_setopt(share, option, param);
+  }
+
+  void curl_share_cleanup(CURLSH* share) override {
+    ::curl_share_cleanup(share);
+  }
+};
+
+// Shares libcurl's connection and DNS caches across all CurlHttpRequests so
+// that consecutive requests to the same endpoint reuse established TLS
+// connections instead of opening a new one per request. The share object
+// lives for the lifetime of the process and is protected by the lock
+// callbacks below, as required for use from multiple threads.
+class CurlConnectionPool {
+ public:
+  // Returns the process-wide share handle for the given libcurl
+  // implementation, or null if sharing could not be set up (in which case
+  // each request manages its own connections). Keyed by implementation so
+  // that fakes injected by tests never receive a share created by the real
+  // libcurl.
+  static CURLSH* Get(LibCurl* libcurl) {
+    static mutex mu;
+    static auto* shares = new std::map<LibCurl*, CURLSH*>;
+    mutex_lock l(mu);
+    auto it = shares->find(libcurl);
+    if (it != shares->end()) {
+      return it->second;
+    }
+    CURLSH* share = CreateShare(libcurl);
+    shares->emplace(libcurl, share);
+    return share;
+  }
+
+ private:
+  static CURLSH* CreateShare(LibCurl* libcurl) {
+    CURLSH* share = libcurl->curl_share_init();
+    if (share == nullptr) {
+      return nullptr;
+    }
+    if (libcurl->curl_share_setopt(share, CURLSHOPT_LOCKFUNC, &LockShare) !=
+            CURLSHE_OK ||
+        libcurl->curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC,
+                                   &UnlockShare) != CURLSHE_OK) {
+      libcurl->curl_share_cleanup(share);
+      return nullptr;
+    }
+    // All libcurl versions we build against can share the DNS cache; sharing
+    // the connection cache needs libcurl 7.57+, so a failure there degrades
+    // to DNS-only sharing.
+    if (libcurl->curl_share_setopt(share, CURLSHOPT_SHARE,
+                                   static_cast<int>(CURL_LOCK_DATA_DNS)) !=
+        CURLSHE_OK) {
+      libcurl->curl_share_cleanup(share);
+      return nullptr;
+    }
+    if (libcurl->curl_share_setopt(share, CURLSHOPT_SHARE,
+                                   static_cast<int>(CURL_LOCK_DATA_CONNECT)) !=
+        CURLSHE_OK) {
+      VLOG(1) << "libcurl does not support connection sharing; "
+                 "only the DNS cache will be pooled across requests.";
+    }
+    return share;
+  }
+
+ private:
+  static mutex* GetShareLock(curl_lock_data data) {
+    static mutex locks[CURL_LOCK_DATA_LAST];
+    return &locks[data];
+  }
+
+  static void LockShare(CURL* handle, curl_lock_data data,
+                        curl_lock_access access, void* userptr) {
+    GetShareLock(data)->lock();
+  }
+
+  static void UnlockShare(CURL* handle, curl_lock_data data, void* userptr) {
+    GetShareLock(data)->unlock();
+  }
 };
 }  // namespace
 
@@ -136,6 +234,14 @@ CurlHttpRequest::CurlHttpRequest(LibCurl* libcurl, Env* env)
   // Do not use signals for timeouts - does not work in multi-threaded programs.
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L));
 
+  // Pool connections and DNS entries across requests, so that repeated
+  // requests to the same endpoint reuse established connections.
+  CURLSH* share = CurlConnectionPool::Get(libcurl_);
+  if (share != nullptr) {
+    CHECK_CURL_OK(
+        libcurl_->curl_easy_setopt(curl_, CURLOPT_SHARE, share));
+  }
+
   // TODO(b/74351157): Enable HTTP/2.
 
   // Set up the progress meter.
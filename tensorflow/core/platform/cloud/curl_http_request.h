@@ -266,6 +266,26 @@ class LibCurl {
   virtual void curl_slist_free_all(curl_slist* list) = 0;
   virtual char* curl_easy_escape(CURL* curl, const char* str, int length) = 0;
   virtual void curl_free(void* p) = 0;
+
+  // The libcurl share interface, used to pool connections and DNS entries
+  // across requests. Defaults are provided so that fakes which do not model
+  // sharing keep working; a null share disables pooling.
+  virtual CURLSH* curl_share_init() { return nullptr; }
+  virtual CURLSHcode curl_share_setopt(CURLSH* share, CURLSHoption option,
+                                       int param) {
+    return CURLSHE_OK;
+  }
+  virtual CURLSHcode curl_share_setopt(
+      CURLSH* share, CURLSHoption option,
+      void (*param)(CURL*, curl_lock_data, curl_lock_access, void*)) {
+    return CURLSHE_OK;
+  }
+  virtual CURLSHcode curl_share_setopt(CURLSH* share, CURLSHoption option,
+                                       void (*param)(CURL*, curl_lock_data,
+                                                     void*)) {
+    return CURLSHE_OK;
+  }
+  virtual void curl_share_cleanup(CURLSH* share) {}
 };
 
 }  // namespace tensorflow
@@ -67,6 +67,13 @@ class FileBlockCache {
   virtual Status Read(const string& filename, size_t offset, size_t n,
                       char* buffer, size_t* bytes_transferred) = 0;
 
+  /// Asynchronously fetch the block containing `offset` of `filename` into
+  /// the cache, if it is not already present or being fetched. Used to read
+  /// ahead of a sequential reader; failures are ignored since the block will
+  /// be fetched again (and the error surfaced) if it is actually read. The
+  /// default implementation does nothing.
+  virtual void Prefetch(const string& filename, size_t offset) {}
+
   // Validate the given file signature with the existing file signature in the
   // cache. Returns true if the signature doesn't change or the file did not
   // exist before. If the signature changes, update the existing signature with
@@ -17,6 +17,7 @@ limitations under the License.
 #include <stdio.h>
 #include <unistd.h>
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -83,6 +84,10 @@ constexpr size_t kDefaultMaxCacheSize = kDefaultBlockSize;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64 kDefaultMaxStaleness = 0;
+// The environment variable that overrides the number of cache blocks kept in
+// flight ahead of a sequential reader. A value of 0 (the default) disables
+// readahead.
+constexpr char kReadaheadWindowBlocks[] = "GCS_READAHEAD_WINDOW_BLOCKS";
 // The environment variable that overrides the maximum age of entries in the
 // Stat cache. A value of 0 (the default) means nothing is cached.
 constexpr char kStatCacheMaxAge[] = "GCS_STAT_CACHE_MAX_AGE";
@@ -306,9 +311,14 @@ class GcsRandomAccessFile : public RandomAccessFile {
   using ReadFn =
       std::function<Status(const string& filename, uint64 offset, size_t n,
                            StringPiece* result, char* scratch)>;
+  using PrefetchFn =
+      std::function<void(const string& filename, uint64 offset)>;
 
-  GcsRandomAccessFile(const string& filename, ReadFn read_fn)
-      : filename_(filename), read_fn_(std::move(read_fn)) {}
+  GcsRandomAccessFile(const string& filename, ReadFn read_fn,
+                      PrefetchFn prefetch_fn = nullptr)
+      : filename_(filename),
+        read_fn_(std::move(read_fn)),
+        prefetch_fn_(std::move(prefetch_fn)) {}
 
   Status Name(StringPiece* result) const override {
     *result = filename_;
@@ -318,7 +328,17 @@ class GcsRandomAccessFile : public RandomAccessFile {
   /// The implementation of reads with an LRU block cache. Thread safe.
   Status Read(uint64 offset, size_t n, StringPiece* result,
               char* scratch) const override {
-    return read_fn_(filename_, offset, n, result, scratch);
+    Status status = read_fn_(filename_, offset, n, result, scratch);
+    if (prefetch_fn_ && status.ok()) {
+      // Read ahead of the caller only while the file is being consumed
+      // sequentially, i.e. each read starts where the previous one ended.
+      const uint64 read_end = offset + result->size();
+      if (offset == last_read_end_.load(std::memory_order_relaxed)) {
+        prefetch_fn_(filename_, read_end);
+      }
+      last_read_end_.store(read_end, std::memory_order_relaxed);
+    }
+    return status;
   }
 
  private:
@@ -326,6 +346,10 @@ class GcsRandomAccessFile : public RandomAccessFile {
   const string filename_;
   /// The implementation of the read operation (provided by the GCSFileSystem).
   const ReadFn read_fn_;
+  /// Starts asynchronous fetches of the data following an offset; may be null.
+  const PrefetchFn prefetch_fn_;
+  /// The end offset of the most recent read, used to detect sequential scans.
+  mutable std::atomic<uint64> last_read_end_{0};
 };
 
 /// \brief GCS-based implementation of a writeable file.
@@ -681,6 +705,9 @@ GcsFileSystem::GcsFileSystem() {
   if (GetEnvVar(kMaxStaleness, strings::safe_strtou64, &value)) {
     max_staleness = value;
   }
+  if (GetEnvVar(kReadaheadWindowBlocks, strings::safe_strtou64, &value)) {
+    readahead_window_blocks_ = value;
+  }
   if (std::getenv(kReadCacheDisabled)) {
     // Setting either to 0 disables the cache; set both for good measure.
     block_size = max_bytes = 0;
@@ -831,6 +858,23 @@ Status GcsFileSystem::NewRandomAccessFile(
   string bucket, object;
   TF_RETURN_IF_ERROR(ParseGcsPath(fname, false, &bucket, &object));
   TF_RETURN_IF_ERROR(CheckBucketLocationConstraint(bucket));
+  GcsRandomAccessFile::PrefetchFn prefetch_fn;
+  if (readahead_window_blocks_ > 0) {
+    const size_t window_blocks = readahead_window_blocks_;
+    prefetch_fn = [this, window_blocks](const string& fname, uint64 offset) {
+      tf_shared_lock l(block_cache_lock_);
+      const size_t block_size = file_block_cache_->block_size();
+      if (block_size == 0) {
+        return;
+      }
+      // Keep up to window_blocks blocks beyond the current read position in
+      // flight. Blocks that are already cached or being fetched are skipped
+      // by the cache, so in steady state each call tops up the window.
+      for (size_t i = 0; i < window_blocks; i++) {
+        file_block_cache_->Prefetch(fname, offset + i * block_size);
+      }
+    };
+  }
   result->reset(new GcsRandomAccessFile(fname, [this, bucket, object](
                                                    const string& fname,
                                                    uint64 offset, size_t n,
@@ -862,7 +906,8 @@ Status GcsFileSystem::NewRandomAccessFile(
                                 " bytes requested.");
     }
     return Status::OK();
-  }));
+  },
+                                        std::move(prefetch_fn)));
   return Status::OK();
 }
 
@@ -1253,15 +1298,29 @@ Status GcsFileSystem::GetMatchingPaths(const string& pattern,
               "A GCS pattern doesn't have a bucket name: ", pattern);
         }
         std::vector<string> all_files;
+        // List with the full fixed prefix, which may extend past the last
+        // '/', so that the wildcard-free part of the pattern is evaluated
+        // by the GCS backend instead of transferring every object under
+        // 'dir' and filtering client-side.
         TF_RETURN_IF_ERROR(GetChildrenBounded(
-            dir, UINT64_MAX, &all_files, true /* recursively */,
-            false /* include_self_directory_marker */));
+            fixed_prefix, UINT64_MAX, &all_files, true /* recursively */,
+            true /* include_self_directory_marker */,
+            true /* allow_partial_prefix */));
 
         const auto& files_and_folders = AddAllSubpaths(all_files);
 
-        // Match all obtained paths to the input pattern.
+        // Match all obtained paths to the input pattern.  The returned
+        // names are relative to fixed_prefix, which may end mid-name, so
+        // plain concatenation (not JoinPath) reassembles the full path.
         for (const auto& path : files_and_folders) {
-          const string& full_path = io::JoinPath(dir, path);
+          // An empty relative path is an object named exactly fixed_prefix:
+          // either a real object (when the prefix does not end in '/',
+          // e.g. a wildcard-free pattern) or a directory self-marker,
+          // which should stay hidden as in GetChildren().
+          if (path.empty() && str_util::EndsWith(fixed_prefix, "/")) {
+            continue;
+          }
+          const string full_path = strings::StrCat(fixed_prefix, path);
           if (Env::Default()->MatchPath(full_path, pattern)) {
             results->push_back(full_path);
           }
@@ -1277,13 +1336,15 @@ Status GcsFileSystem::GetChildrenBounded(const string& dirname,
                                          uint64 max_results,
                                          std::vector<string>* result,
                                          bool recursive,
-                                         bool include_self_directory_marker) {
+                                         bool include_self_directory_marker,
+                                         bool allow_partial_prefix) {
   if (!result) {
     return errors::InvalidArgument("'result' cannot be null");
   }
   string bucket, object_prefix;
   TF_RETURN_IF_ERROR(
-      ParseGcsPath(MaybeAppendSlash(dirname), true, &bucket, &object_prefix));
+      ParseGcsPath(allow_partial_prefix ? dirname : MaybeAppendSlash(dirname),
+                   true, &bucket, &object_prefix));
 
   string nextPageToken;
   uint64 retrieved_results = 0;
@@ -279,9 +279,14 @@ class GcsFileSystem : public FileSystem {
   /// If 'include_self_directory_marker' is true and there is a GCS directory
   /// marker at the path 'dir', GetChildrenBound will return an empty string
   /// as one of the children that represents this marker.
+  /// If 'allow_partial_prefix' is true, 'dir' is used verbatim as the
+  /// listing prefix: it may end in the middle of an object name and no
+  /// trailing slash is appended.  The returned names are then relative to
+  /// that prefix.
   Status GetChildrenBounded(const string& dir, uint64 max_results,
                             std::vector<string>* result, bool recursively,
-                            bool include_self_directory_marker);
+                            bool include_self_directory_marker,
+                            bool allow_partial_prefix = false);
 
   /// Retrieves file statistics assuming fname points to a GCS object. The data
   /// may be read from cache or from GCS directly.
@@ -313,6 +318,9 @@ class GcsFileSystem : public FileSystem {
   mutex block_cache_lock_;
   std::unique_ptr<FileBlockCache> file_block_cache_
       GUARDED_BY(block_cache_lock_);
+  // The number of blocks to keep in flight ahead of a sequential reader. A
+  // value of 0 (the default) disables readahead.
+  size_t readahead_window_blocks_ = 0;
   std::shared_ptr<ComputeEngineMetadataClient> compute_engine_metadata_client_;
   std::unique_ptr<GcsDnsCache> dns_cache_;
   GcsThrottle throttle_;
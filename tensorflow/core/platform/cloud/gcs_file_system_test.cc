@@ -1530,7 +1530,7 @@ TEST(GcsFileSystemTest, GetChildren_Pagination) {
 TEST(GcsFileSystemTest, GetMatchingPaths_NoWildcard) {
   std::vector<HttpRequest*> requests({new FakeHttpRequest(
       "Uri: https://www.googleapis.com/storage/v1/b/bucket/o?"
-      "fields=items%2Fname%2CnextPageToken&prefix=path%2Fsubpath%2F\n"
+      "fields=items%2Fname%2CnextPageToken&prefix=path%2Fsubpath%2Ffile2.txt\n"
       "Auth Token: fake_token\n"
       "Timeouts: 5 1 10\n",
       "{\"items\": [ "
@@ -1609,6 +1609,36 @@ TEST(GcsFileSystemTest, GetMatchingPaths_FolderAndWildcard_Matches) {
             result);
 }
 
+TEST(GcsFileSystemTest, GetMatchingPaths_PartialBasenamePrefix) {
+  // The wildcard-free part of the basename is pushed to GCS as part of the
+  // listing prefix, so unrelated objects in the folder are filtered
+  // server-side.
+  std::vector<HttpRequest*> requests({new FakeHttpRequest(
+      "Uri: https://www.googleapis.com/storage/v1/b/bucket/o?"
+      "fields=items%2Fname%2CnextPageToken&prefix=path%2Ffile\n"
+      "Auth Token: fake_token\n"
+      "Timeouts: 5 1 10\n",
+      "{\"items\": [ "
+      "  { \"name\": \"path/file1.txt\" },"
+      "  { \"name\": \"path/file3.txt\" }]}")});
+  GcsFileSystem fs(std::unique_ptr<AuthProvider>(new FakeAuthProvider),
+                   std::unique_ptr<HttpRequest::Factory>(
+                       new FakeHttpRequestFactory(&requests)),
+                   std::unique_ptr<ZoneProvider>(new FakeZoneProvider),
+                   0 /* block size */, 0 /* max bytes */, 0 /* max staleness */,
+                   0 /* stat cache max age */, 0 /* stat cache max entries */,
+                   0 /* matching paths cache max age */,
+                   0 /* matching paths cache max entries */, kTestRetryConfig,
+                   kTestTimeoutConfig, *kAllowedLocationsDefault,
+                   nullptr /* gcs additional header */);
+
+  std::vector<string> result;
+  TF_EXPECT_OK(fs.GetMatchingPaths("gs://bucket/path/file*.txt", &result));
+  EXPECT_EQ(std::vector<string>({"gs://bucket/path/file1.txt",
+                                 "gs://bucket/path/file3.txt"}),
+            result);
+}
+
 TEST(GcsFileSystemTest, GetMatchingPaths_SelfDirectoryMarker) {
   std::vector<HttpRequest*> requests({new FakeHttpRequest(
       "Uri: https://www.googleapis.com/storage/v1/b/bucket/o?"
@@ -1682,7 +1712,8 @@ TEST(GcsFileSystemTest, GetMatchingPaths_Cache) {
   std::vector<HttpRequest*> requests(
       {new FakeHttpRequest(
            "Uri: https://www.googleapis.com/storage/v1/b/bucket/o?"
-           "fields=items%2Fname%2CnextPageToken&prefix=path%2Fsubpath%2F\n"
+           "fields=items%2Fname%2CnextPageToken&prefix=path%2Fsubpath%2F"
+           "file2.txt\n"
            "Auth Token: fake_token\n"
            "Timeouts: 5 1 10\n",
            "{\"items\": [ "
@@ -1727,14 +1758,16 @@ TEST(GcsFileSystemTest, GetMatchingPaths_Cache_Flush) {
   std::vector<HttpRequest*> requests(
       {new FakeHttpRequest(
            "Uri: https://www.googleapis.com/storage/v1/b/bucket/o?"
-           "fields=items%2Fname%2CnextPageToken&prefix=path%2Fsubpath%2F\n"
+           "fields=items%2Fname%2CnextPageToken&prefix=path%2Fsubpath%2F"
+           "file2.txt\n"
            "Auth Token: fake_token\n"
            "Timeouts: 5 1 10\n",
            "{\"items\": [ "
            "  { \"name\": \"path/subpath/file2.txt\" }]}"),
        new FakeHttpRequest(
            "Uri: https://www.googleapis.com/storage/v1/b/bucket/o?"
-           "fields=items%2Fname%2CnextPageToken&prefix=path%2Fsubpath%2F\n"
+           "fields=items%2Fname%2CnextPageToken&prefix=path%2Fsubpath%2F"
+           "file2.txt\n"
            "Auth Token: fake_token\n"
            "Timeouts: 5 1 10\n",
            "{\"items\": [ "
@@ -217,6 +217,40 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   return Status::OK();
 }
 
+void RamFileBlockCache::Prefetch(const string& filename, size_t offset) {
+  if (!IsCacheEnabled()) {
+    return;
+  }
+  // Cap on concurrently scheduled prefetches, to bound both the background
+  // work and the cache churn a fast sequential reader can generate.
+  static const size_t kMaxPendingPrefetches = 16;
+  Key key = std::make_pair(filename, (offset / block_size_) * block_size_);
+  {
+    mutex_lock lock(mu_);
+    if (block_map_.find(key) != block_map_.end()) {
+      // The block is already cached or being fetched.
+      return;
+    }
+    if (pending_prefetches_ >= kMaxPendingPrefetches) {
+      return;
+    }
+    pending_prefetches_++;
+  }
+  env_->SchedClosure([this, key] {
+    // Reading a single byte pulls the entire enclosing block into the cache
+    // through the regular fetch path, reusing its locking, concurrent-fetch
+    // deduplication and eviction logic.
+    char scratch;
+    size_t bytes_transferred;
+    Read(key.first, key.second, 1, &scratch, &bytes_transferred).IgnoreError();
+    mutex_lock lock(mu_);
+    pending_prefetches_--;
+    if (pending_prefetches_ == 0) {
+      prefetch_cond_var_.notify_all();
+    }
+  });
+}
+
 bool RamFileBlockCache::ValidateAndUpdateFileSignature(const string& filename,
                                                        int64 file_signature) {
   mutex_lock lock(mu_);
@@ -71,6 +71,11 @@ class RamFileBlockCache : public FileBlockCache {
       // notification and returns.
       pruning_thread_.reset();
     }
+    // Wait for in-flight prefetch closures, which access `this`, to drain.
+    mutex_lock lock(mu_);
+    while (pending_prefetches_ > 0) {
+      prefetch_cond_var_.wait(lock);
+    }
   }
 
   /// Read `n` bytes from `filename` starting at `offset` into `out`. This
@@ -90,6 +95,12 @@ class RamFileBlockCache : public FileBlockCache {
   Status Read(const string& filename, size_t offset, size_t n, char* buffer,
               size_t* bytes_transferred) override;
 
+  /// Asynchronously fetch the block containing `offset` into the cache, if it
+  /// is not already present or being fetched. Thread safe; a bounded number of
+  /// prefetches is kept in flight and further requests are dropped.
+  void Prefetch(const string& filename, size_t offset) override
+      LOCKS_EXCLUDED(mu_);
+
   // Validate the given file signature with the existing file signature in the
   // cache. Returns true if the signature doesn't change or the file doesn't
   // exist before. If the signature changes, update the existing signature with
@@ -239,6 +250,12 @@ class RamFileBlockCache : public FileBlockCache {
   /// The combined number of bytes in all of the cached blocks.
   size_t cache_size_ GUARDED_BY(mu_) = 0;
 
+  /// The number of prefetch closures currently scheduled or running.
+  size_t pending_prefetches_ GUARDED_BY(mu_) = 0;
+
+  /// Signaled whenever pending_prefetches_ drops to zero.
+  condition_variable prefetch_cond_var_;
+
   // A filename->file_signature map.
   std::map<string, int64> file_signature_map_ GUARDED_BY(mu_);
 };
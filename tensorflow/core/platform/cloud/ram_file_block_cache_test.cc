@@ -83,6 +83,32 @@ TEST(RamFileBlockCacheTest, ValidateAndUpdateFileSignature) {
   EXPECT_EQ(calls, 2);
 }
 
+TEST(RamFileBlockCacheTest, Prefetch) {
+  int calls = 0;
+  Notification fetched;
+  auto fetcher = [&calls, &fetched](const string& filename, size_t offset,
+                                    size_t n, char* buffer,
+                                    size_t* bytes_transferred) {
+    calls++;
+    memset(buffer, 'x', n);
+    *bytes_transferred = n;
+    fetched.Notify();
+    return Status::OK();
+  };
+  const size_t block_size = 16;
+  RamFileBlockCache cache(block_size, 2 * block_size, 0, fetcher);
+  cache.Prefetch("", 0);
+  fetched.WaitForNotification();
+  // The subsequent read of the same block is served from the cache.
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "", 0, block_size, &out));
+  EXPECT_EQ(calls, 1);
+  // Prefetching an offset within an already cached block is a no-op.
+  cache.Prefetch("", block_size / 2);
+  TF_EXPECT_OK(ReadCache(&cache, "", 0, block_size, &out));
+  EXPECT_EQ(calls, 1);
+}
+
 TEST(RamFileBlockCacheTest, PassThrough) {
   const string want_filename = "foo/bar";
   const size_t want_offset = 42;
@@ -17,7 +17,9 @@ limitations under the License.
 
 #include <stdlib.h>
 
+#include <deque>
 #include <memory>
+#include <unordered_map>
 
 #include "absl/base/casts.h"
 #include "absl/container/flat_hash_map.h"
@@ -112,13 +114,22 @@ static thread_local const char* tls_current_annotation;
 // Stores a series of kernel and memcpy records.
 class CudaEventRecorder {
  public:
+  ~CudaEventRecorder() {
+    for (const auto& pair : free_events_) {
+      if (cuCtxSetCurrent(pair.first) != CUDA_SUCCESS) continue;
+      for (CUevent event : pair.second) {
+        LogIfError(ToStatus(cuEventDestroy(event)));
+      }
+    }
+  }
+
   // Registers the start of a kernel launch. The returned index should be passed
   // to StopKernel() after the kernel launch has completed.
   size_t StartKernel(const char* kernel_name, CUcontext context,
                      CUstream stream) {
     KernelRecord record = {kernel_name, context, stream};
-    LogIfError(CreateAndRecordEvent(&record.start_event, stream));
     mutex_lock lock(mutex_);
+    LogIfError(ObtainAndRecordEvent(&record.start_event, context, stream));
     if (tls_current_annotation) {
       record.annotation = &*annotations_.emplace(tls_current_annotation).first;
     }
@@ -128,7 +139,8 @@ class CudaEventRecorder {
   void StopKernel(size_t index) {
     mutex_lock lock(mutex_);
     auto& record = kernel_records_[index];
-    LogIfError(CreateAndRecordEvent(&record.stop_event, record.stream));
+    LogIfError(
+        ObtainAndRecordEvent(&record.stop_event, record.context, record.stream));
   }
 
   // Registers the start of a copy operation. The returned index should be
@@ -136,8 +148,8 @@ class CudaEventRecorder {
   size_t StartMemcpy(CUmemorytype src_type, CUmemorytype dst_type,
                      size_t size_bytes, CUcontext context, CUstream stream) {
     MemcpyRecord record = {src_type, dst_type, size_bytes, context, stream};
-    LogIfError(CreateAndRecordEvent(&record.start_event, stream));
     mutex_lock lock(mutex_);
+    LogIfError(ObtainAndRecordEvent(&record.start_event, context, stream));
     if (tls_current_annotation) {
       record.annotation = &*annotations_.emplace(tls_current_annotation).first;
     }
@@ -147,23 +159,71 @@ class CudaEventRecorder {
   void StopMemcpy(size_t index) {
     mutex_lock lock(mutex_);
     auto& record = memcpy_records_[index];
-    LogIfError(CreateAndRecordEvent(&record.stop_event, record.stream));
+    LogIfError(
+        ObtainAndRecordEvent(&record.stop_event, record.context, record.stream));
   }
 
-  std::vector<KernelRecord> ConsumeKernelRecords() {
+  std::deque<KernelRecord> ConsumeKernelRecords() {
     mutex_lock lock(mutex_);
     return std::move(kernel_records_);
   }
-  std::vector<MemcpyRecord> ConsumeMemcpyRecords() {
+  std::deque<MemcpyRecord> ConsumeMemcpyRecords() {
     mutex_lock lock(mutex_);
     return std::move(memcpy_records_);
   }
 
+  // Returns timing events whose elapsed times have been consumed, so that
+  // later launches reuse them instead of creating fresh ones.  Events beyond
+  // the per-context pool limit are destroyed.  The events' context is
+  // expected to be current.
+  void RecycleEvents(CUcontext context, std::vector<CUevent>* events) {
+    mutex_lock lock(mutex_);
+    auto& pool = free_events_[context];
+    for (CUevent event : *events) {
+      if (pool.size() < kMaxPooledEventsPerContext) {
+        pool.push_back(event);
+      } else {
+        LogIfError(ToStatus(cuEventDestroy(event)));
+      }
+    }
+    events->clear();
+  }
+
  private:
+  // Creating CUDA events is not free, and under sustained launch rates event
+  // creation can fail, silently truncating the timeline.  Completed events
+  // are therefore recycled through a per-context free list, bounded so that
+  // a pathological step cannot pin event resources forever.
+  static const size_t kMaxPooledEventsPerContext = 1 << 16;
+
+  // Takes an event from the context's free list (or creates one if the list
+  // is empty) and records it on `stream`.
+  Status ObtainAndRecordEvent(CUevent* event, CUcontext context,
+                              CUstream stream)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    auto& pool = free_events_[context];
+    if (!pool.empty()) {
+      *event = pool.back();
+      pool.pop_back();
+      Status status = ToStatus(cuEventRecord(*event, stream));
+      if (!status.ok()) {
+        pool.push_back(*event);
+        *event = nullptr;
+      }
+      return status;
+    }
+    return CreateAndRecordEvent(event, stream);
+  }
+
   mutex mutex_;
   std::unordered_set<std::string> annotations_ GUARDED_BY(mutex_);
-  std::vector<KernelRecord> kernel_records_ GUARDED_BY(mutex_);
-  std::vector<MemcpyRecord> memcpy_records_ GUARDED_BY(mutex_);
+  // Deques rather than vectors: records are appended in fixed-size chunks and
+  // never relocated, so a CUPTI callback never stalls all launching threads
+  // behind a full reallocation of the record buffer.
+  std::deque<KernelRecord> kernel_records_ GUARDED_BY(mutex_);
+  std::deque<MemcpyRecord> memcpy_records_ GUARDED_BY(mutex_);
+  std::unordered_map<CUcontext, std::vector<CUevent>> free_events_
+      GUARDED_BY(mutex_);
 };
 
 // Instances register callbacks with CUPTI to notify the event recorder before
@@ -304,6 +364,8 @@ class CuptiCallbackHook {
                                     CudaEventRecorder* recorder) {
     switch (cbid) {
       case CUPTI_DRIVER_TRACE_CBID_cuLaunchKernel:
+      case CUPTI_DRIVER_TRACE_CBID_cuLaunchCooperativeKernelMultiDevice:
+      case CUPTI_DRIVER_TRACE_CBID_cuLaunchCooperativeKernel:
         recorder->StopKernel(*cbdata.correlationData);
         break;
       case CUPTI_DRIVER_TRACE_CBID_cuMemcpy:
@@ -691,13 +753,53 @@ class CudaEventCollector {
     TF_RETURN_IF_ERROR(Synchronize());
     end_walltime_us_ = Env::Default()->NowMicros();
 
+    int64 num_dropped = 0;
     for (const auto& record : kernel_records) {
+      if (!record.start_event || !record.stop_event) {
+        ++num_dropped;
+        continue;
+      }
       TF_RETURN_IF_ERROR(SaveRecord(record));
     }
     for (const auto& record : memcpy_records) {
+      if (!record.start_event || !record.stop_event) {
+        ++num_dropped;
+        continue;
+      }
       TF_RETURN_IF_ERROR(SaveRecord(record));
     }
+    if (num_dropped > 0) {
+      LOG(WARNING) << num_dropped
+                   << " device trace records lacked timing events; the device "
+                      "timeline is incomplete.";
+    }
 
+    return RecycleEvents(kernel_records, memcpy_records);
+  }
+
+  // Hands the consumed timing events (including the per-context end events)
+  // back to the recorder for reuse by subsequent traces.
+  Status RecycleEvents(const std::deque<KernelRecord>& kernel_records,
+                       const std::deque<MemcpyRecord>& memcpy_records) const {
+    absl::flat_hash_map<CUcontext, std::vector<CUevent>> events;
+    auto add_event = [&events](CUcontext context, CUevent event) {
+      if (event != nullptr) events[context].push_back(event);
+    };
+    for (const auto& record : kernel_records) {
+      add_event(record.context, record.start_event);
+      add_event(record.context, record.stop_event);
+    }
+    for (const auto& record : memcpy_records) {
+      add_event(record.context, record.start_event);
+      add_event(record.context, record.stop_event);
+    }
+    for (const auto& pair : context_infos_) {
+      add_event(pair.first, pair.second.end_event);
+    }
+    for (auto& pair : events) {
+      TF_RETURN_IF_ERROR(ToStatus(cuCtxSetCurrent(pair.first)));
+      recorder_->RecycleEvents(pair.first, &pair.second);
+    }
     return Status::OK();
   }
 
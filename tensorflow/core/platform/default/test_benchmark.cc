@@ -17,9 +17,21 @@ limitations under the License.
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 #include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
 #include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
@@ -28,12 +40,250 @@ limitations under the License.
 namespace tensorflow {
 namespace testing {
 
+namespace {
+
+// Hardware performance counters sampled around the timed portion of each
+// benchmark, enabled with the TF_BENCHMARK_PERF_COUNTERS environment variable
+// (Linux only, requires perf_event_open permission). Counters follow
+// StartTiming/StopTiming, so they cover exactly the reported iterations.
+// Note: counting covers the benchmark thread and threads it spawns afterwards
+// (inherit), not pre-existing pool threads.
+struct PerfCounterValues {
+  int64 cycles = 0;
+  int64 instructions = 0;
+  int64 cache_misses = 0;
+  int64 stalled_cycles = 0;
+  bool has_cache_misses = false;
+  bool has_stalled_cycles = false;
+};
+
+#if defined(__linux__)
+class PerfCounters {
+ public:
+  // Returns the process-wide instance, or nullptr if disabled or unavailable.
+  static PerfCounters* Get() {
+    static PerfCounters* counters = []() -> PerfCounters* {
+      const char* enabled = getenv("TF_BENCHMARK_PERF_COUNTERS");
+      if (enabled == nullptr || enabled[0] == '\0' || enabled[0] == '0') {
+        return nullptr;
+      }
+      PerfCounters* result = new PerfCounters;
+      if (result->cycles_fd_ < 0 || result->instructions_fd_ < 0) {
+        LOG(WARNING) << "TF_BENCHMARK_PERF_COUNTERS is set but "
+                        "perf_event_open failed; counters will not be "
+                        "reported (check /proc/sys/kernel/perf_event_paranoid)";
+        delete result;
+        return nullptr;
+      }
+      return result;
+    }();
+    return counters;
+  }
+
+  void Reset() {
+    for (int fd : {cycles_fd_, instructions_fd_, cache_misses_fd_,
+                   stalled_cycles_fd_}) {
+      if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    }
+  }
+
+  void Enable() {
+    for (int fd : {cycles_fd_, instructions_fd_, cache_misses_fd_,
+                   stalled_cycles_fd_}) {
+      if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  void Disable() {
+    for (int fd : {cycles_fd_, instructions_fd_, cache_misses_fd_,
+                   stalled_cycles_fd_}) {
+      if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+
+  PerfCounterValues Read() {
+    PerfCounterValues values;
+    values.cycles = ReadCounter(cycles_fd_);
+    values.instructions = ReadCounter(instructions_fd_);
+    values.has_cache_misses = cache_misses_fd_ >= 0;
+    values.cache_misses = ReadCounter(cache_misses_fd_);
+    values.has_stalled_cycles = stalled_cycles_fd_ >= 0;
+    values.stalled_cycles = ReadCounter(stalled_cycles_fd_);
+    return values;
+  }
+
+ private:
+  PerfCounters()
+      : cycles_fd_(OpenCounter(PERF_COUNT_HW_CPU_CYCLES)),
+        instructions_fd_(OpenCounter(PERF_COUNT_HW_INSTRUCTIONS)),
+        cache_misses_fd_(OpenCounter(PERF_COUNT_HW_CACHE_MISSES)),
+        stalled_cycles_fd_(
+            OpenCounter(PERF_COUNT_HW_STALLED_CYCLES_BACKEND)) {}
+
+  static int OpenCounter(uint64 config) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;
+    return syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                   /*group_fd=*/-1, /*flags=*/0);
+  }
+
+  static int64 ReadCounter(int fd) {
+    if (fd < 0) return 0;
+    uint64 value = 0;
+    if (read(fd, &value, sizeof(value)) != sizeof(value)) return 0;
+    return static_cast<int64>(value);
+  }
+
+  const int cycles_fd_;
+  const int instructions_fd_;
+  const int cache_misses_fd_;
+  const int stalled_cycles_fd_;
+};
+#else
+class PerfCounters {
+ public:
+  static PerfCounters* Get() { return nullptr; }
+  void Reset() {}
+  void Enable() {}
+  void Disable() {}
+  PerfCounterValues Read() { return PerfCounterValues(); }
+};
+#endif  // defined(__linux__)
+
+// Historical baseline support for regression testing.
+//
+// With TF_BENCHMARK_BASELINE_OUT=<file> each benchmark is repeated several
+// times and its median and median absolute deviation (MAD) of ns/iter are
+// written to <file> as tab-separated lines:
+//   <benchmark name> \t <median ns/iter> \t <MAD ns> \t <repeats>
+// With TF_BENCHMARK_BASELINE=<file> the same measurements are compared
+// against a previously recorded file and the process exits with a failure if
+// any benchmark regressed both by more than the relative tolerance
+// (TF_BENCHMARK_REGRESSION_TOLERANCE, default 0.05) and by more than three
+// times the combined MADs, so run-to-run noise does not trip the check.
+struct BaselineEntry {
+  double median_ns = 0;
+  double mad_ns = 0;
+};
+
+class BenchmarkBaseline {
+ public:
+  // Returns the process-wide instance, or nullptr when neither baseline
+  // environment variable is set.
+  static BenchmarkBaseline* Get() {
+    static BenchmarkBaseline* baseline = []() -> BenchmarkBaseline* {
+      const char* in = getenv("TF_BENCHMARK_BASELINE");
+      const char* out = getenv("TF_BENCHMARK_BASELINE_OUT");
+      if ((in == nullptr || in[0] == '\0') &&
+          (out == nullptr || out[0] == '\0')) {
+        return nullptr;
+      }
+      return new BenchmarkBaseline(in != nullptr ? in : "",
+                                   out != nullptr ? out : "");
+    }();
+    return baseline;
+  }
+
+  int repeats() const { return repeats_; }
+
+  // Records a measurement and, if a baseline was loaded, checks it. Returns
+  // false on a statistically significant regression and fills *message.
+  bool RecordAndCheck(const std::string& name, double median_ns, double mad_ns,
+                      std::string* message) {
+    measured_[name] = BaselineEntry{median_ns, mad_ns};
+    auto it = loaded_.find(name);
+    if (it == loaded_.end()) return true;
+    const BaselineEntry& base = it->second;
+    const double delta = median_ns - base.median_ns;
+    if (delta <= tolerance_ * base.median_ns) return true;
+    if (delta <= 3.0 * (mad_ns + base.mad_ns)) return true;
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "%s regressed: %.0f ns/iter vs baseline %.0f ns/iter "
+             "(+%.1f%%, noise %.0f ns)",
+             name.c_str(), median_ns, base.median_ns,
+             100.0 * delta / base.median_ns, mad_ns + base.mad_ns);
+    *message = buf;
+    return false;
+  }
+
+  // Writes the recorded measurements to TF_BENCHMARK_BASELINE_OUT, if set.
+  bool Flush() {
+    if (out_path_.empty()) return true;
+    FILE* f = fopen(out_path_.c_str(), "w");
+    if (f == nullptr) {
+      LOG(ERROR) << "Could not write benchmark baseline to " << out_path_;
+      return false;
+    }
+    for (const auto& entry : measured_) {
+      fprintf(f, "%s\t%.1f\t%.1f\t%d\n", entry.first.c_str(),
+              entry.second.median_ns, entry.second.mad_ns, repeats_);
+    }
+    fclose(f);
+    return true;
+  }
+
+ private:
+  BenchmarkBaseline(const std::string& in_path, const std::string& out_path)
+      : out_path_(out_path) {
+    const char* repeats = getenv("TF_BENCHMARK_REPEATS");
+    if (repeats != nullptr && atoi(repeats) > 0) repeats_ = atoi(repeats);
+    const char* tolerance = getenv("TF_BENCHMARK_REGRESSION_TOLERANCE");
+    if (tolerance != nullptr && atof(tolerance) > 0) {
+      tolerance_ = atof(tolerance);
+    }
+    if (in_path.empty()) return;
+    FILE* f = fopen(in_path.c_str(), "r");
+    if (f == nullptr) {
+      LOG(ERROR) << "Could not read benchmark baseline from " << in_path;
+      exit(EXIT_FAILURE);
+    }
+    char name[512];
+    double median, mad;
+    int base_repeats;
+    while (fscanf(f, "%511[^\t]\t%lf\t%lf\t%d\n", name, &median, &mad,
+                  &base_repeats) == 4) {
+      loaded_[name] = BaselineEntry{median, mad};
+    }
+    fclose(f);
+  }
+
+  const std::string out_path_;
+  int repeats_ = 5;
+  double tolerance_ = 0.05;
+  std::map<std::string, BaselineEntry> loaded_;
+  std::map<std::string, BaselineEntry> measured_;
+};
+
+// Returns the median of "samples" and the median absolute deviation in *mad.
+double MedianAndMAD(std::vector<double> samples, double* mad) {
+  std::sort(samples.begin(), samples.end());
+  const double median = samples[samples.size() / 2];
+  for (double& sample : samples) {
+    sample = std::abs(sample - median);
+  }
+  std::sort(samples.begin(), samples.end());
+  *mad = samples[samples.size() / 2];
+  return median;
+}
+
+}  // namespace
+
 static std::vector<Benchmark*>* all_benchmarks = nullptr;
 static std::string label;
 static int64 bytes_processed;
 static int64 items_processed;
 static int64 accum_time = 0;
 static int64 start_time = 0;
+static PerfCounterValues perf_counter_values;
+static bool have_perf_counter_values = false;
 static Env* env;
 
 Benchmark::Benchmark(const char* name, void (*fn)(int))
@@ -142,6 +392,9 @@ void Benchmark::Run(const char* pattern) {
     }
   }
 
+  BenchmarkBaseline* baseline = BenchmarkBaseline::Get();
+  std::vector<std::string> regressions;
+
   printf("%-*s %10s %10s\n", width, "Benchmark", "Time(ns)", "Iterations");
   printf("%s\n", string(width + 22, '-').c_str());
   for (auto b : *all_benchmarks) {
@@ -161,7 +414,25 @@ void Benchmark::Run(const char* pattern) {
 
       int iters;
       double seconds;
-      b->Run(arg.first, arg.second, &iters, &seconds);
+      double time_ns;
+      if (baseline != nullptr) {
+        // Repeat the measurement so the baseline captures run-to-run noise
+        // and the regression check can tell signal from jitter.
+        std::vector<double> samples;
+        for (int rep = 0; rep < baseline->repeats(); ++rep) {
+          b->Run(arg.first, arg.second, &iters, &seconds);
+          samples.push_back(seconds * 1e9 / iters);
+        }
+        double mad;
+        time_ns = MedianAndMAD(samples, &mad);
+        std::string message;
+        if (!baseline->RecordAndCheck(name, time_ns, mad, &message)) {
+          regressions.push_back(message);
+        }
+      } else {
+        b->Run(arg.first, arg.second, &iters, &seconds);
+        time_ns = seconds * 1e9 / iters;
+      }
 
       char buf[100];
       std::string full_label = label;
@@ -175,8 +446,24 @@ void Benchmark::Run(const char* pattern) {
                  (items_processed * 1e-6) / seconds);
         full_label += buf;
       }
-      printf("%-*s %10.0f %10d\t%s\n", width, name.c_str(),
-             seconds * 1e9 / iters, iters, full_label.c_str());
+      if (have_perf_counter_values && perf_counter_values.cycles > 0) {
+        const PerfCounterValues& perf = perf_counter_values;
+        snprintf(buf, sizeof(buf), " IPC=%.2f",
+                 static_cast<double>(perf.instructions) / perf.cycles);
+        full_label += buf;
+        if (perf.has_cache_misses) {
+          snprintf(buf, sizeof(buf), " LLC-miss/iter=%.1f",
+                   static_cast<double>(perf.cache_misses) / iters);
+          full_label += buf;
+        }
+        if (perf.has_stalled_cycles) {
+          snprintf(buf, sizeof(buf), " stalled=%.1f%%",
+                   100.0 * perf.stalled_cycles / perf.cycles);
+          full_label += buf;
+        }
+      }
+      printf("%-*s %10.0f %10d\t%s\n", width, name.c_str(), time_ns, iters,
+             full_label.c_str());
 
       TestReporter reporter(name);
       Status s = reporter.Initialize();
@@ -197,6 +484,18 @@ void Benchmark::Run(const char* pattern) {
       }
     }
   }
+
+  if (baseline != nullptr) {
+    if (!baseline->Flush()) {
+      exit(EXIT_FAILURE);
+    }
+    if (!regressions.empty()) {
+      for (const std::string& message : regressions) {
+        LOG(ERROR) << message;
+      }
+      exit(EXIT_FAILURE);
+    }
+  }
 }
 
 void Benchmark::Register() {
@@ -210,12 +509,17 @@ void Benchmark::Run(int arg1, int arg2, int* run_count, double* run_seconds) {
   static const int64 kMaxIters = 1000000000;
   static const double kMinTime = 0.5;
   int64 iters = kMinIters;
+  PerfCounters* perf_counters = PerfCounters::Get();
   while (true) {
     accum_time = 0;
     start_time = env->NowMicros();
     bytes_processed = -1;
     items_processed = -1;
     label.clear();
+    if (perf_counters != nullptr) {
+      perf_counters->Reset();
+      perf_counters->Enable();
+    }
     if (fn0_) {
       (*fn0_)(iters);
     } else if (fn1_) {
@@ -226,6 +530,10 @@ void Benchmark::Run(int arg1, int arg2, int* run_count, double* run_seconds) {
     StopTiming();
     const double seconds = accum_time * 1e-6;
     if (seconds >= kMinTime || iters >= kMaxIters) {
+      have_perf_counter_values = perf_counters != nullptr;
+      if (perf_counters != nullptr) {
+        perf_counter_values = perf_counters->Read();
+      }
       *run_count = iters;
       *run_seconds = seconds;
       return;
@@ -249,10 +557,18 @@ void SetLabel(const std::string& l) { label = l; }
 void BytesProcessed(int64 n) { bytes_processed = n; }
 void ItemsProcessed(int64 n) { items_processed = n; }
 void StartTiming() {
-  if (start_time == 0) start_time = env->NowMicros();
+  if (start_time == 0) {
+    start_time = env->NowMicros();
+    if (PerfCounters* perf_counters = PerfCounters::Get()) {
+      perf_counters->Enable();
+    }
+  }
 }
 void StopTiming() {
   if (start_time != 0) {
+    if (PerfCounters* perf_counters = PerfCounters::Get()) {
+      perf_counters->Disable();
+    }
     accum_time += (env->NowMicros() - start_time);
     start_time = 0;
   }
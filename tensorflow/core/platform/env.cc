@@ -209,6 +209,51 @@ bool Env::FilesExist(const std::vector<string>& files,
   return result;
 }
 
+bool Env::StatFiles(const std::vector<string>& files,
+                    std::vector<FileStatistics>* stats,
+                    std::vector<Status>* status) {
+  // Group the files by file system so each file system can stat its own
+  // batch in parallel.
+  std::unordered_map<string, std::vector<string>> files_per_fs;
+  for (const auto& file : files) {
+    StringPiece scheme, host, path;
+    io::ParseURI(file, &scheme, &host, &path);
+    files_per_fs[string(scheme)].push_back(file);
+  }
+
+  std::unordered_map<string, FileStatistics> per_file_stat;
+  std::unordered_map<string, Status> per_file_status;
+  bool result = true;
+  for (auto itr : files_per_fs) {
+    FileSystem* file_system = file_system_registry_->Lookup(itr.first);
+    std::vector<FileStatistics> fs_stats;
+    std::vector<Status> fs_status;
+    if (!file_system) {
+      result = false;
+      Status s = errors::Unimplemented("File system scheme '", itr.first,
+                                       "' not implemented");
+      fs_stats.resize(itr.second.size());
+      fs_status.resize(itr.second.size(), s);
+    } else {
+      result &= file_system->StatFiles(itr.second, &fs_stats, &fs_status);
+    }
+    for (int i = 0; i < itr.second.size(); ++i) {
+      per_file_stat[itr.second[i]] = fs_stats[i];
+      per_file_status[itr.second[i]] = fs_status[i];
+    }
+  }
+
+  stats->clear();
+  for (const auto& file : files) {
+    stats->push_back(per_file_stat[file]);
+    if (status) {
+      status->push_back(per_file_status[file]);
+    }
+  }
+
+  return result;
+}
+
 Status Env::GetChildren(const string& dir, std::vector<string>* result) {
   FileSystem* fs;
   TF_RETURN_IF_ERROR(GetFileSystemForFile(dir, &fs));
@@ -146,6 +146,17 @@ class Env {
   bool FilesExist(const std::vector<string>& files,
                   std::vector<Status>* status);
 
+  /// \brief Stats all the listed files, issuing the per-file Stat calls in
+  /// parallel with bounded concurrency.
+  ///
+  /// Returns true if all the listed files were statted successfully, false
+  /// otherwise.  *stats is parallel to `files`; entries whose Stat failed
+  /// are left default-initialized.  If status is not null, it is populated
+  /// with a detailed status for each file.
+  bool StatFiles(const std::vector<string>& files,
+                 std::vector<FileStatistics>* stats,
+                 std::vector<Status>* status);
+
   /// \brief Stores in *result the names of the children of the specified
   /// directory. The names are relative to "dir".
   ///
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/file_system_helper.h"
 #include "tensorflow/core/platform/platform.h"
 
 namespace tensorflow {
@@ -71,6 +72,12 @@ bool FileSystem::FilesExist(const std::vector<string>& files,
   return result;
 }
 
+bool FileSystem::StatFiles(const std::vector<string>& files,
+                           std::vector<FileStatistics>* stats,
+                           std::vector<Status>* status) {
+  return internal::StatFilesInParallel(this, files, stats, status);
+}
+
 Status FileSystem::DeleteRecursively(const string& dirname,
                                      int64* undeleted_files,
                                      int64* undeleted_dirs) {
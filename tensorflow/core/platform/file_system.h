@@ -111,6 +111,18 @@ class FileSystem {
   virtual bool FilesExist(const std::vector<string>& files,
                           std::vector<Status>* status);
 
+  /// \brief Stats all the listed files, issuing the per-file Stat calls in
+  /// parallel with bounded concurrency.  This is much faster than a serial
+  /// Stat loop on file systems where Stat is a network round-trip.
+  ///
+  /// Returns true if all the listed files were statted successfully, false
+  /// otherwise.  *stats is resized to files.size(); entries whose Stat
+  /// failed are left default-initialized.  If status is not null, it is
+  /// resized and populated with a detailed status for each file.
+  virtual bool StatFiles(const std::vector<string>& files,
+                         std::vector<FileStatistics>* stats,
+                         std::vector<Status>* status);
+
   /// \brief Returns the immediate children in the given directory.
   ///
   /// The returned paths are relative to 'dir'.
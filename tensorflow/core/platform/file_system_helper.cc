@@ -126,5 +126,24 @@ Status GetMatchingPaths(FileSystem* fs, Env* env, const string& pattern,
   return ret;
 }
 
+bool StatFilesInParallel(FileSystem* fs, const std::vector<string>& files,
+                         std::vector<FileStatistics>* stats,
+                         std::vector<Status>* status) {
+  stats->clear();
+  stats->resize(files.size());
+  std::vector<Status> local_status(files.size());
+  ForEach(0, files.size(), [fs, &files, stats, &local_status](int i) {
+    local_status[i] = fs->Stat(files[i], &(*stats)[i]);
+  });
+  bool result = true;
+  for (const Status& s : local_status) {
+    result &= s.ok();
+  }
+  if (status != nullptr) {
+    *status = std::move(local_status);
+  }
+  return result;
+}
+
 }  // namespace internal
 }  // namespace tensorflow
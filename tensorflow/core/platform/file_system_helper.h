@@ -25,6 +25,7 @@ namespace tensorflow {
 
 class FileSystem;
 class Env;
+struct FileStatistics;
 
 namespace internal {
 
@@ -45,6 +46,23 @@ namespace internal {
 Status GetMatchingPaths(FileSystem* fs, Env* env, const string& pattern,
                         std::vector<string>* results);
 
+// Stats all the listed files on 'fs', issuing the per-file Stat calls in
+// parallel with bounded concurrency (except on iOS, where they run
+// serially).  This helper backs the default implementation of
+// FileSystem::StatFiles().
+//
+// Arguments:
+//   fs: may not be null.
+//   files: the paths to stat.
+//   stats: may not be null; resized to files.size().  Entries whose Stat
+//       failed are left default-initialized.
+//   status: if not null, resized and populated with the per-file status.
+//
+// Returns true if all the listed files were statted successfully.
+bool StatFilesInParallel(FileSystem* fs, const std::vector<string>& files,
+                         std::vector<FileStatistics>* stats,
+                         std::vector<Status>* status);
+
 }  // namespace internal
 }  // namespace tensorflow
 
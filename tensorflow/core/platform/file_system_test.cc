@@ -293,4 +293,54 @@ TEST(TestFileSystemTest, RootDirectory) {
   EXPECT_EQ("./test", results[0]);
 }
 
+// A file system with in-memory stat results, to exercise the parallel
+// StatFiles default implementation.
+class StatOnlyFileSystem : public NullFileSystem {
+ public:
+  void AddFile(const string& fname, int64 length) {
+    FileStatistics stat;
+    stat.length = length;
+    stats_[fname] = stat;
+  }
+
+  Status Stat(const string& fname, FileStatistics* stat) override {
+    auto found = stats_.find(fname);
+    if (found == stats_.end()) {
+      return Status(tensorflow::error::NOT_FOUND, "File does not exist");
+    }
+    *stat = found->second;
+    return Status::OK();
+  }
+
+ private:
+  std::map<string, FileStatistics> stats_;
+};
+
+TEST(StatFilesTest, ParallelStat) {
+  StatOnlyFileSystem fs;
+  std::vector<string> files;
+  // More files than the helper's thread budget, so scheduling is exercised.
+  for (int i = 0; i < 100; ++i) {
+    string fname = strings::StrCat("file-", i);
+    fs.AddFile(fname, i);
+    files.push_back(fname);
+  }
+  std::vector<FileStatistics> stats;
+  std::vector<Status> status;
+  EXPECT_TRUE(fs.StatFiles(files, &stats, &status));
+  ASSERT_EQ(files.size(), stats.size());
+  ASSERT_EQ(files.size(), status.size());
+  for (int i = 0; i < 100; ++i) {
+    TF_EXPECT_OK(status[i]);
+    EXPECT_EQ(i, stats[i].length);
+  }
+
+  // A missing file fails its own slot without affecting the others.
+  files.push_back("no-such-file");
+  EXPECT_FALSE(fs.StatFiles(files, &stats, &status));
+  ASSERT_EQ(files.size(), stats.size());
+  EXPECT_EQ(error::NOT_FOUND, status.back().code());
+  EXPECT_EQ(99, stats[99].length);
+}
+
 }  // namespace tensorflow
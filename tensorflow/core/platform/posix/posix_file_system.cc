@@ -27,6 +27,9 @@ limitations under the License.
 #include <time.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <cstring>
+
 #include "tensorflow/core/lib/core/error_codes.pb.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/strings/strcat.h"
@@ -41,16 +44,55 @@ namespace tensorflow {
 // 128KB of copy buffer
 constexpr size_t kPosixCopyFileBufferSize = 128 * 1024;
 
+// When streaming reads are enabled, drop consumed pages from the page cache
+// in batches of this size, so that a long sequential scan does not evict
+// everything else from the page cache.
+constexpr uint64 kPosixDropBehindChunkBytes = 8 * 1024 * 1024;
+
+// Whether files opened for random access should apply page cache hints for
+// sequential scans (POSIX_FADV_SEQUENTIAL at open, and drop-behind of the
+// consumed range while the reader makes sequential progress). Off by default;
+// set TF_POSIX_STREAMING_READS=1 for input pipelines that scan large files
+// once per epoch.
+static bool StreamingReadsEnabled() {
+  static const bool enabled = [] {
+    const char* value = getenv("TF_POSIX_STREAMING_READS");
+    return value != nullptr && strcmp(value, "1") == 0;
+  }();
+  return enabled;
+}
+
 // pread() based random-access
 class PosixRandomAccessFile : public RandomAccessFile {
  private:
   string filename_;
   int fd_;
+  const bool streaming_reads_;
+  // Sequential-scan progress, used only to decide when to issue advisory
+  // fadvise calls, so relaxed atomics are sufficient.
+  mutable std::atomic<uint64> last_read_end_{0};
+  mutable std::atomic<uint64> drop_behind_offset_{0};
 
  public:
   PosixRandomAccessFile(const string& fname, int fd)
-      : filename_(fname), fd_(fd) {}
-  ~PosixRandomAccessFile() override { close(fd_); }
+      : filename_(fname), fd_(fd), streaming_reads_(StreamingReadsEnabled()) {
+#if defined(__linux__) && !defined(__ANDROID__)
+    if (streaming_reads_) {
+      // Widen the kernel readahead window so a sequential scan keeps the
+      // device queue fed.
+      posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+  }
+  ~PosixRandomAccessFile() override {
+#if defined(__linux__) && !defined(__ANDROID__)
+    if (streaming_reads_) {
+      // A file scanned once should not linger in the page cache.
+      posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+    }
+#endif
+    close(fd_);
+  }
 
   Status Name(StringPiece* result) const override {
     *result = filename_;
@@ -76,8 +118,37 @@ class PosixRandomAccessFile : public RandomAccessFile {
       }
     }
     *result = StringPiece(scratch, dst - scratch);
+#if defined(__linux__) && !defined(__ANDROID__)
+    if (streaming_reads_ && s.ok()) {
+      AdviseSequentialRead(offset - (dst - scratch), offset);
+    }
+#endif
     return s;
   }
+
+ private:
+#if defined(__linux__) && !defined(__ANDROID__)
+  // Applies page cache hints after a read of [read_start, read_end). While the
+  // reader makes sequential progress, the consumed range is dropped from the
+  // page cache in kPosixDropBehindChunkBytes batches; a seek restarts the
+  // drop-behind tracking at the new position.
+  void AdviseSequentialRead(uint64 read_start, uint64 read_end) const {
+    if (read_start != last_read_end_.load(std::memory_order_relaxed)) {
+      drop_behind_offset_.store(read_start, std::memory_order_relaxed);
+    } else {
+      uint64 drop_start = drop_behind_offset_.load(std::memory_order_relaxed);
+      if (read_end - drop_start >= kPosixDropBehindChunkBytes) {
+        // posix_fadvise rounds partial pages inward, so the page containing
+        // `read_end` stays resident for the next read.
+        posix_fadvise(fd_, static_cast<off_t>(drop_start),
+                      static_cast<off_t>(read_end - drop_start),
+                      POSIX_FADV_DONTNEED);
+        drop_behind_offset_.store(read_end, std::memory_order_relaxed);
+      }
+    }
+    last_read_end_.store(read_end, std::memory_order_relaxed);
+  }
+#endif
 };
 
 class PosixWritableFile : public WritableFile {
@@ -22,8 +22,10 @@ limitations under the License.
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/summary.pb.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/db/sqlite.h"
 #include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/event.pb.h"
 
 // TODO(jart): Break this up into multiple files with excellent unit tests.
@@ -79,6 +81,15 @@ const int64 kPreallocateRows = 1000;
 // allow writers in other processes a chance to schedule.
 const uint64 kFlushBytes = 1024 * 1024;
 
+// All asynchronous SummaryDbWriters in the process share one writer thread,
+// so batch transactions from different writers never contend for the
+// database from multiple threads at once.
+thread::ThreadPool* SummaryDbWriterThreadPool() {
+  static thread::ThreadPool* pool =
+      new thread::ThreadPool(Env::Default(), "summary_db_writer", 1);
+  return pool;
+}
+
 double DoubleTime(uint64 micros) {
   // TODO(@jart): Follow precise definitions for time laid out in schema.
   // TODO(@jart): Use monotonic clock from gRPC codebase.
@@ -168,8 +179,11 @@ class IdAllocator {
   Status CreateNewId(int64* id) LOCKS_EXCLUDED(mu_) {
     mutex_lock lock(mu_);
     Status s;
-    SqliteStatement stmt;
-    TF_RETURN_IF_ERROR(db_->Prepare("INSERT INTO Ids (id) VALUES (?)", &stmt));
+    if (!insert_) {
+      TF_RETURN_IF_ERROR(
+          db_->Prepare("INSERT INTO Ids (id) VALUES (?)", &insert_));
+    }
+    SqliteStatement& stmt = insert_;
     for (int i = 0; i < kMaxIdCollisions; ++i) {
       int64 tid = MakeRandomId();
       stmt.BindInt(1, tid);
@@ -209,6 +223,7 @@ class IdAllocator {
   Env* const env_;
   Sqlite* const db_;
   int tier_ GUARDED_BY(mu_) = 0;
+  SqliteStatement insert_ GUARDED_BY(mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(IdAllocator);
 };
@@ -629,19 +644,22 @@ class SeriesWriter {
     DCHECK(series_ > 0);
   }
 
+  // `txn`, if non-null, must be the active transaction on `db`, and remains
+  // active on return; otherwise writes run in auto-commit mode as their own
+  // transactions.
   Status Append(Sqlite* db, int64 step, uint64 now, double computed_time,
-                const Tensor& t) SQLITE_TRANSACTIONS_EXCLUDED(*db)
+                const Tensor& t, SqliteTransaction* txn = nullptr)
       LOCKS_EXCLUDED(mu_) {
     mutex_lock lock(mu_);
     if (rowids_.empty()) {
-      Status s = Reserve(db, t);
+      Status s = Reserve(db, t, txn);
       if (!s.ok()) {
         rowids_.clear();
         return s;
       }
     }
     int64 rowid = rowids_.front();
-    Status s = Write(db, rowid, step, computed_time, t);
+    Status s = Write(db, rowid, step, computed_time, t, txn);
     if (s.ok()) {
       ++count_;
     }
@@ -673,16 +691,21 @@ class SeriesWriter {
 
  private:
   Status Write(Sqlite* db, int64 rowid, int64 step, double computed_time,
-               const Tensor& t) SQLITE_TRANSACTIONS_EXCLUDED(*db) {
+               const Tensor& t, SqliteTransaction* txn)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     if (t.dtype() == DT_STRING) {
       if (t.dims() == 0) {
         return Update(db, step, computed_time, t, t.scalar<string>()(), rowid);
+      } else if (txn != nullptr) {
+        TF_RETURN_IF_ERROR(
+            Update(db, step, computed_time, t, StringPiece(), rowid));
+        return UpdateNdString(db, t, rowid);
       } else {
-        SqliteTransaction txn(*db);
+        SqliteTransaction local_txn(*db);
         TF_RETURN_IF_ERROR(
             Update(db, step, computed_time, t, StringPiece(), rowid));
         TF_RETURN_IF_ERROR(UpdateNdString(db, t, rowid));
-        return txn.Commit();
+        return local_txn.Commit();
       }
     } else {
       return Update(db, step, computed_time, t, t.tensor_data(), rowid);
@@ -690,7 +713,8 @@ class SeriesWriter {
   }
 
   Status Update(Sqlite* db, int64 step, double computed_time, const Tensor& t,
-                const StringPiece& data, int64 rowid) {
+                const StringPiece& data, int64 rowid)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     const char* sql = R"sql(
       UPDATE OR REPLACE
         Tensors
@@ -703,29 +727,33 @@ class SeriesWriter {
       WHERE
         rowid = ?
     )sql";
-    SqliteStatement stmt;
-    TF_RETURN_IF_ERROR(db->Prepare(sql, &stmt));
-    stmt.BindInt(1, step);
-    stmt.BindDouble(2, computed_time);
-    stmt.BindInt(3, t.dtype());
-    stmt.BindText(4, StringifyShape(t.shape()));
-    stmt.BindBlobUnsafe(5, data);
-    stmt.BindInt(6, rowid);
-    TF_RETURN_IF_ERROR(stmt.StepAndReset());
+    if (!update_) {
+      TF_RETURN_IF_ERROR(db->Prepare(sql, &update_));
+    }
+    update_.BindInt(1, step);
+    update_.BindDouble(2, computed_time);
+    update_.BindInt(3, t.dtype());
+    update_.BindText(4, StringifyShape(t.shape()));
+    update_.BindBlobUnsafe(5, data);
+    update_.BindInt(6, rowid);
+    TF_RETURN_IF_ERROR(update_.StepAndReset());
     return Status::OK();
   }
 
   Status UpdateNdString(Sqlite* db, const Tensor& t, int64 tensor_rowid)
-      SQLITE_EXCLUSIVE_TRANSACTIONS_REQUIRED(*db) {
+      SQLITE_EXCLUSIVE_TRANSACTIONS_REQUIRED(*db)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     DCHECK_EQ(t.dtype(), DT_STRING);
     DCHECK_GT(t.dims(), 0);
     const char* deleter_sql = R"sql(
       DELETE FROM TensorStrings WHERE tensor_rowid = ?
     )sql";
-    SqliteStatement deleter;
-    TF_RETURN_IF_ERROR(db->Prepare(deleter_sql, &deleter));
-    deleter.BindInt(1, tensor_rowid);
-    TF_RETURN_WITH_CONTEXT_IF_ERROR(deleter.StepAndReset(), tensor_rowid);
+    if (!delete_strings_) {
+      TF_RETURN_IF_ERROR(db->Prepare(deleter_sql, &delete_strings_));
+    }
+    delete_strings_.BindInt(1, tensor_rowid);
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(delete_strings_.StepAndReset(),
+                                    tensor_rowid);
     const char* inserter_sql = R"sql(
       INSERT INTO TensorStrings (
         tensor_rowid,
@@ -733,32 +761,43 @@ class SeriesWriter {
         data
       ) VALUES (?, ?, ?)
     )sql";
-    SqliteStatement inserter;
-    TF_RETURN_IF_ERROR(db->Prepare(inserter_sql, &inserter));
+    if (!insert_strings_) {
+      TF_RETURN_IF_ERROR(db->Prepare(inserter_sql, &insert_strings_));
+    }
     auto flat = t.flat<string>();
     for (int64 i = 0; i < flat.size(); ++i) {
-      inserter.BindInt(1, tensor_rowid);
-      inserter.BindInt(2, i);
-      inserter.BindBlobUnsafe(3, flat(i));
-      TF_RETURN_WITH_CONTEXT_IF_ERROR(inserter.StepAndReset(), "i=", i);
+      insert_strings_.BindInt(1, tensor_rowid);
+      insert_strings_.BindInt(2, i);
+      insert_strings_.BindBlobUnsafe(3, flat(i));
+      TF_RETURN_WITH_CONTEXT_IF_ERROR(insert_strings_.StepAndReset(), "i=", i);
     }
     return Status::OK();
   }
 
-  Status Reserve(Sqlite* db, const Tensor& t) SQLITE_TRANSACTIONS_EXCLUDED(*db)
+  Status Reserve(Sqlite* db, const Tensor& t, SqliteTransaction* txn)
       EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    SqliteTransaction txn(*db);  // only for performance
+    if (txn != nullptr) {
+      unflushed_bytes_ = 0;
+      return ReserveLocked(db, txn, t);
+    }
+    SqliteTransaction local_txn(*db);  // only for performance
     unflushed_bytes_ = 0;
+    TF_RETURN_IF_ERROR(ReserveLocked(db, &local_txn, t));
+    return local_txn.Commit();
+  }
+
+  Status ReserveLocked(Sqlite* db, SqliteTransaction* txn, const Tensor& t)
+      SQLITE_EXCLUSIVE_TRANSACTIONS_REQUIRED(*db)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     if (t.dtype() == DT_STRING) {
       if (t.dims() == 0) {
-        TF_RETURN_IF_ERROR(ReserveData(db, &txn, t.scalar<string>()().size()));
+        return ReserveData(db, txn, t.scalar<string>()().size());
       } else {
-        TF_RETURN_IF_ERROR(ReserveTensors(db, &txn, kReserveMinBytes));
+        return ReserveTensors(db, txn, kReserveMinBytes);
       }
     } else {
-      TF_RETURN_IF_ERROR(ReserveData(db, &txn, t.tensor_data().size()));
+      return ReserveData(db, txn, t.tensor_data().size());
     }
-    return txn.Commit();
   }
 
   Status ReserveData(Sqlite* db, SqliteTransaction* txn, size_t size)
@@ -780,15 +819,16 @@ class SeriesWriter {
         data
       ) VALUES (?, ZEROBLOB(?))
     )sql";
-    SqliteStatement insert;
-    TF_RETURN_IF_ERROR(db->Prepare(sql, &insert));
+    if (!insert_tensors_) {
+      TF_RETURN_IF_ERROR(db->Prepare(sql, &insert_tensors_));
+    }
     // TODO(jart): Maybe preallocate index pages by setting step. This
     //             is tricky because UPDATE OR REPLACE can have a side
     //             effect of deleting preallocated rows.
     for (int64 i = 0; i < kPreallocateRows; ++i) {
-      insert.BindInt(1, series_);
-      insert.BindInt(2, reserved_bytes);
-      TF_RETURN_WITH_CONTEXT_IF_ERROR(insert.StepAndReset(), "i=", i);
+      insert_tensors_.BindInt(1, series_);
+      insert_tensors_.BindInt(2, reserved_bytes);
+      TF_RETURN_WITH_CONTEXT_IF_ERROR(insert_tensors_.StepAndReset(), "i=", i);
       rowids_.push_back(db->last_insert_rowid());
       unflushed_bytes_ += reserved_bytes;
       TF_RETURN_IF_ERROR(MaybeFlush(db, txn));
@@ -813,6 +853,11 @@ class SeriesWriter {
   uint64 count_ GUARDED_BY(mu_) = 0;
   std::deque<int64> rowids_ GUARDED_BY(mu_);
   uint64 unflushed_bytes_ GUARDED_BY(mu_) = 0;
+  // Prepared once and reused so the hot append path doesn't re-parse SQL.
+  SqliteStatement update_ GUARDED_BY(mu_);
+  SqliteStatement delete_strings_ GUARDED_BY(mu_);
+  SqliteStatement insert_strings_ GUARDED_BY(mu_);
+  SqliteStatement insert_tensors_ GUARDED_BY(mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(SeriesWriter);
 };
@@ -828,11 +873,12 @@ class RunWriter {
  public:
   explicit RunWriter(RunMetadata* meta) : meta_{meta} {}
 
+  // See SeriesWriter::Append for the meaning of `txn`.
   Status Append(Sqlite* db, int64 tag_id, int64 step, uint64 now,
-                double computed_time, const Tensor& t)
-      SQLITE_TRANSACTIONS_EXCLUDED(*db) LOCKS_EXCLUDED(mu_) {
+                double computed_time, const Tensor& t,
+                SqliteTransaction* txn = nullptr) LOCKS_EXCLUDED(mu_) {
     SeriesWriter* writer = GetSeriesWriter(tag_id);
-    return writer->Append(db, step, now, computed_time, t);
+    return writer->Append(db, step, now, computed_time, t, txn);
   }
 
   Status Finish(Sqlite* db) SQLITE_TRANSACTIONS_EXCLUDED(*db)
@@ -884,11 +930,25 @@ class SummaryDbWriter : public SummaryWriterInterface {
         run_{&meta_} {
     DCHECK(env_ != nullptr);
     db_->Ref();
+    // When TF_SUMMARY_DB_ASYNC_WRITES is set, tensor appends are queued and
+    // committed in batched multi-row transactions on a shared background
+    // thread, instead of one auto-commit transaction (and fsync, unless WAL
+    // journaling is on) per summary on the training thread.  Queued memory
+    // is bounded by TF_SUMMARY_DB_MAX_QUEUED_BYTES; writers block when the
+    // budget is exceeded.
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_SUMMARY_DB_ASYNC_WRITES", false,
+                                   &async_));
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_SUMMARY_DB_MAX_QUEUED_BYTES", 16 << 20,
+                                    &max_queued_bytes_));
   }
 
   ~SummaryDbWriter() override {
     core::ScopedUnref unref(db_);
-    Status s = run_.Finish(db_);
+    Status s = Flush();
+    if (!s.ok()) {
+      LOG(ERROR) << s.ToString();
+    }
+    s = run_.Finish(db_);
     if (!s.ok()) {
       // TODO(jart): Retry on transient errors here.
       LOG(ERROR) << s.ToString();
@@ -911,7 +971,17 @@ class SummaryDbWriter : public SummaryWriterInterface {
     }
   }
 
-  Status Flush() override { return Status::OK(); }
+  Status Flush() override {
+    {
+      mutex_lock lock(mu_);
+      if (!async_) {
+        return Status::OK();
+      }
+    }
+    // Acquiring txn_mu_ inside DrainQueue also waits out any drain already
+    // in flight on the writer thread.
+    return DrainQueue();
+  }
 
   Status WriteTensor(int64 global_step, Tensor t, const string& tag,
                      const string& serialized_metadata) override {
@@ -983,12 +1053,89 @@ class SummaryDbWriter : public SummaryWriterInterface {
     TF_RETURN_IF_ERROR(
         meta_.GetTagId(db_, now, computed_time, tag, &tag_id, metadata));
     TF_RETURN_WITH_CONTEXT_IF_ERROR(
-        run_.Append(db_, tag_id, step, now, computed_time, t),
-        meta_.user_name(), "/", meta_.experiment_name(), "/", meta_.run_name(),
-        "/", tag, "@", step);
+        Append(tag_id, step, now, computed_time, t), meta_.user_name(), "/",
+        meta_.experiment_name(), "/", meta_.run_name(), "/", tag, "@", step);
     return Status::OK();
   }
 
+  // Appends directly, or queues the append for the background writer thread
+  // when asynchronous writes are enabled.
+  Status Append(int64 tag_id, int64 step, uint64 now, double computed_time,
+                const Tensor& t) LOCKS_EXCLUDED(mu_) {
+    {
+      mutex_lock lock(mu_);
+      if (async_) {
+        queue_.push_back(PendingAppend{tag_id, step, now, computed_time, t});
+        queued_bytes_ += static_cast<int64>(t.TotalBytes());
+        ScheduleDrainLocked();
+        // Backpressure: block until the writer thread drains below the byte
+        // budget, bounding queue memory.
+        while (queued_bytes_ >= max_queued_bytes_) {
+          drained_.wait(lock);
+        }
+        return async_status_;
+      }
+    }
+    return run_.Append(db_, tag_id, step, now, computed_time, t);
+  }
+
+  void ScheduleDrainLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (drain_scheduled_) {
+      return;
+    }
+    drain_scheduled_ = true;
+    Ref();  // Balanced in the scheduled closure.
+    SummaryDbWriterThreadPool()->Schedule([this]() {
+      {
+        mutex_lock lock(mu_);
+        drain_scheduled_ = false;
+      }
+      DrainQueue().IgnoreError();
+      Unref();
+    });
+  }
+
+  // Writes all queued appends inside one transaction, committing every
+  // kFlushBytes.  Runs on the writer thread and, for Flush(), on the
+  // caller's thread.
+  Status DrainQueue() LOCKS_EXCLUDED(mu_) {
+    // txn_mu_ serializes batches so tensors are committed in the order they
+    // were queued; it is acquired before mu_.
+    mutex_lock txn_lock(txn_mu_);
+    std::vector<PendingAppend> batch;
+    {
+      mutex_lock lock(mu_);
+      queue_.swap(batch);
+      queued_bytes_ = 0;
+      drained_.notify_all();
+    }
+    Status s;
+    if (!batch.empty()) {
+      SqliteTransaction txn(*db_);  // only to increase performance
+      uint64 unflushed_bytes = 0;
+      for (const PendingAppend& p : batch) {
+        s = run_.Append(db_, p.tag_id, p.step, p.now, p.computed_time,
+                        p.tensor, &txn);
+        if (!s.ok()) break;
+        unflushed_bytes += p.tensor.TotalBytes();
+        if (unflushed_bytes >= kFlushBytes) {
+          s = txn.Commit();
+          if (!s.ok()) break;
+          unflushed_bytes = 0;
+        }
+      }
+      if (s.ok()) {
+        s = txn.Commit();
+      }
+    }
+    mutex_lock lock(mu_);
+    if (!s.ok()) {
+      LOG(ERROR) << "Failed to write queued summaries: " << s.ToString();
+      async_status_.Update(s);
+    }
+    return async_status_;
+  }
+
   Status MigrateEvent(std::unique_ptr<Event> e) {
     switch (e->what_case()) {
       case Event::WhatCase::kSummary: {
@@ -1055,7 +1202,7 @@ class SummaryDbWriter : public SummaryWriterInterface {
     int64 tag_id;
     TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
                                       &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Append(tag_id, e->step(), now, e->wall_time(), t);
   }
 
   // TODO(jart): Refactor Summary -> Tensor logic into separate file.
@@ -1068,7 +1215,7 @@ class SummaryDbWriter : public SummaryWriterInterface {
     PatchPluginName(s->mutable_metadata(), kScalarPluginName);
     TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
                                       &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Append(tag_id, e->step(), now, e->wall_time(), t);
   }
 
   Status MigrateHistogram(const Event* e, Summary::Value* s, uint64 now) {
@@ -1099,7 +1246,7 @@ class SummaryDbWriter : public SummaryWriterInterface {
     PatchPluginName(s->mutable_metadata(), kHistogramPluginName);
     TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
                                       &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Append(tag_id, e->step(), now, e->wall_time(), t);
   }
 
   Status MigrateImage(const Event* e, Summary::Value* s, uint64 now) {
@@ -1113,7 +1260,7 @@ class SummaryDbWriter : public SummaryWriterInterface {
     PatchPluginName(s->mutable_metadata(), kImagePluginName);
     TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
                                       &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Append(tag_id, e->step(), now, e->wall_time(), t);
   }
 
   Status MigrateAudio(const Event* e, Summary::Value* s, uint64 now) {
@@ -1126,14 +1273,36 @@ class SummaryDbWriter : public SummaryWriterInterface {
     PatchPluginName(s->mutable_metadata(), kAudioPluginName);
     TF_RETURN_IF_ERROR(meta_.GetTagId(db_, now, e->wall_time(), s->tag(),
                                       &tag_id, s->metadata()));
-    return run_.Append(db_, tag_id, e->step(), now, e->wall_time(), t);
+    return Append(tag_id, e->step(), now, e->wall_time(), t);
   }
 
+  // A tensor append waiting to be written by the background writer thread.
+  struct PendingAppend {
+    int64 tag_id;
+    int64 step;
+    uint64 now;
+    double computed_time;
+    Tensor tensor;
+  };
+
   Env* const env_;
   Sqlite* const db_;
   IdAllocator ids_;
   RunMetadata meta_;
   RunWriter run_;
+  bool async_ = false;
+  int64 max_queued_bytes_ = 0;
+  mutex mu_;
+  std::vector<PendingAppend> queue_ GUARDED_BY(mu_);
+  int64 queued_bytes_ GUARDED_BY(mu_) = 0;
+  bool drain_scheduled_ GUARDED_BY(mu_) = false;
+  // First write error observed on the writer thread; reported back on later
+  // appends and flushes so asynchronous failures are not silent.
+  Status async_status_ GUARDED_BY(mu_);
+  // Signalled whenever the queue has been swapped out for writing.
+  condition_variable drained_ GUARDED_BY(mu_);
+  // Serializes batch transactions; acquired before mu_.
+  mutex txn_mu_;
 };
 
 }  // namespace
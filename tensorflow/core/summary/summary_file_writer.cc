@@ -20,13 +20,25 @@ limitations under the License.
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/summary.pb.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/events_writer.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
 namespace {
 
+// All asynchronous summary writers in the process share one writer thread.
+// Event order within a writer is preserved because each task drains that
+// writer's whole queue, and summary I/O is rarely heavy enough to need more
+// than one thread.
+thread::ThreadPool* SummaryWriterThreadPool() {
+  static thread::ThreadPool* pool =
+      new thread::ThreadPool(Env::Default(), "summary_writer", 1);
+  return pool;
+}
+
 class SummaryFileWriter : public SummaryWriterInterface {
  public:
   SummaryFileWriter(int max_queue, int flush_millis, Env* env)
@@ -34,7 +46,17 @@ class SummaryFileWriter : public SummaryWriterInterface {
         is_initialized_(false),
         max_queue_(max_queue),
         flush_millis_(flush_millis),
-        env_(env) {}
+        env_(env) {
+    // When TF_SUMMARY_ASYNC_WRITES is set, queued events are written and
+    // flushed on a shared background thread instead of on the thread calling
+    // Write*(), so heavy image/histogram summaries do not stall training
+    // steps.  Queued memory is bounded by TF_SUMMARY_MAX_QUEUED_BYTES: lossy
+    // summary types (image, histogram, audio) are dropped when the writer
+    // thread falls behind, other events block until the queue drains.
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_SUMMARY_ASYNC_WRITES", false, &async_));
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_SUMMARY_MAX_QUEUED_BYTES", 16 << 20,
+                                    &max_queued_bytes_));
+  }
 
   Status Initialize(const string& logdir, const string& filename_suffix) {
     const Status is_dir = env_->IsDirectory(logdir);
@@ -44,6 +66,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
       }
       TF_RETURN_IF_ERROR(env_->RecursivelyCreateDir(logdir));
     }
+    mutex_lock fl(file_mu_);
     mutex_lock ml(mu_);
     events_writer_ =
         tensorflow::MakeUnique<EventsWriter>(io::JoinPath(logdir, "events"));
@@ -56,11 +79,14 @@ class SummaryFileWriter : public SummaryWriterInterface {
   }
 
   Status Flush() override {
-    mutex_lock ml(mu_);
-    if (!is_initialized_) {
-      return errors::FailedPrecondition("Class was not properly initialized.");
+    {
+      mutex_lock ml(mu_);
+      if (!is_initialized_) {
+        return errors::FailedPrecondition(
+            "Class was not properly initialized.");
+      }
     }
-    return InternalFlush();
+    return WriteQueuedEvents();
   }
 
   ~SummaryFileWriter() override {
@@ -106,7 +132,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
     e->set_wall_time(GetWallTime());
     TF_RETURN_IF_ERROR(
         AddTensorAsHistogramToSummary(t, tag, e->mutable_summary()));
-    return WriteEvent(std::move(e));
+    return EnqueueEvent(std::move(e), /*droppable=*/true);
   }
 
   Status WriteImage(int64 global_step, Tensor t, const string& tag,
@@ -116,7 +142,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
     e->set_wall_time(GetWallTime());
     TF_RETURN_IF_ERROR(AddTensorAsImageToSummary(t, tag, max_images, bad_color,
                                                  e->mutable_summary()));
-    return WriteEvent(std::move(e));
+    return EnqueueEvent(std::move(e), /*droppable=*/true);
   }
 
   Status WriteAudio(int64 global_step, Tensor t, const string& tag,
@@ -126,7 +152,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
     e->set_wall_time(GetWallTime());
     TF_RETURN_IF_ERROR(AddTensorAsAudioToSummary(
         t, tag, max_outputs, sample_rate, e->mutable_summary()));
-    return WriteEvent(std::move(e));
+    return EnqueueEvent(std::move(e), /*droppable=*/true);
   }
 
   Status WriteGraph(int64 global_step,
@@ -139,13 +165,7 @@ class SummaryFileWriter : public SummaryWriterInterface {
   }
 
   Status WriteEvent(std::unique_ptr<Event> event) override {
-    mutex_lock ml(mu_);
-    queue_.emplace_back(std::move(event));
-    if (queue_.size() > max_queue_ ||
-        env_->NowMicros() - last_flush_ > 1000 * flush_millis_) {
-      return InternalFlush();
-    }
-    return Status::OK();
+    return EnqueueEvent(std::move(event), /*droppable=*/false);
   }
 
   string DebugString() const override { return "SummaryFileWriter"; }
@@ -155,26 +175,113 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return static_cast<double>(env_->NowMicros()) / 1.0e6;
   }
 
-  Status InternalFlush() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    for (const std::unique_ptr<Event>& e : queue_) {
+  Status EnqueueEvent(std::unique_ptr<Event> event, bool droppable) {
+    bool flush_now = false;
+    {
+      mutex_lock ml(mu_);
+      if (async_ && droppable && queued_bytes_ >= max_queued_bytes_) {
+        // The writer thread has fallen behind; lossy summary types are
+        // dropped rather than allowed to grow the queue without bound.
+        ++num_dropped_;
+        return async_status_;
+      }
+      queued_bytes_ += event->ByteSizeLong();
+      queue_.emplace_back(std::move(event));
+      const bool should_flush =
+          queue_.size() > max_queue_ ||
+          env_->NowMicros() - last_flush_ > 1000 * flush_millis_;
+      if (async_) {
+        if (should_flush || queued_bytes_ >= max_queued_bytes_) {
+          ScheduleFlushLocked();
+        }
+        // Backpressure for events that must not be dropped: block until the
+        // writer thread drains below the byte budget.
+        while (queued_bytes_ >= max_queued_bytes_) {
+          drained_.wait(ml);
+        }
+        return async_status_;
+      }
+      flush_now = should_flush;
+    }
+    if (flush_now) {
+      return WriteQueuedEvents();
+    }
+    return Status::OK();
+  }
+
+  void ScheduleFlushLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (flush_scheduled_) {
+      return;
+    }
+    flush_scheduled_ = true;
+    Ref();  // Balanced in the scheduled closure.
+    SummaryWriterThreadPool()->Schedule([this]() {
+      {
+        mutex_lock ml(mu_);
+        flush_scheduled_ = false;
+      }
+      Status s = WriteQueuedEvents();
+      if (!s.ok()) {
+        LOG(ERROR) << "Failed to write queued summary events: " << s;
+      }
+      Unref();
+    });
+  }
+
+  // Writes and flushes all currently queued events.  Runs on the writer
+  // thread and, for a synchronous Flush(), on the caller's thread.
+  Status WriteQueuedEvents() LOCKS_EXCLUDED(mu_) {
+    // file_mu_ is acquired before swapping out the queue so that two
+    // concurrent drains cannot write their batches out of order.
+    mutex_lock fl(file_mu_);
+    std::vector<std::unique_ptr<Event>> to_write;
+    {
+      mutex_lock ml(mu_);
+      queue_.swap(to_write);
+      queued_bytes_ = 0;
+      if (num_dropped_ > 0) {
+        LOG(WARNING) << "Dropped " << num_dropped_
+                     << " lossy summary events under backpressure.";
+        num_dropped_ = 0;
+      }
+      drained_.notify_all();
+    }
+    for (const std::unique_ptr<Event>& e : to_write) {
       events_writer_->WriteEvent(*e);
     }
-    queue_.clear();
-    TF_RETURN_WITH_CONTEXT_IF_ERROR(events_writer_->Flush(),
-                                    "Could not flush events file.");
-    last_flush_ = env_->NowMicros();
+    const Status status = events_writer_->Flush();
+    {
+      mutex_lock ml(mu_);
+      last_flush_ = env_->NowMicros();
+      if (!status.ok()) {
+        async_status_.Update(status);
+      }
+    }
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(status, "Could not flush events file.");
     return Status::OK();
   }
 
   bool is_initialized_;
   const int max_queue_;
   const int flush_millis_;
+  bool async_ = false;
+  int64 max_queued_bytes_ = 0;
   uint64 last_flush_;
   Env* env_;
   mutex mu_;
   std::vector<std::unique_ptr<Event>> queue_ GUARDED_BY(mu_);
+  int64 queued_bytes_ GUARDED_BY(mu_) = 0;
+  int64 num_dropped_ GUARDED_BY(mu_) = 0;
+  bool flush_scheduled_ GUARDED_BY(mu_) = false;
+  // First write error observed on the writer thread; reported back on later
+  // writes so asynchronous failures are not silent.
+  Status async_status_ GUARDED_BY(mu_);
+  // Signalled whenever the queue has been swapped out for writing.
+  condition_variable drained_ GUARDED_BY(mu_);
+  // Serializes access to events_writer_; acquired before mu_.
+  mutex file_mu_;
   // A pointer to allow deferred construction.
-  std::unique_ptr<EventsWriter> events_writer_ GUARDED_BY(mu_);
+  std::unique_ptr<EventsWriter> events_writer_ GUARDED_BY(file_mu_);
   std::vector<std::pair<string, SummaryMetadata>> registered_summaries_
       GUARDED_BY(mu_);
 };
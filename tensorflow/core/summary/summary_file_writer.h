@@ -33,6 +33,11 @@ namespace tensorflow {
 /// filename_suffix. The caller owns a reference to result if the
 /// returned status is ok. The Env object must not be destroyed until
 /// after the returned writer.
+///
+/// If the environment variable TF_SUMMARY_ASYNC_WRITES is set, queued
+/// events are written and flushed on a shared background thread rather
+/// than on the thread calling the Write methods; Flush() still writes
+/// all queued events before returning.
 Status CreateSummaryFileWriter(int max_queue, int flush_millis,
                                const string& logdir,
                                const string& filename_suffix, Env* env,
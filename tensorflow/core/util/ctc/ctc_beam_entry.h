@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <memory>
+#include <new>
 #include <vector>
 
 #include "third_party/eigen3/Eigen/Core"
@@ -108,16 +109,74 @@ struct BeamEntry {
   TF_DISALLOW_COPY_AND_ASSIGN(BeamEntry);
 };
 
+// Recycles the storage of BeamEntry objects across searches.  A search tree
+// can easily reach tens of thousands of entries per utterance; with a pool,
+// the per-entry heap traffic is paid only while the pool grows to the
+// working-set size of the first utterance.  Entries are still constructed
+// and destroyed per search, only their storage is reused.  Not thread-safe;
+// use one pool per decoder.
+template <class CTCBeamState = EmptyBeamState>
+class BeamEntryPool {
+ public:
+  BeamEntryPool() {}
+  BeamEntryPool(const BeamEntryPool&) = delete;
+  BeamEntryPool& operator=(const BeamEntryPool&) = delete;
+
+  // Returns storage suitably sized and aligned for one BeamEntry.
+  void* Allocate() {
+    if (free_.empty()) {
+      chunks_.emplace_back(
+          new char[kEntriesPerChunk * sizeof(BeamEntry<CTCBeamState>)]);
+      char* chunk = chunks_.back().get();
+      for (int i = 0; i < kEntriesPerChunk; ++i) {
+        free_.push_back(chunk + i * sizeof(BeamEntry<CTCBeamState>));
+      }
+    }
+    void* storage = free_.back();
+    free_.pop_back();
+    return storage;
+  }
+
+  // Returns storage obtained from Allocate() to the pool.  The entry must
+  // already be destroyed.
+  void Recycle(void* storage) { free_.push_back(storage); }
+
+ private:
+  static const int kEntriesPerChunk = 256;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  std::vector<void*> free_;
+};
+
 // This class owns all instances of BeamEntry.  This is used to avoid recursive
 // destructor call during destruction.
 template <class CTCBeamState = EmptyBeamState>
 class BeamRoot {
  public:
-  BeamRoot(BeamEntry<CTCBeamState>* p, int l) { root_entry_ = AddEntry(p, l); }
+  // If `pool` is non-null the entries are placed in pooled storage, which
+  // the pool hands out again after this root is destroyed.  The pool must
+  // outlive the root.
+  BeamRoot(BeamEntry<CTCBeamState>* p, int l,
+           BeamEntryPool<CTCBeamState>* pool = nullptr)
+      : pool_(pool) {
+    root_entry_ = AddEntry(p, l);
+  }
   BeamRoot(const BeamRoot&) = delete;
   BeamRoot& operator=(const BeamRoot&) = delete;
 
+  ~BeamRoot() {
+    for (BeamEntry<CTCBeamState>* entry : pooled_entries_) {
+      entry->~BeamEntry();
+      pool_->Recycle(entry);
+    }
+  }
+
   BeamEntry<CTCBeamState>* AddEntry(BeamEntry<CTCBeamState>* p, int l) {
+    if (pool_ != nullptr) {
+      auto* new_entry =
+          new (pool_->Allocate()) BeamEntry<CTCBeamState>(p, l, this);
+      pooled_entries_.push_back(new_entry);
+      return new_entry;
+    }
     auto* new_entry = new BeamEntry<CTCBeamState>(p, l, this);
     beam_entries_.emplace_back(new_entry);
     return new_entry;
@@ -127,6 +186,9 @@ class BeamRoot {
  private:
   BeamEntry<CTCBeamState>* root_entry_ = nullptr;
   std::vector<std::unique_ptr<BeamEntry<CTCBeamState>>> beam_entries_;
+  // Entries living in pooled storage, owned by this root until destruction.
+  std::vector<BeamEntry<CTCBeamState>*> pooled_entries_;
+  BeamEntryPool<CTCBeamState>* pool_ = nullptr;
 };
 
 // BeamComparer is the default beam comparer provided in CTCBeamSearch.
@@ -74,6 +74,7 @@ class CTCBeamSearchDecoder : public CTCDecoder {
   //   P(l=abc? @ t=3) = P(a @ 0)*P(b @ 1)*P(c @ 2)*P(? @ 3)
   // but we calculate it recursively for speed purposes.
   typedef ctc_beam_search::BeamEntry<CTCBeamState> BeamEntry;
+  typedef ctc_beam_search::BeamEntryPool<CTCBeamState> BeamEntryPool;
   typedef ctc_beam_search::BeamRoot<CTCBeamState> BeamRoot;
   typedef ctc_beam_search::BeamProbability BeamProbability;
 
@@ -148,9 +149,18 @@ class CTCBeamSearchDecoder : public CTCDecoder {
   float label_selection_margin_ = -1;  // -1 means unlimited.
 
   gtl::TopN<BeamEntry*, CTCBeamComparer> leaves_;
+  // Storage pool backing beam_root_; reused across Reset() calls so repeated
+  // decodes stop allocating once the pool reaches the search's working set.
+  // Declared before beam_root_ so it outlives the root during destruction.
+  BeamEntryPool entry_pool_;
   std::unique_ptr<BeamRoot> beam_root_;
   BaseBeamScorer<CTCBeamState>* beam_scorer_;
 
+  // Scratch space for the top-K label selection in Step(), kept as members
+  // so the per-timestep pruning does not touch the heap.
+  std::vector<float> top_k_logits_;
+  std::vector<int> top_k_indices_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(CTCBeamSearchDecoder);
 };
 
@@ -246,8 +256,6 @@ template <typename CTCBeamState, typename CTCBeamComparer>
 template <typename Vector>
 void CTCBeamSearchDecoder<CTCBeamState, CTCBeamComparer>::Step(
     const Vector& raw_input) {
-  std::vector<float> top_k_logits;
-  std::vector<int> top_k_indices;
   const bool top_k =
       (label_selection_size_ > 0 && label_selection_size_ < raw_input.size());
   // Number of character classes to consider in each step.
@@ -255,8 +263,8 @@ void CTCBeamSearchDecoder<CTCBeamState, CTCBeamComparer>::Step(
   // Get max coefficient and remove it from raw_input later.
   float max_coeff;
   if (top_k) {
-    max_coeff = GetTopK(label_selection_size_, raw_input, &top_k_logits,
-                        &top_k_indices);
+    max_coeff = GetTopK(label_selection_size_, raw_input, &top_k_logits_,
+                        &top_k_indices_);
   } else {
     max_coeff = raw_input.maxCoeff();
   }
@@ -335,8 +343,8 @@ void CTCBeamSearchDecoder<CTCBeamState, CTCBeamComparer>::Step(
     }
 
     for (int ind = 0; ind < max_classes; ind++) {
-      const int label = top_k ? top_k_indices[ind] : ind;
-      const float logit = top_k ? top_k_logits[ind] : raw_input(ind);
+      const int label = top_k ? top_k_indices_[ind] : ind;
+      const float logit = top_k ? top_k_logits_[ind] : raw_input(ind);
       // Perform label selection: if input for this label looks very
       // unpromising, never evaluate it with a scorer.
       // We may compare logits instead of log probabilities, 
@@ -384,8 +392,9 @@ void CTCBeamSearchDecoder<CTCBeamState, CTCBeamComparer>::Reset() {
   leaves_.Reset();
 
   // This beam root, and all of its children, will be in memory until
-  // the next reset.
-  beam_root_.reset(new BeamRoot(nullptr, -1));
+  // the next reset.  Their storage comes from entry_pool_, which hands it
+  // out again for the next search.
+  beam_root_.reset(new BeamRoot(nullptr, -1, &entry_pool_));
   beam_root_->RootEntry()->newp.total = 0.0;  // ln(1)
   beam_root_->RootEntry()->newp.blank = 0.0;  // ln(1)
 
@@ -180,6 +180,69 @@ TEST(CtcBeamSearch, DecodingWithAndWithoutDictionary) {
   }
 }
 
+TEST(CtcBeamSearch, RepeatedDecodesReuseEntryPool) {
+  const int batch_size = 1;
+  const int timesteps = 5;
+  const int top_paths = 3;
+  const int num_classes = 6;
+
+  // Plain decoder using hibernating beam search algorithm.  Decoding the same
+  // input repeatedly with one decoder instance recycles the pooled beam
+  // entries across the internal Reset() between utterances; the results must
+  // be identical on every run.
+  CTCBeamSearchDecoder<>::DefaultBeamScorer default_scorer;
+  CTCBeamSearchDecoder<> decoder(num_classes, 10 * top_paths, &default_scorer);
+
+  // Raw data containers (arrays of floats, ints, etc.).
+  int sequence_lengths[batch_size] = {timesteps};
+  float input_data_mat[timesteps][batch_size][num_classes] = {
+      {{0, 0.6, 0, 0.4, 0, 0}},
+      {{0, 0.5, 0, 0.5, 0, 0}},
+      {{0, 0.4, 0, 0.6, 0, 0}},
+      {{0, 0.4, 0, 0.6, 0, 0}},
+      {{0, 0.4, 0, 0.6, 0, 0}}};
+
+  // The CTCDecoder works with log-probs.
+  for (int t = 0; t < timesteps; ++t) {
+    for (int b = 0; b < batch_size; ++b) {
+      for (int c = 0; c < num_classes; ++c) {
+        input_data_mat[t][b][c] = std::log(input_data_mat[t][b][c]);
+      }
+    }
+  }
+
+  std::vector<CTCDecoder::Output> expected_output = {
+      {{1, 3}, {1, 3, 1}, {3, 1, 3}},
+  };
+
+  Eigen::Map<const Eigen::ArrayXi> seq_len(&sequence_lengths[0], batch_size);
+  std::vector<Eigen::Map<const Eigen::MatrixXf>> inputs;
+  inputs.reserve(timesteps);
+  for (int t = 0; t < timesteps; ++t) {
+    inputs.emplace_back(&input_data_mat[t][0][0], batch_size, num_classes);
+  }
+
+  float first_scores[top_paths] = {0.0};
+  for (int run = 0; run < 3; ++run) {
+    std::vector<CTCDecoder::Output> outputs(top_paths);
+    for (CTCDecoder::Output& output : outputs) {
+      output.resize(batch_size);
+    }
+    float score[batch_size][top_paths] = {{0.0}};
+    Eigen::Map<Eigen::MatrixXf> scores(&score[0][0], batch_size, top_paths);
+
+    EXPECT_TRUE(decoder.Decode(seq_len, inputs, &outputs, &scores).ok());
+    for (int path = 0; path < top_paths; ++path) {
+      EXPECT_EQ(outputs[path][0], expected_output[0][path]);
+      if (run == 0) {
+        first_scores[path] = score[0][path];
+      } else {
+        EXPECT_EQ(first_scores[path], score[0][path]);
+      }
+    }
+  }
+}
+
 TEST(CtcBeamSearch, AllBeamElementsHaveFiniteScores) {
   const int batch_size = 1;
   const int timesteps = 1;
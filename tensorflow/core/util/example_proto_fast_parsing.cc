@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
+#include <limits>
 #include <vector>
 
 #include "absl/base/casts.h"
@@ -64,6 +65,54 @@ constexpr uint8 kVarintTag(uint32 tag) { return (tag << 3) | 0; }
 constexpr uint8 kDelimitedTag(uint32 tag) { return (tag << 3) | 2; }
 constexpr uint8 kFixed32Tag(uint32 tag) { return (tag << 3) | 5; }
 
+template <typename R>
+auto MaybeReserve(R* r, size_t n) -> decltype(r->reserve(n), void()) {
+  r->reserve(n);
+}
+
+template <typename R>
+void MaybeReserve(R&& r, size_t n) {}
+
+// Decodes a run of packed varints directly from the stream's flat buffer,
+// a word at a time: an 8-byte load whose continuation bits (0x80) are all
+// clear holds eight complete single-byte varints, which is the common case
+// for the small integers that dominate feature lists. Words containing
+// longer varints fall back to CodedInputStream decoding, one varint at a
+// time, before rescanning.
+template <typename Result>
+bool ParsePackedVarint64List(protobuf::io::CodedInputStream* stream,
+                             Result* int64_list) {
+  constexpr uint64 kContinuationMask = 0x8080808080808080ULL;
+  while (!stream->ExpectAtEnd()) {
+    const void* ptr;
+    int size;
+    if (stream->GetDirectBufferPointer(&ptr, &size)) {
+      const uint8* base = static_cast<const uint8*>(ptr);
+      const int bounds = std::min(
+          size, static_cast<int>(std::min<int64>(
+                    stream->BytesUntilLimit(), std::numeric_limits<int>::max())));
+      int consumed = 0;
+      uint64 word;
+      while (bounds - consumed >= static_cast<int>(sizeof(word))) {
+        memcpy(&word, base + consumed, sizeof(word));
+        if ((word & kContinuationMask) != 0) break;
+        for (int i = 0; i < static_cast<int>(sizeof(word)); ++i) {
+          int64_list->push_back(static_cast<int64>(base[consumed + i]));
+        }
+        consumed += sizeof(word);
+      }
+      if (consumed > 0) {
+        if (!stream->Skip(consumed)) return false;
+        continue;
+      }
+    }
+    protobuf_uint64 n;  // There is no API for int64
+    if (!stream->ReadVarint64(&n)) return false;
+    int64_list->push_back(static_cast<int64>(n));
+  }
+  return true;
+}
+
 namespace parsed {
 
 // ParseDataType has to be called first, then appropriate ParseZzzzList.
@@ -240,11 +289,12 @@ class Feature {
         if (!stream.ReadVarint32(&packed_length)) return false;
         auto packed_limit = stream.PushLimit(packed_length);
 
-        while (!stream.ExpectAtEnd()) {
-          protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64>(n));
-        }
+        // Each varint occupies at least one byte, so packed_length bounds
+        // the number of elements; reserving it up front avoids repeated
+        // reallocation while accumulating, at the price of transient
+        // over-allocation when values need multi-byte varints.
+        MaybeReserve(int64_list, int64_list->size() + packed_length);
+        if (!ParsePackedVarint64List(&stream, int64_list)) return false;
 
         stream.PopLimit(packed_limit);
       } else {  // non-packed
@@ -462,6 +512,16 @@ void ParallelFor(const std::function<void(size_t)>& f, size_t n,
 
 enum class Type { Sparse, Dense };
 
+// Positional parse plan for a run of Examples that share the same wire
+// layout, which is the common case when one writer produced them: entry i
+// records which config entry the i-th feature (in parse order) resolved to
+// for the previous Example. A subsequent Example whose i-th feature name
+// matches the planned config name skips the per-feature hash and cuckoo
+// lookup entirely; any mismatch falls back to the hashed lookup and
+// re-records the plan entry.
+constexpr size_t kPlanNotInConfig = std::numeric_limits<size_t>::max();
+using FeatureParsePlan = std::vector<std::pair<size_t, Type>>;
+
 struct SparseBuffer {
   // Features are in one of the 3 vectors below depending on config's dtype.
   // Other 2 vectors remain empty.
@@ -545,7 +605,8 @@ Status FastParseSerializedExample(
     const string& serialized_example, const string& example_name,
     const size_t example_index, const Config& config,
     const PresizedCuckooMap<std::pair<size_t, Type>>& config_index,
-    SeededHasher hasher, std::vector<Tensor>* output_dense,
+    SeededHasher hasher, FeatureParsePlan* feature_plan,
+    std::vector<Tensor>* output_dense,
     std::vector<SparseBuffer>* output_varlen_dense,
     std::vector<SparseBuffer>* output_sparse,
     PerExampleFeatureStats* output_stats) {
@@ -578,22 +639,40 @@ Status FastParseSerializedExample(
     const StringPiece feature_name = name_and_feature.first;
     parsed::Feature& feature = name_and_feature.second;
 
-    std::pair<size_t, Type> d_and_type;
-    uint64 h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
-
-    size_t d = d_and_type.first;
-    bool is_dense = d_and_type.second == Type::Dense;
+    // Consult the positional plan first: Examples written by the same
+    // producer list their features in the same order, so the config entry
+    // resolved for position i in the previous Example usually applies here
+    // too and a single name comparison replaces the hash lookup.
+    if (feature_plan->size() <= i) {
+      feature_plan->resize(i + 1,
+                           std::make_pair(kPlanNotInConfig, Type::Dense));
+    }
+    std::pair<size_t, Type> d_and_type = (*feature_plan)[i];
+    const bool plan_hit =
+        d_and_type.first != kPlanNotInConfig &&
+        feature_name == (d_and_type.second == Type::Dense
+                             ? config.dense[d_and_type.first].feature_name
+                             : config.sparse[d_and_type.first].feature_name);
+    if (!plan_hit) {
+      uint64 h = hasher(feature_name);
+      if (!config_index.Find(h, &d_and_type)) {
+        (*feature_plan)[i] = std::make_pair(kPlanNotInConfig, Type::Dense);
+        continue;
+      }
 
-    {
       // Testing for PresizedCuckooMap collision.
       // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
-      const string& config_feature_name = is_dense
-                                              ? config.dense[d].feature_name
-                                              : config.sparse[d].feature_name;
+      const string& config_feature_name =
+          d_and_type.second == Type::Dense
+              ? config.dense[d_and_type.first].feature_name
+              : config.sparse[d_and_type.first].feature_name;
       if (feature_name != config_feature_name) continue;
+      (*feature_plan)[i] = d_and_type;
     }
 
+    size_t d = d_and_type.first;
+    bool is_dense = d_and_type.second == Type::Dense;
+
     auto example_error = [&](StringPiece suffix) {
       return errors::InvalidArgument("Name: ", example_name,
                                      ", Key: ", feature_name,
@@ -1100,6 +1179,9 @@ Status FastParseExample(const Config& config,
   auto ProcessMiniBatch = [&](size_t minibatch) {
     sparse_buffers[minibatch].resize(config.sparse.size());
     varlen_dense_buffers[minibatch].resize(config.dense.size());
+    // Per-minibatch positional plan: consecutive Examples typically share the
+    // same feature wire layout, letting later ones skip per-feature hashing.
+    FeatureParsePlan feature_plan;
     size_t start = first_example_of_minibatch(minibatch);
     size_t end = first_example_of_minibatch(minibatch + 1);
     for (size_t e = start; e < end; ++e) {
@@ -1110,7 +1192,7 @@ Status FastParseExample(const Config& config,
       status_of_minibatch[minibatch] = FastParseSerializedExample(
           serialized[e],
           (!example_names.empty() ? example_names[e] : "<unknown>"), e, config,
-          config_index, hasher, &fixed_dense_values,
+          config_index, hasher, &feature_plan, &fixed_dense_values,
           &varlen_dense_buffers[minibatch], &sparse_buffers[minibatch], stats);
       if (!status_of_minibatch[minibatch].ok()) break;
     }
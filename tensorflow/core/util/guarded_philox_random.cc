@@ -53,9 +53,12 @@ void GuardedPhiloxRandom::Init(random::PhiloxRandom::ResultType counter,
 
 random::PhiloxRandom GuardedPhiloxRandom::ReserveSamples128(int64 samples) {
   CHECK(initialized_);
-  mutex_lock lock(mu_);
+  // generator_ is immutable after Init(), so a reservation only needs to
+  // claim a disjoint range of the sample stream with one atomic add.
+  const int64 offset =
+      sample_offset_.fetch_add(samples, std::memory_order_relaxed);
   auto local = generator_;
-  generator_.Skip(samples);
+  local.Skip(offset);
   return local;
 }
 
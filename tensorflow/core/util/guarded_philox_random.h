@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_GUARDED_PHILOX_RANDOM_H_
 #define TENSORFLOW_CORE_UTIL_GUARDED_PHILOX_RANDOM_H_
 
+#include <atomic>
+
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/platform/macros.h"
@@ -71,7 +73,12 @@ class GuardedPhiloxRandom {
 
  private:
   mutex mu_;
-  random::PhiloxRandom generator_ GUARDED_BY(mu_);
+  // Written only by Init() and read-only afterwards; reservations are carved
+  // out of the stream by atomically advancing sample_offset_ instead of
+  // mutating the generator under a lock, so concurrent invocations of an op
+  // sharing one generator do not serialize on mu_.
+  random::PhiloxRandom generator_;
+  std::atomic<int64> sample_offset_{0};
   bool initialized_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(GuardedPhiloxRandom);
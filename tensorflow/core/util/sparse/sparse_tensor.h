@@ -384,6 +384,26 @@ void SparseTensor::Reorder(const VarDimArray& order) {
   auto ix_t = ix_.matrix<int64>();
   auto vals_t = vals_.vec<T>();
 
+  // Fast path: callers frequently reorder indices that are already sorted
+  // (e.g. an adjacency structure reused across many steps, or the output of
+  // an op that emits canonical ordering).  Detecting this costs one linear
+  // scan and skips the O(N log N) sort and the permutation swaps below.
+  bool already_sorted = true;
+  for (std::size_t n = 1; already_sorted && n < num_entries(); ++n) {
+    for (int di = 0; di < dims_; ++di) {
+      const int64 diff = ix_t(n, order[di]) - ix_t(n - 1, order[di]);
+      if (diff > 0) break;
+      if (diff < 0) {
+        already_sorted = false;
+        break;
+      }
+    }
+  }
+  if (already_sorted) {
+    order_ = ShapeArray(order.begin(), order.end());
+    return;
+  }
+
   std::vector<int64> reorder(num_entries());
   std::iota(reorder.begin(), reorder.end(), 0);
 
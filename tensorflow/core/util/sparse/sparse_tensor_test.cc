@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 
@@ -266,6 +267,39 @@ TEST(SparseTensorTest, SortingWorksCorrectly) {
   }
 }
 
+TEST(SparseTensorTest, ReorderOfSortedIndicesPreservesValues) {
+  int N = 4;
+  const int NDIM = 2;
+
+  Tensor ix(DT_INT64, TensorShape({N, NDIM}));
+  Tensor vals(DT_STRING, TensorShape({N}));
+
+  auto ix_t = ix.matrix<int64>();
+  auto vals_t = vals.vec<string>();
+  // Already sorted in standard lexicographic order.
+  ix_t(0, 0) = 0;
+  ix_t(0, 1) = 1;
+  ix_t(1, 0) = 0;
+  ix_t(1, 1) = 2;
+  ix_t(2, 0) = 1;
+  ix_t(2, 1) = 0;
+  ix_t(3, 0) = 2;
+  ix_t(3, 1) = 2;
+  for (int n = 0; n < N; ++n) vals_t(n) = strings::StrCat("hi", n);
+
+  TensorShape shape({5, 5});
+  SparseTensor st;
+  TF_ASSERT_OK(SparseTensor::Create(ix, vals, shape, &st));
+
+  // Reordering into the order the indices already satisfy takes the no-sort
+  // fast path; values must stay in place and the order must be recorded.
+  std::vector<int64> order{0, 1};
+  st.Reorder<string>(order);
+  TF_EXPECT_OK(st.IndicesValid());
+  EXPECT_EQ(st.order(), order);
+  for (int n = 0; n < N; ++n) EXPECT_EQ(vals_t(n), strings::StrCat("hi", n));
+}
+
 TEST(SparseTensorTest, ValidateIndicesFindsInvalid) {
   int N = 2;
   const int NDIM = 3;
@@ -19,6 +19,7 @@ limitations under the License.
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <numeric>
 #include <utility>
 
 #include "tensorflow/core/framework/register_types.h"
@@ -34,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/lib/core/coding.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/lib/hash/crc32c.h"
@@ -41,6 +43,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/table_builder.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_slice_util.h"
 
@@ -49,7 +52,7 @@ namespace tensorflow {
 // Versioning of the tensor bundle format.
 const int kTensorBundleMinProducer = 0;
 const int kTensorBundleMinConsumer = 0;
-const int kTensorBundleVersion = 1;
+const int kTensorBundleVersion = 2;
 
 // Size of our input buffer for streaming reads
 static const int kBufferSize = 1024 * 1024;
@@ -394,7 +397,8 @@ BundleWriter::BundleWriter(Env* env, StringPiece prefix, const Options& options)
       tmp_data_path_(strings::StrCat(DataFilename(prefix_, 0, 1), ".tempstate",
                                      random::New64())),
       out_(nullptr),
-      size_(0) {
+      size_(0),
+      has_tensor_references_(false) {
   status_ = env_->CreateDir(string(io::Dirname(prefix_)));
   if (!status_.ok() && !errors::IsAlreadyExists(status_)) {
     return;
@@ -487,6 +491,31 @@ Status BundleWriter::AddSlice(StringPiece full_tensor_key,
   return status_;
 }
 
+Status BundleWriter::AddTensorReference(StringPiece key,
+                                        const BundleEntryProto& ref_entry) {
+  if (!status_.ok()) return status_;
+  CHECK_NE(key, kHeaderEntryKey);
+  const string key_string(key);
+  if (entries_.find(key_string) != entries_.end()) {
+    status_ = errors::InvalidArgument("Adding duplicate key: ", key);
+    return status_;
+  }
+  if (ref_entry.data_file().empty() || !ref_entry.slices().empty()) {
+    status_ = errors::InvalidArgument(
+        "Tensor reference for key ", key,
+        " must name a data file and describe an unsliced tensor");
+    return status_;
+  }
+
+  // References carry their data file path explicitly, so "shard_id" is
+  // meaningless for them; zero it to keep it within this bundle's shards.
+  BundleEntryProto* entry = &entries_[key_string];
+  *entry = ref_entry;
+  entry->set_shard_id(0);
+  has_tensor_references_ = true;
+  return Status::OK();
+}
+
 // TODO(zongheng): on metadata write failure or !status_.ok(), consider removing
 // the orphaned data file.
 Status BundleWriter::Finish() {
@@ -518,7 +547,11 @@ Status BundleWriter::Finish() {
     if (!port::kLittleEndian) header.set_endianness(BundleHeaderProto::BIG);
     VersionDef* version = header.mutable_version();
     version->set_producer(kTensorBundleVersion);
-    version->set_min_consumer(kTensorBundleMinConsumer);
+    // Tensor references were introduced at version 2; consumers below that
+    // would silently read garbage from this bundle's own data files, so lock
+    // them out.  Bundles without references stay readable by any consumer.
+    version->set_min_consumer(has_tensor_references_ ? kTensorBundleVersion
+                                                     : kTensorBundleMinConsumer);
 
     builder.Add(kHeaderEntryKey, header.SerializeAsString());
 
@@ -601,15 +634,25 @@ static Status MergeOneBundle(Env* env, StringPiece prefix,
         return errors::InvalidArgument(
             "Merging bundles with conflicting endianness; inputs corrupted?");
       }
-      // Validates "version".
+      // Validates "version".  "min_consumer" may legitimately differ across
+      // the inputs -- a bundle declares a raised minimum only when it holds
+      // tensor references -- so the merged bundle takes the maximum and the
+      // equality check is performed on the remaining fields.
+      VersionDef curr = header.version();
+      VersionDef merged = merge_state->version;
+      const int32 max_min_consumer =
+          std::max(curr.min_consumer(), merged.min_consumer());
+      curr.set_min_consumer(max_min_consumer);
+      merged.set_min_consumer(max_min_consumer);
       string curr_version, merge_version;
-      header.version().SerializeToString(&curr_version);
-      merge_state->version.SerializeToString(&merge_version);
+      curr.SerializeToString(&curr_version);
+      merged.SerializeToString(&merge_version);
       if (curr_version != merge_version) {
         return errors::InvalidArgument(
             "Merging bundles with different format versions: merged ",
             merge_version, " vs. curr ", curr_version);
       }
+      merge_state->version.set_min_consumer(max_min_consumer);
     }
     num_shards = header.num_shards();
     iter->Next();
@@ -652,11 +695,17 @@ static Status MergeOneBundle(Env* env, StringPiece prefix,
       continue;
     }
 
-    // Key doesn't duplicate: a fresh tensor/slice entry.
-    auto result = merge_state->shard_ids.insert(
-        {DataFilename(prefix, to_merge_entry.shard_id(), num_shards),
-         merge_state->shard_ids.size()});
-    to_merge_entry.set_shard_id(result.first->second);
+    // Key doesn't duplicate: a fresh tensor/slice entry.  Entries referencing
+    // another bundle's data file keep their explicit path and do not occupy a
+    // shard in the merged bundle.
+    if (to_merge_entry.data_file().empty()) {
+      auto result = merge_state->shard_ids.insert(
+          {DataFilename(prefix, to_merge_entry.shard_id(), num_shards),
+           merge_state->shard_ids.size()});
+      to_merge_entry.set_shard_id(result.first->second);
+    } else {
+      to_merge_entry.set_shard_id(0);
+    }
     merge_state->entries[key] = to_merge_entry;
   }
   return Status::OK();
@@ -711,6 +760,119 @@ Status MergeBundles(Env* env, gtl::ArraySlice<string> prefixes,
   return status;
 }
 
+// Parallel and incremental bundle writing.
+
+namespace {
+
+// Returns true iff writing "val" would reproduce the stored entry
+// "base_entry" byte for byte: an unsliced plain-old-data tensor of the same
+// dtype and shape whose size and crc32c content fingerprint both match.
+bool TensorMatchesEntry(const Tensor& val, const BundleEntryProto& base_entry) {
+  if (!base_entry.slices().empty() || base_entry.dtype() != val.dtype() ||
+      TensorShape(base_entry.shape()) != val.shape() ||
+      !DataTypeCanUseMemcpy(val.dtype()) ||
+      base_entry.size() != val.TotalBytes()) {
+    return false;
+  }
+  const StringPiece data = val.tensor_data();
+  return crc32c::Unmask(base_entry.crc32c()) ==
+         crc32c::Value(data.data(), data.size());
+}
+
+}  // namespace
+
+Status WriteBundleInParallel(Env* env, StringPiece prefix,
+                             gtl::ArraySlice<std::pair<string, Tensor>> tensors,
+                             const ParallelBundleWriteOptions& options) {
+  if (options.num_shards < 1) {
+    return errors::InvalidArgument("num_shards must be positive, got: ",
+                                   options.num_shards);
+  }
+  // Opens the incremental base, if requested.  BundleReader is not
+  // thread-safe, so metadata lookups against it are serialized below; the
+  // checksum of each tensor's in-memory bytes is computed outside the lock.
+  std::unique_ptr<BundleReader> base_reader;
+  if (!options.incremental_base_prefix.empty()) {
+    base_reader.reset(new BundleReader(env, options.incremental_base_prefix));
+    TF_RETURN_IF_ERROR(base_reader->status());
+  }
+
+  // Assigns each tensor, largest first, to the least-loaded shard, so that
+  // the per-shard byte counts -- and hence the shard writers' finishing
+  // times -- stay roughly equal.
+  const int num_shards =
+      std::max<int>(1, std::min<int>(options.num_shards, tensors.size()));
+  std::vector<int> order(tensors.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&tensors](int a, int b) {
+    return tensors[a].second.TotalBytes() > tensors[b].second.TotalBytes();
+  });
+  std::vector<std::vector<int>> shard_members(num_shards);
+  std::vector<int64> shard_bytes(num_shards, 0);
+  for (int idx : order) {
+    const int shard =
+        std::min_element(shard_bytes.begin(), shard_bytes.end()) -
+        shard_bytes.begin();
+    shard_members[shard].push_back(idx);
+    shard_bytes[shard] += tensors[idx].second.TotalBytes();
+  }
+
+  std::vector<string> tmp_prefixes;
+  for (int i = 0; i < num_shards; ++i) {
+    tmp_prefixes.push_back(
+        strings::StrCat(prefix, ".par-tempstate-", i, "-", random::New64()));
+  }
+
+  std::vector<Status> shard_status(num_shards);
+  mutex base_mu;
+  {
+    thread::ThreadPool pool(env, "parallel_bundle_writer", num_shards);
+    for (int i = 0; i < num_shards; ++i) {
+      pool.Schedule([&, i] {
+        BundleWriter writer(env, tmp_prefixes[i], options.writer_options);
+        Status* s = &shard_status[i];
+        *s = writer.status();
+        for (int idx : shard_members[i]) {
+          if (!s->ok()) break;
+          const string& key = tensors[idx].first;
+          const Tensor& val = tensors[idx].second;
+          if (base_reader != nullptr && DataTypeCanUseMemcpy(val.dtype())) {
+            BundleEntryProto base_entry;
+            Status lookup_status;
+            {
+              mutex_lock l(base_mu);
+              lookup_status =
+                  base_reader->LookupTensorReference(key, &base_entry);
+            }
+            // A NotFound lookup (a fresh tensor) or changed contents fall
+            // through to a regular write.
+            if (lookup_status.ok() && TensorMatchesEntry(val, base_entry)) {
+              *s = writer.AddTensorReference(key, base_entry);
+              continue;
+            }
+          }
+          *s = writer.Add(key, val);
+        }
+        // Finish() also cleans up the temporary data file on failure.
+        const Status finish_status = writer.Finish();
+        if (s->ok()) *s = finish_status;
+      });
+    }
+  }  // Joins the shard writers.
+
+  Status status;
+  for (const Status& s : shard_status) status.Update(s);
+  if (!status.ok()) {
+    // Best-effort cleanup of the shards that did finish.
+    for (const string& p : tmp_prefixes) {
+      env->DeleteFile(MetaFilename(p)).IgnoreError();
+      env->DeleteFile(DataFilename(p, 0, 1)).IgnoreError();
+    }
+    return status;
+  }
+  return MergeBundles(env, tmp_prefixes, prefix);
+}
+
 // Interface for reading a tensor bundle.
 
 BundleReader::BundleReader(Env* env, StringPiece prefix)
@@ -768,7 +930,13 @@ BundleReader::~BundleReader() {
       delete pair.second->file();
     }
   }
+  for (auto pair : referenced_data_) {
+    if (pair.second != nullptr && pair.second->file() != nullptr) {
+      delete pair.second->file();
+    }
+  }
   gtl::STLDeleteValues(&data_);
+  gtl::STLDeleteValues(&referenced_data_);
   gtl::STLDeleteValues(&tensor_slices_);
 }
 
@@ -822,15 +990,31 @@ Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
     }
   }
 
-  // Open the data file if it has not been opened.
-  io::InputBuffer* buffered_file = data_[entry.shard_id()];
-  if (buffered_file == nullptr) {
-    std::unique_ptr<RandomAccessFile> file = nullptr;
-    TF_RETURN_IF_ERROR(env_->NewRandomAccessFile(
-        DataFilename(prefix_, entry.shard_id(), num_shards_), &file));
-    buffered_file = new io::InputBuffer(file.release(), kBufferSize);
-    // The InputBuffer and RandomAccessFile objects are both released in dtor.
-    data_[entry.shard_id()] = buffered_file;
+  // Open the data file if it has not been opened.  References produced by
+  // incremental saves name their data file explicitly; all other entries
+  // index into this bundle's own shards.
+  io::InputBuffer* buffered_file;
+  if (!entry.data_file().empty()) {
+    buffered_file = referenced_data_[entry.data_file()];
+    if (buffered_file == nullptr) {
+      std::unique_ptr<RandomAccessFile> file = nullptr;
+      TF_RETURN_IF_ERROR(env_->NewRandomAccessFile(entry.data_file(), &file));
+      buffered_file = new io::InputBuffer(file.release(), kBufferSize);
+      // The InputBuffer and RandomAccessFile objects are both released in
+      // dtor.
+      referenced_data_[entry.data_file()] = buffered_file;
+    }
+  } else {
+    buffered_file = data_[entry.shard_id()];
+    if (buffered_file == nullptr) {
+      std::unique_ptr<RandomAccessFile> file = nullptr;
+      TF_RETURN_IF_ERROR(env_->NewRandomAccessFile(
+          DataFilename(prefix_, entry.shard_id(), num_shards_), &file));
+      buffered_file = new io::InputBuffer(file.release(), kBufferSize);
+      // The InputBuffer and RandomAccessFile objects are both released in
+      // dtor.
+      data_[entry.shard_id()] = buffered_file;
+    }
   }
   CHECK(buffered_file != nullptr);
 
@@ -876,6 +1060,128 @@ Status BundleReader::GetValue(const BundleEntryProto& entry, Tensor* val) {
   return Status::OK();
 }
 
+namespace {
+
+// An allocator that hands out the bytes of a tensor stored inside a read-only
+// memory mapping of a bundle data file, modeled on the allocator backing
+// ImmutableConstantOp.  The mapping (and thus the tensor data) is shared with
+// every other process that maps the same file, and must never be written
+// through.  Deletes itself when the owning tensor buffer is deallocated.
+class MemoryMappedBundleAllocator : public Allocator {
+ public:
+  MemoryMappedBundleAllocator() {}
+
+  Status InitializeFromFileRegion(Env* env, const string& filename,
+                                  uint64 offset, uint64 size) {
+    TF_RETURN_IF_ERROR(
+        env->NewReadOnlyMemoryRegionFromFile(filename, &memory_region_));
+    if (offset + size > memory_region_->length()) {
+      return errors::DataLoss("Tensor data at offset ", offset, " with size ",
+                              size, " extends past end of data file ",
+                              filename);
+    }
+    data_ = static_cast<const char*>(memory_region_->data()) + offset;
+    size_ = size;
+    return Status::OK();
+  }
+
+  string Name() override { return "MemoryMappedBundleAllocator"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    if (reinterpret_cast<intptr_t>(data_) % alignment != 0) {
+      allocation_status_ = errors::FailedPrecondition(
+          "Tensor data is not stored at a ", alignment,
+          "-byte aligned offset; write the bundle with "
+          "BundleWriter::Options::data_alignment to make it mappable");
+      return nullptr;
+    }
+    if (num_bytes > size_) {
+      allocation_status_ =
+          errors::Internal("Requested ", num_bytes,
+                           " bytes from a mapped tensor of ", size_, " bytes");
+      return nullptr;
+    }
+    return const_cast<char*>(data_);
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    if (delete_on_deallocate_) {
+      delete this;
+    }
+  }
+
+  const Status& allocation_status() const { return allocation_status_; }
+
+  // When the tensor buffer owns the allocator it is deleted on deallocation.
+  void set_delete_on_deallocate() { delete_on_deallocate_ = true; }
+
+ private:
+  std::unique_ptr<ReadOnlyMemoryRegion> memory_region_;
+  const char* data_ = nullptr;
+  uint64 size_ = 0;
+  // If there is an error during allocation we keep it in this status.
+  Status allocation_status_;
+  bool delete_on_deallocate_ = false;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(MemoryMappedBundleAllocator);
+};
+
+}  // namespace
+
+Status BundleReader::LookupMemoryMapped(StringPiece key, Tensor* val) {
+  CHECK(val != nullptr);
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+
+  // Only unsliced tensors of plain old data types can be backed by a file
+  // region; anything else takes the copying path below.
+  if (entry.slices().empty() && DataTypeCanUseMemcpy(entry.dtype())) {
+    std::unique_ptr<MemoryMappedBundleAllocator> allocator(
+        new MemoryMappedBundleAllocator);
+    Status mmap_status = allocator->InitializeFromFileRegion(
+        env_,
+        entry.data_file().empty()
+            ? DataFilename(prefix_, entry.shard_id(), num_shards_)
+            : entry.data_file(),
+        entry.offset(), entry.size());
+    if (mmap_status.ok()) {
+      Tensor mapped(allocator.get(), entry.dtype(), TensorShape(entry.shape()));
+      if (allocator->allocation_status().ok()) {
+        // The tensor buffer owns the allocator, and with it the mapping, from
+        // this point on.
+        allocator.release()->set_delete_on_deallocate();
+        *val = mapped;
+        return Status::OK();
+      }
+      mmap_status = allocator->allocation_status();
+    }
+    VLOG(1) << "Memory-mapped lookup of " << key
+            << " unavailable, reading a copy instead: " << mmap_status;
+  }
+
+  Tensor copied(entry.dtype(), TensorShape(entry.shape()));
+  TF_RETURN_IF_ERROR(Lookup(key, &copied));
+  *val = copied;
+  return Status::OK();
+}
+
+Status BundleReader::LookupTensorReference(StringPiece key,
+                                           BundleEntryProto* entry) {
+  CHECK(entry != nullptr);
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, entry));
+  if (!entry->slices().empty()) {
+    return errors::Unimplemented("Cannot reference sliced tensor keyed by ",
+                                 key);
+  }
+  // Resolves the shard id to a full path; entries that are themselves
+  // references already carry one, which keeps chains of incremental
+  // checkpoints one hop deep.
+  if (entry->data_file().empty()) {
+    entry->set_data_file(DataFilename(prefix_, entry->shard_id(), num_shards_));
+  }
+  return Status::OK();
+}
+
 Status BundleReader::Lookup(StringPiece key, Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
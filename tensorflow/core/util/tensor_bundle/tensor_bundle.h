@@ -66,6 +66,8 @@ limitations under the License.
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
@@ -91,6 +93,9 @@ class FileOutputBuffer;
 // History:
 // 0. Any tensor bundles produced before this field was added.
 // 1. Added this field (2016-09-14).
+// 2. Added "BundleEntryProto.data_file" tensor references, written by
+//    incremental saves.  Bundles that contain no references remain readable
+//    by version 1 consumers.
 extern const int kTensorBundleMinProducer;
 extern const int kTensorBundleMinConsumer;
 extern const int kTensorBundleVersion;
@@ -140,6 +145,16 @@ class BundleWriter {
                   const TensorShape& full_tensor_shape,
                   const TensorSlice& slice_spec, const Tensor& slice_tensor);
 
+  // Incremental checkpoint support.  Records under "key" a reference to a
+  // tensor whose bytes are already stored in another bundle, without copying
+  // them.  "ref_entry" must describe an unsliced tensor and name the data
+  // file holding its content (see BundleReader::LookupTensorReference()).
+  //
+  // The referenced data file must be kept alive for as long as the bundle
+  // written here may be read.  Bundles containing references can only be read
+  // by consumers at bundle format version >= 2.
+  Status AddTensorReference(StringPiece key, const BundleEntryProto& ref_entry);
+
   // Finishes the writer and flushes.
   Status Finish() TF_MUST_USE_RESULT;
 
@@ -154,6 +169,9 @@ class BundleWriter {
   std::unique_ptr<FileOutputBuffer> out_;
   int64 size_;  // Number of bytes written into out_.
   std::map<string, BundleEntryProto> entries_;
+  // True iff any entry references another bundle's data file; such bundles
+  // declare a higher minimum consumer version.
+  bool has_tensor_references_;
   Status status_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(BundleWriter);
@@ -175,6 +193,39 @@ class BundleWriter {
 Status MergeBundles(Env* env, gtl::ArraySlice<string> prefixes,
                     StringPiece merged_prefix);
 
+// Options for WriteBundleInParallel().
+struct ParallelBundleWriteOptions {
+  ParallelBundleWriteOptions() {}
+  // Number of data file shards to produce.  Each shard is written by its own
+  // thread, so this also bounds the write parallelism.
+  int num_shards{1};
+  // Options forwarded to each per-shard BundleWriter.
+  BundleWriter::Options writer_options;
+  // If nonempty, the prefix of an existing bundle to save incrementally
+  // against.  Tensors whose contents carry the same size and crc32c
+  // fingerprint as the entry of the same key in that bundle are recorded as
+  // references to its data files instead of being written again.
+  //
+  // The referenced data files become part of the new bundle and must be kept
+  // alive for as long as it may be read.  Bundles containing references can
+  // only be read by consumers at bundle format version >= 2.
+  string incremental_base_prefix;
+};
+
+// Writes "tensors" as a bundle at "prefix", distributing them across
+// "options.num_shards" data files written concurrently, each on its own
+// thread.  Tensors are balanced across the shards by byte size, and every
+// entry carries its own crc32c checksum, so each shard's contents remain
+// independently verifiable.  Produces the same logical bundle as adding all
+// tensors through a single BundleWriter, but the wall time is bounded by the
+// slowest shard rather than the sum of all writes.
+//
+// Duplicate keys in "tensors" are an error.  Returns OK iff all shards are
+// written and merged successfully.
+Status WriteBundleInParallel(Env* env, StringPiece prefix,
+                             gtl::ArraySlice<std::pair<string, Tensor>> tensors,
+                             const ParallelBundleWriteOptions& options);
+
 // On construction, silently attempts to read the metadata associated with
 // "prefix".  If caller intends to call any function afterwards, "status()"
 // must be checked.
@@ -218,6 +269,33 @@ class BundleReader {
   // REQUIRES: status().ok()
   Status Lookup(StringPiece key, Tensor* val) TF_MUST_USE_RESULT;
 
+  // Looks up the tensor keyed by "key" and, where possible, returns in "*val"
+  // a tensor backed directly by a read-only memory mapping of the bundle's
+  // data file instead of a freshly allocated copy.  Processes restoring the
+  // same bundle then share one physical copy of the data via the page cache.
+  // Unlike Lookup(), allocates "*val" itself, and the memory-mapped path does
+  // not validate the stored crc32c checksum.
+  //
+  // Only unsliced tensors of plain old data types whose data is stored at a
+  // suitably aligned offset can be mapped (see
+  // BundleWriter::Options::data_alignment); other tensors are returned as
+  // copies, equivalent to Lookup().
+  //
+  // The returned tensor must never be written through: its bytes may live in
+  // a read-only mapping, and writing to them is undefined behavior.
+  // REQUIRES: status().ok()
+  Status LookupMemoryMapped(StringPiece key, Tensor* val) TF_MUST_USE_RESULT;
+
+  // Incremental checkpoint support.  Looks up the metadata entry of the
+  // unsliced tensor keyed by "key", with the location of its bytes resolved
+  // to a full data file path, so that the entry can be handed to
+  // BundleWriter::AddTensorReference().  If the entry itself references
+  // another bundle's data file, that file is returned, keeping chains of
+  // incremental checkpoints one hop deep.
+  // REQUIRES: status().ok()
+  Status LookupTensorReference(StringPiece key, BundleEntryProto* entry)
+      TF_MUST_USE_RESULT;
+
   // Looks up the tensor pointed to by the internal iterator.
   //
   // On error, "val" may contain nonsense data.
@@ -292,6 +370,10 @@ class BundleReader {
   // Owned the InputBuffer objects and their underlying RandomAccessFile's.
   std::unordered_map<int32, io::InputBuffer*> data_;
 
+  // Like "data_", but holds the data files referenced through
+  // "BundleEntryProto.data_file" (incremental checkpoints), keyed by path.
+  std::unordered_map<string, io::InputBuffer*> referenced_data_;
+
   // Maps each partitioned tensor's key to its stored slices (represented in a
   // TensorSliceSet).  Populated on-demand.
   std::unordered_map<string, checkpoint::TensorSliceSet*> tensor_slices_;
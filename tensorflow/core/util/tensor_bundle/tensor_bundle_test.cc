@@ -830,6 +830,107 @@ TEST(TensorBundleTest, VersionTest) {
   }
 }
 
+TEST(TensorBundleTest, LookupMemoryMapped) {
+  // Bundles written with allocator alignment can be memory-mapped directly.
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = Allocator::kAllocatorAlignment;
+    BundleWriter writer(Env::Default(), Prefix("mmap"), opts);
+    TF_EXPECT_OK(writer.Add("bar", Constant_2x3<int32>(7)));
+    TF_EXPECT_OK(writer.Add("foo", Constant_2x3<float>(3)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  {
+    BundleReader reader(Env::Default(), Prefix("mmap"));
+    TF_ASSERT_OK(reader.status());
+    Tensor val;
+    TF_ASSERT_OK(reader.LookupMemoryMapped("bar", &val));
+    test::ExpectTensorEqual<int32>(val, Constant_2x3<int32>(7));
+    TF_ASSERT_OK(reader.LookupMemoryMapped("foo", &val));
+    test::ExpectTensorEqual<float>(val, Constant_2x3<float>(3));
+  }
+  // Tensors at unaligned offsets fall back to a copying read.
+  {
+    BundleWriter writer(Env::Default(), Prefix("mmap_unaligned"));
+    TF_EXPECT_OK(writer.Add("a", Constant(true, TensorShape({1}))));
+    TF_EXPECT_OK(writer.Add("b", Constant_2x3<float>(4)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  {
+    BundleReader reader(Env::Default(), Prefix("mmap_unaligned"));
+    TF_ASSERT_OK(reader.status());
+    Tensor val;
+    TF_ASSERT_OK(reader.LookupMemoryMapped("b", &val));
+    test::ExpectTensorEqual<float>(val, Constant_2x3<float>(4));
+  }
+  // String tensors are never mapped but still restore correctly.
+  {
+    Tensor strings(DT_STRING, TensorShape({2}));
+    strings.vec<string>()(0) = "hello";
+    strings.vec<string>()(1) = "world";
+    {
+      BundleWriter writer(Env::Default(), Prefix("mmap_string"));
+      TF_EXPECT_OK(writer.Add("strs", strings));
+      TF_ASSERT_OK(writer.Finish());
+    }
+    BundleReader reader(Env::Default(), Prefix("mmap_string"));
+    TF_ASSERT_OK(reader.status());
+    Tensor val;
+    TF_ASSERT_OK(reader.LookupMemoryMapped("strs", &val));
+    test::ExpectTensorEqual<string>(val, strings);
+  }
+}
+
+TEST(TensorBundleTest, ParallelWrite) {
+  std::vector<std::pair<string, Tensor>> tensors;
+  for (int i = 0; i < 8; ++i) {
+    tensors.emplace_back(strings::StrCat("tensor-", i), Constant_2x3<float>(i));
+  }
+  ParallelBundleWriteOptions options;
+  options.num_shards = 3;
+  TF_ASSERT_OK(WriteBundleInParallel(Env::Default(), Prefix("parallel"),
+                                     tensors, options));
+  // The data is spread over "num_shards" shard files...
+  for (int i = 0; i < 3; ++i) {
+    TF_EXPECT_OK(
+        Env::Default()->FileExists(DataFilename(Prefix("parallel"), i, 3)));
+  }
+  // ... and the merged bundle reads back like a serially written one.
+  BundleReader reader(Env::Default(), Prefix("parallel"));
+  TF_ASSERT_OK(reader.status());
+  for (int i = 0; i < 8; ++i) {
+    Expect<float>(&reader, strings::StrCat("tensor-", i),
+                  Constant_2x3<float>(i));
+  }
+}
+
+TEST(TensorBundleTest, IncrementalWrite) {
+  std::vector<std::pair<string, Tensor>> tensors;
+  tensors.emplace_back("frozen", Constant_2x3<float>(1));
+  tensors.emplace_back("trained", Constant_2x3<float>(2));
+  ParallelBundleWriteOptions options;
+  TF_ASSERT_OK(
+      WriteBundleInParallel(Env::Default(), Prefix("base"), tensors, options));
+
+  // Saves again with one tensor changed, incrementally against the base.
+  tensors[1].second = Constant_2x3<float>(3);
+  options.incremental_base_prefix = Prefix("base");
+  TF_ASSERT_OK(
+      WriteBundleInParallel(Env::Default(), Prefix("delta"), tensors, options));
+
+  BundleReader reader(Env::Default(), Prefix("delta"));
+  TF_ASSERT_OK(reader.status());
+  // The unchanged tensor is stored as a reference into the base bundle's data
+  // file; the changed tensor is written into the new bundle.
+  BundleEntryProto entry;
+  TF_ASSERT_OK(reader.LookupTensorReference("frozen", &entry));
+  EXPECT_EQ(DataFilename(Prefix("base"), 0, 1), entry.data_file());
+  TF_ASSERT_OK(reader.LookupTensorReference("trained", &entry));
+  EXPECT_EQ(DataFilename(Prefix("delta"), 0, 1), entry.data_file());
+  Expect<float>(&reader, "frozen", Constant_2x3<float>(1));
+  Expect<float>(&reader, "trained", Constant_2x3<float>(3));
+}
+
 class TensorBundleAlignmentTest : public ::testing::Test {
  protected:
   template <typename T>
@@ -15,13 +15,143 @@ limitations under the License.
 
 #include "tensorflow/core/util/work_sharder.h"
 
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
 #include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 /* ABSL_CONST_INIT */ thread_local int per_thread_max_parallism = 1000000;
 
+namespace {
+
+// Weight of the newest observation in the per-call-site cost EWMA.
+const double kCostEwmaAlpha = 0.25;
+// Shard boundaries are aligned to multiples of this many work units so two
+// threads rarely share the cache lines that span a boundary.
+const int64 kBlockAlignUnits = 16;
+// Minimum cost per shard; see Sharder::Do.
+const int64 kAdaptiveMinCostPerShard = 10000;
+
+// Learns per-call-site unit costs and shard placement for Shard() calls,
+// replacing the caller's cost_per_unit guess once a call site has been
+// observed.  Enabled via TF_ADAPTIVE_WORK_SHARDING; a call site is
+// identified by Shard()'s return address.
+class AdaptiveSharder {
+ public:
+  // Returns the process-wide instance, or nullptr when disabled.
+  static AdaptiveSharder* Global() {
+    static AdaptiveSharder* global = []() -> AdaptiveSharder* {
+      bool enabled = false;
+      TF_CHECK_OK(
+          ReadBoolFromEnvVar("TF_ADAPTIVE_WORK_SHARDING", false, &enabled));
+      return enabled ? new AdaptiveSharder : nullptr;
+    }();
+    return global;
+  }
+
+  void Shard(const void* site, int max_parallelism,
+             thread::ThreadPool* workers, int64 total, int64 cost_per_unit,
+             const std::function<void(int64, int64)>& work) {
+    const int num_workers = std::min(max_parallelism, workers->NumThreads());
+    double cost = static_cast<double>(std::max(int64{1}, cost_per_unit));
+    std::vector<int> hints;
+    {
+      mutex_lock l(mu_);
+      SiteStats& stats = sites_[site];
+      if (stats.cost_ewma > 0.0) cost = stats.cost_ewma;
+      hints = stats.last_thread;
+    }
+    const int num_shards = std::max<int64>(
+        1, std::min<int64>(
+               num_workers, static_cast<int64>(total * cost /
+                                               kAdaptiveMinCostPerShard)));
+    int64 block_size = (total + num_shards - 1) / num_shards;
+    if (block_size < total) {
+      block_size = (block_size + kBlockAlignUnits - 1) / kBlockAlignUnits *
+                   kBlockAlignUnits;
+    }
+    Env* env = Env::Default();
+    if (block_size >= total) {
+      const uint64 t0 = env->NowNanos();
+      work(0, total);
+      Update(site, static_cast<double>(env->NowNanos() - t0) / total, {});
+      return;
+    }
+    const int num_shards_used =
+        static_cast<int>((total + block_size - 1) / block_size);
+    // Per-shard bookkeeping lives on the stack; Shard() is synchronous, so
+    // it outlives every shard closure.
+    std::atomic<int64> work_ns(0);
+    std::vector<int> ran_on(num_shards_used, -1);
+    BlockingCounter counter(num_shards_used - 1);
+    int shard_idx = 1;
+    for (int64 start = block_size; start < total;
+         start += block_size, ++shard_idx) {
+      const int64 limit = std::min(start + block_size, total);
+      int* slot = &ran_on[shard_idx];
+      auto closure = [&work, &counter, &work_ns, workers, env, slot, start,
+                      limit]() {
+        const uint64 t0 = env->NowNanos();
+        work(start, limit);
+        work_ns.fetch_add(static_cast<int64>(env->NowNanos() - t0));
+        *slot = workers->CurrentThreadId();
+        counter.DecrementCount();
+      };
+      // Prefer the thread that ran this shard index last time, so repeated
+      // dispatches of the same range find their data still in cache.
+      const int hint = shard_idx < static_cast<int>(hints.size())
+                           ? hints[shard_idx]
+                           : -1;
+      if (hint >= 0 && hint < workers->NumThreads()) {
+        workers->ScheduleWithHint(closure, hint, hint + 1);
+      } else {
+        workers->Schedule(closure);
+      }
+    }
+    // Inline execute the 1st shard.
+    const uint64 t0 = env->NowNanos();
+    work(0, block_size);
+    work_ns.fetch_add(static_cast<int64>(env->NowNanos() - t0));
+    counter.Wait();
+    Update(site, static_cast<double>(work_ns.load()) / total,
+           std::move(ran_on));
+  }
+
+ private:
+  struct SiteStats {
+    double cost_ewma = 0.0;        // EWMA of observed ns per work unit.
+    std::vector<int> last_thread;  // Thread that last ran each shard index.
+  };
+
+  void Update(const void* site, double observed_cost,
+              std::vector<int> ran_on) {
+    mutex_lock l(mu_);
+    SiteStats& stats = sites_[site];
+    if (stats.cost_ewma > 0.0) {
+      stats.cost_ewma =
+          (1.0 - kCostEwmaAlpha) * stats.cost_ewma +
+          kCostEwmaAlpha * observed_cost;
+    } else {
+      stats.cost_ewma = observed_cost;
+    }
+    if (!ran_on.empty()) {
+      stats.last_thread = std::move(ran_on);
+    }
+  }
+
+  mutex mu_;
+  std::unordered_map<const void*, SiteStats> sites_ GUARDED_BY(mu_);
+};
+
+}  // namespace
+
 void SetPerThreadMaxParallelism(int max_parallelism) {
   CHECK_LE(0, max_parallelism);
   per_thread_max_parallism = max_parallelism;
@@ -41,6 +171,17 @@ void Shard(int max_parallelism, thread::ThreadPool* workers, int64 total,
     work(0, total);
     return;
   }
+#if defined(__GNUC__)
+  const void* site = __builtin_return_address(0);
+#else
+  const void* site = nullptr;
+#endif
+  AdaptiveSharder* adaptive = AdaptiveSharder::Global();
+  if (adaptive != nullptr && site != nullptr) {
+    adaptive->Shard(site, max_parallelism, workers, total, cost_per_unit,
+                    work);
+    return;
+  }
   if (max_parallelism >= workers->NumThreads()) {
     workers->ParallelFor(total, cost_per_unit, work);
     return;
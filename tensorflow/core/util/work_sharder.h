@@ -50,6 +50,11 @@ namespace tensorflow {
 // call SetMaxParallelism() so that all Shard() calls later limits the
 // thread parallelism.
 //
+// If the environment variable TF_ADAPTIVE_WORK_SHARDING is set, Shard()
+// replaces the caller's cost_per_unit with a per-call-site estimate learned
+// from observed execution times, and re-dispatches a given shard range to
+// the worker thread that ran it last for cache affinity.
+//
 // REQUIRES: max_parallelism >= 0
 // REQUIRES: workers != nullptr
 // REQUIRES: total >= 0
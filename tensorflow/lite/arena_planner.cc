@@ -64,8 +64,10 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
   // Invalidate any existing data.
   TF_LITE_ENSURE_STATUS(ResetAllocations());
   // The alloc_queue_ is specific to the graph topology, and will be
-  // completely reconstructed from graph data here.
+  // completely reconstructed from graph data here. Cached plans were computed
+  // against the old topology, so they go too.
   alloc_queue_.clear();
+  plan_cache_.clear();
 
   // Keeps track of references to each tensor.
   std::vector<int> refcounts(graph_info_->num_tensors(), 0);
@@ -184,13 +186,69 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
   return kTfLiteOk;
 }
 
+std::vector<size_t> ArenaPlanner::PlanSignature() const {
+  const size_t num_tensors = graph_info_->num_tensors();
+  std::vector<size_t> signature(2 * num_tensors);
+  for (size_t i = 0; i < num_tensors; ++i) {
+    const TfLiteTensor& tensor = *graph_info_->tensor(i);
+    signature[2 * i] = tensor.bytes;
+    signature[2 * i + 1] = static_cast<size_t>(tensor.allocation_type);
+  }
+  return signature;
+}
+
 TfLiteStatus ArenaPlanner::ExecuteAllocations(int first_node, int last_node) {
   // Grow the size of `allocs_` if necessary. This allows allocating temporary
   // tensors in op's `prepare` function.
   TF_LITE_ENSURE(context_, graph_info_->num_tensors() >= allocs_.size());
   allocs_.resize(graph_info_->num_tensors());
 
-  TF_LITE_ENSURE_STATUS(CalculateAllocations(first_node, last_node));
+  // Plans that cover the whole graph in one pass are fully determined by the
+  // tensor sizes, so they can be cached and reused when input shapes switch
+  // back to a signature seen before. Incremental plans for graphs with
+  // dynamic tensors depend on sizes only known mid-execution and are not
+  // cacheable.
+  const bool cacheable_plan =
+      first_node == 0 &&
+      last_node >= static_cast<int>(graph_info_->num_nodes()) - 1;
+  if (cacheable_plan) {
+    std::vector<size_t> signature = PlanSignature();
+    for (auto it = plan_cache_.begin(); it != plan_cache_.end(); ++it) {
+      if (it->signature == signature) {
+        // Restore the precomputed offsets and make sure the arenas are at
+        // least as large as when the plan was computed; no replanning.
+        allocs_ = it->allocs;
+        arena_.EnsureHighWaterMark(it->arena_high_water_mark);
+        persistent_arena_.EnsureHighWaterMark(it->persistent_high_water_mark);
+        plan_cache_.splice(plan_cache_.begin(), plan_cache_, it);
+        last_plan_from_cache_ = true;
+        TF_LITE_ENSURE_STATUS(Commit());
+        for (int i = 0; i < graph_info_->num_tensors(); ++i) {
+          TF_LITE_ENSURE_STATUS(ResolveTensorAllocation(i));
+        }
+        return kTfLiteOk;
+      }
+    }
+    TF_LITE_ENSURE_STATUS(CalculateAllocations(first_node, last_node));
+    last_plan_from_cache_ = false;
+    plan_cache_.push_front(CachedAllocationPlan{
+        std::move(signature), allocs_, arena_.GetHighWaterMark(),
+        persistent_arena_.GetHighWaterMark()});
+    if (plan_cache_.size() > kMaxCachedAllocationPlans) {
+      plan_cache_.pop_back();
+    }
+  } else if (last_plan_from_cache_) {
+    // Restoring from the cache bypassed the arenas' live-allocation
+    // bookkeeping, so an incremental extension cannot build on it. Replay the
+    // whole plan from scratch; being deterministic, it reproduces the cached
+    // offsets for the tensors planned so far.
+    TF_LITE_ENSURE_STATUS(arena_.Clear());
+    TF_LITE_ENSURE_STATUS(persistent_arena_.Clear());
+    last_plan_from_cache_ = false;
+    TF_LITE_ENSURE_STATUS(CalculateAllocations(0, last_node));
+  } else {
+    TF_LITE_ENSURE_STATUS(CalculateAllocations(first_node, last_node));
+  }
   TF_LITE_ENSURE_STATUS(Commit());
 
   for (int i = 0; i < graph_info_->num_tensors(); ++i) {
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_ARENA_PLANNER_H_
 #define TENSORFLOW_LITE_ARENA_PLANNER_H_
 
+#include <list>
 #include <memory>
 #include <vector>
 
@@ -28,6 +29,9 @@ namespace tflite {
 // Memory allocation tuning
 constexpr const int kDefaultArenaAlignment = 64;
 constexpr const int kDefaultTensorAlignment = 64;
+// Maximum number of computed allocation plans retained for reuse when input
+// shapes alternate between a few fixed signatures.
+constexpr const int kMaxCachedAllocationPlans = 4;
 
 struct AllocationInfo;
 
@@ -65,6 +69,22 @@ class ArenaPlanner : public MemoryPlanner {
   int64_t BasePointer(TfLiteAllocationType type);
 
  private:
+  // A fully computed allocation plan for one input-shape signature. Models
+  // that alternate between a few fixed input sizes (e.g. streaming models
+  // with two sequence lengths) trigger a full replan on every switch;
+  // caching the computed offsets and arena high water marks turns the switch
+  // into a copy of the precomputed plan instead.
+  struct CachedAllocationPlan {
+    std::vector<size_t> signature;
+    std::vector<ArenaAlloc> allocs;
+    size_t arena_high_water_mark;
+    size_t persistent_high_water_mark;
+  };
+
+  // Returns the per-tensor sizes and allocation types that fully determine
+  // the allocation plan, for use as a plan cache key.
+  std::vector<size_t> PlanSignature() const;
+
   // Make sure all the arenas have reserved enough memory to store all their
   // tensors.
   TfLiteStatus Commit();
@@ -120,6 +140,16 @@ class ArenaPlanner : public MemoryPlanner {
 
   // Number of bytes that tensor buffers should be aligned to.
   int tensor_alignment_;
+
+  // Cached allocation plans in most-recently-used order, at most
+  // kMaxCachedAllocationPlans entries. Cleared whenever the graph topology
+  // changes (PlanAllocations).
+  std::list<CachedAllocationPlan> plan_cache_;
+
+  // True if the current plan was restored from `plan_cache_`, in which case
+  // the arenas' live-allocation bookkeeping was bypassed and incremental
+  // extension of the plan must replay it from scratch.
+  bool last_plan_from_cache_ = false;
 };
 
 }  // namespace tflite
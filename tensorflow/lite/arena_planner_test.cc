@@ -506,6 +506,75 @@ TEST_F(ArenaPlannerTest, LargerGraphAndStepwiseAllocation) {
   EXPECT_EQ(GetOffset(10), 0);
 }
 
+TEST_F(ArenaPlannerTest, AlternatingInputSizesReusePlans) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+
+  auto all_offsets = [&]() {
+    std::vector<int64_t> offsets;
+    for (int i = 0; i <= 5; ++i) offsets.push_back(GetOffset(i));
+    return offsets;
+  };
+
+  // Plan with the "short sequence" sizes.
+  Execute(0, 10);
+  std::vector<int64_t> short_offsets = all_offsets();
+
+  // Switch to the "long sequence" sizes: full replan.
+  for (int i = 0; i <= 5; ++i) (*graph.tensors())[i].bytes = (i + 1) * 7;
+  CHECK(planner_->ResetAllocations() == kTfLiteOk);
+  Execute(0, 10);
+  std::vector<int64_t> long_offsets = all_offsets();
+
+  // Alternate between the two signatures several times. Each switch must be
+  // served from the plan cache and reproduce the original offsets exactly.
+  for (int iteration = 0; iteration < 3; ++iteration) {
+    for (int i = 0; i <= 5; ++i) (*graph.tensors())[i].bytes = (i + 1) * 3;
+    CHECK(planner_->ResetAllocations() == kTfLiteOk);
+    Execute(0, 10);
+    EXPECT_EQ(all_offsets(), short_offsets);
+
+    for (int i = 0; i <= 5; ++i) (*graph.tensors())[i].bytes = (i + 1) * 7;
+    CHECK(planner_->ResetAllocations() == kTfLiteOk);
+    Execute(0, 10);
+    EXPECT_EQ(all_offsets(), long_offsets);
+  }
+}
+
+TEST_F(ArenaPlannerTest, ModifiedGraphInvalidatesCachedPlans) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},  // First op
+                      {{2, 1}, {3}, {}},  // Second op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, 10);
+
+  TestGraph pruned_graph({0, 1},
+                         {
+                             /* in, out, tmp */
+                             {{0, 1}, {3}, {}},  // First op
+                         },
+                         {3});
+  SwapGraph(&pruned_graph);
+  // Same tensor sizes as before, but the topology changed, so the cached plan
+  // must not be reused.
+  Execute(0, 10);
+
+  EXPECT_EQ(GetOffset(0), 0);
+  EXPECT_EQ(GetOffset(1), GetOffsetAfter(0));
+  EXPECT_EQ(GetOffset(3), GetOffsetAfter(1));
+}
+
 TEST_F(ArenaPlannerTest, ModifiedGraph) {
   TestGraph graph({0, 1},
                   {
@@ -14,6 +14,14 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/lite/core/subgraph.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 #include "tensorflow/lite/arena_planner.h"
 #include "tensorflow/lite/c/c_api_internal.h"
 #include "tensorflow/lite/context_util.h"
@@ -146,6 +154,96 @@ class InterpreterInfo : public GraphInfo {
   Subgraph* subgraph_;
 };
 
+// A small pool of persistent worker threads used by InvokeParallel(). The
+// calling thread participates in every dispatch, so a pool sized for
+// `num_workers` spawns `num_workers - 1` threads.
+class Subgraph::InterOpWorkerPool {
+ public:
+  explicit InterOpWorkerPool(int num_workers) {
+    for (int i = 1; i < num_workers; ++i) {
+      workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+  }
+
+  ~InterOpWorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    work_available_.notify_all();
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Runs fn(i) for every i in [0, count), distributing the invocations over
+  // the workers and the calling thread. Returns once all invocations have
+  // finished. Not reentrant.
+  void ParallelFor(int count, const std::function<void(int)>& fn) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      fn_ = &fn;
+      count_ = count;
+      next_index_ = 0;
+      pending_ = count;
+      ++generation_;
+    }
+    work_available_.notify_all();
+    RunTasks();
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this]() { return pending_ == 0; });
+    fn_ = nullptr;
+  }
+
+ private:
+  // Claims and runs tasks until the current dispatch has none left.
+  void RunTasks() {
+    while (true) {
+      int index;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (next_index_ >= count_) return;
+        index = next_index_++;
+      }
+      (*fn_)(index);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_ == 0) {
+        work_done_.notify_all();
+      }
+    }
+  }
+
+  void WorkerLoop() {
+    int64_t last_generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_available_.wait(lock, [this, last_generation]() {
+          return shutdown_ || generation_ != last_generation;
+        });
+        if (shutdown_) return;
+        last_generation = generation_;
+      }
+      RunTasks();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable work_done_;
+  std::vector<std::thread> workers_;
+  // Valid only while a dispatch is in flight; `pending_ > 0` keeps the
+  // caller (and thus the pointee) alive until the last task completes.
+  const std::function<void(int)>* fn_ = nullptr;
+  int count_ = 0;
+  int next_index_ = 0;
+  int pending_ = 0;
+  // Incremented per dispatch so sleeping workers can tell new work from a
+  // spurious wakeup of an already drained dispatch.
+  int64_t generation_ = 0;
+  bool shutdown_ = false;
+};
+
 Subgraph::Subgraph(ErrorReporter* error_reporter,
                    TfLiteExternalContext** external_contexts,
                    std::vector<std::unique_ptr<Subgraph>>* subgraphs)
@@ -291,6 +389,7 @@ TfLiteStatus Subgraph::ReplaceNodeSubsetsWithDelegateKernels(
                                            &node_subsets);
 
   execution_plan_.clear();
+  InvalidateFrozenPlan();
 
   for (auto& node_subset : node_subsets) {
     // Subsets claimed by the delegate should have a "macro" op created, the
@@ -490,6 +589,11 @@ TfLiteStatus Subgraph::AllocateTensors() {
   }
 
   next_execution_plan_index_to_prepare_ = 0;
+  InvalidateFrozenPlan();
+  // A replan invalidates any reserved batch capacity plan;
+  // ReserveBatchCapacity() takes a fresh snapshot after this call returns.
+  batch_capacity_ = 0;
+  batch_capacity_plan_.clear();
   if (memory_planner_) {
     TF_LITE_ENSURE_STATUS(memory_planner_->ResetAllocations());
   }
@@ -498,6 +602,46 @@ TfLiteStatus Subgraph::AllocateTensors() {
 
   state_ = kStateInvokable;
 
+  // Partition the plan into dependency levels for parallel execution. Graphs
+  // with dynamic tensors fall back to sequential execution since incremental
+  // preparation relies on node order; so do graphs with delegate kernels or
+  // delegate-provided buffers, since the stale-buffer copies in the
+  // sequential loop mutate interpreter state.
+  if (parallel_execution_enabled_ && !has_dynamic_tensors_) {
+    bool has_delegates = false;
+    for (const TfLiteTensor& tensor : tensors_) {
+      if (tensor.delegate != nullptr) {
+        has_delegates = true;
+        break;
+      }
+    }
+    for (int node_index : execution_plan_) {
+      if (nodes_and_registration_[node_index].first.delegate != nullptr) {
+        has_delegates = true;
+        break;
+      }
+    }
+    if (!has_delegates) {
+      // InterpreterInfo indexes nodes by execution plan position, so
+      // partition over positions and map back to node indices.
+      std::vector<int> plan_positions(execution_plan_.size());
+      for (size_t i = 0; i < plan_positions.size(); ++i) {
+        plan_positions[i] = i;
+      }
+      InterpreterInfo info(this);
+      std::vector<std::vector<int>> levels;
+      TF_LITE_ENSURE_STATUS(PartitionExecutionPlanIntoDependencyLevels(
+          &info, plan_positions, &levels));
+      dependency_levels_.reserve(levels.size());
+      for (const std::vector<int>& level : levels) {
+        dependency_levels_.emplace_back();
+        for (int position : level) {
+          dependency_levels_.back().push_back(execution_plan_[position]);
+        }
+      }
+    }
+  }
+
   // Reset the variable tensors to zero after (re)allocating the tensors.
   // Developers shouldn't rely on the side effect of this function to reset
   // variable tensors. They should call `ResetVariableTensors` directly
@@ -536,6 +680,7 @@ TfLiteStatus Subgraph::AddNodeWithParameters(
     return kTfLiteError;
   }
   state_ = kStateUninvokable;
+  InvalidateFrozenPlan();
 
   TF_LITE_ENSURE_OK(context_, CheckTensorIndices("node inputs", inputs.data(),
                                                  inputs.size()));
@@ -611,6 +756,7 @@ TfLiteStatus Subgraph::ResizeInputTensor(int tensor_index,
   }
 
   state_ = kStateUninvokable;
+  InvalidateFrozenPlan();
   return ResizeTensorImpl(tensor, ConvertVectorToTfLiteIntArray(dims));
 }
 
@@ -648,7 +794,10 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
   if (!memory_planner_) {
     memory_planner_.reset(new ArenaPlanner(
         context_, std::unique_ptr<GraphInfo>(new InterpreterInfo(this)),
-        /*preserve_inputs=*/true, /*preserve_intermediates*/ false));
+        // Concurrently executing nodes must not reuse each other's tensor
+        // memory, so intermediates are preserved when running in parallel.
+        /*preserve_inputs=*/true,
+        /*preserve_intermediates=*/parallel_execution_enabled_));
     memory_planner_->PlanAllocations();
   }
 
@@ -663,6 +812,253 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
   return kTfLiteOk;
 }
 
+TfLiteStatus Subgraph::FreezePlan() {
+  InvalidateFrozenPlan();
+  if (!consistent_) {
+    ReportError("FreezePlan called on model that is not consistent.");
+    return kTfLiteError;
+  }
+  if (state_ == kStateUninvokable) {
+    ReportError("FreezePlan called on model that is not ready.");
+    return kTfLiteError;
+  }
+  if (nnapi_delegate_) {
+    ReportError("FreezePlan is not supported with the NNAPI delegate.");
+    return kTfLiteError;
+  }
+  if (next_execution_plan_index_to_prepare_ !=
+          static_cast<int>(execution_plan_.size()) ||
+      has_dynamic_tensors_) {
+    ReportError(
+        "FreezePlan requires a fully prepared plan with only static-size "
+        "tensors.");
+    return kTfLiteError;
+  }
+
+  frozen_plan_.reserve(execution_plan_.size());
+  for (int node_index : execution_plan_) {
+    TfLiteNode* node = &nodes_and_registration_[node_index].first;
+    const TfLiteRegistration& registration =
+        nodes_and_registration_[node_index].second;
+    if (registration.invoke == nullptr) {
+      frozen_plan_.clear();
+      return ReportOpError(context_, *node, registration, node_index,
+                           "has no invoke function; cannot freeze plan");
+    }
+    // The general loop copies stale delegate buffers back to raw memory
+    // before each node; that check is hoisted here by requiring that no
+    // input can ever become stale.
+    for (int i = 0; i < node->inputs->size; ++i) {
+      const int tensor_index = node->inputs->data[i];
+      if (tensor_index == kOptionalTensor) continue;
+      TfLiteTensor* tensor = &tensors_[tensor_index];
+      if (tensor->delegate && tensor->delegate != node->delegate) {
+        frozen_plan_.clear();
+        ReportError(
+            "FreezePlan is not supported with delegate-provided input "
+            "buffers.");
+        return kTfLiteError;
+      }
+    }
+    frozen_plan_.push_back(
+        FrozenPlanRecord{registration.invoke, node, &registration, node_index});
+  }
+  // Tensor pointers handed to kernels must stay valid for the lifetime of
+  // the frozen plan; the general loop re-checks this before every node.
+  EnsureTensorsVectorCapacity();
+  plan_frozen_ = true;
+  return kTfLiteOk;
+}
+
+TfLiteStatus Subgraph::SetParallelExecution(bool enable, int num_workers) {
+  if (state_ == kStateInvokableAndImmutable) {
+    ReportError("SetParallelExecution is disallowed when graph is immutable.");
+    return kTfLiteError;
+  }
+  if (enable && num_workers < 1) {
+    ReportError("SetParallelExecution requires at least one worker.");
+    return kTfLiteError;
+  }
+  if (enable == parallel_execution_enabled_ &&
+      (!enable || num_workers == num_inter_op_workers_)) {
+    return kTfLiteOk;
+  }
+  parallel_execution_enabled_ = enable;
+  num_inter_op_workers_ = enable ? num_workers : 0;
+  worker_pool_.reset();
+  // The memory plan depends on this setting (see PrepareOpsAndTensors), so
+  // discard the planner and replan on the next AllocateTensors().
+  memory_planner_.reset();
+  state_ = kStateUninvokable;
+  InvalidateFrozenPlan();
+  return kTfLiteOk;
+}
+
+TfLiteStatus Subgraph::ResizeInputsToBatch(int batch) {
+  for (int input_index : inputs_) {
+    TfLiteTensor* tensor = &context_->tensors[input_index];
+    if (tensor->dims == nullptr || tensor->dims->size == 0) continue;
+    if (tensor->dims->data[0] == batch) continue;
+    TfLiteIntArray* new_dims = TfLiteIntArrayCopy(tensor->dims);
+    new_dims->data[0] = batch;
+    TF_LITE_ENSURE_STATUS(ResizeTensorImpl(tensor, new_dims));
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus Subgraph::ReserveBatchCapacity(int max_batch) {
+  if (state_ == kStateInvokableAndImmutable) {
+    ReportError("ReserveBatchCapacity is disallowed when graph is immutable.");
+    return kTfLiteError;
+  }
+  if (max_batch < 1) {
+    ReportError("ReserveBatchCapacity requires a positive batch size.");
+    return kTfLiteError;
+  }
+  TF_LITE_ENSURE_STATUS(ResizeInputsToBatch(max_batch));
+  state_ = kStateUninvokable;
+  TF_LITE_ENSURE_STATUS(AllocateTensors());
+  if (has_dynamic_tensors_ ||
+      next_execution_plan_index_to_prepare_ !=
+          static_cast<int>(execution_plan_.size())) {
+    ReportError("ReserveBatchCapacity requires only static-size tensors.");
+    return kTfLiteError;
+  }
+  batch_capacity_plan_.resize(tensors_.size());
+  for (size_t i = 0; i < tensors_.size(); ++i) {
+    batch_capacity_plan_[i] = BatchCapacityRecord{
+        tensors_[i].bytes, tensors_[i].data.raw, tensors_[i].allocation_type};
+  }
+  batch_capacity_ = max_batch;
+  invocation_batch_size_ = max_batch;
+  return kTfLiteOk;
+}
+
+TfLiteStatus Subgraph::SetInvocationBatchSize(int batch) {
+  if (batch_capacity_ == 0) {
+    ReportError("SetInvocationBatchSize called without a reserved capacity.");
+    return kTfLiteError;
+  }
+  if (batch < 1 || batch > batch_capacity_) {
+    ReportError("Invocation batch size %d outside reserved capacity %d.",
+                batch, batch_capacity_);
+    return kTfLiteError;
+  }
+  if (state_ == kStateUninvokable) {
+    ReportError("SetInvocationBatchSize called on model that is not ready.");
+    return kTfLiteError;
+  }
+  if (batch == invocation_batch_size_) return kTfLiteOk;
+
+  // Re-propagate shapes at the new batch so kernels only loop over live
+  // rows. Resizing nulls the data pointer of every affected arena tensor;
+  // the pointers are restored from the capacity snapshot below, which stays
+  // valid as long as every tensor shrinks (or keeps its size) relative to
+  // the reserved plan.
+  TF_LITE_ENSURE_STATUS(ResizeInputsToBatch(batch));
+  int last_execution_plan_index_prepared = -1;
+  bool plan_still_valid =
+      PrepareOpsStartingAt(0, &last_execution_plan_index_prepared) ==
+          kTfLiteOk &&
+      !has_dynamic_tensors_ &&
+      last_execution_plan_index_prepared ==
+          static_cast<int>(execution_plan_.size()) - 1 &&
+      tensors_.size() == batch_capacity_plan_.size();
+  if (plan_still_valid) {
+    for (size_t i = 0; i < tensors_.size(); ++i) {
+      const BatchCapacityRecord& record = batch_capacity_plan_[i];
+      if (record.allocation_type != kTfLiteArenaRw &&
+          record.allocation_type != kTfLiteArenaRwPersistent) {
+        continue;
+      }
+      if (tensors_[i].allocation_type != record.allocation_type ||
+          tensors_[i].bytes > record.bytes) {
+        plan_still_valid = false;
+        break;
+      }
+    }
+  }
+  if (!plan_still_valid) {
+    // A kernel produced a shape the reserved plan cannot hold (e.g. an
+    // output that grows faster than the batch dimension), so the shortcut is
+    // unsound for this graph; the caller must replan at the desired batch.
+    batch_capacity_ = 0;
+    batch_capacity_plan_.clear();
+    next_execution_plan_index_to_prepare_ = 0;
+    state_ = kStateUninvokable;
+    ReportError(
+        "SetInvocationBatchSize could not reuse the reserved plan; call "
+        "AllocateTensors() to replan.");
+    return kTfLiteError;
+  }
+  for (size_t i = 0; i < tensors_.size(); ++i) {
+    const BatchCapacityRecord& record = batch_capacity_plan_[i];
+    if (record.allocation_type == kTfLiteArenaRw ||
+        record.allocation_type == kTfLiteArenaRwPersistent) {
+      tensors_[i].data.raw = record.data;
+    }
+  }
+  next_execution_plan_index_to_prepare_ =
+      static_cast<int>(execution_plan_.size());
+  invocation_batch_size_ = batch;
+  return kTfLiteOk;
+}
+
+TfLiteStatus Subgraph::InvokeParallel() {
+  if (!worker_pool_) {
+    worker_pool_.reset(new InterOpWorkerPool(num_inter_op_workers_));
+  }
+  // Tensor pointers handed to kernels must stay valid while several kernels
+  // run concurrently.
+  EnsureTensorsVectorCapacity();
+  std::atomic<int> first_error_node(-1);
+  for (const std::vector<int>& level : dependency_levels_) {
+    if (check_cancelled_func_ != nullptr &&
+        check_cancelled_func_(cancellation_data_)) {
+      ReportError("Client requested cancel during Invoke()");
+      return kTfLiteError;
+    }
+    tensor_resized_since_op_invoke_ = false;
+    auto invoke_node = [this, &level, &first_error_node](int i) {
+      const int node_index = level[i];
+      TfLiteNode& node = nodes_and_registration_[node_index].first;
+      const TfLiteRegistration& registration =
+          nodes_and_registration_[node_index].second;
+      if (OpInvoke(registration, &node) == kTfLiteError) {
+        int expected = -1;
+        first_error_node.compare_exchange_strong(expected, node_index);
+      }
+    };
+    // Profiling hooks are intentionally skipped: the profiler interface is
+    // not thread-safe.
+    if (level.size() == 1) {
+      invoke_node(0);
+    } else {
+      worker_pool_->ParallelFor(static_cast<int>(level.size()), invoke_node);
+    }
+    const int error_node_index = first_error_node.load();
+    if (error_node_index != -1) {
+      return ReportOpError(context_,
+                           nodes_and_registration_[error_node_index].first,
+                           nodes_and_registration_[error_node_index].second,
+                           error_node_index, "failed to invoke");
+    }
+    // A kernel made one of its outputs dynamic after all: node order now
+    // matters for re-preparing downstream ops, so this plan can no longer
+    // run in parallel. Require a reallocation rather than guessing at a
+    // recovery point mid-level.
+    if (tensor_resized_since_op_invoke_) {
+      dependency_levels_.clear();
+      state_ = kStateUninvokable;
+      ReportError(
+          "Tensor was resized during parallel execution; call "
+          "AllocateTensors() and Invoke() again.");
+      return kTfLiteError;
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus Subgraph::Invoke() {
   if (!consistent_) {
     ReportError("Invoke called on model that is not consistent.");
@@ -689,11 +1085,48 @@ TfLiteStatus Subgraph::Invoke() {
     }
   }
 
+  if (!dependency_levels_.empty() &&
+      next_execution_plan_index_to_prepare_ == execution_plan_.size()) {
+    return InvokeParallel();
+  }
+
+  int first_execution_plan_index = 0;
+  if (plan_frozen_) {
+    // Tight loop over the frozen plan: all per-node checks were hoisted to
+    // FreezePlan() time. Profiling hooks are intentionally skipped here.
+    const bool check_cancelled = check_cancelled_func_ != nullptr;
+    for (size_t i = 0; i < frozen_plan_.size(); ++i) {
+      const FrozenPlanRecord& record = frozen_plan_[i];
+      if (check_cancelled && check_cancelled_func_(cancellation_data_)) {
+        ReportError("Client requested cancel during Invoke()");
+        return kTfLiteError;
+      }
+      tensor_resized_since_op_invoke_ = false;
+      if (record.invoke(context_, record.node) == kTfLiteError) {
+        return ReportOpError(context_, *record.node, *record.registration,
+                             record.node_index, "failed to invoke");
+      }
+      // A kernel made one of its outputs dynamic after all: the hoisted
+      // checks no longer hold, so discard the frozen plan and finish this
+      // call with the general loop, which will re-prepare downstream ops.
+      if (tensor_resized_since_op_invoke_ &&
+          HasDynamicTensor(*context_, record.node->outputs)) {
+        next_execution_plan_index_to_prepare_ = i + 1;
+        first_execution_plan_index = i + 1;
+        InvalidateFrozenPlan();
+        break;
+      }
+    }
+    if (plan_frozen_) {
+      return status;
+    }
+  }
+
   // Invocations are always done in node order.
   // Note that calling Invoke repeatedly will cause the original memory plan to
   // be reused, unless either ResizeInputTensor() or AllocateTensors() has been
   // called.
-  for (int execution_plan_index = 0;
+  for (int execution_plan_index = first_execution_plan_index;
        execution_plan_index < execution_plan_.size(); execution_plan_index++) {
     if (execution_plan_index == next_execution_plan_index_to_prepare_) {
       TF_LITE_ENSURE_STATUS(PrepareOpsAndTensors());
@@ -929,6 +1362,7 @@ TfLiteStatus Subgraph::SetExecutionPlan(const std::vector<int>& new_plan) {
                                  node_index < nodes_and_registration_.size());
   }
   execution_plan_ = new_plan;
+  InvalidateFrozenPlan();
   return kTfLiteOk;
 }
 
@@ -978,6 +1412,7 @@ void Subgraph::UseNNAPI(bool enable) {
     nnapi_delegate_.reset();
   } else if (!nnapi_delegate_) {
     nnapi_delegate_.reset(new NNAPIDelegate);
+    InvalidateFrozenPlan();
   }
 }
 
@@ -120,6 +120,54 @@ class Subgraph {
   // Overrides execution plan. This bounds checks indices sent in.
   TfLiteStatus SetExecutionPlan(const std::vector<int>& new_plan);
 
+  // WARNING: Experimental interface, subject to change
+  // Compiles the prepared execution plan into a flat array of
+  // (kernel invoke function, node) records that Invoke() then runs in a tight
+  // loop, with the per-node checks of the general loop hoisted to freeze
+  // time. Intended for fixed-shape models invoked at high frequency, where
+  // dispatch overhead is significant relative to kernel time.
+  //
+  // Freezing requires a fully prepared plan with only static-size tensors and
+  // no delegate-provided input buffers; call it after AllocateTensors() and a
+  // successful Invoke(). Profiling hooks are skipped while the plan is
+  // frozen. The frozen plan is discarded automatically whenever the graph,
+  // the execution plan, or an input size changes, and Invoke() falls back to
+  // the general loop.
+  TfLiteStatus FreezePlan();
+
+  // WARNING: Experimental interface, subject to change
+  // Enables or disables parallel execution of independent nodes. When
+  // enabled, AllocateTensors() partitions the execution plan into dependency
+  // levels, and Invoke() dispatches the mutually independent nodes within
+  // each level to a pool of `num_workers` threads (the calling thread
+  // participates, so `num_workers - 1` threads are spawned). Intended for
+  // branchy graphs with parallel towers; purely sequential graphs see no
+  // benefit.
+  //
+  // Enabling this forces a tensor reallocation that preserves intermediates,
+  // since concurrently executing nodes must not reuse each other's tensor
+  // memory; expect higher arena usage. Graphs with dynamic tensors or
+  // delegate-provided buffers fall back to sequential execution, and
+  // profiling hooks are skipped while executing in parallel. Call
+  // AllocateTensors() after changing this setting.
+  TfLiteStatus SetParallelExecution(bool enable, int num_workers);
+
+  // WARNING: Experimental interface, subject to change
+  // Reserves a fixed batch capacity for batched serving. Resizes the leading
+  // dimension of every input tensor (rank >= 1) to `max_batch`, allocates
+  // tensors, and snapshots the resulting memory plan so that
+  // SetInvocationBatchSize() can later switch to any batch size up to
+  // `max_batch` without replanning. Requires only static-size tensors.
+  TfLiteStatus ReserveBatchCapacity(int max_batch);
+
+  // WARNING: Experimental interface, subject to change
+  // Sets the live batch size for subsequent invocations. Requires a capacity
+  // previously reserved with ReserveBatchCapacity(); `batch` must not exceed
+  // it. Re-propagates shapes at the new batch so kernels loop only over live
+  // rows, while tensor buffers keep their reserved-capacity placement. The
+  // reserved plan is discarded if the graph is modified or reallocated.
+  TfLiteStatus SetInvocationBatchSize(int batch);
+
   // Get a mutable tensor data structure.
   // TODO(aselle): Create a safe ArrayHandle interface to avoid exposing this
   // read/write access to structure
@@ -511,6 +559,69 @@ class Subgraph {
   // TODO(aselle): replace execution_plan_ with this.
   std::unique_ptr<TfLiteIntArray, TfLiteIntArrayDeleter> plan_cache_;
 
+  // One step of a frozen execution plan: the kernel's invoke function and the
+  // node it operates on, resolved ahead of time by FreezePlan(). The
+  // registration and node index are kept for error reporting only.
+  struct FrozenPlanRecord {
+    TfLiteStatus (*invoke)(TfLiteContext*, TfLiteNode*);
+    TfLiteNode* node;
+    const TfLiteRegistration* registration;
+    int node_index;
+  };
+
+  // Discards the frozen plan and the dependency levels, returning Invoke()
+  // to the general loop. Called by every mutation that could invalidate the
+  // hoisted checks or the plan partitioning.
+  void InvalidateFrozenPlan() {
+    plan_frozen_ = false;
+    frozen_plan_.clear();
+    dependency_levels_.clear();
+  }
+
+  // Filled by FreezePlan(); used by Invoke() while `plan_frozen_` is true.
+  std::vector<FrozenPlanRecord> frozen_plan_;
+  bool plan_frozen_ = false;
+
+  // Runs the execution plan level by level, dispatching the nodes within a
+  // level to the worker pool. Only called when `dependency_levels_` is
+  // non-empty, which implies a fully prepared, static-size, delegate-free
+  // plan.
+  TfLiteStatus InvokeParallel();
+
+  // A small pool of persistent worker threads for SetParallelExecution().
+  // Defined in subgraph.cc; created lazily on the first parallel Invoke().
+  class InterOpWorkerPool;
+  std::unique_ptr<InterOpWorkerPool> worker_pool_;
+
+  // Whether Invoke() should run independent nodes concurrently, and with how
+  // many threads. See SetParallelExecution().
+  bool parallel_execution_enabled_ = false;
+  int num_inter_op_workers_ = 0;
+
+  // The execution plan partitioned into dependency levels, computed by
+  // AllocateTensors() when parallel execution is enabled and applicable.
+  // Empty whenever the sequential path must be used.
+  std::vector<std::vector<int>> dependency_levels_;
+
+  // Resizes the leading dimension of every input tensor with rank >= 1 to
+  // `batch`, leaving other inputs untouched.
+  TfLiteStatus ResizeInputsToBatch(int batch);
+
+  // Per-tensor snapshot of the capacity plan taken by ReserveBatchCapacity():
+  // the planned size and resolved buffer address, used to restore arena
+  // pointers after shapes are re-propagated at a smaller batch.
+  struct BatchCapacityRecord {
+    size_t bytes;
+    char* data;
+    TfLiteAllocationType allocation_type;
+  };
+  std::vector<BatchCapacityRecord> batch_capacity_plan_;
+
+  // Batch size the memory plan was reserved for (0 when no reservation), and
+  // the batch size shapes currently reflect.
+  int batch_capacity_ = 0;
+  int invocation_batch_size_ = 0;
+
   // Whether to delegate to NN API
   std::unique_ptr<NNAPIDelegate> nnapi_delegate_;
 
@@ -230,4 +230,37 @@ TfLiteStatus PartitionGraphIntoIndependentNodeSubsets(
   return kTfLiteOk;
 }
 
+TfLiteStatus PartitionExecutionPlanIntoDependencyLevels(
+    const GraphInfo* info, const std::vector<int>& execution_plan,
+    std::vector<std::vector<int>>* levels) {
+  // Maps from tensor index to the level of the node that produces it.
+  // Graph inputs, constants and variables keep -1, so their consumers land
+  // in level 0.
+  std::vector<int> tensor_level(info->num_tensors(), -1);
+  for (int node_index : execution_plan) {
+    const TfLiteNode& node = info->node(node_index);
+    int node_level = 0;
+    for (int i = 0; i < node.inputs->size; ++i) {
+      const int tensor_index = node.inputs->data[i];
+      if (tensor_index == kOptionalTensor) continue;
+      node_level = std::max(node_level, tensor_level[tensor_index] + 1);
+    }
+    if (static_cast<size_t>(node_level) >= levels->size()) {
+      levels->resize(node_level + 1);
+    }
+    (*levels)[node_level].push_back(node_index);
+    for (int i = 0; i < node.outputs->size; ++i) {
+      tensor_level[node.outputs->data[i]] = node_level;
+    }
+    // Temporaries are private to the node, but record them anyway so a
+    // malformed graph reading another node's temporaries still serializes.
+    if (node.temporaries != nullptr) {
+      for (int i = 0; i < node.temporaries->size; ++i) {
+        tensor_level[node.temporaries->data[i]] = node_level;
+      }
+    }
+  }
+  return kTfLiteOk;
+}
+
 }  // namespace tflite
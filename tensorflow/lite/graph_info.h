@@ -78,6 +78,15 @@ TfLiteStatus PartitionGraphIntoIndependentNodeSubsets(
     const GraphInfo* info, const TfLiteIntArray* nodes_to_partition,
     std::vector<NodeSubset>* node_subsets);
 
+// Partitions an execution plan into dependency levels: every node in level k
+// consumes only graph inputs and outputs of nodes in levels < k, so the nodes
+// within one level are mutually independent and may execute concurrently.
+// `execution_plan` is a list of node indices in topological order, as kept by
+// the interpreter; `levels` is assumed to be empty.
+TfLiteStatus PartitionExecutionPlanIntoDependencyLevels(
+    const GraphInfo* info, const std::vector<int>& execution_plan,
+    std::vector<std::vector<int>>* levels);
+
 }  // namespace tflite
 
 #endif  // TENSORFLOW_LITE_GRAPH_INFO_H_
@@ -277,6 +277,66 @@ TEST(PartitionTest, Nodes3PartitionNodes2) {
       {expected_subgraph0, expected_subgraph1, expected_subgraph2});
 }
 
+// Test partitioning an empty plan into dependency levels.
+TEST(DependencyLevelTest, EmptyPlan) {
+  SimpleTestGraph graph;
+  std::vector<std::vector<int>> levels;
+  ASSERT_EQ(PartitionExecutionPlanIntoDependencyLevels(&graph, {}, &levels),
+            kTfLiteOk);
+  EXPECT_TRUE(levels.empty());
+}
+
+// Test a purely sequential chain: every node gets its own level.
+// Input: tensor(0) -> node(0) -> tensor(1) -> node(1) -> tensor(2)
+// Output: [[0], [1]]
+TEST(DependencyLevelTest, SequentialChain) {
+  SimpleTestGraph graph;
+  graph.AddTensors(3);
+  graph.AddNode({0}, {1});
+  graph.AddNode({1}, {2});
+  graph.SetInputsAndOutputs({0}, {2});
+  std::vector<std::vector<int>> levels;
+  ASSERT_EQ(
+      PartitionExecutionPlanIntoDependencyLevels(&graph, {0, 1}, &levels),
+      kTfLiteOk);
+  EXPECT_EQ(levels, (std::vector<std::vector<int>>{{0}, {1}}));
+}
+
+// Test a diamond: the two towers share a level, the join gets its own.
+// Input: tensor(0) -> node(0) -> tensor(1)
+//        tensor(0) -> node(1) -> tensor(2)
+//        [tensor(1), tensor(2)] -> node(2) -> tensor(3)
+// Output: [[0, 1], [2]]
+TEST(DependencyLevelTest, DiamondRunsTowersTogether) {
+  SimpleTestGraph graph;
+  graph.AddTensors(4);
+  graph.AddNode({0}, {1});
+  graph.AddNode({0}, {2});
+  graph.AddNode({1, 2}, {3});
+  graph.SetInputsAndOutputs({0}, {3});
+  std::vector<std::vector<int>> levels;
+  ASSERT_EQ(
+      PartitionExecutionPlanIntoDependencyLevels(&graph, {0, 1, 2}, &levels),
+      kTfLiteOk);
+  EXPECT_EQ(levels, (std::vector<std::vector<int>>{{0, 1}, {2}}));
+}
+
+// Test that optional (absent) inputs do not constrain the level assignment,
+// and that a plan covering a subset of the nodes only serializes that subset.
+TEST(DependencyLevelTest, OptionalInputsAndPartialPlan) {
+  SimpleTestGraph graph;
+  graph.AddTensors(4);
+  graph.AddNode({0, kOptionalTensor}, {1});
+  graph.AddNode({0}, {2});
+  graph.AddNode({1, 2}, {3});
+  graph.SetInputsAndOutputs({0}, {3});
+  std::vector<std::vector<int>> levels;
+  ASSERT_EQ(
+      PartitionExecutionPlanIntoDependencyLevels(&graph, {0, 1}, &levels),
+      kTfLiteOk);
+  EXPECT_EQ(levels, (std::vector<std::vector<int>>{{0, 1}}));
+}
+
 }  // namespace
 }  // namespace tflite
 
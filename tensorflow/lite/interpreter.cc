@@ -187,6 +187,22 @@ TfLiteStatus Interpreter::SetExecutionPlan(const std::vector<int>& new_plan) {
   return primary_subgraph().SetExecutionPlan(new_plan);
 }
 
+TfLiteStatus Interpreter::FreezeExecutionPlan() {
+  return primary_subgraph().FreezePlan();
+}
+
+TfLiteStatus Interpreter::SetParallelExecution(bool enable, int num_workers) {
+  return primary_subgraph().SetParallelExecution(enable, num_workers);
+}
+
+TfLiteStatus Interpreter::ReserveBatchCapacity(int max_batch) {
+  return primary_subgraph().ReserveBatchCapacity(max_batch);
+}
+
+TfLiteStatus Interpreter::SetInvocationBatchSize(int batch) {
+  return primary_subgraph().SetInvocationBatchSize(batch);
+}
+
 void Interpreter::UseNNAPI(bool enable) { primary_subgraph().UseNNAPI(enable); }
 
 void Interpreter::SetNumThreads(int num_threads) {
@@ -246,6 +246,40 @@ class Interpreter {
   // Overrides execution plan. This bounds checks indices sent in.
   TfLiteStatus SetExecutionPlan(const std::vector<int>& new_plan);
 
+  // WARNING: Experimental interface, subject to change
+  // Compiles the prepared execution plan into a flat array of (kernel invoke
+  // function, node) records that Invoke() runs in a tight loop with all
+  // per-node checks hoisted, minimizing dispatch overhead for fixed-shape
+  // models invoked at high frequency. Call after AllocateTensors() and a
+  // successful Invoke(). The frozen plan is discarded automatically if the
+  // graph, the execution plan, or an input size changes.
+  TfLiteStatus FreezeExecutionPlan();
+
+  // WARNING: Experimental interface, subject to change
+  // Enables or disables parallel execution of independent nodes. When
+  // enabled, AllocateTensors() partitions the execution plan into dependency
+  // levels, and Invoke() dispatches the mutually independent nodes within
+  // each level to a pool of `num_workers` threads (the calling thread
+  // participates). Intended for branchy graphs with parallel towers. This
+  // preserves intermediate tensors, increasing arena usage; graphs with
+  // dynamic tensors or delegates fall back to sequential execution. Call
+  // AllocateTensors() after changing this setting.
+  TfLiteStatus SetParallelExecution(bool enable, int num_workers);
+
+  // WARNING: Experimental interface, subject to change
+  // Reserves a fixed batch capacity for batched serving: resizes the leading
+  // dimension of every input to `max_batch`, allocates tensors, and
+  // snapshots the memory plan so SetInvocationBatchSize() can switch between
+  // batch sizes up to `max_batch` without replanning.
+  TfLiteStatus ReserveBatchCapacity(int max_batch);
+
+  // WARNING: Experimental interface, subject to change
+  // Sets the live batch size for subsequent Invoke() calls; requires a
+  // capacity reserved with ReserveBatchCapacity() and `batch` must not
+  // exceed it. Shapes are re-propagated so kernels loop only over live rows,
+  // while tensor buffers keep their reserved-capacity placement.
+  TfLiteStatus SetInvocationBatchSize(int batch);
+
   // Get a mutable tensor data structure.
   // TODO(aselle): Create a safe ArrayHandle interface to avoid exposing this
   // read/write access to structure
@@ -590,6 +590,223 @@ TEST(BasicInterpreter, OneOpInterpreter) {
   ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
 }
 
+TEST(BasicInterpreter, FrozenPlanInterpreter) {
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(2), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({1}), kTfLiteOk);
+
+  TfLiteQuantizationParams quantized;
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(0, kTfLiteFloat32, "in",
+                                                     {3}, quantized),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(1, kTfLiteFloat32, "out",
+                                                     {3}, quantized),
+            kTfLiteOk);
+
+  TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+  reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    for (int i = 0; i < input->dims->data[0]; ++i) {
+      output->data.f[i] = input->data.f[i] + 1.f;
+    }
+    return kTfLiteOk;
+  };
+  ASSERT_EQ(
+      interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr, &reg),
+      kTfLiteOk);
+
+  // Freezing is only possible once the plan has been fully prepared.
+  ASSERT_EQ(interpreter.FreezeExecutionPlan(), kTfLiteError);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(interpreter.FreezeExecutionPlan(), kTfLiteOk);
+
+  TfLiteTensor* input = interpreter.tensor(0);
+  TfLiteTensor* output = interpreter.tensor(1);
+  for (int i = 0; i < 3; ++i) input->data.f[i] = i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 3; ++i) ASSERT_EQ(output->data.f[i], i + 1.f);
+
+  // Repeated invocations reuse the frozen plan.
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 3; ++i) ASSERT_EQ(output->data.f[i], i + 1.f);
+
+  // Resizing an input discards the frozen plan; the general loop takes over
+  // and the plan can be frozen again after re-allocation.
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {5}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  ASSERT_EQ(interpreter.FreezeExecutionPlan(), kTfLiteOk);
+  input = interpreter.tensor(0);
+  output = interpreter.tensor(1);
+  for (int i = 0; i < 5; ++i) input->data.f[i] = i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 5; ++i) ASSERT_EQ(output->data.f[i], i + 1.f);
+}
+
+TEST(BasicInterpreter, ParallelExecutionInterpreter) {
+  // A small diamond: two independent towers consume the input and a final
+  // node sums their outputs, so the towers form one dependency level that
+  // may execute concurrently.
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(4), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({3}), kTfLiteOk);
+
+  TfLiteQuantizationParams quantized;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(interpreter.SetTensorParametersReadWrite(i, kTfLiteFloat32, "",
+                                                       {3}, quantized),
+              kTfLiteOk);
+  }
+
+  TfLiteRegistration add_one_reg = {nullptr, nullptr, nullptr, nullptr};
+  add_one_reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  add_one_reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    for (int i = 0; i < input->dims->data[0]; ++i) {
+      output->data.f[i] = input->data.f[i] + 1.f;
+    }
+    return kTfLiteOk;
+  };
+  TfLiteRegistration sum_reg = {nullptr, nullptr, nullptr, nullptr};
+  sum_reg.prepare = add_one_reg.prepare;
+  sum_reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input0 = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* input1 = &context->tensors[node->inputs->data[1]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    for (int i = 0; i < input0->dims->data[0]; ++i) {
+      output->data.f[i] = input0->data.f[i] + input1->data.f[i];
+    }
+    return kTfLiteOk;
+  };
+  ASSERT_EQ(interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr,
+                                              &add_one_reg),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.AddNodeWithParameters({0}, {2}, nullptr, 0, nullptr,
+                                              &add_one_reg),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.AddNodeWithParameters({1, 2}, {3}, nullptr, 0, nullptr,
+                                              &sum_reg),
+            kTfLiteOk);
+
+  ASSERT_EQ(interpreter.SetParallelExecution(true, 2), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  TfLiteTensor* input = interpreter.tensor(0);
+  TfLiteTensor* output = interpreter.tensor(3);
+  for (int i = 0; i < 3; ++i) input->data.f[i] = i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 3; ++i) ASSERT_EQ(output->data.f[i], 2.f * i + 2.f);
+
+  // Repeated invocations reuse the partitioned plan.
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 3; ++i) ASSERT_EQ(output->data.f[i], 2.f * i + 2.f);
+
+  // Resizing an input requires re-allocation; the plan is re-partitioned.
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {5}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  input = interpreter.tensor(0);
+  output = interpreter.tensor(3);
+  for (int i = 0; i < 5; ++i) input->data.f[i] = i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 5; ++i) ASSERT_EQ(output->data.f[i], 2.f * i + 2.f);
+
+  // Disabling returns to the sequential path.
+  ASSERT_EQ(interpreter.SetParallelExecution(false, 0), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 5; ++i) ASSERT_EQ(output->data.f[i], 2.f * i + 2.f);
+}
+
+TEST(BasicInterpreter, BatchedInvokeInterpreter) {
+  // One add-1 op over a batched input; the plan is reserved at batch 4 and
+  // invoked at smaller live batch sizes without reallocation.
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(2), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({1}), kTfLiteOk);
+
+  TfLiteQuantizationParams quantized;
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(0, kTfLiteFloat32, "in",
+                                                     {1, 2}, quantized),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.SetTensorParametersReadWrite(1, kTfLiteFloat32, "out",
+                                                     {1, 2}, quantized),
+            kTfLiteOk);
+
+  TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+  reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    const int num = input->dims->data[0] * input->dims->data[1];
+    for (int i = 0; i < num; ++i) {
+      output->data.f[i] = input->data.f[i] + 1.f;
+    }
+    return kTfLiteOk;
+  };
+  ASSERT_EQ(
+      interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr, &reg),
+      kTfLiteOk);
+
+  // Setting a batch size requires a reserved capacity.
+  ASSERT_EQ(interpreter.SetInvocationBatchSize(1), kTfLiteError);
+  ASSERT_EQ(interpreter.ReserveBatchCapacity(4), kTfLiteOk);
+
+  TfLiteTensor* input = interpreter.tensor(0);
+  TfLiteTensor* output = interpreter.tensor(1);
+  char* reserved_output_buffer = output->data.raw;
+  ASSERT_EQ(input->dims->data[0], 4);
+
+  // Shrink to a live batch of 2: shapes reflect the live rows while buffers
+  // keep their reserved placement.
+  ASSERT_EQ(interpreter.SetInvocationBatchSize(2), kTfLiteOk);
+  input = interpreter.tensor(0);
+  output = interpreter.tensor(1);
+  ASSERT_EQ(input->dims->data[0], 2);
+  ASSERT_EQ(output->dims->data[0], 2);
+  ASSERT_EQ(output->data.raw, reserved_output_buffer);
+  for (int i = 0; i < 4; ++i) input->data.f[i] = i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 4; ++i) ASSERT_EQ(output->data.f[i], i + 1.f);
+
+  // Back up to the full capacity.
+  ASSERT_EQ(interpreter.SetInvocationBatchSize(4), kTfLiteOk);
+  input = interpreter.tensor(0);
+  output = interpreter.tensor(1);
+  ASSERT_EQ(output->dims->data[0], 4);
+  for (int i = 0; i < 8; ++i) input->data.f[i] = i;
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  for (int i = 0; i < 8; ++i) ASSERT_EQ(output->data.f[i], i + 1.f);
+
+  // The capacity is a hard limit.
+  ASSERT_EQ(interpreter.SetInvocationBatchSize(5), kTfLiteError);
+
+  // Reallocation discards the reservation.
+  ASSERT_EQ(interpreter.ResizeInputTensor(0, {2, 2}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInvocationBatchSize(2), kTfLiteError);
+}
+
 // Forcefully divides tensor allocation in three steps: one before invocation
 // and two more at invocation time. This happens because we use string tensors
 // and their sizes can't be determined until invocation time.
@@ -62,6 +62,19 @@ class SimpleMemoryArena {
     return arena_alignment_ + high_water_mark_ + padding;
   }
 
+  // Returns the high water mark of this arena's address space.
+  size_t GetHighWaterMark() const { return high_water_mark_; }
+
+  // Raises the high water mark to at least `mark` so that the next Commit()
+  // reserves a buffer at least that large. Used when restoring a previously
+  // computed allocation plan without replaying its allocations.
+  void EnsureHighWaterMark(size_t mark) {
+    if (mark > high_water_mark_) {
+      high_water_mark_ = mark;
+      committed_ = false;
+    }
+  }
+
   TfLiteStatus Commit(TfLiteContext* context);
 
   TfLiteStatus ResolveAlloc(TfLiteContext* context, const ArenaAlloc& alloc,
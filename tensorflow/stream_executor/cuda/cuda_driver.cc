@@ -824,6 +824,123 @@ GpuDriver::ContextGetSharedMemConfig(GpuContext* context) {
   }
 }
 
+/* static */ bool GpuDriver::StreamBeginCapture(GpuContext* context,
+                                                CUstream stream) {
+#if CUDA_VERSION >= 10000
+  ScopedActivateContext activated{context};
+  CUresult res = cuStreamBeginCapture(stream);
+  if (res != CUDA_SUCCESS) {
+    LOG(ERROR) << "failed to begin capture on CUDA stream " << stream << ": "
+               << ToString(res);
+    return false;
+  }
+
+  VLOG(2) << "successfully began capture on stream " << stream;
+  return true;
+#else
+  LOG(ERROR) << "stream capture requires the CUDA 10 toolkit";
+  return false;
+#endif
+}
+
+/* static */ bool GpuDriver::StreamEndCapture(GpuContext* context,
+                                              CUstream stream,
+                                              CUgraph* graph) {
+#if CUDA_VERSION >= 10000
+  ScopedActivateContext activated{context};
+  CUresult res = cuStreamEndCapture(stream, graph);
+  if (res != CUDA_SUCCESS) {
+    LOG(ERROR) << "failed to end capture on CUDA stream " << stream << ": "
+               << ToString(res);
+    return false;
+  }
+
+  VLOG(2) << "successfully ended capture on stream " << stream << ", graph "
+          << *graph;
+  return true;
+#else
+  LOG(ERROR) << "stream capture requires the CUDA 10 toolkit";
+  return false;
+#endif
+}
+
+/* static */ bool GpuDriver::GraphInstantiate(GpuContext* context,
+                                              CUgraph graph,
+                                              CUgraphExec* exec) {
+#if CUDA_VERSION >= 10000
+  ScopedActivateContext activated{context};
+  CUgraphNode error_node = nullptr;
+  char log_buffer[256];
+  log_buffer[0] = '\0';
+  CUresult res = cuGraphInstantiate(exec, graph, &error_node, log_buffer,
+                                    sizeof(log_buffer));
+  if (res != CUDA_SUCCESS) {
+    LOG(ERROR) << "failed to instantiate CUDA graph " << graph << ": "
+               << ToString(res) << " " << log_buffer;
+    return false;
+  }
+
+  VLOG(2) << "successfully instantiated graph " << graph << " as " << *exec;
+  return true;
+#else
+  LOG(ERROR) << "stream capture requires the CUDA 10 toolkit";
+  return false;
+#endif
+}
+
+/* static */ bool GpuDriver::GraphLaunch(GpuContext* context, CUgraphExec exec,
+                                         CUstream stream) {
+#if CUDA_VERSION >= 10000
+  ScopedActivateContext activated{context};
+  CUresult res = cuGraphLaunch(exec, stream);
+  if (res != CUDA_SUCCESS) {
+    LOG(ERROR) << "failed to launch CUDA graph " << exec << " on stream "
+               << stream << ": " << ToString(res);
+    return false;
+  }
+
+  return true;
+#else
+  LOG(ERROR) << "stream capture requires the CUDA 10 toolkit";
+  return false;
+#endif
+}
+
+/* static */ void GpuDriver::DestroyGraph(GpuContext* context, CUgraph* graph) {
+#if CUDA_VERSION >= 10000
+  if (*graph == nullptr) {
+    return;
+  }
+
+  ScopedActivateContext activated{context};
+  CUresult res = cuGraphDestroy(*graph);
+  if (res != CUDA_SUCCESS) {
+    LOG(ERROR) << "failed to destroy CUDA graph " << *graph << ": "
+               << ToString(res);
+  } else {
+    *graph = nullptr;
+  }
+#endif
+}
+
+/* static */ void GpuDriver::DestroyGraphExec(GpuContext* context,
+                                              CUgraphExec* exec) {
+#if CUDA_VERSION >= 10000
+  if (*exec == nullptr) {
+    return;
+  }
+
+  ScopedActivateContext activated{context};
+  CUresult res = cuGraphExecDestroy(*exec);
+  if (res != CUDA_SUCCESS) {
+    LOG(ERROR) << "failed to destroy instantiated CUDA graph " << *exec << ": "
+               << ToString(res);
+  } else {
+    *exec = nullptr;
+  }
+#endif
+}
+
 /* static */ void* GpuDriver::DeviceAllocate(GpuContext* context,
                                              uint64 bytes) {
   if (bytes == 0) {
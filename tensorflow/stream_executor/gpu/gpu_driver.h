@@ -82,6 +82,44 @@ class GpuDriver {
   // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__STREAM.html#group__CUDA__STREAM_1g244c8833de4596bcd31a06cdf21ee758
   static void DestroyStream(GpuContext* context, GpuStreamHandle* stream);
 
+  // Begins capture of the work subsequently enqueued on the given stream via
+  // cuStreamBeginCapture. Until capture ends, launches on the stream are
+  // recorded into a graph instead of being executed. Returns false if stream
+  // capture is unavailable (toolkit older than CUDA 10) or the driver call
+  // fails.
+  // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__STREAM.html#group__CUDA__STREAM_1g767167da0bbf07157dc20b6c258a2143
+  static bool StreamBeginCapture(GpuContext* context, GpuStreamHandle stream);
+
+  // Ends capture on the given stream via cuStreamEndCapture and returns the
+  // captured graph.
+  // graph is an outparam owned by the caller, must not be null.
+  // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__STREAM.html#group__CUDA__STREAM_1g03dab8b2ba76b00718955177a929970c
+  static bool StreamEndCapture(GpuContext* context, GpuStreamHandle stream,
+                               GpuGraphHandle* graph);
+
+  // Instantiates an executable graph from a captured graph via
+  // cuGraphInstantiate. The captured graph may be destroyed afterwards.
+  // exec is an outparam owned by the caller, must not be null.
+  // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g433d93df56ab34d8b23f67f704bc1476
+  static bool GraphInstantiate(GpuContext* context, GpuGraphHandle graph,
+                               GpuGraphExecHandle* exec);
+
+  // Replays an instantiated graph on the given stream as a single submission
+  // via cuGraphLaunch.
+  // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g6b2dceb3901e71a390d2bd8b0491e471
+  static bool GraphLaunch(GpuContext* context, GpuGraphExecHandle exec,
+                          GpuStreamHandle stream);
+
+  // Destroys *graph and turns it into a nullptr, via cuGraphDestroy. graph may
+  // not be null, but *graph may be.
+  // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g718cfd9681f078693d4be2426fd689c8
+  static void DestroyGraph(GpuContext* context, GpuGraphHandle* graph);
+
+  // Destroys *exec and turns it into a nullptr, via cuGraphExecDestroy. exec
+  // may not be null, but *exec may be.
+  // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1ga32ad4944cc5d408158207c978bc43a7
+  static void DestroyGraphExec(GpuContext* context, GpuGraphExecHandle* exec);
+
   // CUDA events can explicitly disable event TSC retrieval for some presumed
   // performance improvement if timing is unnecessary.
   // http://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__EVENT.html#group__CUDA__EVENT_1g450687e75f3ff992fe01662a43d9d3db
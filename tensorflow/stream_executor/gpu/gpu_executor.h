@@ -161,6 +161,16 @@ class GpuExecutor : public internal::StreamExecutorInterface {
 
   bool CreateStreamDependency(Stream* dependent, Stream* other) override;
 
+  bool SupportsStreamCapture() const override;
+
+  bool BeginStreamCapture(Stream* stream) override;
+
+  bool EndStreamCapture(Stream* stream, void** exec_graph) override;
+
+  bool LaunchCapturedGraph(Stream* stream, void* exec_graph) override;
+
+  void DestroyCapturedGraph(void* exec_graph) override;
+
   bool AllocateTimer(Timer* timer) override;
 
   void DeallocateTimer(Timer* timer) override;
@@ -60,6 +60,11 @@ using GpuComplexType = hipComplex;
 using GpuDoubleComplexType = hipDoubleComplex;
 using GpuRngHandle = hiprandGenerator_t;
 
+// This ROCm release has no stream-capture graph API; opaque handles keep the
+// GpuDriver declarations compilable.
+using GpuGraphHandle = void*;
+using GpuGraphExecHandle = void*;
+
 #else  // CUDA
 
 using GpuStreamHandle = CUstream;
@@ -78,6 +83,16 @@ using GpuComplexType = cuComplex;
 using GpuDoubleComplexType = cuDoubleComplex;
 using GpuRngHandle = curandGenerator_t;
 
+#if CUDA_VERSION >= 10000
+using GpuGraphHandle = CUgraph;
+using GpuGraphExecHandle = CUgraphExec;
+#else
+// Stream capture requires the CUDA 10 toolkit; opaque handles keep the
+// GpuDriver declarations compilable against older toolkits.
+using GpuGraphHandle = void*;
+using GpuGraphExecHandle = void*;
+#endif
+
 #endif
 
 }  // namespace gpu
@@ -650,6 +650,39 @@ GpuDriver::ContextGetSharedMemConfig(GpuContext* context) {
   }
 }
 
+/* static */ bool GpuDriver::StreamBeginCapture(GpuContext* context,
+                                                GpuStreamHandle stream) {
+  LOG(ERROR) << "stream capture is not supported on ROCm";
+  return false;
+}
+
+/* static */ bool GpuDriver::StreamEndCapture(GpuContext* context,
+                                              GpuStreamHandle stream,
+                                              GpuGraphHandle* graph) {
+  LOG(ERROR) << "stream capture is not supported on ROCm";
+  return false;
+}
+
+/* static */ bool GpuDriver::GraphInstantiate(GpuContext* context,
+                                              GpuGraphHandle graph,
+                                              GpuGraphExecHandle* exec) {
+  LOG(ERROR) << "stream capture is not supported on ROCm";
+  return false;
+}
+
+/* static */ bool GpuDriver::GraphLaunch(GpuContext* context,
+                                         GpuGraphExecHandle exec,
+                                         GpuStreamHandle stream) {
+  LOG(ERROR) << "stream capture is not supported on ROCm";
+  return false;
+}
+
+/* static */ void GpuDriver::DestroyGraph(GpuContext* context,
+                                          GpuGraphHandle* graph) {}
+
+/* static */ void GpuDriver::DestroyGraphExec(GpuContext* context,
+                                              GpuGraphExecHandle* exec) {}
+
 /* static */ void* GpuDriver::DeviceAllocate(GpuContext* context,
                                              uint64 bytes) {
   ScopedActivateContext activated{context};
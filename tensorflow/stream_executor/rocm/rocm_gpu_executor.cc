@@ -637,6 +637,39 @@ bool GpuExecutor::CreateStreamDependency(Stream* dependent, Stream* other) {
                                       other_completed_event);
 }
 
+bool GpuExecutor::SupportsStreamCapture() const { return false; }
+
+bool GpuExecutor::BeginStreamCapture(Stream* stream) {
+  return GpuDriver::StreamBeginCapture(context_, AsGpuStreamValue(stream));
+}
+
+bool GpuExecutor::EndStreamCapture(Stream* stream, void** exec_graph) {
+  GpuGraphHandle graph = nullptr;
+  if (!GpuDriver::StreamEndCapture(context_, AsGpuStreamValue(stream),
+                                   &graph)) {
+    return false;
+  }
+  GpuGraphExecHandle exec = nullptr;
+  const bool instantiated = GpuDriver::GraphInstantiate(context_, graph, &exec);
+  GpuDriver::DestroyGraph(context_, &graph);
+  if (!instantiated) {
+    return false;
+  }
+  *exec_graph = exec;
+  return true;
+}
+
+bool GpuExecutor::LaunchCapturedGraph(Stream* stream, void* exec_graph) {
+  return GpuDriver::GraphLaunch(context_,
+                                static_cast<GpuGraphExecHandle>(exec_graph),
+                                AsGpuStreamValue(stream));
+}
+
+void GpuExecutor::DestroyCapturedGraph(void* exec_graph) {
+  GpuGraphExecHandle exec = static_cast<GpuGraphExecHandle>(exec_graph);
+  GpuDriver::DestroyGraphExec(context_, &exec);
+}
+
 bool GpuExecutor::StartTimer(Stream* stream, Timer* timer) {
   return AsGpuTimer(timer)->Start(AsGpuStream(stream));
 }
@@ -5136,6 +5136,27 @@ Stream &Stream::ThenDoHostCallbackWithStatus(
   return *this;
 }
 
+Stream &Stream::BeginCapture() {
+  VLOG_CALL();
+
+  CheckError(parent_->BeginStreamCapture(this));
+  return *this;
+}
+
+Stream &Stream::EndCapture(void **exec_graph) {
+  VLOG_CALL(PARAM(exec_graph));
+
+  CheckError(parent_->EndStreamCapture(this, exec_graph));
+  return *this;
+}
+
+Stream &Stream::ThenReplayCapturedGraph(void *exec_graph) {
+  VLOG_CALL(PARAM(exec_graph));
+
+  CheckError(parent_->LaunchCapturedGraph(this, exec_graph));
+  return *this;
+}
+
 Stream &Stream::ThenFft(fft::Plan *plan,
                         const DeviceMemory<std::complex<float>> &input,
                         DeviceMemory<std::complex<float>> *output) {
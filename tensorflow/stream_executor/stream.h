@@ -1942,6 +1942,33 @@ class Stream {
   // negative effects on performance.
   Stream &ThenDoHostCallbackWithStatus(std::function<port::Status()> callback);
 
+  // Begins capturing the device work subsequently enqueued on this stream
+  // (e.g. into a CUDA graph). While capture is active the work is recorded
+  // instead of executed, so the stream must not be synchronized until capture
+  // has ended. Capture is only available when
+  // parent()->SupportsStreamCapture() returns true; beginning capture on
+  // other platforms puts the stream into an error state.
+  //
+  // Capture is intended for launch-overhead-bound sequences of small kernels
+  // whose shapes and control flow do not change between invocations: the
+  // captured sequence can be replayed as a single submission via
+  // ThenReplayCapturedGraph.
+  Stream &BeginCapture();
+
+  // Ends capture on this stream and stores an opaque executable graph handle
+  // in *exec_graph. The handle replays the captured work when passed to
+  // ThenReplayCapturedGraph, on this stream or another stream of the same
+  // StreamExecutor, and must eventually be released with
+  // parent()->DestroyCapturedGraph(). exec_graph must not be null.
+  Stream &EndCapture(void **exec_graph);
+
+  // Entrains onto the stream a replay of the previously captured work held by
+  // exec_graph as a single device submission. The memory addresses recorded
+  // during capture are baked into the graph, so the caller must ensure the
+  // buffers used during capture are still the ones holding the inputs and
+  // outputs of the replayed work.
+  Stream &ThenReplayCapturedGraph(void *exec_graph);
+
   // Returns the StreamExecutor (parent object) associated with this stream.
   StreamExecutor *parent() const {
     CHECK(parent_ != nullptr);
@@ -250,6 +250,23 @@ class StreamExecutorInterface {
   virtual bool AllocateStream(Stream *stream) = 0;
   virtual void DeallocateStream(Stream *stream) = 0;
   virtual bool CreateStreamDependency(Stream *dependent, Stream *other) = 0;
+
+  // Stream capture (e.g. CUDA Graphs). While capture is active, work enqueued
+  // on the stream is recorded into a graph instead of being executed;
+  // EndStreamCapture turns the recording into an opaque executable graph
+  // handle that LaunchCapturedGraph replays as a single submission. The
+  // handle stays valid until passed to DestroyCapturedGraph. Executors
+  // without capture support keep these defaults, which report failure.
+  virtual bool SupportsStreamCapture() const { return false; }
+  virtual bool BeginStreamCapture(Stream *stream) { return false; }
+  virtual bool EndStreamCapture(Stream *stream, void **exec_graph) {
+    return false;
+  }
+  virtual bool LaunchCapturedGraph(Stream *stream, void *exec_graph) {
+    return false;
+  }
+  virtual void DestroyCapturedGraph(void *exec_graph) {}
+
   virtual bool AllocateTimer(Timer *timer) = 0;
   virtual void DeallocateTimer(Timer *timer) = 0;
   virtual bool StartTimer(Stream *stream, Timer *timer) = 0;
@@ -751,6 +751,26 @@ bool StreamExecutor::HostCallback(Stream *stream,
   return implementation_->HostCallback(stream, std::move(callback));
 }
 
+bool StreamExecutor::SupportsStreamCapture() const {
+  return implementation_->SupportsStreamCapture();
+}
+
+bool StreamExecutor::BeginStreamCapture(Stream *stream) {
+  return implementation_->BeginStreamCapture(stream);
+}
+
+bool StreamExecutor::EndStreamCapture(Stream *stream, void **exec_graph) {
+  return implementation_->EndStreamCapture(stream, exec_graph);
+}
+
+bool StreamExecutor::LaunchCapturedGraph(Stream *stream, void *exec_graph) {
+  return implementation_->LaunchCapturedGraph(stream, exec_graph);
+}
+
+void StreamExecutor::DestroyCapturedGraph(void *exec_graph) {
+  implementation_->DestroyCapturedGraph(exec_graph);
+}
+
 port::Status StreamExecutor::AllocateEvent(Event *event) {
   return implementation_->AllocateEvent(event);
 }
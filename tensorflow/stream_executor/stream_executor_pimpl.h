@@ -557,6 +557,26 @@ class StreamExecutor {
   // This is the preferred form for a callback that may return an error.
   bool HostCallback(Stream *stream, std::function<port::Status()> callback);
 
+  // Returns whether the underlying platform supports stream capture (e.g.
+  // CUDA Graphs).
+  bool SupportsStreamCapture() const;
+
+  // Begins recording the work subsequently enqueued on stream into a graph.
+  // See Stream::BeginCapture for full details.
+  bool BeginStreamCapture(Stream *stream);
+
+  // Ends recording on stream and returns an opaque executable graph handle in
+  // *exec_graph. See Stream::EndCapture for full details.
+  bool EndStreamCapture(Stream *stream, void **exec_graph);
+
+  // Entrains onto stream a replay of a previously captured graph as a single
+  // submission. See Stream::ThenReplayCapturedGraph for full details.
+  bool LaunchCapturedGraph(Stream *stream, void *exec_graph);
+
+  // Releases the resources held by an executable graph handle returned by
+  // EndStreamCapture.
+  void DestroyCapturedGraph(void *exec_graph);
+
   // Performs platform-specific allocation and initialization of an event.
   port::Status AllocateEvent(Event *event);
 